@@ -20,7 +20,9 @@ include art/build/Android.common_build.mk
 
 LIBARTBENCHMARK_COMMON_SRC_FILES := \
   jobject-benchmark/jobject_benchmark.cc \
+  jni-micro/jni_micro.cc \
   jni-perf/perf_jni.cc \
+  micro-runtime/micro_runtime.cc \
   scoped-primitive-array/scoped_primitive_array.cc
 
 # $(1): target or host
@@ -0,0 +1,91 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "jni.h"
+
+#include "base/logging.h"
+
+// Microbenchmarks for the public JNI surface. Unlike jobject_benchmark.cc these deliberately go
+// through the JNIEnv function table, so they see the same costs (CheckJNI dispatch, reference
+// table bookkeeping, copy vs pin decisions) as application code.
+
+namespace art {
+namespace {
+
+extern "C" JNIEXPORT void JNICALL Java_JniMicroBenchmark_localRef(
+    JNIEnv* env, jobject, jint reps, jobject obj) {
+  for (jint i = 0; i < reps; ++i) {
+    jobject ref = env->NewLocalRef(obj);
+    CHECK(ref != nullptr);
+    env->DeleteLocalRef(ref);
+  }
+}
+
+extern "C" JNIEXPORT void JNICALL Java_JniMicroBenchmark_globalRef(
+    JNIEnv* env, jobject, jint reps, jobject obj) {
+  for (jint i = 0; i < reps; ++i) {
+    jobject ref = env->NewGlobalRef(obj);
+    CHECK(ref != nullptr);
+    env->DeleteGlobalRef(ref);
+  }
+}
+
+extern "C" JNIEXPORT void JNICALL Java_JniMicroBenchmark_getStringUTFChars(
+    JNIEnv* env, jobject, jint reps, jstring s) {
+  for (jint i = 0; i < reps; ++i) {
+    const char* chars = env->GetStringUTFChars(s, nullptr);
+    CHECK(chars != nullptr);
+    env->ReleaseStringUTFChars(s, chars);
+  }
+}
+
+extern "C" JNIEXPORT void JNICALL Java_JniMicroBenchmark_getStringCritical(
+    JNIEnv* env, jobject, jint reps, jstring s) {
+  for (jint i = 0; i < reps; ++i) {
+    const jchar* chars = env->GetStringCritical(s, nullptr);
+    CHECK(chars != nullptr);
+    env->ReleaseStringCritical(s, chars);
+  }
+}
+
+extern "C" JNIEXPORT void JNICALL Java_JniMicroBenchmark_getPrimitiveArrayCritical(
+    JNIEnv* env, jobject, jint reps, jbyteArray array) {
+  for (jint i = 0; i < reps; ++i) {
+    void* data = env->GetPrimitiveArrayCritical(array, nullptr);
+    CHECK(data != nullptr);
+    env->ReleasePrimitiveArrayCritical(array, data, JNI_ABORT);
+  }
+}
+
+extern "C" JNIEXPORT void JNICALL Java_JniMicroBenchmark_getByteArrayElements(
+    JNIEnv* env, jobject, jint reps, jbyteArray array) {
+  for (jint i = 0; i < reps; ++i) {
+    jbyte* data = env->GetByteArrayElements(array, nullptr);
+    CHECK(data != nullptr);
+    env->ReleaseByteArrayElements(array, data, JNI_ABORT);
+  }
+}
+
+extern "C" JNIEXPORT void JNICALL Java_JniMicroBenchmark_monitorEnterExit(
+    JNIEnv* env, jobject, jint reps, jobject obj) {
+  for (jint i = 0; i < reps; ++i) {
+    CHECK_EQ(env->MonitorEnter(obj), JNI_OK);
+    CHECK_EQ(env->MonitorExit(obj), JNI_OK);
+  }
+}
+
+}  // namespace
+}  // namespace art
@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import com.google.caliper.SimpleBenchmark;
+
+public class JniMicroBenchmark extends SimpleBenchmark {
+  private static final String TEXT =
+      "Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod tempor.";
+
+  private final byte[] bytes = new byte[4096];
+
+  public JniMicroBenchmark() {
+    // Make sure to link methods before benchmark starts.
+    System.loadLibrary("artbenchmark");
+    timeLocalRef(1);
+    timeGlobalRef(1);
+    timeGetStringUTFChars(1);
+    timeGetStringCritical(1);
+    timeGetPrimitiveArrayCritical(1);
+    timeGetByteArrayElements(1);
+    timeMonitorEnterExit(1);
+  }
+
+  public void timeLocalRef(int reps) {
+    localRef(reps, this);
+  }
+
+  public void timeGlobalRef(int reps) {
+    globalRef(reps, this);
+  }
+
+  public void timeGetStringUTFChars(int reps) {
+    getStringUTFChars(reps, TEXT);
+  }
+
+  public void timeGetStringCritical(int reps) {
+    getStringCritical(reps, TEXT);
+  }
+
+  public void timeGetPrimitiveArrayCritical(int reps) {
+    getPrimitiveArrayCritical(reps, bytes);
+  }
+
+  public void timeGetByteArrayElements(int reps) {
+    getByteArrayElements(reps, bytes);
+  }
+
+  public void timeMonitorEnterExit(int reps) {
+    monitorEnterExit(reps, this);
+  }
+
+  private native void localRef(int reps, Object obj);
+  private native void globalRef(int reps, Object obj);
+  private native void getStringUTFChars(int reps, String s);
+  private native void getStringCritical(int reps, String s);
+  private native void getPrimitiveArrayCritical(int reps, byte[] array);
+  private native void getByteArrayElements(int reps, byte[] array);
+  private native void monitorEnterExit(int reps, Object obj);
+}
@@ -0,0 +1,185 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "jni.h"
+
+#include <pthread.h>
+#include <stdio.h>
+
+#include "base/mutex.h"
+#include "gc/accounting/card_table-inl.h"
+#include "gc/heap.h"
+#include "gc/space/space.h"
+#include "handle_scope-inl.h"
+#include "intern_table.h"
+#include "mirror/object-inl.h"
+#include "mirror/object_array-inl.h"
+#include "runtime.h"
+#include "scoped_thread_state_change.h"
+#include "stack.h"
+#include "thread.h"
+
+namespace art {
+namespace {
+
+// Array lengths picked so that the allocations fall into different size
+// classes of the allocator: a small, a medium and a large payload.
+static constexpr size_t kSmallArrayLength = 16;
+static constexpr size_t kMediumArrayLength = 1024;
+static constexpr size_t kLargeArrayLength = 64 * 1024;
+
+static void AllocByteArrays(Thread* self, jint reps, size_t length)
+    SHARED_REQUIRES(Locks::mutator_lock_) {
+  for (jint i = 0; i < reps; ++i) {
+    CHECK(mirror::ByteArray::Alloc(self, length) != nullptr);
+  }
+}
+
+extern "C" JNIEXPORT void JNICALL Java_MicroRuntimeBenchmark_timeAllocSmallByteArray(
+    JNIEnv* env, jobject, jint reps) {
+  ScopedObjectAccess soa(env);
+  AllocByteArrays(soa.Self(), reps, kSmallArrayLength);
+}
+
+extern "C" JNIEXPORT void JNICALL Java_MicroRuntimeBenchmark_timeAllocMediumByteArray(
+    JNIEnv* env, jobject, jint reps) {
+  ScopedObjectAccess soa(env);
+  AllocByteArrays(soa.Self(), reps, kMediumArrayLength);
+}
+
+extern "C" JNIEXPORT void JNICALL Java_MicroRuntimeBenchmark_timeAllocLargeByteArray(
+    JNIEnv* env, jobject, jint reps) {
+  ScopedObjectAccess soa(env);
+  AllocByteArrays(soa.Self(), reps, kLargeArrayLength);
+}
+
+extern "C" JNIEXPORT void JNICALL Java_MicroRuntimeBenchmark_timeInternStrongLookup(
+    JNIEnv* env, jobject, jint reps) {
+  ScopedObjectAccess soa(env);
+  InternTable* const intern_table = Runtime::Current()->GetInternTable();
+  // Warm the entry so every iteration measures the hit path.
+  CHECK(intern_table->InternStrong("micro-runtime-benchmark") != nullptr);
+  for (jint i = 0; i < reps; ++i) {
+    CHECK(intern_table->InternStrong("micro-runtime-benchmark") != nullptr);
+  }
+}
+
+extern "C" JNIEXPORT void JNICALL Java_MicroRuntimeBenchmark_timeInternStrongInsert(
+    JNIEnv* env, jobject, jint reps) {
+  ScopedObjectAccess soa(env);
+  InternTable* const intern_table = Runtime::Current()->GetInternTable();
+  // Cycle through a bounded set of names so the table does not grow without
+  // limit; after the first cycle this mixes insert misses with lookup hits.
+  char name[64];
+  for (jint i = 0; i < reps; ++i) {
+    snprintf(name, sizeof(name), "micro-runtime-benchmark-%d", i & 1023);
+    CHECK(intern_table->InternStrong(name) != nullptr);
+  }
+}
+
+extern "C" JNIEXPORT void JNICALL Java_MicroRuntimeBenchmark_timeThinLockEnterExit(
+    JNIEnv* env, jobject jobj, jint reps) {
+  ScopedObjectAccess soa(env);
+  StackHandleScope<1> hs(soa.Self());
+  Handle<mirror::Object> obj(hs.NewHandle(soa.Decode<mirror::Object*>(jobj)));
+  for (jint i = 0; i < reps; ++i) {
+    obj->MonitorEnter(soa.Self());
+    obj->MonitorExit(soa.Self());
+  }
+}
+
+extern "C" JNIEXPORT void JNICALL Java_MicroRuntimeBenchmark_timeInflatedMonitorEnterExit(
+    JNIEnv* env, jobject jobj, jint reps) {
+  ScopedObjectAccess soa(env);
+  StackHandleScope<1> hs(soa.Self());
+  Handle<mirror::Object> obj(hs.NewHandle(soa.Decode<mirror::Object*>(jobj)));
+  // Taking the identity hash code puts it in the lock word, so the first
+  // MonitorEnter below inflates the lock and it stays fat from then on.
+  obj->IdentityHashCode();
+  for (jint i = 0; i < reps; ++i) {
+    obj->MonitorEnter(soa.Self());
+    obj->MonitorExit(soa.Self());
+  }
+}
+
+static void* AttachDetachThread(void* arg) {
+  JavaVM* vm = reinterpret_cast<JavaVM*>(arg);
+  JNIEnv* env = nullptr;
+  CHECK_EQ(vm->AttachCurrentThread(&env, nullptr), JNI_OK);
+  CHECK_EQ(vm->DetachCurrentThread(), JNI_OK);
+  return nullptr;
+}
+
+extern "C" JNIEXPORT void JNICALL Java_MicroRuntimeBenchmark_timeThreadAttachDetach(
+    JNIEnv* env, jobject, jint reps) {
+  // Measures thread creation plus attach/detach, which includes creating and
+  // tearing down the java.lang.Thread peer.
+  JavaVM* vm = nullptr;
+  CHECK_EQ(env->GetJavaVM(&vm), JNI_OK);
+  for (jint i = 0; i < reps; ++i) {
+    pthread_t pthread;
+    CHECK_EQ(pthread_create(&pthread, nullptr, AttachDetachThread, vm), 0);
+    CHECK_EQ(pthread_join(pthread, nullptr), 0);
+  }
+}
+
+class CountStackVisitor : public StackVisitor {
+ public:
+  explicit CountStackVisitor(Thread* self) SHARED_REQUIRES(Locks::mutator_lock_)
+      : StackVisitor(self, nullptr, StackWalkKind::kIncludeInlinedFrames), frame_count(0u) {}
+
+  bool VisitFrame() OVERRIDE SHARED_REQUIRES(Locks::mutator_lock_) {
+    ++frame_count;
+    return true;
+  }
+
+  size_t frame_count;
+};
+
+extern "C" JNIEXPORT void JNICALL Java_MicroRuntimeBenchmark_walkStack(
+    JNIEnv* env, jobject, jint reps) {
+  ScopedObjectAccess soa(env);
+  for (jint i = 0; i < reps; ++i) {
+    CountStackVisitor visitor(soa.Self());
+    visitor.WalkStack();
+    CHECK_GT(visitor.frame_count, 0u);
+  }
+}
+
+extern "C" JNIEXPORT void JNICALL Java_MicroRuntimeBenchmark_timeCardTableScan(
+    JNIEnv* env, jobject jobj, jint reps) {
+  ScopedObjectAccess soa(env);
+  gc::Heap* const heap = Runtime::Current()->GetHeap();
+  mirror::Object* obj = soa.Decode<mirror::Object*>(jobj);
+  gc::space::ContinuousSpace* const space =
+      heap->FindContinuousSpaceFromObject(obj, /* fail_ok */ false);
+  gc::accounting::CardTable* const card_table = heap->GetCardTable();
+  // Dirty the benchmark object's card so the scan has something to visit.
+  card_table->MarkCard(obj);
+  WriterMutexLock mu(soa.Self(), *Locks::heap_bitmap_lock_);
+  size_t total_cards = 0;
+  for (jint i = 0; i < reps; ++i) {
+    total_cards += card_table->Scan</* kClearCard */ false>(
+        space->GetLiveBitmap(),
+        space->Begin(),
+        space->End(),
+        [](mirror::Object* scanned ATTRIBUTE_UNUSED) {});
+  }
+  CHECK_GT(total_cards, 0u);
+}
+
+}  // namespace
+}  // namespace art
@@ -0,0 +1,64 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import com.google.caliper.SimpleBenchmark;
+
+public class MicroRuntimeBenchmark extends SimpleBenchmark {
+  public MicroRuntimeBenchmark() {
+    // Make sure to link methods before benchmark starts.
+    System.loadLibrary("artbenchmark");
+    timeAllocSmallByteArray(1);
+    timeAllocMediumByteArray(1);
+    timeAllocLargeByteArray(1);
+    timeInternStrongLookup(1);
+    timeInternStrongInsert(1);
+    timeThinLockEnterExit(1);
+    timeInflatedMonitorEnterExit(1);
+    timeThreadAttachDetach(1);
+    walkStack(1);
+    timeCardTableScan(1);
+  }
+
+  public native void timeAllocSmallByteArray(int reps);
+  public native void timeAllocMediumByteArray(int reps);
+  public native void timeAllocLargeByteArray(int reps);
+  public native void timeInternStrongLookup(int reps);
+  public native void timeInternStrongInsert(int reps);
+  public native void timeThinLockEnterExit(int reps);
+  public native void timeInflatedMonitorEnterExit(int reps);
+  public native void timeThreadAttachDetach(int reps);
+  public native void timeCardTableScan(int reps);
+
+  private native void walkStack(int reps);
+
+  // Recurse to the given depth before walking the stack, so the walk cost
+  // can be compared across stack depths.
+  private void recurse(int depth, int reps) {
+    if (depth == 0) {
+      walkStack(reps);
+    } else {
+      recurse(depth - 1, reps);
+    }
+  }
+
+  public void timeWalkStackDepth10(int reps) {
+    recurse(10, reps);
+  }
+
+  public void timeWalkStackDepth100(int reps) {
+    recurse(100, reps);
+  }
+}
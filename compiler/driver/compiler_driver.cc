@@ -16,6 +16,7 @@
 
 #include "compiler_driver.h"
 
+#include <algorithm>
 #include <unordered_set>
 #include <vector>
 #include <unistd.h>
@@ -72,6 +73,7 @@
 #include "utils/swap_space.h"
 #include "verifier/method_verifier.h"
 #include "verifier/method_verifier-inl.h"
+#include "verifier/verification_cache.h"
 
 namespace art {
 
@@ -399,6 +401,7 @@ CompilerDriver::CompilerDriver(
       dex_files_for_oat_file_(nullptr),
       compiled_method_storage_(swap_fd),
       profile_compilation_info_(profile_compilation_info),
+      cached_verification_results_(nullptr),
       max_arena_alloc_(0),
       dex_to_dex_references_lock_("dex-to-dex references lock"),
       dex_to_dex_references_(),
@@ -1001,6 +1004,20 @@ bool CompilerDriver::ShouldVerifyClassBasedOnProfile(const DexFile& dex_file,
   return result;
 }
 
+bool CompilerDriver::CanSkipVerificationFromCache(const DexFile& dex_file,
+                                                  uint16_t class_def_idx) const {
+  if (cached_verification_results_ == nullptr) {
+    return false;
+  }
+  // Compiled code depends on per-method VerifiedMethod data which only fresh verification
+  // produces (CompileMethod() punts to the "required" dex-to-dex level without it), so only
+  // reuse the cached results for filters that do not AOT compile bytecode.
+  if (CompilerFilter::IsBytecodeCompilationEnabled(compiler_options_->GetCompilerFilter())) {
+    return false;
+  }
+  return cached_verification_results_->IsClassVerified(dex_file, class_def_idx);
+}
+
 class ResolveCatchBlockExceptionsClassVisitor : public ClassVisitor {
  public:
   ResolveCatchBlockExceptionsClassVisitor(
@@ -1896,13 +1913,34 @@ class ParallelCompilationManager {
 
   void ForAll(size_t begin, size_t end, CompilationVisitor* visitor, size_t work_units)
       REQUIRES(!*Locks::mutator_lock_) {
+    ForAllImpl(begin, end, /* order */ nullptr, visitor, work_units);
+  }
+
+  // Like ForAll(0, order.size(), ...) but visits order[i] instead of i. Indices are
+  // handed out dynamically through NextIndex(), so passing indices sorted by
+  // descending estimated cost yields largest-first scheduling: expensive work starts
+  // early and cannot be left to a single worker at the tail.
+  void ForAllWithOrder(const std::vector<uint16_t>& order,
+                       CompilationVisitor* visitor,
+                       size_t work_units)
+      REQUIRES(!*Locks::mutator_lock_) {
+    ForAllImpl(0u, order.size(), order.data(), visitor, work_units);
+  }
+
+ private:
+  void ForAllImpl(size_t begin,
+                  size_t end,
+                  const uint16_t* order,
+                  CompilationVisitor* visitor,
+                  size_t work_units)
+      REQUIRES(!*Locks::mutator_lock_) {
     Thread* self = Thread::Current();
     self->AssertNoPendingException();
     CHECK_GT(work_units, 0U);
 
     index_.StoreRelaxed(begin);
     for (size_t i = 0; i < work_units; ++i) {
-      thread_pool_->AddTask(self, new ForAllClosure(this, end, visitor));
+      thread_pool_->AddTask(self, new ForAllClosure(this, end, order, visitor));
     }
     thread_pool_->StartWorkers(self);
 
@@ -1921,12 +1959,15 @@ class ParallelCompilationManager {
     return index_.FetchAndAddSequentiallyConsistent(1);
   }
 
- private:
   class ForAllClosure : public Task {
    public:
-    ForAllClosure(ParallelCompilationManager* manager, size_t end, CompilationVisitor* visitor)
+    ForAllClosure(ParallelCompilationManager* manager,
+                  size_t end,
+                  const uint16_t* order,
+                  CompilationVisitor* visitor)
         : manager_(manager),
           end_(end),
+          order_(order),
           visitor_(visitor) {}
 
     virtual void Run(Thread* self) {
@@ -1935,7 +1976,7 @@ class ParallelCompilationManager {
         if (UNLIKELY(index >= end_)) {
           break;
         }
-        visitor_->Visit(index);
+        visitor_->Visit(order_ == nullptr ? index : order_[index]);
         self->AssertNoPendingException();
       }
     }
@@ -1947,6 +1988,7 @@ class ParallelCompilationManager {
    private:
     ParallelCompilationManager* const manager_;
     const size_t end_;
+    const uint16_t* const order_;
     CompilationVisitor* const visitor_;
   };
 
@@ -2232,6 +2274,50 @@ void CompilerDriver::Verify(jobject class_loader,
   }
 }
 
+// Marks a class as verified without running the method verifier, the way --verify-none
+// does: a resolved class gets kStatusVerified and its methods skip access checks. Used both
+// when verification is disabled altogether and when cached verification results from a
+// previous compilation cover the class.
+static void SetClassVerifiedWithoutVerifier(const ParallelCompilationManager* manager,
+                                            ScopedObjectAccess& soa,
+                                            size_t class_def_index)
+    SHARED_REQUIRES(Locks::mutator_lock_) {
+  const DexFile& dex_file = *manager->GetDexFile();
+  const DexFile::ClassDef& class_def = dex_file.GetClassDef(class_def_index);
+  const char* descriptor = dex_file.GetClassDescriptor(class_def);
+  ClassLinker* class_linker = manager->GetClassLinker();
+  jobject jclass_loader = manager->GetClassLoader();
+  StackHandleScope<3> hs(soa.Self());
+  Handle<mirror::ClassLoader> class_loader(
+      hs.NewHandle(soa.Decode<mirror::ClassLoader*>(jclass_loader)));
+  Handle<mirror::Class> klass(
+      hs.NewHandle(class_linker->FindClass(soa.Self(), descriptor, class_loader)));
+  // Class might have failed resolution. Then don't set it to verified.
+  if (klass.Get() != nullptr) {
+    // Only do this if the class is resolved. If even resolution fails, quickening will go very,
+    // very wrong.
+    if (klass->IsResolved()) {
+      if (klass->GetStatus() < mirror::Class::kStatusVerified) {
+        ObjectLock<mirror::Class> lock(soa.Self(), klass);
+        // Set class status to verified.
+        mirror::Class::SetStatus(klass, mirror::Class::kStatusVerified, soa.Self());
+        // Mark methods as pre-verified. If we don't do this, the interpreter will run with
+        // access checks.
+        klass->SetSkipAccessChecksFlagOnAllMethods(
+            GetInstructionSetPointerSize(manager->GetCompiler()->GetInstructionSet()));
+        klass->SetVerificationAttempted();
+      }
+      // Record the final class status if necessary.
+      ClassReference ref(manager->GetDexFile(), class_def_index);
+      manager->GetCompiler()->RecordClassStatus(ref, klass->GetStatus());
+    }
+  } else {
+    Thread* self = soa.Self();
+    DCHECK(self->IsExceptionPending());
+    self->ClearException();
+  }
+}
+
 class VerifyClassVisitor : public CompilationVisitor {
  public:
   VerifyClassVisitor(const ParallelCompilationManager* manager, LogSeverity log_level)
@@ -2245,6 +2331,12 @@ class VerifyClassVisitor : public CompilationVisitor {
       // Skip verification since the class is not in the profile.
       return;
     }
+    if (manager_->GetCompiler()->CanSkipVerificationFromCache(dex_file, class_def_index)) {
+      // The class verified against the same dex file and boot image during a previous
+      // compilation; mark it verified without re-running the verifier.
+      SetClassVerifiedWithoutVerifier(manager_, soa, class_def_index);
+      return;
+    }
     const DexFile::ClassDef& class_def = dex_file.GetClassDef(class_def_index);
     const char* descriptor = dex_file.GetClassDescriptor(class_def);
     ClassLinker* class_linker = manager_->GetClassLinker();
@@ -2332,40 +2424,7 @@ class SetVerifiedClassVisitor : public CompilationVisitor {
   virtual void Visit(size_t class_def_index) REQUIRES(!Locks::mutator_lock_) OVERRIDE {
     ATRACE_CALL();
     ScopedObjectAccess soa(Thread::Current());
-    const DexFile& dex_file = *manager_->GetDexFile();
-    const DexFile::ClassDef& class_def = dex_file.GetClassDef(class_def_index);
-    const char* descriptor = dex_file.GetClassDescriptor(class_def);
-    ClassLinker* class_linker = manager_->GetClassLinker();
-    jobject jclass_loader = manager_->GetClassLoader();
-    StackHandleScope<3> hs(soa.Self());
-    Handle<mirror::ClassLoader> class_loader(
-        hs.NewHandle(soa.Decode<mirror::ClassLoader*>(jclass_loader)));
-    Handle<mirror::Class> klass(
-        hs.NewHandle(class_linker->FindClass(soa.Self(), descriptor, class_loader)));
-    // Class might have failed resolution. Then don't set it to verified.
-    if (klass.Get() != nullptr) {
-      // Only do this if the class is resolved. If even resolution fails, quickening will go very,
-      // very wrong.
-      if (klass->IsResolved()) {
-        if (klass->GetStatus() < mirror::Class::kStatusVerified) {
-          ObjectLock<mirror::Class> lock(soa.Self(), klass);
-          // Set class status to verified.
-          mirror::Class::SetStatus(klass, mirror::Class::kStatusVerified, soa.Self());
-          // Mark methods as pre-verified. If we don't do this, the interpreter will run with
-          // access checks.
-          klass->SetSkipAccessChecksFlagOnAllMethods(
-              GetInstructionSetPointerSize(manager_->GetCompiler()->GetInstructionSet()));
-          klass->SetVerificationAttempted();
-        }
-        // Record the final class status if necessary.
-        ClassReference ref(manager_->GetDexFile(), class_def_index);
-        manager_->GetCompiler()->RecordClassStatus(ref, klass->GetStatus());
-      }
-    } else {
-      Thread* self = soa.Self();
-      DCHECK(self->IsExceptionPending());
-      self->ClearException();
-    }
+    SetClassVerifiedWithoutVerifier(manager_, soa, class_def_index);
   }
 
  private:
@@ -2426,11 +2485,24 @@ class InitializeClassVisitor : public CompilationVisitor {
           // fields.
           manager_->GetClassLinker()->EnsureInitialized(soa.Self(), klass, false, true);
           if (!klass->IsInitialized()) {
-            // We need to initialize static fields, we only do this for image classes that aren't
-            // marked with the $NoPreloadHolder (which implies this should not be initialized early).
-            bool can_init_static_fields = manager_->GetCompiler()->IsBootImage() &&
-                manager_->GetCompiler()->IsImageClass(descriptor) &&
-                !StringPiece(descriptor).ends_with("$NoPreloadHolder;");
+            // We need to initialize static fields. For the boot image we do this for image
+            // classes that aren't marked with the $NoPreloadHolder (which implies this should
+            // not be initialized early). For app images we do this for the classes recorded
+            // in the compilation profile, i.e. the classes resolved during profiled startups;
+            // an initializer whose side effects escape the app's own objects is rolled back
+            // below, so only provably self-contained initializers keep their result.
+            const bool is_boot_image = manager_->GetCompiler()->IsBootImage();
+            bool can_init_static_fields;
+            if (is_boot_image) {
+              can_init_static_fields = manager_->GetCompiler()->IsImageClass(descriptor) &&
+                  !StringPiece(descriptor).ends_with("$NoPreloadHolder;");
+            } else {
+              const ProfileCompilationInfo* profile_info =
+                  manager_->GetCompiler()->GetProfileCompilationInfo();
+              can_init_static_fields = manager_->GetCompiler()->IsAppImage() &&
+                  profile_info != nullptr &&
+                  profile_info->ContainsClass(dex_file, class_def_index);
+            }
             if (can_init_static_fields) {
               VLOG(compiler) << "Initializing: " << descriptor;
               // TODO multithreading support. We should ensure the current compilation thread has
@@ -2452,7 +2524,14 @@ class InitializeClassVisitor : public CompilationVisitor {
               ScopedAssertNoThreadSuspension ants(soa.Self(), "Transaction end");
               runtime->ExitTransactionMode();
 
-              if (!success) {
+              if (success && !is_boot_image && transaction.WroteToBootImage()) {
+                // The initializer wrote to an object in the boot image. Loading the app image
+                // cannot reproduce that side effect, so keep the class uninitialized.
+                VLOG(compiler) << "Rolling back initialization of " << descriptor
+                               << ": its initializer wrote to the boot image";
+                transaction.Rollback();
+                CHECK_EQ(old_status, klass->GetStatus()) << "Previous class status not restored";
+              } else if (!success) {
                 CHECK(soa.Self()->IsExceptionPending());
                 mirror::Throwable* exception = soa.Self()->GetException();
                 VLOG(compiler) << "Initialization of " << descriptor << " aborted because of "
@@ -2500,8 +2579,9 @@ void CompilerDriver::InitializeClasses(jobject jni_class_loader,
   ClassLinker* class_linker = Runtime::Current()->GetClassLinker();
   ParallelCompilationManager context(class_linker, jni_class_loader, this, &dex_file, dex_files,
                                      init_thread_pool);
-  if (IsBootImage()) {
-    // TODO: remove this when transactional mode supports multithreading.
+  if (IsBootImage() || (IsAppImage() && GetProfileCompilationInfo() != nullptr)) {
+    // TODO: remove this when transactional mode supports multithreading. App image
+    // compilation only runs initializers when a profile is given.
     init_thread_count = 1U;
   }
   InitializeClassVisitor visitor(&context);
@@ -2711,7 +2791,34 @@ void CompilerDriver::CompileDexFile(jobject class_loader,
   ParallelCompilationManager context(Runtime::Current()->GetClassLinker(), class_loader, this,
                                      &dex_file, dex_files, thread_pool);
   CompileClassVisitor visitor(&context);
-  context.ForAll(0, dex_file.NumClassDefs(), &visitor, thread_count);
+  // Estimate per-class compilation cost as the total size of its code items and
+  // compile the most expensive classes first. With the dynamic index distribution
+  // in ForAll this is largest-first scheduling; it keeps a giant (usually
+  // generated) class from being handed out last and leaving one worker running
+  // alone while the rest of the pool is idle.
+  const size_t num_class_defs = dex_file.NumClassDefs();
+  std::vector<uint32_t> cost(num_class_defs, 0u);
+  std::vector<uint16_t> order(num_class_defs);
+  for (size_t i = 0; i != num_class_defs; ++i) {
+    order[i] = static_cast<uint16_t>(i);
+    const uint8_t* class_data = dex_file.GetClassData(dex_file.GetClassDef(i));
+    if (class_data == nullptr) {
+      continue;
+    }
+    ClassDataItemIterator it(dex_file, class_data);
+    while (it.HasNextStaticField() || it.HasNextInstanceField()) {
+      it.Next();
+    }
+    for (; it.HasNext(); it.Next()) {
+      const DexFile::CodeItem* code_item = it.GetMethodCodeItem();
+      if (code_item != nullptr) {
+        cost[i] += code_item->insns_size_in_code_units_;
+      }
+    }
+  }
+  std::stable_sort(order.begin(), order.end(),
+                   [&cost](uint16_t lhs, uint16_t rhs) { return cost[lhs] > cost[rhs]; });
+  context.ForAllWithOrder(order, &visitor, thread_count);
 }
 
 void CompilerDriver::AddCompiledMethod(const MethodReference& method_ref,
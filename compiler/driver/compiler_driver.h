@@ -50,6 +50,7 @@ class DexCache;
 
 namespace verifier {
 class MethodVerifier;
+class VerificationCache;
 }  // namespace verifier
 
 class BitVector;
@@ -158,6 +159,11 @@ class CompilerDriver {
     return boot_image_;
   }
 
+  // Are we compiling and creating an app image file?
+  bool IsAppImage() const {
+    return app_image_;
+  }
+
   const std::unordered_set<std::string>* GetImageClasses() const {
     return image_classes_.get();
   }
@@ -438,6 +444,21 @@ class CompilerDriver {
   // according to the profile file.
   bool ShouldVerifyClassBasedOnProfile(const DexFile& dex_file, uint16_t class_idx) const;
 
+  // Returns the profile used for profile guided compilation, or null if there is none.
+  const ProfileCompilationInfo* GetProfileCompilationInfo() const {
+    return profile_compilation_info_;
+  }
+
+  // Sets verification results recorded by a previous compilation of the same dex files so
+  // that Verify() can skip re-verifying the classes they cover.
+  void SetCachedVerificationResults(const verifier::VerificationCache* cache) {
+    cached_verification_results_ = cache;
+  }
+
+  // Returns true if the class verified during a previous compilation against the same boot
+  // image and can be marked verified without running the verifier again.
+  bool CanSkipVerificationFromCache(const DexFile& dex_file, uint16_t class_def_idx) const;
+
   void RecordClassStatus(ClassReference ref, mirror::Class::Status status)
       REQUIRES(!compiled_classes_lock_);
 
@@ -709,6 +730,10 @@ class CompilerDriver {
   // Info for profile guided compilation.
   const ProfileCompilationInfo* const profile_compilation_info_;
 
+  // Verification results from a previous compilation of the same dex files, or null if
+  // there are none. Not owned by the driver.
+  const verifier::VerificationCache* cached_verification_results_;
+
   size_t max_arena_alloc_;
 
   // Data for delaying dex-to-dex compilation.
@@ -44,6 +44,7 @@ CompilerOptions::CompilerOptions()
       init_failure_output_(nullptr),
       dump_cfg_file_name_(""),
       dump_cfg_append_(false),
+      dump_pass_timings_file_name_(""),
       force_determinism_(false) {
 }
 
@@ -99,6 +100,7 @@ CompilerOptions::CompilerOptions(CompilerFilter::Filter compiler_filter,
     init_failure_output_(init_failure_output),
     dump_cfg_file_name_(dump_cfg_file_name),
     dump_cfg_append_(dump_cfg_append),
+    dump_pass_timings_file_name_(""),
     force_determinism_(force_determinism) {
 }
 
@@ -190,6 +192,8 @@ bool CompilerOptions::ParseCompilerOption(const StringPiece& option, UsageFn Usa
     dump_cfg_file_name_ = option.substr(strlen("--dump-cfg=")).data();
   } else if (option.starts_with("--dump-cfg-append")) {
     dump_cfg_append_ = true;
+  } else if (option.starts_with("--dump-pass-timings=")) {
+    dump_pass_timings_file_name_ = option.substr(strlen("--dump-pass-timings=")).data();
   } else {
     // Option not recognized.
     return false;
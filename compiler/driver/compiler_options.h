@@ -241,6 +241,10 @@ class CompilerOptions FINAL {
     return dump_cfg_append_;
   }
 
+  const std::string& GetDumpPassTimingsFileName() const {
+    return dump_pass_timings_file_name_;
+  }
+
   bool IsForceDeterminism() const {
     return force_determinism_;
   }
@@ -294,6 +298,9 @@ class CompilerOptions FINAL {
   std::string dump_cfg_file_name_;
   bool dump_cfg_append_;
 
+  // File to write the aggregated per-pass compile times to, empty when disabled.
+  std::string dump_pass_timings_file_name_;
+
   // Whether the compiler should trade performance for determinism to guarantee exactly reproducable
   // outcomes.
   bool force_determinism_;
@@ -31,6 +31,7 @@
 #include "elf_utils.h"
 #include "globals.h"
 #include "leb128.h"
+#include "linker/async_output_stream.h"
 #include "linker/buffered_output_stream.h"
 #include "linker/file_output_stream.h"
 #include "thread-inl.h"
@@ -155,7 +156,8 @@ ElfWriterQuick<ElfTypes>::ElfWriterQuick(InstructionSet instruction_set,
       rodata_size_(0u),
       text_size_(0u),
       bss_size_(0u),
-      output_stream_(MakeUnique<BufferedOutputStream>(MakeUnique<FileOutputStream>(elf_file))),
+      output_stream_(MakeUnique<BufferedOutputStream>(
+          MakeUnique<AsyncOutputStream>(MakeUnique<FileOutputStream>(elf_file)))),
       builder_(new ElfBuilder<ElfTypes>(instruction_set, features, output_stream_.get())) {}
 
 template <typename ElfTypes>
@@ -89,7 +89,8 @@ void ImageTest::TestWriteRead(ImageHeader::StorageMode storage_mode) {
                                                       /*compile_app_image*/false,
                                                       storage_mode,
                                                       oat_filename_vector,
-                                                      dex_file_to_oat_index_map));
+                                                      dex_file_to_oat_index_map,
+                                                      /*dirty_image_classes*/nullptr));
   // TODO: compile_pic should be a test argument.
   {
     {
@@ -577,6 +577,26 @@ void ImageWriter::AssignImageBinSlot(mirror::Object* object) {
           }
         }
       }
+
+      // Overrides the dirtiness-based bin: a class recorded in the compilation profile is
+      // touched during startup, so we pack all such classes together at the start of the
+      // image to minimize the number of pages faulted in at launch.
+      const ProfileCompilationInfo* profile_info = compiler_driver_.GetProfileCompilationInfo();
+      if (profile_info != nullptr &&
+          klass->GetDexClassDefIndex() != DexFile::kDexNoIndex16 &&
+          profile_info->ContainsClass(klass->GetDexFile(), klass->GetDexClassDefIndex())) {
+        bin = kBinProfileStartupClass;
+      }
+
+      // A class an imgdiag run observed dirty taints every page it lands on, so group such
+      // classes together no matter what the heuristics above concluded.
+      if (dirty_image_classes_ != nullptr) {
+        std::string temp;
+        if (dirty_image_classes_->find(klass->GetDescriptor(&temp)) !=
+            dirty_image_classes_->end()) {
+          bin = kBinKnownDirty;
+        }
+      }
     } else if (object->GetClass<kVerifyNone>()->IsStringClass()) {
       bin = kBinString;  // Strings are almost always immutable (except for object header).
     } else if (object->GetClass<kVerifyNone>() ==
@@ -2305,7 +2325,8 @@ ImageWriter::ImageWriter(
     bool compile_app_image,
     ImageHeader::StorageMode image_storage_mode,
     const std::vector<const char*>& oat_filenames,
-    const std::unordered_map<const DexFile*, size_t>& dex_file_oat_index_map)
+    const std::unordered_map<const DexFile*, size_t>& dex_file_oat_index_map,
+    const std::unordered_set<std::string>* dirty_image_classes)
     : compiler_driver_(compiler_driver),
       global_image_begin_(reinterpret_cast<uint8_t*>(image_begin)),
       image_objects_offset_begin_(0),
@@ -2317,7 +2338,8 @@ ImageWriter::ImageWriter(
       clean_methods_(0u),
       image_storage_mode_(image_storage_mode),
       oat_filenames_(oat_filenames),
-      dex_file_oat_index_map_(dex_file_oat_index_map) {
+      dex_file_oat_index_map_(dex_file_oat_index_map),
+      dirty_image_classes_(dirty_image_classes) {
   CHECK_NE(image_begin, 0U);
   std::fill_n(image_methods_, arraysize(image_methods_), nullptr);
   CHECK_EQ(compile_app_image, !Runtime::Current()->GetHeap()->GetBootImageSpaces().empty())
@@ -61,7 +61,8 @@ class ImageWriter FINAL {
               bool compile_app_image,
               ImageHeader::StorageMode image_storage_mode,
               const std::vector<const char*>& oat_filenames,
-              const std::unordered_map<const DexFile*, size_t>& dex_file_oat_index_map);
+              const std::unordered_map<const DexFile*, size_t>& dex_file_oat_index_map,
+              const std::unordered_set<std::string>* dirty_image_classes);
 
   bool PrepareImageAddressSpace();
 
@@ -151,6 +152,13 @@ class ImageWriter FINAL {
   // Classify different kinds of bins that objects end up getting packed into during image writing.
   // Ordered from dirtiest to cleanest (until ArtMethods).
   enum Bin {
+    // Classes recorded in the compilation profile are touched during application startup.
+    // Packing them first keeps the pages faulted in at launch contiguous, regardless of
+    // their expected dirtiness.
+    kBinProfileStartupClass,
+    // Classes observed owning dirty objects at runtime (imgdiag feedback). Packing them
+    // together keeps the pages they taint away from the likely-clean bins.
+    kBinKnownDirty,
     kBinMiscDirty,                // Dex caches, object locks, etc...
     kBinClassVerified,            // Class verified, but initializers haven't been run
     // Unknown mix of clean/dirty:
@@ -563,6 +571,10 @@ class ImageWriter FINAL {
   // Map of dex files to the indexes of oat files that they were compiled into.
   const std::unordered_map<const DexFile*, size_t>& dex_file_oat_index_map_;
 
+  // Descriptors of classes an imgdiag run identified as dirty at runtime, or null if no such
+  // report was provided. These classes are packed into their own bin.
+  const std::unordered_set<std::string>* dirty_image_classes_;
+
   friend class ContainsBootClassLoaderNonImageClassVisitor;
   friend class FixupClassVisitor;
   friend class FixupRootVisitor;
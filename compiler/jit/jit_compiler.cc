@@ -103,7 +103,9 @@ JitCompiler::JitCompiler() {
       CompilerOptions::kDefaultGenerateDebugInfo,
       /* implicit_null_checks */ true,
       /* implicit_so_checks */ true,
-      /* implicit_suspend_checks */ false,
+      // Only the ARM fault handlers recognize the implicit suspend check poll.
+      /* implicit_suspend_checks */ kRuntimeISA == kArm || kRuntimeISA == kThumb2 ||
+          kRuntimeISA == kArm64,
       /* pic */ true,  // TODO: Support non-PIC in optimizing.
       /* verbose_methods */ nullptr,
       /* init_failure_output */ nullptr,
@@ -66,6 +66,11 @@ CompiledMethod* ArtJniCompileMethodInternal(CompilerDriver* driver,
   CHECK(is_native);
   const bool is_static = (access_flags & kAccStatic) != 0;
   const bool is_synchronized = (access_flags & kAccSynchronized) != 0;
+  // Methods annotated as fast JNI at build time call the fast entrypoints, which stay runnable
+  // instead of transitioning to the native state. Synchronized methods take the normal path so
+  // that monitor operations may suspend the thread.
+  const bool is_fast_native =
+      !is_synchronized && dex_file.HasFastNativeMethodBuildAnnotation(method_idx);
   const char* shorty = dex_file.GetMethodShorty(dex_file.GetMethodId(method_idx));
   InstructionSet instruction_set = driver->GetInstructionSet();
   const InstructionSetFeatures* instruction_set_features = driver->GetInstructionSetFeatures();
@@ -245,10 +250,16 @@ CompiledMethod* ArtJniCompileMethodInternal(CompilerDriver* driver,
   //    can occur. The result is the saved JNI local state that is restored by the exit call. We
   //    abuse the JNI calling convention here, that is guaranteed to support passing 2 pointer
   //    arguments.
-  ThreadOffset<4> jni_start32 = is_synchronized ? QUICK_ENTRYPOINT_OFFSET(4, pJniMethodStartSynchronized)
-                                                : QUICK_ENTRYPOINT_OFFSET(4, pJniMethodStart);
-  ThreadOffset<8> jni_start64 = is_synchronized ? QUICK_ENTRYPOINT_OFFSET(8, pJniMethodStartSynchronized)
-                                                : QUICK_ENTRYPOINT_OFFSET(8, pJniMethodStart);
+  ThreadOffset<4> jni_start32 =
+      is_synchronized
+          ? QUICK_ENTRYPOINT_OFFSET(4, pJniMethodStartSynchronized)
+          : (is_fast_native ? QUICK_ENTRYPOINT_OFFSET(4, pJniMethodFastStart)
+                            : QUICK_ENTRYPOINT_OFFSET(4, pJniMethodStart));
+  ThreadOffset<8> jni_start64 =
+      is_synchronized
+          ? QUICK_ENTRYPOINT_OFFSET(8, pJniMethodStartSynchronized)
+          : (is_fast_native ? QUICK_ENTRYPOINT_OFFSET(8, pJniMethodFastStart)
+                            : QUICK_ENTRYPOINT_OFFSET(8, pJniMethodStart));
   main_jni_conv->ResetIterator(FrameOffset(main_out_arg_size));
   FrameOffset locked_object_handle_scope_offset(0);
   if (is_synchronized) {
@@ -267,29 +278,55 @@ CompiledMethod* ArtJniCompileMethodInternal(CompilerDriver* driver,
     }
     main_jni_conv->Next();
   }
-  if (main_jni_conv->IsCurrentParamInRegister()) {
-    __ GetCurrentThread(main_jni_conv->CurrentParamRegister());
+  FrameOffset saved_cookie_offset = main_jni_conv->SavedLocalReferenceCookieOffset();
+  if (is_fast_native && main_jni_conv->IsCurrentParamInRegister()) {
+    // Fast JNI methods stay runnable, so JniMethodFastStart does nothing but save the local
+    // reference cookie and open a new segment. Emit those two word copies inline instead of
+    // making the runtime call; JniMethodFastEnd pops the segment from the cookie slot as
+    // usual. The JNIEnv* parameter register is dead until the argument shuffle materializes
+    // the real JNIEnv*, so it can carry the environment pointer here. On x86 the parameters
+    // live on the stack and the runtime call is kept.
+    ManagedRegister jni_env_reg = main_jni_conv->CurrentParamRegister();
+    ManagedRegister scratch = main_jni_conv->InterproceduralScratchRegister();
+    const size_t pointer_size = is_64_bit_target ? 8u : 4u;
+    const Offset cookie_offset = JNIEnvExt::LocalRefCookieOffset(pointer_size);
+    const Offset segment_state_offset = JNIEnvExt::SegmentStateOffset(pointer_size);
     if (is_64_bit_target) {
-      __ Call(main_jni_conv->CurrentParamRegister(), Offset(jni_start64),
-              main_jni_conv->InterproceduralScratchRegister());
+      __ LoadRawPtrFromThread64(jni_env_reg, Thread::JniEnvOffset<8>());
     } else {
-      __ Call(main_jni_conv->CurrentParamRegister(), Offset(jni_start32),
-              main_jni_conv->InterproceduralScratchRegister());
+      __ LoadRawPtrFromThread32(jni_env_reg, Thread::JniEnvOffset<4>());
     }
+    __ Copy(saved_cookie_offset, jni_env_reg, cookie_offset, scratch, 4);
+    // The x86 assemblers implement register-to-register offset copies with a push/pop pair
+    // and expect no scratch register; the load/store architectures need one.
+    ManagedRegister reg_copy_scratch = (instruction_set == kX86 || instruction_set == kX86_64)
+        ? ManagedRegister::NoRegister()
+        : scratch;
+    __ Copy(jni_env_reg, cookie_offset, jni_env_reg, segment_state_offset, reg_copy_scratch, 4);
   } else {
-    __ GetCurrentThread(main_jni_conv->CurrentParamStackOffset(),
-                        main_jni_conv->InterproceduralScratchRegister());
-    if (is_64_bit_target) {
-      __ CallFromThread64(jni_start64, main_jni_conv->InterproceduralScratchRegister());
+    if (main_jni_conv->IsCurrentParamInRegister()) {
+      __ GetCurrentThread(main_jni_conv->CurrentParamRegister());
+      if (is_64_bit_target) {
+        __ Call(main_jni_conv->CurrentParamRegister(), Offset(jni_start64),
+                main_jni_conv->InterproceduralScratchRegister());
+      } else {
+        __ Call(main_jni_conv->CurrentParamRegister(), Offset(jni_start32),
+                main_jni_conv->InterproceduralScratchRegister());
+      }
     } else {
-      __ CallFromThread32(jni_start32, main_jni_conv->InterproceduralScratchRegister());
+      __ GetCurrentThread(main_jni_conv->CurrentParamStackOffset(),
+                          main_jni_conv->InterproceduralScratchRegister());
+      if (is_64_bit_target) {
+        __ CallFromThread64(jni_start64, main_jni_conv->InterproceduralScratchRegister());
+      } else {
+        __ CallFromThread32(jni_start32, main_jni_conv->InterproceduralScratchRegister());
+      }
     }
+    if (is_synchronized) {  // Check for exceptions from monitor enter.
+      __ ExceptionPoll(main_jni_conv->InterproceduralScratchRegister(), main_out_arg_size);
+    }
+    __ Store(saved_cookie_offset, main_jni_conv->IntReturnRegister(), 4);
   }
-  if (is_synchronized) {  // Check for exceptions from monitor enter.
-    __ ExceptionPoll(main_jni_conv->InterproceduralScratchRegister(), main_out_arg_size);
-  }
-  FrameOffset saved_cookie_offset = main_jni_conv->SavedLocalReferenceCookieOffset();
-  __ Store(saved_cookie_offset, main_jni_conv->IntReturnRegister(), 4);
 
   // 7. Iterate over arguments placing values from managed calling convention in
   //    to the convention required for a native call (shuffling). For references
@@ -410,17 +447,29 @@ CompiledMethod* ArtJniCompileMethodInternal(CompilerDriver* driver,
   ThreadOffset<8> jni_end64(-1);
   if (reference_return) {
     // Pass result.
-    jni_end32 = is_synchronized ? QUICK_ENTRYPOINT_OFFSET(4, pJniMethodEndWithReferenceSynchronized)
-                                : QUICK_ENTRYPOINT_OFFSET(4, pJniMethodEndWithReference);
-    jni_end64 = is_synchronized ? QUICK_ENTRYPOINT_OFFSET(8, pJniMethodEndWithReferenceSynchronized)
-                                : QUICK_ENTRYPOINT_OFFSET(8, pJniMethodEndWithReference);
+    jni_end32 =
+        is_synchronized
+            ? QUICK_ENTRYPOINT_OFFSET(4, pJniMethodEndWithReferenceSynchronized)
+            : (is_fast_native ? QUICK_ENTRYPOINT_OFFSET(4, pJniMethodFastEndWithReference)
+                              : QUICK_ENTRYPOINT_OFFSET(4, pJniMethodEndWithReference));
+    jni_end64 =
+        is_synchronized
+            ? QUICK_ENTRYPOINT_OFFSET(8, pJniMethodEndWithReferenceSynchronized)
+            : (is_fast_native ? QUICK_ENTRYPOINT_OFFSET(8, pJniMethodFastEndWithReference)
+                              : QUICK_ENTRYPOINT_OFFSET(8, pJniMethodEndWithReference));
     SetNativeParameter(jni_asm.get(), end_jni_conv.get(), end_jni_conv->ReturnRegister());
     end_jni_conv->Next();
   } else {
-    jni_end32 = is_synchronized ? QUICK_ENTRYPOINT_OFFSET(4, pJniMethodEndSynchronized)
-                                : QUICK_ENTRYPOINT_OFFSET(4, pJniMethodEnd);
-    jni_end64 = is_synchronized ? QUICK_ENTRYPOINT_OFFSET(8, pJniMethodEndSynchronized)
-                                : QUICK_ENTRYPOINT_OFFSET(8, pJniMethodEnd);
+    jni_end32 =
+        is_synchronized
+            ? QUICK_ENTRYPOINT_OFFSET(4, pJniMethodEndSynchronized)
+            : (is_fast_native ? QUICK_ENTRYPOINT_OFFSET(4, pJniMethodFastEnd)
+                              : QUICK_ENTRYPOINT_OFFSET(4, pJniMethodEnd));
+    jni_end64 =
+        is_synchronized
+            ? QUICK_ENTRYPOINT_OFFSET(8, pJniMethodEndSynchronized)
+            : (is_fast_native ? QUICK_ENTRYPOINT_OFFSET(8, pJniMethodFastEnd)
+                              : QUICK_ENTRYPOINT_OFFSET(8, pJniMethodEnd));
   }
   // Pass saved local reference state.
   if (end_jni_conv->IsCurrentParamOnStack()) {
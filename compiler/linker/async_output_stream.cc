@@ -0,0 +1,152 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "async_output_stream.h"
+
+#include <vector>
+
+#include "base/logging.h"
+#include "runtime.h"
+#include "thread-inl.h"
+#include "thread_pool.h"
+
+namespace art {
+
+class AsyncOutputStream::WriteTask FINAL : public SelfDeletingTask {
+ public:
+  WriteTask(AsyncOutputStream* stream, const uint8_t* buffer, size_t byte_count)
+      : stream_(stream), buffer_(buffer, buffer + byte_count) {}
+
+  void Run(Thread* self ATTRIBUTE_UNUSED) OVERRIDE {
+    if (stream_->good_.LoadRelaxed() &&
+        !stream_->out_->WriteFully(buffer_.data(), buffer_.size())) {
+      PLOG(ERROR) << "Failed to write " << buffer_.size() << " bytes to "
+                  << stream_->GetLocation();
+      stream_->good_.StoreRelaxed(false);
+    }
+    stream_->pending_bytes_.FetchAndSubSequentiallyConsistent(buffer_.size());
+  }
+
+ private:
+  AsyncOutputStream* const stream_;
+  const std::vector<uint8_t> buffer_;
+};
+
+class AsyncOutputStream::SeekTask FINAL : public SelfDeletingTask {
+ public:
+  SeekTask(AsyncOutputStream* stream, off_t offset, Whence whence)
+      : stream_(stream), offset_(offset), whence_(whence) {}
+
+  void Run(Thread* self ATTRIBUTE_UNUSED) OVERRIDE {
+    if (stream_->good_.LoadRelaxed() &&
+        stream_->out_->Seek(offset_, whence_) == static_cast<off_t>(-1)) {
+      PLOG(ERROR) << "Failed to seek in " << stream_->GetLocation() << ". Offset=" << offset_
+                  << " whence=" << whence_;
+      stream_->good_.StoreRelaxed(false);
+    }
+  }
+
+ private:
+  AsyncOutputStream* const stream_;
+  const off_t offset_;
+  const Whence whence_;
+};
+
+AsyncOutputStream::AsyncOutputStream(std::unique_ptr<OutputStream> out)
+    : OutputStream(out->GetLocation()),  // Before out is moved to out_.
+      out_(std::move(out)),
+      offset_(0) {
+  pending_bytes_.StoreRelaxed(0u);
+  good_.StoreRelaxed(true);
+}
+
+AsyncOutputStream::~AsyncOutputStream() {
+  WaitForPendingOperations();
+}
+
+bool AsyncOutputStream::EnsureWorkerStarted() {
+  if (pool_ == nullptr) {
+    if (Runtime::Current() == nullptr) {
+      return false;
+    }
+    pool_.reset(new ThreadPool("Output stream writer", 1u));
+    pool_->StartWorkers(Thread::Current());
+  }
+  return true;
+}
+
+void AsyncOutputStream::WaitForPendingOperations() {
+  if (pool_ != nullptr) {
+    // do_work is false: if the producing thread popped queued tasks itself, a later write
+    // could complete ahead of an earlier one still running on the worker.
+    pool_->Wait(Thread::Current(), /* do_work */ false, /* may_hold_locks */ false);
+  }
+}
+
+bool AsyncOutputStream::WriteFully(const void* buffer, size_t byte_count) {
+  offset_ += byte_count;
+  if (!EnsureWorkerStarted()) {
+    if (good_.LoadRelaxed() && !out_->WriteFully(buffer, byte_count)) {
+      PLOG(ERROR) << "Failed to write " << byte_count << " bytes to " << GetLocation();
+      good_.StoreRelaxed(false);
+    }
+    return true;
+  }
+  if (pending_bytes_.LoadRelaxed() > kMaxPendingBytes) {
+    WaitForPendingOperations();
+  }
+  pending_bytes_.FetchAndAddSequentiallyConsistent(byte_count);
+  pool_->AddTask(Thread::Current(),
+                 new WriteTask(this, reinterpret_cast<const uint8_t*>(buffer), byte_count));
+  return true;
+}
+
+off_t AsyncOutputStream::Seek(off_t offset, Whence whence) {
+  if (whence == kSeekEnd) {
+    // The resulting position depends on the file size, so all queued writes must land first.
+    WaitForPendingOperations();
+    off_t new_offset = good_.LoadRelaxed() ? out_->Seek(offset, kSeekEnd) : static_cast<off_t>(-1);
+    if (new_offset == static_cast<off_t>(-1)) {
+      good_.StoreRelaxed(false);
+      return new_offset;
+    }
+    offset_ = new_offset;
+    return new_offset;
+  }
+  DCHECK(whence == kSeekSet || whence == kSeekCurrent) << whence;
+  const off_t new_offset = (whence == kSeekSet) ? offset : offset_ + offset;
+  offset_ = new_offset;
+  if (!EnsureWorkerStarted()) {
+    if (good_.LoadRelaxed() && out_->Seek(offset, whence) == static_cast<off_t>(-1)) {
+      PLOG(ERROR) << "Failed to seek in " << GetLocation() << ". Offset=" << offset
+                  << " whence=" << whence;
+      good_.StoreRelaxed(false);
+    }
+    return new_offset;
+  }
+  pool_->AddTask(Thread::Current(), new SeekTask(this, offset, whence));
+  return new_offset;
+}
+
+bool AsyncOutputStream::Flush() {
+  WaitForPendingOperations();
+  if (good_.LoadRelaxed()) {
+    good_.StoreRelaxed(out_->Flush());
+  }
+  return good_.LoadRelaxed();
+}
+
+}  // namespace art
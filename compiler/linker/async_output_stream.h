@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_COMPILER_LINKER_ASYNC_OUTPUT_STREAM_H_
+#define ART_COMPILER_LINKER_ASYNC_OUTPUT_STREAM_H_
+
+#include <memory>
+
+#include "output_stream.h"
+
+#include "atomic.h"
+#include "globals.h"
+
+namespace art {
+
+class ThreadPool;
+
+// OutputStream wrapper that performs the actual writes on a background worker thread so that
+// oat serialization overlaps with the write() system calls instead of stalling on them.
+// Writes and seeks are forwarded in order through a single-worker thread pool; errors are
+// delayed and reported by Flush(), as the OutputStream contract permits. Operations fall back
+// to synchronous forwarding until the runtime exists, since pool workers need a runtime to
+// attach to.
+class AsyncOutputStream FINAL : public OutputStream {
+ public:
+  explicit AsyncOutputStream(std::unique_ptr<OutputStream> out);
+
+  ~AsyncOutputStream() OVERRIDE;
+
+  // This function always succeeds; write errors surface in Flush().
+  bool WriteFully(const void* buffer, size_t byte_count) OVERRIDE;
+
+  off_t Seek(off_t offset, Whence whence) OVERRIDE;
+
+  // Waits for all queued operations, then flushes the wrapped stream. Returns whether all
+  // operations since the last Flush() succeeded.
+  bool Flush() OVERRIDE;
+
+ private:
+  // Back-pressure bound: once this many bytes are queued but not yet written, the producing
+  // thread drains the queue before continuing so the copies cannot grow without limit.
+  static constexpr size_t kMaxPendingBytes = 8 * MB;
+
+  class WriteTask;
+  class SeekTask;
+
+  // Lazily start the worker pool; returns false when no runtime is available yet and the
+  // operation should be performed synchronously instead.
+  bool EnsureWorkerStarted();
+  void WaitForPendingOperations();
+
+  std::unique_ptr<OutputStream> const out_;
+  std::unique_ptr<ThreadPool> pool_;
+  // Shadow copy of the stream position, maintained so that Seek() can answer without waiting
+  // for the queue to drain.
+  off_t offset_;
+  Atomic<size_t> pending_bytes_;
+  Atomic<bool> good_;
+
+  DISALLOW_COPY_AND_ASSIGN(AsyncOutputStream);
+};
+
+}  // namespace art
+
+#endif  // ART_COMPILER_LINKER_ASYNC_OUTPUT_STREAM_H_
@@ -17,6 +17,7 @@
 #include "file_output_stream.h"
 #include "vector_output_stream.h"
 
+#include "async_output_stream.h"
 #include "base/unix_file/fd_file.h"
 #include "base/logging.h"
 #include "base/stl_util.h"
@@ -91,6 +92,23 @@ TEST_F(OutputStreamTest, Buffered) {
   CheckTestOutput(actual);
 }
 
+TEST_F(OutputStreamTest, Async) {
+  ScratchFile tmp;
+  {
+    AsyncOutputStream async_output_stream(MakeUnique<FileOutputStream>(tmp.GetFile()));
+    SetOutputStream(async_output_stream);
+    // CommonRuntimeTest provides a runtime, so the writes go through the worker thread; the
+    // interleaved seeks and writes check that queued operations stay ordered.
+    GenerateTestOutput();
+  }
+  std::unique_ptr<File> in(OS::OpenFileForReading(tmp.GetFilename().c_str()));
+  EXPECT_TRUE(in.get() != nullptr);
+  std::vector<uint8_t> actual(in->GetLength());
+  bool readSuccess = in->ReadFully(&actual[0], actual.size());
+  EXPECT_TRUE(readSuccess);
+  CheckTestOutput(actual);
+}
+
 TEST_F(OutputStreamTest, Vector) {
   std::vector<uint8_t> output;
   VectorOutputStream output_stream("test vector output", &output);
@@ -14,6 +14,8 @@
  * limitations under the License.
  */
 
+#include <zlib.h>
+
 #include "arch/instruction_set_features.h"
 #include "art_method-inl.h"
 #include "base/unix_file/fd_file.h"
@@ -787,4 +789,28 @@ TEST_F(OatTest, UpdateChecksum) {
   EXPECT_EQ(216138397U, oat_header->GetChecksum());
 }
 
+TEST_F(OatTest, UpdateChecksumWithPartial) {
+  InstructionSet insn_set = kX86;
+  std::string error_msg;
+  std::unique_ptr<const InstructionSetFeatures> insn_features(
+    InstructionSetFeatures::FromVariant(insn_set, "default", &error_msg));
+  ASSERT_TRUE(insn_features.get() != nullptr) << error_msg;
+  std::unique_ptr<OatHeader> oat_header(OatHeader::Create(insn_set,
+                                                          insn_features.get(),
+                                                          0u,
+                                                          nullptr));
+  // Folding an independently computed adler32 must match checksumming the
+  // bytes directly.
+  oat_header->UpdateChecksum(OatHeader::kOatMagic, sizeof(OatHeader::kOatMagic));
+  uint32_t partial = adler32(adler32(0L, Z_NULL, 0),
+                             OatHeader::kOatMagic,
+                             sizeof(OatHeader::kOatMagic));
+  oat_header->UpdateChecksumWithPartial(partial, sizeof(OatHeader::kOatMagic));
+  EXPECT_EQ(216138397U, oat_header->GetChecksum());
+
+  // A zero-length partial must not change the checksum.
+  oat_header->UpdateChecksumWithPartial(0u, 0u);
+  EXPECT_EQ(216138397U, oat_header->GetChecksum());
+}
+
 }  // namespace art
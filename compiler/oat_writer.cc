@@ -16,7 +16,11 @@
 
 #include "oat_writer.h"
 
+#include <string.h>
 #include <unistd.h>
+#include <algorithm>
+#include <thread>
+#include <unordered_map>
 #include <zlib.h>
 
 #include "arch/arm64/instruction_set_features_arm64.h"
@@ -38,6 +42,7 @@
 #include "gc/space/space.h"
 #include "handle_scope-inl.h"
 #include "image_writer.h"
+#include "jit/offline_profiling_info.h"
 #include "linker/multi_oat_relative_patcher.h"
 #include "linker/output_stream.h"
 #include "mirror/array.h"
@@ -63,6 +68,38 @@ const UnalignedDexFileHeader* AsUnalignedDexFileHeader(const uint8_t* raw_data)
     return reinterpret_cast<const UnalignedDexFileHeader*>(raw_data);
 }
 
+// Computes the adler32 of a large buffer in parallel slices and stitches the
+// results together with adler32_combine(). The bulk dex file checksum runs
+// before the runtime exists, so plain std::thread is used instead of the
+// runtime ThreadPool.
+uint32_t ComputeAdler32InParallel(const uint8_t* data, size_t size) {
+  static constexpr size_t kMinBytesPerThread = 4 * MB;
+  const size_t num_cpus = std::max<int64_t>(sysconf(_SC_NPROCESSORS_CONF), 1);
+  const size_t num_threads = std::min(num_cpus, size / kMinBytesPerThread);
+  if (num_threads <= 1u) {
+    return adler32(adler32(0L, Z_NULL, 0), data, size);
+  }
+  const size_t slice_size = size / num_threads;
+  std::vector<uint32_t> slice_checksums(num_threads, 0u);
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i != num_threads; ++i) {
+    const uint8_t* slice_data = data + i * slice_size;
+    const size_t length = (i + 1u == num_threads) ? size - i * slice_size : slice_size;
+    threads.emplace_back([&slice_checksums, i, slice_data, length]() {
+      slice_checksums[i] = adler32(adler32(0L, Z_NULL, 0), slice_data, length);
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  uint32_t checksum = adler32(0L, Z_NULL, 0);
+  for (size_t i = 0; i != num_threads; ++i) {
+    const size_t length = (i + 1u == num_threads) ? size - i * slice_size : slice_size;
+    checksum = adler32_combine(checksum, slice_checksums[i], length);
+  }
+  return checksum;
+}
+
 class ChecksumUpdatingOutputStream : public OutputStream {
  public:
   ChecksumUpdatingOutputStream(OutputStream* out, OatHeader* oat_header)
@@ -279,6 +316,7 @@ OatWriter::OatWriter(bool compiling_boot_image, TimingLogger* timings)
     size_(0u),
     bss_size_(0u),
     oat_data_offset_(0u),
+    code_layout_order_(),
     oat_header_(nullptr),
     size_dex_file_alignment_(0),
     size_executable_offset_alignment_(0),
@@ -455,9 +493,12 @@ bool OatWriter::WriteAndOpenDexFiles(
 
   // Do a bulk checksum update for Dex[] and TypeLookupTable[]. Doing it piece by
   // piece would be difficult because we're not using the OutpuStream directly.
+  // This is the dominant checksum cost for the boot class path, so the buffer
+  // is checksummed in parallel slices.
   if (!oat_dex_files_.empty()) {
     size_t size = size_after_type_lookup_tables - oat_dex_files_[0].dex_file_offset_;
-    oat_header_->UpdateChecksum(dex_files_map->Begin(), size);
+    oat_header_->UpdateChecksumWithPartial(
+        ComputeAdler32InParallel(dex_files_map->Begin(), size), size);
   }
 
   *opened_dex_files_map = std::move(dex_files_map);
@@ -576,6 +617,7 @@ class OatWriter::OatDexMethodVisitor : public DexMethodVisitor {
   OatDexMethodVisitor(OatWriter* writer, size_t offset)
     : DexMethodVisitor(writer, offset),
       oat_class_index_(0u),
+      classes_visited_(0u),
       method_offsets_index_(0u) {
   }
 
@@ -588,11 +630,21 @@ class OatWriter::OatDexMethodVisitor : public DexMethodVisitor {
 
   bool EndClass() {
     ++oat_class_index_;
+    ++classes_visited_;
     return DexMethodVisitor::EndClass();
   }
 
+  // Called by VisitDexMethodsInCodeOrder() before each StartClass() to visit
+  // classes out of definition order.
+  void SetOatClassIndex(size_t oat_class_index) {
+    oat_class_index_ = oat_class_index;
+  }
+
  protected:
   size_t oat_class_index_;
+  // Number of classes visited so far. This matches oat_class_index_ when visiting
+  // in definition order but not when VisitDexMethodsInCodeOrder() reorders classes.
+  size_t classes_visited_;
   size_t method_offsets_index_;
 };
 
@@ -669,7 +721,7 @@ class OatWriter::InitCodeMethodVisitor : public OatDexMethodVisitor {
 
   bool EndClass() {
     OatDexMethodVisitor::EndClass();
-    if (oat_class_index_ == writer_->oat_classes_.size()) {
+    if (classes_visited_ == writer_->oat_classes_.size()) {
       offset_ = writer_->relative_patcher_->ReserveSpaceEnd(offset_);
     }
     return true;
@@ -833,7 +885,8 @@ class OatWriter::InitCodeMethodVisitor : public OatDexMethodVisitor {
 class OatWriter::InitMapMethodVisitor : public OatDexMethodVisitor {
  public:
   InitMapMethodVisitor(OatWriter* writer, size_t offset)
-    : OatDexMethodVisitor(writer, offset) {
+    : OatDexMethodVisitor(writer, offset),
+      shared_bytes_(0u) {
   }
 
   bool VisitMethod(size_t class_def_method_index, const ClassDataItemIterator& it ATTRIBUTE_UNUSED)
@@ -850,9 +903,29 @@ class OatWriter::InitMapMethodVisitor : public OatDexMethodVisitor {
       if (map_size != 0u) {
         size_t offset = dedupe_map_.GetOrCreate(
             map.data(),
-            [this, map_size]() {
+            [this, map, map_size]() {
+              // Reuse the bytes of an already laid out table when this one is a prefix of it.
+              // Maps are self-delimiting when read (CodeInfo and quickening info decode their
+              // own extent from the content), so pointing a method at the first map_size bytes
+              // of a longer table decodes exactly as the original would. Only earlier tables
+              // are candidates: WriteMaps emits each table at its first in-order occurrence,
+              // so shared offsets must point backward.
+              if (map_size >= sizeof(uint64_t)) {
+                auto range = prefix_index_.equal_range(PrefixKey(map.data()));
+                for (auto it2 = range.first; it2 != range.second; ++it2) {
+                  const PrefixEntry& entry = it2->second;
+                  if (entry.size >= map_size && memcmp(entry.data, map.data(), map_size) == 0) {
+                    shared_bytes_ += map_size;
+                    return entry.offset;
+                  }
+                }
+              }
               uint32_t new_offset = offset_;
               offset_ += map_size;
+              if (map_size >= sizeof(uint64_t)) {
+                prefix_index_.emplace(PrefixKey(map.data()),
+                                      PrefixEntry { map.data(), new_offset, map_size });
+              }
               return new_offset;
             });
         // Code offset is not initialized yet, so set the map offset to 0u-offset.
@@ -865,10 +938,30 @@ class OatWriter::InitMapMethodVisitor : public OatDexMethodVisitor {
     return true;
   }
 
+  // Number of map bytes that methods share by referencing a prefix of another method's table.
+  size_t GetSharedBytes() const {
+    return shared_bytes_;
+  }
+
  private:
+  struct PrefixEntry {
+    const uint8_t* data;
+    uint32_t offset;
+    uint32_t size;
+  };
+
+  static uint64_t PrefixKey(const uint8_t* data) {
+    uint64_t key;
+    memcpy(&key, data, sizeof(key));
+    return key;
+  }
+
   // Deduplication is already done on a pointer basis by the compiler driver,
   // so we can simply compare the pointers to find out if things are duplicated.
   SafeMap<const uint8_t*, uint32_t> dedupe_map_;
+  // Already laid out tables, keyed by their first eight bytes for prefix lookups.
+  std::unordered_multimap<uint64_t, PrefixEntry> prefix_index_;
+  size_t shared_bytes_;
 };
 
 class OatWriter::InitImageMethodVisitor : public OatDexMethodVisitor {
@@ -977,7 +1070,7 @@ class OatWriter::WriteCodeMethodVisitor : public OatDexMethodVisitor {
 
   bool EndClass() SHARED_REQUIRES(Locks::mutator_lock_) {
     bool result = OatDexMethodVisitor::EndClass();
-    if (oat_class_index_ == writer_->oat_classes_.size()) {
+    if (classes_visited_ == writer_->oat_classes_.size()) {
       DCHECK(result);  // OatDexMethodVisitor::EndClass() never fails.
       offset_ = writer_->relative_patcher_->WriteThunks(out_, offset_);
       if (UNLIKELY(offset_ == 0u)) {
@@ -1328,16 +1421,85 @@ class OatWriter::WriteMapMethodVisitor : public OatDexMethodVisitor {
 };
 
 // Visit all methods from all classes in all dex files with the specified visitor.
+bool OatWriter::VisitClassMethods(const DexFile* dex_file,
+                                  size_t class_def_index,
+                                  DexMethodVisitor* visitor) {
+  if (UNLIKELY(!visitor->StartClass(dex_file, class_def_index))) {
+    return false;
+  }
+  const DexFile::ClassDef& class_def = dex_file->GetClassDef(class_def_index);
+  const uint8_t* class_data = dex_file->GetClassData(class_def);
+  if (class_data != nullptr) {  // ie not an empty class, such as a marker interface
+    ClassDataItemIterator it(*dex_file, class_data);
+    while (it.HasNextStaticField()) {
+      it.Next();
+    }
+    while (it.HasNextInstanceField()) {
+      it.Next();
+    }
+    size_t class_def_method_index = 0u;
+    while (it.HasNextDirectMethod()) {
+      if (!visitor->VisitMethod(class_def_method_index, it)) {
+        return false;
+      }
+      ++class_def_method_index;
+      it.Next();
+    }
+    while (it.HasNextVirtualMethod()) {
+      if (UNLIKELY(!visitor->VisitMethod(class_def_method_index, it))) {
+        return false;
+      }
+      ++class_def_method_index;
+      it.Next();
+    }
+  }
+  return visitor->EndClass();
+}
+
 bool OatWriter::VisitDexMethods(DexMethodVisitor* visitor) {
   for (const DexFile* dex_file : *dex_files_) {
     const size_t class_def_count = dex_file->NumClassDefs();
     for (size_t class_def_index = 0; class_def_index != class_def_count; ++class_def_index) {
-      if (UNLIKELY(!visitor->StartClass(dex_file, class_def_index))) {
+      if (UNLIKELY(!VisitClassMethods(dex_file, class_def_index, visitor))) {
         return false;
       }
+    }
+  }
+  return true;
+}
+
+bool OatWriter::VisitDexMethodsInCodeOrder(OatDexMethodVisitor* visitor) {
+  if (code_layout_order_.empty()) {
+    return VisitDexMethods(visitor);
+  }
+  for (const CodeLayoutClass& layout : code_layout_order_) {
+    visitor->SetOatClassIndex(layout.oat_class_index);
+    if (UNLIKELY(!VisitClassMethods(layout.dex_file, layout.class_def_index, visitor))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void OatWriter::InitCodeLayoutOrder() {
+  DCHECK(code_layout_order_.empty());
+  const ProfileCompilationInfo* profile_info = compiler_driver_->GetProfileCompilationInfo();
+  if (profile_info == nullptr || compiling_boot_image_) {
+    return;  // Keep the definition order.
+  }
+  // Cluster classes with profile-hot methods at the start of the executable code so that
+  // the hot working set shares pages and i-cache sets instead of being scattered across
+  // the whole .text section in definition order. Hot callers and their hot callees end
+  // up in the same cluster, so most hot calls stay within a few pages.
+  dchecked_vector<CodeLayoutClass> cold_classes;
+  size_t oat_class_index = 0u;
+  for (const DexFile* dex_file : *dex_files_) {
+    const size_t class_def_count = dex_file->NumClassDefs();
+    for (size_t class_def_index = 0; class_def_index != class_def_count; ++class_def_index) {
+      bool has_hot_method = false;
       const DexFile::ClassDef& class_def = dex_file->GetClassDef(class_def_index);
       const uint8_t* class_data = dex_file->GetClassData(class_def);
-      if (class_data != nullptr) {  // ie not an empty class, such as a marker interface
+      if (class_data != nullptr) {
         ClassDataItemIterator it(*dex_file, class_data);
         while (it.HasNextStaticField()) {
           it.Next();
@@ -1345,28 +1507,30 @@ bool OatWriter::VisitDexMethods(DexMethodVisitor* visitor) {
         while (it.HasNextInstanceField()) {
           it.Next();
         }
-        size_t class_def_method_index = 0u;
-        while (it.HasNextDirectMethod()) {
-          if (!visitor->VisitMethod(class_def_method_index, it)) {
-            return false;
-          }
-          ++class_def_method_index;
-          it.Next();
-        }
-        while (it.HasNextVirtualMethod()) {
-          if (UNLIKELY(!visitor->VisitMethod(class_def_method_index, it))) {
-            return false;
+        while (it.HasNextDirectMethod() || it.HasNextVirtualMethod()) {
+          if (profile_info->ContainsMethod(MethodReference(dex_file, it.GetMemberIndex()))) {
+            has_hot_method = true;
+            break;
           }
-          ++class_def_method_index;
           it.Next();
         }
       }
-      if (UNLIKELY(!visitor->EndClass())) {
-        return false;
+      CodeLayoutClass layout = { dex_file, class_def_index, oat_class_index };
+      ++oat_class_index;
+      if (has_hot_method) {
+        code_layout_order_.push_back(layout);
+      } else {
+        cold_classes.push_back(layout);
       }
     }
   }
-  return true;
+  if (code_layout_order_.empty()) {
+    // Nothing in the profile matches these dex files; keep the definition order.
+    return;
+  }
+  VLOG(compiler) << "Code layout: " << code_layout_order_.size() << " hot classes, "
+                 << cold_classes.size() << " cold classes";
+  code_layout_order_.insert(code_layout_order_.end(), cold_classes.begin(), cold_classes.end());
 }
 
 size_t OatWriter::InitOatHeader(InstructionSet instruction_set,
@@ -1418,6 +1582,10 @@ size_t OatWriter::InitOatMaps(size_t offset) {
   InitMapMethodVisitor visitor(this, offset);
   bool success = VisitDexMethods(&visitor);
   DCHECK(success);
+  if (visitor.GetSharedBytes() != 0u) {
+    VLOG(compiler) << "Saved " << visitor.GetSharedBytes()
+                   << " bytes of map tables by prefix sharing";
+  }
   offset = visitor.GetOffset();
 
   return offset;
@@ -1461,21 +1629,21 @@ size_t OatWriter::InitOatCode(size_t offset) {
 }
 
 size_t OatWriter::InitOatCodeDexFiles(size_t offset) {
-  #define VISIT(VisitorType)                          \
-    do {                                              \
-      VisitorType visitor(this, offset);              \
-      bool success = VisitDexMethods(&visitor);       \
-      DCHECK(success);                                \
-      offset = visitor.GetOffset();                   \
-    } while (false)
-
-  VISIT(InitCodeMethodVisitor);
+  InitCodeLayoutOrder();
+
+  {
+    InitCodeMethodVisitor visitor(this, offset);
+    bool success = VisitDexMethodsInCodeOrder(&visitor);
+    DCHECK(success);
+    offset = visitor.GetOffset();
+  }
   if (HasImage()) {
-    VISIT(InitImageMethodVisitor);
+    InitImageMethodVisitor visitor(this, offset);
+    bool success = VisitDexMethods(&visitor);
+    DCHECK(success);
+    offset = visitor.GetOffset();
   }
 
-  #undef VISIT
-
   return offset;
 }
 
@@ -1738,18 +1906,15 @@ size_t OatWriter::WriteCode(OutputStream* out, const size_t file_offset, size_t
 size_t OatWriter::WriteCodeDexFiles(OutputStream* out,
                                     const size_t file_offset,
                                     size_t relative_offset) {
-  #define VISIT(VisitorType)                                              \
-    do {                                                                  \
-      VisitorType visitor(this, out, file_offset, relative_offset);       \
-      if (UNLIKELY(!VisitDexMethods(&visitor))) {                         \
-        return 0;                                                         \
-      }                                                                   \
-      relative_offset = visitor.GetOffset();                              \
-    } while (false)
-
-  VISIT(WriteCodeMethodVisitor);
-
-  #undef VISIT
+  {
+    WriteCodeMethodVisitor visitor(this, out, file_offset, relative_offset);
+    // Visit in the same order as InitCodeMethodVisitor so that the code offsets
+    // assigned there line up with the code written here.
+    if (UNLIKELY(!VisitDexMethodsInCodeOrder(&visitor))) {
+      return 0;
+    }
+    relative_offset = visitor.GetOffset();
+  }
 
   size_code_alignment_ += relative_patcher_->CodeAlignmentSize();
   size_relative_call_thunks_ += relative_patcher_->RelativeCallThunksSize();
@@ -237,6 +237,23 @@ class OatWriter {
   // with a given DexMethodVisitor.
   bool VisitDexMethods(DexMethodVisitor* visitor);
 
+  // Visit the methods of a single class with a given DexMethodVisitor. This is the
+  // per-class part of VisitDexMethods(), exposed so that VisitDexMethodsInCodeOrder()
+  // can replay it for classes out of definition order.
+  bool VisitClassMethods(const DexFile* dex_file,
+                         size_t class_def_index,
+                         DexMethodVisitor* visitor);
+
+  // Visit all the methods in the .text layout order computed by InitCodeLayoutOrder(),
+  // or in definition order if no layout order was computed. Used only by the visitors
+  // that assign and write code offsets; all other visitors keep the definition order.
+  bool VisitDexMethodsInCodeOrder(OatDexMethodVisitor* visitor);
+
+  // Compute a profile-guided .text layout order that clusters classes with
+  // profile-hot methods at the start of the executable code. Leaves the order
+  // empty (i.e. definition order) for boot images and when there is no profile.
+  void InitCodeLayoutOrder();
+
   size_t InitOatHeader(InstructionSet instruction_set,
                        const InstructionSetFeatures* instruction_set_features,
                        uint32_t num_dex_files,
@@ -315,6 +332,18 @@ class OatWriter {
   // Offset of the oat data from the start of the mmapped region of the elf file.
   size_t oat_data_offset_;
 
+  // A class and its position in the oat file, used to describe the .text layout
+  // order when it differs from the definition order. See InitCodeLayoutOrder().
+  struct CodeLayoutClass {
+    const DexFile* dex_file;
+    size_t class_def_index;
+    size_t oat_class_index;
+  };
+
+  // Classes in .text emission order when profile-guided code layout is active.
+  // Empty when method code is laid out in definition order.
+  dchecked_vector<CodeLayoutClass> code_layout_order_;
+
   // data to write
   std::unique_ptr<OatHeader> oat_header_;
   dchecked_vector<OatDexFile> oat_dex_files_;
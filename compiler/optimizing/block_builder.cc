@@ -96,6 +96,9 @@ bool HBasicBlockBuilder::CreateBranchTargets() {
           MaybeCreateBlockAt(dex_pc, s_it.GetDexPcForCurrentIndex());
         }
       }
+      if (table.ShouldBuildSearchTree()) {
+        CreateSearchTreeBlocks(table, dex_pc, 0u, table.GetNumEntries(), /* is_root */ true);
+      }
     } else if (instruction.Opcode() == Instruction::MOVE_EXCEPTION) {
       // End the basic block after MOVE_EXCEPTION. This simplifies the later
       // stage of TryBoundary-block insertion.
@@ -158,6 +161,18 @@ void HBasicBlockBuilder::ConnectBasicBlocks() {
       block->AddSuccessor(graph_->GetExitBlock());
     } else if (instruction.IsSwitch()) {
       DexSwitchTable table(instruction, dex_pc);
+      if (table.ShouldBuildSearchTree()) {
+        // The search tree adds its default-case edges itself, including the one the
+        // fall-through handling below would otherwise create.
+        ConnectSearchTreeBlocks(block,
+                                table,
+                                dex_pc,
+                                dex_pc + instruction.SizeInCodeUnits(),
+                                0u,
+                                table.GetNumEntries());
+        block = nullptr;
+        continue;
+      }
       for (DexSwitchTableIterator s_it(table); !s_it.Done(); s_it.Advance()) {
         uint32_t target_dex_pc = dex_pc + s_it.CurrentTargetOffset();
         block->AddSuccessor(GetBlockAt(target_dex_pc));
@@ -187,6 +202,63 @@ void HBasicBlockBuilder::ConnectBasicBlocks() {
   graph_->AddBlock(graph_->GetExitBlock());
 }
 
+void HBasicBlockBuilder::CreateSearchTreeBlocks(const DexSwitchTable& table,
+                                                uint32_t dex_pc,
+                                                size_t lo,
+                                                size_t hi,
+                                                bool is_root) {
+  const size_t mid = lo + (hi - lo) / 2;
+  if (!is_root) {
+    // Block with the equality test against the key at `mid`. Store it under the payload
+    // dex_pc of the key for uniqueness but give it the dex_pc of the SWITCH instruction
+    // which it semantically belongs to. The root's test lives in the switch's own block.
+    MaybeCreateBlockAt(dex_pc, table.GetDexPcForIndex(mid));
+  }
+  if (hi - lo > 1u) {
+    // Interior node: block with the less-than test steering into the subtrees, stored
+    // under the payload dex_pc of the corresponding target entry.
+    MaybeCreateBlockAt(dex_pc, table.GetDexPcForIndex(table.GetNumEntries() + mid));
+    CreateSearchTreeBlocks(table, dex_pc, lo, mid, /* is_root */ false);
+    if (mid + 1u < hi) {
+      CreateSearchTreeBlocks(table, dex_pc, mid + 1u, hi, /* is_root */ false);
+    }
+  }
+}
+
+void HBasicBlockBuilder::ConnectSearchTreeBlocks(HBasicBlock* block,
+                                                 const DexSwitchTable& table,
+                                                 uint32_t dex_pc,
+                                                 uint32_t default_dex_pc,
+                                                 size_t lo,
+                                                 size_t hi) {
+  const size_t mid = lo + (hi - lo) / 2;
+  // Taken edge of the equality test: the case target of the key at `mid`.
+  block->AddSuccessor(GetBlockAt(dex_pc + table.GetEntryAt(table.GetFirstValueIndex() + mid)));
+  if (hi - lo == 1u) {
+    // Leaf node: a failed equality test means no key matches.
+    block->AddSuccessor(GetBlockAt(default_dex_pc));
+    return;
+  }
+  HBasicBlock* less_than_block = GetBlockAt(table.GetDexPcForIndex(table.GetNumEntries() + mid));
+  block->AddSuccessor(less_than_block);
+  graph_->AddBlock(less_than_block);
+  // The left subtree `[lo, mid)` is never empty here; the right one `[mid + 1, hi)` can be.
+  HBasicBlock* left_block = GetBlockAt(table.GetDexPcForIndex(lo + (mid - lo) / 2));
+  less_than_block->AddSuccessor(left_block);
+  graph_->AddBlock(left_block);
+  if (mid + 1u < hi) {
+    HBasicBlock* right_block =
+        GetBlockAt(table.GetDexPcForIndex((mid + 1u) + (hi - (mid + 1u)) / 2));
+    less_than_block->AddSuccessor(right_block);
+    graph_->AddBlock(right_block);
+    ConnectSearchTreeBlocks(left_block, table, dex_pc, default_dex_pc, lo, mid);
+    ConnectSearchTreeBlocks(right_block, table, dex_pc, default_dex_pc, mid + 1u, hi);
+  } else {
+    less_than_block->AddSuccessor(GetBlockAt(default_dex_pc));
+    ConnectSearchTreeBlocks(left_block, table, dex_pc, default_dex_pc, lo, mid);
+  }
+}
+
 // Returns the TryItem stored for `block` or nullptr if there is no info for it.
 static const DexFile::TryItem* GetTryItem(
     HBasicBlock* block,
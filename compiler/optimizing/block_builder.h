@@ -24,6 +24,8 @@
 
 namespace art {
 
+class DexSwitchTable;
+
 class HBasicBlockBuilder : public ValueObject {
  public:
   HBasicBlockBuilder(HGraph* graph,
@@ -61,6 +63,26 @@ class HBasicBlockBuilder : public ValueObject {
   void ConnectBasicBlocks();
   void InsertTryBoundaryBlocks();
 
+  // Creates the comparison blocks for the binary-search lowering of a sparse switch,
+  // covering the key range `[lo, hi)` of `table`. The root node's equality test lives
+  // in the block of the switch instruction itself and gets no block of its own.
+  void CreateSearchTreeBlocks(const DexSwitchTable& table,
+                              uint32_t dex_pc,
+                              size_t lo,
+                              size_t hi,
+                              bool is_root);
+
+  // Connects the blocks created by CreateSearchTreeBlocks. `block` holds the equality
+  // test of the middle key of `[lo, hi)`; edges out of it and out of the subtree blocks
+  // are added in the order the HIf instructions built later expect: taken first,
+  // not-taken second. Default-case edges target the block at `default_dex_pc`.
+  void ConnectSearchTreeBlocks(HBasicBlock* block,
+                               const DexSwitchTable& table,
+                               uint32_t dex_pc,
+                               uint32_t default_dex_pc,
+                               size_t lo,
+                               size_t hi);
+
   // Helper method which decides whether `catch_block` may have live normal
   // predecessors and thus whether a synthetic catch block needs to be created
   // to avoid mixing normal and exceptional predecessors.
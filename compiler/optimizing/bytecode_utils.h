@@ -64,6 +64,19 @@ class DexSwitchTable : public ValueObject {
                                 : static_cast<uint16_t>(Instruction::kPackedSwitchSignature));
     num_entries_ = table[1];
     values_ = reinterpret_cast<const int32_t*>(&table[2]);
+
+    // The dex format requires sparse-switch keys to be sorted in ascending order. We rely on
+    // this to build binary search trees for large tables, so check it instead of trusting it;
+    // unsorted (invalid) input simply falls back to the linear decision tree.
+    keys_sorted_ = sparse_;
+    if (sparse_) {
+      for (size_t i = 1; i < num_entries_; ++i) {
+        if (values_[i - 1] >= values_[i]) {
+          keys_sorted_ = false;
+          break;
+        }
+      }
+    }
   }
 
   uint16_t GetNumEntries() const {
@@ -106,7 +119,15 @@ class DexSwitchTable : public ValueObject {
   bool IsSparse() const { return sparse_; }
 
   bool ShouldBuildDecisionTree() {
-    return IsSparse() || GetNumEntries() <= kSmallSwitchThreshold;
+    return (IsSparse() && !ShouldBuildSearchTree()) || GetNumEntries() <= kSmallSwitchThreshold;
+  }
+
+  // Whether this table should be lowered as a balanced binary search tree of comparisons
+  // rather than a linear chain. Used for large sparse tables, where the chain needs O(n)
+  // branches on average; e.g. javac lowers string switches into a sparse switch over hash
+  // codes, which for parser-style code easily reaches dozens of entries.
+  bool ShouldBuildSearchTree() const {
+    return sparse_ && num_entries_ > kSearchTreeThreshold && keys_sorted_;
   }
 
  private:
@@ -122,10 +143,19 @@ class DexSwitchTable : public ValueObject {
 
   const int32_t* values_;
 
+  // Whether the keys of a sparse table are sorted in strictly ascending order.
+  bool keys_sorted_;
+
   // The number of entries in a packed switch before we use a jump table or specified
   // compare/jump series.
   static constexpr uint16_t kSmallSwitchThreshold = 3;
 
+  // The number of entries in a sparse switch above which we build a binary search tree
+  // instead of a linear chain of comparisons. The tree spends two branches per level
+  // (equality plus direction), so it only wins once the chain's average of n/2 taken
+  // comparisons (n for the default case) clearly exceeds 2*log2(n).
+  static constexpr uint16_t kSearchTreeThreshold = 7;
+
   DISALLOW_COPY_AND_ASSIGN(DexSwitchTable);
 };
 
@@ -139,6 +139,13 @@ size_t CodeGenerator::GetCachePointerOffset(uint32_t index) {
   return pointer_size * index;
 }
 
+// Returns whether `block` is only executed on an exceptional path. Such code is
+// rarely run and would otherwise occupy instruction cache lines in the middle
+// of the hot code of the method.
+static bool IsColdBlock(HBasicBlock* block) {
+  return block->IsCatchBlock() || block->GetLastInstruction()->IsThrow();
+}
+
 bool CodeGenerator::GoesToNextBlock(HBasicBlock* current, HBasicBlock* next) const {
   DCHECK_EQ((*block_order_)[current_block_index_], current);
   return GetNextBlockToEmit() == FirstNonEmptyBlock(next);
@@ -273,9 +280,35 @@ void CodeGenerator::InitializeCodeGeneration(size_t number_of_spill_slots,
                                              size_t maximum_number_of_live_fpu_registers,
                                              size_t number_of_out_slots,
                                              const ArenaVector<HBasicBlock*>& block_order) {
-  block_order_ = &block_order;
   DCHECK(!block_order.empty());
   DCHECK(block_order[0] == GetGraph()->GetEntryBlock());
+  // Lay out cold blocks after all hot blocks, so that the hot path of the
+  // method stays contiguous in the instruction cache. As for slow paths, all
+  // control transfers to and from cold code are explicit branches, so any
+  // emission order is valid.
+  bool has_cold_blocks = false;
+  for (HBasicBlock* block : block_order) {
+    if (IsColdBlock(block)) {
+      has_cold_blocks = true;
+      break;
+    }
+  }
+  if (has_cold_blocks) {
+    layout_block_order_.reserve(block_order.size());
+    for (HBasicBlock* block : block_order) {
+      if (!IsColdBlock(block)) {
+        layout_block_order_.push_back(block);
+      }
+    }
+    for (HBasicBlock* block : block_order) {
+      if (IsColdBlock(block)) {
+        layout_block_order_.push_back(block);
+      }
+    }
+    block_order_ = &layout_block_order_;
+  } else {
+    block_order_ = &block_order;
+  }
   ComputeSpillMask();
   first_register_slot_in_slow_path_ = (number_of_out_slots + number_of_spill_slots) * kVRegSize;
 
@@ -1136,6 +1169,22 @@ void CodeGenerator::ClearSpillSlotsFromLoopPhisInStackMap(HSuspendCheck* suspend
   }
 }
 
+bool CodeGenerator::CanEmitImplicitSuspendCheck(HSuspendCheck* suspend_check) const {
+  if (!compiler_options_.GetImplicitSuspendChecks()) {
+    return false;
+  }
+  // art_quick_implicit_suspend, which the fault handler resumes into, calls into the
+  // runtime with only a refs-only callee-save frame. Values live in caller-save core
+  // registers would be clobbered by that call, and references held there would be
+  // invisible to the GC crawling the frame. Caller-save floating point registers are
+  // clobbered as well since the stub does not spill any. Callee-save registers are fine:
+  // the core ones are a subset of the refs-only frame spills, and the floating point
+  // ones never hold references and are preserved by the native calling convention.
+  RegisterSet* live_registers = suspend_check->GetLocations()->GetLiveRegisters();
+  return (live_registers->GetCoreRegisters() & ~core_callee_save_mask_) == 0u &&
+         (live_registers->GetFloatingPointRegisters() & ~fpu_callee_save_mask_) == 0u;
+}
+
 void CodeGenerator::EmitParallelMoves(Location from1,
                                       Location to1,
                                       Primitive::Type type1,
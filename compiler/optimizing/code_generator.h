@@ -330,6 +330,13 @@ class CodeGenerator : public DeletableArenaObject<kArenaAllocCodeGenerator> {
   // have not been written to.
   void ClearSpillSlotsFromLoopPhisInStackMap(HSuspendCheck* suspend_check) const;
 
+  // Whether the explicit thread flag test for `suspend_check` can be replaced by an
+  // implicit poll, i.e. a load through the suspend trigger pointer that faults when a
+  // suspension is requested (see SuspensionHandler in the arch fault_handler files).
+  // The runtime stub the fault handler redirects to only sets up a refs-only callee-save
+  // frame, so the poll is only safe when no caller-save register is live at the check.
+  bool CanEmitImplicitSuspendCheck(HSuspendCheck* suspend_check) const;
+
   bool* GetBlockedCoreRegisters() const { return blocked_core_registers_; }
   bool* GetBlockedFloatingPointRegisters() const { return blocked_fpu_registers_; }
 
@@ -513,6 +520,7 @@ class CodeGenerator : public DeletableArenaObject<kArenaAllocCodeGenerator> {
         fpu_callee_save_mask_(fpu_callee_save_mask),
         stack_map_stream_(graph->GetArena()),
         block_order_(nullptr),
+        layout_block_order_(graph->GetArena()->Adapter(kArenaAllocCodeGenerator)),
         disasm_info_(nullptr),
         stats_(stats),
         graph_(graph),
@@ -605,6 +613,10 @@ class CodeGenerator : public DeletableArenaObject<kArenaAllocCodeGenerator> {
   // The order to use for code generation.
   const ArenaVector<HBasicBlock*>* block_order_;
 
+  // Storage for the block order when cold blocks are laid out after all hot
+  // blocks, in which case `block_order_` points here.
+  ArenaVector<HBasicBlock*> layout_block_order_;
+
   DisassemblyInformation* disasm_info_;
 
  private:
@@ -4819,6 +4819,26 @@ void InstructionCodeGeneratorARM::VisitSuspendCheck(HSuspendCheck* instruction)
 
 void InstructionCodeGeneratorARM::GenerateSuspendCheck(HSuspendCheck* instruction,
                                                        HBasicBlock* successor) {
+  if (codegen_->CanEmitImplicitSuspendCheck(instruction)) {
+    if (successor != nullptr) {
+      DCHECK(successor->IsLoopHeader());
+      codegen_->ClearSpillSlotsFromLoopPhisInStackMap(instruction);
+    }
+    // Load through the suspend trigger pointer. When a suspension is requested the runtime
+    // nulls the pointer and the second load faults; SuspensionHandler::Action (see
+    // fault_handler_arm.cc) recognizes this exact two-instruction pattern and redirects
+    // execution to art_quick_implicit_suspend with LR pointing at the instruction after
+    // the faulting load. R0 is what the handler expects and is known to be free here:
+    // the implicit form is only used when no caller-save register is live.
+    __ LoadFromOffset(
+        kLoadWord, R0, TR, Thread::ThreadSuspendTriggerOffset<kArmWordSize>().Int32Value());
+    __ LoadFromOffset(kLoadWord, R0, R0, 0);
+    codegen_->RecordPcInfo(instruction, instruction->GetDexPc());
+    if (successor != nullptr) {
+      __ b(codegen_->GetLabelOf(successor));
+    }
+    return;
+  }
   SuspendCheckSlowPathARM* slow_path =
       down_cast<SuspendCheckSlowPathARM*>(instruction->GetSlowPath());
   if (slow_path == nullptr) {
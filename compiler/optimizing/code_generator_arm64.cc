@@ -1512,6 +1512,25 @@ void CodeGeneratorARM64::GenerateMemoryBarrier(MemBarrierKind kind) {
 
 void InstructionCodeGeneratorARM64::GenerateSuspendCheck(HSuspendCheck* instruction,
                                                          HBasicBlock* successor) {
+  if (codegen_->CanEmitImplicitSuspendCheck(instruction)) {
+    if (successor != nullptr) {
+      DCHECK(successor->IsLoopHeader());
+      codegen_->ClearSpillSlotsFromLoopPhisInStackMap(instruction);
+    }
+    // Load through the suspend trigger pointer. When a suspension is requested the runtime
+    // nulls the pointer and the second load faults; SuspensionHandler::Action (see
+    // fault_handler_arm64.cc) recognizes this exact two-instruction pattern and redirects
+    // execution to art_quick_implicit_suspend with LR pointing at the instruction after
+    // the faulting load. x0 is what the handler expects and is known to be free here:
+    // the implicit form is only used when no caller-save register is live.
+    __ Ldr(x0, MemOperand(tr, Thread::ThreadSuspendTriggerOffset<kArm64WordSize>().SizeValue()));
+    __ Ldr(x0, MemOperand(x0));
+    codegen_->RecordPcInfo(instruction, instruction->GetDexPc());
+    if (successor != nullptr) {
+      __ B(codegen_->GetLabelOf(successor));
+    }
+    return;
+  }
   SuspendCheckSlowPathARM64* slow_path =
       down_cast<SuspendCheckSlowPathARM64*>(instruction->GetSlowPath());
   if (slow_path == nullptr) {
@@ -1597,11 +1616,20 @@ void LocationsBuilderARM64::HandleBinaryOp(HBinaryOperation* instr) {
   }
 }
 
+// Returns whether the read barrier elision pass proved the field load redundant, in which
+// case a plain load is emitted even with read barriers enabled.
+static bool IsFieldGetReadBarrierElided(HInstruction* instruction) {
+  return instruction->IsInstanceFieldGet() &&
+      instruction->AsInstanceFieldGet()->IsReadBarrierElided();
+}
+
 void LocationsBuilderARM64::HandleFieldGet(HInstruction* instruction) {
   DCHECK(instruction->IsInstanceFieldGet() || instruction->IsStaticFieldGet());
 
   bool object_field_get_with_read_barrier =
-      kEmitCompilerReadBarrier && (instruction->GetType() == Primitive::kPrimNot);
+      kEmitCompilerReadBarrier &&
+      (instruction->GetType() == Primitive::kPrimNot) &&
+      !IsFieldGetReadBarrierElided(instruction);
   LocationSummary* locations =
       new (GetGraph()->GetArena()) LocationSummary(instruction,
                                                    object_field_get_with_read_barrier ?
@@ -1630,8 +1658,12 @@ void InstructionCodeGeneratorARM64::HandleFieldGet(HInstruction* instruction,
   Primitive::Type field_type = field_info.GetFieldType();
   BlockPoolsScope block_pools(GetVIXLAssembler());
   MemOperand field = HeapOperand(InputRegisterAt(instruction, 0), field_info.GetFieldOffset());
+  const bool read_barrier_elided = IsFieldGetReadBarrierElided(instruction);
 
-  if (field_type == Primitive::kPrimNot && kEmitCompilerReadBarrier && kUseBakerReadBarrier) {
+  if (field_type == Primitive::kPrimNot &&
+      kEmitCompilerReadBarrier &&
+      !read_barrier_elided &&
+      kUseBakerReadBarrier) {
     // Object FieldGet with Baker's read barrier case.
     MacroAssembler* masm = GetVIXLAssembler();
     UseScratchRegisterScope temps(masm);
@@ -1661,10 +1693,16 @@ void InstructionCodeGeneratorARM64::HandleFieldGet(HInstruction* instruction,
       codegen_->MaybeRecordImplicitNullCheck(instruction);
     }
     if (field_type == Primitive::kPrimNot) {
-      // If read barriers are enabled, emit read barriers other than
-      // Baker's using a slow path (and also unpoison the loaded
-      // reference, if heap poisoning is enabled).
-      codegen_->MaybeGenerateReadBarrierSlow(instruction, out, out, base_loc, offset);
+      if (read_barrier_elided) {
+        // The read barrier was proven redundant, but it would also have unpoisoned the
+        // loaded reference; keep that part when heap poisoning is enabled.
+        GetAssembler()->MaybeUnpoisonHeapReference(WRegisterFrom(out));
+      } else {
+        // If read barriers are enabled, emit read barriers other than
+        // Baker's using a slow path (and also unpoison the loaded
+        // reference, if heap poisoning is enabled).
+        codegen_->MaybeGenerateReadBarrierSlow(instruction, out, out, base_loc, offset);
+      }
     }
   }
 }
@@ -1715,7 +1753,15 @@ void InstructionCodeGeneratorARM64::HandleFieldSet(HInstruction* instruction,
   }
 
   if (CodeGenerator::StoreNeedsWriteBarrier(field_type, instruction->InputAt(1))) {
-    codegen_->MarkGCCard(obj, Register(value), value_can_be_null);
+    WriteBarrierKind write_barrier_kind = instruction->IsInstanceFieldSet()
+        ? instruction->AsInstanceFieldSet()->GetWriteBarrierKind()
+        : WriteBarrierKind::kEmitWithNullCheck;
+    if (write_barrier_kind != WriteBarrierKind::kDontEmit) {
+      codegen_->MarkGCCard(
+          obj,
+          Register(value),
+          value_can_be_null && write_barrier_kind != WriteBarrierKind::kEmitBeingReliedOn);
+    }
   }
 }
 
@@ -2309,7 +2355,14 @@ void InstructionCodeGeneratorARM64::VisitArraySet(HArraySet* instruction) {
       }
     }
 
-    codegen_->MarkGCCard(array, value.W(), instruction->GetValueCanBeNull());
+    WriteBarrierKind write_barrier_kind = instruction->GetWriteBarrierKind();
+    if (write_barrier_kind != WriteBarrierKind::kDontEmit) {
+      codegen_->MarkGCCard(
+          array,
+          value.W(),
+          instruction->GetValueCanBeNull() &&
+              write_barrier_kind != WriteBarrierKind::kEmitBeingReliedOn);
+    }
 
     if (done.IsLinked()) {
       __ Bind(&done);
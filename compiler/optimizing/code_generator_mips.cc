@@ -1103,8 +1103,22 @@ void InstructionCodeGeneratorMIPS::GenerateClassInitializationCheck(SlowPathCode
   __ Bind(slow_path->GetExitLabel());
 }
 
-void InstructionCodeGeneratorMIPS::GenerateMemoryBarrier(MemBarrierKind kind ATTRIBUTE_UNUSED) {
-  __ Sync(0);  // Only stype 0 is supported.
+void InstructionCodeGeneratorMIPS::GenerateMemoryBarrier(MemBarrierKind kind) {
+  // Implementations without the lighter stypes fall back to a full barrier.
+  switch (kind) {
+    case kAnyStore:
+      __ Sync(kSyncRelease);
+      break;
+    case kLoadAny:
+      __ Sync(kSyncAcquire);
+      break;
+    case kStoreStore:
+      __ Sync(kSyncWmb);
+      break;
+    default:
+      __ Sync(kSyncFull);
+      break;
+  }
 }
 
 void InstructionCodeGeneratorMIPS::GenerateSuspendCheck(HSuspendCheck* instruction,
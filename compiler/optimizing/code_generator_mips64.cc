@@ -985,8 +985,22 @@ void InstructionCodeGeneratorMIPS64::GenerateClassInitializationCheck(SlowPathCo
   __ Bind(slow_path->GetExitLabel());
 }
 
-void InstructionCodeGeneratorMIPS64::GenerateMemoryBarrier(MemBarrierKind kind ATTRIBUTE_UNUSED) {
-  __ Sync(0);  // only stype 0 is supported
+void InstructionCodeGeneratorMIPS64::GenerateMemoryBarrier(MemBarrierKind kind) {
+  // Implementations without the lighter stypes fall back to a full barrier.
+  switch (kind) {
+    case kAnyStore:
+      __ Sync(kSyncRelease);
+      break;
+    case kLoadAny:
+      __ Sync(kSyncAcquire);
+      break;
+    case kStoreStore:
+      __ Sync(kSyncWmb);
+      break;
+    default:
+      __ Sync(kSyncFull);
+      break;
+  }
 }
 
 void InstructionCodeGeneratorMIPS64::GenerateSuspendCheck(HSuspendCheck* instruction,
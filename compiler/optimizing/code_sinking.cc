@@ -0,0 +1,138 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "code_sinking.h"
+
+#include "common_dominator.h"
+
+namespace art {
+
+// Returns the number of loops enclosing `block`.
+static size_t LoopDepthOf(HBasicBlock* block) {
+  size_t depth = 0;
+  for (HLoopInformation* loop = block->GetLoopInformation();
+       loop != nullptr;
+       loop = loop->GetPreHeader()->GetLoopInformation()) {
+    ++depth;
+  }
+  return depth;
+}
+
+// Returns whether `instruction` can be freely moved to a later position: it must
+// not observe or modify the heap, throw, or carry an environment, so that executing
+// it later (or not at all on some paths) is unobservable.
+static bool IsSinkingCandidate(HInstruction* instruction) {
+  return !instruction->IsControlFlow() &&
+         !instruction->CanThrow() &&
+         !instruction->HasEnvironment() &&
+         instruction->GetSideEffects().DoesNothing() &&
+         instruction->HasNonEnvironmentUses();
+}
+
+// Returns the position of the use of `instruction` in `user`, which is the user
+// itself for a normal use, and the end of the matching predecessor block for a
+// use as phi input.
+static HBasicBlock* BlockOfUse(HInstruction* instruction,
+                               const HUseListNode<HInstruction*>& use) {
+  HInstruction* user = use.GetUser();
+  if (user->IsPhi()) {
+    return user->GetBlock()->GetPredecessors()[use.GetIndex()];
+  }
+  DCHECK(instruction->StrictlyDominates(user));
+  return user->GetBlock();
+}
+
+void CodeSinking::Run() {
+  // Pre-headers are consulted to compute loop depths; bail out when they may
+  // not exist.
+  if (graph_->ContainsIrreducibleLoop()) {
+    return;
+  }
+  // Visit uses before definitions so that chains of computations sink together:
+  // once the sole user of an instruction has been sunk, the instruction itself
+  // may follow it into the branch.
+  for (HPostOrderIterator it(*graph_); !it.Done(); it.Advance()) {
+    HBasicBlock* block = it.Current();
+    for (HBackwardInstructionIterator inst_it(block->GetInstructions());
+         !inst_it.Done();
+         inst_it.Advance()) {
+      HInstruction* instruction = inst_it.Current();
+      if (IsSinkingCandidate(instruction)) {
+        TrySinkingInstruction(instruction);
+      }
+    }
+  }
+}
+
+void CodeSinking::TrySinkingInstruction(HInstruction* instruction) {
+  // Compute the common dominator of all use positions. Since in SSA form the
+  // definition dominates every use, the result is dominated by the block of
+  // `instruction` and is the latest block the instruction could move to.
+  CommonDominator finder(BlockOfUse(instruction, instruction->GetUses().front()));
+  for (const HUseListNode<HInstruction*>& use : instruction->GetUses()) {
+    finder.Update(BlockOfUse(instruction, use));
+  }
+  for (const HUseListNode<HEnvironment*>& use : instruction->GetEnvUses()) {
+    finder.Update(use.GetUser()->GetHolder()->GetBlock());
+  }
+  HBasicBlock* block = instruction->GetBlock();
+  HBasicBlock* common = finder.Get();
+  if (common == block) {
+    return;
+  }
+  DCHECK(block->Dominates(common));
+
+  // Walk the dominator chain from the common dominator of the uses back up to
+  // the current position, and pick the latest block that does not sink the
+  // instruction into a deeper loop or into a catch block.
+  const size_t depth = LoopDepthOf(block);
+  HBasicBlock* target = nullptr;
+  for (HBasicBlock* candidate = common; candidate != block; candidate = candidate->GetDominator()) {
+    if (!candidate->IsCatchBlock() && LoopDepthOf(candidate) <= depth) {
+      target = candidate;
+      break;
+    }
+  }
+  if (target == nullptr) {
+    return;
+  }
+
+  // Move before the first use inside the target block, if any. Phi uses through
+  // one of the target's successors occur at the end of the block and are covered
+  // by any position within it.
+  HInstruction* insert_pos = nullptr;
+  for (const HUseListNode<HInstruction*>& use : instruction->GetUses()) {
+    HInstruction* user = use.GetUser();
+    if (!user->IsPhi() && user->GetBlock() == target &&
+        (insert_pos == nullptr || user->StrictlyDominates(insert_pos))) {
+      insert_pos = user;
+    }
+  }
+  for (const HUseListNode<HEnvironment*>& use : instruction->GetEnvUses()) {
+    HInstruction* holder = use.GetUser()->GetHolder();
+    if (holder->GetBlock() == target &&
+        (insert_pos == nullptr || holder->StrictlyDominates(insert_pos))) {
+      insert_pos = holder;
+    }
+  }
+  if (insert_pos == nullptr) {
+    insert_pos = target->GetFirstInstruction();
+  }
+  instruction->MoveBefore(insert_pos);
+  MaybeRecordStat(MethodCompilationStat::kInstructionSunk);
+}
+
+}  // namespace art
@@ -47,6 +47,15 @@ namespace art {
 
 static constexpr size_t kMaximumNumberOfHInstructions = 32;
 
+// More generous instruction budget and recursion depth for methods that a profile marks
+// as hot: code size spent on such call sites is much more likely to pay off.
+static constexpr size_t kMaximumNumberOfHInstructionsForHotMethod = 3 * kMaximumNumberOfHInstructions;
+static constexpr size_t kInlineDepthBonusForHotMethod = 2;
+
+// Maximum number of receiver types speculated on at a megamorphic call site.
+// Only the types with the highest inline cache hit counts are considered.
+static constexpr size_t kMaximumNumberOfMegamorphicTargets = 2;
+
 // Limit the number of dex registers that we accumulate while inlining
 // to avoid creating large amount of nested environments.
 static constexpr size_t kMaximumNumberOfCumulatedDexRegisters = 64;
@@ -271,6 +280,22 @@ bool HInliner::TryInline(HInvoke* invoke_instruction) {
         : class_linker->FindDexCache(soa.Self(), *ref.dex_file);
     resolved_method = dex_cache->GetResolvedMethod(
         ref.dex_method_index, class_linker->GetImagePointerSize());
+    if (resolved_method == nullptr && !IsSameDexFile(caller_dex_file, *ref.dex_file)) {
+      // The target method lives in another dex file, typically a multidex split of the same
+      // app, so its dex cache may not have been populated by the verifier. Resolve explicitly
+      // instead of giving up on the inlining; all the app's dex files share the caller's
+      // class loader.
+      StackHandleScope<2> hs(soa.Self());
+      Handle<mirror::DexCache> h_dex_cache(hs.NewHandle(dex_cache));
+      Handle<mirror::ClassLoader> class_loader(hs.NewHandle(
+          soa.Decode<mirror::ClassLoader*>(caller_compilation_unit_.GetClassLoader())));
+      resolved_method = class_linker->ResolveMethodWithoutInvokeType(
+          *ref.dex_file, ref.dex_method_index, h_dex_cache, class_loader);
+      if (resolved_method == nullptr) {
+        // Clean up any exception left by method resolution.
+        soa.Self()->ClearException();
+      }
+    }
     // actual_method == resolved_method for direct or static calls.
     actual_method = resolved_method;
   } else {
@@ -309,6 +334,14 @@ bool HInliner::TryInline(HInvoke* invoke_instruction) {
     if (profiling_info != nullptr) {
       const InlineCache& ic = *profiling_info->GetInlineCache(invoke_instruction->GetDexPc());
       if (ic.IsUninitialized()) {
+        // The site has not been hit in the interpreter yet. If class hierarchy analysis shows
+        // no override of the resolved method among the classes loaded so far, speculate on it
+        // under a vtable guard: a later class load which overrides the method makes its
+        // instances fail the guard and deoptimize, so the assumption needs no invalidation
+        // bookkeeping and no notification from the class linker.
+        if (invoke_instruction->IsInvokeVirtual() && resolved_method->HasSingleImplementation()) {
+          return TryInlineSingleImplementationCall(invoke_instruction, resolved_method);
+        }
         VLOG(compiler) << "Interface or virtual call to "
                        << PrettyMethod(method_index, caller_dex_file)
                        << " is not hit and not inlined";
@@ -327,11 +360,11 @@ bool HInliner::TryInline(HInvoke* invoke_instruction) {
         return TryInlinePolymorphicCall(invoke_instruction, resolved_method, ic);
       } else {
         DCHECK(ic.IsMegamorphic());
-        VLOG(compiler) << "Interface or virtual call to "
-                       << PrettyMethod(method_index, caller_dex_file)
-                       << " is megamorphic and not inlined";
         MaybeRecordStat(kMegamorphicCall);
-        return false;
+        // The call site saw more receiver types than the cache can hold, but
+        // the hit counts still identify its dominant receivers. Speculate on
+        // those; the original invoke remains as fallback for all others.
+        return TryInlinePolymorphicCall(invoke_instruction, resolved_method, ic);
       }
     }
   }
@@ -474,12 +507,39 @@ bool HInliner::TryInlinePolymorphicCall(HInvoke* invoke_instruction,
   size_t pointer_size = class_linker->GetImagePointerSize();
   const DexFile& caller_dex_file = *caller_compilation_unit_.GetDexFile();
 
+  // For a megamorphic call site, only speculate on the receivers with the
+  // highest hit counts; the invoke is kept as fallback for all others. Note
+  // that concurrent updates can only add types, so the cache stays full and
+  // the deoptimizing case below can never be taken for these call sites.
+  bool speculate_on_type[InlineCache::kIndividualCacheSize];
+  const bool is_megamorphic = ic.IsMegamorphic();
+  for (size_t i = 0; i < InlineCache::kIndividualCacheSize; ++i) {
+    speculate_on_type[i] = !is_megamorphic;
+  }
+  if (is_megamorphic) {
+    for (size_t picked = 0; picked < kMaximumNumberOfMegamorphicTargets; ++picked) {
+      size_t best = InlineCache::kIndividualCacheSize;
+      for (size_t i = 0; i < InlineCache::kIndividualCacheSize; ++i) {
+        if (!speculate_on_type[i] &&
+            (best == InlineCache::kIndividualCacheSize ||
+             ic.GetHitCountAt(i) > ic.GetHitCountAt(best))) {
+          best = i;
+        }
+      }
+      speculate_on_type[best] = true;
+    }
+  }
+
   bool all_targets_inlined = true;
   bool one_target_inlined = false;
   for (size_t i = 0; i < InlineCache::kIndividualCacheSize; ++i) {
     if (ic.GetTypeAt(i) == nullptr) {
       break;
     }
+    if (!speculate_on_type[i]) {
+      all_targets_inlined = false;
+      continue;
+    }
     ArtMethod* method = nullptr;
     if (invoke_instruction->IsInvokeInterface()) {
       method = ic.GetTypeAt(i)->FindVirtualMethodForInterface(
@@ -714,7 +774,9 @@ bool HInliner::TryInlinePolymorphicCallToSameTarget(HInvoke* invoke_instruction,
   bb_cursor->InsertInstructionAfter(class_table_get, receiver_class);
   bb_cursor->InsertInstructionAfter(compare, class_table_get);
 
-  if (outermost_graph_->IsCompilingOsr()) {
+  if (outermost_graph_->IsCompilingOsr() || ic.IsMegamorphic()) {
+    // For a megamorphic call site, unseen receivers with a different target
+    // are likely; keep the invoke as fallback rather than deoptimizing.
     CreateDiamondPatternForPolymorphicInline(compare, return_replacement, invoke_instruction);
   } else {
     // TODO: Extend reference type propagation to understand the guard.
@@ -740,6 +802,87 @@ bool HInliner::TryInlinePolymorphicCallToSameTarget(HInvoke* invoke_instruction,
   return true;
 }
 
+bool HInliner::TryInlineSingleImplementationCall(HInvoke* invoke_instruction,
+                                                 ArtMethod* resolved_method) {
+  // This optimization only works under JIT for now.
+  DCHECK(Runtime::Current()->UseJitCompilation());
+  DCHECK(invoke_instruction->IsInvokeVirtual());
+  DCHECK(resolved_method->HasSingleImplementation());
+  if (graph_->GetInstructionSet() == kMips64) {
+    // TODO: Support HClassTableGet for mips64.
+    return false;
+  }
+  ClassLinker* class_linker = caller_compilation_unit_.GetClassLinker();
+  size_t method_index = invoke_instruction->AsInvokeVirtual()->GetVTableIndex();
+
+  HInstruction* receiver = invoke_instruction->InputAt(0);
+  HInstruction* cursor = invoke_instruction->GetPrevious();
+  HBasicBlock* bb_cursor = invoke_instruction->GetBlock();
+
+  HInstruction* return_replacement = nullptr;
+  if (!TryBuildAndInline(invoke_instruction, resolved_method, &return_replacement)) {
+    return false;
+  }
+
+  // Guard on the receiver's vtable entry rather than its exact type: the vtable slot is the
+  // class hierarchy assumption itself, so receivers of later-loaded subclasses keep passing the
+  // guard as long as they do not override the method.
+  HInstanceFieldGet* receiver_class = BuildGetReceiverClass(
+      class_linker, receiver, invoke_instruction->GetDexPc());
+
+  Primitive::Type type = Is64BitInstructionSet(graph_->GetInstructionSet())
+      ? Primitive::kPrimLong
+      : Primitive::kPrimInt;
+  HClassTableGet* class_table_get = new (graph_->GetArena()) HClassTableGet(
+      receiver_class,
+      type,
+      HClassTableGet::TableKind::kVTable,
+      method_index,
+      invoke_instruction->GetDexPc());
+
+  HConstant* constant;
+  if (type == Primitive::kPrimLong) {
+    constant = graph_->GetLongConstant(
+        reinterpret_cast<intptr_t>(resolved_method), invoke_instruction->GetDexPc());
+  } else {
+    constant = graph_->GetIntConstant(
+        reinterpret_cast<intptr_t>(resolved_method), invoke_instruction->GetDexPc());
+  }
+
+  HNotEqual* compare = new (graph_->GetArena()) HNotEqual(class_table_get, constant);
+  if (cursor != nullptr) {
+    bb_cursor->InsertInstructionAfter(receiver_class, cursor);
+  } else {
+    bb_cursor->InsertInstructionBefore(receiver_class, bb_cursor->GetFirstInstruction());
+  }
+  bb_cursor->InsertInstructionAfter(class_table_get, receiver_class);
+  bb_cursor->InsertInstructionAfter(compare, class_table_get);
+
+  if (outermost_graph_->IsCompilingOsr()) {
+    // Deoptimizing from OSR code is unsupported; keep the invoke as the guard's slow path.
+    CreateDiamondPatternForPolymorphicInline(compare, return_replacement, invoke_instruction);
+  } else {
+    HDeoptimize* deoptimize = new (graph_->GetArena()) HDeoptimize(
+        compare, invoke_instruction->GetDexPc());
+    bb_cursor->InsertInstructionAfter(deoptimize, compare);
+    deoptimize->CopyEnvironmentFrom(invoke_instruction->GetEnvironment());
+    if (return_replacement != nullptr) {
+      invoke_instruction->ReplaceWith(return_replacement);
+    }
+    invoke_instruction->GetBlock()->RemoveInstruction(invoke_instruction);
+  }
+
+  // Run type propagation to get the guard typed.
+  ReferenceTypePropagation rtp_fixup(graph_,
+                                     outer_compilation_unit_.GetDexCache(),
+                                     handles_,
+                                     /* is_first_run */ false);
+  rtp_fixup.Run();
+
+  MaybeRecordStat(kInlinedInvokeVirtualOrInterface);
+  return true;
+}
+
 bool HInliner::TryInlineAndReplace(HInvoke* invoke_instruction, ArtMethod* method, bool do_rtp) {
   HInstruction* return_replacement = nullptr;
   if (!TryBuildAndInline(invoke_instruction, method, &return_replacement)) {
@@ -1141,7 +1284,9 @@ bool HInliner::TryBuildAndInlineHelper(HInvoke* invoke_instruction,
     }
   }
 
-  size_t number_of_instructions_budget = kMaximumNumberOfHInstructions;
+  size_t number_of_instructions_budget = IsHotMethod(callee_dex_file, method_index)
+      ? kMaximumNumberOfHInstructionsForHotMethod
+      : kMaximumNumberOfHInstructions;
   size_t number_of_inlined_instructions =
       RunOptimizations(callee_graph, code_item, dex_compilation_unit);
   number_of_instructions_budget += number_of_inlined_instructions;
@@ -1213,10 +1358,22 @@ bool HInliner::TryBuildAndInlineHelper(HInvoke* invoke_instruction,
       }
 
       if (!same_dex_file && current->NeedsEnvironment()) {
-        VLOG(compiler) << "Method " << PrettyMethod(method_index, callee_dex_file)
-                       << " could not be inlined because " << current->DebugName()
-                       << " needs an environment and is in a different dex file";
-        return false;
+        // An environment names its method by an index that the stack walker resolves
+        // in the dex file of the outer method. A frame of the callee itself can be
+        // renamed below to the method index of the invoke, which refers to the same
+        // method from the caller's dex file, provided the caller and the outer method
+        // share that dex file and the invoke names the inlined target exactly (which
+        // rules out devirtualized calls). Frames inherited from methods the callee
+        // inlined in turn have no valid name in the outer dex file.
+        if (!invoke_instruction->IsInvokeStaticOrDirect() ||
+            !IsSameDexFile(*caller_compilation_unit_.GetDexFile(),
+                           *outer_compilation_unit_.GetDexFile()) ||
+            current->GetEnvironment()->GetParent() != nullptr) {
+          VLOG(compiler) << "Method " << PrettyMethod(method_index, callee_dex_file)
+                         << " could not be inlined because " << current->DebugName()
+                         << " needs an environment and is in a different dex file";
+          return false;
+        }
       }
 
       if (!same_dex_file && current->NeedsDexCacheOfDeclaringClass()) {
@@ -1258,6 +1415,26 @@ bool HInliner::TryBuildAndInlineHelper(HInvoke* invoke_instruction,
   }
   number_of_inlined_instructions_ += number_of_instructions;
 
+  if (!same_dex_file) {
+    // Rename the callee's frames so that the stack walker can resolve them: the
+    // method index of the invoke refers to the inlined method from the dex file
+    // of the outer method. The per-instruction checks above ensured only root
+    // environments of the callee remain.
+    const uint32_t invoke_method_index = invoke_instruction->GetDexMethodIndex();
+    for (HReversePostOrderIterator it(*callee_graph); !it.Done(); it.Advance()) {
+      for (HInstructionIterator instr_it(it.Current()->GetInstructions());
+           !instr_it.Done();
+           instr_it.Advance()) {
+        HEnvironment* environment = instr_it.Current()->GetEnvironment();
+        if (environment != nullptr) {
+          DCHECK(environment->GetParent() == nullptr);
+          environment->SetMethodInfo(*caller_compilation_unit_.GetDexFile(),
+                                     invoke_method_index);
+        }
+      }
+    }
+  }
+
   DCHECK_EQ(caller_instruction_counter, graph_->GetCurrentInstructionId())
       << "No instructions can be added to the outer graph while inner graph is being built";
 
@@ -1295,8 +1472,12 @@ size_t HInliner::RunOptimizations(HGraph* callee_graph,
     optimization->Run();
   }
 
+  size_t inline_depth_limit = compiler_driver_->GetCompilerOptions().GetInlineDepthLimit();
+  if (IsHotMethod(*dex_compilation_unit.GetDexFile(), dex_compilation_unit.GetDexMethodIndex())) {
+    inline_depth_limit += kInlineDepthBonusForHotMethod;
+  }
   size_t number_of_inlined_instructions = 0u;
-  if (depth_ + 1 < compiler_driver_->GetCompilerOptions().GetInlineDepthLimit()) {
+  if (depth_ + 1 < inline_depth_limit) {
     HInliner inliner(callee_graph,
                      outermost_graph_,
                      codegen_,
@@ -1314,6 +1495,11 @@ size_t HInliner::RunOptimizations(HGraph* callee_graph,
   return number_of_inlined_instructions;
 }
 
+bool HInliner::IsHotMethod(const DexFile& dex_file, uint32_t method_index) const {
+  const ProfileCompilationInfo* profile = compiler_driver_->GetProfileCompilationInfo();
+  return profile != nullptr && profile->ContainsMethod(MethodReference(&dex_file, method_index));
+}
+
 void HInliner::FixUpReturnReferenceType(HInvoke* invoke_instruction,
                                         ArtMethod* resolved_method,
                                         HInstruction* return_replacement,
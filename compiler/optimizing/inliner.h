@@ -82,6 +82,10 @@ class HInliner : public HOptimization {
                           const DexFile::CodeItem* code_item,
                           const DexCompilationUnit& dex_compilation_unit);
 
+  // Returns whether the profile used for this compilation, if any, marks the
+  // given method as hot.
+  bool IsHotMethod(const DexFile& dex_file, uint32_t method_index) const;
+
   // Try to recognize known simple patterns and replace invoke call with appropriate instructions.
   bool TryPatternSubstitution(HInvoke* invoke_instruction,
                               ArtMethod* resolved_method,
@@ -118,6 +122,12 @@ class HInliner : public HOptimization {
                                             const InlineCache& ic)
     SHARED_REQUIRES(Locks::mutator_lock_);
 
+  // Try to inline an invoke-virtual whose resolved method has no override among the loaded
+  // classes, guarded by a vtable entry comparison instead of an exact type check.
+  bool TryInlineSingleImplementationCall(HInvoke* invoke_instruction,
+                                         ArtMethod* resolved_method)
+    SHARED_REQUIRES(Locks::mutator_lock_);
+
 
   HInstanceFieldGet* BuildGetReceiverClass(ClassLinker* class_linker,
                                            HInstruction* receiver,
@@ -601,6 +601,8 @@ void HInstructionBuilder::BuildSwitch(const Instruction& instruction, uint32_t d
     // Empty Switch. Code falls through to the next block.
     DCHECK(IsFallthroughInstruction(instruction, dex_pc, current_block_));
     AppendInstruction(new (arena_) HGoto(dex_pc));
+  } else if (table.ShouldBuildSearchTree()) {
+    BuildSearchTreeSwitch(value, table, 0u, table.GetNumEntries(), dex_pc);
   } else if (table.ShouldBuildDecisionTree()) {
     for (DexSwitchTableIterator it(table); !it.Done(); it.Advance()) {
       HInstruction* case_value = graph_->GetIntConstant(it.CurrentKey(), dex_pc);
@@ -620,6 +622,34 @@ void HInstructionBuilder::BuildSwitch(const Instruction& instruction, uint32_t d
   current_block_ = nullptr;
 }
 
+void HInstructionBuilder::BuildSearchTreeSwitch(HInstruction* value,
+                                                const DexSwitchTable& table,
+                                                size_t lo,
+                                                size_t hi,
+                                                uint32_t dex_pc) {
+  // HBasicBlockBuilder wired the successors of each comparison block as taken first,
+  // not-taken second, matching the HIf instructions built here; the block and edge layout
+  // below must stay in sync with its CreateSearchTreeBlocks/ConnectSearchTreeBlocks.
+  const size_t mid = lo + (hi - lo) / 2;
+  HInstruction* key = graph_->GetIntConstant(table.GetEntryAt(mid), dex_pc);
+  HEqual* equality = new (arena_) HEqual(value, key, dex_pc);
+  AppendInstruction(equality);
+  AppendInstruction(new (arena_) HIf(equality, dex_pc));
+  if (hi - lo > 1u) {
+    current_block_ = FindBlockStartingAt(table.GetDexPcForIndex(table.GetNumEntries() + mid));
+    HLessThan* less_than = new (arena_) HLessThan(value, key, dex_pc);
+    AppendInstruction(less_than);
+    AppendInstruction(new (arena_) HIf(less_than, dex_pc));
+    const size_t right_lo = mid + 1u;
+    current_block_ = FindBlockStartingAt(table.GetDexPcForIndex(lo + (mid - lo) / 2));
+    BuildSearchTreeSwitch(value, table, lo, mid, dex_pc);
+    if (right_lo < hi) {
+      current_block_ = FindBlockStartingAt(table.GetDexPcForIndex(right_lo + (hi - right_lo) / 2));
+      BuildSearchTreeSwitch(value, table, right_lo, hi, dex_pc);
+    }
+  }
+}
+
 void HInstructionBuilder::BuildReturn(const Instruction& instruction,
                                       Primitive::Type type,
                                       uint32_t dex_pc) {
@@ -835,10 +865,28 @@ bool HInstructionBuilder::BuildInvoke(const Instruction& instruction,
                         nullptr /* clinit_check */);
   }
 
+  // Devirtualize invoke-virtual when the resolved method cannot be overridden: such a call has
+  // a unique target, so it can be built as a statically bound invoke and have its dispatch
+  // sharpened by HSharpening (which re-runs the driver's devirtualization on it) like any
+  // invoke-direct. A classpath-wide effectively-final analysis could catch more targets, but
+  // without runtime invalidation support a direct call to a merely unoverridden method would
+  // break as soon as a class loader introduces an overriding subclass, so only targets the
+  // language makes final are rewritten.
+  InvokeType optimized_invoke_type = invoke_type;
+  if (invoke_type == kVirtual) {
+    ScopedObjectAccess soa(Thread::Current());
+    if (resolved_method->IsInvokable() &&
+        (resolved_method->IsFinal() || resolved_method->GetDeclaringClass()->IsFinal())) {
+      optimized_invoke_type = kDirect;
+    }
+  }
+
   // Potential class initialization check, in the case of a static method call.
   HClinitCheck* clinit_check = nullptr;
   HInvoke* invoke = nullptr;
-  if (invoke_type == kDirect || invoke_type == kStatic || invoke_type == kSuper) {
+  if (optimized_invoke_type == kDirect ||
+      optimized_invoke_type == kStatic ||
+      optimized_invoke_type == kSuper) {
     // By default, consider that the called method implicitly requires
     // an initialization check of its declaring method.
     HInvokeStaticOrDirect::ClinitCheckRequirement clinit_check_requirement
@@ -870,7 +918,7 @@ bool HInstructionBuilder::BuildInvoke(const Instruction& instruction,
                                                 target_method,
                                                 dispatch_info,
                                                 invoke_type,
-                                                invoke_type,
+                                                optimized_invoke_type,
                                                 clinit_check_requirement);
   } else if (invoke_type == kVirtual) {
     ScopedObjectAccess soa(Thread::Current());  // Needed for the method index
@@ -888,7 +936,7 @@ bool HInstructionBuilder::BuildInvoke(const Instruction& instruction,
                                            return_type,
                                            dex_pc,
                                            method_idx,
-                                           resolved_method->GetDexMethodIndex());
+                                           resolved_method->GetImtIndex());
   }
 
   return HandleInvoke(invoke,
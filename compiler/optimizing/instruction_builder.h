@@ -209,6 +209,15 @@ class HInstructionBuilder : public ValueObject {
   // Builds an instruction sequence for a switch statement.
   void BuildSwitch(const Instruction& instruction, uint32_t dex_pc);
 
+  // Populates the binary search tree blocks created by HBasicBlockBuilder for a large
+  // sparse switch, covering the key range `[lo, hi)` of `table`. On entry,
+  // `current_block_` holds the equality test of the range's middle key.
+  void BuildSearchTreeSwitch(HInstruction* value,
+                             const DexSwitchTable& table,
+                             size_t lo,
+                             size_t hi,
+                             uint32_t dex_pc);
+
   // Returns the outer-most compiling method's class.
   mirror::Class* GetOutermostCompilingClass() const;
 
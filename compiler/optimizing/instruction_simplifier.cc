@@ -79,6 +79,7 @@ class InstructionSimplifierVisitor : public HGraphDelegateVisitor {
   void VisitAboveOrEqual(HAboveOrEqual* condition) OVERRIDE;
   void VisitDiv(HDiv* instruction) OVERRIDE;
   void VisitMul(HMul* instruction) OVERRIDE;
+  void VisitRem(HRem* instruction) OVERRIDE;
   void VisitNeg(HNeg* instruction) OVERRIDE;
   void VisitNot(HNot* instruction) OVERRIDE;
   void VisitOr(HOr* instruction) OVERRIDE;
@@ -1157,6 +1158,46 @@ void InstructionSimplifierVisitor::VisitDiv(HDiv* instruction) {
   }
 }
 
+void InstructionSimplifierVisitor::VisitRem(HRem* instruction) {
+  Primitive::Type type = instruction->GetType();
+  if (!Primitive::IsIntegralType(type)) {
+    return;
+  }
+
+  HInstruction* dividend = instruction->GetLeft();
+  HInstruction* divisor = instruction->GetRight();
+
+  // Look for a division of the same operands whose quotient we can reuse. Digit-formatting
+  // and parsing loops commonly compute both `a / b` and `a % b`; without this, each of them
+  // expands into its own full division (or magic-multiply) sequence in the backends.
+  for (const HUseListNode<HInstruction*>& use : dividend->GetUses()) {
+    HInstruction* user = use.GetUser();
+    if (user->IsDiv() &&
+        user->GetType() == type &&
+        user->InputAt(0) == dividend &&
+        user->InputAt(1) == divisor &&
+        user->StrictlyDominates(instruction)) {
+      // Replace code looking like
+      //    DIV quot, a, b
+      //    REM dst, a, b
+      // with
+      //    DIV quot, a, b
+      //    MUL tmp, quot, b
+      //    SUB dst, a, tmp
+      // which holds for all inputs under Java's truncated division, including the
+      // min_int / -1 overflow case. The backends fuse the multiply-subtract pair where
+      // the ISA provides one.
+      ArenaAllocator* allocator = GetGraph()->GetArena();
+      HMul* mul = new (allocator) HMul(type, user, divisor);
+      instruction->GetBlock()->InsertInstructionBefore(mul, instruction);
+      HSub* sub = new (allocator) HSub(type, dividend, mul);
+      instruction->GetBlock()->ReplaceAndRemoveInstructionWith(instruction, sub);
+      RecordSimplification();
+      return;
+    }
+  }
+}
+
 void InstructionSimplifierVisitor::VisitMul(HMul* instruction) {
   HConstant* input_cst = instruction->GetConstantRight();
   HInstruction* input_other = instruction->GetLeastConstantLeft();
@@ -365,6 +365,59 @@ void IntrinsicCodeGeneratorARM::VisitMathMaxIntInt(HInvoke* invoke) {
   GenMinMax(invoke->GetLocations(), /* is_min */ false, GetAssembler());
 }
 
+static void GenMinMaxLong(LocationSummary* locations, bool is_min, ArmAssembler* assembler) {
+  Register op1_lo = locations->InAt(0).AsRegisterPairLow<Register>();
+  Register op1_hi = locations->InAt(0).AsRegisterPairHigh<Register>();
+  Register op2_lo = locations->InAt(1).AsRegisterPairLow<Register>();
+  Register op2_hi = locations->InAt(1).AsRegisterPairHigh<Register>();
+  Register out_lo = locations->Out().AsRegisterPairLow<Register>();
+  Register out_hi = locations->Out().AsRegisterPairHigh<Register>();
+  Register temp = locations->GetTemp(0).AsRegister<Register>();
+
+  // Compare op1 and op2 as 64-bit signed values: subtract the high words with the borrow
+  // of the low-word subtraction and keep only the flags.
+  __ cmp(op1_lo, ShifterOperand(op2_lo));
+  __ sbcs(temp, op1_hi, ShifterOperand(op2_hi));
+
+  // Select op1 when it compares lower (min) resp. not lower (max).
+  Condition op1_cond = is_min ? Condition::LT : Condition::GE;
+  Condition op2_cond = is_min ? Condition::GE : Condition::LT;
+  __ it(op1_cond, kItThen, kItElse, kItElse);
+  __ mov(out_lo, ShifterOperand(op1_lo), op1_cond);
+  __ mov(out_hi, ShifterOperand(op1_hi), op1_cond);
+  __ mov(out_lo, ShifterOperand(op2_lo), op2_cond);
+  __ mov(out_hi, ShifterOperand(op2_hi), op2_cond);
+}
+
+static void CreateLongLongToLongLocations(ArenaAllocator* arena, HInvoke* invoke) {
+  LocationSummary* locations = new (arena) LocationSummary(invoke,
+                                                           LocationSummary::kNoCall,
+                                                           kIntrinsified);
+  locations->SetInAt(0, Location::RequiresRegister());
+  locations->SetInAt(1, Location::RequiresRegister());
+  // The output pair must not alias either input pair: both of its words are written
+  // under one condition or the other, so a partial overlap could clobber an input
+  // word before it is read.
+  locations->SetOut(Location::RequiresRegister(), Location::kOutputOverlap);
+  locations->AddTemp(Location::RequiresRegister());
+}
+
+void IntrinsicLocationsBuilderARM::VisitMathMinLongLong(HInvoke* invoke) {
+  CreateLongLongToLongLocations(arena_, invoke);
+}
+
+void IntrinsicCodeGeneratorARM::VisitMathMinLongLong(HInvoke* invoke) {
+  GenMinMaxLong(invoke->GetLocations(), /* is_min */ true, GetAssembler());
+}
+
+void IntrinsicLocationsBuilderARM::VisitMathMaxLongLong(HInvoke* invoke) {
+  CreateLongLongToLongLocations(arena_, invoke);
+}
+
+void IntrinsicCodeGeneratorARM::VisitMathMaxLongLong(HInvoke* invoke) {
+  GenMinMaxLong(invoke->GetLocations(), /* is_min */ false, GetAssembler());
+}
+
 void IntrinsicLocationsBuilderARM::VisitMathSqrt(HInvoke* invoke) {
   CreateFPToFPLocations(arena_, invoke);
 }
@@ -1987,17 +2040,19 @@ void IntrinsicCodeGeneratorARM::VisitStringGetCharsNoCheck(HInvoke* invoke) {
 
 UNIMPLEMENTED_INTRINSIC(ARM, IntegerBitCount)
 UNIMPLEMENTED_INTRINSIC(ARM, LongBitCount)
+// The round/rint family and the NaN/-0.0-correct float/double min/max all want the
+// ARMv8 AArch32 instructions (vrint*, vcvta, vminnm/vmaxnm); our assembler has no
+// encodings for those and the instruction set features carry no ARMv8 bit to gate
+// them on, so ARMv7 fleets would see no benefit anyway.
 UNIMPLEMENTED_INTRINSIC(ARM, MathMinDoubleDouble)
 UNIMPLEMENTED_INTRINSIC(ARM, MathMinFloatFloat)
 UNIMPLEMENTED_INTRINSIC(ARM, MathMaxDoubleDouble)
 UNIMPLEMENTED_INTRINSIC(ARM, MathMaxFloatFloat)
-UNIMPLEMENTED_INTRINSIC(ARM, MathMinLongLong)
-UNIMPLEMENTED_INTRINSIC(ARM, MathMaxLongLong)
-UNIMPLEMENTED_INTRINSIC(ARM, MathCeil)          // Could be done by changing rounding mode, maybe?
-UNIMPLEMENTED_INTRINSIC(ARM, MathFloor)         // Could be done by changing rounding mode, maybe?
+UNIMPLEMENTED_INTRINSIC(ARM, MathCeil)
+UNIMPLEMENTED_INTRINSIC(ARM, MathFloor)
 UNIMPLEMENTED_INTRINSIC(ARM, MathRint)
-UNIMPLEMENTED_INTRINSIC(ARM, MathRoundDouble)   // Could be done by changing rounding mode, maybe?
-UNIMPLEMENTED_INTRINSIC(ARM, MathRoundFloat)    // Could be done by changing rounding mode, maybe?
+UNIMPLEMENTED_INTRINSIC(ARM, MathRoundDouble)
+UNIMPLEMENTED_INTRINSIC(ARM, MathRoundFloat)
 UNIMPLEMENTED_INTRINSIC(ARM, UnsafeCASLong)     // High register pressure.
 UNIMPLEMENTED_INTRINSIC(ARM, SystemArrayCopyChar)
 UNIMPLEMENTED_INTRINSIC(ARM, ReferenceGetReferent)
@@ -1209,6 +1209,7 @@ void IntrinsicLocationsBuilderARM64::VisitStringEquals(HInvoke* invoke) {
   // Temporary registers to store lengths of strings and for calculations.
   locations->AddTemp(Location::RequiresRegister());
   locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
 
   locations->SetOut(Location::RequiresRegister(), Location::kOutputOverlap);
 }
@@ -1225,8 +1226,11 @@ void IntrinsicCodeGeneratorARM64::VisitStringEquals(HInvoke* invoke) {
   Register temp = scratch_scope.AcquireW();
   Register temp1 = WRegisterFrom(locations->GetTemp(0));
   Register temp2 = WRegisterFrom(locations->GetTemp(1));
+  Register temp3 = XRegisterFrom(locations->GetTemp(2));
 
   vixl::Label loop;
+  vixl::Label remainder;
+  vixl::Label remainder_loop;
   vixl::Label end;
   vixl::Label return_true;
   vixl::Label return_false;
@@ -1261,28 +1265,47 @@ void IntrinsicCodeGeneratorARM64::VisitStringEquals(HInvoke* invoke) {
   // Check if lengths are equal, return false if they're not.
   __ Cmp(temp, temp1);
   __ B(&return_false, ne);
-  // Store offset of string value in preparation for comparison loop
-  __ Mov(temp1, value_offset);
   // Return true if both strings are empty.
   __ Cbz(temp, &return_true);
 
-  // Assertions that must hold in order to compare strings 4 characters at a time.
+  // Assertions that must hold in order to compare strings 8 bytes at a time.
   DCHECK_ALIGNED(value_offset, 8);
   static_assert(IsAligned<8>(kObjectAlignment), "String of odd length is not zero padded");
 
   temp1 = temp1.X();
   temp2 = temp2.X();
+  Register temp4 = scratch_scope.AcquireX();
+
+  // Store addresses of string values in preparation for comparison loop.
+  __ Add(temp1, str.X(), Operand(value_offset));
+  __ Add(temp2, arg.X(), Operand(value_offset));
 
-  // Loop to compare strings 4 characters at a time starting at the beginning of the string.
-  // Ok to do this because strings are zero-padded to be 8-byte aligned.
+  // Loop comparing 8 characters at a time with an early exit on the first
+  // mismatching 16-byte block. Runs only while at least 8 characters remain,
+  // so the loads never read past the string value array.
   __ Bind(&loop);
-  __ Ldr(out, MemOperand(str.X(), temp1));
-  __ Ldr(temp2, MemOperand(arg.X(), temp1));
-  __ Add(temp1, temp1, Operand(sizeof(uint64_t)));
-  __ Cmp(out, temp2);
+  __ Cmp(temp, 8);
+  __ B(&remainder, lt);
+  __ Ldp(out, temp4, MemOperand(temp1, 2 * sizeof(uint64_t), vixl::PostIndex));
+  __ Ldr(temp3, MemOperand(temp2, sizeof(uint64_t), vixl::PostIndex));
+  __ Cmp(out, temp3);
+  __ Ldr(temp3, MemOperand(temp2, sizeof(uint64_t), vixl::PostIndex));
+  __ Ccmp(temp4, temp3, NoFlag, eq);
+  __ B(&return_false, ne);
+  __ Sub(temp, temp, Operand(8));
+  __ B(&loop);
+
+  // The remaining 1 to 7 characters occupy one or two 8-byte words which are
+  // zero padded, so they can be compared whole.
+  __ Bind(&remainder);
+  __ Cbz(temp, &return_true);
+  __ Bind(&remainder_loop);
+  __ Ldr(out, MemOperand(temp1, sizeof(uint64_t), vixl::PostIndex));
+  __ Ldr(temp3, MemOperand(temp2, sizeof(uint64_t), vixl::PostIndex));
+  __ Cmp(out, temp3);
   __ B(&return_false, ne);
   __ Sub(temp, temp, Operand(4), SetFlags);
-  __ B(&loop, gt);
+  __ B(&remainder_loop, gt);
 
   // Return true and exit the function.
   // If loop does not result in returning false, we return true.
@@ -2181,19 +2204,28 @@ void IntrinsicCodeGeneratorARM64::VisitSystemArrayCopy(HInvoke* invoke) {
 
     // Iterate over the arrays and do a raw copy of the objects. We don't need to
     // poison/unpoison, nor do any read barrier as the next uses of the destination
-    // array will do it.
-    vixl::Label loop, done;
+    // array will do it. Two elements are copied per iteration where possible:
+    // heap references are only guaranteed 4 byte alignment, but doubleword
+    // accesses to normal memory do not require it.
+    vixl::Label pair_loop, pair_done, done;
     const int32_t element_size = Primitive::ComponentSize(Primitive::kPrimNot);
-    __ Bind(&loop);
-    __ Cmp(src_curr_addr, src_stop_addr);
-    __ B(&done, eq);
     {
-      Register tmp = temps.AcquireW();
-      __ Ldr(tmp, MemOperand(src_curr_addr, element_size, vixl::PostIndex));
-      __ Str(tmp, MemOperand(dst_curr_addr, element_size, vixl::PostIndex));
+      Register tmp = temps.AcquireX();
+      __ Bind(&pair_loop);
+      __ Sub(tmp, src_stop_addr, src_curr_addr);
+      __ Cmp(tmp, 2 * element_size);
+      __ B(&pair_done, lt);
+      __ Ldr(tmp, MemOperand(src_curr_addr, 2 * element_size, vixl::PostIndex));
+      __ Str(tmp, MemOperand(dst_curr_addr, 2 * element_size, vixl::PostIndex));
+      __ B(&pair_loop);
+      __ Bind(&pair_done);
+      // Copy the remaining element, if any.
+      __ Cmp(src_curr_addr, src_stop_addr);
+      __ B(&done, eq);
+      __ Ldr(tmp.W(), MemOperand(src_curr_addr));
+      __ Str(tmp.W(), MemOperand(dst_curr_addr));
+      __ Bind(&done);
     }
-    __ B(&loop);
-    __ Bind(&done);
   }
   // We only need one card marking on the destination array.
   codegen_->MarkGCCard(dest.W(), Register(), /* value_can_be_null */ false);
@@ -1618,7 +1618,10 @@ static void GenUnsafePut(LocationSummary* locations,
 
   __ Addu(TMP, base, offset_lo);
   if (is_volatile || is_ordered) {
-    __ Sync(0);
+    // Volatile and ordered stores only need release ordering ahead of the
+    // store; the StoreLoad ordering for volatile comes from the trailing
+    // full barrier.
+    __ Sync(kSyncRelease);
   }
   if ((type == Primitive::kPrimInt) || (type == Primitive::kPrimNot)) {
     Register value = locations->InAt(3).AsRegister<Register>();
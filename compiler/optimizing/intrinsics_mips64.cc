@@ -1049,7 +1049,10 @@ static void GenUnsafePut(LocationSummary* locations,
 
   __ Daddu(TMP, base, offset);
   if (is_volatile || is_ordered) {
-    __ Sync(0);
+    // Volatile and ordered stores only need release ordering ahead of the
+    // store; the StoreLoad ordering for volatile comes from the trailing
+    // full barrier.
+    __ Sync(kSyncRelease);
   }
   switch (type) {
     case Primitive::kPrimInt:
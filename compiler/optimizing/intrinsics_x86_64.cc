@@ -1388,12 +1388,14 @@ void IntrinsicLocationsBuilderX86_64::VisitStringEquals(HInvoke* invoke) {
   locations->SetInAt(0, Location::RequiresRegister());
   locations->SetInAt(1, Location::RequiresRegister());
 
-  // Request temporary registers, RCX and RDI needed for repe_cmpsq instruction.
-  locations->AddTemp(Location::RegisterLocation(RCX));
-  locations->AddTemp(Location::RegisterLocation(RDI));
+  // Temporary registers for the string length and the running byte offset.
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  // Vector registers for the 16-byte comparison loop.
+  locations->AddTemp(Location::RequiresFpuRegister());
+  locations->AddTemp(Location::RequiresFpuRegister());
 
-  // Set output, RSI needed for repe_cmpsq instruction anyways.
-  locations->SetOut(Location::RegisterLocation(RSI), Location::kOutputOverlap);
+  locations->SetOut(Location::RequiresRegister(), Location::kOutputOverlap);
 }
 
 void IntrinsicCodeGeneratorX86_64::VisitStringEquals(HInvoke* invoke) {
@@ -1402,11 +1404,13 @@ void IntrinsicCodeGeneratorX86_64::VisitStringEquals(HInvoke* invoke) {
 
   CpuRegister str = locations->InAt(0).AsRegister<CpuRegister>();
   CpuRegister arg = locations->InAt(1).AsRegister<CpuRegister>();
-  CpuRegister rcx = locations->GetTemp(0).AsRegister<CpuRegister>();
-  CpuRegister rdi = locations->GetTemp(1).AsRegister<CpuRegister>();
-  CpuRegister rsi = locations->Out().AsRegister<CpuRegister>();
+  CpuRegister len = locations->GetTemp(0).AsRegister<CpuRegister>();
+  CpuRegister offset = locations->GetTemp(1).AsRegister<CpuRegister>();
+  XmmRegister vec_str = locations->GetTemp(2).AsFpuRegister<XmmRegister>();
+  XmmRegister vec_arg = locations->GetTemp(3).AsFpuRegister<XmmRegister>();
+  CpuRegister out = locations->Out().AsRegister<CpuRegister>();
 
-  NearLabel end, return_true, return_false;
+  NearLabel loop, remainder, remainder_loop, end, return_true, return_false;
 
   // Get offsets of count, value, and class fields within a string object.
   const uint32_t count_offset = mirror::String::CountOffset().Uint32Value();
@@ -1424,8 +1428,8 @@ void IntrinsicCodeGeneratorX86_64::VisitStringEquals(HInvoke* invoke) {
   // All string objects must have the same type since String cannot be subclassed.
   // Receiver must be a string object, so its class field is equal to all strings' class fields.
   // If the argument is a string object, its class field must be equal to receiver's class field.
-  __ movl(rcx, Address(str, class_offset));
-  __ cmpl(rcx, Address(arg, class_offset));
+  __ movl(out, Address(str, class_offset));
+  __ cmpl(out, Address(arg, class_offset));
   __ j(kNotEqual, &return_false);
 
   // Reference equality check, return true if same reference.
@@ -1433,39 +1437,58 @@ void IntrinsicCodeGeneratorX86_64::VisitStringEquals(HInvoke* invoke) {
   __ j(kEqual, &return_true);
 
   // Load length of receiver string.
-  __ movl(rcx, Address(str, count_offset));
+  __ movl(len, Address(str, count_offset));
   // Check if lengths are equal, return false if they're not.
-  __ cmpl(rcx, Address(arg, count_offset));
+  __ cmpl(len, Address(arg, count_offset));
   __ j(kNotEqual, &return_false);
   // Return true if both strings are empty.
-  __ jrcxz(&return_true);
-
-  // Load starting addresses of string values into RSI/RDI as required for repe_cmpsq instruction.
-  __ leal(rsi, Address(str, value_offset));
-  __ leal(rdi, Address(arg, value_offset));
-
-  // Divide string length by 4 and adjust for lengths not divisible by 4.
-  __ addl(rcx, Immediate(3));
-  __ shrl(rcx, Immediate(2));
+  __ testl(len, len);
+  __ j(kEqual, &return_true);
 
-  // Assertions that must hold in order to compare strings 4 characters at a time.
+  // Assertions that must hold in order to compare strings 8 bytes at a time.
   DCHECK_ALIGNED(value_offset, 8);
   static_assert(IsAligned<8>(kObjectAlignment), "String is not zero padded");
 
-  // Loop to compare strings four characters at a time starting at the beginning of the string.
-  __ repe_cmpsq();
-  // If strings are not equal, zero flag will be cleared.
+  __ xorl(offset, offset);
+
+  // Loop comparing 8 characters at a time with an early exit on the first
+  // mismatching 16-byte block. Runs only while at least 8 characters remain,
+  // so the vector loads never read past the string value array.
+  __ Bind(&loop);
+  __ cmpl(len, Immediate(8));
+  __ j(kLess, &remainder);
+  __ movdqu(vec_str, Address(str, offset, ScaleFactor::TIMES_1, value_offset));
+  __ movdqu(vec_arg, Address(arg, offset, ScaleFactor::TIMES_1, value_offset));
+  __ pcmpeqw(vec_str, vec_arg);
+  __ pmovmskb(out, vec_str);
+  __ cmpl(out, Immediate(0xffff));
   __ j(kNotEqual, &return_false);
+  __ addl(offset, Immediate(16));
+  __ subl(len, Immediate(8));
+  __ jmp(&loop);
+
+  // The remaining 1 to 7 characters occupy one or two quadwords which are
+  // zero padded, so they can be compared whole.
+  __ Bind(&remainder);
+  __ testl(len, len);
+  __ j(kEqual, &return_true);
+  __ Bind(&remainder_loop);
+  __ movq(out, Address(str, offset, ScaleFactor::TIMES_1, value_offset));
+  __ cmpq(out, Address(arg, offset, ScaleFactor::TIMES_1, value_offset));
+  __ j(kNotEqual, &return_false);
+  __ addl(offset, Immediate(8));
+  __ subl(len, Immediate(4));
+  __ j(kGreater, &remainder_loop);
 
   // Return true and exit the function.
   // If loop does not result in returning false, we return true.
   __ Bind(&return_true);
-  __ movl(rsi, Immediate(1));
+  __ movl(out, Immediate(1));
   __ jmp(&end);
 
   // Return false and exit the function.
   __ Bind(&return_false);
-  __ xorl(rsi, rsi);
+  __ xorl(out, out);
   __ Bind(&end);
 }
 
@@ -566,12 +566,20 @@ class LSEVisitor : public HGraphVisitor {
       store->GetBlock()->RemoveInstruction(store);
     }
 
-    // TODO: remove unnecessary allocations.
-    // Eliminate instructions in singleton_new_instances_ that:
-    // - don't have uses,
-    // - don't have finalizers,
-    // - are instantiable and accessible,
-    // - have no/separate clinit check.
+    // Eliminate singleton allocations whose loads and stores have all been
+    // replaced/removed above. An allocation that still has a real use, e.g. a
+    // store that had to be kept, cannot be eliminated. Finalizability,
+    // instantiability and access were already checked when the allocation was
+    // added to singleton_new_instances_, and the absence of deoptimization
+    // points means no environment needs to reconstruct the object.
+    size = singleton_new_instances_.size();
+    for (size_t i = 0; i < size; i++) {
+      HInstruction* new_instance = singleton_new_instances_[i];
+      if (!new_instance->HasNonEnvironmentUses()) {
+        new_instance->RemoveEnvironmentUsers();
+        new_instance->GetBlock()->RemoveInstruction(new_instance);
+      }
+    }
   }
 
  private:
@@ -973,7 +981,7 @@ class LSEVisitor : public HGraphVisitor {
         ref_info->IsSingletonAndNotReturned() &&
         !new_instance->IsFinalizable() &&
         !new_instance->CanThrow()) {
-      // TODO: add new_instance to singleton_new_instances_ and enable allocation elimination.
+      singleton_new_instances_.push_back(new_instance);
     }
     ArenaVector<HInstruction*>& heap_values =
         heap_values_for_[new_instance->GetBlock()->GetBlockId()];
@@ -0,0 +1,230 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "loop_optimization.h"
+
+namespace art {
+
+// Removes an instruction that is part of a dead induction cycle. The safety checks have
+// already been made by the caller, so the use lists may be bypassed.
+static void RemoveFromCycle(HInstruction* instruction) {
+  for (size_t i = 0, e = instruction->InputCount(); i < e; ++i) {
+    instruction->RemoveAsUserOfInput(i);
+  }
+  instruction->RemoveEnvironmentUsers();
+  instruction->GetBlock()->RemoveInstructionOrPhi(instruction, /* ensure_safety */ false);
+}
+
+// Returns whether all normal and environment uses of `instruction` are inside the loop.
+static bool UsedOnlyInsideLoop(HLoopInformation* loop_info, HInstruction* instruction) {
+  for (const HUseListNode<HInstruction*>& use : instruction->GetUses()) {
+    if (!loop_info->Contains(*use.GetUser()->GetBlock())) {
+      return false;
+    }
+  }
+  for (const HUseListNode<HEnvironment*>& use : instruction->GetEnvUses()) {
+    if (!loop_info->Contains(*use.GetUser()->GetHolder()->GetBlock())) {
+      return false;
+    }
+  }
+  return true;
+}
+
+HLoopOptimization::HLoopOptimization(HGraph* graph, HInductionVarAnalysis* induction_analysis)
+    : HOptimization(graph, kLoopOptimizationPassName),
+      induction_analysis_(induction_analysis),
+      induction_range_(induction_analysis),
+      top_loop_(nullptr),
+      last_loop_(nullptr) {
+}
+
+void HLoopOptimization::Run() {
+  // Build the linear order of the loop hierarchy. Loop headers are visited in reverse
+  // post order, so that an outer loop is always added before its inner loops.
+  for (HReversePostOrderIterator it(*graph_); !it.Done(); it.Advance()) {
+    HBasicBlock* block = it.Current();
+    if (block->IsLoopHeader()) {
+      AddLoop(block->GetLoopInformation());
+    }
+  }
+  if (top_loop_ == nullptr) {
+    return;  // no loops
+  }
+  TraverseLoopsInnerToOuter(top_loop_);
+}
+
+void HLoopOptimization::AddLoop(HLoopInformation* loop_info) {
+  DCHECK(loop_info != nullptr);
+  LoopNode* node = new (graph_->GetArena()) LoopNode(loop_info);
+  if (last_loop_ == nullptr) {
+    // First loop.
+    DCHECK(top_loop_ == nullptr);
+    last_loop_ = top_loop_ = node;
+  } else if (loop_info->IsIn(*last_loop_->loop_info)) {
+    // Inner loop.
+    node->outer = last_loop_;
+    DCHECK(last_loop_->inner == nullptr);
+    last_loop_ = last_loop_->inner = node;
+  } else {
+    // Subsequent loop.
+    while (last_loop_->outer != nullptr && !loop_info->IsIn(*last_loop_->outer->loop_info)) {
+      last_loop_ = last_loop_->outer;
+    }
+    node->outer = last_loop_->outer;
+    node->previous = last_loop_;
+    DCHECK(last_loop_->next == nullptr);
+    last_loop_ = last_loop_->next = node;
+  }
+}
+
+void HLoopOptimization::TraverseLoopsInnerToOuter(LoopNode* node) {
+  for ( ; node != nullptr; node = node->next) {
+    if (node->inner != nullptr) {
+      TraverseLoopsInnerToOuter(node->inner);
+    }
+    SimplifyInduction(node);
+    if (node->inner == nullptr) {
+      RemoveIfEmptyLoop(node);
+    }
+  }
+}
+
+void HLoopOptimization::SimplifyInduction(LoopNode* node) {
+  HBasicBlock* header = node->loop_info->GetHeader();
+  // Scan the phis in the header to find dead induction, typically left behind after
+  // dynamic BCE rewrote the loop in terms of a different induction variable. Removing
+  // the cycle i = phi(i0, u) with u = i op c shortens the live range of a register
+  // that would otherwise be carried around the loop without being used.
+  for (HInstructionIterator it(header->GetPhis()); !it.Done(); it.Advance()) {
+    HPhi* phi = it.Current()->AsPhi();
+    HInstruction* update = nullptr;
+    if (IsDeadPhiUpdateCycle(node->loop_info, phi, &update)) {
+      RemoveFromCycle(phi);     // removes environment uses too
+      RemoveFromCycle(update);  // removes environment uses too
+      MaybeRecordStat(MethodCompilationStat::kRemovedDeadInstruction, 2);
+    }
+  }
+}
+
+void HLoopOptimization::RemoveIfEmptyLoop(LoopNode* node) {
+  HLoopInformation* loop_info = node->loop_info;
+  DCHECK(node->inner == nullptr);
+  // Only simple countable loops that exit from the header are recognized.
+  if (loop_info->NumberOfBackEdges() != 1) {
+    return;
+  }
+  HBasicBlock* header = loop_info->GetHeader();
+  HInstruction* control = header->GetLastInstruction();
+  if (!control->IsIf()) {
+    return;
+  }
+  HIf* ifs = control->AsIf();
+  const bool true_in_loop = loop_info->Contains(*ifs->IfTrueSuccessor());
+  if (true_in_loop == loop_info->Contains(*ifs->IfFalseSuccessor())) {
+    return;
+  }
+  // The loop is empty when nothing it computes can be observed: no side effects,
+  // nothing that may throw, and no value that flows out of the loop.
+  for (HBlocksInLoopIterator block_it(*loop_info); !block_it.Done(); block_it.Advance()) {
+    HBasicBlock* block = block_it.Current();
+    for (HInstructionIterator it(block->GetPhis()); !it.Done(); it.Advance()) {
+      if (block != header || !UsedOnlyInsideLoop(loop_info, it.Current())) {
+        return;
+      }
+    }
+    for (HInstructionIterator it(block->GetInstructions()); !it.Done(); it.Advance()) {
+      HInstruction* instruction = it.Current();
+      if (instruction == control || instruction->IsGoto() || instruction->IsSuspendCheck()) {
+        continue;
+      }
+      if (instruction->HasSideEffects() ||
+          instruction->CanThrow() ||
+          !UsedOnlyInsideLoop(loop_info, instruction)) {
+        return;
+      }
+    }
+  }
+  // An empty loop may still hang, so removal requires a termination proof: range
+  // analysis must determine a finite range for an induction phi without needing
+  // an additional finite-test.
+  HPhi* induction_phi = nullptr;
+  for (HInstructionIterator it(header->GetPhis()); !it.Done(); it.Advance()) {
+    HPhi* phi = it.Current()->AsPhi();
+    if (induction_analysis_->LookupInfo(loop_info, phi) != nullptr) {
+      induction_phi = phi;
+      break;
+    }
+  }
+  if (induction_phi == nullptr) {
+    return;
+  }
+  InductionVarRange::Value min_val;
+  InductionVarRange::Value max_val;
+  bool needs_finite_test = false;
+  if (!induction_range_.GetInductionRange(
+          control, induction_phi, &min_val, &max_val, &needs_finite_test) ||
+      needs_finite_test || !min_val.is_known || !max_val.is_known) {
+    return;
+  }
+  // Running the loop for zero iterations is now known to be equivalent. Force
+  // the exit branch and let dead code elimination reclaim the loop afterwards.
+  ifs->ReplaceInput(graph_->GetIntConstant(true_in_loop ? 0 : 1), 0);
+  MaybeRecordStat(MethodCompilationStat::kRemovedDeadInstruction);
+}
+
+bool HLoopOptimization::IsDeadPhiUpdateCycle(HLoopInformation* loop_info,
+                                             HPhi* phi,
+                                             /*out*/ HInstruction** update) {
+  // Only the simple cycle of a loop phi and a single update instruction on the
+  // back edge is recognized. Induction analysis must have classified the phi, so
+  // that e.g. irreducible control flow never reaches the removal logic.
+  if (phi->InputCount() != 2 ||
+      induction_analysis_->LookupInfo(loop_info, phi) == nullptr) {
+    return false;
+  }
+  HInstruction* u = phi->InputAt(1);
+  if (u == phi ||
+      !loop_info->Contains(*u->GetBlock()) ||
+      u->HasSideEffects() ||
+      u->CanThrow()) {
+    return false;
+  }
+  // The cycle is dead when neither instruction escapes it. Environment uses outside
+  // the cycle are conservatively treated as escapes as well, since the interpreter
+  // may still read the corresponding dex register after deoptimization.
+  for (const HUseListNode<HInstruction*>& use : phi->GetUses()) {
+    if (use.GetUser() != u) {
+      return false;
+    }
+  }
+  for (const HUseListNode<HInstruction*>& use : u->GetUses()) {
+    if (use.GetUser() != phi) {
+      return false;
+    }
+  }
+  for (const HUseListNode<HEnvironment*>& use : phi->GetEnvUses()) {
+    if (use.GetUser()->GetHolder() != u) {
+      return false;
+    }
+  }
+  if (u->HasEnvironmentUses()) {
+    return false;  // phis have no environment that could hold the update
+  }
+  *update = u;
+  return true;
+}
+
+}  // namespace art
@@ -1655,7 +1655,7 @@ class HEnvironment : public ArenaObject<kArenaAllocEnvironment> {
      : vregs_(number_of_vregs, arena->Adapter(kArenaAllocEnvironmentVRegs)),
        locations_(number_of_vregs, arena->Adapter(kArenaAllocEnvironmentLocations)),
        parent_(nullptr),
-       dex_file_(dex_file),
+       dex_file_(&dex_file),
        method_idx_(method_idx),
        dex_pc_(dex_pc),
        invoke_type_(invoke_type),
@@ -1726,7 +1726,15 @@ class HEnvironment : public ArenaObject<kArenaAllocEnvironment> {
   }
 
   const DexFile& GetDexFile() const {
-    return dex_file_;
+    return *dex_file_;
+  }
+
+  // Rename the method this environment describes. Used when inlining across dex
+  // files, where the frame must be named by a method index that the stack walker
+  // can resolve in the dex file of the outer method.
+  void SetMethodInfo(const DexFile& dex_file, uint32_t method_idx) {
+    dex_file_ = &dex_file;
+    method_idx_ = method_idx;
   }
 
   HInstruction* GetHolder() const {
@@ -1742,8 +1750,8 @@ class HEnvironment : public ArenaObject<kArenaAllocEnvironment> {
   ArenaVector<HUserRecord<HEnvironment*>> vregs_;
   ArenaVector<Location> locations_;
   HEnvironment* parent_;
-  const DexFile& dex_file_;
-  const uint32_t method_idx_;
+  const DexFile* dex_file_;
+  uint32_t method_idx_;
   const uint32_t dex_pc_;
   const InvokeType invoke_type_;
 
@@ -5007,7 +5015,8 @@ class HInstanceFieldGet : public HExpression<1> {
                     field_idx,
                     declaring_class_def_index,
                     dex_file,
-                    dex_cache) {
+                    dex_cache),
+        read_barrier_elided_(false) {
     SetRawInputAt(0, value);
   }
 
@@ -5031,14 +5040,34 @@ class HInstanceFieldGet : public HExpression<1> {
   Primitive::Type GetFieldType() const { return field_info_.GetFieldType(); }
   bool IsVolatile() const { return field_info_.IsVolatile(); }
 
+  // Set by the read barrier elision pass when the loaded reference was proven to already
+  // point to to-space, so the code generator can emit a plain load. Only meaningful for
+  // reference type loads with read barriers enabled.
+  bool IsReadBarrierElided() const { return read_barrier_elided_; }
+  void SetReadBarrierElided() { read_barrier_elided_ = true; }
+
   DECLARE_INSTRUCTION(InstanceFieldGet);
 
  private:
   const FieldInfo field_info_;
+  bool read_barrier_elided_;
 
   DISALLOW_COPY_AND_ASSIGN(HInstanceFieldGet);
 };
 
+// Card marking decision for a reference store, refined by the write barrier
+// elimination pass.
+enum class WriteBarrierKind {
+  // Emit the card mark, skipping it when the stored value is null.
+  kEmitWithNullCheck,
+  // Emit the card mark unconditionally: elided later stores to the same object rely on it.
+  kEmitBeingReliedOn,
+  // Do not emit the card mark: a preceding store already dirtied the object's card and no
+  // thread suspension can happen in between.
+  kDontEmit,
+  kLast = kDontEmit
+};
+
 class HInstanceFieldSet : public HTemplateInstruction<2> {
  public:
   HInstanceFieldSet(HInstruction* object,
@@ -5061,6 +5090,7 @@ class HInstanceFieldSet : public HTemplateInstruction<2> {
                     dex_file,
                     dex_cache) {
     SetPackedFlag<kFlagValueCanBeNull>(true);
+    SetPackedField<WriteBarrierKindField>(WriteBarrierKind::kEmitWithNullCheck);
     SetRawInputAt(0, object);
     SetRawInputAt(1, value);
   }
@@ -5076,14 +5106,22 @@ class HInstanceFieldSet : public HTemplateInstruction<2> {
   HInstruction* GetValue() const { return InputAt(1); }
   bool GetValueCanBeNull() const { return GetPackedFlag<kFlagValueCanBeNull>(); }
   void ClearValueCanBeNull() { SetPackedFlag<kFlagValueCanBeNull>(false); }
+  WriteBarrierKind GetWriteBarrierKind() const { return GetPackedField<WriteBarrierKindField>(); }
+  void SetWriteBarrierKind(WriteBarrierKind kind) { SetPackedField<WriteBarrierKindField>(kind); }
 
   DECLARE_INSTRUCTION(InstanceFieldSet);
 
  private:
   static constexpr size_t kFlagValueCanBeNull = kNumberOfGenericPackedBits;
-  static constexpr size_t kNumberOfInstanceFieldSetPackedBits = kFlagValueCanBeNull + 1;
+  static constexpr size_t kFieldWriteBarrierKind = kFlagValueCanBeNull + 1;
+  static constexpr size_t kFieldWriteBarrierKindSize =
+      MinimumBitsToStore(static_cast<size_t>(WriteBarrierKind::kLast));
+  static constexpr size_t kNumberOfInstanceFieldSetPackedBits =
+      kFieldWriteBarrierKind + kFieldWriteBarrierKindSize;
   static_assert(kNumberOfInstanceFieldSetPackedBits <= kMaxNumberOfPackedBits,
                 "Too many packed fields.");
+  using WriteBarrierKindField =
+      BitField<WriteBarrierKind, kFieldWriteBarrierKind, kFieldWriteBarrierKindSize>;
 
   const FieldInfo field_info_;
 
@@ -5159,6 +5197,7 @@ class HArraySet : public HTemplateInstruction<3> {
     SetPackedFlag<kFlagNeedsTypeCheck>(value->GetType() == Primitive::kPrimNot);
     SetPackedFlag<kFlagValueCanBeNull>(true);
     SetPackedFlag<kFlagStaticTypeOfArrayIsObjectArray>(false);
+    SetPackedField<WriteBarrierKindField>(WriteBarrierKind::kEmitWithNullCheck);
     SetRawInputAt(0, array);
     SetRawInputAt(1, index);
     SetRawInputAt(2, value);
@@ -5194,6 +5233,8 @@ class HArraySet : public HTemplateInstruction<3> {
   bool StaticTypeOfArrayIsObjectArray() const {
     return GetPackedFlag<kFlagStaticTypeOfArrayIsObjectArray>();
   }
+  WriteBarrierKind GetWriteBarrierKind() const { return GetPackedField<WriteBarrierKindField>(); }
+  void SetWriteBarrierKind(WriteBarrierKind kind) { SetPackedField<WriteBarrierKindField>(kind); }
 
   HInstruction* GetArray() const { return InputAt(0); }
   HInstruction* GetIndex() const { return InputAt(1); }
@@ -5230,11 +5271,16 @@ class HArraySet : public HTemplateInstruction<3> {
   // Cached information for the reference_type_info_ so that codegen
   // does not need to inspect the static type.
   static constexpr size_t kFlagStaticTypeOfArrayIsObjectArray = kFlagValueCanBeNull + 1;
+  static constexpr size_t kFieldWriteBarrierKind = kFlagStaticTypeOfArrayIsObjectArray + 1;
+  static constexpr size_t kFieldWriteBarrierKindSize =
+      MinimumBitsToStore(static_cast<size_t>(WriteBarrierKind::kLast));
   static constexpr size_t kNumberOfArraySetPackedBits =
-      kFlagStaticTypeOfArrayIsObjectArray + 1;
+      kFieldWriteBarrierKind + kFieldWriteBarrierKindSize;
   static_assert(kNumberOfArraySetPackedBits <= kMaxNumberOfPackedBits, "Too many packed fields.");
   using ExpectedComponentTypeField =
       BitField<Primitive::Type, kFieldExpectedComponentType, kFieldExpectedComponentTypeSize>;
+  using WriteBarrierKindField =
+      BitField<WriteBarrierKind, kFieldWriteBarrierKind, kFieldWriteBarrierKindSize>;
 
   DISALLOW_COPY_AND_ASSIGN(HArraySet);
 };
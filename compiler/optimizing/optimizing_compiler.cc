@@ -17,7 +17,9 @@
 #include "optimizing_compiler.h"
 
 #include <fstream>
+#include <map>
 #include <memory>
+#include <set>
 #include <stdint.h>
 
 #ifdef ART_ENABLE_CODEGEN_arm
@@ -26,6 +28,7 @@
 
 #ifdef ART_ENABLE_CODEGEN_arm64
 #include "instruction_simplifier_arm64.h"
+#include "scheduler_arm64.h"
 #endif
 
 #ifdef ART_ENABLE_CODEGEN_x86
@@ -37,9 +40,11 @@
 #include "base/arena_containers.h"
 #include "base/dumpable.h"
 #include "base/macros.h"
+#include "base/time_utils.h"
 #include "base/timing_logger.h"
 #include "bounds_check_elimination.h"
 #include "builder.h"
+#include "code_sinking.h"
 #include "code_generator.h"
 #include "compiled_method.h"
 #include "compiler.h"
@@ -68,9 +73,11 @@
 #include "jni/quick/jni_compiler.h"
 #include "licm.h"
 #include "load_store_elimination.h"
+#include "loop_optimization.h"
 #include "nodes.h"
 #include "oat_quick_method_header.h"
 #include "prepare_for_register_allocation.h"
+#include "read_barrier_elision.h"
 #include "reference_type_propagation.h"
 #include "register_allocator.h"
 #include "select_generator.h"
@@ -78,6 +85,7 @@
 #include "side_effects_analysis.h"
 #include "ssa_builder.h"
 #include "ssa_liveness_analysis.h"
+#include "write_barrier_elimination.h"
 #include "ssa_phi_elimination.h"
 #include "utils/assembler.h"
 #include "verifier/method_verifier.h"
@@ -117,6 +125,77 @@ class CodeVectorAllocator FINAL : public CodeAllocator {
  */
 static constexpr const char kStringFilter[] = "";
 
+/**
+ * Aggregates pass wall times over all compiled methods and keeps the most
+ * expensive methods for a top-k offender report. Compiler threads add their
+ * measurements under lock_; the report is written to the file selected with
+ * --dump-pass-timings when the compiler is destroyed.
+ */
+class PassTimingAggregator {
+ public:
+  explicit PassTimingAggregator(const std::string& file_name)
+      : lock_("Pass timing lock"),
+        file_name_(file_name) {}
+
+  void AddPass(const char* pass_name, uint64_t duration_ns) REQUIRES(!lock_) {
+    MutexLock mu(Thread::Current(), lock_);
+    PassTotal& total = pass_totals_[pass_name];
+    total.ns += duration_ns;
+    total.count += 1u;
+  }
+
+  void AddMethod(const char* method_name, uint64_t duration_ns) REQUIRES(!lock_) {
+    MutexLock mu(Thread::Current(), lock_);
+    top_methods_.emplace(duration_ns, method_name);
+    if (top_methods_.size() > kTopKMethods) {
+      top_methods_.erase(top_methods_.begin());
+    }
+  }
+
+  void Dump() REQUIRES(!lock_) {
+    MutexLock mu(Thread::Current(), lock_);
+    std::ofstream os(file_name_);
+    if (!os.is_open()) {
+      LOG(ERROR) << "Could not open pass timing file " << file_name_;
+      return;
+    }
+    std::vector<const std::pair<const std::string, PassTotal>*> passes;
+    passes.reserve(pass_totals_.size());
+    for (const auto& it : pass_totals_) {
+      passes.push_back(&it);
+    }
+    std::sort(passes.begin(), passes.end(),
+              [](const std::pair<const std::string, PassTotal>* a,
+                 const std::pair<const std::string, PassTotal>* b) {
+                return a->second.ns > b->second.ns;
+              });
+    os << "Pass timings aggregated over all compiled methods:\n";
+    for (const auto* pass : passes) {
+      os << "  " << PrettyDuration(pass->second.ns) << " in " << pass->second.count
+         << " runs: " << pass->first << "\n";
+    }
+    os << "Top " << top_methods_.size() << " methods by time in the optimizing compiler:\n";
+    for (auto it = top_methods_.rbegin(); it != top_methods_.rend(); ++it) {
+      os << "  " << PrettyDuration(it->first) << " " << it->second << "\n";
+    }
+  }
+
+ private:
+  struct PassTotal {
+    uint64_t ns = 0u;
+    size_t count = 0u;
+  };
+
+  static constexpr size_t kTopKMethods = 20;
+
+  Mutex lock_;
+  const std::string file_name_;
+  std::map<std::string, PassTotal> pass_totals_ GUARDED_BY(lock_);
+  std::multiset<std::pair<uint64_t, std::string>> top_methods_ GUARDED_BY(lock_);
+
+  DISALLOW_COPY_AND_ASSIGN(PassTimingAggregator);
+};
+
 class PassScope;
 
 class PassObserver : public ValueObject {
@@ -124,11 +203,15 @@ class PassObserver : public ValueObject {
   PassObserver(HGraph* graph,
                CodeGenerator* codegen,
                std::ostream* visualizer_output,
-               CompilerDriver* compiler_driver)
+               CompilerDriver* compiler_driver,
+               PassTimingAggregator* pass_timings)
       : graph_(graph),
         cached_method_name_(),
         timing_logger_enabled_(compiler_driver->GetDumpPasses()),
         timing_logger_(timing_logger_enabled_ ? GetMethodName() : "", true, true),
+        pass_timings_(pass_timings),
+        pass_start_ns_(0u),
+        method_total_ns_(0u),
         disasm_info_(graph->GetArena()),
         visualizer_enabled_(!compiler_driver->GetCompilerOptions().GetDumpCfgFileName().empty()),
         visualizer_(visualizer_output, graph, *codegen),
@@ -149,6 +232,9 @@ class PassObserver : public ValueObject {
       LOG(INFO) << "TIMINGS " << GetMethodName();
       LOG(INFO) << Dumpable<TimingLogger>(timing_logger_);
     }
+    if (pass_timings_ != nullptr && method_total_ns_ != 0u) {
+      pass_timings_->AddMethod(GetMethodName(), method_total_ns_);
+    }
   }
 
   void DumpDisassembly() const {
@@ -176,10 +262,18 @@ class PassObserver : public ValueObject {
     if (timing_logger_enabled_) {
       timing_logger_.StartTiming(pass_name);
     }
+    if (pass_timings_ != nullptr) {
+      pass_start_ns_ = NanoTime();
+    }
   }
 
   void EndPass(const char* pass_name) {
     // Pause timer first, then dump graph.
+    if (pass_timings_ != nullptr) {
+      const uint64_t duration_ns = NanoTime() - pass_start_ns_;
+      pass_timings_->AddPass(pass_name, duration_ns);
+      method_total_ns_ += duration_ns;
+    }
     if (timing_logger_enabled_) {
       timing_logger_.EndTiming();
     }
@@ -223,6 +317,11 @@ class PassObserver : public ValueObject {
   bool timing_logger_enabled_;
   TimingLogger timing_logger_;
 
+  // Aggregated pass timings shared by all methods; null when --dump-pass-timings is not set.
+  PassTimingAggregator* const pass_timings_;
+  uint64_t pass_start_ns_;
+  uint64_t method_total_ns_;
+
   DisassemblyInformation disasm_info_;
 
   bool visualizer_enabled_;
@@ -328,6 +427,8 @@ class OptimizingCompiler FINAL : public Compiler {
 
   std::unique_ptr<std::ostream> visualizer_output_;
 
+  std::unique_ptr<PassTimingAggregator> pass_timings_;
+
   DISALLOW_COPY_AND_ASSIGN(OptimizingCompiler);
 };
 
@@ -352,6 +453,11 @@ void OptimizingCompiler::Init() {
   if (driver->GetDumpStats()) {
     compilation_stats_.reset(new OptimizingCompilerStats());
   }
+  const std::string& pass_timings_file_name =
+      driver->GetCompilerOptions().GetDumpPassTimingsFileName();
+  if (!pass_timings_file_name.empty()) {
+    pass_timings_.reset(new PassTimingAggregator(pass_timings_file_name));
+  }
 }
 
 void OptimizingCompiler::UnInit() const {
@@ -361,6 +467,9 @@ OptimizingCompiler::~OptimizingCompiler() {
   if (compilation_stats_.get() != nullptr) {
     compilation_stats_->Log();
   }
+  if (pass_timings_.get() != nullptr) {
+    pass_timings_->Dump();
+  }
 }
 
 bool OptimizingCompiler::CanCompileMethod(uint32_t method_idx ATTRIBUTE_UNUSED,
@@ -453,10 +562,12 @@ static void RunArchOptimizations(InstructionSet instruction_set,
           new (arena) arm64::InstructionSimplifierArm64(graph, stats);
       SideEffectsAnalysis* side_effects = new (arena) SideEffectsAnalysis(graph);
       GVNOptimization* gvn = new (arena) GVNOptimization(graph, *side_effects, "GVN_after_arch");
+      arm64::SchedulerArm64* scheduler = new (arena) arm64::SchedulerArm64(graph);
       HOptimization* arm64_optimizations[] = {
         simplifier,
         side_effects,
-        gvn
+        gvn,
+        scheduler
       };
       RunOptimizations(arm64_optimizations, arraysize(arm64_optimizations), pass_observer);
       break;
@@ -521,6 +632,11 @@ static void RunOptimizations(HGraph* graph,
   LoadStoreElimination* lse = new (arena) LoadStoreElimination(graph, *side_effects);
   HInductionVarAnalysis* induction = new (arena) HInductionVarAnalysis(graph);
   BoundsCheckElimination* bce = new (arena) BoundsCheckElimination(graph, *side_effects, induction);
+  HLoopOptimization* loop = new (arena) HLoopOptimization(graph, induction);
+  CodeSinking* code_sinking = new (arena) CodeSinking(graph, stats);
+  ReadBarrierElision* read_barrier_elision = new (arena) ReadBarrierElision(graph, stats);
+  WriteBarrierElimination* write_barrier_elimination =
+      new (arena) WriteBarrierElimination(graph, stats);
   HSharpening* sharpening = new (arena) HSharpening(graph, codegen, dex_compilation_unit, driver);
   InstructionSimplifier* simplify2 = new (arena) InstructionSimplifier(
       graph, stats, "instruction_simplifier_after_bce");
@@ -549,14 +665,20 @@ static void RunOptimizations(HGraph* graph,
     licm,
     induction,
     bce,
+    loop,
     fold3,  // evaluates code generated by dynamic bce
     simplify2,
     lse,
     dce2,
+    code_sinking,
     // The codegen has a few assumptions that only the instruction simplifier
     // can satisfy. For example, the code generator does not expect to see a
     // HTypeConversion from a type to the same type.
     simplify3,
+    // These two run last so that no later pass can move memory accesses across
+    // the suspend points their proofs rely on.
+    read_barrier_elision,
+    write_barrier_elimination,
   };
   RunOptimizations(optimizations2, arraysize(optimizations2), pass_observer);
 
@@ -724,7 +846,8 @@ CodeGenerator* OptimizingCompiler::TryCompile(ArenaAllocator* arena,
   PassObserver pass_observer(graph,
                              codegen.get(),
                              visualizer_output_.get(),
-                             compiler_driver);
+                             compiler_driver,
+                             pass_timings_.get());
 
   VLOG(compiler) << "Building " << pass_observer.GetMethodName();
 
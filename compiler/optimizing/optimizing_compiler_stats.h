@@ -60,11 +60,14 @@ enum MethodCompilationStat {
   kBooleanSimplified,
   kIntrinsicRecognized,
   kLoopInvariantMoved,
+  kInstructionSunk,
   kSelectGenerated,
   kRemovedInstanceOf,
   kInlinedInvokeVirtualOrInterface,
   kImplicitNullCheckGenerated,
   kExplicitNullCheckGenerated,
+  kElidedReadBarrier,
+  kElidedWriteBarrier,
   kLastStat
 };
 
@@ -138,11 +141,14 @@ class OptimizingCompilerStats {
       case kBooleanSimplified : name = "BooleanSimplified"; break;
       case kIntrinsicRecognized : name = "IntrinsicRecognized"; break;
       case kLoopInvariantMoved : name = "LoopInvariantMoved"; break;
+      case kInstructionSunk : name = "InstructionSunk"; break;
       case kSelectGenerated : name = "SelectGenerated"; break;
       case kRemovedInstanceOf: name = "RemovedInstanceOf"; break;
       case kInlinedInvokeVirtualOrInterface: name = "InlinedInvokeVirtualOrInterface"; break;
       case kImplicitNullCheckGenerated: name = "ImplicitNullCheckGenerated"; break;
       case kExplicitNullCheckGenerated: name = "ExplicitNullCheckGenerated"; break;
+      case kElidedReadBarrier: name = "ElidedReadBarrier"; break;
+      case kElidedWriteBarrier: name = "ElidedWriteBarrier"; break;
 
       case kLastStat:
         LOG(FATAL) << "invalid stat "
@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "read_barrier_elision.h"
+
+namespace art {
+
+// Returns whether executing `instruction` can lead to a thread suspension, after
+// which references obtained earlier may point to from-space.
+static bool CanSuspend(HInstruction* instruction) {
+  return instruction->IsSuspendCheck() ||
+         instruction->GetSideEffects().Includes(SideEffects::CanTriggerGC());
+}
+
+void ReadBarrierElision::Run() {
+  if (!kEmitCompilerReadBarrier) {
+    return;
+  }
+  ArenaAllocator* arena = graph_->GetArena();
+  // Objects allocated in the current block with no suspend point since. Both vectors are
+  // small in practice, so linear scans beat the constant factor of a hash container.
+  ArenaVector<HInstruction*> fresh_allocations(arena->Adapter(kArenaAllocMisc));
+  // Reference field loads seen in the current block with no suspend point since.
+  ArenaVector<HInstanceFieldGet*> prior_loads(arena->Adapter(kArenaAllocMisc));
+  for (HReversePostOrderIterator it(*graph_); !it.Done(); it.Advance()) {
+    HBasicBlock* block = it.Current();
+    fresh_allocations.clear();
+    prior_loads.clear();
+    for (HInstructionIterator inst_it(block->GetInstructions()); !inst_it.Done();
+         inst_it.Advance()) {
+      HInstruction* instruction = inst_it.Current();
+      if (instruction->IsNewInstance() || instruction->IsNewArray()) {
+        // The allocation itself can trigger a collection, invalidating everything
+        // learned so far; the new object is safe from here on.
+        fresh_allocations.clear();
+        prior_loads.clear();
+        fresh_allocations.push_back(instruction);
+        continue;
+      }
+      if (instruction->IsInstanceFieldGet()) {
+        HInstanceFieldGet* get = instruction->AsInstanceFieldGet();
+        if (get->GetType() != Primitive::kPrimNot || get->IsVolatile()) {
+          continue;
+        }
+        HInstruction* object = get->InputAt(0);
+        bool redundant = ContainsElement(fresh_allocations, object);
+        if (!redundant) {
+          for (HInstanceFieldGet* prior : prior_loads) {
+            if (prior->InputAt(0) == object &&
+                prior->GetFieldOffset().Uint32Value() == get->GetFieldOffset().Uint32Value()) {
+              redundant = true;
+              break;
+            }
+          }
+        }
+        if (redundant) {
+          get->SetReadBarrierElided();
+          MaybeRecordStat(MethodCompilationStat::kElidedReadBarrier);
+        }
+        prior_loads.push_back(get);
+        continue;
+      }
+      if (CanSuspend(instruction)) {
+        fresh_allocations.clear();
+        prior_loads.clear();
+      }
+    }
+  }
+}
+
+}  // namespace art
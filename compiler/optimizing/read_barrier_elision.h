@@ -0,0 +1,56 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_COMPILER_OPTIMIZING_READ_BARRIER_ELISION_H_
+#define ART_COMPILER_OPTIMIZING_READ_BARRIER_ELISION_H_
+
+#include "nodes.h"
+#include "optimization.h"
+
+namespace art {
+
+/**
+ * Optimization pass proving reference field loads redundant with respect to the
+ * concurrent copying collector's read barrier. Within a basic block, and as long
+ * as no thread suspension can happen in between, two classes of loads cannot
+ * observe a from-space reference:
+ *
+ *  - loads from an object allocated in the same block: every reference stored
+ *    into it was obtained through a read barrier (or is itself newly allocated),
+ *    so it points to to-space, and without a suspend point no flip can intervene;
+ *  - repeated loads of the same field of the same object: the first load's
+ *    barrier (or the store that produced the value) already yielded a to-space
+ *    reference, and the to-space invariant keeps any racing store to-space too.
+ *
+ * Such loads are flagged so the code generator can emit a plain load. The pass
+ * is a no-op when the compiler does not emit read barriers.
+ */
+class ReadBarrierElision : public HOptimization {
+ public:
+  ReadBarrierElision(HGraph* graph, OptimizingCompilerStats* stats)
+      : HOptimization(graph, kReadBarrierElisionPassName, stats) {}
+
+  void Run() OVERRIDE;
+
+  static constexpr const char* kReadBarrierElisionPassName = "read_barrier_elision";
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(ReadBarrierElision);
+};
+
+}  // namespace art
+
+#endif  // ART_COMPILER_OPTIMIZING_READ_BARRIER_ELISION_H_
@@ -0,0 +1,189 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "scheduler_arm64.h"
+
+#include <algorithm>
+
+namespace art {
+namespace arm64 {
+
+// Approximate result latencies, in cycles, of the Cortex-A53. They do not
+// need to be exact: the scheduler only uses them to decide which of several
+// ready instructions should issue first. The same ordering decisions are
+// harmless on out-of-order cores such as the Cortex-A57.
+static constexpr uint32_t kArm64MemoryLoadLatency = 4;
+static constexpr uint32_t kArm64MulIntegralLatency = 3;
+static constexpr uint32_t kArm64DivIntegralLatency = 10;
+static constexpr uint32_t kArm64DivFloatingPointLatency = 15;
+static constexpr uint32_t kArm64FloatingPointOpLatency = 4;
+static constexpr uint32_t kArm64DefaultLatency = 1;
+
+// Regions below this size have at most one pair of independent instructions
+// and cannot be improved by reordering.
+static constexpr size_t kMinimumRegionSize = 3;
+
+static uint32_t LatencyOf(HInstruction* instruction) {
+  if (instruction->IsArrayGet() ||
+      instruction->IsArrayLength() ||
+      instruction->IsInstanceFieldGet() ||
+      instruction->IsStaticFieldGet()) {
+    return kArm64MemoryLoadLatency;
+  }
+  if (instruction->IsDiv() || instruction->IsRem()) {
+    return Primitive::IsFloatingPointType(instruction->GetType())
+        ? kArm64DivFloatingPointLatency
+        : kArm64DivIntegralLatency;
+  }
+  if (instruction->IsMul() && !Primitive::IsFloatingPointType(instruction->GetType())) {
+    return kArm64MulIntegralLatency;
+  }
+  if (Primitive::IsFloatingPointType(instruction->GetType())) {
+    return kArm64FloatingPointOpLatency;
+  }
+  return kArm64DefaultLatency;
+}
+
+// Returns whether `instruction` may be freely reordered with respect to other
+// schedulable instructions. Anything else acts as a scheduling barrier that
+// keeps its position and delimits the regions being reordered: in particular
+// heap writes and instructions that may trigger garbage collection, so that
+// heap reads and GC-dependent values never move across them. Conditions are
+// also kept in place, as code generation prefers them adjacent to their
+// branch.
+static bool IsSchedulable(HInstruction* instruction) {
+  return !instruction->IsControlFlow() &&
+         !instruction->IsCondition() &&
+         !instruction->CanThrow() &&
+         !instruction->HasEnvironment() &&
+         instruction->GetSideEffects().Exclusion(
+             SideEffects::AllReads().Union(SideEffects::DependsOnGC())).DoesNothing();
+}
+
+void SchedulerArm64::Run() {
+  for (HReversePostOrderIterator it(*graph_); !it.Done(); it.Advance()) {
+    ScheduleBlock(it.Current());
+  }
+}
+
+void SchedulerArm64::ScheduleBlock(HBasicBlock* block) {
+  // Split the block into regions of consecutive schedulable instructions.
+  // The block always ends with control flow, which flushes the last region.
+  ArenaVector<HInstruction*> region(graph_->GetArena()->Adapter(kArenaAllocMisc));
+  for (HInstructionIterator it(block->GetInstructions()); !it.Done(); it.Advance()) {
+    HInstruction* instruction = it.Current();
+    if (IsSchedulable(instruction)) {
+      region.push_back(instruction);
+    } else {
+      ScheduleRegion(region, instruction);
+      region.clear();
+    }
+  }
+}
+
+void SchedulerArm64::ScheduleRegion(const ArenaVector<HInstruction*>& region,
+                                    HInstruction* delimiter) {
+  const size_t size = region.size();
+  if (size < kMinimumRegionSize) {
+    return;
+  }
+  // There is no latency to hide when every instruction completes in a cycle.
+  bool has_multi_cycle_instruction = false;
+  for (size_t i = 0; i < size && !has_multi_cycle_instruction; ++i) {
+    has_multi_cycle_instruction = LatencyOf(region[i]) > kArm64DefaultLatency;
+  }
+  if (!has_multi_cycle_instruction) {
+    return;
+  }
+
+  ArenaAllocator* arena = graph_->GetArena();
+  ArenaSafeMap<HInstruction*, size_t> position(
+      std::less<HInstruction*>(), arena->Adapter(kArenaAllocMisc));
+  for (size_t i = 0; i < size; ++i) {
+    position.Put(region[i], i);
+  }
+
+  // Since the region contains no heap writes, the only dependences within it
+  // are through SSA inputs, and a producer always precedes its users in the
+  // original order. Record, for every instruction, its users inside the
+  // region and the number of region-internal inputs still unscheduled.
+  ArenaVector<ArenaVector<size_t>> users(
+      size, ArenaVector<size_t>(arena->Adapter(kArenaAllocMisc)), arena->Adapter(kArenaAllocMisc));
+  ArenaVector<size_t> unscheduled_inputs(size, 0u, arena->Adapter(kArenaAllocMisc));
+  for (size_t i = 0; i < size; ++i) {
+    HInstruction* instruction = region[i];
+    for (size_t j = 0, e = instruction->InputCount(); j < e; ++j) {
+      auto it = position.find(instruction->InputAt(j));
+      if (it != position.end()) {
+        users[it->second].push_back(i);
+        ++unscheduled_inputs[i];
+      }
+    }
+  }
+
+  // The priority of an instruction is the latency-weighted length of the
+  // longest dependence chain it starts within the region. Users precede their
+  // producers in this backward walk, so their priorities are final when read.
+  ArenaVector<uint32_t> priority(size, 0u, arena->Adapter(kArenaAllocMisc));
+  for (size_t i = size; i > 0; --i) {
+    uint32_t value = LatencyOf(region[i - 1]);
+    for (size_t user : users[i - 1]) {
+      value = std::max(value, LatencyOf(region[i - 1]) + priority[user]);
+    }
+    priority[i - 1] = value;
+  }
+
+  // List scheduling: repeatedly issue, among the instructions whose region-
+  // internal inputs have all been scheduled, the one on the most critical
+  // path, preferring the original order on ties.
+  ArenaVector<size_t> ready(arena->Adapter(kArenaAllocMisc));
+  for (size_t i = 0; i < size; ++i) {
+    if (unscheduled_inputs[i] == 0u) {
+      ready.push_back(i);
+    }
+  }
+  ArenaVector<HInstruction*> order(arena->Adapter(kArenaAllocMisc));
+  order.reserve(size);
+  while (!ready.empty()) {
+    size_t best = 0;
+    for (size_t i = 1; i < ready.size(); ++i) {
+      if (priority[ready[i]] > priority[ready[best]] ||
+          (priority[ready[i]] == priority[ready[best]] && ready[i] < ready[best])) {
+        best = i;
+      }
+    }
+    size_t current = ready[best];
+    ready.erase(ready.begin() + best);
+    order.push_back(region[current]);
+    for (size_t user : users[current]) {
+      if (--unscheduled_inputs[user] == 0u) {
+        ready.push_back(user);
+      }
+    }
+  }
+  DCHECK_EQ(order.size(), size);
+
+  // Re-emit the region in the new order, directly before the delimiter.
+  if (std::equal(order.begin(), order.end(), region.begin())) {
+    return;
+  }
+  for (HInstruction* instruction : order) {
+    instruction->MoveBefore(delimiter);
+  }
+}
+
+}  // namespace arm64
+}  // namespace art
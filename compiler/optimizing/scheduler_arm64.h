@@ -0,0 +1,57 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_COMPILER_OPTIMIZING_SCHEDULER_ARM64_H_
+#define ART_COMPILER_OPTIMIZING_SCHEDULER_ARM64_H_
+
+#include "nodes.h"
+#include "optimization.h"
+
+namespace art {
+namespace arm64 {
+
+/**
+ * Local instruction scheduler for ARM64. Code is generated in the order in
+ * which instructions appear in their block, and on in-order cores such as the
+ * Cortex-A53 a value used directly after the load producing it stalls the
+ * pipeline. This pass reorders side-effect free instructions within a basic
+ * block, using list scheduling with approximate result latencies, so that
+ * independent work separates loads from their uses.
+ */
+class SchedulerArm64 : public HOptimization {
+ public:
+  explicit SchedulerArm64(HGraph* graph)
+      : HOptimization(graph, kSchedulerArm64PassName) {}
+
+  void Run() OVERRIDE;
+
+  static constexpr const char* kSchedulerArm64PassName = "scheduler_arm64";
+
+ private:
+  void ScheduleBlock(HBasicBlock* block);
+
+  // Reschedules the consecutive schedulable instructions in `region` by
+  // moving them, in the new order, directly before `delimiter` (the first
+  // instruction after the region that must stay in place).
+  void ScheduleRegion(const ArenaVector<HInstruction*>& region, HInstruction* delimiter);
+
+  DISALLOW_COPY_AND_ASSIGN(SchedulerArm64);
+};
+
+}  // namespace arm64
+}  // namespace art
+
+#endif  // ART_COMPILER_OPTIMIZING_SCHEDULER_ARM64_H_
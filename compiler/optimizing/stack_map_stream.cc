@@ -49,8 +49,18 @@ void StackMapStream::BeginStackMapEntry(uint32_t dex_pc,
     number_of_stack_maps_with_inline_info_++;
   }
 
+  // Deduplicate the register mask; most stack maps of a method share a few masks.
+  auto it = register_mask_indices_.find(register_mask);
+  if (it != register_mask_indices_.end()) {
+    current_entry_.register_mask_index = it->second;
+  } else {
+    size_t index = register_masks_.size();
+    register_masks_.push_back(register_mask);
+    register_mask_indices_.Put(register_mask, index);
+    current_entry_.register_mask_index = index;
+  }
+
   dex_pc_max_ = std::max(dex_pc_max_, dex_pc);
-  register_mask_max_ = std::max(register_mask_max_, register_mask);
   current_dex_register_ = 0;
 }
 
@@ -145,30 +155,46 @@ size_t StackMapStream::PrepareForFillIn() {
                                                            dex_pc_max_,
                                                            dex_register_maps_size_,
                                                            inline_info_size_,
-                                                           register_mask_max_,
+                                                           register_masks_.size(),
                                                            stack_mask_number_of_bits);
   stack_maps_size_ = stack_maps_.size() * stack_map_size;
+  register_masks_size_ = register_masks_.size() * sizeof(uint32_t);
   dex_register_location_catalog_size_ = ComputeDexRegisterLocationCatalogSize();
 
   size_t non_header_size =
       stack_maps_size_ +
+      register_masks_size_ +
       dex_register_location_catalog_size_ +
       dex_register_maps_size_ +
       inline_info_size_;
 
   // Prepare the CodeInfo variable-sized encoding.
   CodeInfoEncoding code_info_encoding;
+  // Compute how many leading stack maps are sorted by native pc offset, so that the
+  // runtime can binary search them. Safepoint stack maps are emitted in code order and
+  // form a sorted prefix; catch stack maps are emitted at the end and may break it.
+  size_t number_of_sorted_stack_maps = stack_maps_.size();
+  for (size_t i = 1; i < stack_maps_.size(); ++i) {
+    if (stack_maps_[i].native_pc_offset < stack_maps_[i - 1].native_pc_offset) {
+      number_of_sorted_stack_maps = i;
+      break;
+    }
+  }
+
   code_info_encoding.non_header_size = non_header_size;
   code_info_encoding.number_of_stack_maps = stack_maps_.size();
+  code_info_encoding.number_of_sorted_stack_maps = number_of_sorted_stack_maps;
   code_info_encoding.stack_map_size_in_bytes = stack_map_size;
   code_info_encoding.stack_map_encoding = stack_map_encoding_;
   code_info_encoding.inline_info_encoding = inline_info_encoding_;
   code_info_encoding.number_of_location_catalog_entries = location_catalog_entries_.size();
+  code_info_encoding.number_of_register_masks = register_masks_.size();
   code_info_encoding.Compress(&code_info_encoding_);
 
   // TODO: Move the catalog at the end. It is currently too expensive at runtime
   // to compute its size (note that we do not encode that size in the CodeInfo).
-  dex_register_location_catalog_start_ = code_info_encoding_.size() + stack_maps_size_;
+  register_masks_start_ = code_info_encoding_.size() + stack_maps_size_;
+  dex_register_location_catalog_start_ = register_masks_start_ + register_masks_size_;
   dex_register_maps_start_ =
       dex_register_location_catalog_start_ + dex_register_location_catalog_size_;
   inline_infos_start_ = dex_register_maps_start_ + dex_register_maps_size_;
@@ -270,6 +296,13 @@ void StackMapStream::FillIn(MemoryRegion region) {
   CodeInfoEncoding encoding = code_info.ExtractEncoding();
   DCHECK_EQ(code_info.GetStackMapsSize(encoding), stack_maps_size_);
 
+  // Write the register mask table referenced by the stack maps.
+  MemoryRegion register_masks_region = region.Subregion(register_masks_start_,
+                                                        register_masks_size_);
+  for (size_t i = 0, e = register_masks_.size(); i < e; ++i) {
+    register_masks_region.StoreUnaligned<uint32_t>(i * sizeof(uint32_t), register_masks_[i]);
+  }
+
   // Set the Dex register location catalog.
   MemoryRegion dex_register_location_catalog_region = region.Subregion(
       dex_register_location_catalog_start_, dex_register_location_catalog_size_);
@@ -293,7 +326,7 @@ void StackMapStream::FillIn(MemoryRegion region) {
 
     stack_map.SetDexPc(stack_map_encoding_, entry.dex_pc);
     stack_map.SetNativePcOffset(stack_map_encoding_, entry.native_pc_offset);
-    stack_map.SetRegisterMask(stack_map_encoding_, entry.register_mask);
+    stack_map.SetRegisterMaskIndex(stack_map_encoding_, entry.register_mask_index);
     size_t number_of_stack_mask_bits = stack_map.GetNumberOfStackMaskBits(stack_map_encoding_);
     if (entry.sp_mask != nullptr) {
       for (size_t bit = 0; bit < number_of_stack_mask_bits; bit++) {
@@ -510,7 +543,7 @@ void StackMapStream::CheckCodeInfo(MemoryRegion region) const {
     // Check main stack map fields.
     DCHECK_EQ(stack_map.GetNativePcOffset(stack_map_encoding), entry.native_pc_offset);
     DCHECK_EQ(stack_map.GetDexPc(stack_map_encoding), entry.dex_pc);
-    DCHECK_EQ(stack_map.GetRegisterMask(stack_map_encoding), entry.register_mask);
+    DCHECK_EQ(code_info.GetRegisterMaskOf(encoding, stack_map), entry.register_mask);
     size_t num_stack_mask_bits = stack_map.GetNumberOfStackMaskBits(stack_map_encoding);
     if (entry.sp_mask != nullptr) {
       DCHECK_GE(num_stack_mask_bits, entry.sp_mask->GetNumberOfBits());
@@ -66,9 +66,11 @@ class StackMapStream : public ValueObject {
         location_catalog_entries_indices_(allocator->Adapter(kArenaAllocStackMapStream)),
         dex_register_locations_(allocator->Adapter(kArenaAllocStackMapStream)),
         inline_infos_(allocator->Adapter(kArenaAllocStackMapStream)),
+        register_masks_(allocator->Adapter(kArenaAllocStackMapStream)),
+        register_mask_indices_(std::less<uint32_t>(),
+                               allocator->Adapter(kArenaAllocStackMapStream)),
         stack_mask_max_(-1),
         dex_pc_max_(0),
-        register_mask_max_(0),
         number_of_stack_maps_with_inline_info_(0),
         dex_map_hash_to_stack_map_indices_(std::less<uint32_t>(),
                                            allocator->Adapter(kArenaAllocStackMapStream)),
@@ -78,7 +80,9 @@ class StackMapStream : public ValueObject {
         inline_info_size_(0),
         dex_register_maps_size_(0),
         stack_maps_size_(0),
+        register_masks_size_(0),
         dex_register_location_catalog_size_(0),
+        register_masks_start_(0),
         dex_register_location_catalog_start_(0),
         dex_register_maps_start_(0),
         inline_infos_start_(0),
@@ -97,6 +101,7 @@ class StackMapStream : public ValueObject {
     uint32_t dex_pc;
     uint32_t native_pc_offset;
     uint32_t register_mask;
+    size_t register_mask_index;
     BitVector* sp_mask;
     uint32_t num_dex_registers;
     uint8_t inlining_depth;
@@ -190,9 +195,13 @@ class StackMapStream : public ValueObject {
   // A set of concatenated maps of Dex register locations indices to `location_catalog_entries_`.
   ArenaVector<size_t> dex_register_locations_;
   ArenaVector<InlineInfoEntry> inline_infos_;
+  // Unique register masks seen so far (per method). Stack maps only encode an
+  // index into this list; the list itself is emitted after the stack maps.
+  ArenaVector<uint32_t> register_masks_;
+  // Map from register mask to its index in `register_masks_`.
+  ArenaSafeMap<uint32_t, size_t> register_mask_indices_;
   int stack_mask_max_;
   uint32_t dex_pc_max_;
-  uint32_t register_mask_max_;
   size_t number_of_stack_maps_with_inline_info_;
 
   ArenaSafeMap<uint32_t, ArenaVector<uint32_t>> dex_map_hash_to_stack_map_indices_;
@@ -205,7 +214,9 @@ class StackMapStream : public ValueObject {
   size_t inline_info_size_;
   size_t dex_register_maps_size_;
   size_t stack_maps_size_;
+  size_t register_masks_size_;
   size_t dex_register_location_catalog_size_;
+  size_t register_masks_start_;
   size_t dex_register_location_catalog_start_;
   size_t dex_register_maps_start_;
   size_t inline_infos_start_;
@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "write_barrier_elimination.h"
+
+namespace art {
+
+// Returns whether executing `instruction` can lead to a thread suspension, giving the
+// GC an opportunity to process and clear the cards dirtied so far.
+static bool CanSuspend(HInstruction* instruction) {
+  return instruction->IsSuspendCheck() ||
+         instruction->GetSideEffects().Includes(SideEffects::CanTriggerGC());
+}
+
+static void SetLeaderWriteBarrierKind(HInstruction* leader) {
+  if (leader->IsInstanceFieldSet()) {
+    HInstanceFieldSet* set = leader->AsInstanceFieldSet();
+    if (set->GetWriteBarrierKind() == WriteBarrierKind::kEmitWithNullCheck) {
+      set->SetWriteBarrierKind(WriteBarrierKind::kEmitBeingReliedOn);
+    }
+  } else {
+    HArraySet* set = leader->AsArraySet();
+    if (set->GetWriteBarrierKind() == WriteBarrierKind::kEmitWithNullCheck) {
+      set->SetWriteBarrierKind(WriteBarrierKind::kEmitBeingReliedOn);
+    }
+  }
+}
+
+void WriteBarrierElimination::Run() {
+  ArenaAllocator* arena = graph_->GetArena();
+  // Objects whose card has been dirtied by a store in the current block with no suspend
+  // point since, paired with the store whose card mark the later ones rely on. Small in
+  // practice, so a linear scan beats the constant factor of a hash container.
+  ArenaVector<std::pair<HInstruction*, HInstruction*>> dirtied(
+      arena->Adapter(kArenaAllocMisc));
+  for (HReversePostOrderIterator it(*graph_); !it.Done(); it.Advance()) {
+    HBasicBlock* block = it.Current();
+    dirtied.clear();
+    for (HInstructionIterator inst_it(block->GetInstructions()); !inst_it.Done();
+         inst_it.Advance()) {
+      HInstruction* instruction = inst_it.Current();
+      if (instruction->IsInstanceFieldSet()) {
+        HInstanceFieldSet* set = instruction->AsInstanceFieldSet();
+        if (set->GetFieldType() != Primitive::kPrimNot || set->GetValue()->IsNullConstant()) {
+          continue;  // No card mark emitted for this store.
+        }
+        HInstruction* object = set->InputAt(0);
+        bool found = false;
+        for (const auto& pair : dirtied) {
+          if (pair.first == object) {
+            SetLeaderWriteBarrierKind(pair.second);
+            set->SetWriteBarrierKind(WriteBarrierKind::kDontEmit);
+            MaybeRecordStat(MethodCompilationStat::kElidedWriteBarrier);
+            found = true;
+            break;
+          }
+        }
+        if (!found) {
+          dirtied.push_back(std::make_pair(object, instruction));
+        }
+        continue;
+      }
+      if (instruction->IsArraySet()) {
+        HArraySet* set = instruction->AsArraySet();
+        if (set->GetComponentType() == Primitive::kPrimNot && !set->GetValue()->IsNullConstant()) {
+          HInstruction* array = set->GetArray();
+          bool found = false;
+          for (const auto& pair : dirtied) {
+            if (pair.first == array) {
+              SetLeaderWriteBarrierKind(pair.second);
+              set->SetWriteBarrierKind(WriteBarrierKind::kDontEmit);
+              MaybeRecordStat(MethodCompilationStat::kElidedWriteBarrier);
+              found = true;
+              break;
+            }
+          }
+          if (!found && !set->NeedsTypeCheck()) {
+            // A store needing a type check may take a runtime path which marks the card
+            // itself, so it cannot serve as the mark later stores rely on.
+            dirtied.push_back(std::make_pair(array, instruction));
+          }
+        }
+        if (set->NeedsTypeCheck()) {
+          // Conservatively assume the runtime path can suspend.
+          dirtied.clear();
+        }
+        continue;
+      }
+      if (CanSuspend(instruction)) {
+        dirtied.clear();
+      }
+    }
+  }
+}
+
+}  // namespace art
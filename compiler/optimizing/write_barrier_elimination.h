@@ -0,0 +1,51 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_COMPILER_OPTIMIZING_WRITE_BARRIER_ELIMINATION_H_
+#define ART_COMPILER_OPTIMIZING_WRITE_BARRIER_ELIMINATION_H_
+
+#include "nodes.h"
+#include "optimization.h"
+
+namespace art {
+
+/**
+ * Optimization pass batching card dirtying for reference stores. The card mark
+ * emitted for a reference store is a function of the holding object only, and
+ * the GC can neither process nor clear cards without suspending the mutator, so
+ * when several stores into the same object happen with no suspend point in
+ * between, one card mark suffices for all of them. The first store of such a
+ * group keeps its card mark, made unconditional since the stores relying on it
+ * may not be storing null, and the later ones are marked kDontEmit. This mostly
+ * helps batch code filling object arrays and constructors initializing several
+ * reference fields.
+ */
+class WriteBarrierElimination : public HOptimization {
+ public:
+  WriteBarrierElimination(HGraph* graph, OptimizingCompilerStats* stats)
+      : HOptimization(graph, kWriteBarrierEliminationPassName, stats) {}
+
+  void Run() OVERRIDE;
+
+  static constexpr const char* kWriteBarrierEliminationPassName = "write_barrier_elimination";
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(WriteBarrierElimination);
+};
+
+}  // namespace art
+
+#endif  // ART_COMPILER_OPTIMIZING_WRITE_BARRIER_ELIMINATION_H_
@@ -175,7 +175,8 @@ class DedupeSet<InKey, StoreKey, Alloc, HashType, HashFunc, kShard>::Shard {
   Alloc alloc_;
   const std::string lock_name_;
   Mutex lock_;
-  HashSet<HashedKey<StoreKey>, ShardEmptyFn, ShardHashFn, ShardPred> keys_ GUARDED_BY(lock_);
+  HashSet<HashedKey<StoreKey>, ShardEmptyFn, ShardHashFn, ShardPred,
+      std::allocator<HashedKey<StoreKey>>, /* kStoreHashTags */ true> keys_ GUARDED_BY(lock_);
 };
 
 template <typename InKey,
@@ -34,6 +34,15 @@ namespace mips64 {
 static constexpr size_t kMips64WordSize = 4;
 static constexpr size_t kMips64DoublewordSize = 8;
 
+// SYNC instruction stype values. The architecture executes any stype the
+// implementation does not support as a full completion barrier (stype 0),
+// so the lighter forms below are always safe to emit.
+static constexpr uint32_t kSyncFull = 0x00;     // All older accesses before all younger ones.
+static constexpr uint32_t kSyncWmb = 0x04;      // Older stores before younger stores.
+static constexpr uint32_t kSyncAcquire = 0x11;  // Older loads before younger loads and stores.
+static constexpr uint32_t kSyncRelease = 0x12;  // Older loads and stores before younger stores.
+static constexpr uint32_t kSyncRmb = 0x13;      // Older loads before younger loads.
+
 enum LoadOperandType {
   kLoadSignedByte,
   kLoadUnsignedByte,
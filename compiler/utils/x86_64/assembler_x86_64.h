@@ -403,6 +403,12 @@ class X86_64Assembler FINAL : public Assembler {
   void movd(XmmRegister dst, CpuRegister src, bool is64bit);
   void movd(CpuRegister dst, XmmRegister src, bool is64bit);
 
+  void movdqu(XmmRegister dst, const Address& src);
+
+  void pcmpeqw(XmmRegister dst, XmmRegister src);
+
+  void pmovmskb(CpuRegister dst, XmmRegister src);
+
   void addss(XmmRegister dst, XmmRegister src);
   void addss(XmmRegister dst, const Address& src);
   void subss(XmmRegister dst, XmmRegister src);
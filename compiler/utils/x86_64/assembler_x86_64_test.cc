@@ -994,6 +994,21 @@ TEST_F(AssemblerX86_64Test, Movd2) {
   DriverStr(RepeatRF(&x86_64::X86_64Assembler::movd, "movd %{reg2}, %{reg1}"), "movd.2");
 }
 
+TEST_F(AssemblerX86_64Test, Movdqu) {
+  GetAssembler()->movdqu(x86_64::XmmRegister(x86_64::XMM14),
+                         x86_64::Address(x86_64::CpuRegister(x86_64::RAX), 0));
+  const char* expected = "movdqu 0(%RAX), %xmm14\n";
+  DriverStr(expected, "movdqu");
+}
+
+TEST_F(AssemblerX86_64Test, Pcmpeqw) {
+  DriverStr(RepeatFF(&x86_64::X86_64Assembler::pcmpeqw, "pcmpeqw %{reg2}, %{reg1}"), "pcmpeqw");
+}
+
+TEST_F(AssemblerX86_64Test, Pmovmskb) {
+  DriverStr(RepeatrF(&x86_64::X86_64Assembler::pmovmskb, "pmovmskb %{reg2}, %{reg1}"), "pmovmskb");
+}
+
 TEST_F(AssemblerX86_64Test, Addss) {
   DriverStr(RepeatFF(&x86_64::X86_64Assembler::addss, "addss %{reg2}, %{reg1}"), "addss");
 }
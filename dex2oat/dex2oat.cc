@@ -44,6 +44,7 @@
 #include "base/timing_logger.h"
 #include "base/unix_file/fd_file.h"
 #include "class_linker.h"
+#include "compiled_class.h"
 #include "compiler.h"
 #include "compiler_callbacks.h"
 #include "debug/elf_debug_writer.h"
@@ -76,6 +77,7 @@
 #include "ScopedLocalRef.h"
 #include "scoped_thread_state_change.h"
 #include "utils.h"
+#include "verifier/verification_cache.h"
 #include "well_known_classes.h"
 #include "zip_archive.h"
 
@@ -212,6 +214,12 @@ NO_RETURN static void Usage(const char* fmt, ...) {
   UsageError("  --oat-symbols=<file.oat>: specifies an oat output destination with full symbols.");
   UsageError("      Example: --oat-symbols=/symbols/system/framework/boot.oat");
   UsageError("");
+  UsageError("  --incremental-from=<file.oat>: specifies a previously compiled oat file. If the");
+  UsageError("      input dex files, boot image and compiler configuration are unchanged with");
+  UsageError("      respect to that file, its contents are reused instead of recompiling.");
+  UsageError("      Only supported when compiling an app to a single oat file.");
+  UsageError("      Example: --incremental-from=/data/app/Calculator/oat/arm/base.odex");
+  UsageError("");
   UsageError("  --image=<file.art>: specifies an output image filename.");
   UsageError("      Example: --image=/system/framework/boot.art");
   UsageError("");
@@ -223,6 +231,11 @@ NO_RETURN static void Usage(const char* fmt, ...) {
   UsageError("  --image-classes=<classname-file>: specifies classes to include in an image.");
   UsageError("      Example: --image=frameworks/base/preloaded-classes");
   UsageError("");
+  UsageError("  --dirty-image-classes=<classname-file>: specifies classes known to dirty their");
+  UsageError("      image pages at runtime, e.g. as reported by imgdiag, so the image writer can");
+  UsageError("      pack them together.");
+  UsageError("      Example: --dirty-image-classes=dirty-classes.txt");
+  UsageError("");
   UsageError("  --base=<hex-address>: specifies the base address when creating a boot image.");
   UsageError("      Example: --base=0x50000000");
   UsageError("");
@@ -267,7 +280,7 @@ NO_RETURN static void Usage(const char* fmt, ...) {
                 "|everything-profile"
                 "|everything):");
   UsageError("      select compiler filter.");
-  UsageError("      verify-profile requires a --profile(-fd) to also be passed in.");
+  UsageError("      the *-profile filters require a --profile(-fd) to also be passed in.");
   UsageError("      Example: --compiler-filter=everything");
   UsageError("      Default: speed");
   UsageError("");
@@ -315,6 +328,10 @@ NO_RETURN static void Usage(const char* fmt, ...) {
   UsageError("");
   UsageError("  --dump-timing: display a breakdown of where time was spent");
   UsageError("");
+  UsageError("  --dump-pass-timings=<file.txt>: write aggregated per-pass compile times and the");
+  UsageError("      methods the optimizing compiler spent the most time on to the given file.");
+  UsageError("      Example: --dump-pass-timings=pass-timings.txt");
+  UsageError("");
   UsageError("  --include-patch-information: Include patching information so the generated code");
   UsageError("      can have its base address moved without full recompilation.");
   UsageError("");
@@ -512,11 +529,13 @@ class Dex2Oat FINAL {
       image_base_(0U),
       image_classes_zip_filename_(nullptr),
       image_classes_filename_(nullptr),
+      dirty_image_classes_filename_(nullptr),
       image_storage_mode_(ImageHeader::kStorageModeUncompressed),
       compiled_classes_zip_filename_(nullptr),
       compiled_classes_filename_(nullptr),
       compiled_methods_zip_filename_(nullptr),
       compiled_methods_filename_(nullptr),
+      incremental_from_filename_(nullptr),
       app_image_(false),
       boot_image_(false),
       multi_image_(false),
@@ -760,6 +779,10 @@ class Dex2Oat FINAL {
       Usage("--compiled-classes-zip should be used with --compiled-classes");
     }
 
+    if (incremental_from_filename_ != nullptr && IsImage()) {
+      Usage("--incremental-from should not be used when compiling an image");
+    }
+
     if (dex_filenames_.empty() && zip_fd_ == -1) {
       Usage("Input must be supplied with either --dex-file or --zip-fd");
     }
@@ -802,6 +825,15 @@ class Dex2Oat FINAL {
       Usage("Profile file should not be specified with both --profile-file-fd and --profile-file");
     }
 
+    // Without a profile every method looks cold, so a profile guided compilation
+    // would silently compile nothing at all. Reject the combination up front.
+    if (CompilerFilter::DependsOnProfile(compiler_options_->GetCompilerFilter()) &&
+        !have_profile_file && !have_profile_fd) {
+      Usage("Profile guided compilation (--compiler-filter=%s) requires a profile "
+            "specified with --profile-file or --profile-file-fd",
+            CompilerFilter::NameOfFilter(compiler_options_->GetCompilerFilter()).c_str());
+    }
+
     if (!parser_options->oat_symbols.empty()) {
       oat_unstripped_ = std::move(parser_options->oat_symbols);
     }
@@ -853,6 +885,9 @@ class Dex2Oat FINAL {
       case kArm:
       case kThumb2:
       case kArm64:
+        // Only the ARM fault handlers recognize the implicit suspend check poll.
+        compiler_options_->implicit_suspend_checks_ = true;
+        FALLTHROUGH_INTENDED;
       case kX86:
       case kX86_64:
       case kMips:
@@ -1090,6 +1125,8 @@ class Dex2Oat FINAL {
         image_classes_filename_ = option.substr(strlen("--image-classes=")).data();
       } else if (option.starts_with("--image-classes-zip=")) {
         image_classes_zip_filename_ = option.substr(strlen("--image-classes-zip=")).data();
+      } else if (option.starts_with("--dirty-image-classes=")) {
+        dirty_image_classes_filename_ = option.substr(strlen("--dirty-image-classes=")).data();
       } else if (option.starts_with("--image-format=")) {
         ParseImageFormat(option);
       } else if (option.starts_with("--compiled-classes=")) {
@@ -1100,6 +1137,8 @@ class Dex2Oat FINAL {
         compiled_methods_filename_ = option.substr(strlen("--compiled-methods=")).data();
       } else if (option.starts_with("--compiled-methods-zip=")) {
         compiled_methods_zip_filename_ = option.substr(strlen("--compiled-methods-zip=")).data();
+      } else if (option.starts_with("--incremental-from=")) {
+        incremental_from_filename_ = option.substr(strlen("--incremental-from=")).data();
       } else if (option.starts_with("--base=")) {
         ParseBase(option);
       } else if (option.starts_with("--boot-image=")) {
@@ -1485,6 +1524,8 @@ class Dex2Oat FINAL {
     TimingLogger::ScopedTiming t("dex2oat Compile", timings_);
     compiler_phases_timings_.reset(new CumulativeLogger("compilation times"));
 
+    LoadCachedVerificationResults();
+
     // Find the dex files we should not inline from.
 
     std::vector<std::string> no_inline_filters;
@@ -1550,7 +1591,11 @@ class Dex2Oat FINAL {
                                      swap_fd_,
                                      profile_compilation_info_.get()));
     driver_->SetDexFilesForOatFile(dex_files_);
+    if (cached_verification_results_ != nullptr) {
+      driver_->SetCachedVerificationResults(cached_verification_results_.get());
+    }
     driver_->CompileAll(class_loader_, dex_files_, timings_);
+    SaveVerificationResults();
   }
 
   // Notes on the interleaving of creating the images and oat files to
@@ -1654,7 +1699,8 @@ class Dex2Oat FINAL {
                                           IsAppImage(),
                                           image_storage_mode_,
                                           oat_filenames_,
-                                          dex_file_oat_index_map_));
+                                          dex_file_oat_index_map_,
+                                          dirty_image_classes_.get()));
 
       // We need to prepare method offsets in the image address space for direct method patching.
       TimingLogger::ScopedTiming t2("dex2oat Prepare image address space", timings_);
@@ -1806,6 +1852,104 @@ class Dex2Oat FINAL {
     return true;
   }
 
+  // Returns true if --incremental-from was given and that oat file can be reused as-is: same
+  // instruction set and features, same compiler filter, same boot image, and exactly the same
+  // dex files. Requires Setup() to have run so that the opened dex files and the boot image
+  // checksum are available. Reuse is whole-file: once linked, the relative and image-absolute
+  // patches in compiled code cannot be recovered per method, so a single changed dex file means
+  // a full recompile.
+  bool MayReuseOatFile() {
+    if (incremental_from_filename_ == nullptr) {
+      return false;
+    }
+    DCHECK(!IsImage());
+    TimingLogger::ScopedTiming t("dex2oat IncrementalCheck", timings_);
+    if (oat_files_.size() != 1u) {
+      LOG(WARNING) << "Ignoring --incremental-from: compiling more than one oat file.";
+      return false;
+    }
+    std::string error_msg;
+    std::unique_ptr<OatFile> previous(OatFile::Open(incremental_from_filename_,
+                                                    incremental_from_filename_,
+                                                    nullptr,
+                                                    nullptr,
+                                                    /* executable */ false,
+                                                    /* low_4gb */ false,
+                                                    /* abs_dex_location */ nullptr,
+                                                    &error_msg));
+    if (previous == nullptr) {
+      LOG(WARNING) << "Ignoring --incremental-from: " << error_msg;
+      return false;
+    }
+    const OatHeader& previous_header = previous->GetOatHeader();
+    if (previous_header.GetInstructionSet() != instruction_set_ ||
+        previous_header.GetInstructionSetFeaturesBitmap() !=
+            instruction_set_features_->AsBitmap()) {
+      VLOG(compiler) << "Not reusing " << incremental_from_filename_
+                     << ": instruction set changed";
+      return false;
+    }
+    if (previous->GetCompilerFilter() != compiler_options_->GetCompilerFilter()) {
+      VLOG(compiler) << "Not reusing " << incremental_from_filename_
+                     << ": compiler filter changed";
+      return false;
+    }
+    if (previous_header.GetImageFileLocationOatChecksum() != image_file_location_oat_checksum_ ||
+        previous_header.GetImageFileLocationOatDataBegin() !=
+            static_cast<uint32_t>(image_file_location_oat_data_begin_) ||
+        previous_header.GetImagePatchDelta() != image_patch_delta_) {
+      VLOG(compiler) << "Not reusing " << incremental_from_filename_ << ": boot image changed";
+      return false;
+    }
+    if (previous->GetOatDexFiles().size() != dex_files_.size()) {
+      VLOG(compiler) << "Not reusing " << incremental_from_filename_
+                     << ": number of dex files changed";
+      return false;
+    }
+    for (const DexFile* dex_file : dex_files_) {
+      const uint32_t checksum = dex_file->GetLocationChecksum();
+      if (previous->GetOatDexFile(dex_file->GetLocation().c_str(),
+                                  &checksum,
+                                  /* exception_if_not_found */ false) == nullptr) {
+        VLOG(compiler) << "Not reusing " << incremental_from_filename_ << ": dex file "
+                       << dex_file->GetLocation() << " changed";
+        return false;
+      }
+    }
+    LOG(INFO) << "Reusing compiled code from " << incremental_from_filename_;
+    return true;
+  }
+
+  // Replaces the output oat file with a copy of the previous oat file. The dex files that
+  // Setup() already wrote to the output are discarded; the previous file carries identical
+  // copies of them. Only called when MayReuseOatFile() returned true.
+  bool ReuseOatFile() {
+    TimingLogger::ScopedTiming t("dex2oat IncrementalCopy", timings_);
+    DCHECK_EQ(oat_files_.size(), 1u);
+    // Setup() already wrote dex file data through the ELF writer's (possibly asynchronous)
+    // stream; make sure none of it lands after the copy below.
+    elf_writers_[0]->GetStream()->Flush();
+    std::unique_ptr<File> in(OS::OpenFileForReading(incremental_from_filename_));
+    if (in == nullptr) {
+      PLOG(ERROR) << "Failed to reopen oat file: " << incremental_from_filename_;
+      return false;
+    }
+    int64_t in_length = in->GetLength();
+    if (in_length < 0) {
+      PLOG(ERROR) << "Failed to get length of oat file: " << incremental_from_filename_;
+      return false;
+    }
+    File* out = oat_files_[0].get();
+    if (out->SetLength(0) != 0 ||
+        lseek(out->Fd(), 0, SEEK_SET) != 0 ||
+        !out->Copy(in.get(), 0, in_length)) {
+      PLOG(ERROR) << "Failed to copy oat file: " << incremental_from_filename_;
+      return false;
+    }
+    VLOG(compiler) << "Oat file reused successfully: " << out->GetPath();
+    return true;
+  }
+
   bool FlushOatFiles() {
     TimingLogger::ScopedTiming t2("dex2oat Flush ELF", timings_);
     for (size_t i = 0; i < oat_files_.size(); ++i) {
@@ -1843,7 +1987,7 @@ class Dex2Oat FINAL {
     if (dump_timing_ || (dump_slow_timing_ && timings_->GetTotalNs() > MsToNs(1000))) {
       LOG(INFO) << Dumpable<TimingLogger>(*timings_);
     }
-    if (dump_passes_) {
+    if (dump_passes_ && driver_ != nullptr) {
       LOG(INFO) << Dumpable<CumulativeLogger>(*driver_->GetTimingsLogger());
     }
   }
@@ -1913,6 +2057,80 @@ class Dex2Oat FINAL {
     return result;
   }
 
+  // The verification cache lives next to the oat file, mirroring how the runtime keeps its
+  // cache next to the profile. Returns an empty string if no usable location is known.
+  std::string GetVerificationCacheFileName() const {
+    if (!oat_location_.empty()) {
+      return oat_location_ + verifier::VerificationCache::kFileSuffix;
+    }
+    if (!oat_filenames_.empty()) {
+      return std::string(oat_filenames_[0]) + verifier::VerificationCache::kFileSuffix;
+    }
+    return "";
+  }
+
+  // Tries to reuse class verification results recorded by a previous compilation of the
+  // same dex files, e.g. when a compiler filter change or an A/B OTA triggers a recompile.
+  // Compiled code depends on fresh per-method VerifiedMethod data which is not part of the
+  // cache, so only filters that do not AOT compile bytecode can use it.
+  void LoadCachedVerificationResults() {
+    CompilerFilter::Filter filter = compiler_options_->GetCompilerFilter();
+    if (IsBootImage() ||
+        !CompilerFilter::IsVerificationEnabled(filter) ||
+        CompilerFilter::IsBytecodeCompilationEnabled(filter)) {
+      return;
+    }
+    std::string cache_filename = GetVerificationCacheFileName();
+    if (cache_filename.empty() || !OS::FileExists(cache_filename.c_str())) {
+      return;
+    }
+    std::unique_ptr<verifier::VerificationCache> cache(
+        new verifier::VerificationCache(cache_filename));
+    cache->Load();
+    if (cache->GetBootImageChecksum() != image_file_location_oat_checksum_) {
+      VLOG(compiler) << "Ignoring verification cache " << cache_filename
+                     << " recorded against a different boot image";
+      return;
+    }
+    size_t verified_classes = cache->GetNumberOfVerifiedClasses();
+    if (verified_classes == 0u) {
+      return;
+    }
+    VLOG(compiler) << "Reusing verification results for " << verified_classes
+                   << " classes from " << cache_filename;
+    cached_verification_results_ = std::move(cache);
+  }
+
+  // Records which classes verified so that future compilations of the same dex files do not
+  // have to re-verify them.
+  void SaveVerificationResults() {
+    CompilerFilter::Filter filter = compiler_options_->GetCompilerFilter();
+    if (IsBootImage() || !CompilerFilter::IsVerificationEnabled(filter)) {
+      // Without verification there are no results to record; --verify-none class statuses
+      // do not come from the verifier and must not poison the cache.
+      return;
+    }
+    std::string cache_filename = GetVerificationCacheFileName();
+    if (cache_filename.empty()) {
+      return;
+    }
+    verifier::VerificationCache cache(cache_filename);
+    cache.SetBootImageChecksum(image_file_location_oat_checksum_);
+    for (const DexFile* dex_file : dex_files_) {
+      for (size_t i = 0; i != dex_file->NumClassDefs(); ++i) {
+        ClassReference ref(dex_file, i);
+        CompiledClass* compiled_class = driver_->GetCompiledClass(ref);
+        if (compiled_class != nullptr &&
+            compiled_class->GetStatus() >= mirror::Class::kStatusVerified) {
+          cache.AddVerifiedClass(*dex_file, static_cast<uint16_t>(i));
+        }
+      }
+    }
+    if (cache.GetNumberOfVerifiedClasses() != 0u) {
+      cache.Save();
+    }
+  }
+
   std::string GetMultiImageBootClassPath() {
     DCHECK(IsBootImage());
     DCHECK_GT(oat_filenames_.size(), 1u);
@@ -2023,6 +2241,16 @@ class Dex2Oat FINAL {
     } else if (IsBootImage()) {
       image_classes_.reset(new std::unordered_set<std::string>);
     }
+    // If an imgdiag dirty class report was specified, read it so the image writer can pack the
+    // listed classes into their own bin.
+    if (dirty_image_classes_filename_ != nullptr) {
+      dirty_image_classes_.reset(ReadImageClassesFromFile(dirty_image_classes_filename_));
+      if (dirty_image_classes_ == nullptr) {
+        LOG(ERROR) << "Failed to create list of dirty classes from '"
+                   << dirty_image_classes_filename_ << "'";
+        return false;
+      }
+    }
     return true;
   }
 
@@ -2452,12 +2680,15 @@ class Dex2Oat FINAL {
   uintptr_t image_base_;
   const char* image_classes_zip_filename_;
   const char* image_classes_filename_;
+  const char* dirty_image_classes_filename_;
   ImageHeader::StorageMode image_storage_mode_;
   const char* compiled_classes_zip_filename_;
   const char* compiled_classes_filename_;
   const char* compiled_methods_zip_filename_;
   const char* compiled_methods_filename_;
+  const char* incremental_from_filename_;
   std::unique_ptr<std::unordered_set<std::string>> image_classes_;
+  std::unique_ptr<std::unordered_set<std::string>> dirty_image_classes_;
   std::unique_ptr<std::unordered_set<std::string>> compiled_classes_;
   std::unique_ptr<std::unordered_set<std::string>> compiled_methods_;
   bool app_image_;
@@ -2495,6 +2726,7 @@ class Dex2Oat FINAL {
   std::string profile_file_;
   int profile_file_fd_;
   std::unique_ptr<ProfileCompilationInfo> profile_compilation_info_;
+  std::unique_ptr<verifier::VerificationCache> cached_verification_results_;
   TimingLogger* timings_;
   std::unique_ptr<CumulativeLogger> compiler_phases_timings_;
   std::vector<std::vector<const DexFile*>> dex_files_per_oat_file_;
@@ -2574,6 +2806,39 @@ static int CompileImage(Dex2Oat& dex2oat) {
   return EXIT_SUCCESS;
 }
 
+// Copy an unchanged previous oat file through instead of compiling. Mirrors CompileApp from
+// the write step on; only entered when Dex2Oat::MayReuseOatFile() has validated the reuse.
+static int ReuseApp(Dex2Oat& dex2oat) {
+  if (!dex2oat.ReuseOatFile()) {
+    dex2oat.EraseOatFiles();
+    return EXIT_FAILURE;
+  }
+
+  // When given --host, finish early without stripping.
+  if (dex2oat.IsHost()) {
+    if (!dex2oat.FlushCloseOatFiles()) {
+      return EXIT_FAILURE;
+    }
+
+    dex2oat.DumpTiming();
+    return EXIT_SUCCESS;
+  }
+
+  // Copy stripped to unstripped location, if necessary. This will implicitly flush & close the
+  // stripped versions. If this is given, we expect to be able to open writable files by name.
+  if (!dex2oat.CopyStrippedToUnstripped()) {
+    return EXIT_FAILURE;
+  }
+
+  // Flush and close the files.
+  if (!dex2oat.FlushCloseOatFiles()) {
+    return EXIT_FAILURE;
+  }
+
+  dex2oat.DumpTiming();
+  return EXIT_SUCCESS;
+}
+
 static int CompileApp(Dex2Oat& dex2oat) {
   dex2oat.Compile();
 
@@ -2658,6 +2923,8 @@ static int dex2oat(int argc, char** argv) {
   bool result;
   if (dex2oat->IsImage()) {
     result = CompileImage(*dex2oat);
+  } else if (dex2oat->MayReuseOatFile()) {
+    result = ReuseApp(*dex2oat);
   } else {
     result = CompileApp(*dex2oat);
   }
@@ -44,6 +44,7 @@
 
 #include "dex_file-inl.h"
 #include "dex_instruction-inl.h"
+#include "utf.h"
 #include "utils.h"
 
 namespace art {
@@ -186,6 +187,23 @@ static char* descriptorClassToDot(const char* str) {
   return newStr;
 }
 
+/*
+ * Returns the type descriptor for a class name given in either dotted or
+ * descriptor form, i.e. both "java.lang.String" and "Ljava/lang/String;"
+ * yield "Ljava/lang/String;".
+ */
+static std::string dotNameToDescriptor(const char* str) {
+  if (str[0] == 'L' && str[strlen(str) - 1] == ';') {
+    return str;
+  }
+  std::string descriptor(1, 'L');
+  for (const char* cp = str; *cp != '\0'; cp++) {
+    descriptor += (*cp == '.') ? '/' : *cp;
+  }
+  descriptor += ';';
+  return descriptor;
+}
+
 /*
  * Returns a quoted string representing the boolean value.
  */
@@ -1432,13 +1450,30 @@ static void processDexFile(const char* fileName, const DexFile* pDexFile) {
 
   // Iterate over all classes.
   char* package = nullptr;
-  const u4 classDefsSize = pDexFile->GetHeader().class_defs_size_;
-  for (u4 i = 0; i < classDefsSize; i++) {
-    if (gOptions.showSectionHeaders) {
-      dumpClassDef(pDexFile, i);
+  if (gOptions.classToFind != nullptr) {
+    // A single-class query goes through FindClassDef, which consults the
+    // type lookup table instead of scanning every class definition.
+    const std::string descriptor = dotNameToDescriptor(gOptions.classToFind);
+    const DexFile::ClassDef* pClassDef =
+        pDexFile->FindClassDef(descriptor.c_str(), ComputeModifiedUtf8Hash(descriptor.c_str()));
+    if (pClassDef != nullptr) {
+      const u4 i = pDexFile->GetIndexForClassDef(*pClassDef);
+      if (gOptions.showSectionHeaders) {
+        dumpClassDef(pDexFile, i);
+      }
+      dumpClass(pDexFile, i, &package);
+    } else if (gOptions.verbose) {
+      fprintf(gOutFile, "Class '%s' not found in '%s'\n", gOptions.classToFind, fileName);
     }
-    dumpClass(pDexFile, i, &package);
-  }  // for
+  } else {
+    const u4 classDefsSize = pDexFile->GetHeader().class_defs_size_;
+    for (u4 i = 0; i < classDefsSize; i++) {
+      if (gOptions.showSectionHeaders) {
+        dumpClassDef(pDexFile, i);
+      }
+      dumpClass(pDexFile, i, &package);
+    }  // for
+  }
 
   // Free the last package allocated.
   if (package != nullptr) {
@@ -47,6 +47,8 @@ struct Options {
   bool verbose;
   bool cfg;
   OutputFormat outputFormat;
+  const char* batchFileName;
+  const char* classToFind;
   const char* outputFileName;
   const char* tempFileName;
 };
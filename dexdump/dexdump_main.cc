@@ -24,6 +24,7 @@
 
 #include "dexdump.h"
 
+#include <limits.h>
 #include <stdio.h>
 #include <string.h>
 #include <unistd.h>
@@ -40,9 +41,10 @@ static const char* gProgName = "dexdump";
  */
 static void usage(void) {
   fprintf(stderr, "Copyright (C) 2007 The Android Open Source Project\n\n");
-  fprintf(stderr, "%s: [-c] [-d] [-e] [-f] [-h] [-i] [-l layout] [-o outfile]"
-                  " [-t tempfile] dexfile...\n", gProgName);
+  fprintf(stderr, "%s: [-b batchfile] [-c] [-d] [-e] [-f] [-h] [-i] [-k class]"
+                  " [-l layout] [-o outfile] [-t tempfile] dexfile...\n", gProgName);
   fprintf(stderr, "\n");
+  fprintf(stderr, " -b : process all dex files listed in batchfile, one path per line\n");
   fprintf(stderr, " -c : verify checksum and exit\n");
   fprintf(stderr, " -d : disassemble code sections\n");
   fprintf(stderr, " -e : display exported items only\n");
@@ -50,11 +52,37 @@ static void usage(void) {
   fprintf(stderr, " -g : dump CFG for dex\n");
   fprintf(stderr, " -h : display file header details\n");
   fprintf(stderr, " -i : ignore checksum failures\n");
+  fprintf(stderr, " -k : dump only the class with the given name or type descriptor\n");
   fprintf(stderr, " -l : output layout, either 'plain' or 'xml'\n");
   fprintf(stderr, " -o : output file name (defaults to stdout)\n");
   fprintf(stderr, " -t : temp file name (defaults to /sdcard/dex-temp-*)\n");
 }
 
+/*
+ * Processes all files listed in the given batch file, one path per line.
+ * Empty lines and lines starting with '#' are skipped. A single invocation
+ * amortizes the runtime set up over the whole list, which matters when
+ * disassembling thousands of dex files.
+ */
+static int processBatchFile(const char* fileName) {
+  FILE* batchFp = fopen(fileName, "r");
+  if (batchFp == nullptr) {
+    fprintf(stderr, "%s: can't open batch file '%s'\n", gProgName, fileName);
+    return -1;
+  }
+  int result = 0;
+  char line[PATH_MAX + 2];
+  while (fgets(line, sizeof(line), batchFp) != nullptr) {
+    line[strcspn(line, "\r\n")] = '\0';
+    if (line[0] == '\0' || line[0] == '#') {
+      continue;
+    }
+    result |= processFile(line);
+  }  // while
+  fclose(batchFp);
+  return result;
+}
+
 /*
  * Main driver of the dexdump utility.
  */
@@ -70,11 +98,14 @@ int dexdumpDriver(int argc, char** argv) {
 
   // Parse all arguments.
   while (1) {
-    const int ic = getopt(argc, argv, "cdefghil:t:o:");
+    const int ic = getopt(argc, argv, "b:cdefghik:l:t:o:");
     if (ic < 0) {
       break;  // done
     }
     switch (ic) {
+      case 'b':  // batch file with one input file per line
+        gOptions.batchFileName = optarg;
+        break;
       case 'c':  // verify the checksum then exit
         gOptions.checksumOnly = true;
         break;
@@ -96,6 +127,9 @@ int dexdumpDriver(int argc, char** argv) {
       case 'i':  // continue even if checksum is bad
         gOptions.ignoreBadChecksum = true;
         break;
+      case 'k':  // dump a single class
+        gOptions.classToFind = optarg;
+        break;
       case 'l':  // layout
         if (strcmp(optarg, "plain") == 0) {
           gOptions.outputFormat = OUTPUT_PLAIN;
@@ -119,7 +153,7 @@ int dexdumpDriver(int argc, char** argv) {
   }  // while
 
   // Detect early problems.
-  if (optind == argc) {
+  if (optind == argc && gOptions.batchFileName == nullptr) {
     fprintf(stderr, "%s: no file specified\n", gProgName);
     wantUsage = true;
   }
@@ -141,11 +175,14 @@ int dexdumpDriver(int argc, char** argv) {
     }
   }
 
-  // Process all files supplied on command line.
+  // Process all files supplied on command line, then the batch file if any.
   int result = 0;
   while (optind < argc) {
     result |= processFile(argv[optind++]);
   }  // while
+  if (gOptions.batchFileName != nullptr) {
+    result |= processBatchFile(gOptions.batchFileName);
+  }
   return result != 0;
 }
 
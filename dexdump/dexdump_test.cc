@@ -22,6 +22,7 @@
 #include <unistd.h>
 
 #include "base/stringprintf.h"
+#include "base/unix_file/fd_file.h"
 #include "common_runtime_test.h"
 #include "runtime/arch/instruction_set.h"
 #include "runtime/gc/heap.h"
@@ -81,4 +82,24 @@ TEST_F(DexDumpTest, XMLOutput) {
     dex_file_}, &error_msg)) << error_msg;
 }
 
+TEST_F(DexDumpTest, SingleClassOutput) {
+  std::string error_msg;
+  ASSERT_TRUE(Exec({"-d", "-k", "java.lang.Object", "-o", "/dev/null",
+    dex_file_}, &error_msg)) << error_msg;
+}
+
+TEST_F(DexDumpTest, BatchFileInput) {
+  ScratchFile batch;
+  const std::string line = dex_file_ + "\n";
+  ASSERT_TRUE(batch.GetFile()->WriteFully(line.c_str(), line.size()));
+  std::string error_msg;
+  ASSERT_TRUE(Exec({"-b", batch.GetFilename(), "-o", "/dev/null"},
+    &error_msg)) << error_msg;
+}
+
+TEST_F(DexDumpTest, CantOpenBatchFile) {
+  std::string error_msg;
+  ASSERT_FALSE(Exec({"-b", "/joho", "-o", "/dev/null"}, &error_msg)) << error_msg;
+}
+
 }  // namespace art
@@ -0,0 +1,393 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Implementation file of the dexlayout utility.
+ *
+ * The tool permutes the code_items section of a DEX file so that the code
+ * of methods recorded in a profile comes first, then re-encodes the
+ * class_data_items (whose ULEB128 code offsets change size) at the end of
+ * the file and patches the class_defs, map list, header and checksum.
+ * Everything else stays at its original offset, so no other references
+ * need fixing up. The rewritten file is re-verified with DexFileVerifier
+ * before it is written out.
+ */
+
+#include "dexlayout.h"
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <zlib.h>
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/bit_utils.h"
+#include "base/casts.h"
+#include "base/logging.h"
+#include "base/stringprintf.h"
+#include "base/unix_file/fd_file.h"
+#include "dex_file-inl.h"
+#include "jit/offline_profiling_info.h"
+#include "leb128.h"
+#include "method_reference.h"
+#include "os.h"
+#include "safe_map.h"
+
+namespace art {
+
+struct Options gOptions;
+
+// Extent and profile classification of a single code_item.
+struct CodeItemExtent {
+  uint32_t size;
+  bool hot;
+};
+
+// A mutable mirror of DexFile::MapItem (which is not copyable).
+struct RawMapItem {
+  uint16_t type;
+  uint16_t unused;
+  uint32_t size;
+  uint32_t offset;
+};
+static_assert(sizeof(RawMapItem) == sizeof(DexFile::MapItem), "MapItem size mismatch");
+
+/*
+ * Computes the exact byte size of a code_item, including the try items
+ * and the ULEB128-encoded catch handler list.
+ */
+static uint32_t CodeItemSize(const DexFile::CodeItem& code_item) {
+  const uint8_t* start = reinterpret_cast<const uint8_t*>(&code_item);
+  if (code_item.tries_size_ == 0) {
+    const uint8_t* insns_end =
+        reinterpret_cast<const uint8_t*>(&code_item.insns_[code_item.insns_size_in_code_units_]);
+    return insns_end - start;
+  }
+  const uint8_t* handler_data = DexFile::GetCatchHandlerData(code_item, 0u);
+  const uint32_t handlers_size = DecodeUnsignedLeb128(&handler_data);
+  for (uint32_t i = 0; i < handlers_size; ++i) {
+    const int32_t size = DecodeSignedLeb128(&handler_data);
+    const int32_t pair_count = (size < 0) ? -size : size;
+    for (int32_t j = 0; j < pair_count; ++j) {
+      DecodeUnsignedLeb128(&handler_data);  // type_idx
+      DecodeUnsignedLeb128(&handler_data);  // addr
+    }
+    if (size <= 0) {
+      DecodeUnsignedLeb128(&handler_data);  // catch_all_addr
+    }
+  }
+  return handler_data - start;
+}
+
+static const DexFile::MapItem* FindMapItem(const DexFile& dex_file, uint16_t type) {
+  const DexFile::MapList* map_list = reinterpret_cast<const DexFile::MapList*>(
+      dex_file.Begin() + dex_file.GetHeader().map_off_);
+  for (uint32_t i = 0; i < map_list->size_; ++i) {
+    if (map_list->list_[i].type_ == type) {
+      return &map_list->list_[i];
+    }
+  }
+  return nullptr;
+}
+
+/*
+ * Re-encodes one class_data_item with relocated code item offsets. Indices
+ * and access flags are unchanged, so only the code_off ULEB128 encodings
+ * (and therefore the item size) may differ from the original.
+ */
+static void EncodeClassData(const DexFile& dex_file,
+                            const uint8_t* class_data,
+                            const SafeMap<uint32_t, uint32_t>& new_code_offsets,
+                            std::vector<uint8_t>* out) {
+  ClassDataItemIterator it(dex_file, class_data);
+  EncodeUnsignedLeb128(out, it.NumStaticFields());
+  EncodeUnsignedLeb128(out, it.NumInstanceFields());
+  EncodeUnsignedLeb128(out, it.NumDirectMethods());
+  EncodeUnsignedLeb128(out, it.NumVirtualMethods());
+  uint32_t prev_idx = 0;
+  for (; it.HasNextStaticField(); it.Next()) {
+    EncodeUnsignedLeb128(out, it.GetMemberIndex() - prev_idx);
+    EncodeUnsignedLeb128(out, it.GetRawMemberAccessFlags());
+    prev_idx = it.GetMemberIndex();
+  }
+  prev_idx = 0;
+  for (; it.HasNextInstanceField(); it.Next()) {
+    EncodeUnsignedLeb128(out, it.GetMemberIndex() - prev_idx);
+    EncodeUnsignedLeb128(out, it.GetRawMemberAccessFlags());
+    prev_idx = it.GetMemberIndex();
+  }
+  prev_idx = 0;
+  for (; it.HasNextDirectMethod(); it.Next()) {
+    const uint32_t code_off = it.GetMethodCodeItemOffset();
+    EncodeUnsignedLeb128(out, it.GetMemberIndex() - prev_idx);
+    EncodeUnsignedLeb128(out, it.GetRawMemberAccessFlags());
+    EncodeUnsignedLeb128(out, (code_off == 0u) ? 0u : new_code_offsets.Get(code_off));
+    prev_idx = it.GetMemberIndex();
+  }
+  prev_idx = 0;
+  for (; it.HasNextVirtualMethod(); it.Next()) {
+    const uint32_t code_off = it.GetMethodCodeItemOffset();
+    EncodeUnsignedLeb128(out, it.GetMemberIndex() - prev_idx);
+    EncodeUnsignedLeb128(out, it.GetRawMemberAccessFlags());
+    EncodeUnsignedLeb128(out, (code_off == 0u) ? 0u : new_code_offsets.Get(code_off));
+    prev_idx = it.GetMemberIndex();
+  }
+}
+
+/*
+ * Rewrites dex_file into *out with profile-hot code items first. Returns
+ * false only on malformed input; inputs that cannot be safely reordered
+ * are copied through unchanged.
+ */
+static bool LayoutDexFile(const DexFile& dex_file,
+                          const ProfileCompilationInfo* profile_info,
+                          std::vector<uint8_t>* out) {
+  const DexFile::Header& header = dex_file.GetHeader();
+  out->assign(dex_file.Begin(), dex_file.Begin() + dex_file.Size());
+
+  const DexFile::MapItem* code_item_map = FindMapItem(dex_file, DexFile::kDexTypeCodeItem);
+  const DexFile::MapItem* class_data_map = FindMapItem(dex_file, DexFile::kDexTypeClassDataItem);
+  if (code_item_map == nullptr || class_data_map == nullptr || code_item_map->size_ == 0u) {
+    return true;  // No code to reorder.
+  }
+
+  // Collect the extent of every code item reachable from a class_data_item
+  // and mark the ones whose method is present in the profile as hot.
+  std::map<uint32_t, CodeItemExtent> code_items;  // Keyed by offset, i.e. original order.
+  size_t hot_count = 0;
+  for (uint32_t i = 0; i < dex_file.NumClassDefs(); ++i) {
+    const uint8_t* class_data = dex_file.GetClassData(dex_file.GetClassDef(i));
+    if (class_data == nullptr) {
+      continue;
+    }
+    ClassDataItemIterator it(dex_file, class_data);
+    while (it.HasNextStaticField() || it.HasNextInstanceField()) {
+      it.Next();
+    }
+    for (; it.HasNext(); it.Next()) {
+      const uint32_t code_off = it.GetMethodCodeItemOffset();
+      if (code_off == 0u) {
+        continue;
+      }
+      const bool hot = profile_info != nullptr &&
+          profile_info->ContainsMethod(MethodReference(&dex_file, it.GetMemberIndex()));
+      auto result = code_items.emplace(
+          code_off, CodeItemExtent { CodeItemSize(*dex_file.GetCodeItem(code_off)), hot });
+      if (hot && (result.second || !result.first->second.hot)) {
+        result.first->second.hot = true;
+        ++hot_count;
+      }
+    }
+  }
+  if (code_items.size() != code_item_map->size_) {
+    // Some code items are not reachable from any class_data_item. We cannot
+    // relocate what we cannot see, so leave the file in its original layout.
+    LOG(WARNING) << dex_file.GetLocation() << ": " << code_item_map->size_ - code_items.size()
+                 << " unreferenced code items, not reordering";
+    return true;
+  }
+  if (hot_count == 0u || hot_count == code_items.size()) {
+    return true;  // Reordering would be the identity (or there is no profile data).
+  }
+
+  // Lay the code items out again in the same section: hot ones first, each
+  // group in its original relative order. Sizes and alignment match the
+  // original layout, so the permuted section can never outgrow the old one.
+  const uint32_t section_begin = code_item_map->offset_;
+  uint32_t section_end = section_begin;
+  for (const auto& entry : code_items) {
+    section_end = std::max(section_end, entry.first + entry.second.size);
+  }
+  std::vector<uint8_t> new_section(section_end - section_begin, 0u);
+  SafeMap<uint32_t, uint32_t> new_code_offsets;
+  uint32_t cursor = section_begin;
+  for (int pass = 0; pass < 2; ++pass) {
+    const bool want_hot = (pass == 0);
+    for (const auto& entry : code_items) {
+      if (entry.second.hot != want_hot) {
+        continue;
+      }
+      cursor = RoundUp(cursor, 4u);  // Code items are 4-byte aligned.
+      memcpy(&new_section[cursor - section_begin],
+             dex_file.Begin() + entry.first,
+             entry.second.size);
+      new_code_offsets.Put(entry.first, cursor);
+      cursor += entry.second.size;
+    }
+  }
+  CHECK_LE(cursor, section_end);
+  memcpy(out->data() + section_begin, new_section.data(), new_section.size());
+
+  // Re-encode the class_data_items with the relocated code offsets. The
+  // ULEB128 encodings change size, so the new section goes at the end of
+  // the file, in the original item order, and the old one becomes dead.
+  std::vector<std::pair<uint32_t, uint32_t>> class_data_offsets;  // (old offset, class def index)
+  for (uint32_t i = 0; i < dex_file.NumClassDefs(); ++i) {
+    const uint32_t old_off = dex_file.GetClassDef(i).class_data_off_;
+    if (old_off != 0u) {
+      class_data_offsets.push_back(std::make_pair(old_off, i));
+    }
+  }
+  std::sort(class_data_offsets.begin(), class_data_offsets.end());
+
+  const uint32_t new_class_data_off = RoundUp(out->size(), 4u);
+  std::vector<uint8_t> class_data_section;
+  SafeMap<uint32_t, uint32_t> new_class_data_offsets;
+  for (const auto& entry : class_data_offsets) {
+    if (new_class_data_offsets.find(entry.first) != new_class_data_offsets.end()) {
+      continue;  // Duplicate class defs may share one class_data_item.
+    }
+    new_class_data_offsets.Put(entry.first,
+                               new_class_data_off + dchecked_integral_cast<uint32_t>(
+                                   class_data_section.size()));
+    EncodeClassData(dex_file,
+                    dex_file.Begin() + entry.first,
+                    new_code_offsets,
+                    &class_data_section);
+  }
+  out->resize(new_class_data_off, 0u);
+  out->insert(out->end(), class_data_section.begin(), class_data_section.end());
+
+  DexFile::ClassDef* out_class_defs =
+      reinterpret_cast<DexFile::ClassDef*>(out->data() + header.class_defs_off_);
+  for (const auto& entry : class_data_offsets) {
+    out_class_defs[entry.second].class_data_off_ = new_class_data_offsets.Get(entry.first);
+  }
+
+  // Move the map list behind the rewritten class data and re-sort it; the
+  // verifier requires the entries to be ordered by offset.
+  const DexFile::MapList* old_map_list =
+      reinterpret_cast<const DexFile::MapList*>(dex_file.Begin() + header.map_off_);
+  const uint32_t map_count = old_map_list->size_;
+  std::vector<RawMapItem> map_items(map_count);
+  memcpy(map_items.data(), old_map_list->list_, map_count * sizeof(RawMapItem));
+  const uint32_t new_map_off = RoundUp(out->size(), 4u);
+  for (RawMapItem& item : map_items) {
+    if (item.type == DexFile::kDexTypeClassDataItem) {
+      item.offset = new_class_data_off;
+    } else if (item.type == DexFile::kDexTypeMapList) {
+      item.offset = new_map_off;
+    }
+  }
+  std::sort(map_items.begin(), map_items.end(),
+            [](const RawMapItem& lhs, const RawMapItem& rhs) { return lhs.offset < rhs.offset; });
+  out->resize(new_map_off + sizeof(uint32_t) + map_count * sizeof(RawMapItem), 0u);
+  memcpy(out->data() + new_map_off, &map_count, sizeof(uint32_t));
+  memcpy(out->data() + new_map_off + sizeof(uint32_t),
+         map_items.data(),
+         map_count * sizeof(RawMapItem));
+  out->resize(RoundUp(out->size(), 4u), 0u);
+
+  // Patch the header. The SHA-1 signature is deliberately left untouched:
+  // neither the runtime nor DexFileVerifier checks it, and recomputing it
+  // would pull in a crypto dependency.
+  DexFile::Header* out_header = reinterpret_cast<DexFile::Header*>(out->data());
+  out_header->map_off_ = new_map_off;
+  out_header->file_size_ = out->size();
+  out_header->data_size_ = out->size() - out_header->data_off_;
+  const uint32_t non_sum = sizeof(out_header->magic_) + sizeof(out_header->checksum_);
+  uint32_t checksum = adler32(0L, Z_NULL, 0);
+  checksum = adler32(checksum, out->data() + non_sum, out->size() - non_sum);
+  out_header->checksum_ = checksum;
+
+  if (gOptions.verbose) {
+    printf("%s: %zu of %zu code items hot, code section %u bytes\n",
+           dex_file.GetLocation().c_str(),
+           hot_count,
+           code_items.size(),
+           section_end - section_begin);
+  }
+  return true;
+}
+
+static bool WriteFile(const char* file_name, const std::vector<uint8_t>& contents) {
+  std::unique_ptr<File> file(OS::CreateEmptyFile(file_name));
+  if (file == nullptr) {
+    PLOG(ERROR) << "Failed to create output file " << file_name;
+    return false;
+  }
+  if (!file->WriteFully(contents.data(), contents.size())) {
+    PLOG(ERROR) << "Failed to write output file " << file_name;
+    file->Erase();
+    return false;
+  }
+  return file->FlushCloseOrErase() == 0;
+}
+
+/*
+ * Processes a single file (either direct .dex or indirect .zip/.jar/.apk).
+ */
+int ProcessFile(const char* file_name) {
+  std::string error_msg;
+  std::vector<std::unique_ptr<const DexFile>> dex_files;
+  if (!DexFile::Open(file_name, file_name, &error_msg, &dex_files)) {
+    fputs(error_msg.c_str(), stderr);
+    fputc('\n', stderr);
+    return -1;
+  }
+
+  std::unique_ptr<ProfileCompilationInfo> profile_info;
+  if (gOptions.profileFileName != nullptr) {
+    int fd = open(gOptions.profileFileName, O_RDONLY);
+    if (fd < 0) {
+      fprintf(stderr, "Can't open profile file %s\n", gOptions.profileFileName);
+      return -1;
+    }
+    profile_info.reset(new ProfileCompilationInfo());
+    if (!profile_info->Load(fd)) {
+      fprintf(stderr, "Can't load profile file %s\n", gOptions.profileFileName);
+      close(fd);
+      return -1;
+    }
+    close(fd);
+  }
+
+  for (size_t i = 0; i < dex_files.size(); ++i) {
+    const DexFile* dex_file = dex_files[i].get();
+    std::vector<uint8_t> out;
+    if (!LayoutDexFile(*dex_file, profile_info.get(), &out)) {
+      return -1;
+    }
+    // Re-verify the rewritten file before letting it out the door.
+    const DexFile::Header* out_header = reinterpret_cast<const DexFile::Header*>(out.data());
+    std::unique_ptr<const DexFile> checked(DexFile::Open(out.data(),
+                                                         out.size(),
+                                                         dex_file->GetLocation(),
+                                                         out_header->checksum_,
+                                                         /* oat_dex_file */ nullptr,
+                                                         /* verify */ true,
+                                                         &error_msg));
+    if (checked == nullptr) {
+      fprintf(stderr, "Internal error: rewritten %s failed verification: %s\n",
+              dex_file->GetLocation().c_str(), error_msg.c_str());
+      return -1;
+    }
+    std::string out_name(gOptions.outputFileName);
+    if (i != 0) {
+      out_name += StringPrintf(".%zu", i);
+    }
+    if (!WriteFile(out_name.c_str(), out)) {
+      return -1;
+    }
+  }
+  return 0;
+}
+
+}  // namespace art
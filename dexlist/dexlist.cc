@@ -23,6 +23,7 @@
  * List all methods in all concrete classes in one or more DEX files.
  */
 
+#include <limits.h>
 #include <stdlib.h>
 #include <stdio.h>
 
@@ -37,6 +38,7 @@ static const char* gProgName = "dexlist";
 /* Command-line options. */
 static struct {
   char* argCopy;
+  const char* batchFileName;
   const char* classToFind;
   const char* methodToFind;
   const char* outputFileName;
@@ -201,12 +203,35 @@ static int processFile(const char* fileName) {
   return 0;
 }
 
+/*
+ * Processes all files listed in the given batch file, one path per line.
+ * Empty lines and lines starting with '#' are skipped.
+ */
+static int processBatchFile(const char* fileName) {
+  FILE* batchFp = fopen(fileName, "r");
+  if (batchFp == nullptr) {
+    fprintf(stderr, "%s: can't open batch file '%s'\n", gProgName, fileName);
+    return -1;
+  }
+  int result = 0;
+  char line[PATH_MAX + 2];
+  while (fgets(line, sizeof(line), batchFp) != nullptr) {
+    line[strcspn(line, "\r\n")] = '\0';
+    if (line[0] == '\0' || line[0] == '#') {
+      continue;
+    }
+    result |= processFile(line);
+  }  // while
+  fclose(batchFp);
+  return result;
+}
+
 /*
  * Shows usage.
  */
 static void usage(void) {
   fprintf(stderr, "Copyright (C) 2007 The Android Open Source Project\n\n");
-  fprintf(stderr, "%s: [-m p.c.m] [-o outfile] dexfile...\n", gProgName);
+  fprintf(stderr, "%s: [-b batchfile] [-m p.c.m] [-o outfile] dexfile...\n", gProgName);
   fprintf(stderr, "\n");
 }
 
@@ -224,11 +249,14 @@ int dexlistDriver(int argc, char** argv) {
 
   // Parse all arguments.
   while (1) {
-    const int ic = getopt(argc, argv, "o:m:");
+    const int ic = getopt(argc, argv, "b:o:m:");
     if (ic < 0) {
       break;  // done
     }
     switch (ic) {
+      case 'b':  // batch file with one input file per line
+        gOptions.batchFileName = optarg;
+        break;
       case 'o':  // output file
         gOptions.outputFileName = optarg;
         break;
@@ -256,7 +284,7 @@ int dexlistDriver(int argc, char** argv) {
   }  // while
 
   // Detect early problems.
-  if (optind == argc) {
+  if (optind == argc && gOptions.batchFileName == nullptr) {
     fprintf(stderr, "%s: no file specified\n", gProgName);
     wantUsage = true;
   }
@@ -276,12 +304,15 @@ int dexlistDriver(int argc, char** argv) {
     }
   }
 
-  // Process all files supplied on command line. If one of them fails we
-  // continue on, only returning a failure at the end.
+  // Process all files supplied on command line, then the batch file if any.
+  // If one of them fails we continue on, only returning a failure at the end.
   int result = 0;
   while (optind < argc) {
     result |= processFile(argv[optind++]);
   }  // while
+  if (gOptions.batchFileName != nullptr) {
+    result |= processBatchFile(gOptions.batchFileName);
+  }
 
   free(gOptions.argCopy);
   return result != 0;
@@ -36,6 +36,7 @@
 #include "image.h"
 #include "scoped_thread_state_change.h"
 #include "os.h"
+#include "utils.h"
 
 #include "cmdline.h"
 #include "backtrace/BacktraceMap.h"
@@ -52,12 +53,14 @@ class ImgDiagDumper {
                          const ImageHeader& image_header,
                          const std::string& image_location,
                          pid_t image_diff_pid,
-                         pid_t zygote_diff_pid)
+                         pid_t zygote_diff_pid,
+                         const char* dirty_classes_out)
       : os_(os),
         image_header_(image_header),
         image_location_(image_location),
         image_diff_pid_(image_diff_pid),
-        zygote_diff_pid_(zygote_diff_pid) {}
+        zygote_diff_pid_(zygote_diff_pid),
+        dirty_classes_out_(dirty_classes_out) {}
 
   bool Dump() SHARED_REQUIRES(Locks::mutator_lock_) {
     std::ostream& os = *os_;
@@ -827,6 +830,38 @@ class ImgDiagDumper {
       os << "    " << PrettyClass(vk_pair.second) << " (" << vk_pair.first << ")\n";
     }
 
+    if (dirty_classes_out_ != nullptr && !WriteDirtyClasses(class_data)) {
+      return false;
+    }
+
+    return true;
+  }
+
+  // Writes the classes owning dirty objects to a file, most dirty bytes first, one class name
+  // per line in the form dex2oat's --dirty-image-classes option consumes. Per-class counts are
+  // emitted as comment lines so dashboards can parse them while dex2oat ignores them.
+  bool WriteDirtyClasses(const std::map<mirror::Class*, ClassData>& class_data)
+      SHARED_REQUIRES(Locks::mutator_lock_) {
+    std::ofstream out(dirty_classes_out_);
+    if (!out.is_open()) {
+      *os_ << "Failed to open dirty class output file " << dirty_classes_out_ << "\n";
+      return false;
+    }
+    auto dirty_byte_class_values = SortByValueDesc<mirror::Class*, int, ClassData>(
+        class_data, [](const ClassData& d) { return d.dirty_object_byte_count; });
+    out << "# Classes with dirty objects in " << GetImageLocationBaseName()
+        << ", most dirty bytes first.\n";
+    for (const auto& vk_pair : dirty_byte_class_values) {
+      if (vk_pair.first <= 0) {
+        continue;
+      }
+      const ClassData& data = class_data.at(vk_pair.second);
+      out << "# dirty_objects=" << data.dirty_object_count
+          << " dirty_bytes=" << data.dirty_object_byte_count << "\n";
+      out << DescriptorToDot(data.descriptor.c_str()) << "\n";
+    }
+    out.close();
+    *os_ << "  Wrote dirty classes to " << dirty_classes_out_ << "\n";
     return true;
   }
 
@@ -1009,6 +1044,7 @@ class ImgDiagDumper {
   const std::string image_location_;
   pid_t image_diff_pid_;  // Dump image diff against boot.art if pid is non-negative
   pid_t zygote_diff_pid_;  // Dump image diff against zygote boot.art if pid is non-negative
+  const char* dirty_classes_out_;  // Write dirty class names here if non-null
 
   DISALLOW_COPY_AND_ASSIGN(ImgDiagDumper);
 };
@@ -1016,7 +1052,8 @@ class ImgDiagDumper {
 static int DumpImage(Runtime* runtime,
                      std::ostream* os,
                      pid_t image_diff_pid,
-                     pid_t zygote_diff_pid) {
+                     pid_t zygote_diff_pid,
+                     const char* dirty_classes_out) {
   ScopedObjectAccess soa(Thread::Current());
   gc::Heap* heap = runtime->GetHeap();
   std::vector<gc::space::ImageSpace*> image_spaces = heap->GetBootImageSpaces();
@@ -1032,7 +1069,8 @@ static int DumpImage(Runtime* runtime,
                                   image_header,
                                   image_space->GetImageLocation(),
                                   image_diff_pid,
-                                  zygote_diff_pid);
+                                  zygote_diff_pid,
+                                  dirty_classes_out);
     if (!img_diag_dumper.Dump()) {
       return EXIT_FAILURE;
     }
@@ -1067,6 +1105,8 @@ struct ImgDiagArgs : public CmdlineArgs {
         *error_msg = "Zygote diff pid out of range";
         return kParseError;
       }
+    } else if (option.starts_with("--dirty-classes-out=")) {
+      dirty_classes_out_ = option.substr(strlen("--dirty-classes-out=")).data();
     } else {
       return kParseUnknownArgument;
     }
@@ -1119,6 +1159,9 @@ struct ImgDiagArgs : public CmdlineArgs {
         "  --zygote-diff-pid=<pid>: provide the PID of the zygote whose boot.art you want to diff "
         "against.\n"
         "      Example: --zygote-diff-pid=$(pid zygote)\n"
+        "  --dirty-classes-out=<file>: write the classes owning dirty objects to a file that\n"
+        "      dex2oat's --dirty-image-classes option can consume.\n"
+        "      Example: --dirty-classes-out=dirty-classes.txt\n"
         "\n";
 
     return usage;
@@ -1127,6 +1170,7 @@ struct ImgDiagArgs : public CmdlineArgs {
  public:
   pid_t image_diff_pid_ = -1;
   pid_t zygote_diff_pid_ = -1;
+  const char* dirty_classes_out_ = nullptr;
 };
 
 struct ImgDiagMain : public CmdlineMain<ImgDiagArgs> {
@@ -1136,7 +1180,8 @@ struct ImgDiagMain : public CmdlineMain<ImgDiagArgs> {
     return DumpImage(runtime,
                      args_->os_,
                      args_->image_diff_pid_,
-                     args_->zygote_diff_pid_) == EXIT_SUCCESS;
+                     args_->zygote_diff_pid_,
+                     args_->dirty_classes_out_) == EXIT_SUCCESS;
   }
 };
 
@@ -288,6 +288,7 @@ class OatDumperOptions {
                    const char* method_filter,
                    bool list_classes,
                    bool list_methods,
+                   bool dump_method_sizes,
                    bool dump_header_only,
                    const char* export_dex_location,
                    const char* app_image,
@@ -301,6 +302,7 @@ class OatDumperOptions {
       method_filter_(method_filter),
       list_classes_(list_classes),
       list_methods_(list_methods),
+      dump_method_sizes_(dump_method_sizes),
       dump_header_only_(dump_header_only),
       export_dex_location_(export_dex_location),
       app_image_(app_image),
@@ -316,6 +318,7 @@ class OatDumperOptions {
   const char* const method_filter_;
   const bool list_classes_;
   const bool list_methods_;
+  const bool dump_method_sizes_;
   const bool dump_header_only_;
   const char* const export_dex_location_;
   const char* const app_image_;
@@ -355,6 +358,11 @@ class OatDumper {
     bool success = true;
     const OatHeader& oat_header = oat_file_.GetOatHeader();
 
+    if (options_.dump_method_sizes_) {
+      // Index-only mode: per-method offsets and sizes, no header dump, no disassembly.
+      return DumpMethodSizes(os);
+    }
+
     os << "MAGIC:\n";
     os << oat_header.GetMagic() << "\n\n";
 
@@ -636,6 +644,58 @@ class OatDumper {
     return success;
   }
 
+  // Emits one CSV row per compiled method so oat files can be size-diffed without paying for
+  // disassembly: dex_location,"method",code_offset,code_size. The class and method filters apply
+  // as in the normal dump.
+  bool DumpMethodSizes(std::ostream& os) {
+    bool success = true;
+    os << "dex_location,method,code_offset,code_size\n";
+    for (size_t i = 0; i < oat_dex_files_.size(); i++) {
+      const OatFile::OatDexFile* oat_dex_file = oat_dex_files_[i];
+      CHECK(oat_dex_file != nullptr);
+      std::string error_msg;
+      const DexFile* const dex_file = OpenDexFile(oat_dex_file, &error_msg);
+      if (dex_file == nullptr) {
+        LOG(WARNING) << "Failed to open dex file '" << oat_dex_file->GetDexFileLocation()
+            << "': " << error_msg;
+        success = false;
+        continue;
+      }
+      for (size_t class_def_index = 0;
+           class_def_index < dex_file->NumClassDefs();
+           class_def_index++) {
+        const DexFile::ClassDef& class_def = dex_file->GetClassDef(class_def_index);
+        const char* descriptor = dex_file->GetClassDescriptor(class_def);
+        if (DescriptorToDot(descriptor).find(options_.class_filter_) == std::string::npos) {
+          continue;
+        }
+        const uint8_t* class_data = dex_file->GetClassData(class_def);
+        if (class_data == nullptr) {  // empty class such as a marker interface?
+          continue;
+        }
+        const OatFile::OatClass oat_class = oat_dex_file->GetOatClass(class_def_index);
+        ClassDataItemIterator it(*dex_file, class_data);
+        SkipAllFields(it);
+        uint32_t class_method_index = 0;
+        while (it.HasNextDirectMethod() || it.HasNextVirtualMethod()) {
+          const OatFile::OatMethod oat_method = oat_class.GetOatMethod(class_method_index++);
+          std::string pretty_method = PrettyMethod(it.GetMemberIndex(), *dex_file, true);
+          it.Next();
+          if (pretty_method.find(options_.method_filter_) == std::string::npos) {
+            continue;
+          }
+          // Quote the method so the commas in its signature don't break the CSV format.
+          os << oat_dex_file->GetDexFileLocation() << ",\"" << pretty_method << "\","
+             << StringPrintf("0x%08x,%u\n",
+                             oat_method.GetCodeOffset(),
+                             oat_method.GetQuickCodeSize());
+        }
+      }
+    }
+    os << std::flush;
+    return success;
+  }
+
   bool ExportDexFile(std::ostream& os, const OatFile::OatDexFile& oat_dex_file) {
     std::string error_msg;
     std::string dex_file_location = oat_dex_file.GetDexFileLocation();
@@ -2406,6 +2466,8 @@ struct OatdumpArgs : public CmdlineArgs {
       list_classes_ = true;
     } else if (option.starts_with("--list-methods")) {
       list_methods_ = true;
+    } else if (option.starts_with("--method-sizes")) {
+      dump_method_sizes_ = true;
     } else if (option.starts_with("--export-dex-to=")) {
       export_dex_location_ = option.substr(strlen("--export-dex-to=")).data();
     } else if (option.starts_with("--addr2instr=")) {
@@ -2494,6 +2556,10 @@ struct OatdumpArgs : public CmdlineArgs {
         "      Example: --list-methods\n"
         "      Example: --list-methods --class-filter=com.example --method-filter=foo\n"
         "\n"
+        "  --method-sizes may be used to emit per-method code offsets and sizes as CSV,\n"
+        "      skipping the header dump and disassembly (can be used with filters).\n"
+        "      Example: --method-sizes --class-filter=com.example\n"
+        "\n"
         "  --symbolize=<file.oat>: output a copy of file.oat with elf symbols included.\n"
         "      Example: --symbolize=/system/framework/boot.oat\n"
         "\n"
@@ -2531,6 +2597,7 @@ struct OatdumpArgs : public CmdlineArgs {
   bool only_keep_debug_ = false;
   bool list_classes_ = false;
   bool list_methods_ = false;
+  bool dump_method_sizes_ = false;
   bool dump_header_only_ = false;
   uint32_t addr2instr_ = 0;
   const char* export_dex_location_ = nullptr;
@@ -2554,6 +2621,7 @@ struct OatdumpMain : public CmdlineMain<OatdumpArgs> {
         args_->method_filter_,
         args_->list_classes_,
         args_->list_methods_,
+        args_->dump_method_sizes_,
         args_->dump_header_only_,
         args_->export_dex_location_,
         args_->app_image_,
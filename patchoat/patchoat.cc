@@ -46,6 +46,7 @@
 #include "runtime.h"
 #include "scoped_thread_state_change.h"
 #include "thread.h"
+#include "thread_pool.h"
 #include "utils.h"
 
 namespace art {
@@ -627,6 +628,35 @@ void PatchOat::PatchDexFileArrays(mirror::ObjectArray<mirror::Object>* img_roots
   }
 }
 
+// Number of threads used to patch the objects section of an image, including the invoking
+// thread. Capped because the patching is memory bound and more threads mostly contend for
+// bandwidth.
+static constexpr size_t kMaxImagePatchThreads = 4;
+
+class PatchOat::PatchImageShardTask : public Task {
+ public:
+  PatchImageShardTask(PatchOat* p, uintptr_t begin, uintptr_t end)
+      : p_(p), begin_(begin), end_(end) {}
+
+  void Run(Thread* self) OVERRIDE {
+    ScopedObjectAccess soa(self);
+    ReaderMutexLock mu(self, *Locks::heap_bitmap_lock_);
+    p_->bitmap_->VisitMarkedRange(begin_, end_, [this](mirror::Object* obj)
+        SHARED_REQUIRES(Locks::mutator_lock_) {
+      p_->VisitObject(obj);
+    });
+  }
+
+  void Finalize() OVERRIDE {
+    delete this;
+  }
+
+ private:
+  PatchOat* const p_;
+  const uintptr_t begin_;
+  const uintptr_t end_;
+};
+
 bool PatchOat::PatchImage(bool primary_image) {
   ImageHeader* image_header = reinterpret_cast<ImageHeader*>(image_->Begin());
   CHECK_GT(image_->Size(), sizeof(ImageHeader));
@@ -653,9 +683,40 @@ bool PatchOat::PatchImage(bool primary_image) {
 
   {
     TimingLogger::ScopedTiming t("Walk Bitmap", timings_);
-    // Walk the bitmap.
-    WriterMutexLock mu(Thread::Current(), *Locks::heap_bitmap_lock_);
-    bitmap_->Walk(PatchOat::BitmapCallback, this);
+    // Shard the objects section into page-aligned ranges and patch them in parallel. The
+    // patching is idempotent: structures reachable from several shards (e.g. a vtable shared
+    // between a class and its subclasses) receive identical relocated values from every visit,
+    // so the shards do not need to synchronize with each other.
+    Thread* const self = Thread::Current();
+    const ImageSection& objects = image_header->GetImageSection(ImageHeader::kSectionObjects);
+    const uintptr_t objects_begin = reinterpret_cast<uintptr_t>(heap_->Begin()) + objects.Offset();
+    const uintptr_t objects_end = objects_begin + objects.Size();
+    const size_t num_cpus = static_cast<size_t>(std::max(1L, sysconf(_SC_NPROCESSORS_CONF)));
+    const size_t thread_count = std::min(kMaxImagePatchThreads, num_cpus);
+    if (thread_count == 1u) {
+      ReaderMutexLock mu(self, *Locks::heap_bitmap_lock_);
+      bitmap_->VisitMarkedRange(objects_begin, objects_end, [this](mirror::Object* obj)
+          SHARED_REQUIRES(Locks::mutator_lock_) {
+        VisitObject(obj);
+      });
+    } else {
+      // Use more shards than threads so that one unlucky dense shard does not serialize the
+      // walk at the end.
+      const size_t shard_count = thread_count * 4;
+      const uintptr_t shard_size =
+          RoundUp((objects_end - objects_begin) / shard_count + 1u, kPageSize);
+      ThreadPool pool("Image patching pool", thread_count - 1);
+      for (uintptr_t shard = objects_begin; shard < objects_end; shard += shard_size) {
+        pool.AddTask(self,
+                     new PatchImageShardTask(this, shard, std::min(objects_end,
+                                                                   shard + shard_size)));
+      }
+      pool.StartWorkers(self);
+      // Participate in the patching, and transition out of runnable while waiting so that the
+      // workers can transition in.
+      ScopedThreadSuspension sts(self, kNative);
+      pool.Wait(self, /* do_work */ true, /* may_hold_locks */ false);
+    }
   }
   return true;
 }
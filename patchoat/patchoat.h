@@ -97,10 +97,8 @@ class PatchOat {
                                         bool output_oat_opened_from_fd,
                                         bool new_oat_out);  // Output oat was newly created?
 
-  static void BitmapCallback(mirror::Object* obj, void* arg)
-      SHARED_REQUIRES(Locks::mutator_lock_) {
-    reinterpret_cast<PatchOat*>(arg)->VisitObject(obj);
-  }
+  // Task patching the objects whose addresses fall into one shard of the objects section.
+  class PatchImageShardTask;
 
   void VisitObject(mirror::Object* obj)
       SHARED_REQUIRES(Locks::mutator_lock_);
@@ -28,7 +28,8 @@ static constexpr const uint32_t kMinNewClassesForCompilation = 10;
 
 ProfileAssistant::ProcessingResult ProfileAssistant::ProcessProfilesInternal(
         const std::vector<ScopedFlock>& profile_files,
-        const ScopedFlock& reference_profile_file) {
+        const ScopedFlock& reference_profile_file,
+        uint32_t max_methods) {
   DCHECK(!profile_files.empty());
 
   ProfileCompilationInfo info;
@@ -42,13 +43,19 @@ ProfileAssistant::ProcessingResult ProfileAssistant::ProcessProfilesInternal(
   uint32_t number_of_methods = info.GetNumberOfMethods();
   uint32_t number_of_classes = info.GetNumberOfResolvedClasses();
 
-  // Merge all current profiles.
+  // Merge all current profiles. Keep their union around so that we can fall
+  // back to it if the merged reference profile outgrows the method cap.
+  ProfileCompilationInfo current_info;
   for (size_t i = 0; i < profile_files.size(); i++) {
-    if (!info.Load(profile_files[i].GetFile()->Fd())) {
+    if (!current_info.Load(profile_files[i].GetFile()->Fd())) {
       LOG(WARNING) << "Could not load profile file at index " << i;
       return kErrorBadProfiles;
     }
   }
+  if (!info.MergeWith(current_info)) {
+    LOG(WARNING) << "Could not merge current profiles into the reference profile";
+    return kErrorBadProfiles;
+  }
 
   // Check if there is enough new information added by the current profiles.
   if (((info.GetNumberOfMethods() - number_of_methods) < kMinNewMethodsForCompilation) &&
@@ -56,6 +63,15 @@ ProfileAssistant::ProcessingResult ProfileAssistant::ProcessProfilesInternal(
     return kSkipCompilation;
   }
 
+  // The profile format records no hotness, so when the merged profile grows
+  // past the cap the best approximation of evicting the coldest entries is to
+  // retire everything the current profiles did not observe.
+  if ((max_methods != 0) && (info.GetNumberOfMethods() > max_methods)) {
+    VLOG(profiler) << "Merged profile exceeds " << max_methods
+        << " methods; retiring data not seen by the current profiles";
+    info = current_info;
+  }
+
   // We were successful in merging all profile information. Update the reference profile.
   if (!reference_profile_file.GetFile()->ClearContent()) {
     PLOG(WARNING) << "Could not clear reference profile file";
@@ -116,7 +132,8 @@ class ScopedCollectionFlock {
 
 ProfileAssistant::ProcessingResult ProfileAssistant::ProcessProfiles(
         const std::vector<int>& profile_files_fd,
-        int reference_profile_file_fd) {
+        int reference_profile_file_fd,
+        uint32_t max_methods) {
   DCHECK_GE(reference_profile_file_fd, 0);
   std::string error;
   ScopedCollectionFlock profile_files_flocks(profile_files_fd.size());
@@ -131,12 +148,14 @@ ProfileAssistant::ProcessingResult ProfileAssistant::ProcessProfiles(
   }
 
   return ProcessProfilesInternal(profile_files_flocks.Get(),
-                                 reference_profile_file_flock);
+                                 reference_profile_file_flock,
+                                 max_methods);
 }
 
 ProfileAssistant::ProcessingResult ProfileAssistant::ProcessProfiles(
         const std::vector<std::string>& profile_files,
-        const std::string& reference_profile_file) {
+        const std::string& reference_profile_file,
+        uint32_t max_methods) {
   std::string error;
   ScopedCollectionFlock profile_files_flocks(profile_files.size());
   if (!profile_files_flocks.Init(profile_files, &error)) {
@@ -150,7 +169,8 @@ ProfileAssistant::ProcessingResult ProfileAssistant::ProcessProfiles(
   }
 
   return ProcessProfilesInternal(profile_files_flocks.Get(),
-                                 reference_profile_file_flock);
+                                 reference_profile_file_flock,
+                                 max_methods);
 }
 
 }  // namespace art
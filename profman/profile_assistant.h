@@ -51,18 +51,26 @@ class ProfileAssistant {
   // merge of the current profiles and the reference one is insignificant. In
   // this case no file will be updated.
   //
+  // If max_methods is not 0 and the merged profile would record more methods
+  // than that, the methods and classes which were not seen by any of the
+  // current profiles are retired from the reference profile. The profile
+  // format does not record hotness so this generational retirement is how we
+  // keep a long-lived reference profile focused on the current working set.
   static ProcessingResult ProcessProfiles(
       const std::vector<std::string>& profile_files,
-      const std::string& reference_profile_file);
+      const std::string& reference_profile_file,
+      uint32_t max_methods = 0);
 
   static ProcessingResult ProcessProfiles(
       const std::vector<int>& profile_files_fd_,
-      int reference_profile_file_fd);
+      int reference_profile_file_fd,
+      uint32_t max_methods = 0);
 
  private:
   static ProcessingResult ProcessProfilesInternal(
       const std::vector<ScopedFlock>& profile_files,
-      const ScopedFlock& reference_profile_file);
+      const ScopedFlock& reference_profile_file,
+      uint32_t max_methods);
 
   DISALLOW_COPY_AND_ASSIGN(ProfileAssistant);
 };
@@ -62,7 +62,9 @@ class ProfileAssistantTest : public CommonRuntimeTest {
   }
 
     // Runs test with given arguments.
-  int ProcessProfiles(const std::vector<int>& profiles_fd, int reference_profile_fd) {
+  int ProcessProfiles(const std::vector<int>& profiles_fd,
+                      int reference_profile_fd,
+                      const std::vector<std::string>& extra_args = std::vector<std::string>()) {
     std::string file_path = GetTestAndroidRoot();
     file_path += "/bin/profman";
     if (kIsDebugBuild) {
@@ -76,6 +78,7 @@ class ProfileAssistantTest : public CommonRuntimeTest {
       argv_str.push_back("--profile-file-fd=" + std::to_string(profiles_fd[k]));
     }
     argv_str.push_back("--reference-profile-file-fd=" + std::to_string(reference_profile_fd));
+    argv_str.insert(argv_str.end(), extra_args.begin(), extra_args.end());
 
     std::string error;
     return ExecAndReturnCode(argv_str, &error);
@@ -189,6 +192,38 @@ TEST_F(ProfileAssistantTest, AdviseCompilationNonEmptyReferences) {
   CheckProfileInfo(profile2, info2);
 }
 
+TEST_F(ProfileAssistantTest, MethodCapRetiresUnseenData) {
+  ScratchFile profile1;
+  ScratchFile reference_profile;
+
+  std::vector<int> profile_fds({
+      GetFd(profile1)});
+  int reference_profile_fd = GetFd(reference_profile);
+
+  // The reference profile records methods 0-99, the current profile methods 100-199.
+  const uint16_t kNumberOfMethods = 100;
+  ProfileCompilationInfo info1;
+  SetupProfile("p1", 1, kNumberOfMethods, 0, profile1, &info1,
+      /* start_method_index */ kNumberOfMethods);
+  ProfileCompilationInfo reference_info;
+  SetupProfile("p1", 1, kNumberOfMethods, 0, reference_profile, &reference_info);
+
+  // SetupProfile records each method in two dex files, so the merge would hold
+  // 400 methods. Capping at 300 must retire the data only the reference has.
+  std::vector<std::string> extra_args({"--max-methods=300"});
+  ASSERT_EQ(ProfileAssistant::kCompile,
+            ProcessProfiles(profile_fds, reference_profile_fd, extra_args));
+
+  // Only the data seen by the current profile survives.
+  ProfileCompilationInfo result;
+  ASSERT_TRUE(reference_profile.GetFile()->ResetOffset());
+  ASSERT_TRUE(result.Load(reference_profile_fd));
+  ASSERT_TRUE(result.Equals(info1));
+
+  // The information from the current profile must remain the same.
+  CheckProfileInfo(profile1, info1);
+}
+
 TEST_F(ProfileAssistantTest, DoNotAdviseCompilation) {
   ScratchFile profile1;
   ScratchFile profile2;
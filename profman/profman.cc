@@ -84,6 +84,11 @@ NO_RETURN static void Usage(const char *fmt, ...) {
   UsageError("  --dump-output-to-fd=<number>: redirects --dump-info-for output to a file");
   UsageError("      descriptor.");
   UsageError("");
+  UsageError("  --dump-new-methods: dumps the methods present in the aggregation of the");
+  UsageError("      specified profile files but absent from the reference profile.");
+  UsageError("      No file is updated. The output goes to standard output or to");
+  UsageError("      --dump-output-to-fd.");
+  UsageError("");
   UsageError("  --profile-file=<filename>: specify profiler output file to use for compilation.");
   UsageError("      Can be specified multiple time, in which case the data from the different");
   UsageError("      profiles will be aggregated.");
@@ -107,6 +112,11 @@ NO_RETURN static void Usage(const char *fmt, ...) {
   UsageError("  --apk-fd=<number>: file descriptor containing an open APK to");
   UsageError("      search for dex files");
   UsageError("");
+  UsageError("  --max-methods=<number>: if the merged reference profile would record");
+  UsageError("      more methods than this, the methods and classes not seen by the");
+  UsageError("      current profiles are dropped from it. A value of 0 (default)");
+  UsageError("      disables the cap.");
+  UsageError("");
 
   exit(EXIT_FAILURE);
 }
@@ -116,7 +126,9 @@ class ProfMan FINAL {
   ProfMan() :
       reference_profile_file_fd_(kInvalidFd),
       dump_only_(false),
+      dump_new_methods_(false),
       dump_output_to_fd_(kInvalidFd),
+      max_methods_(0u),
       start_ns_(NanoTime()) {}
 
   ~ProfMan() {
@@ -145,6 +157,8 @@ class ProfMan FINAL {
       }
       if (option == "--dump-only") {
         dump_only_ = true;
+      } else if (option == "--dump-new-methods") {
+        dump_new_methods_ = true;
       } else if (option.starts_with("--dump-output-to-fd=")) {
         ParseUintOption(option, "--dump-output-to-fd", &dump_output_to_fd_, Usage);
       } else if (option.starts_with("--profile-file=")) {
@@ -159,6 +173,8 @@ class ProfMan FINAL {
         dex_locations_.push_back(option.substr(strlen("--dex-location=")).ToString());
       } else if (option.starts_with("--apk-fd=")) {
         ParseFdForCollection(option, "--apk-fd", &apks_fd_);
+      } else if (option.starts_with("--max-methods=")) {
+        ParseUintOption(option, "--max-methods", &max_methods_, Usage);
       } else {
         Usage("Unknown argument '%s'", option.data());
       }
@@ -168,6 +184,9 @@ class ProfMan FINAL {
     bool has_reference_profile = !reference_profile_file_.empty() ||
         FdIsValid(reference_profile_file_fd_);
 
+    if (dump_only_ && dump_new_methods_) {
+      Usage("--dump-only cannot be specified together with --dump-new-methods");
+    }
     // --dump-only may be specified with only --reference-profiles present.
     if (!dump_only_ && !has_profiles) {
       Usage("No profile files specified.");
@@ -195,16 +214,21 @@ class ProfMan FINAL {
       // The file doesn't need to be flushed here (ProcessProfiles will do it)
       // so don't check the usage.
       File file(reference_profile_file_fd_, false);
-      result = ProfileAssistant::ProcessProfiles(profile_files_fd_, reference_profile_file_fd_);
+      result = ProfileAssistant::ProcessProfiles(profile_files_fd_,
+                                                 reference_profile_file_fd_,
+                                                 max_methods_);
       CloseAllFds(profile_files_fd_, "profile_files_fd_");
     } else {
-      result = ProfileAssistant::ProcessProfiles(profile_files_, reference_profile_file_);
+      result = ProfileAssistant::ProcessProfiles(profile_files_,
+                                                 reference_profile_file_,
+                                                 max_methods_);
     }
     return result;
   }
 
-  int DumpOneProfile(const std::string& banner, const std::string& filename, int fd,
-                     const std::vector<const DexFile*>* dex_files, std::string* dump) {
+  // Loads profile information from a file or, if filename is empty, from the
+  // given descriptor. The descriptor is closed when the load is done.
+  int LoadProfile(const std::string& filename, int fd, ProfileCompilationInfo* info) {
     if (!filename.empty()) {
       fd = open(filename.c_str(), O_RDWR);
       if (fd < 0) {
@@ -212,27 +236,20 @@ class ProfMan FINAL {
         return -1;
       }
     }
-    ProfileCompilationInfo info;
-    if (!info.Load(fd)) {
+    if (!info->Load(fd)) {
       std::cerr << "Cannot load profile info from fd=" << fd << "\n";
       return -1;
     }
-    std::string this_dump = banner + "\n" + info.DumpInfo(dex_files) + "\n";
-    *dump += this_dump;
     if (close(fd) < 0) {
       PLOG(WARNING) << "Failed to close descriptor";
     }
     return 0;
   }
 
-  int DumpProfileInfo() {
-    static const char* kEmptyString = "";
-    static const char* kOrdinaryProfile = "=== profile ===";
-    static const char* kReferenceProfile = "=== reference profile ===";
-
-    // Open apk/zip files and and read dex files.
+  // Opens the dex files in the apks provided with --apk-fd so that profile
+  // entries can be resolved to method and class names.
+  void OpenDexFilesFromApks(std::vector<const DexFile*>* dex_files) {
     MemMap::Init();  // for ZipArchive::OpenFromFd
-    std::vector<const DexFile*> dex_files;
     assert(dex_locations_.size() == apks_fd_.size());
     for (size_t i = 0; i < dex_locations_.size(); ++i) {
       std::string error_msg;
@@ -253,9 +270,43 @@ class ProfMan FINAL {
         continue;
       }
       for (std::unique_ptr<const DexFile>& dex_file : dex_files_for_location) {
-        dex_files.push_back(dex_file.release());
+        dex_files->push_back(dex_file.release());
       }
     }
+  }
+
+  // Writes the dump to standard output or to --dump-output-to-fd if one was given.
+  int WriteDump(const std::string& dump) {
+    if (!FdIsValid(dump_output_to_fd_)) {
+      std::cout << dump;
+    } else {
+      unix_file::FdFile out_fd(dump_output_to_fd_, false /*check_usage*/);
+      if (!out_fd.WriteFully(dump.c_str(), dump.length())) {
+        return -1;
+      }
+    }
+    return 0;
+  }
+
+  int DumpOneProfile(const std::string& banner, const std::string& filename, int fd,
+                     const std::vector<const DexFile*>* dex_files, std::string* dump) {
+    ProfileCompilationInfo info;
+    if (LoadProfile(filename, fd, &info) != 0) {
+      return -1;
+    }
+    std::string this_dump = banner + "\n" + info.DumpInfo(dex_files) + "\n";
+    *dump += this_dump;
+    return 0;
+  }
+
+  int DumpProfileInfo() {
+    static const char* kEmptyString = "";
+    static const char* kOrdinaryProfile = "=== profile ===";
+    static const char* kReferenceProfile = "=== reference profile ===";
+
+    // Open apk/zip files and and read dex files.
+    std::vector<const DexFile*> dex_files;
+    OpenDexFilesFromApks(&dex_files);
 
     std::string dump;
     // Dump individual profile files.
@@ -300,19 +351,49 @@ class ProfMan FINAL {
         return ret;
       }
     }
-    if (!FdIsValid(dump_output_to_fd_)) {
-      std::cout << dump;
+    return WriteDump(dump);
+  }
+
+  bool ShouldOnlyDumpProfile() {
+    return dump_only_;
+  }
+
+  // Reports the methods recorded by the current profiles but not by the
+  // reference profile, without updating any file.
+  int DumpNewMethods() {
+    // Open apk/zip files and and read dex files.
+    std::vector<const DexFile*> dex_files;
+    OpenDexFilesFromApks(&dex_files);
+
+    // Aggregate the current profiles the same way a merge would.
+    ProfileCompilationInfo current_info;
+    for (int profile_file_fd : profile_files_fd_) {
+      if (LoadProfile("", profile_file_fd, &current_info) != 0) {
+        return -1;
+      }
+    }
+    for (const std::string& profile_file : profile_files_) {
+      if (LoadProfile(profile_file, kInvalidFd, &current_info) != 0) {
+        return -1;
+      }
+    }
+
+    ProfileCompilationInfo reference_info;
+    if (FdIsValid(reference_profile_file_fd_)) {
+      if (LoadProfile("", reference_profile_file_fd_, &reference_info) != 0) {
+        return -1;
+      }
     } else {
-      unix_file::FdFile out_fd(dump_output_to_fd_, false /*check_usage*/);
-      if (!out_fd.WriteFully(dump.c_str(), dump.length())) {
+      if (LoadProfile(reference_profile_file_, kInvalidFd, &reference_info) != 0) {
         return -1;
       }
     }
-    return 0;
+
+    return WriteDump(current_info.DumpNewMethods(reference_info, &dex_files) + "\n");
   }
 
-  bool ShouldOnlyDumpProfile() {
-    return dump_only_;
+  bool ShouldOnlyDumpNewMethods() {
+    return dump_new_methods_;
   }
 
  private:
@@ -347,7 +428,9 @@ class ProfMan FINAL {
   std::string reference_profile_file_;
   int reference_profile_file_fd_;
   bool dump_only_;
+  bool dump_new_methods_;
   int dump_output_to_fd_;
+  uint32_t max_methods_;
   uint64_t start_ns_;
 };
 
@@ -361,6 +444,9 @@ static int profman(int argc, char** argv) {
   if (profman.ShouldOnlyDumpProfile()) {
     return profman.DumpProfileInfo();
   }
+  if (profman.ShouldOnlyDumpNewMethods()) {
+    return profman.DumpNewMethods();
+  }
   // Process profile information and assess if we need to do a profile guided compilation.
   // This operation involves I/O.
   return profman.ProcessProfiles();
@@ -27,6 +27,7 @@ LIBART_COMMON_SRC_FILES := \
   base/arena_allocator.cc \
   base/arena_bit_vector.cc \
   base/bit_vector.cc \
+  base/concurrent_histogram.cc \
   base/file_magic.cc \
   base/hex_dump.cc \
   base/logging.cc \
@@ -41,6 +42,7 @@ LIBART_COMMON_SRC_FILES := \
   base/unix_file/random_access_file_utils.cc \
   check_jni.cc \
   class_linker.cc \
+  class_load_notifier.cc \
   class_table.cc \
   code_simulator_container.cc \
   common_throws.cc \
@@ -90,6 +92,7 @@ LIBART_COMMON_SRC_FILES := \
   instrumentation.cc \
   intern_table.cc \
   interpreter/interpreter.cc \
+  interpreter/interpreter_cache.cc \
   interpreter/interpreter_common.cc \
   interpreter/interpreter_goto_table_impl.cc \
   interpreter/interpreter_switch_impl.cc \
@@ -104,6 +107,7 @@ LIBART_COMMON_SRC_FILES := \
   jdwp/object_registry.cc \
   jni_env_ext.cc \
   jit/debugger_interface.cc \
+  jit/dex_cache_prefetcher.cc \
   jit/jit.cc \
   jit/jit_code_cache.cc \
   jit/offline_profiling_info.cc \
@@ -192,6 +196,7 @@ LIBART_COMMON_SRC_FILES := \
   verifier/reg_type.cc \
   verifier/reg_type_cache.cc \
   verifier/register_line.cc \
+  verifier/verification_cache.cc \
   well_known_classes.cc \
   zip_archive.cc
 
@@ -218,6 +223,7 @@ LIBART_COMMON_SRC_FILES += \
   entrypoints/quick/quick_cast_entrypoints.cc \
   entrypoints/quick/quick_deoptimization_entrypoints.cc \
   entrypoints/quick/quick_dexcache_entrypoints.cc \
+  entrypoints/quick/quick_entrypoint_counters.cc \
   entrypoints/quick/quick_field_entrypoints.cc \
   entrypoints/quick/quick_fillarray_entrypoints.cc \
   entrypoints/quick/quick_instrumentation_entrypoints.cc \
@@ -110,9 +110,9 @@ bool NullPointerHandler::Action(int sig ATTRIBUTE_UNUSED, siginfo_t* info ATTRIB
 // the fault (at PC-4 and PC).
 bool SuspensionHandler::Action(int sig ATTRIBUTE_UNUSED, siginfo_t* info ATTRIBUTE_UNUSED,
                                void* context) {
-  // These are the instructions to check for.  The first one is the ldr x0,[r18,#xxx]
-  // where xxx is the offset of the suspend trigger.
-  uint32_t checkinst1 = 0xf9400240 | (Thread::ThreadSuspendTriggerOffset<8>().Int32Value() << 7);
+  // These are the instructions to check for.  The first one is the ldr x0,[x19,#xxx]
+  // where x19 is the thread register and xxx is the offset of the suspend trigger.
+  uint32_t checkinst1 = 0xf9400260 | (Thread::ThreadSuspendTriggerOffset<8>().Int32Value() << 7);
   uint32_t checkinst2 = 0xf9400000;
 
   struct ucontext *uc = reinterpret_cast<struct ucontext *>(context);
@@ -38,6 +38,7 @@
 #include "mirror/string.h"
 #include "oat_file-inl.h"
 #include "scoped_thread_state_change.h"
+#include "utf.h"
 #include "well_known_classes.h"
 
 namespace art {
@@ -183,6 +184,22 @@ uint32_t ArtMethod::FindDexMethodIndexInOtherDexFile(const DexFile& other_dexfil
   return DexFile::kDexNoIndex;
 }
 
+uint32_t ArtMethod::GetImtIndex() {
+  // Mix the hashes of the three components with distinct coefficients so that interfaces whose
+  // methods share a name (call(), run(), accept(), ...) still spread over the table. The string
+  // walks make this too slow for a dispatch fast path, but it only runs at class link time and
+  // in the interface dispatch slow paths; compiled code gets the value baked in by the compiler.
+  static constexpr uint32_t kImtIndexHashCoefficientClass = 427799u;
+  static constexpr uint32_t kImtIndexHashCoefficientName = 2919u;
+  static constexpr uint32_t kImtIndexHashCoefficientSignature = 5333u;
+  const uint32_t class_hash = ComputeModifiedUtf8Hash(GetDeclaringClassDescriptor());
+  const uint32_t name_hash = ComputeModifiedUtf8Hash(GetName());
+  const uint32_t signature_hash = ComputeModifiedUtf8Hash(GetSignature().ToString().c_str());
+  return kImtIndexHashCoefficientClass * class_hash +
+      kImtIndexHashCoefficientName * name_hash +
+      kImtIndexHashCoefficientSignature * signature_hash;
+}
+
 uint32_t ArtMethod::FindCatchBlock(Handle<mirror::Class> exception_type,
                                    uint32_t dex_pc, bool* has_no_move_exception) {
   const DexFile::CodeItem* code_item = GetCodeItem();
@@ -314,8 +331,9 @@ void ArtMethod::Invoke(Thread* self, uint32_t* args, uint32_t args_size, JValue*
 
 void ArtMethod::RegisterNative(const void* native_method, bool is_fast) {
   CHECK(IsNative()) << PrettyMethod(this);
-  CHECK(!IsFastNative()) << PrettyMethod(this);
   CHECK(native_method != nullptr) << PrettyMethod(this);
+  // Note: kAccFastNative may already be set, either from an earlier "!" registration or from the
+  // build-time FastNative annotation. It is sticky; a plain re-registration does not clear it.
   if (is_fast) {
     SetAccessFlags(GetAccessFlags() | kAccFastNative);
   }
@@ -323,7 +341,7 @@ void ArtMethod::RegisterNative(const void* native_method, bool is_fast) {
 }
 
 void ArtMethod::UnregisterNative() {
-  CHECK(IsNative() && !IsFastNative()) << PrettyMethod(this);
+  CHECK(IsNative()) << PrettyMethod(this);
   // restore stub to lookup native pointer via dlsym
   RegisterNative(GetJniDlsymLookupStub(), false);
 }
@@ -300,6 +300,25 @@ class ArtMethod FINAL {
     return (GetAccessFlags() & kAccMiranda) != 0;
   }
 
+  // Whether the class linker has ever installed an override of this method in a subclass vtable.
+  bool IsOverridden() {
+    return (GetAccessFlags() & kAccOverridden) != 0;
+  }
+
+  void SetOverridden() {
+    DCHECK(!IsStatic());
+    SetAccessFlags(GetAccessFlags() | kAccOverridden);
+  }
+
+  // Whether this method is the only implementation of its vtable slot among the classes loaded
+  // so far. Copied (default/miranda) methods are excluded since each implementing class holds
+  // its own copy, so the resolved method need not be the one in a subclass vtable even without
+  // an override. The answer can be invalidated by a later class load, so callers must guard any
+  // speculation based on it.
+  bool HasSingleImplementation() {
+    return !IsAbstract() && !IsCopied() && !IsOverridden();
+  }
+
   // Returns true if invoking this method will not throw an AbstractMethodError or
   // IncompatibleClassChangeError.
   bool IsInvokable() {
@@ -402,6 +421,13 @@ class ArtMethod FINAL {
 
   ALWAYS_INLINE uint32_t GetDexMethodIndex() SHARED_REQUIRES(Locks::mutator_lock_);
 
+  // Hash of the declaring class descriptor, name and signature used to pick the IMT slot of an
+  // interface method (modulo mirror::Class::kImtSize at the use sites). Unlike the dex method
+  // index, this does not systematically collide methods of unrelated interfaces which happen to
+  // alias modulo the table size. Must be used consistently by the class linker, the interface
+  // dispatch entrypoints and the compiler.
+  uint32_t GetImtIndex() SHARED_REQUIRES(Locks::mutator_lock_);
+
   void SetDexMethodIndex(uint32_t new_idx) {
     // Not called within a transaction.
     dex_method_index_ = new_idx;
@@ -240,6 +240,12 @@ ADD_TEST_EQ(static_cast<uint32_t>(ACCESS_FLAGS_CLASS_IS_FINALIZABLE),
 #define ACCESS_FLAGS_CLASS_IS_FINALIZABLE_BIT 31
 ADD_TEST_EQ(static_cast<uint32_t>(ACCESS_FLAGS_CLASS_IS_FINALIZABLE),
             static_cast<uint32_t>(1U << ACCESS_FLAGS_CLASS_IS_FINALIZABLE_BIT))
+// Classes with any of these access flags must take the allocation slow path: finalizable
+// classes and classes pretenured by the allocation profile. The two bits are adjacent so the
+// mask is a valid logical immediate on arm and arm64.
+#define ACCESS_FLAGS_CLASS_ALLOC_FAST_PATH_REJECT_MASK 0xC0000000
+ADD_TEST_EQ(static_cast<uint32_t>(ACCESS_FLAGS_CLASS_ALLOC_FAST_PATH_REJECT_MASK),
+            static_cast<uint32_t>(art::kAccClassIsFinalizable | art::kAccClassIsPretenured))
 
 // Array offsets.
 #define MIRROR_ARRAY_LENGTH_OFFSET      MIRROR_OBJECT_HEADER_SIZE
@@ -25,13 +25,20 @@ namespace art {
 
 Barrier::Barrier(int count)
     : count_(count),
+      last_zero_time_ns_(0u),
       lock_("GC barrier lock", kThreadSuspendCountLock),
       condition_("GC barrier condition", lock_) {
 }
 
 void Barrier::Pass(Thread* self) {
-  MutexLock mu(self, lock_);
-  SetCountLocked(self, count_ - 1);
+  if (count_.FetchAndSubSequentiallyConsistent(1) == 1) {
+    // This decrement made the count zero: hand off to the waiters. Taking the lock orders
+    // the broadcast after any waiter that saw a non-zero count has entered its wait, so the
+    // wake-up cannot be lost.
+    MaybeRecordZeroTime();
+    MutexLock mu(self, lock_);
+    condition_.Broadcast(self);
+  }
 }
 
 void Barrier::Wait(Thread* self) {
@@ -45,7 +52,11 @@ void Barrier::Init(Thread* self, int count) {
 
 void Barrier::Increment(Thread* self, int delta) {
   MutexLock mu(self, lock_);
-  SetCountLocked(self, count_ + delta);
+  // Note: the addition must be atomic since Pass() decrements the count without the lock.
+  if (count_.FetchAndAddSequentiallyConsistent(delta) + delta == 0) {
+    MaybeRecordZeroTime();
+    condition_.Broadcast(self);
+  }
 
   // Increment the count.  If it becomes zero after the increment
   // then all the threads have already passed the barrier.  If
@@ -54,21 +65,35 @@ void Barrier::Increment(Thread* self, int delta) {
   // Pass function is called by the last thread, the count will
   // be decremented to zero and a Broadcast will be made on the
   // condition variable, thus waking this up.
-  while (count_ != 0) {
+  bool waited = false;
+  while (count_.LoadSequentiallyConsistent() != 0) {
     condition_.Wait(self);
+    waited = true;
+  }
+  if (waited) {
+    MaybeLogWakeLatency();
   }
 }
 
 bool Barrier::Increment(Thread* self, int delta, uint32_t timeout_ms) {
   MutexLock mu(self, lock_);
-  SetCountLocked(self, count_ + delta);
+  // Note: the addition must be atomic since Pass() decrements the count without the lock.
+  if (count_.FetchAndAddSequentiallyConsistent(delta) + delta == 0) {
+    MaybeRecordZeroTime();
+    condition_.Broadcast(self);
+  }
   bool timed_out = false;
-  if (count_ != 0) {
+  if (count_.LoadSequentiallyConsistent() != 0) {
     uint32_t timeout_ns = 0;
     uint64_t abs_timeout = NanoTime() + MsToNs(timeout_ms);
     for (;;) {
       timed_out = condition_.TimedWait(self, timeout_ms, timeout_ns);
-      if (timed_out || count_ == 0) return timed_out;
+      if (timed_out || count_.LoadSequentiallyConsistent() == 0) {
+        if (!timed_out) {
+          MaybeLogWakeLatency();
+        }
+        return timed_out;
+      }
       // Compute time remaining on timeout.
       uint64_t now = NanoTime();
       int64_t time_left = abs_timeout - now;
@@ -81,19 +106,37 @@ bool Barrier::Increment(Thread* self, int delta, uint32_t timeout_ms) {
 }
 
 void Barrier::SetCountLocked(Thread* self, int count) {
-  count_ = count;
+  count_.StoreSequentiallyConsistent(count);
   if (count == 0) {
+    MaybeRecordZeroTime();
     condition_.Broadcast(self);
   }
 }
 
+void Barrier::MaybeRecordZeroTime() {
+  if (VLOG_IS_ON(threads)) {
+    last_zero_time_ns_.StoreRelaxed(NanoTime());
+  }
+}
+
+void Barrier::MaybeLogWakeLatency() {
+  if (VLOG_IS_ON(threads)) {
+    uint64_t zero_time_ns = last_zero_time_ns_.LoadRelaxed();
+    if (zero_time_ns != 0u) {
+      VLOG(threads) << "Barrier wake-to-run latency "
+                    << PrettyDuration(NanoTime() - zero_time_ns);
+    }
+  }
+}
+
 Barrier::~Barrier() {
   if (gAborting == 0) {
     // Only check when not aborting.
-    CHECK_EQ(count_, 0) << "Attempted to destroy barrier with non zero count";
+    CHECK_EQ(count_.LoadRelaxed(), 0) << "Attempted to destroy barrier with non zero count";
   } else {
-    if (count_ != 0) {
-      LOG(WARNING) << "Attempted to destroy barrier with non zero count " << count_;
+    if (count_.LoadRelaxed() != 0) {
+      LOG(WARNING) << "Attempted to destroy barrier with non zero count "
+                   << count_.LoadRelaxed();
     }
   }
 }
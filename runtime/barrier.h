@@ -28,6 +28,7 @@
 #define ART_RUNTIME_BARRIER_H_
 
 #include <memory>
+#include "atomic.h"
 #include "base/mutex.h"
 
 namespace art {
@@ -38,7 +39,9 @@ class Barrier {
   explicit Barrier(int count);
   virtual ~Barrier();
 
-  // Pass through the barrier, decrement the count but do not block.
+  // Pass through the barrier, decrement the count but do not block. Lock-free except for the
+  // decrement that reaches zero, so e.g. checkpointing threads arriving back-to-back do not
+  // all contend on lock_.
   void Pass(Thread* self) REQUIRES(!lock_);
 
   // Wait on the barrier, decrement the count.
@@ -64,8 +67,20 @@ class Barrier {
  private:
   void SetCountLocked(Thread* self, int count) REQUIRES(lock_);
 
-  // Counter, when this reaches 0 all people blocked on the barrier are signalled.
-  int count_ GUARDED_BY(lock_);
+  // Records the time the count hit zero, for wake-to-run latency reporting.
+  void MaybeRecordZeroTime();
+
+  // Logs how long it took this thread to run again after the count hit zero.
+  void MaybeLogWakeLatency();
+
+  // Counter, when this reaches 0 all people blocked on the barrier are signalled. Atomic so
+  // that Pass() can decrement it without taking lock_; the condition variable hand-off for
+  // the decrement that reaches zero still happens under the lock.
+  AtomicInteger count_;
+
+  // NanoTime() at the moment the count last hit zero. Only maintained when thread verbose
+  // logging is enabled, to report the wake-to-run latency of the waiters.
+  Atomic<uint64_t> last_zero_time_ns_;
 
   Mutex lock_ ACQUIRED_AFTER(Locks::abort_lock_);
   ConditionVariable condition_ GUARDED_BY(lock_);
@@ -80,16 +80,16 @@ volatile size_t g_max_bytes_used[kAllocatorTagCount];
 Atomic<uint64_t> g_total_bytes_used[kAllocatorTagCount];
 
 void Dump(std::ostream& os) {
-  if (kEnableTrackingAllocator) {
-    os << "Dumping native memory usage\n";
-    for (size_t i = 0; i < kAllocatorTagCount; ++i) {
-      uint64_t bytes_used = g_bytes_used[i].LoadRelaxed();
-      uint64_t max_bytes_used = g_max_bytes_used[i];
-      uint64_t total_bytes_used = g_total_bytes_used[i].LoadRelaxed();
-      if (total_bytes_used != 0) {
-        os << static_cast<AllocatorTag>(i) << " active=" << bytes_used << " max="
-           << max_bytes_used << " total=" << total_bytes_used << "\n";
-      }
+  // The MemMap and ArenaPool counters are maintained unconditionally, so dump whatever is
+  // non-zero even when the STL tracking allocators are compiled out.
+  os << "Dumping native memory usage\n";
+  for (size_t i = 0; i < kAllocatorTagCount; ++i) {
+    uint64_t bytes_used = g_bytes_used[i].LoadRelaxed();
+    uint64_t max_bytes_used = g_max_bytes_used[i];
+    uint64_t total_bytes_used = g_total_bytes_used[i].LoadRelaxed();
+    if (total_bytes_used != 0) {
+      os << static_cast<AllocatorTag>(i) << " active=" << bytes_used << " max="
+         << max_bytes_used << " total=" << total_bytes_used << "\n";
     }
   }
 }
@@ -71,6 +71,8 @@ enum AllocatorTag {
   kAllocatorTagOatFile,
   kAllocatorTagDexFileVerifier,
   kAllocatorTagRosAlloc,
+  kAllocatorTagMemMap,
+  kAllocatorTagArenaPool,
   kAllocatorTagCount,  // Must always be last element.
 };
 std::ostream& operator<<(std::ostream& os, const AllocatorTag& tag);
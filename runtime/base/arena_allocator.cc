@@ -19,6 +19,7 @@
 #include <numeric>
 
 #include "arena_allocator.h"
+#include "allocator.h"
 #include "logging.h"
 #include "mem_map.h"
 #include "mutex.h"
@@ -82,6 +83,7 @@ const char* const ArenaAllocatorStatsImpl<kCount>::kAllocNames[] = {
   "GraphChecker ",
   "Verifier     ",
   "CallingConv  ",
+  "Transaction  ",
 };
 
 template <bool kCount>
@@ -200,7 +202,7 @@ void Arena::Reset() {
 ArenaPool::ArenaPool(bool use_malloc, bool low_4gb, const char* name)
     : use_malloc_(use_malloc),
       lock_("Arena pool lock", kArenaPoolLock),
-      free_arenas_(nullptr),
+      free_bytes_(0u),
       low_4gb_(low_4gb),
       name_(name) {
   if (low_4gb) {
@@ -209,17 +211,37 @@ ArenaPool::ArenaPool(bool use_malloc, bool low_4gb, const char* name)
   if (!use_malloc) {
     MemMap::Init();
   }
+  std::fill_n(free_arenas_, kNumFreeListClasses, nullptr);
+  for (size_t i = 0; i < kArenaCacheSlots; ++i) {
+    arena_cache_[i].StoreRelaxed(nullptr);
+  }
 }
 
 ArenaPool::~ArenaPool() {
   ReclaimMemory();
 }
 
+size_t ArenaPool::CacheSlot(Thread* self) {
+  return (self != nullptr ? static_cast<size_t>(self->GetTid()) : 0u) % kArenaCacheSlots;
+}
+
 void ArenaPool::ReclaimMemory() {
-  while (free_arenas_ != nullptr) {
-    auto* arena = free_arenas_;
-    free_arenas_ = free_arenas_->next_;
-    delete arena;
+  for (size_t i = 0; i < kNumFreeListClasses; ++i) {
+    while (free_arenas_[i] != nullptr) {
+      auto* arena = free_arenas_[i];
+      free_arenas_[i] = free_arenas_[i]->next_;
+      TrackedAllocators::RegisterFree(kAllocatorTagArenaPool, arena->Size());
+      delete arena;
+    }
+  }
+  free_bytes_ = 0u;
+  for (size_t i = 0; i < kArenaCacheSlots; ++i) {
+    Arena* cached = arena_cache_[i].LoadRelaxed();
+    if (cached != nullptr &&
+        arena_cache_[i].CompareExchangeStrongSequentiallyConsistent(cached, nullptr)) {
+      TrackedAllocators::RegisterFree(kAllocatorTagArenaPool, cached->Size());
+      delete cached;
+    }
   }
 }
 
@@ -230,17 +252,51 @@ void ArenaPool::LockReclaimMemory() {
 
 Arena* ArenaPool::AllocArena(size_t size) {
   Thread* self = Thread::Current();
+  // Lock-free fast path: take a default-sized arena out of this thread's cache slot.
+  if (LIKELY(size <= Arena::kDefaultSize)) {
+    const size_t slot = CacheSlot(self);
+    Arena* cached = arena_cache_[slot].LoadRelaxed();
+    if (cached != nullptr &&
+        arena_cache_[slot].CompareExchangeStrongSequentiallyConsistent(cached, nullptr)) {
+      cached->Reset();
+      return cached;
+    }
+  }
   Arena* ret = nullptr;
   {
     MutexLock lock(self, lock_);
-    if (free_arenas_ != nullptr && LIKELY(free_arenas_->Size() >= size)) {
-      ret = free_arenas_;
-      free_arenas_ = free_arenas_->next_;
+    // Any arena in class i has Size() >= i * kDefaultSize, so every class from min_class up to
+    // the last guarantees a fit and only the last, mixed-size class needs a size check. This
+    // keeps over-sized requests (e.g. the verifier of a method with many registers) from
+    // allocating a fresh arena every time while reusable ones sit on the list.
+    const size_t min_class =
+        std::min((size + Arena::kDefaultSize - 1) / Arena::kDefaultSize, kNumFreeListClasses - 1);
+    for (size_t i = min_class; i < kNumFreeListClasses && ret == nullptr; ++i) {
+      if (i + 1u < kNumFreeListClasses) {
+        ret = free_arenas_[i];
+        if (ret != nullptr) {
+          free_arenas_[i] = ret->next_;
+        }
+      } else {
+        Arena** prev_next = &free_arenas_[i];
+        for (Arena* arena = free_arenas_[i]; arena != nullptr; arena = arena->next_) {
+          if (arena->Size() >= size) {
+            ret = arena;
+            *prev_next = arena->next_;
+            break;
+          }
+          prev_next = &arena->next_;
+        }
+      }
+    }
+    if (ret != nullptr) {
+      free_bytes_ -= ret->Size();
     }
   }
   if (ret == nullptr) {
     ret = use_malloc_ ? static_cast<Arena*>(new MallocArena(size)) :
         new MemMapArena(size, low_4gb_, name_);
+    TrackedAllocators::RegisterAllocation(kAllocatorTagArenaPool, ret->Size());
   }
   ret->Reset();
   return ret;
@@ -251,8 +307,21 @@ void ArenaPool::TrimMaps() {
     ScopedTrace trace(__PRETTY_FUNCTION__);
     // Doesn't work for malloc.
     MutexLock lock(Thread::Current(), lock_);
-    for (auto* arena = free_arenas_; arena != nullptr; arena = arena->next_) {
-      arena->Release();
+    // Pull cached arenas back onto the free lists so that they get released too.
+    for (size_t i = 0; i < kArenaCacheSlots; ++i) {
+      Arena* cached = arena_cache_[i].LoadRelaxed();
+      if (cached != nullptr &&
+          arena_cache_[i].CompareExchangeStrongSequentiallyConsistent(cached, nullptr)) {
+        const size_t idx = std::min(cached->Size() / Arena::kDefaultSize, kNumFreeListClasses - 1);
+        cached->next_ = free_arenas_[idx];
+        free_arenas_[idx] = cached;
+        free_bytes_ += cached->Size();
+      }
+    }
+    for (size_t i = 0; i < kNumFreeListClasses; ++i) {
+      for (auto* arena = free_arenas_[i]; arena != nullptr; arena = arena->next_) {
+        arena->Release();
+      }
     }
   }
 }
@@ -260,8 +329,10 @@ void ArenaPool::TrimMaps() {
 size_t ArenaPool::GetBytesAllocated() const {
   size_t total = 0;
   MutexLock lock(Thread::Current(), lock_);
-  for (Arena* arena = free_arenas_; arena != nullptr; arena = arena->next_) {
-    total += arena->GetBytesAllocated();
+  for (size_t i = 0; i < kNumFreeListClasses; ++i) {
+    for (Arena* arena = free_arenas_[i]; arena != nullptr; arena = arena->next_) {
+      total += arena->GetBytesAllocated();
+    }
   }
   return total;
 }
@@ -272,15 +343,38 @@ void ArenaPool::FreeArenaChain(Arena* first) {
       MEMORY_TOOL_MAKE_UNDEFINED(arena->memory_, arena->bytes_allocated_);
     }
   }
-  if (first != nullptr) {
-    Arena* last = first;
-    while (last->next_ != nullptr) {
-      last = last->next_;
+  // Lock-free fast path: park one default-sized arena in this thread's cache slot.
+  if (first != nullptr && first->Size() == Arena::kDefaultSize) {
+    const size_t slot = CacheSlot(Thread::Current());
+    if (arena_cache_[slot].LoadRelaxed() == nullptr) {
+      Arena* cached = first;
+      Arena* rest = cached->next_;
+      // Unlink before publishing so that the next taker never sees a stale chain.
+      cached->next_ = nullptr;
+      if (arena_cache_[slot].CompareExchangeStrongSequentiallyConsistent(nullptr, cached)) {
+        first = rest;
+      } else {
+        cached->next_ = rest;
+      }
     }
+  }
+  if (first != nullptr) {
     Thread* self = Thread::Current();
     MutexLock lock(self, lock_);
-    last->next_ = free_arenas_;
-    free_arenas_ = first;
+    while (first != nullptr) {
+      Arena* arena = first;
+      first = first->next_;
+      if (free_bytes_ + arena->Size() > kMaxFreeBytes) {
+        // Over the retention cap, give the memory back to the system.
+        TrackedAllocators::RegisterFree(kAllocatorTagArenaPool, arena->Size());
+        delete arena;
+      } else {
+        free_bytes_ += arena->Size();
+        const size_t idx = std::min(arena->Size() / Arena::kDefaultSize, kNumFreeListClasses - 1);
+        arena->next_ = free_arenas_[idx];
+        free_arenas_[idx] = arena;
+      }
+    }
   }
 }
 
@@ -20,6 +20,7 @@
 #include <stdint.h>
 #include <stddef.h>
 
+#include "atomic.h"
 #include "base/bit_utils.h"
 #include "base/memory_tool.h"
 #include "debug_stack.h"
@@ -93,6 +94,7 @@ enum ArenaAllocKind {
   kArenaAllocGraphChecker,
   kArenaAllocVerifier,
   kArenaAllocCallingConvention,
+  kArenaAllocTransaction,
   kNumArenaAllocKinds
 };
 
@@ -272,9 +274,25 @@ class ArenaPool {
   void TrimMaps() REQUIRES(!lock_);
 
  private:
+  // Free arenas are binned by multiples of Arena::kDefaultSize so that the common default-sized
+  // request pops the head of its class instead of scanning a mixed list. The last class holds
+  // all larger arenas and is the only one that needs a fit check.
+  static constexpr size_t kNumFreeListClasses = 8;
+  // Cap on total retained free arena bytes; arenas beyond the cap go back to the system.
+  static constexpr size_t kMaxFreeBytes = 32 * MB;
+  // Small hashed cache of default-sized arenas that threads exchange with compare-and-swap,
+  // so that the common alloc/free pattern skips lock_ entirely.
+  static constexpr size_t kArenaCacheSlots = 16;
+
+  // Cache slot of the calling thread.
+  static size_t CacheSlot(Thread* self);
+
   const bool use_malloc_;
   mutable Mutex lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
-  Arena* free_arenas_ GUARDED_BY(lock_);
+  Arena* free_arenas_[kNumFreeListClasses] GUARDED_BY(lock_);
+  // Total size of the arenas on the free lists, excluding the cache slots.
+  size_t free_bytes_ GUARDED_BY(lock_);
+  Atomic<Arena*> arena_cache_[kArenaCacheSlots];
   const bool low_4gb_;
   const char* name_;
   DISALLOW_COPY_AND_ASSIGN(ArenaPool);
@@ -158,15 +158,16 @@ bool BitVector::Union(const BitVector* src) {
     DCHECK_LT(static_cast<uint32_t> (highest_bit), storage_size_ * kWordBits);
   }
 
+  // Accumulate the newly set bits instead of branching per word, so that the compiler can
+  // vectorize the loop; liveness fix-points call this for every block until stabilization.
+  uint32_t added_bits = 0u;
   for (uint32_t idx = 0; idx < src_size; idx++) {
     uint32_t existing = storage_[idx];
     uint32_t update = existing | src->GetRawStorageWord(idx);
-    if (existing != update) {
-      changed = true;
-      storage_[idx] = update;
-    }
+    added_bits |= update & ~existing;
+    storage_[idx] = update;
   }
-  return changed;
+  return changed || (added_bits != 0u);
 }
 
 bool BitVector::UnionIfNotIn(const BitVector* union_with, const BitVector* not_in) {
@@ -192,26 +193,24 @@ bool BitVector::UnionIfNotIn(const BitVector* union_with, const BitVector* not_i
 
   uint32_t not_in_size = not_in->GetStorageSize();
 
+  // As in Union(), accumulate the newly set bits so that the loops vectorize.
+  uint32_t added_bits = 0u;
   uint32_t idx = 0;
   for (; idx < std::min(not_in_size, union_with_size); idx++) {
     uint32_t existing = storage_[idx];
     uint32_t update = existing |
         (union_with->GetRawStorageWord(idx) & ~not_in->GetRawStorageWord(idx));
-    if (existing != update) {
-      changed = true;
-      storage_[idx] = update;
-    }
+    added_bits |= update & ~existing;
+    storage_[idx] = update;
   }
 
   for (; idx < union_with_size; idx++) {
     uint32_t existing = storage_[idx];
     uint32_t update = existing | union_with->GetRawStorageWord(idx);
-    if (existing != update) {
-      changed = true;
-      storage_[idx] = update;
-    }
+    added_bits |= update & ~existing;
+    storage_[idx] = update;
   }
-  return changed;
+  return changed || (added_bits != 0u);
 }
 
 void BitVector::Subtract(const BitVector *src) {
@@ -372,4 +371,43 @@ Allocator* BitVector::GetAllocator() const {
   return allocator_;
 }
 
+BitVector::RankIndex::RankIndex(const BitVector* bit_vector, Allocator* allocator)
+  : bit_storage_(bit_vector->GetRawStorage()),
+    storage_size_(bit_vector->GetStorageSize()),
+    block_ranks_(nullptr),
+    allocator_(allocator) {
+  // One entry per block boundary, including the one at storage_size_ so that a query for the
+  // last full block does not index out of bounds.
+  uint32_t num_entries = storage_size_ / kBlockWords + 1u;
+  block_ranks_ = static_cast<uint32_t*>(allocator_->Alloc(num_entries * sizeof(uint32_t)));
+  uint32_t count = 0u;
+  for (uint32_t word = 0u; word < storage_size_; word++) {
+    if ((word % kBlockWords) == 0u) {
+      block_ranks_[word / kBlockWords] = count;
+    }
+    count += POPCOUNT(bit_storage_[word]);
+  }
+  if ((storage_size_ % kBlockWords) == 0u) {
+    block_ranks_[storage_size_ / kBlockWords] = count;
+  }
+}
+
+BitVector::RankIndex::~RankIndex() {
+  allocator_->Free(block_ranks_);
+}
+
+uint32_t BitVector::RankIndex::NumSetBitsBefore(uint32_t end) const {
+  DCHECK_LE(end, storage_size_ * kWordBits);
+  uint32_t word_end = WordIndex(end);
+  uint32_t count = block_ranks_[word_end / kBlockWords];
+  for (uint32_t word = word_end - (word_end % kBlockWords); word < word_end; word++) {
+    count += POPCOUNT(bit_storage_[word]);
+  }
+  uint32_t partial_word_bits = end & 0x1f;
+  if (partial_word_bits != 0u) {
+    count += POPCOUNT(bit_storage_[word_end] & ~(0xffffffffu << partial_word_bits));
+  }
+  return count;
+}
+
 }  // namespace art
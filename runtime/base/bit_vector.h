@@ -111,6 +111,37 @@ class BitVector {
     const BitVector* const bit_vector_;
   };
 
+  /**
+   * @brief Rank acceleration for a BitVector whose contents no longer change.
+   *
+   * @details Caches the cumulative popcount at every block of kBlockWords storage words,
+   * so NumSetBitsBefore(n) ("number of set bits in [0, n)") reads one cached entry and
+   * popcounts at most kBlockWords words, independent of the vector length. The index is a
+   * snapshot: it does not track later modifications of the indexed vector and must then
+   * be rebuilt by constructing a new instance.
+   */
+  class RankIndex {
+   public:
+    RankIndex(const BitVector* bit_vector, Allocator* allocator);
+
+    ~RankIndex();
+
+    RankIndex(const RankIndex& other) = delete;
+    RankIndex& operator=(const RankIndex& other) = delete;
+
+    // Count the number of bits that are set in range [0, end).
+    uint32_t NumSetBitsBefore(uint32_t end) const;
+
+   private:
+    // Words per cached block; 256-bit blocks cost one index word per eight storage words.
+    static constexpr uint32_t kBlockWords = 8;
+
+    const uint32_t* const bit_storage_;
+    const uint32_t storage_size_;   // Size of the indexed vector in words.
+    uint32_t* block_ranks_;         // Number of set bits before each block boundary.
+    Allocator* const allocator_;
+  };
+
   // MoveConstructible but not MoveAssignable, CopyConstructible or CopyAssignable.
 
   BitVector(const BitVector& other) = delete;
@@ -167,6 +167,22 @@ TEST(BitVector, UnionIfNotIn) {
   }
 }
 
+TEST(BitVector, RankIndex) {
+  const uint32_t kBits = 1000;
+  BitVector bv(kBits, false, Allocator::GetMallocAllocator());
+  // Set a pattern that crosses block boundaries irregularly.
+  for (uint32_t i = 0; i < kBits; i += 3) {
+    bv.SetBit(i);
+  }
+  bv.SetBit(kBits - 1);
+  BitVector::RankIndex rank_index(&bv, Allocator::GetMallocAllocator());
+  for (uint32_t end = 0; end <= kBits; ++end) {
+    EXPECT_EQ(bv.NumSetBits(end), rank_index.NumSetBitsBefore(end)) << end;
+  }
+  // Query at the very top of the storage, including the padding bits.
+  EXPECT_EQ(bv.NumSetBits(), rank_index.NumSetBitsBefore(bv.GetStorageSize() * 32u));
+}
+
 TEST(BitVector, Subset) {
   {
     BitVector first(2, true, Allocator::GetMallocAllocator());
@@ -0,0 +1,140 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "concurrent_histogram.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "bit_utils.h"
+#include "logging.h"
+#include "thread-inl.h"
+
+namespace art {
+
+constexpr size_t ConcurrentHistogram::kSubBucketBits;
+constexpr size_t ConcurrentHistogram::kSubBucketCount;
+constexpr size_t ConcurrentHistogram::kNumBuckets;
+constexpr size_t ConcurrentHistogram::kNumStripes;
+
+ConcurrentHistogram::ConcurrentHistogram(const char* name) : name_(name) {
+  Reset();
+}
+
+size_t ConcurrentHistogram::BucketIndex(uint64_t value) {
+  if (value < 2 * kSubBucketCount) {
+    return static_cast<size_t>(value);
+  }
+  const size_t msb = static_cast<size_t>(MostSignificantBit(value));
+  const size_t shift = msb - kSubBucketBits;
+  const size_t sub = static_cast<size_t>(value >> shift) - kSubBucketCount;
+  return (msb - kSubBucketBits + 1) * kSubBucketCount + sub;
+}
+
+uint64_t ConcurrentHistogram::BucketStart(size_t index) {
+  DCHECK_LT(index, kNumBuckets);
+  if (index < 2 * kSubBucketCount) {
+    return index;
+  }
+  const size_t group = index / kSubBucketCount - 1;
+  const uint64_t sub = index % kSubBucketCount;
+  return (kSubBucketCount + sub) << group;
+}
+
+uint64_t ConcurrentHistogram::BucketEnd(size_t index) {
+  DCHECK_LT(index, kNumBuckets);
+  return (index + 1 < kNumBuckets) ? BucketStart(index + 1) - 1
+                                   : std::numeric_limits<uint64_t>::max();
+}
+
+size_t ConcurrentHistogram::StripeIndex() {
+  Thread* self = Thread::Current();
+  return (self != nullptr ? static_cast<size_t>(self->GetTid()) : 0u) % kNumStripes;
+}
+
+void ConcurrentHistogram::AddValue(uint64_t value) {
+  const size_t stripe = StripeIndex();
+  counts_[stripe][BucketIndex(value)].FetchAndAddRelaxed(1u);
+  sums_[stripe].FetchAndAddRelaxed(value);
+  uint64_t prev_max = max_.LoadRelaxed();
+  while (value > prev_max && !max_.CompareExchangeWeakRelaxed(prev_max, value)) {
+    prev_max = max_.LoadRelaxed();
+  }
+}
+
+uint64_t ConcurrentHistogram::Percentile(double per) const {
+  DCHECK_GE(per, 0.0);
+  DCHECK_LE(per, 1.0);
+  uint64_t merged[kNumBuckets];
+  uint64_t total = 0u;
+  for (size_t bucket = 0; bucket < kNumBuckets; ++bucket) {
+    uint64_t count = 0u;
+    for (size_t stripe = 0; stripe < kNumStripes; ++stripe) {
+      count += counts_[stripe][bucket].LoadRelaxed();
+    }
+    merged[bucket] = count;
+    total += count;
+  }
+  if (total == 0u) {
+    return 0u;
+  }
+  uint64_t rank = static_cast<uint64_t>(per * total + 0.5);
+  rank = std::max<uint64_t>(1u, std::min(rank, total));
+  uint64_t cumulative = 0u;
+  for (size_t bucket = 0; bucket < kNumBuckets; ++bucket) {
+    cumulative += merged[bucket];
+    if (cumulative >= rank) {
+      // Clamp by the exact max so that top percentiles never exceed an observed value.
+      return std::min(BucketEnd(bucket), Max());
+    }
+  }
+  return Max();
+}
+
+uint64_t ConcurrentHistogram::SampleSize() const {
+  uint64_t total = 0u;
+  for (size_t stripe = 0; stripe < kNumStripes; ++stripe) {
+    for (size_t bucket = 0; bucket < kNumBuckets; ++bucket) {
+      total += counts_[stripe][bucket].LoadRelaxed();
+    }
+  }
+  return total;
+}
+
+uint64_t ConcurrentHistogram::Sum() const {
+  uint64_t total = 0u;
+  for (size_t stripe = 0; stripe < kNumStripes; ++stripe) {
+    total += sums_[stripe].LoadRelaxed();
+  }
+  return total;
+}
+
+double ConcurrentHistogram::Mean() const {
+  const uint64_t size = SampleSize();
+  return size != 0u ? static_cast<double>(Sum()) / size : 0.0;
+}
+
+void ConcurrentHistogram::Reset() {
+  for (size_t stripe = 0; stripe < kNumStripes; ++stripe) {
+    for (size_t bucket = 0; bucket < kNumBuckets; ++bucket) {
+      counts_[stripe][bucket].StoreRelaxed(0u);
+    }
+    sums_[stripe].StoreRelaxed(0u);
+  }
+  max_.StoreRelaxed(0u);
+}
+
+}  // namespace art
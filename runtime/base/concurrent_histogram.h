@@ -0,0 +1,91 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef ART_RUNTIME_BASE_CONCURRENT_HISTOGRAM_H_
+#define ART_RUNTIME_BASE_CONCURRENT_HISTOGRAM_H_
+
+#include <string>
+
+#include "atomic.h"
+#include "base/macros.h"
+
+namespace art {
+
+// Histogram that can be recorded to from multiple threads without external locking, for data
+// such as GC stalls that we want to capture in production builds. Unlike Histogram<>, buckets
+// are log-scaled: every power of two is split into kSubBucketCount linear sub-buckets, which
+// bounds the relative error of a reported percentile by 1 / kSubBucketCount while covering the
+// full uint64_t range, so tail percentiles (p99, p999) stay accurate without growing buckets.
+// Each counter is striped by thread id so that concurrent recorders rarely share a cache line;
+// readers merge the stripes. Reads are not atomic with respect to concurrent recording, but
+// every sample is counted exactly once.
+class ConcurrentHistogram {
+ public:
+  explicit ConcurrentHistogram(const char* name);
+
+  // Lock-free and wait-free apart from the max update; safe to call from any thread.
+  void AddValue(uint64_t value);
+
+  // Estimate of the percentile value, per in [0.0, 1.0]. The returned value is the inclusive
+  // upper bound of the bucket holding the requested rank, so the estimate never under-reports
+  // by more than one sample and over-reports by at most 1 / kSubBucketCount relative error.
+  uint64_t Percentile(double per) const;
+
+  uint64_t SampleSize() const;
+  uint64_t Sum() const;
+  double Mean() const;
+
+  uint64_t Max() const {
+    return max_.LoadRelaxed();
+  }
+
+  // Not safe with respect to concurrent AddValue calls; values recorded while resetting may be
+  // partially lost. Intended for the same explicit reset points as Histogram<>::Reset.
+  void Reset();
+
+  const std::string& Name() const {
+    return name_;
+  }
+
+ private:
+  // Number of linear sub-buckets per power of two. 16 gives at most 6.25% relative error.
+  static constexpr size_t kSubBucketBits = 4;
+  static constexpr size_t kSubBucketCount = 1u << kSubBucketBits;
+  // Values [0, 2 * kSubBucketCount) get exact buckets, then kSubBucketCount buckets per
+  // remaining power of two up to the top bit of uint64_t.
+  static constexpr size_t kNumBuckets = (64 - kSubBucketBits + 1) * kSubBucketCount;
+  // Counter stripes, indexed by thread id, to spread concurrent recorders.
+  static constexpr size_t kNumStripes = 4;
+
+  static size_t BucketIndex(uint64_t value);
+  // Smallest value mapping to the bucket.
+  static uint64_t BucketStart(size_t index);
+  // Largest value mapping to the bucket.
+  static uint64_t BucketEnd(size_t index);
+  static size_t StripeIndex();
+
+  const std::string name_;
+  Atomic<uint64_t> counts_[kNumStripes][kNumBuckets];
+  Atomic<uint64_t> sums_[kNumStripes];
+  Atomic<uint64_t> max_;
+
+  friend class ConcurrentHistogramTest;
+
+  DISALLOW_COPY_AND_ASSIGN(ConcurrentHistogram);
+};
+
+}  // namespace art
+
+#endif  // ART_RUNTIME_BASE_CONCURRENT_HISTOGRAM_H_
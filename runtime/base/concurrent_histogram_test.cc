@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "concurrent_histogram.h"
+
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace art {
+
+TEST(ConcurrentHistogramTest, BasicStats) {
+  ConcurrentHistogram hist("Test");
+  for (uint64_t i = 1; i <= 1000; ++i) {
+    hist.AddValue(i);
+  }
+  EXPECT_EQ(1000u, hist.SampleSize());
+  EXPECT_EQ(500500u, hist.Sum());
+  EXPECT_DOUBLE_EQ(500.5, hist.Mean());
+  EXPECT_EQ(1000u, hist.Max());
+}
+
+TEST(ConcurrentHistogramTest, PercentileAccuracy) {
+  ConcurrentHistogram hist("Test");
+  for (uint64_t i = 1; i <= 1000; ++i) {
+    hist.AddValue(i);
+  }
+  // Log-scaled buckets bound the relative over-estimate by 1/16; the estimate never
+  // under-reports the true percentile value.
+  const uint64_t p50 = hist.Percentile(0.5);
+  EXPECT_GE(p50, 500u);
+  EXPECT_LE(p50, 500u + 500u / 16u + 1u);
+  const uint64_t p99 = hist.Percentile(0.99);
+  EXPECT_GE(p99, 990u);
+  EXPECT_LE(p99, 1000u);  // Clamped by the exact max.
+  EXPECT_EQ(1000u, hist.Percentile(1.0));
+}
+
+TEST(ConcurrentHistogramTest, ConcurrentRecording) {
+  ConcurrentHistogram hist("Test");
+  static constexpr size_t kNumThreads = 4;
+  static constexpr uint64_t kValuesPerThread = 10000;
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < kNumThreads; ++t) {
+    threads.emplace_back([&hist]() {
+      for (uint64_t i = 1; i <= kValuesPerThread; ++i) {
+        hist.AddValue(i);
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(kNumThreads * kValuesPerThread, hist.SampleSize());
+  EXPECT_EQ(kNumThreads * kValuesPerThread * (kValuesPerThread + 1) / 2, hist.Sum());
+  EXPECT_EQ(kValuesPerThread, hist.Max());
+}
+
+TEST(ConcurrentHistogramTest, Reset) {
+  ConcurrentHistogram hist("Test");
+  hist.AddValue(42);
+  hist.Reset();
+  EXPECT_EQ(0u, hist.SampleSize());
+  EXPECT_EQ(0u, hist.Sum());
+  EXPECT_EQ(0u, hist.Max());
+  EXPECT_EQ(0u, hist.Percentile(0.99));
+}
+
+}  // namespace art
@@ -17,12 +17,17 @@
 #ifndef ART_RUNTIME_BASE_HASH_SET_H_
 #define ART_RUNTIME_BASE_HASH_SET_H_
 
+#include <algorithm>
 #include <functional>
 #include <iterator>
 #include <memory>
 #include <stdint.h>
 #include <utility>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 #include "bit_utils.h"
 #include "logging.h"
 
@@ -56,8 +61,13 @@ class DefaultEmptyFn<T*> {
 // EmptyFn needs to implement two functions MakeEmpty(T& item) and IsEmpty(const T& item).
 // TODO: We could get rid of this requirement by using a bitmap, though maybe this would be slower
 // and more complicated.
+// If kStoreHashTags is set, the set additionally keeps a contiguous array of 1-byte hash tags
+// (top bits of the element hash, 0 meaning empty) and probes a group of tags per compare during
+// lookup, so misses are rejected without touching the element array or calling Pred. This costs
+// one byte per bucket and is worthwhile for hot sets with expensive predicates (e.g. descriptor
+// comparison); the serialized format is unchanged, tags are rebuilt when reading from memory.
 template <class T, class EmptyFn = DefaultEmptyFn<T>, class HashFn = std::hash<T>,
-    class Pred = std::equal_to<T>, class Alloc = std::allocator<T>>
+    class Pred = std::equal_to<T>, class Alloc = std::allocator<T>, bool kStoreHashTags = false>
 class HashSet {
   template <class Elem, class HashSetType>
   class BaseIterator : std::iterator<std::forward_iterator_tag, Elem> {
@@ -131,6 +141,11 @@ class HashSet {
   static constexpr double kDefaultMaxLoadFactor = 0.7;
   static constexpr size_t kMinBuckets = 1000;
 
+  // Tag probing (kStoreHashTags) constants. With SSE2 a whole group is compared per instruction,
+  // otherwise the group is scanned a byte at a time (still cheaper than touching the elements).
+  static constexpr uint8_t kEmptyTag = 0u;
+  static constexpr size_t kTagGroupSize = 16u;
+
   // If we don't own the data, this will create a new array which owns the data.
   void Clear() {
     DeallocateStorage();
@@ -146,6 +161,7 @@ class HashSet {
         elements_until_expand_(0u),
         owns_data_(false),
         data_(nullptr),
+        tags_(nullptr),
         min_load_factor_(min_load_factor),
         max_load_factor_(max_load_factor) {
     DCHECK_GT(min_load_factor, 0.0);
@@ -162,6 +178,7 @@ class HashSet {
         elements_until_expand_(0u),
         owns_data_(false),
         data_(nullptr),
+        tags_(nullptr),
         min_load_factor_(kDefaultMinLoadFactor),
         max_load_factor_(kDefaultMaxLoadFactor) {
   }
@@ -176,12 +193,16 @@ class HashSet {
         elements_until_expand_(other.elements_until_expand_),
         owns_data_(false),
         data_(nullptr),
+        tags_(nullptr),
         min_load_factor_(other.min_load_factor_),
         max_load_factor_(other.max_load_factor_) {
     AllocateStorage(other.NumBuckets());
     for (size_t i = 0; i < num_buckets_; ++i) {
       ElementForIndex(i) = other.data_[i];
     }
+    if (kStoreHashTags) {
+      std::copy_n(other.tags_, num_buckets_, tags_);
+    }
   }
 
   // noexcept required so that the move constructor is used instead of copy constructor.
@@ -196,6 +217,7 @@ class HashSet {
         elements_until_expand_(other.elements_until_expand_),
         owns_data_(other.owns_data_),
         data_(other.data_),
+        tags_(other.tags_),
         min_load_factor_(other.min_load_factor_),
         max_load_factor_(other.max_load_factor_) {
     other.num_elements_ = 0u;
@@ -203,12 +225,14 @@ class HashSet {
     other.elements_until_expand_ = 0u;
     other.owns_data_ = false;
     other.data_ = nullptr;
+    other.tags_ = nullptr;
   }
 
   // Construct from existing data.
   // Read from a block of memory, if make_copy_of_data is false, then data_ points to within the
   // passed in ptr_.
   HashSet(const uint8_t* ptr, bool make_copy_of_data, size_t* read_count) noexcept {
+    tags_ = nullptr;
     uint64_t temp;
     size_t offset = 0;
     offset = ReadFromBytes(ptr, offset, &temp);
@@ -232,6 +256,10 @@ class HashSet {
         offset = ReadFromBytes(ptr, offset, &data_[i]);
       }
     }
+    if (kStoreHashTags) {
+      // The serialized format has no tags, rebuild them from the elements.
+      BuildTags();
+    }
     // Caller responsible for aligning.
     *read_count = offset;
   }
@@ -325,6 +353,9 @@ class HashSet {
       // If the next element is empty, we are done. Make sure to clear the current empty index.
       if (emptyfn_.IsEmpty(next_element)) {
         emptyfn_.MakeEmpty(ElementForIndex(empty_index));
+        if (kStoreHashTags) {
+          tags_[empty_index] = kEmptyTag;
+        }
         break;
       }
       // Otherwise try to see if the next element can fill the current empty index.
@@ -347,6 +378,9 @@ class HashSet {
         // If the target index isn't within our current range it must have been probed from before
         // the empty index.
         ElementForIndex(empty_index) = std::move(next_element);
+        if (kStoreHashTags) {
+          tags_[empty_index] = tags_[next_index];
+        }
         filled = true;  // TODO: Optimize
         empty_index = next_index;
       }
@@ -396,6 +430,9 @@ class HashSet {
     }
     const size_t index = FirstAvailableSlot(IndexForHash(hash));
     data_[index] = element;
+    if (kStoreHashTags) {
+      tags_[index] = TagForHash(hash);
+    }
     ++num_elements_;
   }
 
@@ -411,6 +448,7 @@ class HashSet {
     swap(emptyfn_, other.emptyfn_);
     swap(pred_, other.pred_);
     std::swap(data_, other.data_);
+    std::swap(tags_, other.tags_);
     std::swap(num_buckets_, other.num_buckets_);
     std::swap(num_elements_, other.num_elements_);
     std::swap(elements_until_expand_, other.elements_until_expand_);
@@ -555,6 +593,9 @@ class HashSet {
       return 0;
     }
     DCHECK_EQ(hashfn_(element), hash);
+    if (kStoreHashTags) {
+      return FindIndexWithTags(element, hash);
+    }
     size_t index = IndexForHash(hash);
     while (true) {
       const T& slot = ElementForIndex(index);
@@ -568,10 +609,87 @@ class HashSet {
     }
   }
 
+  // Tag-probing lookup: scan a group of hash tags per compare and only call Pred on slots whose
+  // tag matches. Visits slots in the same order as the plain linear probe, so the first match
+  // and the stop-at-first-empty semantics are identical.
+  template <typename K>
+  size_t FindIndexWithTags(const K& element, size_t hash) const {
+    const uint8_t tag = TagForHash(hash);
+    size_t index = IndexForHash(hash);
+    while (true) {
+      const size_t group_len = std::min(static_cast<size_t>(kTagGroupSize), num_buckets_ - index);
+      uint32_t match_mask;
+      uint32_t empty_mask;
+      TagGroupMasks(&tags_[index], group_len, tag, &match_mask, &empty_mask);
+      if (empty_mask != 0u) {
+        // Slots at or past the first empty slot cannot hold the element.
+        match_mask &= (1u << CTZ(empty_mask)) - 1u;
+      }
+      while (match_mask != 0u) {
+        const size_t candidate = index + CTZ(match_mask);
+        if (pred_(ElementForIndex(candidate), element)) {
+          return candidate;
+        }
+        match_mask &= match_mask - 1u;
+      }
+      if (empty_mask != 0u) {
+        return NumBuckets();
+      }
+      index += group_len;
+      if (index == num_buckets_) {
+        index = 0;
+      }
+    }
+  }
+
   bool IsFreeSlot(size_t index) const {
     return emptyfn_.IsEmpty(ElementForIndex(index));
   }
 
+  // One byte hash tag per bucket: kEmptyTag for empty slots, otherwise 7 hash-derived bits with
+  // the high bit set so that a full slot never looks empty. The hash is remixed first since some
+  // of our hash functions only produce 32 significant bits and the bucket index already consumes
+  // the low bits.
+  static uint8_t TagForHash(size_t hash) {
+    const uint32_t mixed = static_cast<uint32_t>(hash) * 0x9E3779B9u;  // 2^32 / golden ratio.
+    return static_cast<uint8_t>(0x80u | (mixed >> 25));
+  }
+
+  // Compute bit masks of the tags in [tags, tags + len) that match `tag` or are empty.
+  // `len` is at most kTagGroupSize; bit i of a mask corresponds to tags[i].
+  static void TagGroupMasks(const uint8_t* tags, size_t len, uint8_t tag,
+                            uint32_t* match_mask, uint32_t* empty_mask) {
+#if defined(__SSE2__)
+    if (LIKELY(len == kTagGroupSize)) {
+      const __m128i group = _mm_loadu_si128(reinterpret_cast<const __m128i*>(tags));
+      const __m128i match = _mm_cmpeq_epi8(group, _mm_set1_epi8(static_cast<char>(tag)));
+      *match_mask = static_cast<uint32_t>(_mm_movemask_epi8(match));
+      *empty_mask = static_cast<uint32_t>(_mm_movemask_epi8(
+          _mm_cmpeq_epi8(group, _mm_setzero_si128())));
+      return;
+    }
+#endif
+    uint32_t match = 0u;
+    uint32_t empty = 0u;
+    for (size_t i = 0; i < len; ++i) {
+      match |= (tags[i] == tag ? 1u : 0u) << i;
+      empty |= (tags[i] == kEmptyTag ? 1u : 0u) << i;
+    }
+    *match_mask = match;
+    *empty_mask = empty;
+  }
+
+  // Rebuild the tag array from the elements, used after loading serialized data.
+  void BuildTags() {
+    DCHECK(kStoreHashTags);
+    delete[] tags_;
+    tags_ = new uint8_t[num_buckets_];
+    for (size_t i = 0; i < num_buckets_; ++i) {
+      const T& element = data_[i];
+      tags_[i] = emptyfn_.IsEmpty(element) ? kEmptyTag : TagForHash(hashfn_(element));
+    }
+  }
+
   // Allocate a number of buckets.
   void AllocateStorage(size_t num_buckets) {
     num_buckets_ = num_buckets;
@@ -581,6 +699,10 @@ class HashSet {
       allocfn_.construct(allocfn_.address(data_[i]));
       emptyfn_.MakeEmpty(data_[i]);
     }
+    if (kStoreHashTags) {
+      tags_ = new uint8_t[num_buckets_];
+      std::fill_n(tags_, num_buckets_, static_cast<uint8_t>(kEmptyTag));
+    }
   }
 
   void DeallocateStorage() {
@@ -594,6 +716,9 @@ class HashSet {
       owns_data_ = false;
     }
     data_ = nullptr;
+    // The tags are owned even when the element data is not.
+    delete[] tags_;
+    tags_ = nullptr;
     num_buckets_ = 0;
   }
 
@@ -611,6 +736,8 @@ class HashSet {
     }
     DCHECK_GE(new_size, Size());
     T* const old_data = data_;
+    uint8_t* const old_tags = tags_;
+    tags_ = nullptr;
     size_t old_num_buckets = num_buckets_;
     // Reinsert all of the old elements.
     const bool owned_data = owns_data_;
@@ -618,7 +745,12 @@ class HashSet {
     for (size_t i = 0; i < old_num_buckets; ++i) {
       T& element = old_data[i];
       if (!emptyfn_.IsEmpty(element)) {
-        data_[FirstAvailableSlot(IndexForHash(hashfn_(element)))] = std::move(element);
+        const size_t hash = hashfn_(element);
+        const size_t index = FirstAvailableSlot(IndexForHash(hash));
+        data_[index] = std::move(element);
+        if (kStoreHashTags) {
+          tags_[index] = TagForHash(hash);
+        }
       }
       if (owned_data) {
         allocfn_.destroy(allocfn_.address(element));
@@ -627,6 +759,7 @@ class HashSet {
     if (owned_data) {
       allocfn_.deallocate(old_data, old_num_buckets);
     }
+    delete[] old_tags;
 
     // When we hit elements_until_expand_, we are at the max load factor and must expand again.
     elements_until_expand_ = NumBuckets() * max_load_factor_;
@@ -670,13 +803,14 @@ class HashSet {
   size_t elements_until_expand_;  // Maximum number of elements until we expand the table.
   bool owns_data_;  // If we own data_ and are responsible for freeing it.
   T* data_;  // Backing storage.
+  uint8_t* tags_;  // One hash tag per bucket, nullptr unless kStoreHashTags. Always owned.
   double min_load_factor_;
   double max_load_factor_;
 };
 
-template <class T, class EmptyFn, class HashFn, class Pred, class Alloc>
-void swap(HashSet<T, EmptyFn, HashFn, Pred, Alloc>& lhs,
-          HashSet<T, EmptyFn, HashFn, Pred, Alloc>& rhs) {
+template <class T, class EmptyFn, class HashFn, class Pred, class Alloc, bool kStoreHashTags>
+void swap(HashSet<T, EmptyFn, HashFn, Pred, Alloc, kStoreHashTags>& lhs,
+          HashSet<T, EmptyFn, HashFn, Pred, Alloc, kStoreHashTags>& rhs) {
   lhs.swap(rhs);
 }
 
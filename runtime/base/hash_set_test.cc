@@ -111,6 +111,36 @@ TEST_F(HashSetTest, TestInsertAndErase) {
   }
 }
 
+TEST_F(HashSetTest, TestHashTagInsertAndErase) {
+  // Same work load as TestInsertAndErase, but with the tag-probing lookup enabled.
+  HashSet<std::string, IsEmptyFnString, std::hash<std::string>, std::equal_to<std::string>,
+      std::allocator<std::string>, /* kStoreHashTags */ true> hash_set;
+  static constexpr size_t count = 1000;
+  std::vector<std::string> strings;
+  for (size_t i = 0; i < count; ++i) {
+    strings.push_back(RandomString(10));
+    hash_set.Insert(strings[i]);
+    auto it = hash_set.Find(strings[i]);
+    ASSERT_TRUE(it != hash_set.end());
+    ASSERT_EQ(*it, strings[i]);
+  }
+  ASSERT_EQ(strings.size(), hash_set.Size());
+  for (size_t i = 1; i < count; i += 2) {
+    auto it = hash_set.Find(strings[i]);
+    ASSERT_TRUE(it != hash_set.end());
+    hash_set.Erase(it);
+    ASSERT_EQ(hash_set.Verify(), 0U);
+  }
+  for (size_t i = 1; i < count; i += 2) {
+    ASSERT_TRUE(hash_set.Find(strings[i]) == hash_set.end());
+  }
+  for (size_t i = 0; i < count; i += 2) {
+    auto it = hash_set.Find(strings[i]);
+    ASSERT_TRUE(it != hash_set.end());
+    ASSERT_EQ(*it, strings[i]);
+  }
+}
+
 TEST_F(HashSetTest, TestIterator) {
   HashSet<std::string, IsEmptyFnString> hash_set;
   ASSERT_TRUE(hash_set.begin() == hash_set.end());
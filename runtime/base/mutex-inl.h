@@ -123,8 +123,52 @@ inline void BaseMutex::RegisterAsUnlocked(Thread* self) {
   }
 }
 
+inline size_t ReaderWriterMutex::VisibleReaderSlot(Thread* self) const {
+  // Mix the thread id and the mutex address so that concurrent readers of the same lock spread
+  // over the table and the same thread uses distinct slots for distinct biased locks.
+  uintptr_t value = reinterpret_cast<uintptr_t>(this) >> 4;
+  value ^= static_cast<uintptr_t>(SafeGetTid(self)) * 0x9E3779B9u;
+  return static_cast<size_t>(value % kVisibleReaderSlots);
+}
+
+inline bool ReaderWriterMutex::SharedLockVisibleReaderFastPath(Thread* self) {
+  DCHECK(reader_biased_);
+  if (!reader_bias_active_.LoadRelaxed()) {
+    return false;
+  }
+  const size_t slot = VisibleReaderSlot(self);
+  const ReaderWriterMutex* null_mutex = nullptr;
+  if (!visible_readers_[slot].CompareExchangeStrongSequentiallyConsistent(null_mutex, this)) {
+    // Slot collision, fall back to the shared reader count.
+    return false;
+  }
+  // Publication must be visible before the re-check so that it cannot race past a concurrent
+  // revocation (store/load ordering against WaitForVisibleReaders).
+  if (LIKELY(reader_bias_active_.LoadSequentiallyConsistent())) {
+    return true;
+  }
+  // A writer is revoking the bias, undo the publication and fall back to the reader count.
+  visible_readers_[slot].StoreSequentiallyConsistent(nullptr);
+  return false;
+}
+
+inline bool ReaderWriterMutex::SharedUnlockVisibleReaderFastPath(Thread* self) {
+  DCHECK(reader_biased_);
+  const size_t slot = VisibleReaderSlot(self);
+  // Shared holds are interchangeable: on a slot hash collision this may consume a publication
+  // made by another reader, whose own unlock then balances through state_. The CAS ensures a
+  // publication is consumed exactly once.
+  return visible_readers_[slot].LoadRelaxed() == this &&
+      visible_readers_[slot].CompareExchangeStrongSequentiallyConsistent(this, nullptr);
+}
+
 inline void ReaderWriterMutex::SharedLock(Thread* self) {
   DCHECK(self == nullptr || self == Thread::Current());
+  if (reader_biased_ && SharedLockVisibleReaderFastPath(self)) {
+    RegisterAsLocked(self);
+    AssertSharedHeld(self);
+    return;
+  }
 #if ART_USE_FUTEXES
   bool done = false;
   do {
@@ -139,6 +183,10 @@ inline void ReaderWriterMutex::SharedLock(Thread* self) {
 #else
   CHECK_MUTEX_CALL(pthread_rwlock_rdlock, (&rwlock_));
 #endif
+  if (UNLIKELY(reader_biased_)) {
+    // We hold a share of state_, so no writer can be in its critical section while we re-arm.
+    MaybeRearmReaderBias();
+  }
   DCHECK(exclusive_owner_ == 0U || exclusive_owner_ == -1U);
   RegisterAsLocked(self);
   AssertSharedHeld(self);
@@ -149,6 +197,9 @@ inline void ReaderWriterMutex::SharedUnlock(Thread* self) {
   DCHECK(exclusive_owner_ == 0U || exclusive_owner_ == -1U);
   AssertSharedHeld(self);
   RegisterAsUnlocked(self);
+  if (reader_biased_ && SharedUnlockVisibleReaderFastPath(self)) {
+    return;
+  }
 #if ART_USE_FUTEXES
   bool done = false;
   do {
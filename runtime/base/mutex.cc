@@ -17,8 +17,13 @@
 #include "mutex.h"
 
 #include <errno.h>
+#include <sched.h>
 #include <sys/time.h>
 
+#include <algorithm>
+#include <map>
+#include <vector>
+
 #include "atomic.h"
 #include "base/logging.h"
 #include "base/time_utils.h"
@@ -28,6 +33,7 @@
 #include "runtime.h"
 #include "scoped_thread_state_change.h"
 #include "thread-inl.h"
+#include "thread_list.h"
 
 namespace art {
 
@@ -117,10 +123,10 @@ class ScopedAllMutexesLock FINAL {
 class ScopedContentionRecorder FINAL : public ValueObject {
  public:
   ScopedContentionRecorder(BaseMutex* mutex, uint64_t blocked_tid, uint64_t owner_tid)
-      : mutex_(kLogLockContentions ? mutex : nullptr),
-        blocked_tid_(kLogLockContentions ? blocked_tid : 0),
-        owner_tid_(kLogLockContentions ? owner_tid : 0),
-        start_nano_time_(kLogLockContentions ? NanoTime() : 0) {
+      : mutex_(kLogLockContentions || BaseMutex::IsContentionLogEnabled() ? mutex : nullptr),
+        blocked_tid_(mutex_ != nullptr ? blocked_tid : 0),
+        owner_tid_(mutex_ != nullptr ? owner_tid : 0),
+        start_nano_time_(mutex_ != nullptr ? NanoTime() : 0) {
     if (ATRACE_ENABLED()) {
       std::string msg = StringPrintf("Lock contention on %s (owner tid: %" PRIu64 ")",
                                      mutex->GetName(), owner_tid);
@@ -130,7 +136,7 @@ class ScopedContentionRecorder FINAL : public ValueObject {
 
   ~ScopedContentionRecorder() {
     ATRACE_END();
-    if (kLogLockContentions) {
+    if (mutex_ != nullptr) {
       uint64_t end_nano_time = NanoTime();
       mutex_->RecordContention(blocked_tid_, owner_tid_, end_nano_time - start_nano_time_);
     }
@@ -143,6 +149,8 @@ class ScopedContentionRecorder FINAL : public ValueObject {
   const uint64_t start_nano_time_;
 };
 
+Atomic<bool> BaseMutex::contention_log_enabled_(kLogLockContentions);
+
 BaseMutex::BaseMutex(const char* name, LockLevel level) : level_(level), name_(name) {
   if (kLogLockContentions) {
     ScopedAllMutexesLock mu(this);
@@ -250,6 +258,89 @@ void BaseMutex::RecordContention(uint64_t blocked_tid,
       log[new_slot].count.StoreRelaxed(1);
     }
   }
+  if (IsContentionLogEnabled()) {
+    RecordContentionEvent(owner_tid, nano_time_blocked);
+  }
+}
+
+void BaseMutex::RecordContentionEvent(uint64_t owner_tid, uint64_t nano_time_blocked) {
+  Thread* self = Thread::Current();
+  if (self == nullptr) {
+    return;
+  }
+  ContentionEventRing* ring = self->GetContentionEventRing();
+  if (ring == nullptr) {
+    ring = new ContentionEventRing;
+    self->SetContentionEventRing(ring);
+  }
+  // Single writer, no synchronization needed; the aggregation pass reads racily.
+  ContentionEventRing::Event* event = &ring->events[ring->pos % kContentionEventRingSize];
+  event->name = name_;
+  event->owner_tid = owner_tid;
+  event->wait_nanos = nano_time_blocked;
+  ++ring->pos;
+}
+
+void BaseMutex::DumpContentionRanking(std::ostream& os) {
+  os << "Lock contention ranking";
+  if (!IsContentionLogEnabled()) {
+    os << ": collection disabled\n";
+    return;
+  }
+  os << ":\n";
+  Runtime* runtime = Runtime::Current();
+  if (runtime == nullptr) {
+    return;
+  }
+  struct ContentionSums {
+    uint64_t count;
+    uint64_t total_wait_nanos;
+    uint64_t max_wait_nanos;
+  };
+  std::map<const char*, ContentionSums> sums;
+  Thread* self = Thread::Current();
+  {
+    MutexLock mu(self, *Locks::thread_list_lock_);
+    for (Thread* thread : runtime->GetThreadList()->GetList()) {
+      const ContentionEventRing* ring = thread->GetContentionEventRing();
+      if (ring == nullptr) {
+        continue;
+      }
+      // The owner may still be recording; a slot under rewrite yields at worst one misattributed
+      // sample, which is acceptable for diagnostics.
+      const size_t valid = std::min(ring->pos, kContentionEventRingSize);
+      for (size_t i = 0; i < valid; ++i) {
+        const ContentionEventRing::Event& event = ring->events[i];
+        if (event.name == nullptr) {
+          continue;
+        }
+        auto it = sums.find(event.name);
+        if (it == sums.end()) {
+          sums.emplace(event.name, ContentionSums{1u, event.wait_nanos, event.wait_nanos});
+        } else {
+          ++it->second.count;
+          it->second.total_wait_nanos += event.wait_nanos;
+          it->second.max_wait_nanos = std::max(it->second.max_wait_nanos, event.wait_nanos);
+        }
+      }
+    }
+  }
+  if (sums.empty()) {
+    os << "  (no events recorded)\n";
+    return;
+  }
+  std::vector<std::pair<const char*, ContentionSums>> ranking(sums.begin(), sums.end());
+  std::sort(ranking.begin(),
+            ranking.end(),
+            [](const std::pair<const char*, ContentionSums>& lhs,
+               const std::pair<const char*, ContentionSums>& rhs) {
+              return lhs.second.total_wait_nanos > rhs.second.total_wait_nanos;
+            });
+  for (const auto& entry : ranking) {
+    os << "  " << entry.first << ": " << entry.second.count << " events, total wait "
+       << PrettyDuration(entry.second.total_wait_nanos) << ", max wait "
+       << PrettyDuration(entry.second.max_wait_nanos) << "\n";
+  }
 }
 
 void BaseMutex::DumpContention(std::ostream& os) const {
@@ -513,8 +604,17 @@ std::ostream& operator<<(std::ostream& os, const Mutex& mu) {
   return os;
 }
 
-ReaderWriterMutex::ReaderWriterMutex(const char* name, LockLevel level)
-    : BaseMutex(name, level)
+Atomic<const ReaderWriterMutex*> ReaderWriterMutex::visible_readers_[kVisibleReaderSlots];
+
+// How long after a revocation contended readers must wait before re-arming the reader bias, so
+// that write-heavy phases do not pay for a visible reader table scan on every acquisition.
+static constexpr uint64_t kReaderBiasRearmDelayNs = 1 * 1000 * 1000;  // 1ms
+
+ReaderWriterMutex::ReaderWriterMutex(const char* name, LockLevel level, bool reader_biased)
+    : BaseMutex(name, level),
+      reader_biased_(reader_biased),
+      reader_bias_active_(reader_biased),
+      bias_inhibit_until_(0)
 #if ART_USE_FUTEXES
     , state_(0), num_pending_readers_(0), num_pending_writers_(0)
 #endif
@@ -574,12 +674,36 @@ void ReaderWriterMutex::ExclusiveLock(Thread* self) {
 #else
   CHECK_MUTEX_CALL(pthread_rwlock_wrlock, (&rwlock_));
 #endif
+  if (reader_biased_ && reader_bias_active_.LoadSequentiallyConsistent()) {
+    WaitForVisibleReaders();
+  }
   DCHECK_EQ(exclusive_owner_, 0U);
   exclusive_owner_ = SafeGetTid(self);
   RegisterAsLocked(self);
   AssertExclusiveHeld(self);
 }
 
+void ReaderWriterMutex::WaitForVisibleReaders() {
+  // Deactivate the bias so that new readers fall back to state_, which we hold exclusively,
+  // then wait for the already published readers to leave their critical sections. The sequential
+  // consistency of the store and the scan pairs with the publish/re-check in the reader fast
+  // path: a reader either sees the deactivation and reverts, or its publication is seen here.
+  bias_inhibit_until_.StoreRelaxed(NanoTime() + kReaderBiasRearmDelayNs);
+  reader_bias_active_.StoreSequentiallyConsistent(false);
+  for (size_t i = 0; i < kVisibleReaderSlots; ++i) {
+    while (visible_readers_[i].LoadSequentiallyConsistent() == this) {
+      sched_yield();
+    }
+  }
+}
+
+void ReaderWriterMutex::MaybeRearmReaderBias() {
+  if (!reader_bias_active_.LoadRelaxed() &&
+      NanoTime() >= bias_inhibit_until_.LoadRelaxed()) {
+    reader_bias_active_.StoreSequentiallyConsistent(true);
+  }
+}
+
 void ReaderWriterMutex::ExclusiveUnlock(Thread* self) {
   DCHECK(self == nullptr || self == Thread::Current());
   AssertExclusiveHeld(self);
@@ -662,6 +786,10 @@ bool ReaderWriterMutex::ExclusiveLockWithTimeout(Thread* self, int64_t ms, int32
     PLOG(FATAL) << "pthread_rwlock_timedwrlock failed for " << name_;
   }
 #endif
+  if (reader_biased_ && reader_bias_active_.LoadSequentiallyConsistent()) {
+    // May overshoot the timeout, but published readers hold only short critical sections.
+    WaitForVisibleReaders();
+  }
   exclusive_owner_ = SafeGetTid(self);
   RegisterAsLocked(self);
   AssertSharedHeld(self);
@@ -685,6 +813,11 @@ void ReaderWriterMutex::HandleSharedLockContention(Thread* self, int32_t cur_sta
 
 bool ReaderWriterMutex::SharedTryLock(Thread* self) {
   DCHECK(self == nullptr || self == Thread::Current());
+  if (reader_biased_ && SharedLockVisibleReaderFastPath(self)) {
+    RegisterAsLocked(self);
+    AssertSharedHeld(self);
+    return true;
+  }
 #if ART_USE_FUTEXES
   bool done = false;
   do {
@@ -1022,7 +1155,8 @@ void Locks::Init() {
     UPDATE_CURRENT_LOCK_LEVEL(kClassLinkerClassesLock);
     DCHECK(classlinker_classes_lock_ == nullptr);
     classlinker_classes_lock_ = new ReaderWriterMutex("ClassLinker classes lock",
-                                                      current_lock_level);
+                                                      current_lock_level,
+                                                      /* reader_biased */ true);
 
     UPDATE_CURRENT_LOCK_LEVEL(kMonitorPoolLock);
     DCHECK(allocated_monitor_ids_lock_ == nullptr);
@@ -90,6 +90,7 @@ enum LockLevel {
   kDeoptimizedMethodsLock,
   kJitCodeCacheLock,
   kClassLoaderClassesLock,
+  kThreadPoolWorkerQueueLock,
   kDefaultMutexLevel,
   kMarkSweepLargeObjectLock,
   kPinTableLock,
@@ -137,6 +138,33 @@ const size_t kContentionLogSize = 4;
 const size_t kContentionLogDataSize = kLogLockContentions ? 1 : 0;
 const size_t kAllMutexDataSize = kLogLockContentions ? 1 : 0;
 
+// Number of contention events each thread's ring can hold before old events are overwritten.
+const size_t kContentionEventRingSize = 256;
+
+// Per-thread ring of lock contention events, written without synchronization by the owning
+// thread on contended acquisitions and read racily during aggregation. The mutex name is
+// recorded rather than the mutex itself so that events survive short-lived locks, such as an
+// inflated monitor's, being destroyed.
+struct ContentionEventRing {
+  struct Event {
+    const char* name;
+    uint64_t owner_tid;
+    uint64_t wait_nanos;
+  };
+
+  ContentionEventRing() : pos(0u) {
+    for (Event& event : events) {
+      event.name = nullptr;
+      event.owner_tid = 0u;
+      event.wait_nanos = 0u;
+    }
+  }
+
+  // Total number of events recorded; the next event goes to pos % kContentionEventRingSize.
+  size_t pos;
+  Event events[kContentionEventRingSize];
+};
+
 // Base class for all Mutex implementations
 class BaseMutex {
  public:
@@ -152,6 +180,19 @@ class BaseMutex {
 
   static void DumpAll(std::ostream& os);
 
+  // Runtime toggle for contention event collection. Only the contended slow path checks it, so
+  // leaving it off costs nothing on uncontended acquisitions.
+  static void SetContentionLogEnabled(bool enabled) {
+    contention_log_enabled_.StoreSequentiallyConsistent(enabled);
+  }
+  static bool IsContentionLogEnabled() {
+    return contention_log_enabled_.LoadRelaxed();
+  }
+
+  // Aggregate the per-thread contention event rings into a table of locks ranked by total wait
+  // time. Events of detached threads are discarded with their rings.
+  static void DumpContentionRanking(std::ostream& os);
+
  protected:
   friend class ConditionVariable;
 
@@ -164,8 +205,12 @@ class BaseMutex {
   friend class ScopedContentionRecorder;
 
   void RecordContention(uint64_t blocked_tid, uint64_t owner_tid, uint64_t nano_time_blocked);
+  void RecordContentionEvent(uint64_t owner_tid, uint64_t nano_time_blocked);
   void DumpContention(std::ostream& os) const;
 
+  // Whether contended acquisitions append to the per-thread event rings.
+  static Atomic<bool> contention_log_enabled_;
+
   const LockLevel level_;  // Support for lock hierarchy.
   const char* const name_;
 
@@ -303,7 +348,14 @@ class LOCKABLE Mutex : public BaseMutex {
 std::ostream& operator<<(std::ostream& os, const ReaderWriterMutex& mu);
 class SHARED_LOCKABLE ReaderWriterMutex : public BaseMutex {
  public:
-  explicit ReaderWriterMutex(const char* name, LockLevel level = kDefaultMutexLevel);
+  // If reader_biased is true, readers publish themselves in a slot of a global visible reader
+  // table instead of CAS-updating the shared reader count, so read-mostly locks stop bouncing
+  // their cache line across cores. Writers revoke the bias after acquiring exclusive access and
+  // wait for the published readers to drain; contended readers re-arm it. Only worthwhile for
+  // locks that are read overwhelmingly more often than they are written.
+  explicit ReaderWriterMutex(const char* name,
+                             LockLevel level = kDefaultMutexLevel,
+                             bool reader_biased = false);
   ~ReaderWriterMutex();
 
   virtual bool IsReaderWriterMutex() const { return true; }
@@ -387,6 +439,40 @@ class SHARED_LOCKABLE ReaderWriterMutex : public BaseMutex {
   const ReaderWriterMutex& operator!() const { return *this; }
 
  private:
+  // Global table of published readers for reader biased mutexes, indexed by a hash of the
+  // acquiring thread and the mutex so that concurrent readers of the same lock land in
+  // different slots.
+  static constexpr size_t kVisibleReaderSlots = 256;
+  static Atomic<const ReaderWriterMutex*> visible_readers_[kVisibleReaderSlots];
+
+  // Slot of the calling thread for this mutex in visible_readers_.
+  size_t VisibleReaderSlot(Thread* self) const;
+
+  // Publish the calling thread as a reader without touching state_. Returns false if the bias
+  // is inactive or the slot is taken, in which case the caller falls back to state_.
+  bool SharedLockVisibleReaderFastPath(Thread* self) ALWAYS_INLINE;
+
+  // Consume a publication made through the fast path. Returns false if this share was acquired
+  // through state_ instead.
+  bool SharedUnlockVisibleReaderFastPath(Thread* self) ALWAYS_INLINE;
+
+  // With exclusive access held, deactivate the bias and wait for already published readers to
+  // leave their critical sections.
+  void WaitForVisibleReaders();
+
+  // Reactivate the bias from a reader that fell back to state_, once the inhibition window set
+  // by the last revocation has passed. Safe because the caller holds a share of state_, so any
+  // later writer revokes again before entering its critical section.
+  void MaybeRearmReaderBias();
+
+  // Whether readers of this mutex may use the visible reader table (constant per mutex).
+  const bool reader_biased_;
+  // Whether the table is currently usable; deactivated by writers during revocation.
+  Atomic<bool> reader_bias_active_;
+  // NanoTime() before which contended readers must not re-arm the bias, so that write-heavy
+  // phases do not pay for a table scan on every exclusive acquisition.
+  Atomic<uint64_t> bias_inhibit_until_;
+
 #if ART_USE_FUTEXES
   // Out-of-inline path for handling contention for a SharedLock.
   void HandleSharedLockContention(Thread* self, int32_t cur_state);
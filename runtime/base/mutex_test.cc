@@ -171,4 +171,23 @@ TEST_F(MutexTest, SharedTryLockUnlock) {
   SharedTryLockUnlockTest();
 }
 
+TEST_F(MutexTest, ReaderBiasedSharedLockUnlock) {
+  ReaderWriterMutex mu("test reader biased rwmutex", kDefaultMutexLevel, /* reader_biased */ true);
+  mu.AssertNotHeld(Thread::Current());
+  mu.SharedLock(Thread::Current());
+  mu.AssertSharedHeld(Thread::Current());
+  mu.AssertNotExclusiveHeld(Thread::Current());
+  mu.SharedUnlock(Thread::Current());
+  mu.AssertNotHeld(Thread::Current());
+  // An exclusive pass revokes the bias; shared locking afterwards goes through the reader count
+  // until the bias is re-armed, and both paths must still balance.
+  mu.ExclusiveLock(Thread::Current());
+  mu.AssertExclusiveHeld(Thread::Current());
+  mu.ExclusiveUnlock(Thread::Current());
+  mu.SharedLock(Thread::Current());
+  mu.AssertSharedHeld(Thread::Current());
+  mu.SharedUnlock(Thread::Current());
+  mu.AssertNotHeld(Thread::Current());
+}
+
 }  // namespace art
@@ -34,6 +34,7 @@ namespace art {
 constexpr size_t CumulativeLogger::kLowMemoryBucketCount;
 constexpr size_t CumulativeLogger::kDefaultBucketCount;
 constexpr size_t TimingLogger::kIndexNotFound;
+constexpr size_t TimingLogger::kInitialTimingCapacity;
 
 CumulativeLogger::CumulativeLogger(const std::string& name)
     : name_(name),
@@ -137,6 +138,9 @@ void TimingLogger::Reset() {
 
 void TimingLogger::StartTiming(const char* label) {
   DCHECK(label != nullptr);
+  if (timings_.capacity() == 0u) {
+    timings_.reserve(kInitialTimingCapacity);
+  }
   timings_.push_back(Timing(NanoTime(), label));
   ATRACE_BEGIN(label);
 }
@@ -232,6 +236,25 @@ void TimingLogger::Dump(std::ostream &os, const char* indent_string) const {
   os << name_ << ": end, " << PrettyDuration(GetTotalNs()) << "\n";
 }
 
+void TimingLogger::DumpFolded(std::ostream& os) const {
+  TimingLogger::TimingData timing_data(CalculateTimingData());
+  std::vector<size_t> open_stack;
+  for (size_t i = 0; i < timings_.size(); ++i) {
+    if (timings_[i].IsStartTiming()) {
+      open_stack.push_back(i);
+      os << name_;
+      for (size_t open_idx : open_stack) {
+        os << ';' << timings_[open_idx].GetName();
+      }
+      // Exclusive time, in whole microseconds as flamegraph.pl expects integer counts.
+      os << ' ' << timing_data.GetExclusiveTime(i) / 1000 << '\n';
+    } else {
+      DCHECK(!open_stack.empty()) << "No starting split for ending split at index " << i;
+      open_stack.pop_back();
+    }
+  }
+}
+
 void TimingLogger::Verify() {
   size_t counts[2] = { 0 };
   for (size_t i = 0; i < timings_.size(); ++i) {
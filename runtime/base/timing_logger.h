@@ -78,6 +78,9 @@ class CumulativeLogger {
 class TimingLogger {
  public:
   static constexpr size_t kIndexNotFound = static_cast<size_t>(-1);
+  // Pre-sized on the first split so that typical phase counts record without reallocating;
+  // Reset() keeps the capacity.
+  static constexpr size_t kInitialTimingCapacity = 64;
 
   class Timing {
    public:
@@ -151,6 +154,10 @@ class TimingLogger {
   // Find the index of a timing by name.
   size_t FindTimingIndex(const char* name, size_t start_idx) const;
   void Dump(std::ostream& os, const char* indent_string = "  ") const;
+  // Dump the timings as flame-graph "folded stacks": one line per split with its full
+  // semicolon-separated nesting path and its exclusive time in microseconds. The output is
+  // directly consumable by flamegraph.pl, which sums repeated stacks.
+  void DumpFolded(std::ostream& os) const;
 
   // Scoped timing splits that can be nested and composed with the explicit split
   // starts and ends.
@@ -16,6 +16,9 @@
 
 #include "timing_logger.h"
 
+#include <algorithm>
+#include <sstream>
+
 #include "common_runtime_test.h"
 
 namespace art {
@@ -158,4 +161,21 @@ TEST_F(TimingLoggerTest, ScopedAndExplicit) {
   EXPECT_LE(timings[idx_innerinnersplit1].GetTime(), timings[idx_innerinnersplit2].GetTime());
 }
 
+TEST_F(TimingLoggerTest, DumpFolded) {
+  TimingLogger logger("Folded", true, false);
+  {
+    TimingLogger::ScopedTiming outer("Outer", &logger);
+    {
+      TimingLogger::ScopedTiming inner("Inner", &logger);
+    }  // Ends Inner.
+  }  // Ends Outer.
+  std::ostringstream oss;
+  logger.DumpFolded(oss);
+  const std::string folded = oss.str();
+  // One line per split, each with its full nesting path.
+  EXPECT_NE(folded.find("Folded;Outer "), std::string::npos) << folded;
+  EXPECT_NE(folded.find("Folded;Outer;Inner "), std::string::npos) << folded;
+  EXPECT_EQ(std::count(folded.begin(), folded.end(), '\n'), 2) << folded;
+}
+
 }  // namespace art
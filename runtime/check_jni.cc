@@ -29,6 +29,7 @@
 #include "dex_file-inl.h"
 #include "gc/space/space.h"
 #include "java_vm_ext.h"
+#include "jni_env_ext.h"
 #include "jni_internal.h"
 #include "mirror/class-inl.h"
 #include "mirror/object-inl.h"
@@ -240,6 +241,23 @@ class VarArgs {
   };
 };
 
+// Returns whether this call should go through the thorough argument checks.
+// With -Xcheck:jni:sample:N only every Nth call on a given JNIEnv is fully
+// validated, bounding CheckJNI overhead enough for always-on use; the first
+// call on each thread is always checked. The default interval of 0 keeps the
+// traditional check-every-call behavior.
+static bool ShouldCheckThoroughly(JNIEnvExt* env) {
+  uint32_t interval = env->vm->GetCheckJniSampleInterval();
+  if (LIKELY(interval == 0u)) {
+    return true;
+  }
+  if (--env->check_jni_sample_countdown == 0u) {
+    env->check_jni_sample_countdown = interval;
+    return true;
+  }
+  return false;
+}
+
 class ScopedCheck {
  public:
   ScopedCheck(int flags, const char* functionName, bool has_method = true)
@@ -493,8 +511,9 @@ class ScopedCheck {
       }
     }
 
-    // We always do the thorough checks on entry, and never on exit...
-    if (entry) {
+    // We always do the thorough checks on entry, and never on exit. When
+    // sampling is enabled, most entries skip them too.
+    if (entry && ShouldCheckThoroughly(soa.Env())) {
       for (size_t i = 0; fmt[i] != '\0'; ++i) {
         if (!CheckPossibleHeapValue(soa, fmt[i], args[i])) {
           return false;
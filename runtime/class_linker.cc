@@ -54,10 +54,12 @@
 #include "gc/heap.h"
 #include "gc/scoped_gc_critical_section.h"
 #include "gc/space/image_space.h"
+#include "gc/task_processor.h"
 #include "handle_scope-inl.h"
 #include "image-inl.h"
 #include "intern_table.h"
 #include "interpreter/interpreter.h"
+#include "interpreter/interpreter_cache.h"
 #include "jit/jit.h"
 #include "jit/jit_code_cache.h"
 #include "jit/offline_profiling_info.h"
@@ -84,6 +86,7 @@
 #include "oat_file_manager.h"
 #include "object_lock.h"
 #include "os.h"
+#include "reflection.h"
 #include "runtime.h"
 #include "ScopedLocalRef.h"
 #include "scoped_thread_state_change.h"
@@ -92,6 +95,7 @@
 #include "utils.h"
 #include "utils/dex_cache_arrays_layout-inl.h"
 #include "verifier/method_verifier.h"
+#include "verifier/verification_cache.h"
 #include "well_known_classes.h"
 
 namespace art {
@@ -311,6 +315,8 @@ static void ShuffleForward(size_t* current_field_idx,
 ClassLinker::ClassLinker(InternTable* intern_table)
     // dex_lock_ is recursive as it may be used in stack dumping.
     : dex_lock_("ClassLinker dex lock", kDefaultMutexLevel),
+      class_loader_reclaim_task_pending_(false),
+      reclaimed_class_loader_bytes_(0u),
       dex_cache_boot_image_class_lookup_required_(false),
       failed_dex_cache_class_lookups_(0),
       class_roots_(nullptr),
@@ -1496,6 +1502,74 @@ class UpdateClassLoaderAndResolvedStringsVisitor {
   const bool forward_strings_;
 };
 
+// Redirect references to strings the runtime had already interned before the app image was
+// loaded to the canonical instance, so that equal string literals keep pointer identity across
+// dex files. Should only be used on objects in the image space.
+class RemapInternedStringsVisitor {
+ public:
+  explicit RemapInternedStringsVisitor(
+      const SafeMap<mirror::String*, mirror::String*>& intern_remap)
+      : intern_remap_(intern_remap) {}
+
+  mirror::String* operator()(mirror::String* string) const {
+    auto it = intern_remap_.find(string);
+    return (it != intern_remap_.end()) ? it->second : string;
+  }
+
+  void operator()(mirror::Object* object) const SHARED_REQUIRES(Locks::mutator_lock_) {
+    // Native roots are not visited; the only native references to strings are the dex cache
+    // string arrays, which the caller fixes up separately.
+    object->VisitReferences</*kVisitNativeRoots*/false>(*this, *this);
+  }
+
+  void operator()(mirror::Object* obj, MemberOffset offset, bool is_static ATTRIBUTE_UNUSED) const
+      SHARED_REQUIRES(Locks::mutator_lock_) {
+    mirror::Object* ref = obj->GetFieldObject<mirror::Object>(offset);
+    if (ref != nullptr && ref->IsString()) {
+      mirror::String* remapped = operator()(ref->AsString());
+      if (remapped != ref) {
+        // Keep the write barrier since the canonical string may be in the main heap.
+        obj->SetFieldObject</*kTransactionActive*/false>(offset, remapped);
+      }
+    }
+  }
+
+  // java.lang.ref.Reference visitor.
+  void operator()(mirror::Class* klass ATTRIBUTE_UNUSED, mirror::Reference* ref) const
+      SHARED_REQUIRES(Locks::mutator_lock_) {
+    operator()(ref, mirror::Reference::ReferentOffset(), /* is_static */ false);
+  }
+
+  // Unused since we do not visit native roots.
+  void VisitRootIfNonNull(
+      mirror::CompressedReference<mirror::Object>* root ATTRIBUTE_UNUSED) const {}
+  void VisitRoot(mirror::CompressedReference<mirror::Object>* root ATTRIBUTE_UNUSED) const {}
+
+ private:
+  const SafeMap<mirror::String*, mirror::String*>& intern_remap_;
+};
+
+// Redirect all references in an app image to strings that were interned by the runtime while
+// the image was being compiled or loaded. See RemapInternedStringsVisitor.
+static void RemapAppImageDuplicateStrings(
+    gc::space::ImageSpace* space,
+    Handle<mirror::ObjectArray<mirror::DexCache>> dex_caches,
+    const SafeMap<mirror::String*, mirror::String*>& intern_remap)
+    SHARED_REQUIRES(Locks::mutator_lock_) {
+  RemapInternedStringsVisitor visitor(intern_remap);
+  space->GetLiveBitmap()->VisitMarkedRange(reinterpret_cast<uintptr_t>(space->Begin()),
+                                           reinterpret_cast<uintptr_t>(space->End()),
+                                           visitor);
+  gc::Heap* const heap = Runtime::Current()->GetHeap();
+  for (int32_t i = 0, count = dex_caches->GetLength(); i < count; ++i) {
+    mirror::DexCache* const dex_cache = dex_caches->Get(i);
+    dex_cache->FixupStrings(dex_cache->GetStrings(), visitor);
+    // The dex cache array may now reference strings in the main heap; make sure the GC visits
+    // it even though the dex cache itself lives in the image.
+    heap->WriteBarrierEveryFieldOf(dex_cache);
+  }
+}
+
 static std::unique_ptr<const DexFile> OpenOatDexFile(const OatFile* oat_file,
                                                      const char* location,
                                                      std::string* error_msg)
@@ -1799,6 +1873,23 @@ bool ClassLinker::AddImageSpace(
                     << reinterpret_cast<const void*>(section_end);
       }
     }
+    // Merge the precomputed intern table from the image so that the strings it pre-resolved do
+    // not need to be interned one at a time on first use. The section was already fixed up when
+    // the image was relocated. This must come after the last point where we can still reject the
+    // image, since the merged table references the image for the lifetime of the runtime.
+    const ImageSection& intern_table_section = header.GetImageSection(
+        ImageHeader::kSectionInternedStrings);
+    if (intern_table_section.Size() > 0u) {
+      const uint64_t start_time2 = NanoTime();
+      SafeMap<mirror::String*, mirror::String*> intern_remap;
+      intern_table_->AddAppImageTableFromMemory(space->Begin() + intern_table_section.Offset(),
+                                                &intern_remap);
+      if (!intern_remap.empty()) {
+        RemapAppImageDuplicateStrings(space, dex_caches, intern_remap);
+      }
+      VLOG(image) << "Adding intern table took " << PrettyDuration(NanoTime() - start_time2)
+                  << " (" << intern_remap.size() << " duplicates)";
+    }
   }
   if (added_class_table) {
     WriterMutexLock mu(self, *Locks::classlinker_classes_lock_);
@@ -2034,6 +2125,12 @@ ClassLinker::~ClassLinker() {
     DeleteClassLoader(self, data);
   }
   class_loaders_.clear();
+  // The heap task processor is stopped before we get here; reclaim whatever the background
+  // task did not get to.
+  for (const ClassLoaderData& data : pending_class_loader_reclaims_) {
+    DeleteClassLoaderAllocations(data);
+  }
+  pending_class_loader_reclaims_.clear();
 }
 
 void ClassLinker::DeleteClassLoader(Thread* self, const ClassLoaderData& data) {
@@ -2047,8 +2144,14 @@ void ClassLinker::DeleteClassLoader(Thread* self, const ClassLoaderData& data) {
       code_cache->RemoveMethodsIn(self, *data.allocator);
     }
   }
+  DeleteClassLoaderAllocations(data);
+}
+
+size_t ClassLinker::DeleteClassLoaderAllocations(const ClassLoaderData& data) {
+  const size_t bytes = data.allocator->GetUsedMemory();
   delete data.allocator;
   delete data.class_table;
+  return bytes;
 }
 
 mirror::PointerArray* ClassLinker::AllocPointerArray(Thread* self, size_t length) {
@@ -2402,31 +2505,33 @@ mirror::Class* ClassLinker::FindClass(Thread* self,
     ScopedLocalRef<jobject> class_loader_object(soa.Env(),
                                                 soa.AddLocalReference<jobject>(class_loader.Get()));
     std::string class_name_string(DescriptorToDot(descriptor));
-    ScopedLocalRef<jobject> result(soa.Env(), nullptr);
+    ScopedLocalRef<jobject> class_name_object(soa.Env(), nullptr);
     {
       ScopedThreadStateChange tsc(self, kNative);
-      ScopedLocalRef<jobject> class_name_object(soa.Env(),
-                                                soa.Env()->NewStringUTF(class_name_string.c_str()));
-      if (class_name_object.get() == nullptr) {
-        DCHECK(self->IsExceptionPending());  // OOME.
-        return nullptr;
-      }
-      CHECK(class_loader_object.get() != nullptr);
-      result.reset(soa.Env()->CallObjectMethod(class_loader_object.get(),
-                                               WellKnownClasses::java_lang_ClassLoader_loadClass,
-                                               class_name_object.get()));
+      class_name_object.reset(soa.Env()->NewStringUTF(class_name_string.c_str()));
     }
+    if (class_name_object.get() == nullptr) {
+      DCHECK(self->IsExceptionPending());  // OOME.
+      return nullptr;
+    }
+    CHECK(class_loader_object.get() != nullptr);
+    // Invoke loadClass directly instead of through CallObjectMethod, avoiding the JNI argument
+    // packing and the extra pair of thread state transitions for this well-known upcall.
+    jvalue args[1];
+    args[0].l = class_name_object.get();
+    JValue result = InvokeVirtualOrInterfaceWithJValues(
+        soa, class_loader_object.get(), WellKnownClasses::java_lang_ClassLoader_loadClass, args);
     if (self->IsExceptionPending()) {
       // If the ClassLoader threw, pass that exception up.
       return nullptr;
-    } else if (result.get() == nullptr) {
+    } else if (result.GetL() == nullptr) {
       // broken loader - throw NPE to be compatible with Dalvik
       ThrowNullPointerException(StringPrintf("ClassLoader.loadClass returned null for %s",
                                              class_name_string.c_str()).c_str());
       return nullptr;
     } else {
       // success, return mirror::Class*
-      return soa.Decode<mirror::Class*>(result.get());
+      return down_cast<mirror::Class*>(result.GetL());
     }
   }
   UNREACHABLE();
@@ -2564,6 +2669,10 @@ mirror::Class* ClassLinker::DefineClass(Thread* self,
   // Notify native debugger of the new class and its layout.
   jit::Jit::NewTypeLoadedIfUsingJit(h_new_class.Get());
 
+  // Queue an event for asynchronous listeners; they run on a background thread so their cost
+  // stays off this path.
+  class_load_notifier_.NotifyClassLoaded(descriptor, dex_file.GetLocation());
+
   return h_new_class.Get();
 }
 
@@ -2960,6 +3069,32 @@ LengthPrefixedArray<ArtField>* ClassLinker::AllocArtFieldArray(Thread* self,
   return ret;
 }
 
+void ClassLinker::AllocArtFieldArrays(Thread* self,
+                                      LinearAlloc* allocator,
+                                      size_t num_sfields,
+                                      size_t num_ifields,
+                                      LengthPrefixedArray<ArtField>** out_sfields,
+                                      LengthPrefixedArray<ArtField>** out_ifields) {
+  if (num_sfields == 0 || num_ifields == 0) {
+    *out_sfields = AllocArtFieldArray(self, allocator, num_sfields);
+    *out_ifields = AllocArtFieldArray(self, allocator, num_ifields);
+    return;
+  }
+  // Both arrays are needed, so carve them out of one allocation. This halves the allocator round
+  // trips of field-heavy class loading and drops the alignment padding between the arrays; the
+  // arrays are freed together with the class loader anyway.
+  static_assert(alignof(ArtField) == 4, "ArtField alignment is expected to be 4.");
+  const size_t sfields_size =
+      RoundUp(LengthPrefixedArray<ArtField>::ComputeSize(num_sfields), alignof(ArtField));
+  const size_t ifields_size = LengthPrefixedArray<ArtField>::ComputeSize(num_ifields);
+  uint8_t* const storage =
+      reinterpret_cast<uint8_t*>(allocator->Alloc(self, sfields_size + ifields_size));
+  *out_sfields = new (storage) LengthPrefixedArray<ArtField>(num_sfields);
+  std::uninitialized_fill_n(&(*out_sfields)->At(0), num_sfields, ArtField());
+  *out_ifields = new (storage + sfields_size) LengthPrefixedArray<ArtField>(num_ifields);
+  std::uninitialized_fill_n(&(*out_ifields)->At(0), num_ifields, ArtField());
+}
+
 LengthPrefixedArray<ArtMethod>* ClassLinker::AllocArtMethodArray(Thread* self,
                                                                  LinearAlloc* allocator,
                                                                  size_t length) {
@@ -3016,9 +3151,14 @@ void ClassLinker::LoadClassMembers(Thread* self,
     // but ignore the repeated indexes here, b/21868015.
     LinearAlloc* const allocator = GetAllocatorForClassLoader(klass->GetClassLoader());
     ClassDataItemIterator it(dex_file, class_data);
-    LengthPrefixedArray<ArtField>* sfields = AllocArtFieldArray(self,
-                                                                allocator,
-                                                                it.NumStaticFields());
+    LengthPrefixedArray<ArtField>* sfields;
+    LengthPrefixedArray<ArtField>* ifields;
+    AllocArtFieldArrays(self,
+                        allocator,
+                        it.NumStaticFields(),
+                        it.NumInstanceFields(),
+                        &sfields,
+                        &ifields);
     size_t num_sfields = 0;
     uint32_t last_field_idx = 0u;
     for (; it.HasNextStaticField(); it.Next()) {
@@ -3032,9 +3172,6 @@ void ClassLinker::LoadClassMembers(Thread* self,
       }
     }
     // Load instance fields.
-    LengthPrefixedArray<ArtField>* ifields = AllocArtFieldArray(self,
-                                                                allocator,
-                                                                it.NumInstanceFields());
     size_t num_ifields = 0u;
     last_field_idx = 0u;
     for (; it.HasNextInstanceField(); it.Next()) {
@@ -3073,10 +3210,14 @@ void ClassLinker::LoadClassMembers(Thread* self,
     size_t class_def_method_index = 0;
     uint32_t last_dex_method_index = DexFile::kDexNoIndex;
     size_t last_class_def_method_index = 0;
+    // Fetch the dex cache arrays once for the whole class rather than per method.
+    mirror::DexCache* const dex_cache = klass->GetDexCache();
+    ArtMethod** const resolved_methods = dex_cache->GetResolvedMethods();
+    GcRoot<mirror::Class>* const resolved_types = dex_cache->GetResolvedTypes();
     // TODO These should really use the iterators.
     for (size_t i = 0; it.HasNextDirectMethod(); i++, it.Next()) {
       ArtMethod* method = klass->GetDirectMethodUnchecked(i, image_pointer_size_);
-      LoadMethod(self, dex_file, it, klass, method);
+      LoadMethod(self, dex_file, it, klass, resolved_methods, resolved_types, method);
       LinkCode(method, oat_class, class_def_method_index);
       uint32_t it_method_index = it.GetMemberIndex();
       if (last_dex_method_index == it_method_index) {
@@ -3091,7 +3232,7 @@ void ClassLinker::LoadClassMembers(Thread* self,
     }
     for (size_t i = 0; it.HasNextVirtualMethod(); i++, it.Next()) {
       ArtMethod* method = klass->GetVirtualMethodUnchecked(i, image_pointer_size_);
-      LoadMethod(self, dex_file, it, klass, method);
+      LoadMethod(self, dex_file, it, klass, resolved_methods, resolved_types, method);
       DCHECK_EQ(class_def_method_index, it.NumDirectMethods() + i);
       LinkCode(method, oat_class, class_def_method_index);
       class_def_method_index++;
@@ -3116,6 +3257,8 @@ void ClassLinker::LoadMethod(Thread* self,
                              const DexFile& dex_file,
                              const ClassDataItemIterator& it,
                              Handle<mirror::Class> klass,
+                             ArtMethod** resolved_methods,
+                             GcRoot<mirror::Class>* resolved_types,
                              ArtMethod* dst) {
   uint32_t dex_method_idx = it.GetMemberIndex();
   const DexFile::MethodId& method_id = dex_file.GetMethodId(dex_method_idx);
@@ -3126,8 +3269,8 @@ void ClassLinker::LoadMethod(Thread* self,
   dst->SetDeclaringClass(klass.Get());
   dst->SetCodeItemOffset(it.GetMethodCodeItemOffset());
 
-  dst->SetDexCacheResolvedMethods(klass->GetDexCache()->GetResolvedMethods(), image_pointer_size_);
-  dst->SetDexCacheResolvedTypes(klass->GetDexCache()->GetResolvedTypes(), image_pointer_size_);
+  dst->SetDexCacheResolvedMethods(resolved_methods, image_pointer_size_);
+  dst->SetDexCacheResolvedTypes(resolved_types, image_pointer_size_);
 
   uint32_t access_flags = it.GetMethodAccessFlags();
 
@@ -3165,6 +3308,13 @@ void ClassLinker::LoadMethod(Thread* self,
       }
     }
   }
+  if (UNLIKELY((access_flags & kAccNative) != 0u) &&
+      (access_flags & kAccSynchronized) == 0u &&
+      dex_file.HasFastNativeMethodBuildAnnotation(dex_method_idx)) {
+    // The method was annotated as fast JNI at build time: calls elide the runnable-to-native
+    // thread state transition, as if it had been registered with a "!" signature.
+    access_flags |= kAccFastNative;
+  }
   dst->SetAccessFlags(access_flags);
 }
 
@@ -3593,12 +3743,16 @@ bool ClassLinker::RemoveClass(const char* descriptor, mirror::ClassLoader* class
   return class_table != nullptr && class_table->Remove(descriptor);
 }
 
-mirror::Class* ClassLinker::LookupClass(Thread* self,
+mirror::Class* ClassLinker::LookupClass(Thread* self ATTRIBUTE_UNUSED,
                                         const char* descriptor,
                                         size_t hash,
                                         mirror::ClassLoader* class_loader) {
   {
-    ReaderMutexLock mu(self, *Locks::classlinker_classes_lock_);
+    // No need to hold Locks::classlinker_classes_lock_ here, the class table pointer is stored in
+    // the class loader object and is published before any class is inserted into the table. The
+    // table probe itself is serialized against writers by the per-table lock inside
+    // ClassTable::Lookup, which is much less contended than the global lock during multi-threaded
+    // class loading.
     ClassTable* const class_table = ClassTableForClassLoader(class_loader);
     if (class_table != nullptr) {
       mirror::Class* result = class_table->Lookup(descriptor, hash);
@@ -3914,6 +4068,14 @@ void ClassLinker::VerifyClass(Thread* self, Handle<mirror::Class> klass, LogSeve
   //     oat_file_class_status == mirror::Class::kStatusError => !preverified
   DCHECK(!(oat_file_class_status == mirror::Class::kStatusError) || !preverified);
 
+  // The oat file had no verification data for the class. If it fully verified at runtime in a
+  // previous launch of the same app and the dex file is unchanged, trust the persistent
+  // verification cache and skip re-running the verifier.
+  if (!preverified && !Runtime::Current()->IsAotCompiler()) {
+    preverified = verifier::VerificationCache::ContainsClass(dex_file,
+                                                             klass->GetDexClassDefIndex());
+  }
+
   verifier::MethodVerifier::FailureKind verifier_failure = verifier::MethodVerifier::kNoFailure;
   std::string error_msg;
   if (!preverified) {
@@ -3943,6 +4105,10 @@ void ClassLinker::VerifyClass(Thread* self, Handle<mirror::Class> klass, LogSeve
       // super-default-interfaces were verified or requiring runtime reverification.
       if (supertype.Get() == nullptr || supertype->IsVerified()) {
         mirror::Class::SetStatus(klass, mirror::Class::kStatusVerified, self);
+        if (!preverified && !Runtime::Current()->IsAotCompiler()) {
+          // Record the clean runtime verification so that subsequent launches can skip it.
+          verifier::VerificationCache::AddClass(dex_file, klass->GetDexClassDefIndex());
+        }
       } else {
         CHECK_EQ(supertype->GetStatus(), mirror::Class::kStatusRetryVerificationAtRuntime);
         mirror::Class::SetStatus(klass, mirror::Class::kStatusRetryVerificationAtRuntime, self);
@@ -5733,6 +5899,9 @@ bool ClassLinker::LinkVirtualMethods(
           }
           vtable->SetElementPtrSize(j, virtual_method, image_pointer_size_);
           virtual_method->SetMethodIndex(j);
+          // Record that the super method now has an override, for the JIT's class hierarchy
+          // based speculation (see ArtMethod::HasSingleImplementation).
+          super_method->SetOverridden();
         } else {
           LOG(WARNING) << "Before Android 4.1, method " << PrettyMethod(virtual_method)
                        << " would have incorrectly overridden the package-private method in "
@@ -6096,7 +6265,7 @@ void ClassLinker::FillIMTAndConflictTables(mirror::Class* klass) {
 
 static inline uint32_t GetIMTIndex(ArtMethod* interface_method)
     SHARED_REQUIRES(Locks::mutator_lock_) {
-  return interface_method->GetDexMethodIndex() % mirror::Class::kImtSize;
+  return interface_method->GetImtIndex() % mirror::Class::kImtSize;
 }
 
 ImtConflictTable* ClassLinker::CreateImtConflictTable(size_t count,
@@ -7756,6 +7925,7 @@ void ClassLinker::DumpForSigQuit(std::ostream& os) {
   ReaderMutexLock mu(soa.Self(), *Locks::classlinker_classes_lock_);
   os << "Zygote loaded classes=" << NumZygoteClasses() << " post zygote classes="
      << NumNonZygoteClasses() << "\n";
+  os << "Reclaimed class loader bytes=" << GetReclaimedClassLoaderBytes() << "\n";
 }
 
 class CountClassesVisitor : public ClassLoaderVisitor {
@@ -8015,21 +8185,107 @@ void ClassLinker::InsertDexFileInToClassLoader(mirror::Object* dex_file,
   }
 }
 
+// How long to let the mutators run between two background class loader reclamation slices.
+static constexpr uint64_t kClassLoaderReclaimSliceInterval = MsToNs(4);
+
+class ClassLoaderReclaimTask FINAL : public gc::HeapTask {
+ public:
+  explicit ClassLoaderReclaimTask(uint64_t target_time)
+      : gc::HeapTask(target_time, gc::kHeapTaskPriorityHygiene) { }
+
+  void Run(Thread* self) OVERRIDE {
+    if (Runtime::Current()->GetClassLinker()->ReclaimNextDeadClassLoader(self)) {
+      // More dead class loaders remain; let the mutators run, then take another slice.
+      Runtime::Current()->GetHeap()->GetTaskProcessor()->AddTask(
+          self, new ClassLoaderReclaimTask(NanoTime() + kClassLoaderReclaimSliceInterval));
+    }
+  }
+};
+
 void ClassLinker::CleanupClassLoaders() {
   Thread* const self = Thread::Current();
-  WriterMutexLock mu(self, *Locks::classlinker_classes_lock_);
-  for (auto it = class_loaders_.begin(); it != class_loaders_.end(); ) {
-    const ClassLoaderData& data = *it;
-    // Need to use DecodeJObject so that we get null for cleared JNI weak globals.
-    auto* const class_loader = down_cast<mirror::ClassLoader*>(self->DecodeJObject(data.weak_root));
-    if (class_loader != nullptr) {
-      ++it;
-    } else {
-      VLOG(class_linker) << "Freeing class loader";
-      DeleteClassLoader(self, data);
-      it = class_loaders_.erase(it);
+  std::vector<ClassLoaderData> to_delete;
+  // Unhook the dead class loaders under the lock, but release their allocations outside of it.
+  {
+    WriterMutexLock mu(self, *Locks::classlinker_classes_lock_);
+    for (auto it = class_loaders_.begin(); it != class_loaders_.end(); ) {
+      const ClassLoaderData& data = *it;
+      // Need to use DecodeJObject so that we get null for cleared JNI weak globals.
+      auto* const class_loader =
+          down_cast<mirror::ClassLoader*>(self->DecodeJObject(data.weak_root));
+      if (class_loader != nullptr) {
+        ++it;
+      } else {
+        VLOG(class_linker) << "Freeing class loader";
+        to_delete.push_back(data);
+        it = class_loaders_.erase(it);
+      }
+    }
+  }
+  if (to_delete.empty()) {
+    return;
+  }
+  // Invalidate the interpreter resolution caches, they may hold metadata of the dead loaders.
+  interpreter::InterpreterCache::BumpGlobalEpoch();
+  // The weak roots and the jit code cache entries reference memory that the current GC cycle
+  // sweeps, so they must be released before it finishes. The allocator and the class table are
+  // unreachable once the loader is out of class_loaders_, so their teardown (which unmaps the
+  // LinearAlloc arenas) can safely run in the background.
+  Runtime* const runtime = Runtime::Current();
+  JavaVMExt* const vm = runtime->GetJavaVM();
+  for (const ClassLoaderData& data : to_delete) {
+    vm->DeleteWeakGlobalRef(self, data.weak_root);
+    if (runtime->GetJit() != nullptr) {
+      jit::JitCodeCache* code_cache = runtime->GetJit()->GetCodeCache();
+      if (code_cache != nullptr) {
+        code_cache->RemoveMethodsIn(self, *data.allocator);
+      }
+    }
+  }
+  gc::TaskProcessor* const task_processor = runtime->GetHeap()->GetTaskProcessor();
+  if (task_processor == nullptr || !task_processor->IsRunning()) {
+    // Too early in startup or too late in shutdown for background reclamation.
+    for (const ClassLoaderData& data : to_delete) {
+      reclaimed_class_loader_bytes_.FetchAndAddRelaxed(DeleteClassLoaderAllocations(data));
+    }
+    return;
+  }
+  bool add_task = false;
+  {
+    WriterMutexLock mu(self, *Locks::classlinker_classes_lock_);
+    pending_class_loader_reclaims_.insert(pending_class_loader_reclaims_.end(),
+                                          to_delete.begin(),
+                                          to_delete.end());
+    if (!class_loader_reclaim_task_pending_) {
+      class_loader_reclaim_task_pending_ = true;
+      add_task = true;
+    }
+  }
+  if (add_task) {
+    task_processor->AddTask(self, new ClassLoaderReclaimTask(NanoTime()));
+  }
+}
+
+bool ClassLinker::ReclaimNextDeadClassLoader(Thread* self) {
+  ClassLoaderData data;
+  bool more;
+  {
+    WriterMutexLock mu(self, *Locks::classlinker_classes_lock_);
+    DCHECK(class_loader_reclaim_task_pending_);
+    if (pending_class_loader_reclaims_.empty()) {
+      class_loader_reclaim_task_pending_ = false;
+      return false;
+    }
+    data = pending_class_loader_reclaims_.back();
+    pending_class_loader_reclaims_.pop_back();
+    more = !pending_class_loader_reclaims_.empty();
+    if (!more) {
+      // A GC finishing after this point queues a fresh task.
+      class_loader_reclaim_task_pending_ = false;
     }
   }
+  reclaimed_class_loader_bytes_.FetchAndAddRelaxed(DeleteClassLoaderAllocations(data));
+  return more;
 }
 
 std::set<DexCacheResolvedClasses> ClassLinker::GetResolvedClasses(bool ignore_boot_classes) {
@@ -28,6 +28,7 @@
 #include "base/hash_set.h"
 #include "base/macros.h"
 #include "base/mutex.h"
+#include "class_load_notifier.h"
 #include "class_table.h"
 #include "dex_cache_resolved_classes.h"
 #include "dex_file.h"
@@ -440,6 +441,15 @@ class ClassLinker {
                                                     LinearAlloc* allocator,
                                                     size_t length);
 
+  // Allocates the static and instance field arrays of a class in a single LinearAlloc block.
+  // Either array may come back null if its length is zero.
+  void AllocArtFieldArrays(Thread* self,
+                           LinearAlloc* allocator,
+                           size_t num_sfields,
+                           size_t num_ifields,
+                           LengthPrefixedArray<ArtField>** out_sfields,
+                           LengthPrefixedArray<ArtField>** out_ifields);
+
   LengthPrefixedArray<ArtMethod>* AllocArtMethodArray(Thread* self,
                                                       LinearAlloc* allocator,
                                                       size_t length);
@@ -520,6 +530,12 @@ class ClassLinker {
     return intern_table_;
   }
 
+  // Asynchronous class-load notifications, for listeners that do not need synchronous
+  // semantics and should stay off the class-loading critical path.
+  ClassLoadNotifier* GetClassLoadNotifier() {
+    return &class_load_notifier_;
+  }
+
   // Set the entrypoints up for method to the given code.
   void SetEntryPointsToCompiledCode(ArtMethod* method, const void* method_code) const
       SHARED_REQUIRES(Locks::mutator_lock_);
@@ -582,10 +598,21 @@ class ClassLinker {
   void DropFindArrayClassCache() SHARED_REQUIRES(Locks::mutator_lock_);
 
   // Clean up class loaders, this needs to happen after JNI weak globals are cleared.
+  // Dead class loaders are unhooked here but their native allocations are reclaimed
+  // by a background task, outside of the GC critical section.
   void CleanupClassLoaders()
       REQUIRES(!Locks::classlinker_classes_lock_)
       SHARED_REQUIRES(Locks::mutator_lock_);
 
+  // Reclaim the allocations of one dead class loader queued by CleanupClassLoaders. Called by
+  // the background reclamation task; returns true if more dead class loaders remain queued.
+  bool ReclaimNextDeadClassLoader(Thread* self) REQUIRES(!Locks::classlinker_classes_lock_);
+
+  // Total number of LinearAlloc bytes reclaimed from unloaded class loaders so far.
+  size_t GetReclaimedClassLoaderBytes() const {
+    return reclaimed_class_loader_bytes_.LoadRelaxed();
+  }
+
   // Unlike GetOrCreateAllocatorForClassLoader, GetAllocatorForClassLoader asserts that the
   // allocator for this class loader is already created.
   LinearAlloc* GetAllocatorForClassLoader(mirror::ClassLoader* class_loader)
@@ -678,6 +705,10 @@ class ClassLinker {
       REQUIRES(Locks::classlinker_classes_lock_)
       SHARED_REQUIRES(Locks::mutator_lock_);
 
+  // Delete the allocator and class table of a class loader that has already been removed from
+  // class_loaders_. Returns the number of LinearAlloc bytes reclaimed.
+  static size_t DeleteClassLoaderAllocations(const ClassLoaderData& data);
+
   void VisitClassLoaders(ClassLoaderVisitor* visitor) const
       SHARED_REQUIRES(Locks::classlinker_classes_lock_, Locks::mutator_lock_);
 
@@ -764,10 +795,15 @@ class ClassLinker {
   void LoadField(const ClassDataItemIterator& it, Handle<mirror::Class> klass, ArtField* dst)
       SHARED_REQUIRES(Locks::mutator_lock_);
 
+  // The dex cache arrays are passed in by LoadClassMembers so that they are fetched (and their
+  // read barriers taken) once per class instead of once per method.
   void LoadMethod(Thread* self,
                   const DexFile& dex_file,
                   const ClassDataItemIterator& it,
-                  Handle<mirror::Class> klass, ArtMethod* dst)
+                  Handle<mirror::Class> klass,
+                  ArtMethod** resolved_methods,
+                  GcRoot<mirror::Class>* resolved_types,
+                  ArtMethod* dst)
       SHARED_REQUIRES(Locks::mutator_lock_);
 
   void FixupStaticTrampolines(mirror::Class* klass) SHARED_REQUIRES(Locks::mutator_lock_);
@@ -1123,6 +1159,15 @@ class ClassLinker {
   std::list<ClassLoaderData> class_loaders_
       GUARDED_BY(Locks::classlinker_classes_lock_);
 
+  // Dead class loaders whose allocations have not been reclaimed by the background task yet,
+  // and whether such a task is currently queued on the heap task processor.
+  std::vector<ClassLoaderData> pending_class_loader_reclaims_
+      GUARDED_BY(Locks::classlinker_classes_lock_);
+  bool class_loader_reclaim_task_pending_ GUARDED_BY(Locks::classlinker_classes_lock_);
+
+  // Total number of LinearAlloc bytes reclaimed from unloaded class loaders.
+  Atomic<size_t> reclaimed_class_loader_bytes_;
+
   // Boot class path table. Since the class loader for this is null.
   ClassTable boot_class_table_ GUARDED_BY(Locks::classlinker_classes_lock_);
 
@@ -1152,6 +1197,9 @@ class ClassLinker {
 
   InternTable* intern_table_;
 
+  // Delivers class-load events to registered asynchronous listeners.
+  ClassLoadNotifier class_load_notifier_;
+
   // Trampolines within the image the bounce to runtime entrypoints. Done so that there is a single
   // patch point within the image. TODO: make these proper relocations.
   const void* quick_resolution_trampoline_;
@@ -1162,6 +1210,7 @@ class ClassLinker {
   // Image pointer size.
   size_t image_pointer_size_;
 
+  friend class DexCachePrefetcher;  // for DexLock, GetDexCachesData and FindDexCacheLocked
   friend class ImageDumper;  // for DexLock
   friend class ImageWriter;  // for GetClassRoots
   friend class JniCompilerTest;  // for GetRuntimeQuickGenericJniStub
@@ -0,0 +1,142 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "class_load_notifier.h"
+
+#include <algorithm>
+
+#include "base/logging.h"
+#include "thread.h"
+#include "utils.h"
+
+namespace art {
+
+// Bound on queued events so a stalled delivery thread cannot make class loading accumulate
+// unbounded memory. Events past the bound are dropped with a (rate-limited) warning; listeners
+// are advisory and must cope with loss.
+static constexpr size_t kMaxQueuedEvents = 1024;
+
+ClassLoadNotifier::ClassLoadNotifier()
+    : has_listeners_(false),
+      lock_("class load notifier lock"),
+      cond_("class load notifier condition", lock_),
+      dropped_events_(0u),
+      shutting_down_(false),
+      thread_started_(false) {
+}
+
+ClassLoadNotifier::~ClassLoadNotifier() {
+  Thread* self = Thread::Current();
+  bool join = false;
+  {
+    MutexLock mu(self, lock_);
+    shutting_down_ = true;
+    join = thread_started_;
+    cond_.Broadcast(self);
+  }
+  if (join) {
+    CHECK_PTHREAD_CALL(pthread_join, (delivery_thread_, nullptr),
+                       "class load delivery thread shutdown");
+  }
+}
+
+void ClassLoadNotifier::AddListener(ClassLoadListener* listener) {
+  Thread* self = Thread::Current();
+  MutexLock mu(self, lock_);
+  DCHECK(!shutting_down_);
+  listeners_.push_back(listener);
+  has_listeners_.StoreRelaxed(true);
+  if (!thread_started_) {
+    CHECK_PTHREAD_CALL(pthread_create,
+                       (&delivery_thread_, nullptr, &RunDeliveryThread, this),
+                       "class load delivery thread");
+    thread_started_ = true;
+  }
+}
+
+void ClassLoadNotifier::RemoveListener(ClassLoadListener* listener) {
+  Thread* self = Thread::Current();
+  MutexLock mu(self, lock_);
+  auto it = std::find(listeners_.begin(), listeners_.end(), listener);
+  DCHECK(it != listeners_.end());
+  listeners_.erase(it);
+  if (listeners_.empty()) {
+    has_listeners_.StoreRelaxed(false);
+  }
+}
+
+void ClassLoadNotifier::NotifyClassLoaded(const char* descriptor, const std::string& location) {
+  if (!has_listeners_.LoadRelaxed()) {
+    return;
+  }
+  Thread* self = Thread::Current();
+  MutexLock mu(self, lock_);
+  if (listeners_.empty() || shutting_down_) {
+    return;
+  }
+  if (events_.size() >= kMaxQueuedEvents) {
+    ++dropped_events_;
+    return;
+  }
+  events_.push_back(Event { descriptor, location });
+  cond_.Signal(self);
+}
+
+void* ClassLoadNotifier::RunDeliveryThread(void* arg) {
+  // Deliberately not attached to the runtime: listeners only receive strings, and staying
+  // unattached keeps the thread out of thread suspension and GC protocols.
+  SetThreadName("ClassLoadNotifier");
+  reinterpret_cast<ClassLoadNotifier*>(arg)->Run();
+  return nullptr;
+}
+
+void ClassLoadNotifier::Run() {
+  Thread* self = Thread::Current();
+  DCHECK(self == nullptr);
+  while (true) {
+    std::vector<ClassLoadListener*> listeners;
+    std::deque<Event> events;
+    {
+      MutexLock mu(self, lock_);
+      while (events_.empty() && !shutting_down_) {
+        cond_.Wait(self);
+      }
+      if (events_.empty()) {
+        DCHECK(shutting_down_);
+        return;
+      }
+      if (dropped_events_ != 0u) {
+        LOG(WARNING) << "Dropped " << dropped_events_ << " class load event(s): queue was full";
+        dropped_events_ = 0u;
+      }
+      listeners = listeners_;
+      events.swap(events_);
+    }
+    // Deliver outside the lock so slow listeners do not stall class-loading threads.
+    DeliverEvents(listeners, events);
+  }
+}
+
+void ClassLoadNotifier::DeliverEvents(const std::vector<ClassLoadListener*>& listeners,
+                                      const std::deque<Event>& events) {
+  for (const Event& event : events) {
+    for (ClassLoadListener* listener : listeners) {
+      listener->ClassLoaded(event.descriptor, event.location);
+    }
+  }
+}
+
+}  // namespace art
@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_CLASS_LOAD_NOTIFIER_H_
+#define ART_RUNTIME_CLASS_LOAD_NOTIFIER_H_
+
+#include <pthread.h>
+
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "atomic.h"
+#include "base/macros.h"
+#include "base/mutex.h"
+
+namespace art {
+
+// Listener for asynchronous class-load notifications. Listeners are invoked on a dedicated
+// background thread, not on the thread that loaded the class, and must not assume the class is
+// still loaded (or even that the runtime is in any particular state) by the time they run. The
+// delivery thread is not attached to the runtime, so listeners may not call into managed code
+// or use JNI.
+class ClassLoadListener {
+ public:
+  virtual ~ClassLoadListener() {}
+
+  // Called with the descriptor of the newly defined class and the location of the dex file it
+  // was defined from.
+  virtual void ClassLoaded(const std::string& descriptor, const std::string& location) = 0;
+};
+
+// Hands class-load events from ClassLinker::DefineClass to registered listeners on a background
+// thread, so that listener work stays off the class-loading critical path. Events are queued
+// under a dedicated lock that is only ever held briefly; when no listener is registered the
+// notification is a single relaxed atomic load.
+class ClassLoadNotifier {
+ public:
+  ClassLoadNotifier();
+  ~ClassLoadNotifier();
+
+  // Registers a listener and lazily starts the delivery thread. The listener must remain valid
+  // until it has been removed.
+  void AddListener(ClassLoadListener* listener) REQUIRES(!lock_);
+
+  // Unregisters a listener. On return the listener may still be mid-delivery on the background
+  // thread; it is only guaranteed to be quiescent once the notifier is destroyed.
+  void RemoveListener(ClassLoadListener* listener) REQUIRES(!lock_);
+
+  // Queues a class-load event for background delivery. Cheap if no listeners are registered.
+  void NotifyClassLoaded(const char* descriptor, const std::string& location) REQUIRES(!lock_);
+
+ private:
+  struct Event {
+    std::string descriptor;
+    std::string location;
+  };
+
+  static void* RunDeliveryThread(void* arg);
+  void Run() REQUIRES(!lock_);
+  void DeliverEvents(const std::vector<ClassLoadListener*>& listeners,
+                     const std::deque<Event>& events);
+
+  // Fast-path check for NotifyClassLoaded, updated under lock_ when listeners come and go.
+  Atomic<bool> has_listeners_;
+
+  Mutex lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
+  ConditionVariable cond_ GUARDED_BY(lock_);
+  std::vector<ClassLoadListener*> listeners_ GUARDED_BY(lock_);
+  std::deque<Event> events_ GUARDED_BY(lock_);
+  // Number of events dropped because the queue was full, pending a warning log.
+  size_t dropped_events_ GUARDED_BY(lock_);
+  bool shutting_down_ GUARDED_BY(lock_);
+  bool thread_started_ GUARDED_BY(lock_);
+  pthread_t delivery_thread_;
+
+  DISALLOW_COPY_AND_ASSIGN(ClassLoadNotifier);
+};
+
+}  // namespace art
+
+#endif  // ART_RUNTIME_CLASS_LOAD_NOTIFIER_H_
@@ -4402,13 +4402,34 @@ int Dbg::DdmHandleHpifChunk(HpifWhen when) {
   return true;
 }
 
+// Hashes of the HPSG pieces sent by the previous incremental heap segment poll, keyed by the
+// piece's starting address. DdmSendHeapSegments runs are serialized by GC completion, so the
+// map needs no locking of its own.
+static SafeMap<uintptr_t, uint64_t> gDdmHpsgPieceHashes;
+
+static void ClearDdmHpsgPieceHashes() {
+  gDdmHpsgPieceHashes.clear();
+}
+
+// 64-bit FNV-1a over an encoded piece. A collision makes us drop an update that the client then
+// keeps stale until the piece next changes; with a few hundred pieces per poll the odds are
+// negligible for tooling purposes.
+static uint64_t HashEncodedHeapPiece(const uint8_t* data, size_t length) {
+  uint64_t hash = UINT64_C(0xcbf29ce484222325);
+  for (size_t i = 0; i < length; ++i) {
+    hash = (hash ^ data[i]) * UINT64_C(0x100000001b3);
+  }
+  return hash;
+}
+
 bool Dbg::DdmHandleHpsgNhsgChunk(Dbg::HpsgWhen when, Dbg::HpsgWhat what, bool native) {
   if (when != HPSG_WHEN_NEVER && when != HPSG_WHEN_EVERY_GC) {
     LOG(ERROR) << "invalid HpsgWhen value: " << static_cast<int>(when);
     return false;
   }
 
-  if (what != HPSG_WHAT_MERGED_OBJECTS && what != HPSG_WHAT_DISTINCT_OBJECTS) {
+  if (what != HPSG_WHAT_MERGED_OBJECTS && what != HPSG_WHAT_DISTINCT_OBJECTS &&
+      what != HPSG_WHAT_MERGED_OBJECTS_INCREMENTAL) {
     LOG(ERROR) << "invalid HpsgWhat value: " << static_cast<int>(what);
     return false;
   }
@@ -4419,6 +4440,8 @@ bool Dbg::DdmHandleHpsgNhsgChunk(Dbg::HpsgWhen when, Dbg::HpsgWhat what, bool na
   } else {
     gDdmHpsgWhen = when;
     gDdmHpsgWhat = what;
+    // A (re)configured client has no previous poll to be incremental against.
+    ClearDdmHpsgPieceHashes();
   }
   return true;
 }
@@ -4491,9 +4514,11 @@ class HeapChunkContext {
  public:
   // Maximum chunk size.  Obtain this from the formula:
   // (((maximum_heap_size / ALLOCATION_UNIT_SIZE) + 255) / 256) * 2
-  HeapChunkContext(bool merge, bool native)
+  HeapChunkContext(bool merge, bool native, bool incremental)
       : buf_(16384 - 16),
         type_(0),
+        merge_(merge),
+        incremental_(incremental),
         chunk_overhead_(0) {
     Reset();
     if (native) {
@@ -4504,7 +4529,7 @@ class HeapChunkContext {
   }
 
   ~HeapChunkContext() {
-    if (p_ > &buf_[0]) {
+    if (p_ > &buf_[0] || run_length_ != 0) {
       Flush();
     }
   }
@@ -4523,6 +4548,7 @@ class HeapChunkContext {
     }
 
     // Start a new HPSx chunk.
+    piece_start_ = chunk_ptr;
     JDWP::Write4BE(&p_, 1);  // Heap id (bogus; we only have one heap).
     JDWP::Write1BE(&p_, 8);  // Size of allocation unit, in bytes.
 
@@ -4536,6 +4562,9 @@ class HeapChunkContext {
   }
 
   void Flush() SHARED_REQUIRES(Locks::mutator_lock_) {
+    if (run_length_ != 0) {
+      EmitRun();
+    }
     if (pieceLenField_ == nullptr) {
       // Flush immediately post Reset (maybe back-to-back Flush). Ignore.
       CHECK(needHeader_);
@@ -4546,7 +4575,9 @@ class HeapChunkContext {
     CHECK_LE(pieceLenField_, p_);
     JDWP::Set4BE(pieceLenField_, totalAllocationUnits_);
 
-    Dbg::DdmSendChunk(type_, p_ - &buf_[0], &buf_[0]);
+    if (!incremental_ || PieceChangedSinceLastPoll()) {
+      Dbg::DdmSendChunk(type_, p_ - &buf_[0], &buf_[0]);
+    }
     Reset();
   }
 
@@ -4570,6 +4601,23 @@ class HeapChunkContext {
     totalAllocationUnits_ = 0;
     needHeader_ = true;
     pieceLenField_ = nullptr;
+    piece_start_ = nullptr;
+    run_state_ = 0;
+    run_start_ = nullptr;
+    run_length_ = 0;
+  }
+
+  // Returns whether the encoded piece in buf_ differs from what the previous poll sent for the
+  // same starting address, updating the recorded hash either way.
+  bool PieceChangedSinceLastPoll() {
+    const uintptr_t key = reinterpret_cast<uintptr_t>(piece_start_);
+    const uint64_t hash = HashEncodedHeapPiece(&buf_[0], p_ - &buf_[0]);
+    auto it = gDdmHpsgPieceHashes.find(key);
+    if (it != gDdmHpsgPieceHashes.end() && it->second == hash) {
+      return false;
+    }
+    gDdmHpsgPieceHashes.Overwrite(key, hash);
+    return true;
   }
 
   bool IsNative() const {
@@ -4636,6 +4684,38 @@ class HeapChunkContext {
 
   void AppendChunk(uint8_t state, void* ptr, size_t length, bool is_native)
       SHARED_REQUIRES(Locks::mutator_lock_) {
+    if (merge_) {
+      // Coalesce adjacent chunks with an identical state so a run of same-kind objects costs
+      // two bytes per 256 allocation units instead of two bytes per object.
+      if (run_length_ != 0 &&
+          state == run_state_ &&
+          reinterpret_cast<uint8_t*>(run_start_) + run_length_ == ptr) {
+        run_length_ += length;
+        return;
+      }
+      if (run_length_ != 0) {
+        EmitRun();
+      }
+      run_state_ = state;
+      run_start_ = ptr;
+      run_length_ = length;
+      return;
+    }
+    WriteChunk(state, ptr, length, is_native);
+  }
+
+  void EmitRun() SHARED_REQUIRES(Locks::mutator_lock_) {
+    // Clear the run before writing: WriteChunk may Flush when the buffer runs full, and Flush
+    // re-enters here.
+    const uint8_t state = run_state_;
+    void* const start = run_start_;
+    const size_t length = run_length_;
+    run_length_ = 0;
+    WriteChunk(state, start, length, IsNative());
+  }
+
+  void WriteChunk(uint8_t state, void* ptr, size_t length, bool is_native)
+      SHARED_REQUIRES(Locks::mutator_lock_) {
     // Make sure there's enough room left in the buffer.
     // We need to use two bytes for every fractional 256 allocation units used by the chunk plus
     // 17 bytes for any header.
@@ -4716,6 +4796,14 @@ class HeapChunkContext {
   void* startOfNextMemoryChunk_;
   size_t totalAllocationUnits_;
   uint32_t type_;
+  bool merge_;
+  bool incremental_;
+  // Starting address of the piece currently in buf_, the key for the incremental hash map.
+  const void* piece_start_;
+  // Pending run of coalesced same-state chunks, not yet encoded into buf_.
+  uint8_t run_state_;
+  void* run_start_;
+  size_t run_length_;
   bool needHeader_;
   size_t chunk_overhead_;
 
@@ -4736,7 +4824,8 @@ void Dbg::DdmSendHeapSegments(bool native) {
     return;
   }
   // Figure out what kind of chunks we'll be sending.
-  CHECK(what == HPSG_WHAT_MERGED_OBJECTS || what == HPSG_WHAT_DISTINCT_OBJECTS)
+  CHECK(what == HPSG_WHAT_MERGED_OBJECTS || what == HPSG_WHAT_DISTINCT_OBJECTS ||
+        what == HPSG_WHAT_MERGED_OBJECTS_INCREMENTAL)
       << static_cast<int>(what);
 
   // First, send a heap start chunk.
@@ -4747,7 +4836,8 @@ void Dbg::DdmSendHeapSegments(bool native) {
   Locks::mutator_lock_->AssertSharedHeld(self);
 
   // Send a series of heap segment chunks.
-  HeapChunkContext context(what == HPSG_WHAT_MERGED_OBJECTS, native);
+  HeapChunkContext context(what != HPSG_WHAT_DISTINCT_OBJECTS, native,
+                           what == HPSG_WHAT_MERGED_OBJECTS_INCREMENTAL);
   if (native) {
     UNIMPLEMENTED(WARNING) << "Native heap inspection is not supported";
   } else {
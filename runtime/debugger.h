@@ -674,6 +674,10 @@ class Dbg {
   enum HpsgWhat {
     HPSG_WHAT_MERGED_OBJECTS = 0,
     HPSG_WHAT_DISTINCT_OBJECTS = 1,
+    // Like merged, but pieces identical to the previous poll are not retransmitted. Only
+    // clients that treat a missing piece as "unchanged" (our polling memory tooling) should
+    // request this.
+    HPSG_WHAT_MERGED_OBJECTS_INCREMENTAL = 2,
   };
   static bool DdmHandleHpsgNhsgChunk(HpsgWhen when, HpsgWhat what, bool native);
 
@@ -26,16 +26,34 @@
 namespace art {
 
 inline int32_t DexFile::GetStringLength(const StringId& string_id) const {
-  const uint8_t* ptr = begin_ + string_id.string_data_off_;
-  return DecodeUnsignedLeb128(&ptr);
+  uint32_t utf16_length;
+  GetStringDataAndUtf16Length(string_id, &utf16_length);
+  return utf16_length;
 }
 
 inline const char* DexFile::GetStringDataAndUtf16Length(const StringId& string_id,
                                                         uint32_t* utf16_length) const {
   DCHECK(utf16_length != nullptr) << GetLocation();
-  const uint8_t* ptr = begin_ + string_id.string_data_off_;
-  *utf16_length = DecodeUnsignedLeb128(&ptr);
-  return reinterpret_cast<const char*>(ptr);
+  Atomic<uint64_t>* cache = string_data_cache_.LoadRelaxed();
+  if (UNLIKELY(cache == nullptr)) {
+    cache = AllocateStringDataCache();
+    if (UNLIKELY(cache == nullptr)) {
+      // No string ids at all; decode directly.
+      const uint8_t* ptr = begin_ + string_id.string_data_off_;
+      *utf16_length = DecodeUnsignedLeb128(&ptr);
+      return reinterpret_cast<const char*>(ptr);
+    }
+  }
+  Atomic<uint64_t>& entry = cache[&string_id - string_ids_];
+  uint64_t value = entry.LoadRelaxed();
+  if (UNLIKELY(value == 0u)) {
+    const uint8_t* ptr = begin_ + string_id.string_data_off_;
+    const uint32_t length = DecodeUnsignedLeb128(&ptr);
+    value = (static_cast<uint64_t>(length) << 32) | static_cast<uint32_t>(ptr - begin_);
+    entry.StoreRelaxed(value);
+  }
+  *utf16_length = static_cast<uint32_t>(value >> 32);
+  return reinterpret_cast<const char*>(begin_ + static_cast<uint32_t>(value));
 }
 
 inline const Signature DexFile::GetMethodSignature(const MethodId& method_id) const {
@@ -459,6 +459,22 @@ DexFile::~DexFile() {
   // that's only called after DetachCurrentThread, which means there's no JNIEnv. We could
   // re-attach, but cleaning up these global references is not obviously useful. It's not as if
   // the global reference table is otherwise empty!
+  delete lazy_lookup_table_.LoadRelaxed();
+  delete[] string_data_cache_.LoadRelaxed();
+}
+
+Atomic<uint64_t>* DexFile::AllocateStringDataCache() const {
+  const uint32_t num_string_ids = NumStringIds();
+  if (num_string_ids == 0u) {
+    return nullptr;
+  }
+  Atomic<uint64_t>* cache = new Atomic<uint64_t>[num_string_ids]();
+  if (!string_data_cache_.CompareExchangeStrongSequentiallyConsistent(nullptr, cache)) {
+    // Another thread published its cache first.
+    delete[] cache;
+    cache = string_data_cache_.LoadSequentiallyConsistent();
+  }
+  return cache;
 }
 
 bool DexFile::Init(std::string* error_msg) {
@@ -511,10 +527,17 @@ uint32_t DexFile::Header::GetVersion() const {
   return atoi(version);
 }
 
+// Number of table-less FindClassDef calls after which a TypeLookupTable is built for the dex
+// file. Dex files loaded from bytecode (e.g. secondary multidex files of a plugin) have no
+// prebuilt table, and class loading from them is lookup-heavy enough that the table quickly
+// pays for its construction.
+static constexpr uint32_t kSlowClassDefLookupsForLazyTable = 16;
+
 const DexFile::ClassDef* DexFile::FindClassDef(const char* descriptor, size_t hash) const {
   DCHECK_EQ(ComputeModifiedUtf8Hash(descriptor), hash);
-  if (LIKELY(lookup_table_ != nullptr)) {
-    const uint32_t class_def_idx = lookup_table_->Lookup(descriptor, hash);
+  const TypeLookupTable* const lookup_table = GetTypeLookupTable();
+  if (LIKELY(lookup_table != nullptr)) {
+    const uint32_t class_def_idx = lookup_table->Lookup(descriptor, hash);
     return (class_def_idx != DexFile::kDexNoIndex) ? &GetClassDef(class_def_idx) : nullptr;
   }
 
@@ -523,6 +546,16 @@ const DexFile::ClassDef* DexFile::FindClassDef(const char* descriptor, size_t ha
   if (num_class_defs == 0) {
     return nullptr;
   }
+
+  // Exactly one thread observes the counter crossing the threshold, so only that thread builds
+  // the table; until it is published the others keep using the slow path below.
+  if (UNLIKELY(slow_class_def_lookups_.FetchAndAddRelaxed(1) ==
+               kSlowClassDefLookupsForLazyTable - 1)) {
+    TypeLookupTable* const table = TypeLookupTable::Create(*this);
+    lazy_lookup_table_.StoreRelease(table);
+    const uint32_t class_def_idx = table->Lookup(descriptor, hash);
+    return (class_def_idx != DexFile::kDexNoIndex) ? &GetClassDef(class_def_idx) : nullptr;
+  }
   const TypeId* type_id = FindTypeId(descriptor);
   if (type_id != nullptr) {
     uint16_t type_idx = GetIndexForTypeId(*type_id);
@@ -1279,6 +1312,35 @@ const DexFile::ParameterAnnotationsItem* DexFile::FindAnnotationsItemForMethod(A
   return nullptr;
 }
 
+bool DexFile::HasFastNativeMethodBuildAnnotation(uint32_t method_idx) const {
+  const MethodId& method_id = GetMethodId(method_idx);
+  const ClassDef* class_def = FindClassDef(method_id.class_idx_);
+  if (class_def == nullptr) {
+    return false;
+  }
+  const AnnotationsDirectoryItem* annotations_dir = GetAnnotationsDirectory(*class_def);
+  if (annotations_dir == nullptr) {
+    return false;
+  }
+  const MethodAnnotationsItem* method_annotations = GetMethodAnnotations(annotations_dir);
+  if (method_annotations == nullptr) {
+    return false;
+  }
+  uint32_t method_count = annotations_dir->methods_size_;
+  for (uint32_t i = 0; i < method_count; ++i) {
+    if (method_annotations[i].method_idx_ == method_idx) {
+      const AnnotationSetItem* annotation_set = GetMethodAnnotationSetItem(method_annotations[i]);
+      if (annotation_set == nullptr) {
+        return false;
+      }
+      return SearchAnnotationSet(annotation_set,
+                                 "Ldalvik/annotation/optimization/FastNative;",
+                                 kDexVisibilityBuild) != nullptr;
+    }
+  }
+  return false;
+}
+
 mirror::Object* DexFile::GetAnnotationDefaultValue(ArtMethod* method) const {
   mirror::Class* klass = method->GetDeclaringClass();
   const AnnotationsDirectoryItem* annotations_dir = GetAnnotationsDirectory(*klass->GetClassDef());
@@ -22,6 +22,7 @@
 #include <unordered_map>
 #include <vector>
 
+#include "atomic.h"
 #include "base/logging.h"
 #include "base/mutex.h"  // For Locks::mutator_lock_.
 #include "base/value_object.h"
@@ -1001,6 +1002,11 @@ class DexFile {
   bool IsMethodAnnotationPresent(ArtMethod* method, Handle<mirror::Class> annotation_class) const
       SHARED_REQUIRES(Locks::mutator_lock_);
 
+  // Returns whether the method carries the build-visibility FastNative annotation
+  // ("Ldalvik/annotation/optimization/FastNative;"). Unlike the accessors above this only needs
+  // the method index, so it can be used without a runtime, e.g. by the JNI stub compiler.
+  bool HasFastNativeMethodBuildAnnotation(uint32_t method_idx) const;
+
   const AnnotationSetItem* FindAnnotationSetForClass(Handle<mirror::Class> klass) const
       SHARED_REQUIRES(Locks::mutator_lock_);
   mirror::Object* GetAnnotationForClass(Handle<mirror::Class> klass,
@@ -1170,7 +1176,8 @@ class DexFile {
   }
 
   TypeLookupTable* GetTypeLookupTable() const {
-    return lookup_table_.get();
+    TypeLookupTable* const table = lookup_table_.get();
+    return table != nullptr ? table : lazy_lookup_table_.LoadAcquire();
   }
 
   void CreateTypeLookupTable(uint8_t* storage = nullptr) const;
@@ -1230,6 +1237,10 @@ class DexFile {
   // whether the string contains the separator character.
   static bool IsMultiDexLocation(const char* location);
 
+  // Allocates and publishes the string data cache, racing against other threads doing the
+  // same. Returns the published cache, or null for a dex file without string ids.
+  Atomic<uint64_t>* AllocateStringDataCache() const;
+
 
   // The base address of the memory mapping.
   const uint8_t* const begin_;
@@ -1275,6 +1286,22 @@ class DexFile {
   const OatDexFile* oat_dex_file_;
   mutable std::unique_ptr<TypeLookupTable> lookup_table_;
 
+  // Lookup table built lazily at runtime for dex files loaded without an oat file, once
+  // FindClassDef has taken the slow path often enough to amortize the construction. Owned by
+  // the dex file and published with an atomic store since FindClassDef runs concurrently
+  // without locks.
+  mutable Atomic<TypeLookupTable*> lazy_lookup_table_;
+
+  // Number of FindClassDef calls served without a lookup table.
+  mutable Atomic<uint32_t> slow_class_def_lookups_;
+
+  // Lazily allocated cache of decoded string_id data, indexed by string index: the utf16
+  // length in the high 32 bits and the offset of the string data (past its leb128 length
+  // prefix) in the low 32 bits. Zero means not yet decoded; a decoded entry is never zero
+  // because offset 0 lies inside the header. Entries are filled on first access and racing
+  // threads store identical values, so relaxed loads and stores suffice.
+  mutable Atomic<Atomic<uint64_t>*> string_data_cache_;
+
   friend class DexFileVerifierTest;
   ART_FRIEND_TEST(ClassLinkerTest, RegisterDexFileName);  // for constructor
 };
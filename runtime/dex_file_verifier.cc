@@ -19,6 +19,7 @@
 #include <inttypes.h>
 #include <zlib.h>
 
+#include <algorithm>
 #include <memory>
 
 #include "base/stringprintf.h"
@@ -431,6 +432,11 @@ bool DexFileVerifier::CheckMap() {
     ErrorStringPrintf("Map is missing class_defs entry");
     return false;
   }
+
+  // The map is now known to be well formed, so size the offset-to-type map for the
+  // exact number of data section items before the intra-section pass fills it in.
+  offset_to_type_map_.reserve(data_item_count);
+
   return true;
 }
 
@@ -1464,8 +1470,10 @@ bool DexFileVerifier::CheckIntraSectionIterate(size_t offset, uint32_t section_c
         ErrorStringPrintf("Item %d offset is 0", i);
         return false;
       }
-      DCHECK(offset_to_type_map_.Find(aligned_offset) == offset_to_type_map_.end());
-      offset_to_type_map_.Insert(std::pair<uint32_t, uint16_t>(aligned_offset, type));
+      // Items are visited in strictly increasing offset order, so appending keeps
+      // the vector sorted for the binary searches in CheckOffsetToTypeMap().
+      DCHECK(offset_to_type_map_.empty() || offset_to_type_map_.back().first < aligned_offset);
+      offset_to_type_map_.emplace_back(aligned_offset, type);
     }
 
     aligned_offset = ptr_ - begin_;
@@ -1639,8 +1647,13 @@ bool DexFileVerifier::CheckIntraSection() {
 
 bool DexFileVerifier::CheckOffsetToTypeMap(size_t offset, uint16_t type) {
   DCHECK_NE(offset, 0u);
-  auto it = offset_to_type_map_.Find(offset);
-  if (UNLIKELY(it == offset_to_type_map_.end())) {
+  auto it = std::lower_bound(offset_to_type_map_.begin(),
+                             offset_to_type_map_.end(),
+                             offset,
+                             [](const std::pair<uint32_t, uint16_t>& entry, size_t value) {
+                               return entry.first < value;
+                             });
+  if (UNLIKELY(it == offset_to_type_map_.end() || it->first != offset)) {
     ErrorStringPrintf("No data map entry found @ %zx; expected %x", offset, type);
     return false;
   }
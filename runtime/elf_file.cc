@@ -17,9 +17,12 @@
 #include "elf_file.h"
 
 #include <inttypes.h>
+#include <string.h>
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <algorithm>
+
 #include "arch/instruction_set.h"
 #include "base/logging.h"
 #include "base/stringprintf.h"
@@ -844,7 +847,6 @@ typename ElfTypes::Sym* ElfFileImpl<ElfTypes>::FindSymbolByName(
   if (*symbol_table != nullptr || build_map) {
     if (*symbol_table == nullptr) {
       DCHECK(build_map);
-      *symbol_table = new SymbolTable;
       Elf_Shdr* symbol_section = FindSectionByType(section_type);
       if (symbol_section == nullptr) {
         return nullptr;  // Failure condition.
@@ -853,6 +855,8 @@ typename ElfTypes::Sym* ElfFileImpl<ElfTypes>::FindSymbolByName(
       if (string_section == nullptr) {
         return nullptr;  // Failure condition.
       }
+      std::unique_ptr<SymbolTable> table(new SymbolTable);
+      table->reserve(GetSymbolNum(*symbol_section));
       for (uint32_t i = 0; i < GetSymbolNum(*symbol_section); i++) {
         Elf_Sym* symbol = GetSymbol(section_type, i);
         if (symbol == nullptr) {
@@ -868,23 +872,37 @@ typename ElfTypes::Sym* ElfFileImpl<ElfTypes>::FindSymbolByName(
         if (name == nullptr) {
           continue;
         }
-        std::pair<typename SymbolTable::iterator, bool> result =
-            (*symbol_table)->insert(std::make_pair(name, symbol));
-        if (!result.second) {
-          // If a duplicate, make sure it has the same logical value. Seen on x86.
-          if ((symbol->st_value != result.first->second->st_value) ||
-              (symbol->st_size != result.first->second->st_size) ||
-              (symbol->st_info != result.first->second->st_info) ||
-              (symbol->st_other != result.first->second->st_other) ||
-              (symbol->st_shndx != result.first->second->st_shndx)) {
-            return nullptr;  // Failure condition.
-          }
+        table->push_back(std::make_pair(name, symbol));
+      }
+      std::sort(table->begin(), table->end(),
+                [](const std::pair<const char*, Elf_Sym*>& lhs,
+                   const std::pair<const char*, Elf_Sym*>& rhs) {
+                  return strcmp(lhs.first, rhs.first) < 0;
+                });
+      // Duplicate names must have the same logical value. Seen on x86.
+      for (size_t i = 1; i < table->size(); ++i) {
+        const Elf_Sym* prev = (*table)[i - 1].second;
+        const Elf_Sym* curr = (*table)[i].second;
+        if (strcmp((*table)[i - 1].first, (*table)[i].first) == 0 &&
+            ((curr->st_value != prev->st_value) ||
+             (curr->st_size != prev->st_size) ||
+             (curr->st_info != prev->st_info) ||
+             (curr->st_other != prev->st_other) ||
+             (curr->st_shndx != prev->st_shndx))) {
+          return nullptr;  // Failure condition.
         }
       }
+      *symbol_table = table.release();
     }
     CHECK(*symbol_table != nullptr);
-    typename SymbolTable::const_iterator it = (*symbol_table)->find(symbol_name);
-    if (it == (*symbol_table)->end()) {
+    typename SymbolTable::const_iterator it =
+        std::lower_bound((*symbol_table)->begin(),
+                         (*symbol_table)->end(),
+                         symbol_name.c_str(),
+                         [](const std::pair<const char*, Elf_Sym*>& entry, const char* name) {
+                           return strcmp(entry.first, name) < 0;
+                         });
+    if (it == (*symbol_table)->end() || symbol_name != it->first) {
       return nullptr;
     }
     return it->second;
@@ -155,7 +155,10 @@ class ElfFileImpl {
   Elf_Word GetHashBucket(size_t i, bool* ok) const;
   Elf_Word GetHashChain(size_t i, bool* ok) const;
 
-  typedef std::map<std::string, Elf_Sym*> SymbolTable;
+  // Table of symbols sorted by name, built on demand by FindSymbolByName(). A sorted
+  // vector of pointers into the mapped string section is denser than a map keyed by
+  // std::string copies and is searched with a binary search.
+  typedef std::vector<std::pair<const char*, Elf_Sym*>> SymbolTable;
   SymbolTable** GetSymbolTable(Elf_Word section_type);
 
   bool ValidPointer(const uint8_t* start) const;
@@ -559,7 +559,7 @@ inline ArtMethod* FindMethodFromCode(uint32_t method_idx, mirror::Object** this_
       }
     }
     case kInterface: {
-      uint32_t imt_index = resolved_method->GetDexMethodIndex() % mirror::Class::kImtSize;
+      uint32_t imt_index = resolved_method->GetImtIndex() % mirror::Class::kImtSize;
       ArtMethod* imt_method = (*this_object)->GetClass()->GetEmbeddedImTableEntry(
           imt_index, class_linker->GetImagePointerSize());
       if (!imt_method->IsRuntimeMethod()) {
@@ -154,8 +154,10 @@ JValue InvokeProxyInvocationHandler(ScopedObjectAccessAlreadyRunnable& soa, cons
     }
     for (size_t i = 0; i < args.size(); ++i) {
       if (shorty[i + 1] == 'L') {
-        jobject val = args.at(i).l;
-        soa.Env()->SetObjectArrayElement(args_jobj, i, val);
+        // Any reference is assignable to an Object[] element, so store directly instead of
+        // paying for a JNI transition and store check per argument.
+        mirror::Object* val = soa.Decode<mirror::Object*>(args.at(i).l);
+        soa.Decode<mirror::ObjectArray<mirror::Object>*>(args_jobj)->Set<false>(i, val);
       } else {
         JValue jv;
         jv.SetJ(args.at(i).j);
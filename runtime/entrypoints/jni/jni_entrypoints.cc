@@ -31,7 +31,11 @@ extern "C" void* artFindNativeMethod() {
 extern "C" void* artFindNativeMethod(Thread* self) {
   DCHECK_EQ(self, Thread::Current());
 #endif
-  Locks::mutator_lock_->AssertNotHeld(self);  // We come here as Native.
+  // We usually come here as Native; a fast JNI stub, however, never left the runnable state and
+  // still holds its share of the mutator lock. ScopedObjectAccess copes with both states.
+  if (self->GetState() != kRunnable) {
+    Locks::mutator_lock_->AssertNotHeld(self);
+  }
   ScopedObjectAccess soa(self);
 
   ArtMethod* method = self->GetCurrentMethod(nullptr);
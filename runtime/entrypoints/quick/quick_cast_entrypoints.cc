@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 
+#include "entrypoints/quick/quick_entrypoint_counters.h"
 #include "mirror/class-inl.h"
 #include "mirror/object-inl.h"
 
@@ -24,6 +25,7 @@ extern "C" uint32_t artIsAssignableFromCode(mirror::Class* klass, mirror::Class*
     SHARED_REQUIRES(Locks::mutator_lock_) {
   DCHECK(klass != nullptr);
   DCHECK(ref_class != nullptr);
+  CountEntrypointHit(kQuickInstanceofNonTrivial);
   return klass->IsAssignableFrom(ref_class) ? 1 : 0;
 }
 
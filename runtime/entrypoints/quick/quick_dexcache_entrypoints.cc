@@ -17,28 +17,73 @@
 #include "art_method-inl.h"
 #include "callee_save_frame.h"
 #include "entrypoints/entrypoint_utils-inl.h"
+#include "entrypoints/quick/quick_entrypoint_counters.h"
 #include "class_linker-inl.h"
 #include "dex_file-inl.h"
+#include "entrypoints/runtime_asm_entrypoints.h"
 #include "gc/accounting/card_table-inl.h"
+#include "jit/jit.h"
+#include "jit/jit_code_cache.h"
 #include "mirror/object_array-inl.h"
 #include "mirror/object-inl.h"
+#include "oat_quick_method_header.h"
 
 namespace art {
 
+// A class initialization check compiled while its class was still uninitialized becomes dead
+// weight the moment the class reaches the initialized state: initialization is sticky, so the
+// status load and branch can never take the slow path again. We cannot patch emitted code, but
+// for JIT-compiled callers we can throw the code away; the recompilation observes the
+// now-initialized class and emits no check at all (see HInstructionBuilder::IsInitialized).
+// This costs one extra compilation per (caller, initialization) pair, paid once on the JIT
+// thread, in exchange for dropping the dependent load and branch from every later execution.
+// AOT code is left alone.
+static void InvalidateJitCallerForDeadClinitCheck(Thread* self, mirror::Class* klass)
+    SHARED_REQUIRES(Locks::mutator_lock_) {
+  Runtime* runtime = Runtime::Current();
+  jit::Jit* jit = runtime->GetJit();
+  if (jit == nullptr || klass == nullptr || !klass->IsInitialized()) {
+    // No JIT, initialization threw, or the class is still initializing in this very thread
+    // (recursive use from its own <clinit>); the check in the caller is still live.
+    return;
+  }
+  ArtMethod** sp = self->GetManagedStack()->GetTopQuickFrame();
+  DCHECK_EQ(*sp, runtime->GetCalleeSaveMethod(Runtime::kRefsOnly));
+  const size_t return_pc_offset = GetCalleeSaveReturnPcOffset(kRuntimeISA, Runtime::kRefsOnly);
+  uintptr_t caller_pc = *reinterpret_cast<uintptr_t*>(
+      reinterpret_cast<uint8_t*>(sp) + return_pc_offset);
+  if (caller_pc == reinterpret_cast<uintptr_t>(GetQuickInstrumentationExitPc()) ||
+      !jit->GetCodeCache()->ContainsPc(reinterpret_cast<const void*>(caller_pc))) {
+    return;
+  }
+  const size_t callee_frame_size = GetCalleeSaveFrameSize(kRuntimeISA, Runtime::kRefsOnly);
+  ArtMethod* outer_method = *reinterpret_cast<ArtMethod**>(
+      reinterpret_cast<uintptr_t>(sp) + callee_frame_size);
+  if (outer_method == nullptr) {
+    return;
+  }
+  const OatQuickMethodHeader* header = outer_method->GetOatQuickMethodHeader(caller_pc);
+  jit->GetCodeCache()->InvalidateCompiledCodeFor(outer_method, header);
+}
+
 extern "C" mirror::Class* artInitializeStaticStorageFromCode(uint32_t type_idx, Thread* self)
     SHARED_REQUIRES(Locks::mutator_lock_) {
   // Called to ensure static storage base is initialized for direct static field reads and writes.
   // A class may be accessing another class' fields when it doesn't have access, as access has been
   // given by inheritance.
   ScopedQuickEntrypointChecks sqec(self);
+  CountEntrypointHit(kQuickInitializeStaticStorage);
   auto* caller = GetCalleeSaveMethodCaller(self, Runtime::kRefsOnly);
-  return ResolveVerifyAndClinit(type_idx, caller, self, true, false);
+  mirror::Class* result = ResolveVerifyAndClinit(type_idx, caller, self, true, false);
+  InvalidateJitCallerForDeadClinitCheck(self, result);
+  return result;
 }
 
 extern "C" mirror::Class* artInitializeTypeFromCode(uint32_t type_idx, Thread* self)
     SHARED_REQUIRES(Locks::mutator_lock_) {
   // Called when method->dex_cache_resolved_types_[] misses.
   ScopedQuickEntrypointChecks sqec(self);
+  CountEntrypointHit(kQuickInitializeType);
   auto* caller = GetCalleeSaveMethodCaller(self, Runtime::kRefsOnly);
   return ResolveVerifyAndClinit(type_idx, caller, self, false, false);
 }
@@ -48,6 +93,7 @@ extern "C" mirror::Class* artInitializeTypeAndVerifyAccessFromCode(uint32_t type
   // Called when caller isn't guaranteed to have access to a type and the dex cache may be
   // unpopulated.
   ScopedQuickEntrypointChecks sqec(self);
+  CountEntrypointHit(kQuickInitializeTypeAndVerifyAccess);
   auto* caller = GetCalleeSaveMethodCaller(self, Runtime::kRefsOnly);
   return ResolveVerifyAndClinit(type_idx, caller, self, false, true);
 }
@@ -55,6 +101,7 @@ extern "C" mirror::Class* artInitializeTypeAndVerifyAccessFromCode(uint32_t type
 extern "C" mirror::String* artResolveStringFromCode(int32_t string_idx, Thread* self)
     SHARED_REQUIRES(Locks::mutator_lock_) {
   ScopedQuickEntrypointChecks sqec(self);
+  CountEntrypointHit(kQuickResolveString);
   auto* caller = GetCalleeSaveMethodCaller(self, Runtime::kRefsOnly);
   return ResolveStringFromCode(caller, string_idx);
 }
@@ -0,0 +1,69 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "quick_entrypoint_counters.h"
+
+#include <algorithm>
+#include <ostream>
+#include <utility>
+#include <vector>
+
+namespace art {
+
+Atomic<uint64_t> gEntrypointHitCounts[kEntrypointCounterStripes][kNumQuickEntrypoints];
+
+static const char* const kQuickEntrypointNames[] = {
+#define ENTRYPOINT_ENUM(name, rettype, ...) #name,
+#include "quick_entrypoints_list.h"
+  QUICK_ENTRYPOINT_LIST(ENTRYPOINT_ENUM)
+#undef QUICK_ENTRYPOINT_LIST
+#undef ENTRYPOINT_ENUM
+};
+
+void DumpEntrypointCounters(std::ostream& os) {
+  if (!kCountEntrypointHits) {
+    return;
+  }
+  std::vector<std::pair<uint64_t, size_t>> counts;
+  for (size_t i = 0; i < kNumQuickEntrypoints; ++i) {
+    uint64_t sum = 0u;
+    for (size_t stripe = 0; stripe < kEntrypointCounterStripes; ++stripe) {
+      sum += gEntrypointHitCounts[stripe][i].LoadRelaxed();
+    }
+    if (sum != 0u) {
+      counts.push_back(std::make_pair(sum, i));
+    }
+  }
+  if (counts.empty()) {
+    return;
+  }
+  std::sort(counts.begin(), counts.end(), std::greater<std::pair<uint64_t, size_t>>());
+  os << "Quick entrypoint hit counts (most hit first):\n";
+  for (const std::pair<uint64_t, size_t>& count : counts) {
+    os << "  " << kQuickEntrypointNames[count.second] << ": " << count.first << "\n";
+  }
+  os << "\n";
+}
+
+void ResetEntrypointCounters() {
+  for (size_t stripe = 0; stripe < kEntrypointCounterStripes; ++stripe) {
+    for (size_t i = 0; i < kNumQuickEntrypoints; ++i) {
+      gEntrypointHitCounts[stripe][i].StoreRelaxed(0u);
+    }
+  }
+}
+
+}  // namespace art
@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_ENTRYPOINTS_QUICK_QUICK_ENTRYPOINT_COUNTERS_H_
+#define ART_RUNTIME_ENTRYPOINTS_QUICK_QUICK_ENTRYPOINT_COUNTERS_H_
+
+#include <sched.h>
+
+#include <iosfwd>
+
+#include "atomic.h"
+#include "base/macros.h"
+#include "quick_entrypoints_enum.h"
+
+namespace art {
+
+// Count hits on the quick entrypoint slow paths, dumpable via SIGQUIT. To enable the
+// counters, set this to true. The counts are cleared together with the VMDebug
+// allocation statistics (VMDebug.resetAllocCount).
+static constexpr bool kCountEntrypointHits = false;
+
+// One past the last value of QuickEntrypointEnum.
+static constexpr size_t kNumQuickEntrypoints =
+    static_cast<size_t>(kQuickReadBarrierForRootSlow) + 1u;
+
+// The counters are striped so that concurrent increments from different cpus mostly hit
+// different cache lines; readers sum the stripes. A single (unused) stripe is kept when
+// counting is disabled so that the modulo below stays well defined.
+static constexpr size_t kEntrypointCounterStripes = kCountEntrypointHits ? 8 : 1;
+
+extern Atomic<uint64_t> gEntrypointHitCounts[kEntrypointCounterStripes][kNumQuickEntrypoints];
+
+// Records one hit on the given entrypoint. Compiles away when the counters are disabled.
+// The increment is relaxed and the stripe is only a contention hint, so counts are cheap
+// but not exact under preemption; that is fine for a frequency profile.
+ALWAYS_INLINE static inline void CountEntrypointHit(QuickEntrypointEnum entrypoint) {
+  if (!kCountEntrypointHits) {
+    return;
+  }
+  const int cpu = sched_getcpu();
+  const size_t stripe = (cpu >= 0) ? (static_cast<size_t>(cpu) % kEntrypointCounterStripes) : 0u;
+  gEntrypointHitCounts[stripe][entrypoint].FetchAndAddRelaxed(1u);
+}
+
+// Writes all non-zero counters to |os|, most frequently hit entrypoint first.
+void DumpEntrypointCounters(std::ostream& os);
+
+// Clears all counters.
+void ResetEntrypointCounters();
+
+}  // namespace art
+
+#endif  // ART_RUNTIME_ENTRYPOINTS_QUICK_QUICK_ENTRYPOINT_COUNTERS_H_
@@ -16,6 +16,7 @@
 
 #include "callee_save_frame.h"
 #include "common_throws.h"
+#include "entrypoints/quick/quick_entrypoint_counters.h"
 #include "mirror/object-inl.h"
 
 namespace art {
@@ -25,6 +26,7 @@ extern "C" int artLockObjectFromCode(mirror::Object* obj, Thread* self)
     REQUIRES(!Roles::uninterruptible_)
     SHARED_REQUIRES(Locks::mutator_lock_) /* EXCLUSIVE_LOCK_FUNCTION(Monitor::monitor_lock_) */ {
   ScopedQuickEntrypointChecks sqec(self);
+  CountEntrypointHit(kQuickLockObject);
   if (UNLIKELY(obj == nullptr)) {
     ThrowNullPointerException("Null reference used for synchronization (monitor-enter)");
     return -1;  // Failure.
@@ -46,6 +48,7 @@ extern "C" int artUnlockObjectFromCode(mirror::Object* obj, Thread* self)
     REQUIRES(!Roles::uninterruptible_)
     SHARED_REQUIRES(Locks::mutator_lock_) /* UNLOCK_FUNCTION(Monitor::monitor_lock_) */ {
   ScopedQuickEntrypointChecks sqec(self);
+  CountEntrypointHit(kQuickUnlockObject);
   if (UNLIKELY(obj == nullptr)) {
     ThrowNullPointerException("Null reference used for synchronization (monitor-exit)");
     return -1;  // Failure.
@@ -17,6 +17,7 @@
 #include "mod_union_table.h"
 
 #include <memory>
+#include <vector>
 
 #include "base/stl_util.h"
 #include "bitmap-inl.h"
@@ -446,31 +447,35 @@ ModUnionTableCardCache::ModUnionTableCardCache(const std::string& name,
       RoundUp(reinterpret_cast<uintptr_t>(space->Limit()), CardTable::kCardSize)));
 }
 
-class CardBitVisitor {
+// Visitor used when scanning a coalesced run of dirty cards: marks through each object's
+// references and re-dirties the card covering the object's start if it still references
+// another space.
+class CardRunRedirtyVisitor {
  public:
-  CardBitVisitor(MarkObjectVisitor* visitor,
-                 space::ContinuousSpace* space,
-                 space::ContinuousSpace* immune_space,
-                 ModUnionTable::CardBitmap* card_bitmap)
+  CardRunRedirtyVisitor(MarkObjectVisitor* visitor,
+                        space::ContinuousSpace* space,
+                        space::ContinuousSpace* immune_space,
+                        ModUnionTable::CardBitmap* card_bitmap)
       : visitor_(visitor),
         space_(space),
         immune_space_(immune_space),
-        bitmap_(space->GetLiveBitmap()),
         card_bitmap_(card_bitmap) {
     DCHECK(immune_space_ != nullptr);
   }
 
-  void operator()(size_t bit_index) const {
-    const uintptr_t start = card_bitmap_->AddrFromBitIndex(bit_index);
-    DCHECK(space_->HasAddress(reinterpret_cast<mirror::Object*>(start)))
-        << start << " " << *space_;
+  void operator()(mirror::Object* obj) const
+      REQUIRES(Locks::heap_bitmap_lock_)
+      SHARED_REQUIRES(Locks::mutator_lock_) {
+    DCHECK(obj != nullptr);
     bool reference_to_other_space = false;
-    ModUnionScanImageRootVisitor scan_visitor(visitor_, space_, immune_space_,
-                                              &reference_to_other_space);
-    bitmap_->VisitMarkedRange(start, start + CardTable::kCardSize, scan_visitor);
-    if (!reference_to_other_space) {
-      // No non null reference to another space, clear the bit.
-      card_bitmap_->ClearBit(bit_index);
+    ModUnionUpdateObjectReferencesVisitor ref_visitor(visitor_,
+                                                      space_,
+                                                      immune_space_,
+                                                      &reference_to_other_space);
+    obj->VisitReferences(ref_visitor, VoidFunctor());
+    if (reference_to_other_space) {
+      // Keep the card dirty so the reference is found again next cycle.
+      card_bitmap_->Set(reinterpret_cast<uintptr_t>(obj));
     }
   }
 
@@ -478,10 +483,8 @@ class CardBitVisitor {
   MarkObjectVisitor* const visitor_;
   space::ContinuousSpace* const space_;
   space::ContinuousSpace* const immune_space_;
-  ContinuousSpaceBitmap* const bitmap_;
   ModUnionTable::CardBitmap* const card_bitmap_;
 };
-
 void ModUnionTableCardCache::ClearCards() {
   CardTable* const card_table = GetHeap()->GetCardTable();
   ModUnionAddToCardBitmapVisitor visitor(card_bitmap_.get(), card_table);
@@ -494,12 +497,36 @@ void ModUnionTableCardCache::UpdateAndMarkReferences(MarkObjectVisitor* visitor)
   // TODO: Needs better support for multi-images? b/26317072
   space::ImageSpace* image_space =
       heap_->GetBootImageSpaces().empty() ? nullptr : heap_->GetBootImageSpaces()[0];
+  // Gather the dirty card indices once, then scan each maximal run of contiguous dirty cards
+  // with a single VisitMarkedRange call. Heavy class initialization dirties long contiguous
+  // ranges of image space cards, and one live bitmap walk per run is much cheaper than one per
+  // card.
+  std::vector<size_t> dirty_bits;
+  card_bitmap_->VisitSetBits(
+      0,
+      RoundUp(space_->Size(), CardTable::kCardSize) / CardTable::kCardSize,
+      [&dirty_bits](size_t bit_index) { dirty_bits.push_back(bit_index); });
   // If we don't have an image space, just pass in space_ as the immune space. Pass in the same
   // space_ instead of image_space to avoid a null check in ModUnionUpdateObjectReferencesVisitor.
-  CardBitVisitor bit_visitor(visitor, space_, image_space != nullptr ? image_space : space_,
+  CardRunRedirtyVisitor scan_visitor(visitor, space_, image_space != nullptr ? image_space : space_,
       card_bitmap_.get());
-  card_bitmap_->VisitSetBits(
-      0, RoundUp(space_->Size(), CardTable::kCardSize) / CardTable::kCardSize, bit_visitor);
+  ContinuousSpaceBitmap* const live_bitmap = space_->GetLiveBitmap();
+  for (size_t i = 0; i < dirty_bits.size();) {
+    size_t run_end = i + 1;
+    while (run_end < dirty_bits.size() && dirty_bits[run_end] == dirty_bits[run_end - 1] + 1) {
+      ++run_end;
+    }
+    const uintptr_t start = card_bitmap_->AddrFromBitIndex(dirty_bits[i]);
+    const uintptr_t end =
+        card_bitmap_->AddrFromBitIndex(dirty_bits[run_end - 1]) + CardTable::kCardSize;
+    // Clear the whole run up front; the visitor re-dirties the cards of objects which still
+    // reference another space.
+    for (size_t j = i; j < run_end; ++j) {
+      card_bitmap_->ClearBit(dirty_bits[j]);
+    }
+    live_bitmap->VisitMarkedRange(start, end, scan_visitor);
+    i = run_end;
+  }
 }
 
 void ModUnionTableCardCache::Dump(std::ostream& os) {
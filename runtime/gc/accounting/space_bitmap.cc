@@ -162,23 +162,46 @@ void SpaceBitmap<kAlignment>::SweepWalk(const SpaceBitmap<kAlignment>& live_bitm
   CHECK_LT(end, live_bitmap.Size() / sizeof(intptr_t));
   uintptr_t* live = live_bitmap.bitmap_begin_;
   uintptr_t* mark = mark_bitmap.bitmap_begin_;
-  for (size_t i = start; i <= end; i++) {
-    uintptr_t garbage = live[i] & ~mark[i];
-    if (UNLIKELY(garbage != 0)) {
-      uintptr_t ptr_base = IndexToOffset(i) + live_bitmap.heap_begin_;
-      do {
-        const size_t shift = CTZ(garbage);
-        garbage ^= (static_cast<uintptr_t>(1)) << shift;
-        *pb++ = reinterpret_cast<mirror::Object*>(ptr_base + shift * kAlignment);
-      } while (garbage != 0);
-      // Make sure that there are always enough slots available for an
-      // entire word of one bits.
-      if (pb >= &pointer_buf[buffer_size - kBitsPerIntPtrT]) {
-        (*callback)(pb - &pointer_buf[0], &pointer_buf[0], arg);
-        pb = &pointer_buf[0];
+  auto sweep_word = [&](size_t index, uintptr_t garbage) {
+    uintptr_t ptr_base = IndexToOffset(index) + live_bitmap.heap_begin_;
+    do {
+      const size_t shift = CTZ(garbage);
+      garbage ^= (static_cast<uintptr_t>(1)) << shift;
+      *pb++ = reinterpret_cast<mirror::Object*>(ptr_base + shift * kAlignment);
+    } while (garbage != 0);
+    // Make sure that there are always enough slots available for an
+    // entire word of one bits.
+    if (pb >= &pointer_buf[buffer_size - kBitsPerIntPtrT]) {
+      (*callback)(pb - &pointer_buf[0], &pointer_buf[0], arg);
+      pb = &pointer_buf[0];
+    }
+  };
+  // Diff the bitmaps a block of words at a time. Blocks with no dead objects, the common case
+  // for mostly-live or untouched ranges, are rejected with a single branch, and the
+  // straight-line word-parallel diff is amenable to compiler vectorization (NEON/SSE2).
+  constexpr size_t kSweepBlockWords = 4;
+  size_t i = start;
+  for (; i + kSweepBlockWords <= end + 1; i += kSweepBlockWords) {
+    uintptr_t any_garbage = 0;
+    for (size_t j = 0; j < kSweepBlockWords; ++j) {
+      any_garbage |= live[i + j] & ~mark[i + j];
+    }
+    if (LIKELY(any_garbage == 0)) {
+      continue;
+    }
+    for (size_t j = 0; j < kSweepBlockWords; ++j) {
+      const uintptr_t garbage = live[i + j] & ~mark[i + j];
+      if (garbage != 0) {
+        sweep_word(i + j, garbage);
       }
     }
   }
+  for (; i <= end; i++) {
+    const uintptr_t garbage = live[i] & ~mark[i];
+    if (UNLIKELY(garbage != 0)) {
+      sweep_word(i, garbage);
+    }
+  }
   if (pb > &pointer_buf[0]) {
     (*callback)(pb - &pointer_buf[0], &pointer_buf[0], arg);
   }
@@ -18,6 +18,7 @@
 
 #include "art_method-inl.h"
 #include "base/stl_util.h"
+#include "mirror/class-inl.h"
 #include "stack.h"
 
 #ifdef __ANDROID__
@@ -71,6 +72,25 @@ void AllocRecordObjectMap::SetProperties() {
       recent_record_max_ = value;
     }
   }
+  // Check whether there's a system property enabling byte-interval sampling.
+  propertyName = "debug.allocTracker.sampleIntervalBytes";
+  char sampleIntervalString[PROPERTY_VALUE_MAX];
+  if (property_get(propertyName, sampleIntervalString, "") > 0) {
+    char* end;
+    size_t value = strtoul(sampleIntervalString, &end, 10);
+    if (*end != '\0') {
+      LOG(ERROR) << "Ignoring  " << propertyName << " '" << sampleIntervalString
+                 << "' --- invalid";
+    } else {
+      sample_interval_bytes_ = value;
+    }
+  }
+  // Check whether there's a system property selecting an allocation trace file.
+  propertyName = "debug.allocTracker.traceFile";
+  char traceFileString[PROPERTY_VALUE_MAX];
+  if (property_get(propertyName, traceFileString, "") > 0) {
+    trace_file_path_ = traceFileString;
+  }
   // Check whether there's a system property overriding the max depth of stack trace.
   propertyName = "debug.allocTracker.stackDepth";
   char stackDepthString[PROPERTY_VALUE_MAX];
@@ -115,6 +135,16 @@ void AllocRecordObjectMap::VisitRoots(RootVisitor* visitor) {
       element.GetMethod()->VisitRoots(buffered_visitor, sizeof(void*));
     }
   }
+  // Aggregated traces can outlive the records they were sampled from, so their methods must be
+  // kept alive as well.
+  for (const auto& it : aggregated_samples_) {
+    const AllocRecordStackTrace& trace = it.first;
+    for (size_t i = 0, depth = trace.GetDepth(); i < depth; ++i) {
+      ArtMethod* method = trace.GetStackElement(i).GetMethod();
+      DCHECK(method != nullptr);
+      method->VisitRoots(buffered_visitor, sizeof(void*));
+    }
+  }
 }
 
 static inline void SweepClassObject(AllocRecord* record, IsMarkedVisitor* visitor)
@@ -137,6 +167,11 @@ static inline void SweepClassObject(AllocRecord* record, IsMarkedVisitor* visito
 void AllocRecordObjectMap::SweepAllocationRecords(IsMarkedVisitor* visitor) {
   VLOG(heap) << "Start SweepAllocationRecords()";
   size_t count_deleted = 0, count_moved = 0, count = 0;
+  // Per-class tallies of records that have survived at least two sweeps and of records that
+  // died young, used to flag long-lived classes for pretenuring below. Keys are the marked
+  // (moved) class pointers, which are stable for the duration of the sweep.
+  std::unordered_map<mirror::Class*, size_t> old_survivors;
+  std::unordered_map<mirror::Class*, size_t> young_deaths;
   // Only the first (size - recent_record_max_) number of records can be deleted.
   const size_t delete_bound = std::max(entries_.size(), recent_record_max_) - recent_record_max_;
   for (auto it = entries_.begin(), end = entries_.end(); it != end;) {
@@ -146,6 +181,21 @@ void AllocRecordObjectMap::SweepAllocationRecords(IsMarkedVisitor* visitor) {
     AllocRecord& record = it->second;
     mirror::Object* new_object = old_object == nullptr ? nullptr : visitor->IsMarked(old_object);
     if (new_object == nullptr) {
+      // old_object is null for records whose death was already reported by an earlier sweep.
+      if (trace_file_ != nullptr && old_object != nullptr) {
+        *trace_file_ << "d " << record.AllocTick() << " " << alloc_tick_ << " "
+                     << record.ByteCount() << "\n";
+      }
+      if (kPretenureLongLivedClasses &&
+          old_object != nullptr &&
+          record.AllocTick() >= pretenure_old_tick_bound_) {
+        // Died within its first two sweeps; counts against pretenuring its class.
+        mirror::Object* klass = record.GetClassGcRoot().Read<kWithoutReadBarrier>();
+        mirror::Object* marked_klass = klass == nullptr ? nullptr : visitor->IsMarked(klass);
+        if (marked_klass != nullptr) {
+          ++young_deaths[marked_klass->AsClass()];
+        }
+      }
       if (count > delete_bound) {
         it->first = GcRoot<mirror::Object>(nullptr);
         SweepClassObject(&record, visitor);
@@ -160,9 +210,48 @@ void AllocRecordObjectMap::SweepAllocationRecords(IsMarkedVisitor* visitor) {
         ++count_moved;
       }
       SweepClassObject(&record, visitor);
+      if (kPretenureLongLivedClasses && record.AllocTick() < pretenure_old_tick_bound_) {
+        // SweepClassObject just updated the class root, so it can be read without a barrier.
+        mirror::Class* klass = record.GetClassGcRoot().Read<kWithoutReadBarrier>();
+        if (klass != nullptr) {
+          ++old_survivors[klass];
+        }
+      }
       ++it;
     }
   }
+  if (kPretenureLongLivedClasses) {
+    size_t count_pretenured = 0;
+    for (const auto& pair : old_survivors) {
+      mirror::Class* const klass = pair.first;
+      if (pair.second < kPretenureMinOldSamples) {
+        continue;
+      }
+      auto deaths_it = young_deaths.find(klass);
+      if (deaths_it != young_deaths.end() && deaths_it->second > pair.second) {
+        // Mixed behavior: the class also churns plenty of short-lived instances.
+        continue;
+      }
+      // Arrays and strings allocate through paths that do not consult the flag, so skip them
+      // to keep the bit meaningful. Component type nullness is the same in from- and to-space,
+      // so it is safe to test without a read barrier here.
+      if (klass->IsPretenured() ||
+          klass->GetComponentType<kVerifyNone, kWithoutReadBarrier>() != nullptr ||
+          klass->IsStringClass()) {
+        continue;
+      }
+      klass->SetPretenured();
+      ++count_pretenured;
+    }
+    if (count_pretenured != 0) {
+      VLOG(heap) << "Pretenured " << count_pretenured << " classes";
+    }
+    pretenure_old_tick_bound_ = last_sweep_start_tick_;
+    last_sweep_start_tick_ = alloc_tick_;
+  }
+  if (trace_file_ != nullptr) {
+    *trace_file_ << "g " << alloc_tick_ << "\n" << std::flush;
+  }
   VLOG(heap) << "Deleted " << count_deleted << " allocation records";
   VLOG(heap) << "Updated " << count_moved << " allocation records";
 }
@@ -237,6 +326,19 @@ void AllocRecordObjectMap::SetAllocTrackingEnabled(bool enable) {
       LOG(INFO) << "Enabling alloc tracker (" << records->alloc_record_max_ << " entries of "
                 << records->max_stack_depth_ << " frames, taking up to "
                 << PrettySize(sz * records->alloc_record_max_) << ")";
+      if (records->sample_interval_bytes_ != 0u) {
+        LOG(INFO) << "Alloc tracker sampling every " << records->sample_interval_bytes_
+                  << " allocated bytes";
+      }
+      if (!records->trace_file_path_.empty()) {
+        records->trace_file_.reset(new std::ofstream(records->trace_file_path_));
+        if (!records->trace_file_->is_open()) {
+          LOG(ERROR) << "Could not open allocation trace file " << records->trace_file_path_;
+          records->trace_file_.reset();
+        } else {
+          LOG(INFO) << "Writing allocation trace to " << records->trace_file_path_;
+        }
+      }
     }
     Runtime::Current()->GetInstrumentation()->InstrumentQuickAllocEntryPoints();
     {
@@ -261,9 +363,30 @@ void AllocRecordObjectMap::SetAllocTrackingEnabled(bool enable) {
   }
 }
 
+bool AllocRecordObjectMap::ShouldRecordAllocation(Thread* self, size_t byte_count) {
+  if (sample_interval_bytes_ == 0u) {
+    return true;
+  }
+  const size_t countdown = self->GetAllocRecordSampleCountdown();
+  if (countdown > byte_count) {
+    self->SetAllocRecordSampleCountdown(countdown - byte_count);
+    return false;
+  }
+  // The countdown expired: sample this allocation and rearm. New threads start at zero, so
+  // their first tracked allocation is always sampled.
+  self->SetAllocRecordSampleCountdown(sample_interval_bytes_);
+  return true;
+}
+
 void AllocRecordObjectMap::RecordAllocation(Thread* self,
                                             mirror::Object** obj,
                                             size_t byte_count) {
+  // When byte-interval sampling is enabled, skip the stack walk and the tracker lock
+  // entirely for allocations that fall between samples.
+  if (!ShouldRecordAllocation(self, byte_count)) {
+    return;
+  }
+
   // Get stack trace outside of lock in case there are allocations during the stack walk.
   // b/27858645.
   AllocRecordStackTrace trace;
@@ -303,13 +426,62 @@ void AllocRecordObjectMap::RecordAllocation(Thread* self,
   // Erase extra unfilled elements.
   trace.SetTid(self->GetTid());
 
+  // Aggregate by call site, with a zero tid so the same site merges across threads. This
+  // survives the eviction of individual records from entries_.
+  AllocRecordStackTrace site(trace);
+  site.SetTid(0);
+  AggregatedSample& sample = aggregated_samples_[std::move(site)];
+  sample.count += 1;
+  sample.bytes += byte_count;
+
+  const uint64_t tick = alloc_tick_++;
+  if (trace_file_ != nullptr) {
+    std::string storage;
+    *trace_file_ << "a " << tick << " " << byte_count << " "
+                 << (*obj)->GetClass()->GetDescriptor(&storage) << "\n";
+  }
+
   // Add the record.
-  Put(*obj, AllocRecord(byte_count, (*obj)->GetClass(), std::move(trace)));
+  Put(*obj, AllocRecord(byte_count, tick, (*obj)->GetClass(), std::move(trace)));
   DCHECK_LE(Size(), alloc_record_max_);
 }
 
+void AllocRecordObjectMap::DumpAggregatedStats(std::ostream& os) {
+  if (aggregated_samples_.empty()) {
+    return;
+  }
+  std::vector<const AggregatedSampleMap::value_type*> sites;
+  sites.reserve(aggregated_samples_.size());
+  for (const auto& it : aggregated_samples_) {
+    sites.push_back(&it);
+  }
+  const size_t top_k = std::min(kTopKAllocSites, sites.size());
+  std::partial_sort(sites.begin(), sites.begin() + top_k, sites.end(),
+                    [](const AggregatedSampleMap::value_type* a,
+                       const AggregatedSampleMap::value_type* b) {
+                      return a->second.bytes > b->second.bytes;
+                    });
+  os << "Top " << top_k << " allocation sites (of " << sites.size() << ")";
+  if (sample_interval_bytes_ != 0u) {
+    os << ", sampled every " << sample_interval_bytes_ << " allocated bytes";
+  }
+  os << ":\n";
+  for (size_t i = 0; i < top_k; ++i) {
+    const AllocRecordStackTrace& trace = sites[i]->first;
+    const AggregatedSample& sample = sites[i]->second;
+    os << "  " << PrettySize(sample.bytes) << " in " << sample.count << " allocations\n";
+    for (size_t j = 0, depth = trace.GetDepth(); j < depth; ++j) {
+      const AllocRecordStackTraceElement& element = trace.GetStackElement(j);
+      os << "    at " << PrettyMethod(element.GetMethod())
+         << ":" << element.ComputeLineNumber() << "\n";
+    }
+  }
+}
+
 void AllocRecordObjectMap::Clear() {
   entries_.clear();
+  aggregated_samples_.clear();
+  trace_file_.reset();
 }
 
 AllocRecordObjectMap::AllocRecordObjectMap()
@@ -17,8 +17,10 @@
 #ifndef ART_RUNTIME_GC_ALLOCATION_RECORD_H_
 #define ART_RUNTIME_GC_ALLOCATION_RECORD_H_
 
+#include <fstream>
 #include <list>
 #include <memory>
+#include <unordered_map>
 
 #include "base/mutex.h"
 #include "object_callbacks.h"
@@ -155,8 +157,8 @@ template <typename T> struct EqAllocRecordTypesPtr {
 class AllocRecord {
  public:
   // All instances of AllocRecord should be managed by an instance of AllocRecordObjectMap.
-  AllocRecord(size_t count, mirror::Class* klass, AllocRecordStackTrace&& trace)
-      : byte_count_(count), klass_(klass), trace_(std::move(trace)) {}
+  AllocRecord(size_t count, uint64_t alloc_tick, mirror::Class* klass, AllocRecordStackTrace&& trace)
+      : byte_count_(count), alloc_tick_(alloc_tick), klass_(klass), trace_(std::move(trace)) {}
 
   size_t GetDepth() const {
     return trace_.GetDepth();
@@ -170,6 +172,10 @@ class AllocRecord {
     return byte_count_;
   }
 
+  uint64_t AllocTick() const {
+    return alloc_tick_;
+  }
+
   pid_t GetTid() const {
     return trace_.GetTid();
   }
@@ -191,6 +197,9 @@ class AllocRecord {
 
  private:
   const size_t byte_count_;
+  // Value of the sampled allocation counter when this record was created, used as the
+  // time base of the allocation trace file.
+  const uint64_t alloc_tick_;
   // The klass_ could be a strong or weak root for GC
   GcRoot<mirror::Class> klass_;
   // TODO: Share between alloc records with identical stack traces.
@@ -263,6 +272,23 @@ class AllocRecordObjectMap {
       SHARED_REQUIRES(Locks::mutator_lock_)
       REQUIRES(Locks::alloc_tracker_lock_);
 
+  // Cumulative number of sampled allocations and bytes attributed to one stack trace.
+  struct AggregatedSample {
+    size_t count = 0;
+    size_t bytes = 0;
+  };
+  using AggregatedSampleMap =
+      std::unordered_map<AllocRecordStackTrace, AggregatedSample, HashAllocRecordTypes>;
+
+  // Returns true if this allocation should be recorded. Decrements the thread's byte
+  // countdown and rearms it when it expires; always true if sampling is disabled.
+  bool ShouldRecordAllocation(Thread* self, size_t byte_count);
+
+  // Writes the top allocation sites by attributed bytes, for the SIGQUIT GC performance dump.
+  void DumpAggregatedStats(std::ostream& os)
+      SHARED_REQUIRES(Locks::mutator_lock_)
+      REQUIRES(Locks::alloc_tracker_lock_);
+
   // TODO: Is there a better way to hide the entries_'s type?
   EntryList::iterator Begin()
       SHARED_REQUIRES(Locks::mutator_lock_)
@@ -295,14 +321,45 @@ class AllocRecordObjectMap {
   static constexpr size_t kDefaultNumRecentRecords = 64 * 1024 - 1;
   static constexpr size_t kDefaultAllocStackDepth = 16;
   static constexpr size_t kMaxSupportedStackDepth = 128;
+  // Byte interval between sampled allocations; zero records every allocation. Overridable
+  // with the debug.allocTracker.sampleIntervalBytes property.
+  static constexpr size_t kDefaultSampleIntervalBytes = 0;
+  // Number of allocation sites emitted by DumpAggregatedStats().
+  static constexpr size_t kTopKAllocSites = 20;
+  // Pretenuring: classes whose sampled instances keep surviving collections are flagged with
+  // kAccClassIsPretenured during sweeping, after which new instances allocate directly in the
+  // non-moving space. A class qualifies once at least kPretenureMinOldSamples of its records
+  // have survived two sweeps and such records are not outnumbered by its young deaths.
+  static constexpr bool kPretenureLongLivedClasses = true;
+  static constexpr size_t kPretenureMinOldSamples = 16;
   size_t alloc_record_max_ GUARDED_BY(Locks::alloc_tracker_lock_) = kDefaultNumAllocRecords;
   size_t recent_record_max_ GUARDED_BY(Locks::alloc_tracker_lock_) = kDefaultNumRecentRecords;
   size_t max_stack_depth_ = kDefaultAllocStackDepth;
+  // Like max_stack_depth_, only written before tracking is enabled, so reads on the hot
+  // allocation path need no lock.
+  size_t sample_interval_bytes_ = kDefaultSampleIntervalBytes;
   pid_t alloc_ddm_thread_id_  GUARDED_BY(Locks::alloc_tracker_lock_) = 0;
   bool allow_new_record_ GUARDED_BY(Locks::alloc_tracker_lock_) = true;
   ConditionVariable new_record_condition_ GUARDED_BY(Locks::alloc_tracker_lock_);
   // see the comment in typedef of EntryList
   EntryList entries_ GUARDED_BY(Locks::alloc_tracker_lock_);
+  // Per-stack-trace aggregation of sampled allocations, keyed with a zero tid so the same
+  // site is merged across threads. Survives eviction of individual entries_ records.
+  AggregatedSampleMap aggregated_samples_ GUARDED_BY(Locks::alloc_tracker_lock_);
+  // Monotonic count of sampled allocations, used as the time base of the trace file.
+  uint64_t alloc_tick_ GUARDED_BY(Locks::alloc_tracker_lock_) = 0;
+  // Records with an alloc tick below this bound were created before the previous sweep
+  // started, so if they are still live they have survived at least two collections.
+  uint64_t pretenure_old_tick_bound_ GUARDED_BY(Locks::alloc_tracker_lock_) = 0;
+  // Value of alloc_tick_ when the last sweep started; becomes the bound above next sweep.
+  uint64_t last_sweep_start_tick_ GUARDED_BY(Locks::alloc_tracker_lock_) = 0;
+  // Allocation trace file, selected with the debug.allocTracker.traceFile property and
+  // opened while tracking is enabled. Each sampled allocation appends
+  // "a <tick> <bytes> <class-descriptor>", each sweep that finds a sampled object dead
+  // appends "d <alloc-tick> <death-tick> <bytes>", and each sweep ends with "g <tick>".
+  // Records evicted from entries_ before they die get no death event.
+  std::unique_ptr<std::ofstream> trace_file_ GUARDED_BY(Locks::alloc_tracker_lock_);
+  std::string trace_file_path_ GUARDED_BY(Locks::alloc_tracker_lock_);
 
   void SetProperties() REQUIRES(Locks::alloc_tracker_lock_);
 };
@@ -18,6 +18,7 @@
 
 #include "base/memory_tool.h"
 #include "base/mutex-inl.h"
+#include "base/time_utils.h"
 #include "gc/space/memory_tool_settings.h"
 #include "mem_map.h"
 #include "mirror/class-inl.h"
@@ -26,6 +27,7 @@
 #include "thread-inl.h"
 #include "thread_list.h"
 
+#include <algorithm>
 #include <map>
 #include <list>
 #include <sstream>
@@ -741,9 +743,31 @@ void* RosAlloc::AllocFromRun(Thread* self, size_t size, size_t* bytes_allocated,
     *bytes_allocated = bracket_size;
     *usable_size = bracket_size;
   } else {
-    // Use the (shared) current run.
-    MutexLock mu(self, *size_bracket_locks_[idx]);
-    slot_addr = AllocFromCurrentRunUnlocked(self, idx);
+    // Use the (shared) current run. If the bracket lock is contended, spill to a slightly
+    // larger shared bracket instead of blocking: serving the request from a bigger bracket is
+    // always correct (the true bracket is rederived from the run header on free, and the larger
+    // usable size is reported to the caller), and spreading a hot bracket across its neighbors
+    // lets medium-size allocation throughput scale with the thread count at the cost of one
+    // bracket quantum of waste per spilled allocation.
+    static constexpr size_t kMaxContentionSpillBrackets = 2;
+    size_t alloc_idx = idx;
+    if (UNLIKELY(!size_bracket_locks_[idx]->ExclusiveTryLock(self))) {
+      const size_t max_spill_idx = std::min(idx + kMaxContentionSpillBrackets,
+                                            kNumRegularSizeBrackets - 1);
+      for (size_t spill_idx = idx + 1; spill_idx <= max_spill_idx; ++spill_idx) {
+        if (size_bracket_locks_[spill_idx]->ExclusiveTryLock(self)) {
+          alloc_idx = spill_idx;
+          bracket_size = bracketSizes[spill_idx];
+          break;
+        }
+      }
+      if (alloc_idx == idx) {
+        // All nearby brackets are contended too; wait for our own.
+        size_bracket_locks_[idx]->ExclusiveLock(self);
+      }
+    }
+    slot_addr = AllocFromCurrentRunUnlocked(self, alloc_idx);
+    size_bracket_locks_[alloc_idx]->ExclusiveUnlock(self);
     if (kTraceRosAlloc) {
       LOG(INFO) << "RosAlloc::AllocFromRun() : 0x" << std::hex
                 << reinterpret_cast<intptr_t>(slot_addr)
@@ -1984,14 +2008,28 @@ void RosAlloc::Run::Verify(Thread* self, RosAlloc* rosalloc, bool running_on_mem
   }
 }
 
-size_t RosAlloc::ReleasePages() {
+size_t RosAlloc::ReleasePages(uint64_t deadline_ns, size_t* cursor) {
   VLOG(heap) << "RosAlloc::ReleasePages()";
   DCHECK(!DoesReleaseAllPages());
+  DCHECK(deadline_ns == 0u || cursor != nullptr);
   Thread* self = Thread::Current();
   size_t reclaimed_bytes = 0;
-  size_t i = 0;
+  // Resume from where the previous slice left off, if any. The page map may have shrunk since
+  // then, in which case the stale cursor simply ends the walk below.
+  size_t i = (cursor != nullptr) ? *cursor : 0;
+  // Number of pages to process between deadline checks, to keep the NanoTime() overhead off the
+  // per-page path.
+  static constexpr size_t kPagesPerDeadlineCheck = 128;
+  size_t pages_until_deadline_check = kPagesPerDeadlineCheck;
   // Check the page map size which might have changed due to grow/shrink.
   while (i < page_map_size_) {
+    if (deadline_ns != 0u && pages_until_deadline_check-- == 0u) {
+      pages_until_deadline_check = kPagesPerDeadlineCheck;
+      if (NanoTime() > deadline_ns) {
+        *cursor = i;
+        return reclaimed_bytes;
+      }
+    }
     // Reading the page map without a lock is racy but the race is benign since it should only
     // result in occasionally not releasing pages which we could release.
     uint8_t pm = page_map_[i];
@@ -2037,6 +2075,9 @@ size_t RosAlloc::ReleasePages() {
         break;
     }
   }
+  if (cursor != nullptr) {
+    *cursor = 0;
+  }
   return reclaimed_bytes;
 }
 
@@ -881,8 +881,10 @@ class RosAlloc {
                   void* arg)
       REQUIRES(!lock_);
 
-  // Release empty pages.
-  size_t ReleasePages() REQUIRES(!lock_);
+  // Release empty pages. If deadline_ns is non-zero, the page map walk stops once NanoTime()
+  // passes the deadline and the index to resume from is stored in *cursor (reset to 0 once the
+  // walk reaches the end), so callers can release pages in bounded time slices.
+  size_t ReleasePages(uint64_t deadline_ns = 0u, size_t* cursor = nullptr) REQUIRES(!lock_);
   // Returns the current footprint.
   size_t Footprint() REQUIRES(!lock_);
   // Returns the current capacity, maximum footprint.
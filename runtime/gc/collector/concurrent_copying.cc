@@ -19,7 +19,9 @@
 #include "art_field-inl.h"
 #include "base/stl_util.h"
 #include "debugger.h"
+#include "gc/accounting/card_table-inl.h"
 #include "gc/accounting/heap_bitmap-inl.h"
+#include "gc/accounting/mod_union_table.h"
 #include "gc/accounting/space_bitmap-inl.h"
 #include "gc/reference_processor.h"
 #include "gc/space/image_space.h"
@@ -28,6 +30,8 @@
 #include "intern_table.h"
 #include "mirror/class-inl.h"
 #include "mirror/object-inl.h"
+#include "mirror/object_array-inl.h"
+#include "mirror/reference.h"
 #include "scoped_thread_state_change.h"
 #include "thread-inl.h"
 #include "thread_list.h"
@@ -39,10 +43,11 @@ namespace collector {
 
 static constexpr size_t kDefaultGcMarkStackSize = 2 * MB;
 
-ConcurrentCopying::ConcurrentCopying(Heap* heap, const std::string& name_prefix)
+ConcurrentCopying::ConcurrentCopying(Heap* heap, const std::string& name_prefix, bool young_gen)
     : GarbageCollector(heap,
                        name_prefix + (name_prefix.empty() ? "" : " ") +
-                       "concurrent copying + mark sweep"),
+                       (young_gen ? "young concurrent copying + mark sweep"
+                                  : "concurrent copying + mark sweep")),
       region_space_(nullptr), gc_barrier_(new Barrier(0)),
       gc_mark_stack_(accounting::ObjectStack::Create("concurrent copying gc mark stack",
                                                      kDefaultGcMarkStackSize,
@@ -54,7 +59,8 @@ ConcurrentCopying::ConcurrentCopying(Heap* heap, const std::string& name_prefix)
       weak_ref_access_enabled_(true),
       skipped_blocks_lock_("concurrent copying bytes blocks lock", kMarkSweepMarkStackLock),
       rb_table_(heap_->GetReadBarrierTable()),
-      force_evacuate_all_(false) {
+      force_evacuate_all_(false),
+      young_gen_(young_gen) {
   static_assert(space::RegionSpace::kRegionSize == accounting::ReadBarrierTable::kRegionSize,
                 "The region space size and the read barrier table region size must match");
   cc_heap_bitmap_.reset(new accounting::HeapBitmap(heap));
@@ -238,7 +244,15 @@ class FlipCallback : public Closure {
     Thread* self = Thread::Current();
     CHECK(thread == self);
     Locks::mutator_lock_->AssertExclusiveHeld(self);
-    cc->region_space_->SetFromSpace(cc->rb_table_, cc->force_evacuate_all_);
+    space::RegionSpace::EvacMode evac_mode;
+    if (cc->force_evacuate_all_) {
+      evac_mode = space::RegionSpace::EvacMode::kEvacModeForceAll;
+    } else if (cc->young_gen_) {
+      evac_mode = space::RegionSpace::EvacMode::kEvacModeNewlyAllocated;
+    } else {
+      evac_mode = space::RegionSpace::EvacMode::kEvacModeLivePercentNewlyAllocated;
+    }
+    cc->region_space_->SetFromSpace(cc->rb_table_, evac_mode);
     cc->SwapStacks();
     if (ConcurrentCopying::kEnableFromSpaceAccountingCheck) {
       cc->RecordLiveStackFreezeSize(self);
@@ -296,11 +310,59 @@ void ConcurrentCopying::RecordLiveStackFreezeSize(Thread* self) {
   live_stack_freeze_size_ = heap_->GetLiveStack()->Size();
 }
 
+// Visits the references of an immune space object on an aged card to decide whether the object
+// still needs to be rescanned: it does iff it still holds a reference to a non-immune space.
+class ConcurrentCopyingImmuneSpaceRefCheckVisitor {
+ public:
+  ConcurrentCopyingImmuneSpaceRefCheckVisitor(ConcurrentCopying* cc, bool* has_non_immune_ref)
+      : collector_(cc), has_non_immune_ref_(has_non_immune_ref) {}
+
+  void operator()(mirror::Object* obj, MemberOffset offset, bool is_static ATTRIBUTE_UNUSED) const
+      SHARED_REQUIRES(Locks::mutator_lock_) {
+    CheckReference(obj->GetFieldObject<
+        mirror::Object, kVerifyNone, kWithoutReadBarrier, false>(offset));
+  }
+
+  void operator()(mirror::Class* klass, mirror::Reference* ref) const
+      SHARED_REQUIRES(Locks::mutator_lock_) {
+    CHECK(klass->IsTypeOfReferenceClass());
+    // The referent needs to be rescanned (for the reference processing) unless it stays within
+    // the immune spaces.
+    CheckReference(ref->GetFieldObject<
+        mirror::Object, kVerifyNone, kWithoutReadBarrier, false>(mirror::Reference::ReferentOffset()));
+  }
+
+  void VisitRootIfNonNull(mirror::CompressedReference<mirror::Object>* root) const
+      SHARED_REQUIRES(Locks::mutator_lock_) {
+    if (!root->IsNull()) {
+      VisitRoot(root);
+    }
+  }
+
+  void VisitRoot(mirror::CompressedReference<mirror::Object>* root) const
+      SHARED_REQUIRES(Locks::mutator_lock_) {
+    CheckReference(root->AsMirrorPtr());
+  }
+
+ private:
+  void CheckReference(mirror::Object* ref) const SHARED_REQUIRES(Locks::mutator_lock_) {
+    if (ref != nullptr && !collector_->immune_spaces_.ContainsObject(ref)) {
+      *has_non_immune_ref_ = true;
+    }
+  }
+
+  ConcurrentCopying* const collector_;
+  bool* const has_non_immune_ref_;
+};
+
 // Used to visit objects in the immune spaces.
 class ConcurrentCopyingImmuneSpaceObjVisitor {
  public:
-  explicit ConcurrentCopyingImmuneSpaceObjVisitor(ConcurrentCopying* cc)
-      : collector_(cc) {}
+  ConcurrentCopyingImmuneSpaceObjVisitor(ConcurrentCopying* cc,
+                                         accounting::ModUnionTable* mod_union_table)
+      : collector_(cc),
+        card_table_(cc->heap_->GetCardTable()),
+        mod_union_table_(mod_union_table) {}
 
   void operator()(mirror::Object* obj) const SHARED_REQUIRES(Locks::mutator_lock_)
       SHARED_REQUIRES(Locks::heap_bitmap_lock_) {
@@ -314,21 +376,60 @@ class ConcurrentCopyingImmuneSpaceObjVisitor {
       DCHECK(collector_->heap_->GetMarkBitmap()->Test(obj))
           << "Immune space object must be already marked";
     }
-    // This may or may not succeed, which is ok.
-    if (kUseBakerReadBarrier) {
-      obj->AtomicSetReadBarrierPointer(ReadBarrier::WhitePtr(), ReadBarrier::GrayPtr());
+    if (ConcurrentCopying::kScanImmuneSpacesByCards && mod_union_table_ != nullptr &&
+        !NeedsScan(obj)) {
+      // The object holds no references to the non-immune spaces, so there is nothing to scan or
+      // to push. Still record it in the bitmap so that IsMarked() keeps treating it as alive for
+      // the weak reference sweeps; it stays white, which MarkNonMoving() and the rb_ptr checks
+      // account for.
+      cc_bitmap->AtomicTestAndSet(obj);
+      return;
     }
-    if (cc_bitmap->AtomicTestAndSet(obj)) {
-      // Already marked. Do nothing.
-    } else {
-      // Newly marked. Set the gray bit and push it onto the mark stack.
-      CHECK(!kUseBakerReadBarrier || obj->GetReadBarrierPointer() == ReadBarrier::GrayPtr());
+    if (kUseBakerReadBarrier) {
+      // Winning the white->gray CAS makes this thread the unique one to push the object; a
+      // mutator which grays it first through MarkNonMoving() pushes it itself.
+      if (obj->AtomicSetReadBarrierPointer(ReadBarrier::WhitePtr(), ReadBarrier::GrayPtr())) {
+        cc_bitmap->AtomicTestAndSet(obj);
+        collector_->PushOntoMarkStack(obj);
+      } else {
+        // Already gray (pushed by a mutator) or already scanned and blackened.
+        cc_bitmap->AtomicTestAndSet(obj);
+      }
+    } else if (!cc_bitmap->AtomicTestAndSet(obj)) {
+      // Newly marked. Push it onto the mark stack.
       collector_->PushOntoMarkStack(obj);
     }
   }
 
  private:
+  // Returns whether the object may hold references to the non-immune spaces, based on its card:
+  // a dirty card or a card recorded in the mod-union table always needs a rescan, a clean card
+  // was verified to hold no such references in an earlier cycle, and an aged card is verified
+  // now and re-dirtied if the verification fails. Cards are aged at most one step per cycle
+  // (just before this scan) and mutator stores re-dirty them, so a dirty card is always
+  // rescanned at least once before it can become clean.
+  bool NeedsScan(mirror::Object* obj) const SHARED_REQUIRES(Locks::mutator_lock_) {
+    const uint8_t card = card_table_->GetCard(obj);
+    if (card == accounting::CardTable::kCardDirty ||
+        mod_union_table_->ContainsCardFor(reinterpret_cast<uintptr_t>(obj))) {
+      return true;
+    }
+    if (card == accounting::CardTable::kCardClean) {
+      return false;
+    }
+    bool has_non_immune_ref = false;
+    ConcurrentCopyingImmuneSpaceRefCheckVisitor visitor(collector_, &has_non_immune_ref);
+    obj->VisitReferences</*kVisitNativeRoots*/true, kDefaultVerifyFlags, kWithoutReadBarrier>(
+        visitor, visitor);
+    if (has_non_immune_ref) {
+      card_table_->MarkCard(obj);
+    }
+    return has_non_immune_ref;
+  }
+
   ConcurrentCopying* const collector_;
+  accounting::CardTable* const card_table_;
+  accounting::ModUnionTable* const mod_union_table_;
 };
 
 class EmptyCheckpoint : public Closure {
@@ -388,10 +489,24 @@ void ConcurrentCopying::MarkingPhase() {
   }
 
   // Immune spaces.
+  if (kScanImmuneSpacesByCards) {
+    // Age the immune space cards so that cards which stay free of references to the non-immune
+    // spaces for a full cycle become clean and their objects are dropped from the scan below.
+    // This is safe to do concurrently since mutator stores only ever dirty cards.
+    TimingLogger::ScopedTiming split6("AgeImmuneSpaceCards", GetTimings());
+    accounting::CardTable* const card_table = heap_->GetCardTable();
+    for (space::ContinuousSpace* space : immune_spaces_.GetSpaces()) {
+      if (heap_->FindModUnionTableFromSpace(space) != nullptr) {
+        card_table->ModifyCardsAtomic(space->Begin(), space->End(), AgeCardVisitor(),
+                                      VoidFunctor());
+      }
+    }
+  }
   for (auto& space : immune_spaces_.GetSpaces()) {
     DCHECK(space->IsImageSpace() || space->IsZygoteSpace());
     accounting::ContinuousSpaceBitmap* live_bitmap = space->GetLiveBitmap();
-    ConcurrentCopyingImmuneSpaceObjVisitor visitor(this);
+    // Spaces without a mod-union table have no card history to consult and are scanned in full.
+    ConcurrentCopyingImmuneSpaceObjVisitor visitor(this, heap_->FindModUnionTableFromSpace(space));
     live_bitmap->VisitMarkedRange(reinterpret_cast<uintptr_t>(space->Begin()),
                                   reinterpret_cast<uintptr_t>(space->Limit()),
                                   visitor);
@@ -677,7 +792,8 @@ class ConcurrentCopyingVerifyNoFromSpaceRefsVisitor : public SingleRootVisitor {
       } else {
         CHECK(ref->GetReadBarrierPointer() == ReadBarrier::BlackPtr() ||
               (ref->GetReadBarrierPointer() == ReadBarrier::WhitePtr() &&
-               collector_->IsOnAllocStack(ref)))
+               (collector_->IsOnAllocStack(ref) ||
+                collector_->immune_spaces_.ContainsObject(ref))))
             << "Non-moving/unevac from space ref " << ref << " " << PrettyTypeOf(ref)
             << " has non-black rb_ptr " << ref->GetReadBarrierPointer()
             << " but isn't on the alloc stack (and has white rb_ptr)."
@@ -755,7 +871,8 @@ class ConcurrentCopyingVerifyNoFromSpaceRefsObjectVisitor {
       } else {
         CHECK(obj->GetReadBarrierPointer() == ReadBarrier::BlackPtr() ||
               (obj->GetReadBarrierPointer() == ReadBarrier::WhitePtr() &&
-               collector->IsOnAllocStack(obj)))
+               (collector->IsOnAllocStack(obj) ||
+                collector->immune_spaces_.ContainsObject(obj))))
             << "Non-moving space/unevac from space ref " << obj << " " << PrettyTypeOf(obj)
             << " has non-black rb_ptr " << obj->GetReadBarrierPointer()
             << " but isn't on the alloc stack (and has white rb_ptr). Is it in the non-moving space="
@@ -1234,6 +1351,11 @@ class ConcurrentCopyingClearBlackPtrsVisitor {
       SHARED_REQUIRES(Locks::heap_bitmap_lock_) {
     DCHECK(obj != nullptr);
     DCHECK(collector_->heap_->GetMarkBitmap()->Test(obj)) << obj;
+    if (obj->GetReadBarrierPointer() == ReadBarrier::WhitePtr() &&
+        collector_->immune_spaces_.ContainsObject(obj)) {
+      // Immune space objects which the card-limited immune space scan left unscanned stay white.
+      return;
+    }
     DCHECK_EQ(obj->GetReadBarrierPointer(), ReadBarrier::BlackPtr()) << obj;
     obj->AtomicSetReadBarrierPointer(ReadBarrier::BlackPtr(), ReadBarrier::WhitePtr());
     DCHECK_EQ(obj->GetReadBarrierPointer(), ReadBarrier::WhitePtr()) << obj;
@@ -1621,12 +1743,50 @@ class ConcurrentCopyingRefFieldsVisitor {
 // Scan ref fields of an object.
 inline void ConcurrentCopying::Scan(mirror::Object* to_ref) {
   DCHECK(!region_space_->IsInFromSpace(to_ref));
+  mirror::Class* const klass = to_ref->GetClass<kVerifyNone, kWithoutReadBarrier>();
+  if (klass->GetClassFlags<kVerifyNone>() == mirror::kClassFlagObjectArray) {
+    // Object arrays dominate the mark stack for array-scanning workloads; process their
+    // contiguous element slots with a flat loop instead of going through VisitReferences.
+    // The klass_ field is processed like any other reference field.
+    Process(to_ref, mirror::Object::ClassOffset());
+    ScanObjectArray(to_ref->AsObjectArray<mirror::Object, kVerifyNone, kWithoutReadBarrier>());
+    return;
+  }
   ConcurrentCopyingRefFieldsVisitor visitor(this);
   // Disable the read barrier for a performance reason.
   to_ref->VisitReferences</*kVisitNativeRoots*/true, kDefaultVerifyFlags, kWithoutReadBarrier>(
       visitor, visitor);
 }
 
+// Scan the elements of an object array. Null elements and elements whose referent does not move
+// skip the write-back entirely, and the element slots are walked with one base pointer rather
+// than per-element visitor dispatch.
+inline void ConcurrentCopying::ScanObjectArray(mirror::ObjectArray<mirror::Object>* array) {
+  const int32_t length = array->GetLength<kVerifyNone>();
+  for (int32_t i = 0; i < length; ++i) {
+    const MemberOffset offset = mirror::ObjectArray<mirror::Object>::OffsetOfElement(i);
+    mirror::Object* const ref = array->GetFieldObject<
+        mirror::Object, kVerifyNone, kWithoutReadBarrier, false>(offset);
+    if (ref == nullptr) {
+      continue;
+    }
+    mirror::Object* const to_ref = Mark(ref);
+    if (to_ref == ref) {
+      continue;
+    }
+    // Same lossy protocol as Process(): the mutator may legitimately race with the update.
+    mirror::Object* expected_ref = ref;
+    do {
+      if (expected_ref !=
+          array->GetFieldObject<mirror::Object, kVerifyNone, kWithoutReadBarrier, false>(offset)) {
+        // It was updated by the mutator.
+        break;
+      }
+    } while (!array->CasFieldWeakRelaxedObjectWithoutWriteBarrier<
+        false, false, kVerifyNone>(offset, expected_ref, to_ref));
+  }
+}
+
 // Process a field.
 inline void ConcurrentCopying::Process(mirror::Object* obj, MemberOffset offset) {
   mirror::Object* ref = obj->GetFieldObject<
@@ -1999,17 +2159,20 @@ mirror::Object* ConcurrentCopying::MarkNonMoving(mirror::Object* ref) {
       DCHECK(heap_mark_bitmap_->GetContinuousSpaceBitmap(ref)->Test(ref))
           << "Immune space object must be already marked";
     }
-    // This may or may not succeed, which is ok.
     if (kUseBakerReadBarrier) {
-      ref->AtomicSetReadBarrierPointer(ReadBarrier::WhitePtr(), ReadBarrier::GrayPtr());
-    }
-    if (cc_bitmap->AtomicTestAndSet(ref)) {
-      // Already marked.
-    } else {
-      // Newly marked.
-      if (kUseBakerReadBarrier) {
-        DCHECK_EQ(ref->GetReadBarrierPointer(), ReadBarrier::GrayPtr());
+      // Winning the white->gray CAS makes this thread the unique one to push the object. This
+      // also covers objects which the card-limited immune space scan recorded in the bitmap
+      // without graying: the first mutator to gray one pushes it here so that it gets scanned
+      // and its gray bit cleared like any other marked object.
+      if (ref->AtomicSetReadBarrierPointer(ReadBarrier::WhitePtr(), ReadBarrier::GrayPtr())) {
+        cc_bitmap->AtomicTestAndSet(ref);
+        PushOntoMarkStack(ref);
+      } else {
+        // Already gray (pushed by another thread) or already scanned and blackened.
+        cc_bitmap->AtomicTestAndSet(ref);
       }
+    } else if (!cc_bitmap->AtomicTestAndSet(ref)) {
+      // Newly marked.
       PushOntoMarkStack(ref);
     }
   } else {
@@ -58,8 +58,17 @@ class ConcurrentCopying : public GarbageCollector {
   static constexpr bool kEnableFromSpaceAccountingCheck = true;
   // Enable verbose mode.
   static constexpr bool kVerboseMode = false;
+  // If true, limit the immune space scan to objects whose cards are dirty, aged or recorded in
+  // the space's mod-union table. Aged cards whose objects hold no references outside the immune
+  // spaces are allowed to become clean so that long-unwritten image objects are promoted out of
+  // the rescan set; see the immune space handling in MarkingPhase().
+  static constexpr bool kScanImmuneSpacesByCards = true;
 
-  ConcurrentCopying(Heap* heap, const std::string& name_prefix = "");
+  // A young_gen collector only evacuates the regions allocated since the previous collection
+  // cycle; older regions are left in place as unevacuated from-space. Note that the marking
+  // phase still traces the whole heap - replacing that with dirty-card scanning of the old
+  // regions is the remaining piece of a fully generational mode.
+  ConcurrentCopying(Heap* heap, const std::string& name_prefix = "", bool young_gen = false);
   ~ConcurrentCopying();
 
   virtual void RunPhases() OVERRIDE REQUIRES(!mark_stack_lock_, !skipped_blocks_lock_);
@@ -117,6 +126,8 @@ class ConcurrentCopying : public GarbageCollector {
       REQUIRES(!skipped_blocks_lock_, !mark_stack_lock_);
   void Scan(mirror::Object* to_ref) SHARED_REQUIRES(Locks::mutator_lock_)
       REQUIRES(!mark_stack_lock_);
+  void ScanObjectArray(mirror::ObjectArray<mirror::Object>* array)
+      SHARED_REQUIRES(Locks::mutator_lock_) REQUIRES(!mark_stack_lock_, !skipped_blocks_lock_);
   void Process(mirror::Object* obj, MemberOffset offset)
       SHARED_REQUIRES(Locks::mutator_lock_) REQUIRES(!mark_stack_lock_ , !skipped_blocks_lock_);
   virtual void VisitRoots(mirror::Object*** roots, size_t count, const RootInfo& info)
@@ -236,9 +247,12 @@ class ConcurrentCopying : public GarbageCollector {
 
   accounting::ReadBarrierTable* rb_table_;
   bool force_evacuate_all_;  // True if all regions are evacuated.
+  // True if this collector only evacuates newly allocated regions (young collection).
+  const bool young_gen_;
 
   friend class ConcurrentCopyingRefFieldsVisitor;
   friend class ConcurrentCopyingImmuneSpaceObjVisitor;
+  friend class ConcurrentCopyingImmuneSpaceRefCheckVisitor;
   friend class ConcurrentCopyingVerifyNoFromSpaceRefsVisitor;
   friend class ConcurrentCopyingVerifyNoFromSpaceRefsObjectVisitor;
   friend class ConcurrentCopyingClearBlackPtrsVisitor;
@@ -402,8 +402,11 @@ void MarkCompact::Compact() {
   space_->RecordFree(objects_freed, bytes_freed);
   RecordFree(ObjectBytePair(objects_freed, bytes_freed));
   space_->SetEnd(bump_pointer_);
-  // Need to zero out the memory we freed. TODO: Use madvise for pages.
-  memset(bump_pointer_, 0, bytes_freed);
+  // Zero out the memory we freed: whole pages go back to the operating system and fault in
+  // zeroed on demand when the space grows again, so a backgrounded process no longer keeps
+  // its pre-compaction footprint resident. Threads are suspended here, so nobody can bump
+  // the end concurrently.
+  space_->ReleaseTailPages();
 }
 
 // Marks all objects in the root set.
@@ -51,11 +51,26 @@ namespace collector {
 // Performance options.
 static constexpr bool kUseRecursiveMark = false;
 static constexpr bool kUseMarkStackPrefetch = true;
+// Depth of the prefetch fifo used when draining the mark stack. Must be a power of two, and
+// deep enough that an object's header prefetch has completed by the time the object reaches
+// the front of the fifo.
+static constexpr size_t kMarkStackPrefetchFifoSize = 8;
+// Pipeline the class prefetch one stage behind the header prefetch: when popping an object,
+// also prefetch the class of the object that will be scanned next. Its header was prefetched
+// when it entered the fifo, so loading the class pointer here is usually already a hit, and
+// the class data arrives while the current object is being scanned.
+static constexpr bool kUseMarkStackClassPrefetch = true;
 static constexpr size_t kSweepArrayChunkFreeSize = 1024;
 static constexpr bool kPreCleanCards = true;
 
 // Parallelism options.
 static constexpr bool kParallelCardScan = true;
+// Number of card scan chunks handed to the thread pool per worker thread. Larger values give
+// better load balancing when dirty cards are clustered in a few spaces, at the cost of more task
+// allocations.
+static constexpr size_t kCardScanChunksPerThread = 8;
+// Lower bound on the address range covered by one card scan task.
+static constexpr size_t kMinimumCardScanChunkSize = 128 * KB;
 static constexpr bool kParallelRecursiveMark = true;
 // Don't attempt to parallelize mark stack processing unless the mark stack is at least n
 // elements. This is temporary until we reduce the overhead caused by allocating tasks, etc.. Not
@@ -566,10 +581,18 @@ class VerifyRootMarkedVisitor : public SingleRootVisitor {
   MarkSweep* const collector_;
 };
 
+// How many roots ahead of the current one to prefetch when marking a batch of
+// roots. Marking chases the object and its bitmap word, so warming the next
+// targets hides most of the cache misses during the pause.
+static constexpr size_t kVisitRootsPrefetchAhead = 8;
+
 void MarkSweep::VisitRoots(mirror::Object*** roots,
                            size_t count,
                            const RootInfo& info ATTRIBUTE_UNUSED) {
   for (size_t i = 0; i < count; ++i) {
+    if (i + kVisitRootsPrefetchAhead < count) {
+      __builtin_prefetch(*roots[i + kVisitRootsPrefetchAhead]);
+    }
     MarkObjectNonNull(*roots[i]);
   }
 }
@@ -578,6 +601,9 @@ void MarkSweep::VisitRoots(mirror::CompressedReference<mirror::Object>** roots,
                            size_t count,
                            const RootInfo& info ATTRIBUTE_UNUSED) {
   for (size_t i = 0; i < count; ++i) {
+    if (i + kVisitRootsPrefetchAhead < count) {
+      __builtin_prefetch(roots[i + kVisitRootsPrefetchAhead]->AsMirrorPtr());
+    }
     MarkObjectNonNull(roots[i]->AsMirrorPtr());
   }
 }
@@ -773,13 +799,11 @@ class MarkStackTask : public Task {
       REQUIRES(Locks::heap_bitmap_lock_)
       SHARED_REQUIRES(Locks::mutator_lock_) {
     ScanObjectParallelVisitor visitor(this);
-    // TODO: Tune this.
-    static const size_t kFifoSize = 4;
-    BoundedFifoPowerOfTwo<mirror::Object*, kFifoSize> prefetch_fifo;
+    BoundedFifoPowerOfTwo<mirror::Object*, kMarkStackPrefetchFifoSize> prefetch_fifo;
     for (;;) {
       mirror::Object* obj = nullptr;
       if (kUseMarkStackPrefetch) {
-        while (mark_stack_pos_ != 0 && prefetch_fifo.size() < kFifoSize) {
+        while (mark_stack_pos_ != 0 && prefetch_fifo.size() < kMarkStackPrefetchFifoSize) {
           mirror::Object* const mark_stack_obj = mark_stack_[--mark_stack_pos_].AsMirrorPtr();
           DCHECK(mark_stack_obj != nullptr);
           __builtin_prefetch(mark_stack_obj);
@@ -790,6 +814,10 @@ class MarkStackTask : public Task {
         }
         obj = prefetch_fifo.front();
         prefetch_fifo.pop_front();
+        if (kUseMarkStackClassPrefetch && !prefetch_fifo.empty()) {
+          __builtin_prefetch(
+              prefetch_fifo.front()->GetClass<kVerifyNone, kWithoutReadBarrier>());
+        }
       } else {
         if (UNLIKELY(mark_stack_pos_ == 0)) {
           break;
@@ -886,9 +914,14 @@ void MarkSweep::ScanGrayObjects(bool paused, uint8_t minimum_age) {
       DCHECK_ALIGNED(card_end, accounting::CardTable::kCardSize);
       // Calculate how many bytes of heap we will scan,
       const size_t address_range = card_end - card_begin;
-      // Calculate how much address range each task gets.
-      const size_t card_delta = RoundUp(address_range / thread_count + 1,
-                                        accounting::CardTable::kCardSize);
+      // Calculate how much address range each task gets. Over-partition relative to the thread
+      // count so that workers which hit mostly-clean card runs can steal further chunks from the
+      // pool instead of idling while a worker stuck on a dirty region finishes, but keep a
+      // minimum chunk size so we do not drown in task overhead on small spaces.
+      const size_t card_delta = std::max(
+          RoundUp(address_range / (thread_count * kCardScanChunksPerThread) + 1,
+                  accounting::CardTable::kCardSize),
+          kMinimumCardScanChunkSize);
       // If paused and the space is neither zygote nor image space, we could clear the dirty
       // cards to avoid accumulating them to increase card scanning load in the following GC
       // cycles. We need to keep dirty cards of image space and zygote space in order to track
@@ -1396,13 +1429,11 @@ void MarkSweep::ProcessMarkStack(bool paused) {
       mark_stack_->Size() >= kMinimumParallelMarkStackSize) {
     ProcessMarkStackParallel(thread_count);
   } else {
-    // TODO: Tune this.
-    static const size_t kFifoSize = 4;
-    BoundedFifoPowerOfTwo<mirror::Object*, kFifoSize> prefetch_fifo;
+    BoundedFifoPowerOfTwo<mirror::Object*, kMarkStackPrefetchFifoSize> prefetch_fifo;
     for (;;) {
       mirror::Object* obj = nullptr;
       if (kUseMarkStackPrefetch) {
-        while (!mark_stack_->IsEmpty() && prefetch_fifo.size() < kFifoSize) {
+        while (!mark_stack_->IsEmpty() && prefetch_fifo.size() < kMarkStackPrefetchFifoSize) {
           mirror::Object* mark_stack_obj = mark_stack_->PopBack();
           DCHECK(mark_stack_obj != nullptr);
           __builtin_prefetch(mark_stack_obj);
@@ -1413,6 +1444,10 @@ void MarkSweep::ProcessMarkStack(bool paused) {
         }
         obj = prefetch_fifo.front();
         prefetch_fifo.pop_front();
+        if (kUseMarkStackClassPrefetch && !prefetch_fifo.empty()) {
+          __builtin_prefetch(
+              prefetch_fifo.front()->GetClass<kVerifyNone, kWithoutReadBarrier>());
+        }
       } else {
         if (mark_stack_->IsEmpty()) {
           break;
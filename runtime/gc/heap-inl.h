@@ -206,9 +206,6 @@ inline mirror::Object* Heap::AllocObjectWithAllocator(Thread* self,
   return obj;
 }
 
-// The size of a thread-local allocation stack in the number of references.
-static constexpr size_t kThreadLocalAllocationStackSize = 128;
-
 inline void Heap::PushOnAllocationStack(Thread* self, mirror::Object** obj) {
   if (kUseThreadLocalAllocationStack) {
     if (UNLIKELY(!self->PushOnThreadLocalAllocationStack(*obj))) {
@@ -347,14 +344,15 @@ inline mirror::Object* Heap::TryToAllocate(Thread* self,
         if (space::RegionSpace::kRegionSize >= alloc_size) {
           // Non-large. Check OOME for a tlab.
           if (LIKELY(!IsOutOfMemoryOnAllocation<kGrow>(allocator_type, space::RegionSpace::kRegionSize))) {
-            // Try to allocate a tlab.
-            if (!region_space_->AllocNewTlab(self)) {
+            // Try to allocate a tlab, possibly spanning several contiguous regions.
+            const size_t tlab_bytes = region_space_->AllocNewTlab(self);
+            if (tlab_bytes == 0u) {
               // Failed to allocate a tlab. Try non-tlab.
               ret = region_space_->AllocNonvirtual<false>(alloc_size, bytes_allocated, usable_size,
                                                           bytes_tl_bulk_allocated);
               return ret;
             }
-            *bytes_tl_bulk_allocated = space::RegionSpace::kRegionSize;
+            *bytes_tl_bulk_allocated = tlab_bytes;
             // Fall-through.
           } else {
             // Check OOME for a non-tlab allocation.
@@ -16,6 +16,7 @@
 
 #include "heap.h"
 
+#include <cmath>
 #include <limits>
 #include <memory>
 #include <unwind.h>  // For GC verification.
@@ -121,6 +122,21 @@ static constexpr bool kDumpRosAllocStatsOnSigQuit = false;
 
 static constexpr size_t kNativeAllocationHistogramBuckets = 16;
 
+// Back the main space maps with transparent huge pages to reduce dTLB pressure. This trades the
+// ashmem naming of those maps for huge page eligibility; the kernel falls back to normal pages
+// where it cannot honor the advice.
+static constexpr bool kUseHugePagesForMainSpaces = true;
+
+// Maximum number of monitors scanned for deflation per incremental heap trim slice. Bounds the
+// suspend-all pause each slice takes; a full pass over the monitor list is spread over slices.
+static constexpr size_t kMonitorDeflateSliceCapacity = 2048;
+
+// Minimum estimated fragmentation slack in the main space before a homogeneous space compaction
+// is worth its suspend-all copy. Requests which arrive with less reclaimable slack than this are
+// counted as ignored instead of run, and a full GC which leaves at least this much slack behind
+// requests a compaction on its own.
+static constexpr size_t kMinFragmentationSlackForCompaction = 8 * MB;
+
 static inline bool CareAboutPauseTimes() {
   return Runtime::Current()->InJankPerceptibleProcessState();
 }
@@ -193,6 +209,9 @@ Heap::Heap(size_t initial_size,
                                    1U,
                                    kNativeAllocationHistogramBuckets),
       native_free_histogram_("Native free sizes", 1U, kNativeAllocationHistogramBuckets),
+      native_velocity_bytes_(0.0),
+      native_velocity_update_ns_(0),
+      native_gcs_deferred_(0u),
       num_bytes_freed_revoke_(0),
       verify_missing_card_marks_(false),
       verify_system_weaks_(false),
@@ -222,6 +241,7 @@ Heap::Heap(size_t initial_size,
       target_utilization_(target_utilization),
       foreground_heap_growth_multiplier_(foreground_heap_growth_multiplier),
       total_wait_time_(0),
+      gc_stall_histogram_("GC stall times"),
       verify_object_mode_(kVerifyObjectModeDisabled),
       disable_moving_gc_count_(0),
       is_running_on_memory_tool_(Runtime::Current()->IsRunningOnMemoryTool()),
@@ -639,7 +659,9 @@ MemMap* Heap::MapAnonymousPreferredAddress(const char* name,
                                            std::string* out_error_str) {
   while (true) {
     MemMap* map = MemMap::MapAnonymous(name, request_begin, capacity,
-                                       PROT_READ | PROT_WRITE, true, false, out_error_str);
+                                       PROT_READ | PROT_WRITE, true, false, out_error_str,
+                                       /* use_ashmem */ !kUseHugePagesForMainSpaces,
+                                       /* huge_pages */ kUseHugePagesForMainSpaces);
     if (map != nullptr || request_begin == nullptr) {
       return map;
     }
@@ -873,6 +895,7 @@ void Heap::IncrementDisableThreadFlip(Thread* self) {
   if (has_waited) {
     uint64_t wait_time = NanoTime() - wait_start;
     total_wait_time_ += wait_time;
+    gc_stall_histogram_.AddValue(wait_time);
     if (wait_time > long_pause_log_threshold_) {
       LOG(INFO) << __FUNCTION__ << " blocked for " << PrettyDuration(wait_time);
     }
@@ -1168,6 +1191,14 @@ void Heap::DumpGcPerformanceInfo(std::ostream& os) {
   }
   os << "Total mutator paused time: " << PrettyDuration(total_paused_time) << "\n";
   os << "Total time waiting for GC to complete: " << PrettyDuration(total_wait_time_) << "\n";
+  if (gc_stall_histogram_.SampleSize() > 0u) {
+    os << "Mutator GC stalls: " << gc_stall_histogram_.SampleSize()
+       << " p50 " << PrettyDuration(gc_stall_histogram_.Percentile(0.5))
+       << " p90 " << PrettyDuration(gc_stall_histogram_.Percentile(0.9))
+       << " p99 " << PrettyDuration(gc_stall_histogram_.Percentile(0.99))
+       << " p999 " << PrettyDuration(gc_stall_histogram_.Percentile(0.999))
+       << " max " << PrettyDuration(gc_stall_histogram_.Max()) << "\n";
+  }
   os << "Total GC count: " << GetGcCount() << "\n";
   os << "Total GC time: " << PrettyDuration(GetGcTime()) << "\n";
   os << "Total blocking GC count: " << GetBlockingGcCount() << "\n";
@@ -1192,6 +1223,14 @@ void Heap::DumpGcPerformanceInfo(std::ostream& os) {
     rosalloc_space_->DumpStats(os);
   }
 
+  if (IsAllocTrackingEnabled()) {
+    ScopedObjectAccess soa(Thread::Current());
+    MutexLock mu(Thread::Current(), *Locks::alloc_tracker_lock_);
+    if (IsAllocTrackingEnabled() && GetAllocationRecords() != nullptr) {
+      GetAllocationRecords()->DumpAggregatedStats(os);
+    }
+  }
+
   {
     MutexLock mu(Thread::Current(), native_histogram_lock_);
     if (native_allocation_histogram_.SampleSize() > 0u) {
@@ -1216,6 +1255,7 @@ void Heap::ResetGcPerformanceInfo() {
   total_bytes_freed_ever_ = 0;
   total_objects_freed_ever_ = 0;
   total_wait_time_ = 0;
+  gc_stall_histogram_.Reset();
   blocking_gc_count_ = 0;
   blocking_gc_time_ = 0;
   gc_count_last_window_ = 0;
@@ -1362,32 +1402,45 @@ void Heap::DoPendingCollectorTransition() {
   CollectorType desired_collector_type = desired_collector_type_;
   // Launch homogeneous space compaction if it is desired.
   if (desired_collector_type == kCollectorTypeHomogeneousSpaceCompact) {
-    if (!CareAboutPauseTimes()) {
-      PerformHomogeneousSpaceCompact();
-    } else {
+    if (CareAboutPauseTimes()) {
       VLOG(gc) << "Homogeneous compaction ignored due to jank perceptible process state";
+    } else if (EstimateMainSpaceFragmentationSlack() < kMinFragmentationSlackForCompaction) {
+      // Not enough reclaimable slack to pay for the copy. Count the request as ignored; the next
+      // full GC re-requests the compaction if fragmentation builds back up.
+      count_ignored_homogeneous_space_compaction_++;
+      VLOG(gc) << "Homogeneous compaction ignored due to low fragmentation slack";
+    } else {
+      PerformHomogeneousSpaceCompact();
     }
   } else {
     TransitionCollector(desired_collector_type);
   }
 }
 
-void Heap::Trim(Thread* self) {
+bool Heap::Trim(Thread* self, uint64_t slice_deadline_ns, bool first_slice) {
   Runtime* const runtime = Runtime::Current();
+  bool monitors_done = true;
   if (!CareAboutPauseTimes()) {
-    // Deflate the monitors, this can cause a pause but shouldn't matter since we don't care
-    // about pauses.
+    // Deflate a bounded batch of monitors. Each slice still needs to suspend the mutators, but
+    // the batch size limits how long they stay suspended. A deadline of zero means the caller
+    // wants the whole trim in one go, so loop until the pass completes.
     ScopedTrace trace("Deflating monitors");
     ScopedSuspendAll ssa(__FUNCTION__);
     uint64_t start_time = NanoTime();
-    size_t count = runtime->GetMonitorList()->DeflateMonitors();
+    size_t count = 0;
+    do {
+      count += runtime->GetMonitorList()->DeflateMonitorsSlice(kMonitorDeflateSliceCapacity,
+                                                               &monitors_done);
+    } while (slice_deadline_ns == 0u && !monitors_done);
     VLOG(heap) << "Deflating " << count << " monitors took "
         << PrettyDuration(NanoTime() - start_time);
   }
-  TrimIndirectReferenceTables(self);
-  TrimSpaces(self);
-  // Trim arenas that may have been used by JIT or verifier.
-  runtime->GetArenaPool()->TrimMaps();
+  if (first_slice) {
+    TrimIndirectReferenceTables(self);
+    // Trim arenas that may have been used by JIT or verifier.
+    runtime->GetArenaPool()->TrimMaps();
+  }
+  return TrimSpaces(self, slice_deadline_ns) && monitors_done;
 }
 
 class TrimIndirectReferenceTableClosure : public Closure {
@@ -1428,7 +1481,8 @@ void Heap::StartGC(Thread* self, GcCause cause, CollectorType collector_type) {
   collector_type_running_ = collector_type;
 }
 
-void Heap::TrimSpaces(Thread* self) {
+bool Heap::TrimSpaces(Thread* self, uint64_t deadline_ns) {
+  bool done = true;
   {
     // Need to do this before acquiring the locks since we don't want to get suspended while
     // holding any locks.
@@ -1448,7 +1502,13 @@ void Heap::TrimSpaces(Thread* self) {
     for (const auto& space : continuous_spaces_) {
       if (space->IsMallocSpace()) {
         gc::space::MallocSpace* malloc_space = space->AsMallocSpace();
-        if (malloc_space->IsRosAllocSpace() || !CareAboutPauseTimes()) {
+        if (malloc_space->IsRosAllocSpace() && deadline_ns != 0u) {
+          // Incremental trim: release pages until the slice deadline, resuming from the
+          // previous slice's cursor. The caller reschedules us until the walk completes.
+          size_t reclaimed;
+          done = malloc_space->AsRosAllocSpace()->TrimSlice(deadline_ns, &reclaimed) && done;
+          managed_reclaimed += reclaimed;
+        } else if (malloc_space->IsRosAllocSpace() || !CareAboutPauseTimes()) {
           // Don't trim dlmalloc spaces if we care about pauses since this can hold the space lock
           // for a long period of time.
           managed_reclaimed += malloc_space->Trim();
@@ -1476,6 +1536,7 @@ void Heap::TrimSpaces(Thread* self) {
   VLOG(heap) << "Heap trim of managed (duration=" << PrettyDuration(gc_heap_end_ns - start_ns)
       << ", advised=" << PrettySize(managed_reclaimed) << ") heap. Managed heap utilization of "
       << static_cast<int>(100 * managed_utilization) << "%.";
+  return done;
 }
 
 bool Heap::IsValidObjectAddress(const mirror::Object* obj) const {
@@ -2020,6 +2081,22 @@ bool Heap::SupportHomogeneousSpaceCompactAndCollectorTransitions() const {
       foreground_collector_type_ == kCollectorTypeCMS;
 }
 
+size_t Heap::EstimateMainSpaceFragmentationSlack() {
+  if (main_space_ == nullptr || !main_space_->CanMoveObjects()) {
+    return 0;
+  }
+  // Attribute every live byte in the heap to the main space. This overcounts by the bytes which
+  // live in the non moving and large object spaces, so the returned slack is a lower bound on
+  // what a compaction could actually give back. Conservative is the safe direction here: we only
+  // skip a compaction when even the lower bound says it is not worth the pause, and the estimate
+  // stays cheap enough (a footprint read under the space lock plus an atomic counter load) to be
+  // evaluated after every GC. Walking the rosalloc runs for an exact number would need a
+  // suspend-all, which defeats the point of skipping.
+  const size_t footprint = main_space_->GetFootprint();
+  const size_t bytes_allocated = GetBytesAllocated();
+  return footprint > bytes_allocated ? footprint - bytes_allocated : 0u;
+}
+
 HomogeneousSpaceCompactResult Heap::PerformHomogeneousSpaceCompact() {
   Thread* self = Thread::Current();
   // Inc requested homogeneous space compaction.
@@ -2724,6 +2801,19 @@ collector::GcType Heap::CollectGarbageInternal(collector::GcType gc_type,
   reference_processor_->EnqueueClearedReferences(self);
   // Grow the heap so that we know when to perform the next GC.
   GrowForUtilization(collector, bytes_allocated_before_gc);
+  // Defragment on demand: if a full GC leaves the main space with enough fragmentation slack to
+  // pay for a compaction pause, request one instead of waiting for an OOM or a process state
+  // change to trigger it. The request is re-checked against the slack estimate and the process
+  // state when the transition task actually runs. Don't clobber a pending transition to a
+  // different collector type.
+  if (use_homogeneous_space_compaction_for_oom_ &&
+      gc_type == collector::kGcTypeFull &&
+      !CareAboutPauseTimes() &&
+      (desired_collector_type_ == collector_type_ ||
+       desired_collector_type_ == kCollectorTypeHomogeneousSpaceCompact) &&
+      EstimateMainSpaceFragmentationSlack() >= kMinFragmentationSlackForCompaction) {
+    RequestCollectorTransition(kCollectorTypeHomogeneousSpaceCompact, kCollectorTransitionWait);
+  }
   LogGC(gc_cause, collector);
   FinishGC(self, gc_type);
   // Inform DDMS that a GC completed.
@@ -3056,8 +3146,10 @@ void Heap::PushOnThreadLocalAllocationStackWithInternalGC(Thread* self, mirror::
   DCHECK(!self->PushOnThreadLocalAllocationStack(*obj));
   StackReference<mirror::Object>* start_address;
   StackReference<mirror::Object>* end_address;
-  while (!allocation_stack_->AtomicBumpBack(kThreadLocalAllocationStackSize, &start_address,
-                                            &end_address)) {
+  // Request progressively larger segments for threads which keep exhausting theirs, so that
+  // allocation-heavy threads touch the shared bump pointer less often.
+  const size_t refill_size = self->GetThreadLocalAllocStackRefillSize();
+  while (!allocation_stack_->AtomicBumpBack(refill_size, &start_address, &end_address)) {
     // TODO: Add handle VerifyObject.
     StackHandleScope<1> hs(self);
     HandleWrapper<mirror::Object> wrapper(hs.NewHandleWrapper(obj));
@@ -3069,6 +3161,7 @@ void Heap::PushOnThreadLocalAllocationStackWithInternalGC(Thread* self, mirror::
     CollectGarbageInternal(collector::kGcTypeSticky, kGcCauseForAlloc, false);
   }
   self->SetThreadLocalAllocationStack(start_address, end_address);
+  self->GrowThreadLocalAllocStackRefillSize();
   // Retry on the new thread-local allocation stack.
   CHECK(self->PushOnThreadLocalAllocationStack(*obj));  // Must succeed.
 }
@@ -3456,7 +3549,9 @@ collector::GcType Heap::WaitForGcToComplete(GcCause cause, Thread* self) {
 collector::GcType Heap::WaitForGcToCompleteLocked(GcCause cause, Thread* self) {
   collector::GcType last_gc_type = collector::kGcTypeNone;
   uint64_t wait_start = NanoTime();
+  bool has_waited = false;
   while (collector_type_running_ != kCollectorTypeNone) {
+    has_waited = true;
     if (self != task_processor_->GetRunningThread()) {
       // The current thread is about to wait for a currently running
       // collection to finish. If the waiting thread is not the heap
@@ -3472,6 +3567,9 @@ collector::GcType Heap::WaitForGcToCompleteLocked(GcCause cause, Thread* self) {
   }
   uint64_t wait_time = NanoTime() - wait_start;
   total_wait_time_ += wait_time;
+  if (has_waited) {
+    gc_stall_histogram_.AddValue(wait_time);
+  }
   if (wait_time > long_pause_log_threshold_) {
     LOG(INFO) << "WaitForGcToComplete blocked for " << PrettyDuration(wait_time)
         << " for cause " << cause;
@@ -3679,7 +3777,7 @@ void Heap::RequestConcurrentGCAndSaveObject(Thread* self, bool force_full, mirro
 class Heap::ConcurrentGCTask : public HeapTask {
  public:
   ConcurrentGCTask(uint64_t target_time, bool force_full)
-      : HeapTask(target_time), force_full_(force_full) { }
+      : HeapTask(target_time, kHeapTaskPriorityPauseCritical), force_full_(force_full) { }
   virtual void Run(Thread* self) OVERRIDE {
     gc::Heap* heap = Runtime::Current()->GetHeap();
     heap->ConcurrentGC(self, force_full_);
@@ -3773,12 +3871,20 @@ void Heap::RequestCollectorTransition(CollectorType desired_collector_type, uint
 
 class Heap::HeapTrimTask : public HeapTask {
  public:
-  explicit HeapTrimTask(uint64_t delta_time) : HeapTask(NanoTime() + delta_time) { }
+  HeapTrimTask(uint64_t delta_time, bool first_slice)
+      : HeapTask(NanoTime() + delta_time, kHeapTaskPriorityHygiene), first_slice_(first_slice) { }
   virtual void Run(Thread* self) OVERRIDE {
     gc::Heap* heap = Runtime::Current()->GetHeap();
-    heap->Trim(self);
+    const bool done = heap->Trim(self, NanoTime() + kHeapTrimSliceDuration, first_slice_);
     heap->ClearPendingTrim(self);
+    if (!done) {
+      // More pages remain to be released; let the mutators run, then take another slice.
+      heap->RequestTrim(self, kHeapTrimSliceInterval, /* first_slice */ false);
+    }
   }
+
+ private:
+  const bool first_slice_;
 };
 
 void Heap::ClearPendingTrim(Thread* self) {
@@ -3786,7 +3892,7 @@ void Heap::ClearPendingTrim(Thread* self) {
   pending_heap_trim_ = nullptr;
 }
 
-void Heap::RequestTrim(Thread* self) {
+void Heap::RequestTrim(Thread* self, uint64_t delta_time, bool first_slice) {
   if (!CanAddHeapTask(self)) {
     return;
   }
@@ -3809,7 +3915,7 @@ void Heap::RequestTrim(Thread* self) {
       // Already have a heap trim request in task processor, ignore this request.
       return;
     }
-    added_task = new HeapTrimTask(kHeapTrimWait);
+    added_task = new HeapTrimTask(delta_time, first_slice);
     pending_heap_trim_ = added_task;
   }
   task_processor_->AddTask(self, added_task);
@@ -3867,11 +3973,43 @@ void Heap::RunFinalization(JNIEnv* env, uint64_t timeout) {
                             static_cast<jlong>(timeout));
 }
 
+// Half-life of the decayed native allocation accumulator. Short enough that burst detection
+// reacts within a couple of decoded images and drops out quickly once the burst ends.
+static constexpr uint64_t kNativeAllocationRateHalfLifeNs = MsToNs(250);
+// Decayed native bytes above which the mutator is considered to be in an allocation burst.
+static constexpr size_t kNativeAllocationBurstBytes = 8 * MB;
+
+bool Heap::UpdateNativeAllocationRate(size_t bytes) {
+  const uint64_t now = NanoTime();
+  const uint64_t elapsed_ns = now - native_velocity_update_ns_;
+  // Decay the accumulator by 2^-(elapsed / half_life). The first registration sees a huge
+  // elapsed time and decays the zero-initialized accumulator to zero, which is correct.
+  native_velocity_bytes_ *= std::pow(
+      2.0, -static_cast<double>(elapsed_ns) / static_cast<double>(kNativeAllocationRateHalfLifeNs));
+  native_velocity_bytes_ += bytes;
+  native_velocity_update_ns_ = now;
+  return native_velocity_bytes_ > kNativeAllocationBurstBytes;
+}
+
+uint64_t Heap::GetNativeAllocationRate() {
+  MutexLock mu(Thread::Current(), native_histogram_lock_);
+  const uint64_t elapsed_ns = NanoTime() - native_velocity_update_ns_;
+  const double decayed = native_velocity_bytes_ * std::pow(
+      2.0, -static_cast<double>(elapsed_ns) / static_cast<double>(kNativeAllocationRateHalfLifeNs));
+  // The accumulator integrates bytes with half-life decay, so dividing by the mean age of its
+  // window (half-life / ln 2) converts it to bytes per second.
+  const double mean_window_seconds =
+      static_cast<double>(kNativeAllocationRateHalfLifeNs) / (M_LN2 * 1e9);
+  return static_cast<uint64_t>(decayed / mean_window_seconds);
+}
+
 void Heap::RegisterNativeAllocation(JNIEnv* env, size_t bytes) {
   Thread* self = ThreadForEnv(env);
+  bool bursting;
   {
     MutexLock mu(self, native_histogram_lock_);
     native_allocation_histogram_.AddValue(bytes);
+    bursting = UpdateNativeAllocationRate(bytes);
   }
   if (native_need_to_run_finalization_) {
     RunFinalization(env, kNativeAllocationFinalizeTimeout);
@@ -3906,7 +4044,16 @@ void Heap::RegisterNativeAllocation(JNIEnv* env, size_t bytes) {
       // finalizers released native managed allocations.
       UpdateMaxNativeFootprint();
     } else if (!IsGCRequestPending()) {
-      if (IsGcConcurrent()) {
+      // During an allocation burst, crossing the watermark says more about the burst than about
+      // garbage: defer the equilibrium GC while there is still headroom below the hard limit
+      // rather than collecting once per watermark crossing. The burst either ends, letting the
+      // next registration trigger normally, or allocations reach the halfway point and collect
+      // anyway.
+      const size_t headroom_limit = native_footprint_gc_watermark_ +
+          (growth_limit_ - native_footprint_gc_watermark_) / 2;
+      if (bursting && new_native_bytes_allocated < headroom_limit) {
+        native_gcs_deferred_.FetchAndAddRelaxed(1u);
+      } else if (IsGcConcurrent()) {
         RequestConcurrentGC(self, true);  // Request non-sticky type.
       } else {
         CollectGarbageInternal(gc_type, kGcCauseForNativeAlloc, false);
@@ -25,6 +25,7 @@
 #include "allocator_type.h"
 #include "arch/instruction_set.h"
 #include "atomic.h"
+#include "base/concurrent_histogram.h"
 #include "base/time_utils.h"
 #include "gc/accounting/atomic_stack.h"
 #include "gc/accounting/card_table.h"
@@ -148,6 +149,12 @@ class Heap {
 
   // How often we allow heap trimming to happen (nanoseconds).
   static constexpr uint64_t kHeapTrimWait = MsToNs(5000);
+  // Maximum duration of one incremental heap trim slice (nanoseconds). Releasing empty pages of
+  // large heaps is split into slices of roughly this length so the trim never causes a single
+  // long stall on the task processor thread while it holds the rosalloc lock.
+  static constexpr uint64_t kHeapTrimSliceDuration = MsToNs(2);
+  // Delay between two incremental heap trim slices (nanoseconds).
+  static constexpr uint64_t kHeapTrimSliceInterval = MsToNs(50);
   // How long we wait after a transition request to perform a collector transition (nanoseconds).
   static constexpr uint64_t kCollectorTransitionWait = MsToNs(5000);
 
@@ -468,6 +475,12 @@ class Heap {
     return num_bytes_allocated_.LoadSequentiallyConsistent();
   }
 
+  // Returns the minimum size an eligible object must have to be allocated in
+  // the large object space.
+  size_t GetLargeObjectThreshold() const {
+    return large_object_threshold_;
+  }
+
   // Returns the number of objects currently allocated.
   size_t GetObjectsAllocated() const
       REQUIRES(!Locks::heap_bitmap_lock_);
@@ -537,8 +550,12 @@ class Heap {
   // Do a pending collector transition.
   void DoPendingCollectorTransition() REQUIRES(!*gc_complete_lock_);
 
-  // Deflate monitors, ... and trim the spaces.
-  void Trim(Thread* self) REQUIRES(!*gc_complete_lock_);
+  // Deflate monitors, ... and trim the spaces. If slice_deadline_ns is non-zero, page release
+  // stops at the deadline and false is returned to signal that another slice is needed; monitor
+  // deflation runs a bounded batch per slice, and the reference table and arena trimming is only
+  // done when first_slice is true.
+  bool Trim(Thread* self, uint64_t slice_deadline_ns = 0u, bool first_slice = true)
+      REQUIRES(!*gc_complete_lock_);
 
   void RevokeThreadLocalBuffers(Thread* thread);
   void RevokeRosAllocThreadLocalBuffers(Thread* thread);
@@ -655,7 +672,7 @@ class Heap {
 
   // GC performance measuring
   void DumpGcPerformanceInfo(std::ostream& os)
-      REQUIRES(!*gc_complete_lock_, !native_histogram_lock_);
+      REQUIRES(!*gc_complete_lock_, !native_histogram_lock_, !Locks::alloc_tracker_lock_);
   void ResetGcPerformanceInfo() REQUIRES(!*gc_complete_lock_);
 
   // Thread pool.
@@ -718,8 +735,10 @@ class Heap {
     return disable_moving_gc_count_ > 0;
   }
 
-  // Request an asynchronous trim.
-  void RequestTrim(Thread* self) REQUIRES(!*pending_task_lock_);
+  // Request an asynchronous trim. Continuation slices of an incremental trim pass a shorter
+  // delta_time and first_slice = false.
+  void RequestTrim(Thread* self, uint64_t delta_time = kHeapTrimWait, bool first_slice = true)
+      REQUIRES(!*pending_task_lock_);
 
   // Request asynchronous GC.
   void RequestConcurrentGC(Thread* self, bool force_full) REQUIRES(!*pending_task_lock_);
@@ -740,6 +759,15 @@ class Heap {
   void DumpGcCountRateHistogram(std::ostream& os) const REQUIRES(!*gc_complete_lock_);
   void DumpBlockingGcCountRateHistogram(std::ostream& os) const REQUIRES(!*gc_complete_lock_);
 
+  // Estimated native allocation rate in bytes per second, exponentially decayed. Exposed
+  // together with GetDeferredNativeGcCount so native GC triggering can be tuned per device.
+  uint64_t GetNativeAllocationRate() REQUIRES(!native_histogram_lock_);
+
+  // Number of native-watermark GCs skipped because the mutator was in an allocation burst.
+  uint64_t GetDeferredNativeGcCount() const {
+    return native_gcs_deferred_.LoadRelaxed();
+  }
+
   // Allocation tracking support
   // Callers to this function use double-checked locking to ensure safety on allocation_records_
   bool IsAllocTrackingEnabled() const {
@@ -782,6 +810,9 @@ class Heap {
 
   // Create a new alloc space and compact default alloc space to it.
   HomogeneousSpaceCompactResult PerformHomogeneousSpaceCompact() REQUIRES(!*gc_complete_lock_);
+  // Conservative estimate of the bytes a homogeneous space compaction of the main space could
+  // give back. Returns zero when there is no compactable main space.
+  size_t EstimateMainSpaceFragmentationSlack();
   bool SupportHomogeneousSpaceCompactAndCollectorTransitions() const;
 
  private:
@@ -936,6 +967,10 @@ class Heap {
   // bytes allocated and the target utilization ratio.
   void UpdateMaxNativeFootprint();
 
+  // Fold a newly registered native allocation into the decayed allocation accumulator. Returns
+  // whether the mutator is currently in a native allocation burst.
+  bool UpdateNativeAllocationRate(size_t bytes) REQUIRES(native_histogram_lock_);
+
   // Find a collector based on GC type.
   collector::GarbageCollector* FindCollectorByGcType(collector::GcType gc_type);
 
@@ -998,8 +1033,10 @@ class Heap {
     return collector_type_ == kCollectorTypeCMS || collector_type_ == kCollectorTypeCC;
   }
 
-  // Trim the managed and native spaces by releasing unused memory back to the OS.
-  void TrimSpaces(Thread* self) REQUIRES(!*gc_complete_lock_);
+  // Trim the managed and native spaces by releasing unused memory back to the OS. A non-zero
+  // deadline_ns bounds the rosalloc page release; returns true once all spaces are fully
+  // trimmed.
+  bool TrimSpaces(Thread* self, uint64_t deadline_ns) REQUIRES(!*gc_complete_lock_);
 
   // Trim 0 pages at the end of reference tables.
   void TrimIndirectReferenceTables(Thread* self);
@@ -1162,6 +1199,15 @@ class Heap {
   Histogram<uint64_t> native_allocation_histogram_;
   Histogram<uint64_t> native_free_histogram_;
 
+  // Exponentially decayed accumulator of registered native bytes and the time it was last
+  // folded into, used to estimate the current native allocation rate.
+  double native_velocity_bytes_ GUARDED_BY(native_histogram_lock_);
+  uint64_t native_velocity_update_ns_ GUARDED_BY(native_histogram_lock_);
+
+  // Number of native-watermark GCs skipped because the mutator was in an allocation burst with
+  // headroom left below the growth limit.
+  Atomic<uint64_t> native_gcs_deferred_;
+
   // Number of bytes freed by thread local buffer revokes. This will
   // cancel out the ahead-of-time bulk counting of bytes allocated in
   // rosalloc thread-local buffers.  It is temporarily accumulated
@@ -1262,6 +1308,10 @@ class Heap {
   // Total time which mutators are paused or waiting for GC to complete.
   uint64_t total_wait_time_;
 
+  // Distribution of individual mutator stalls waiting for the GC, recorded lock-free so that
+  // every stall can be captured in production. Nanosecond values.
+  ConcurrentHistogram gc_stall_histogram_;
+
   // The current state of heap verification, may be enabled or disabled.
   VerifyObjectMode verify_object_mode_;
 
@@ -136,13 +136,16 @@ size_t ReferenceQueue::GetLength() const {
 
 void ReferenceQueue::ClearWhiteReferences(ReferenceQueue* cleared_references,
                                           collector::GarbageCollector* collector) {
+  // Hoisted out of the loop; the transaction state cannot change while references are being
+  // processed.
+  const bool transaction_active = Runtime::Current()->IsActiveTransaction();
   while (!IsEmpty()) {
     mirror::Reference* ref = DequeuePendingReference();
     mirror::HeapReference<mirror::Object>* referent_addr = ref->GetReferentReferenceAddr();
     if (referent_addr->AsMirrorPtr() != nullptr &&
         !collector->IsMarkedHeapReference(referent_addr)) {
       // Referent is white, clear it.
-      if (Runtime::Current()->IsActiveTransaction()) {
+      if (transaction_active) {
         ref->ClearReferent<true>();
       } else {
         ref->ClearReferent<false>();
@@ -154,6 +157,7 @@ void ReferenceQueue::ClearWhiteReferences(ReferenceQueue* cleared_references,
 
 void ReferenceQueue::EnqueueFinalizerReferences(ReferenceQueue* cleared_references,
                                                 collector::GarbageCollector* collector) {
+  const bool transaction_active = Runtime::Current()->IsActiveTransaction();
   while (!IsEmpty()) {
     mirror::FinalizerReference* ref = DequeuePendingReference()->AsFinalizerReference();
     mirror::HeapReference<mirror::Object>* referent_addr = ref->GetReferentReferenceAddr();
@@ -161,7 +165,7 @@ void ReferenceQueue::EnqueueFinalizerReferences(ReferenceQueue* cleared_referenc
         !collector->IsMarkedHeapReference(referent_addr)) {
       mirror::Object* forward_address = collector->MarkObject(referent_addr->AsMirrorPtr());
       // Move the updated referent to the zombie field.
-      if (Runtime::Current()->IsActiveTransaction()) {
+      if (transaction_active) {
         ref->SetZombie<true>(forward_address);
         ref->ClearReferent<true>();
       } else {
@@ -180,11 +184,15 @@ void ReferenceQueue::ForwardSoftReferences(MarkObjectVisitor* visitor) {
   mirror::Reference* const head = list_;
   mirror::Reference* ref = head;
   do {
+    mirror::Reference* const next = ref->GetPendingNext();
+    // The queue is a linked list of cold reference objects; fetch the next node while the
+    // current referent is being marked.
+    __builtin_prefetch(next);
     mirror::HeapReference<mirror::Object>* referent_addr = ref->GetReferentReferenceAddr();
     if (referent_addr->AsMirrorPtr() != nullptr) {
       visitor->MarkHeapReference(referent_addr);
     }
-    ref = ref->GetPendingNext();
+    ref = next;
   } while (LIKELY(ref != head));
 }
 
@@ -82,6 +82,22 @@ void BumpPointerSpace::Clear() {
   }
 }
 
+size_t BumpPointerSpace::ReleaseTailPages() {
+  uint8_t* const end = End();
+  uint8_t* const aligned_end = AlignUp(end, kPageSize);
+  // The partial page at the end cannot be released; zero it in place so that future bump
+  // allocations still see zeroed memory.
+  memset(end, 0, aligned_end - end);
+  const size_t unused_size = static_cast<size_t>(Limit() - aligned_end);
+  if (unused_size != 0) {
+    if (!kMadviseZeroes) {
+      memset(aligned_end, 0, unused_size);
+    }
+    CHECK_NE(madvise(aligned_end, unused_size, MADV_DONTNEED), -1) << "madvise failed";
+  }
+  return unused_size;
+}
+
 void BumpPointerSpace::Dump(std::ostream& os) const {
   os << GetName() << " "
       << reinterpret_cast<void*>(Begin()) << "-" << reinterpret_cast<void*>(End()) << " - "
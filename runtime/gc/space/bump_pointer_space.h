@@ -101,6 +101,12 @@ class BumpPointerSpace FINAL : public ContinuousMemMapAllocSpace {
   // Reset the space to empty.
   void Clear() OVERRIDE REQUIRES(!block_lock_);
 
+  // Releases the unused pages between the current end of the space and its limit back to
+  // the operating system; they fault back in zeroed on demand if the space grows again.
+  // Returns the number of bytes released. Only safe when mutators cannot be allocating,
+  // e.g. while threads are suspended right after the space was compacted.
+  size_t ReleaseTailPages();
+
   void Dump(std::ostream& os) const;
 
   size_t RevokeThreadLocalBuffers(Thread* thread) REQUIRES(!block_lock_);
@@ -17,7 +17,9 @@
 #include "image_space.h"
 
 #include <lz4.h>
+#include <pthread.h>
 #include <random>
+#include <sys/mman.h>
 #include <sys/statvfs.h>
 #include <sys/types.h>
 #include <unistd.h>
@@ -31,6 +33,7 @@
 #include "gc/accounting/space_bitmap-inl.h"
 #include "image-inl.h"
 #include "image_space_fs.h"
+#include "intern_table.h"
 #include "mirror/class-inl.h"
 #include "mirror/object-inl.h"
 #include "oat_file.h"
@@ -750,6 +753,32 @@ class FixupRootVisitor : public FixupVisitor {
   }
 };
 
+// Adapt FixupRootVisitor for InternTable::VisitSerializedTable, which takes a RootVisitor.
+// Must not dereference the roots since they are only valid once forwarded.
+class FixupInternTableRootVisitor FINAL : public RootVisitor {
+ public:
+  explicit FixupInternTableRootVisitor(const FixupRootVisitor& visitor) : visitor_(visitor) {}
+
+  void VisitRoots(mirror::Object*** roots, size_t count, const RootInfo& info ATTRIBUTE_UNUSED)
+      OVERRIDE SHARED_REQUIRES(Locks::mutator_lock_) {
+    for (size_t i = 0; i < count; ++i) {
+      *roots[i] = visitor_.ForwardObject(*roots[i]);
+    }
+  }
+
+  void VisitRoots(mirror::CompressedReference<mirror::Object>** roots,
+                  size_t count,
+                  const RootInfo& info ATTRIBUTE_UNUSED)
+      OVERRIDE SHARED_REQUIRES(Locks::mutator_lock_) {
+    for (size_t i = 0; i < count; ++i) {
+      visitor_.VisitRoot(roots[i]);
+    }
+  }
+
+ private:
+  const FixupRootVisitor& visitor_;
+};
+
 class FixupObjectVisitor : public FixupVisitor {
  public:
   template<typename... Args>
@@ -1147,6 +1176,19 @@ static bool RelocateInPlace(ImageHeader& image_header,
       FixupRootVisitor root_visitor(boot_image, boot_oat, app_image, app_oat);
       temp_table.VisitRoots(root_visitor);
     }
+    const auto& intern_table_section = image_header.GetImageSection(
+        ImageHeader::kSectionInternedStrings);
+    if (intern_table_section.Size() > 0u) {
+      TimingLogger::ScopedTiming timing("Fixup intern table", &logger);
+      // Fix up the table in place so that the class linker can merge it into the runtime intern
+      // table without another pass. The serialized roots still hold compile-time addresses, so
+      // they may not be dereferenced until they are forwarded.
+      ScopedObjectAccess soa(Thread::Current());
+      FixupRootVisitor root_visitor(boot_image, boot_oat, app_image, app_oat);
+      FixupInternTableRootVisitor intern_table_visitor(root_visitor);
+      InternTable::VisitSerializedTable(target_base + intern_table_section.Offset(),
+                                        &intern_table_visitor);
+    }
   }
   if (VLOG_IS_ON(image)) {
     logger.Dump(LOG(INFO));
@@ -1154,6 +1196,108 @@ static bool RelocateInPlace(ImageHeader& image_header,
   return true;
 }
 
+// Opens and checks the oat file referenced by the image header. The header is passed
+// explicitly (rather than read from the mapped image) so that this can run on a worker
+// thread while the mapped copy is still being written.
+static OatFile* OpenImageOatFile(const char* image_path,
+                                 const ImageHeader& image_header,
+                                 const char* space_name,
+                                 std::string* error_msg) {
+  std::string oat_filename = ImageHeader::GetOatLocationFromImageLocation(image_path);
+
+  CHECK(image_header.GetOatDataBegin() != nullptr);
+
+  OatFile* oat_file = OatFile::Open(oat_filename,
+                                    oat_filename,
+                                    image_header.GetOatDataBegin(),
+                                    image_header.GetOatFileBegin(),
+                                    !Runtime::Current()->IsAotCompiler(),
+                                    /*low_4gb*/false,
+                                    nullptr,
+                                    error_msg);
+  if (oat_file == nullptr) {
+    *error_msg = StringPrintf("Failed to open oat file '%s' referenced from image %s: %s",
+                              oat_filename.c_str(), space_name, error_msg->c_str());
+    return nullptr;
+  }
+  uint32_t oat_checksum = oat_file->GetOatHeader().GetChecksum();
+  uint32_t image_oat_checksum = image_header.GetOatChecksum();
+  if (oat_checksum != image_oat_checksum) {
+    *error_msg = StringPrintf("Failed to match oat file checksum 0x%x to expected oat checksum 0x%x"
+                              " in image %s", oat_checksum, image_oat_checksum, space_name);
+    delete oat_file;
+    return nullptr;
+  }
+  int32_t image_patch_delta = image_header.GetPatchDelta();
+  int32_t oat_patch_delta = oat_file->GetOatHeader().GetImagePatchDelta();
+  if (oat_patch_delta != image_patch_delta && !image_header.CompilePic()) {
+    // We should have already relocated by this point. Bail out.
+    *error_msg = StringPrintf("Failed to match oat file patch delta %d to expected patch delta %d "
+                              "in image %s", oat_patch_delta, image_patch_delta, space_name);
+    delete oat_file;
+    return nullptr;
+  }
+
+  return oat_file;
+}
+
+// Opens an image's oat file on a worker thread so that the open, which is dominated by I/O
+// on a separate file, overlaps the mapping, decompression and bitmap work in
+// ImageSpace::Init. The worker only reads the copy of the image header taken at
+// construction time, never the mapped (and possibly concurrently written) one.
+class BootOatFileOpenTask {
+ public:
+  BootOatFileOpenTask(const char* image_path, const ImageHeader& image_header)
+      : image_path_(image_path), image_header_(image_header), started_(false) {}
+
+  // Covers the error paths of Init(); normally the thread is joined when the result is
+  // claimed through ReleaseOatFile().
+  ~BootOatFileOpenTask() {
+    Join();
+  }
+
+  void Start() {
+    DCHECK(!started_);
+    CHECK_PTHREAD_CALL(pthread_create, (&thread_, nullptr, &Callback, this), "image oat open");
+    started_ = true;
+  }
+
+  void Join() {
+    if (started_) {
+      CHECK_PTHREAD_CALL(pthread_join, (thread_, nullptr), "image oat open");
+      started_ = false;
+    }
+  }
+
+  // Returns the opened oat file, or null with error_msg set. Must be called after Join().
+  OatFile* ReleaseOatFile(std::string* error_msg) {
+    DCHECK(!started_);
+    if (oat_file_ == nullptr) {
+      *error_msg = error_msg_;
+    }
+    return oat_file_.release();
+  }
+
+ private:
+  static void* Callback(void* arg) {
+    BootOatFileOpenTask* task = reinterpret_cast<BootOatFileOpenTask*>(arg);
+    task->oat_file_.reset(OpenImageOatFile(task->image_path_,
+                                           task->image_header_,
+                                           task->image_path_,
+                                           &task->error_msg_));
+    return nullptr;
+  }
+
+  const char* const image_path_;
+  const ImageHeader image_header_;
+  pthread_t thread_;
+  bool started_;
+  std::unique_ptr<OatFile> oat_file_;
+  std::string error_msg_;
+
+  DISALLOW_COPY_AND_ASSIGN(BootOatFileOpenTask);
+};
+
 ImageSpace* ImageSpace::Init(const char* image_filename,
                              const char* image_location,
                              bool validate_oat_file,
@@ -1207,6 +1351,16 @@ ImageSpace* ImageSpace::Init(const char* image_filename,
     }
   }
 
+  // For the boot image the oat file is opened below. The open only needs the header read
+  // above and is dominated by I/O on a separate file, so kick it off on a worker thread
+  // now and let it overlap the mapping, decompression and bitmap work. Init() only
+  // succeeds for a boot image when it maps at its preferred address (boot images are not
+  // compiled PIC), so the header values captured here match the final ones.
+  BootOatFileOpenTask oat_open_task(image_filename, temp_image_header);
+  if (oat_file == nullptr) {
+    oat_open_task.Start();
+  }
+
   if (VLOG_IS_ON(startup)) {
     LOG(INFO) << "Dumping image sections";
     for (size_t i = 0; i < ImageHeader::kSectionCount; ++i) {
@@ -1320,6 +1474,15 @@ ImageSpace* ImageSpace::Init(const char* image_filename,
   }
   DCHECK_EQ(0, memcmp(image_header, map->Begin(), sizeof(ImageHeader)));
 
+  if (image_header->GetStorageMode() == ImageHeader::kStorageModeUncompressed) {
+    // The image was mapped file-backed and would be faulted in one random read at a time as
+    // objects are touched. Startup walks most of the image, so ask the kernel to start reading
+    // it ahead asynchronously now. The compressed modes already read all the data above.
+    if (madvise(map->Begin(), map->Size(), MADV_WILLNEED) != 0) {
+      PLOG(WARNING) << "madvise(MADV_WILLNEED) failed for " << image_filename;
+    }
+  }
+
   std::unique_ptr<MemMap> image_bitmap_map(MemMap::MapFileAtAddress(nullptr,
                                                                     bitmap_section.Size(),
                                                                     PROT_READ, MAP_PRIVATE,
@@ -1382,7 +1545,8 @@ ImageSpace* ImageSpace::Init(const char* image_filename,
   // set yet at this point.
   if (oat_file == nullptr) {
     TimingLogger::ScopedTiming timing("OpenOatFile", &logger);
-    space->oat_file_.reset(space->OpenOatFile(image_filename, error_msg));
+    oat_open_task.Join();
+    space->oat_file_.reset(oat_open_task.ReleaseOatFile(error_msg));
     if (space->oat_file_ == nullptr) {
       DCHECK(!error_msg->empty());
       return nullptr;
@@ -1439,64 +1603,95 @@ ImageSpace* ImageSpace::Init(const char* image_filename,
   return space.release();
 }
 
-OatFile* ImageSpace::OpenOatFile(const char* image_path, std::string* error_msg) const {
-  const ImageHeader& image_header = GetImageHeader();
-  std::string oat_filename = ImageHeader::GetOatLocationFromImageLocation(image_path);
-
-  CHECK(image_header.GetOatDataBegin() != nullptr);
-
-  OatFile* oat_file = OatFile::Open(oat_filename,
-                                    oat_filename,
-                                    image_header.GetOatDataBegin(),
-                                    image_header.GetOatFileBegin(),
-                                    !Runtime::Current()->IsAotCompiler(),
-                                    /*low_4gb*/false,
-                                    nullptr,
-                                    error_msg);
-  if (oat_file == nullptr) {
-    *error_msg = StringPrintf("Failed to open oat file '%s' referenced from image %s: %s",
-                              oat_filename.c_str(), GetName(), error_msg->c_str());
-    return nullptr;
-  }
-  uint32_t oat_checksum = oat_file->GetOatHeader().GetChecksum();
-  uint32_t image_oat_checksum = image_header.GetOatChecksum();
-  if (oat_checksum != image_oat_checksum) {
-    *error_msg = StringPrintf("Failed to match oat file checksum 0x%x to expected oat checksum 0x%x"
-                              " in image %s", oat_checksum, image_oat_checksum, GetName());
-    return nullptr;
+// Checks that the dex file referenced by the oat file still has the checksum the oat file
+// was compiled against.
+static bool ValidateOatDexFileChecksum(const OatFile::OatDexFile* oat_dex_file,
+                                       const char* space_name,
+                                       const OatFile* oat_file,
+                                       std::string* error_msg) {
+  const std::string& dex_file_location = oat_dex_file->GetDexFileLocation();
+  uint32_t dex_file_location_checksum;
+  if (!DexFile::GetChecksum(dex_file_location.c_str(), &dex_file_location_checksum, error_msg)) {
+    *error_msg = StringPrintf("Failed to get checksum of dex file '%s' referenced by image %s: "
+                              "%s", dex_file_location.c_str(), space_name, error_msg->c_str());
+    return false;
   }
-  int32_t image_patch_delta = image_header.GetPatchDelta();
-  int32_t oat_patch_delta = oat_file->GetOatHeader().GetImagePatchDelta();
-  if (oat_patch_delta != image_patch_delta && !image_header.CompilePic()) {
-    // We should have already relocated by this point. Bail out.
-    *error_msg = StringPrintf("Failed to match oat file patch delta %d to expected patch delta %d "
-                              "in image %s", oat_patch_delta, image_patch_delta, GetName());
-    return nullptr;
+  if (dex_file_location_checksum != oat_dex_file->GetDexFileLocationChecksum()) {
+    *error_msg = StringPrintf("ValidateOatFile found checksum mismatch between oat file '%s' and "
+                              "dex file '%s' (0x%x != 0x%x)",
+                              oat_file->GetLocation().c_str(), dex_file_location.c_str(),
+                              oat_dex_file->GetDexFileLocationChecksum(),
+                              dex_file_location_checksum);
+    return false;
   }
+  return true;
+}
 
-  return oat_file;
+// The slice of the oat file's dex files checked by one worker thread in ValidateOatFile.
+struct ValidateOatFileSlice {
+  const OatFile* oat_file;
+  const char* space_name;
+  size_t start_index;
+  size_t stride;
+  bool ok;
+  std::string error_msg;
+};
+
+static void* ValidateOatFileSliceCallback(void* arg) {
+  ValidateOatFileSlice* slice = reinterpret_cast<ValidateOatFileSlice*>(arg);
+  const std::vector<const OatFile::OatDexFile*>& oat_dex_files =
+      slice->oat_file->GetOatDexFiles();
+  slice->ok = true;
+  for (size_t i = slice->start_index; i < oat_dex_files.size(); i += slice->stride) {
+    if (!ValidateOatDexFileChecksum(oat_dex_files[i],
+                                    slice->space_name,
+                                    slice->oat_file,
+                                    &slice->error_msg)) {
+      slice->ok = false;
+      return nullptr;
+    }
+  }
+  return nullptr;
 }
 
 bool ImageSpace::ValidateOatFile(std::string* error_msg) const {
   CHECK(oat_file_.get() != nullptr);
-  for (const OatFile::OatDexFile* oat_dex_file : oat_file_->GetOatDexFiles()) {
-    const std::string& dex_file_location = oat_dex_file->GetDexFileLocation();
-    uint32_t dex_file_location_checksum;
-    if (!DexFile::GetChecksum(dex_file_location.c_str(), &dex_file_location_checksum, error_msg)) {
-      *error_msg = StringPrintf("Failed to get checksum of dex file '%s' referenced by image %s: "
-                                "%s", dex_file_location.c_str(), GetName(), error_msg->c_str());
-      return false;
+  const std::vector<const OatFile::OatDexFile*>& oat_dex_files = oat_file_->GetOatDexFiles();
+  // Checksumming a dex file inflates it from its zip container, so validating the whole
+  // boot class path serially dominates the load time of a cache image. Spread the dex
+  // files over a few worker threads; this runs before the runtime is fully up, so plain
+  // pthreads are used instead of a ThreadPool.
+  static constexpr size_t kMaxValidationWorkers = 4;
+  const size_t worker_count = std::min(oat_dex_files.size(), kMaxValidationWorkers);
+  if (worker_count <= 1u) {
+    for (const OatFile::OatDexFile* oat_dex_file : oat_dex_files) {
+      if (!ValidateOatDexFileChecksum(oat_dex_file, GetName(), oat_file_.get(), error_msg)) {
+        return false;
+      }
     }
-    if (dex_file_location_checksum != oat_dex_file->GetDexFileLocationChecksum()) {
-      *error_msg = StringPrintf("ValidateOatFile found checksum mismatch between oat file '%s' and "
-                                "dex file '%s' (0x%x != 0x%x)",
-                                oat_file_->GetLocation().c_str(), dex_file_location.c_str(),
-                                oat_dex_file->GetDexFileLocationChecksum(),
-                                dex_file_location_checksum);
-      return false;
+    return true;
+  }
+  std::vector<ValidateOatFileSlice> slices(worker_count);
+  std::vector<pthread_t> threads(worker_count);
+  for (size_t i = 0; i < worker_count; ++i) {
+    slices[i].oat_file = oat_file_.get();
+    slices[i].space_name = GetName();
+    slices[i].start_index = i;
+    slices[i].stride = worker_count;
+    slices[i].ok = false;
+    CHECK_PTHREAD_CALL(pthread_create,
+                       (&threads[i], nullptr, &ValidateOatFileSliceCallback, &slices[i]),
+                       "oat file validation");
+  }
+  bool result = true;
+  for (size_t i = 0; i < worker_count; ++i) {
+    CHECK_PTHREAD_CALL(pthread_join, (threads[i], nullptr), "oat file validation");
+    if (result && !slices[i].ok) {
+      *error_msg = slices[i].error_msg;
+      result = false;
     }
   }
-  return true;
+  return result;
 }
 
 const OatFile* ImageSpace::GetOatFile() const {
@@ -165,9 +165,6 @@ class ImageSpace : public MemMapSpace {
                           std::string* error_msg)
       SHARED_REQUIRES(Locks::mutator_lock_);
 
-  OatFile* OpenOatFile(const char* image, std::string* error_msg) const
-      SHARED_REQUIRES(Locks::mutator_lock_);
-
   bool ValidateOatFile(std::string* error_msg) const
       SHARED_REQUIRES(Locks::mutator_lock_);
 
@@ -43,7 +43,7 @@ class MemoryToolLargeObjectMapSpace FINAL : public LargeObjectMapSpace {
   ~MemoryToolLargeObjectMapSpace() OVERRIDE {
     // Keep valgrind happy if there is any large objects such as dex cache arrays which aren't
     // freed since they are held live by the class linker.
-    MutexLock mu(Thread::Current(), lock_);
+    WriterMutexLock mu(Thread::Current(), lock_);
     for (auto& m : large_objects_) {
       delete m.second.mem_map;
     }
@@ -151,7 +151,7 @@ mirror::Object* LargeObjectMapSpace::Alloc(Thread* self, size_t num_bytes,
     space_bitmap = live_bitmap->GetContinuousSpaceBitmap(obj_end - 1);
     CHECK(space_bitmap == nullptr) << obj_end << " overlaps with bitmap " << *space_bitmap;
   }
-  MutexLock mu(self, lock_);
+  WriterMutexLock mu(self, lock_);
   large_objects_.Put(obj, LargeObject {mem_map, false /* not zygote */});
   const size_t allocation_size = mem_map->BaseSize();
   DCHECK(bytes_allocated != nullptr);
@@ -174,21 +174,21 @@ mirror::Object* LargeObjectMapSpace::Alloc(Thread* self, size_t num_bytes,
 }
 
 bool LargeObjectMapSpace::IsZygoteLargeObject(Thread* self, mirror::Object* obj) const {
-  MutexLock mu(self, lock_);
+  ReaderMutexLock mu(self, lock_);
   auto it = large_objects_.find(obj);
   CHECK(it != large_objects_.end());
   return it->second.is_zygote;
 }
 
 void LargeObjectMapSpace::SetAllLargeObjectsAsZygoteObjects(Thread* self) {
-  MutexLock mu(self, lock_);
+  WriterMutexLock mu(self, lock_);
   for (auto& pair : large_objects_) {
     pair.second.is_zygote = true;
   }
 }
 
 size_t LargeObjectMapSpace::Free(Thread* self, mirror::Object* ptr) {
-  MutexLock mu(self, lock_);
+  WriterMutexLock mu(self, lock_);
   auto it = large_objects_.find(ptr);
   if (UNLIKELY(it == large_objects_.end())) {
     ScopedObjectAccess soa(self);
@@ -207,7 +207,7 @@ size_t LargeObjectMapSpace::Free(Thread* self, mirror::Object* ptr) {
 }
 
 size_t LargeObjectMapSpace::AllocationSize(mirror::Object* obj, size_t* usable_size) {
-  MutexLock mu(Thread::Current(), lock_);
+  ReaderMutexLock mu(Thread::Current(), lock_);
   auto it = large_objects_.find(obj);
   CHECK(it != large_objects_.end()) << "Attempted to get size of a large object which is not live";
   size_t alloc_size = it->second.mem_map->BaseSize();
@@ -229,7 +229,7 @@ size_t LargeObjectSpace::FreeList(Thread* self, size_t num_ptrs, mirror::Object*
 }
 
 void LargeObjectMapSpace::Walk(DlMallocSpace::WalkCallback callback, void* arg) {
-  MutexLock mu(Thread::Current(), lock_);
+  WriterMutexLock mu(Thread::Current(), lock_);
   for (auto& pair : large_objects_) {
     MemMap* mem_map = pair.second.mem_map;
     callback(mem_map->Begin(), mem_map->End(), mem_map->Size(), arg);
@@ -239,11 +239,11 @@ void LargeObjectMapSpace::Walk(DlMallocSpace::WalkCallback callback, void* arg)
 
 bool LargeObjectMapSpace::Contains(const mirror::Object* obj) const {
   Thread* self = Thread::Current();
-  if (lock_.IsExclusiveHeld(self)) {
+  if (lock_.IsExclusiveHeld(self) || lock_.IsSharedHeld(self)) {
     // We hold lock_ so do the check.
     return large_objects_.find(const_cast<mirror::Object*>(obj)) != large_objects_.end();
   } else {
-    MutexLock mu(self, lock_);
+    ReaderMutexLock mu(self, lock_);
     return large_objects_.find(const_cast<mirror::Object*>(obj)) != large_objects_.end();
   }
 }
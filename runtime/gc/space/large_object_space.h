@@ -150,8 +150,10 @@ class LargeObjectMapSpace : public LargeObjectSpace {
   bool IsZygoteLargeObject(Thread* self, mirror::Object* obj) const OVERRIDE REQUIRES(!lock_);
   void SetAllLargeObjectsAsZygoteObjects(Thread* self) OVERRIDE REQUIRES(!lock_);
 
-  // Used to ensure mutual exclusion when the allocation spaces data structures are being modified.
-  mutable Mutex lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
+  // Used to ensure mutual exclusion when the allocation spaces data structures are being
+  // modified. Reader-writer so that the hot read-only lookups (Contains, AllocationSize) from
+  // multiple GC worker threads do not serialize behind each other.
+  mutable ReaderWriterMutex lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
   AllocationTrackingSafeMap<mirror::Object*, LargeObject, kAllocatorTagLOSMaps> large_objects_
       GUARDED_BY(lock_);
 };
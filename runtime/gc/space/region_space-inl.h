@@ -76,7 +76,8 @@ inline mirror::Object* RegionSpace::AllocNonvirtual(size_t num_bytes, size_t* by
         return nullptr;
       }
       for (size_t i = 0; i < num_regions_; ++i) {
-        Region* r = &regions_[i];
+        const size_t idx = (cyclic_alloc_region_index_ + i) % num_regions_;
+        Region* r = &regions_[idx];
         if (r->IsFree()) {
           r->Unfree(time_);
           r->SetNewlyAllocated();
@@ -84,6 +85,7 @@ inline mirror::Object* RegionSpace::AllocNonvirtual(size_t num_bytes, size_t* by
           obj = r->Alloc(num_bytes, bytes_allocated, usable_size, bytes_tl_bulk_allocated);
           CHECK(obj != nullptr);
           current_region_ = r;
+          cyclic_alloc_region_index_ = (idx + 1) % num_regions_;
           return obj;
         }
       }
@@ -32,9 +32,13 @@ RegionSpace* RegionSpace::Create(const std::string& name, size_t capacity,
                                  uint8_t* requested_begin) {
   capacity = RoundUp(capacity, kRegionSize);
   std::string error_msg;
+  // Ask for transparent huge page backing: the region space is by far the largest contiguous
+  // mapping and dominates dTLB pressure. This also huge-page aligns the base when no begin is
+  // requested, which satisfies the kRegionSize alignment checked in the constructor.
   std::unique_ptr<MemMap> mem_map(MemMap::MapAnonymous(name.c_str(), requested_begin, capacity,
                                                        PROT_READ | PROT_WRITE, true, false,
-                                                       &error_msg));
+                                                       &error_msg, /* use_ashmem */ false,
+                                                       /* huge_pages */ true));
   if (mem_map.get() == nullptr) {
     LOG(ERROR) << "Failed to allocate pages for alloc space (" << name << ") of size "
         << PrettySize(capacity) << " with message " << error_msg;
@@ -75,6 +79,7 @@ RegionSpace::RegionSpace(const std::string& name, MemMap* mem_map)
   DCHECK(full_region_.IsAllocated());
   current_region_ = &full_region_;
   evac_region_ = nullptr;
+  cyclic_alloc_region_index_ = 0U;
   size_t ignored;
   DCHECK(full_region_.Alloc(kAlignment, &ignored, nullptr, &ignored) == nullptr);
 }
@@ -115,14 +120,20 @@ size_t RegionSpace::ToSpaceSize() {
   return num_regions * kRegionSize;
 }
 
-inline bool RegionSpace::Region::ShouldBeEvacuated() {
+inline bool RegionSpace::Region::ShouldBeEvacuated(EvacMode evac_mode) {
   DCHECK((IsAllocated() || IsLarge()) && IsInToSpace());
+  if (evac_mode == EvacMode::kEvacModeForceAll) {
+    return true;
+  }
   // if the region was allocated after the start of the
   // previous GC or the live ratio is below threshold, evacuate
   // it.
   bool result;
   if (is_newly_allocated_) {
     result = true;
+  } else if (evac_mode == EvacMode::kEvacModeNewlyAllocated) {
+    // Young collection: old regions stay in place regardless of their live ratio.
+    result = false;
   } else {
     bool is_live_percent_valid = live_bytes_ != static_cast<size_t>(-1);
     if (is_live_percent_valid) {
@@ -145,7 +156,7 @@ inline bool RegionSpace::Region::ShouldBeEvacuated() {
 
 // Determine which regions to evacuate and mark them as
 // from-space. Mark the rest as unevacuated from-space.
-void RegionSpace::SetFromSpace(accounting::ReadBarrierTable* rb_table, bool force_evacuate_all) {
+void RegionSpace::SetFromSpace(accounting::ReadBarrierTable* rb_table, EvacMode evac_mode) {
   ++time_;
   if (kUseTableLookupReadBarrier) {
     DCHECK(rb_table->IsAllCleared());
@@ -164,7 +175,7 @@ void RegionSpace::SetFromSpace(accounting::ReadBarrierTable* rb_table, bool forc
         DCHECK((state == RegionState::kRegionStateAllocated ||
                 state == RegionState::kRegionStateLarge) &&
                type == RegionType::kRegionTypeToSpace);
-        bool should_evacuate = force_evacuate_all || r->ShouldBeEvacuated();
+        bool should_evacuate = r->ShouldBeEvacuated(evac_mode);
         if (should_evacuate) {
           r->SetAsFromSpace();
           DCHECK(r->IsInFromSpace());
@@ -278,6 +289,7 @@ void RegionSpace::Clear() {
   }
   current_region_ = &full_region_;
   evac_region_ = &full_region_;
+  cyclic_alloc_region_index_ = 0U;
 }
 
 void RegionSpace::Dump(std::ostream& os) const {
@@ -332,28 +344,43 @@ void RegionSpace::RecordAlloc(mirror::Object* ref) {
   reinterpret_cast<Atomic<uint64_t>*>(&r->objects_allocated_)->FetchAndAddSequentiallyConsistent(1);
 }
 
-bool RegionSpace::AllocNewTlab(Thread* self) {
+size_t RegionSpace::AllocNewTlab(Thread* self) {
   MutexLock mu(self, region_lock_);
   RevokeThreadLocalBuffersLocked(self);
   // Retain sufficient free regions for full evacuation.
   if ((num_non_free_regions_ + 1) * 2 > num_regions_) {
-    return false;
+    return 0U;
   }
   for (size_t i = 0; i < num_regions_; ++i) {
-    Region* r = &regions_[i];
+    const size_t idx = (cyclic_alloc_region_index_ + i) % num_regions_;
+    Region* r = &regions_[idx];
     if (r->IsFree()) {
-      r->Unfree(time_);
-      ++num_non_free_regions_;
-      // TODO: this is buggy. Debug it.
-      // r->SetNewlyAllocated();
-      r->SetTop(r->End());
-      r->is_a_tlab_ = true;
-      r->thread_ = self;
-      self->SetTlab(r->Begin(), r->End());
-      return true;
+      // Extend the tlab over following contiguous free regions, as long as the evacuation
+      // reserve holds. The regions are adjacent in memory, so the tlab stays a single
+      // bump-pointer range.
+      size_t num_claimed = 1;
+      while (num_claimed < kTlabRegionsPerRefill &&
+             idx + num_claimed < num_regions_ &&
+             regions_[idx + num_claimed].IsFree() &&
+             (num_non_free_regions_ + num_claimed + 1) * 2 <= num_regions_) {
+        ++num_claimed;
+      }
+      for (size_t j = 0; j < num_claimed; ++j) {
+        Region* claimed = &regions_[idx + j];
+        claimed->Unfree(time_);
+        ++num_non_free_regions_;
+        // TODO: this is buggy. Debug it.
+        // claimed->SetNewlyAllocated();
+        claimed->SetTop(claimed->End());
+        claimed->is_a_tlab_ = true;
+        claimed->thread_ = self;
+      }
+      cyclic_alloc_region_index_ = (idx + num_claimed) % num_regions_;
+      self->SetTlab(r->Begin(), r->Begin() + num_claimed * kRegionSize);
+      return num_claimed * kRegionSize;
     }
   }
-  return false;
+  return 0U;
 }
 
 size_t RegionSpace::RevokeThreadLocalBuffers(Thread* thread) {
@@ -367,13 +394,18 @@ void RegionSpace::RevokeThreadLocalBuffersLocked(Thread* thread) {
   DCHECK_EQ(thread->HasTlab(), tlab_start != nullptr);
   if (tlab_start != nullptr) {
     DCHECK_ALIGNED(tlab_start, kRegionSize);
+    const size_t tlab_bytes = thread->GetThreadLocalBytesAllocated();
+    DCHECK_ALIGNED(tlab_bytes, kRegionSize);
     Region* r = RefToRegionLocked(reinterpret_cast<mirror::Object*>(tlab_start));
-    DCHECK(r->IsAllocated());
-    DCHECK_EQ(thread->GetThreadLocalBytesAllocated(), kRegionSize);
-    r->RecordThreadLocalAllocations(thread->GetThreadLocalObjectsAllocated(),
-                                    thread->GetThreadLocalBytesAllocated());
-    r->is_a_tlab_ = false;
-    r->thread_ = nullptr;
+    // The object count only feeds space-wide statistics, so all of the tlab's objects are
+    // attributed to its first region.
+    r->RecordThreadLocalAllocations(thread->GetThreadLocalObjectsAllocated(), kRegionSize);
+    for (size_t i = 0; i < tlab_bytes / kRegionSize; ++i) {
+      Region* tlab_region = r + i;
+      DCHECK(tlab_region->IsAllocated());
+      tlab_region->is_a_tlab_ = false;
+      tlab_region->thread_ = nullptr;
+    }
   }
   thread->SetTlab(nullptr, nullptr);
 }
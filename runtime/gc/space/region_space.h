@@ -169,6 +169,9 @@ class RegionSpace FINAL : public ContinuousMemMapAllocSpace {
   static constexpr size_t kAlignment = kObjectAlignment;
   // The region size.
   static constexpr size_t kRegionSize = 1 * MB;
+  // Number of contiguous regions a tlab refill tries to claim per region lock acquisition,
+  // halving how often allocating threads come back under the lock.
+  static constexpr size_t kTlabRegionsPerRefill = 2;
 
   bool IsInFromSpace(mirror::Object* ref) {
     if (HasAddress(ref)) {
@@ -202,7 +205,16 @@ class RegionSpace FINAL : public ContinuousMemMapAllocSpace {
     return RegionType::kRegionTypeNone;
   }
 
-  void SetFromSpace(accounting::ReadBarrierTable* rb_table, bool force_evacuate_all)
+  // Evacuation policy for SetFromSpace(). A young collection evacuates only the regions
+  // allocated since the last collection cycle, a normal collection additionally evacuates
+  // mostly-dead regions by live percent, and a forced collection evacuates everything.
+  enum class EvacMode {
+    kEvacModeNewlyAllocated,
+    kEvacModeLivePercentNewlyAllocated,
+    kEvacModeForceAll,
+  };
+
+  void SetFromSpace(accounting::ReadBarrierTable* rb_table, EvacMode evac_mode)
       REQUIRES(!region_lock_);
 
   size_t FromSpaceSize() REQUIRES(!region_lock_);
@@ -218,7 +230,9 @@ class RegionSpace FINAL : public ContinuousMemMapAllocSpace {
   void AssertAllRegionLiveBytesZeroOrCleared() REQUIRES(!region_lock_);
 
   void RecordAlloc(mirror::Object* ref) REQUIRES(!region_lock_);
-  bool AllocNewTlab(Thread* self) REQUIRES(!region_lock_);
+  // Allocates a new tlab of up to kTlabRegionsPerRefill contiguous regions. Returns the
+  // number of bytes claimed, or 0 on failure.
+  size_t AllocNewTlab(Thread* self) REQUIRES(!region_lock_);
 
   uint32_t Time() {
     return time_;
@@ -372,7 +386,7 @@ class RegionSpace FINAL : public ContinuousMemMapAllocSpace {
       type_ = RegionType::kRegionTypeToSpace;
     }
 
-    ALWAYS_INLINE bool ShouldBeEvacuated();
+    ALWAYS_INLINE bool ShouldBeEvacuated(EvacMode evac_mode);
 
     void AddLiveBytes(size_t live_bytes) {
       DCHECK(IsInUnevacFromSpace());
@@ -513,6 +527,9 @@ class RegionSpace FINAL : public ContinuousMemMapAllocSpace {
   uint32_t time_;                  // The time as the number of collections since the startup.
   size_t num_regions_;             // The number of regions in this space.
   size_t num_non_free_regions_;    // The number of non-free regions in this space.
+  // Index where the free-region searches resume, one past the most recently claimed region.
+  // Keeps region claims O(1) amortized instead of rescanning the non-free prefix every time.
+  size_t cyclic_alloc_region_index_ GUARDED_BY(region_lock_);
   std::unique_ptr<Region[]> regions_ GUARDED_BY(region_lock_);
                                    // The pointer to the region array.
   Region* current_region_;         // The region that's being allocated currently.
@@ -48,7 +48,7 @@ RosAllocSpace::RosAllocSpace(MemMap* mem_map, size_t initial_size, const std::st
                              size_t starting_size, bool low_memory_mode)
     : MallocSpace(name, mem_map, begin, end, limit, growth_limit, true, can_move_objects,
                   starting_size, initial_size),
-      rosalloc_(rosalloc), low_memory_mode_(low_memory_mode) {
+      rosalloc_(rosalloc), low_memory_mode_(low_memory_mode), trim_page_cursor_(0) {
   CHECK(rosalloc != nullptr);
 }
 
@@ -258,6 +258,23 @@ size_t RosAllocSpace::Trim() {
   return 0;
 }
 
+bool RosAllocSpace::TrimSlice(uint64_t deadline_ns, size_t* reclaimed) {
+  if (trim_page_cursor_ == 0) {
+    // First slice: shrink the footprint at the end of the space, which is cheap.
+    Thread* const self = Thread::Current();
+    // SOA required for Rosalloc::Trim() -> ArtRosAllocMoreCore() -> Heap::GetRosAllocSpace.
+    ScopedObjectAccess soa(self);
+    MutexLock mu(self, lock_);
+    rosalloc_->Trim();
+  }
+  if (!rosalloc_->DoesReleaseAllPages()) {
+    *reclaimed = rosalloc_->ReleasePages(deadline_ns, &trim_page_cursor_);
+    return trim_page_cursor_ == 0;
+  }
+  *reclaimed = 0;
+  return true;
+}
+
 void RosAllocSpace::Walk(void(*callback)(void *start, void *end, size_t num_bytes, void* callback_arg),
                          void* arg) {
   InspectAllRosAlloc(callback, arg, true);
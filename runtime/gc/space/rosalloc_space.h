@@ -104,6 +104,10 @@ class RosAllocSpace : public MallocSpace {
   }
 
   size_t Trim() OVERRIDE;
+  // Incremental variant of Trim(): releases empty pages until NanoTime() passes deadline_ns,
+  // resuming where the previous slice stopped. Stores the bytes released by this slice in
+  // *reclaimed and returns true once the whole space has been walked.
+  bool TrimSlice(uint64_t deadline_ns, size_t* reclaimed);
   void Walk(WalkCallback callback, void* arg) OVERRIDE REQUIRES(!lock_);
   size_t GetFootprint() OVERRIDE;
   size_t GetFootprintLimit() OVERRIDE;
@@ -179,6 +183,10 @@ class RosAllocSpace : public MallocSpace {
 
   const bool low_memory_mode_;
 
+  // Page map index at which the next TrimSlice() call resumes releasing pages. Zero when no
+  // incremental trim is in progress.
+  size_t trim_page_cursor_;
+
   friend class collector::MarkSweep;
 
   DISALLOW_COPY_AND_ASSIGN(RosAllocSpace);
@@ -16,6 +16,9 @@
 
 #include "zygote_space.h"
 
+#include <errno.h>
+#include <sys/mman.h>
+
 #include "gc/accounting/card_table-inl.h"
 #include "gc/accounting/space_bitmap-inl.h"
 #include "gc/heap.h"
@@ -26,6 +29,11 @@ namespace art {
 namespace gc {
 namespace space {
 
+// Mark the zygote space as mergeable so that a kernel running KSM can re-share identical
+// pages between forked children after copy-on-write has made them private-dirty. Has no
+// effect (and no cost) when KSM is disabled or unavailable.
+static constexpr bool kMadviseMergeableZygoteSpace = true;
+
 class CountObjectsAllocated {
  public:
   explicit CountObjectsAllocated(size_t* objects_allocated)
@@ -54,6 +62,14 @@ ZygoteSpace* ZygoteSpace::Create(const std::string& name, MemMap* mem_map,
   CHECK(zygote_space->mark_bitmap_.get() == nullptr);
   zygote_space->live_bitmap_.reset(live_bitmap);
   zygote_space->mark_bitmap_.reset(mark_bitmap);
+#ifdef MADV_MERGEABLE
+  if (kMadviseMergeableZygoteSpace) {
+    // EINVAL just means the kernel was built without CONFIG_KSM, which is not worth a warning.
+    if (madvise(mem_map->Begin(), mem_map->Size(), MADV_MERGEABLE) == -1 && errno != EINVAL) {
+      PLOG(WARNING) << "madvise(MADV_MERGEABLE) failed for zygote space";
+    }
+  }
+#endif
   return zygote_space;
 }
 
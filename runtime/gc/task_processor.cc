@@ -52,12 +52,24 @@ HeapTask* TaskProcessor::GetTask(Thread* self) {
     } else {
       // Non empty queue, look at the top element and see if we are ready to run it.
       const uint64_t current_time = NanoTime();
-      HeapTask* task = *tasks_.begin();
       // If we are shutting down, return the task right away without waiting. Otherwise return the
       // task if it is late enough.
-      uint64_t target_time = task->GetTargetRunTime();
+      const uint64_t target_time = (*tasks_.begin())->GetTargetRunTime();
       if (!is_running_ || target_time <= current_time) {
-        tasks_.erase(tasks_.begin());
+        auto best = tasks_.begin();
+        if (is_running_) {
+          // Several tasks may be due at once; run them in priority order rather than queue
+          // order so that hygiene work such as a trim never delays a pause-critical
+          // concurrent GC start. The queue is small, so scanning the due prefix is cheap.
+          auto it = best;
+          for (++it; it != tasks_.end() && (*it)->GetTargetRunTime() <= current_time; ++it) {
+            if ((*it)->GetPriority() < (*best)->GetPriority()) {
+              best = it;
+            }
+          }
+        }
+        HeapTask* const task = *best;
+        tasks_.erase(best);
         return task;
       }
       DCHECK_GT(target_time, current_time);
@@ -27,13 +27,27 @@
 namespace art {
 namespace gc {
 
+// Scheduling lanes for heap tasks. When several tasks are due at the same time, lower
+// values run first, so hygiene work such as a trim can never delay a pause-critical
+// concurrent GC start.
+enum HeapTaskPriority {
+  kHeapTaskPriorityPauseCritical = 0,  // Work that prevents mutator stalls.
+  kHeapTaskPriorityConcurrent = 1,     // Ordinary background work.
+  kHeapTaskPriorityHygiene = 2,        // Footprint hygiene such as heap trims.
+};
+
 class HeapTask : public SelfDeletingTask {
  public:
-  explicit HeapTask(uint64_t target_run_time) : target_run_time_(target_run_time) {
+  explicit HeapTask(uint64_t target_run_time,
+                    HeapTaskPriority priority = kHeapTaskPriorityConcurrent)
+      : target_run_time_(target_run_time), priority_(priority) {
   }
   uint64_t GetTargetRunTime() const {
     return target_run_time_;
   }
+  HeapTaskPriority GetPriority() const {
+    return priority_;
+  }
 
  private:
   // Update the updated_target_run_time_, the task processor will re-insert the task when it is
@@ -44,6 +58,8 @@ class HeapTask : public SelfDeletingTask {
 
   // Time in ns at which we want the task to run.
   uint64_t target_run_time_;
+  // Lane the task runs in when it is due at the same time as other tasks.
+  const HeapTaskPriority priority_;
 
   friend class TaskProcessor;
   DISALLOW_IMPLICIT_CONSTRUCTORS(HeapTask);
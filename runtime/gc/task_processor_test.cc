@@ -144,5 +144,34 @@ TEST_F(TaskProcessorTest, Ordering) {
   ASSERT_EQ(counter, kNumTasks);
 }
 
+class PriorityTask : public HeapTask {
+ public:
+  PriorityTask(uint64_t target_time, HeapTaskPriority priority)
+      : HeapTask(target_time, priority) {
+  }
+  virtual void Run(Thread* thread ATTRIBUTE_UNUSED) OVERRIDE {
+  }
+};
+
+TEST_F(TaskProcessorTest, DueTasksRunInPriorityOrder) {
+  Thread* const self = Thread::Current();
+  TaskProcessor task_processor;
+  task_processor.Start(self);
+  const uint64_t now = NanoTime();
+  // The hygiene task is queued first and due earlier, but since both tasks are due, the
+  // pause-critical task must be returned first.
+  HeapTask* hygiene = new PriorityTask(now - MsToNs(2), kHeapTaskPriorityHygiene);
+  HeapTask* pause_critical = new PriorityTask(now - MsToNs(1), kHeapTaskPriorityPauseCritical);
+  task_processor.AddTask(self, hygiene);
+  task_processor.AddTask(self, pause_critical);
+  HeapTask* first = task_processor.GetTask(self);
+  EXPECT_EQ(first, pause_critical);
+  HeapTask* second = task_processor.GetTask(self);
+  EXPECT_EQ(second, hygiene);
+  first->Finalize();
+  second->Finalize();
+  task_processor.Stop(self);
+}
+
 }  // namespace gc
 }  // namespace art
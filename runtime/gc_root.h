@@ -247,6 +247,9 @@ class BufferedRootVisitor {
     if (UNLIKELY(buffer_pos_ >= kBufferSize)) {
       Flush();
     }
+    // Prefetch the referenced object; it is not touched until the visitor
+    // processes the batch in Flush, up to a buffer length from now.
+    __builtin_prefetch(root->AsMirrorPtr());
     roots_[buffer_pos_++] = root;
   }
 
@@ -34,8 +34,9 @@ inline StackHandleScope<kNumReferences>::StackHandleScope(Thread* self, mirror::
     Locks::mutator_lock_->AssertSharedHeld(Thread::Current());
   }
   static_assert(kNumReferences >= 1, "StackHandleScope must contain at least 1 reference");
-  // TODO: Figure out how to use a compile assert.
-  CHECK_EQ(&storage_[0], GetReferences());
+  // The layout invariant is structural; checking it in every scope construction of release
+  // builds is wasted work. TODO: Figure out how to use a compile assert.
+  DCHECK_EQ(&storage_[0], GetReferences());
   for (size_t i = 0; i < kNumReferences; ++i) {
     SetReference(i, fill_value);
   }
@@ -125,6 +126,49 @@ inline void StackHandleScope<kNumReferences>::SetReference(size_t i, mirror::Obj
   GetReferences()[i].Assign(object);
 }
 
+inline StackHandleScopeCollection::~StackHandleScopeCollection() {
+  while (!scopes_.empty()) {
+    HandleScope* const scope = scopes_.top();
+    HandleScope* const top_handle_scope = self_->PopHandleScope();
+    DCHECK_EQ(top_handle_scope, scope);
+    scopes_.pop();
+    // The chunk was allocated as a uint8_t array and HandleScope is trivially destructible.
+    delete[] reinterpret_cast<uint8_t*>(scope);
+  }
+}
+
+inline void StackHandleScopeCollection::Reserve(size_t num_refs) {
+  if (RemainingInCurrentScope() < num_refs) {
+    PushScope(num_refs);
+  }
+}
+
+template<class T>
+inline MutableHandle<T> StackHandleScopeCollection::NewHandle(T* object) {
+  if (UNLIKELY(RemainingInCurrentScope() == 0u)) {
+    PushScope(/* min_num_refs */ 1u);
+  }
+  VerifyObject(object);
+  HandleScope* const scope = scopes_.top();
+  const size_t pos = current_scope_num_refs_++;
+  scope->SetReference(pos, object);
+  return MutableHandle<T>(scope->GetMutableHandle(pos));
+}
+
+inline void StackHandleScopeCollection::PushScope(size_t min_num_refs) {
+  const size_t num_refs = std::max(min_num_refs, next_scope_num_refs_);
+  // Avoid std::min, it odr-uses the constant.
+  if (next_scope_num_refs_ < kMaxScopeNumRefs) {
+    next_scope_num_refs_ *= 2u;
+  }
+  // Value-initialized so all the references start out null, the GC visits the whole chunk.
+  uint8_t* const storage = new uint8_t[HandleScope::SizeOf(num_refs)]();
+  HandleScope* const scope = HandleScope::Create(storage, self_->GetTopHandleScope(), num_refs);
+  self_->PushHandleScope(scope);
+  scopes_.push(scope);
+  current_scope_num_refs_ = 0;
+}
+
 }  // namespace art
 
 #endif  // ART_RUNTIME_HANDLE_SCOPE_INL_H_
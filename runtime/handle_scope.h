@@ -17,6 +17,7 @@
 #ifndef ART_RUNTIME_HANDLE_SCOPE_H_
 #define ART_RUNTIME_HANDLE_SCOPE_H_
 
+#include <algorithm>
 #include <stack>
 
 #include "base/logging.h"
@@ -182,11 +183,10 @@ class PACKED(4) StackHandleScope FINAL : public HandleScope {
   template<size_t kNumRefs> friend class StackHandleScope;
 };
 
-// Utility class to manage a collection (stack) of StackHandleScope. All the managed
-// scope handle have the same fixed sized.
-// Calls to NewHandle will create a new handle inside the top StackHandleScope.
-// When the handle scope becomes full a new one is created and push on top of the
-// previous.
+// Utility class to manage a collection (stack) of handle scopes without a compile time bound on
+// the number of handles. Handles are carved out of heap allocated chunks whose size doubles as
+// the collection grows, so handle-hungry users end up with a few large chunks that the GC visits
+// as contiguous ranges instead of a long chain of small scopes.
 //
 // NB:
 // - it is not safe to use the *same* StackHandleScopeCollection intermix with
@@ -197,35 +197,39 @@ class StackHandleScopeCollection {
  public:
   explicit StackHandleScopeCollection(Thread* const self) :
       self_(self),
-      current_scope_num_refs_(0) {
+      current_scope_num_refs_(0),
+      next_scope_num_refs_(kInitialScopeNumRefs) {
   }
 
-  ~StackHandleScopeCollection() {
-    while (!scopes_.empty()) {
-      delete scopes_.top();
-      scopes_.pop();
-    }
-  }
+  ALWAYS_INLINE ~StackHandleScopeCollection();
+
+  // Bulk-reserve storage for at least num_refs handles in a single chunk, so that the upcoming
+  // NewHandle calls allocate nothing and yield one contiguous range of references.
+  ALWAYS_INLINE void Reserve(size_t num_refs);
 
   template<class T>
-  MutableHandle<T> NewHandle(T* object) SHARED_REQUIRES(Locks::mutator_lock_) {
-    if (scopes_.empty() || current_scope_num_refs_ >= kNumReferencesPerScope) {
-      StackHandleScope<kNumReferencesPerScope>* scope =
-          new StackHandleScope<kNumReferencesPerScope>(self_);
-      scopes_.push(scope);
-      current_scope_num_refs_ = 0;
-    }
-    current_scope_num_refs_++;
-    return scopes_.top()->NewHandle(object);
-  }
+  ALWAYS_INLINE MutableHandle<T> NewHandle(T* object) SHARED_REQUIRES(Locks::mutator_lock_);
 
  private:
-  static constexpr size_t kNumReferencesPerScope = 4;
+  // The first chunk is small since most users only create a few handles. Subsequent chunks
+  // double in size up to the cap.
+  static constexpr size_t kInitialScopeNumRefs = 4;
+  static constexpr size_t kMaxScopeNumRefs = 256;
+
+  size_t RemainingInCurrentScope() const {
+    return scopes_.empty() ? 0u : scopes_.top()->NumberOfReferences() - current_scope_num_refs_;
+  }
+
+  ALWAYS_INLINE void PushScope(size_t min_num_refs);
 
   Thread* const self_;
 
-  std::stack<StackHandleScope<kNumReferencesPerScope>*> scopes_;
+  // Chunks in creation order, the top one is the only one handles are carved from.
+  std::stack<HandleScope*> scopes_;
+  // Number of references used in the top chunk.
   size_t current_scope_num_refs_;
+  // Capacity of the next chunk to allocate.
+  size_t next_scope_num_refs_;
 
   DISALLOW_COPY_AND_ASSIGN(StackHandleScopeCollection);
 };
@@ -34,6 +34,7 @@
 #include <time.h>
 #include <time.h>
 #include <unistd.h>
+#include <zlib.h>
 
 #include <set>
 
@@ -61,6 +62,7 @@
 #include "safe_map.h"
 #include "scoped_thread_state_change.h"
 #include "thread_list.h"
+#include "utils.h"
 
 namespace art {
 
@@ -391,6 +393,33 @@ class FileEndianOutput FINAL : public EndianOutputBuffered {
   bool errors_;
 };
 
+// Streams the records through zlib's gzip compressor on their way to a file descriptor. Used
+// when the dump file name ends in ".gz"; analysis tools must decompress the file before use.
+class GzipFileEndianOutput FINAL : public EndianOutputBuffered {
+ public:
+  GzipFileEndianOutput(gzFile gz_file, size_t reserved_size)
+      : EndianOutputBuffered(reserved_size), gz_file_(gz_file), errors_(false) {
+    DCHECK(gz_file != nullptr);
+  }
+  ~GzipFileEndianOutput() {
+  }
+
+  bool Errors() {
+    return errors_;
+  }
+
+ protected:
+  void HandleFlush(const uint8_t* buffer, size_t length) OVERRIDE {
+    if (!errors_ && length != 0u) {
+      errors_ = gzwrite(gz_file_, buffer, length) != static_cast<int>(length);
+    }
+  }
+
+ private:
+  gzFile gz_file_;
+  bool errors_;
+};
+
 class NetStateEndianOutput FINAL : public EndianOutputBuffered {
  public:
   NetStateEndianOutput(JDWP::JdwpNetStateBase* net_state, size_t reserved_size)
@@ -753,26 +782,55 @@ class Hprof : public SingleRootVisitor {
       }
     }
 
-    std::unique_ptr<File> file(new File(out_fd, filename_, true));
     bool okay;
-    {
-      FileEndianOutput file_output(file.get(), max_length);
-      output_ = &file_output;
-      ProcessHeap(true);
-      okay = !file_output.Errors();
+    if (EndsWith(filename_, ".gz")) {
+      // Stream the records through gzip on their way to the file. The level favors speed; the
+      // verbose hprof encoding compresses well even at the lowest setting.
+      gzFile gz_file = gzdopen(out_fd, "wb1");
+      if (gz_file == nullptr) {
+        close(out_fd);
+        ThrowRuntimeException("Couldn't dump heap; gzdopen(\"%s\") failed: %s", filename_.c_str(),
+                              strerror(errno));
+        return false;
+      }
+      {
+        GzipFileEndianOutput gz_output(gz_file, max_length);
+        output_ = &gz_output;
+        ProcessHeap(true);
+        okay = !gz_output.Errors();
+        if (okay) {
+          // Check for expected size; note that the sum is of the uncompressed record bytes.
+          // Output is expected to be less-or-equal than first phase, see b/23521263.
+          DCHECK_LE(gz_output.SumLength(), overall_size);
+        }
+        output_ = nullptr;
+      }
+      // gzclose flushes the compressor and closes out_fd.
+      okay = (gzclose(gz_file) == Z_OK) && okay;
+      if (!okay && fd_ < 0) {
+        unlink(filename_.c_str());
+      }
+    } else {
+      std::unique_ptr<File> file(new File(out_fd, filename_, true));
+      {
+        FileEndianOutput file_output(file.get(), max_length);
+        output_ = &file_output;
+        ProcessHeap(true);
+        okay = !file_output.Errors();
+
+        if (okay) {
+          // Check for expected size. Output is expected to be less-or-equal than first phase, see
+          // b/23521263.
+          DCHECK_LE(file_output.SumLength(), overall_size);
+        }
+        output_ = nullptr;
+      }
 
       if (okay) {
-        // Check for expected size. Output is expected to be less-or-equal than first phase, see
-        // b/23521263.
-        DCHECK_LE(file_output.SumLength(), overall_size);
+        okay = file->FlushCloseOrErase() == 0;
+      } else {
+        file->Erase();
       }
-      output_ = nullptr;
-    }
-
-    if (okay) {
-      okay = file->FlushCloseOrErase() == 0;
-    } else {
-      file->Erase();
     }
     if (!okay) {
       std::string msg(StringPrintf("Couldn't dump heap; writing \"%s\" failed: %s",
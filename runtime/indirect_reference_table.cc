@@ -71,7 +71,8 @@ IndirectReferenceTable::IndirectReferenceTable(size_t initialCount,
                                                size_t maxCount, IndirectRefKind desiredKind,
                                                bool abort_on_error)
     : kind_(desiredKind),
-      max_entries_(maxCount) {
+      max_entries_(maxCount),
+      recent_hole_(kNoRecentHole) {
   CHECK_GT(initialCount, 0U);
   CHECK_LE(initialCount, maxCount);
   CHECK_NE(desiredKind, kHandleScopeOrInvalid);
@@ -126,15 +127,26 @@ IndirectRef IndirectReferenceTable::Add(uint32_t cookie, mirror::Object* obj) {
   size_t index;
   if (numHoles > 0) {
     DCHECK_GT(topIndex, 1U);
-    // Find the first hole; likely to be near the end of the list.
-    IrtEntry* pScan = &table_[topIndex - 1];
-    DCHECK(!pScan->GetReference()->IsNull());
-    --pScan;
-    while (!pScan->GetReference()->IsNull()) {
-      DCHECK_GE(pScan, table_ + prevState.parts.topIndex);
+    if (recent_hole_ != kNoRecentHole &&
+        recent_hole_ >= prevState.parts.topIndex &&
+        recent_hole_ < topIndex &&
+        table_[recent_hole_].GetReference()->IsNull()) {
+      // Reuse the most recently created hole without scanning. Any null entry
+      // between the segment bottom and the top index is a hole of the current
+      // segment, so the range check is all the validation we need.
+      index = recent_hole_;
+      recent_hole_ = kNoRecentHole;
+    } else {
+      // Find the first hole; likely to be near the end of the list.
+      IrtEntry* pScan = &table_[topIndex - 1];
+      DCHECK(!pScan->GetReference()->IsNull());
       --pScan;
+      while (!pScan->GetReference()->IsNull()) {
+        DCHECK_GE(pScan, table_ + prevState.parts.topIndex);
+        --pScan;
+      }
+      index = pScan - table_;
     }
-    index = pScan - table_;
     segment_state_.parts.numHoles--;
   } else {
     // Add to the end.
@@ -253,6 +265,7 @@ bool IndirectReferenceTable::Remove(uint32_t cookie, IndirectRef iref) {
 
     *table_[idx].GetReference() = GcRoot<mirror::Object>(nullptr);
     segment_state_.parts.numHoles++;
+    recent_hole_ = idx;
     if ((false)) {
       LOG(INFO) << "+++ left hole at " << idx << ", holes=" << segment_state_.parts.numHoles;
     }
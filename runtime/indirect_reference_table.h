@@ -391,6 +391,16 @@ class IndirectReferenceTable {
   const IndirectRefKind kind_;
   /* max #of entries allowed */
   const size_t max_entries_;
+
+  // Sentinel for recent_hole_ when no hole hint is available.
+  static constexpr uint32_t kNoRecentHole = 0xffffffffu;
+
+  // Index of the most recently created hole, or kNoRecentHole. Only a hint:
+  // Add() validates it against the current segment before use, so stale values
+  // left behind by segment pushes and pops are rejected rather than kept in
+  // sync. Makes the common JNI delete-then-add pattern constant time instead
+  // of scanning down from the top of the segment for a free slot.
+  uint32_t recent_hole_;
 };
 
 }  // namespace art
@@ -135,6 +135,9 @@ void Instrumentation::InstallStubsForMethod(ArtMethod* method) {
       new_quick_code = class_linker->GetQuickOatCodeFor(method);
       if (NeedDebugVersionForBootImageCode(method, new_quick_code)) {
         new_quick_code = GetQuickToInterpreterBridge();
+      } else if (IsMethodInstrumented(method)) {
+        // The method keeps its individually installed entry/exit stub.
+        new_quick_code = GetQuickInstrumentationEntryPoint();
       }
     } else {
       new_quick_code = GetQuickResolutionStub();
@@ -153,7 +156,7 @@ void Instrumentation::InstallStubsForMethod(ArtMethod* method) {
           // Oat code should not be used. Don't install instrumentation stub and
           // use interpreter for instrumentation.
           new_quick_code = GetQuickToInterpreterBridge();
-        } else if (entry_exit_stubs_installed_) {
+        } else if (entry_exit_stubs_installed_ || IsMethodInstrumented(method)) {
           new_quick_code = GetQuickInstrumentationEntryPoint();
         }
       } else {
@@ -617,7 +620,8 @@ void Instrumentation::ConfigureStubs(const char* key, InstrumentationLevel desir
     bool empty;
     {
       ReaderMutexLock mu(self, deoptimized_methods_lock_);
-      empty = IsDeoptimizedMethodsEmpty();  // Avoid lock violation.
+      // Avoid lock violation.
+      empty = IsDeoptimizedMethodsEmpty() && IsInstrumentedMethodsEmpty();
     }
     if (empty) {
       MutexLock mu(self, *Locks::thread_list_lock_);
@@ -699,7 +703,7 @@ void Instrumentation::UpdateMethodsCodeImpl(ArtMethod* method, const void* quick
       if (class_linker->IsQuickResolutionStub(quick_code) ||
           class_linker->IsQuickToInterpreterBridge(quick_code)) {
         new_quick_code = quick_code;
-      } else if (entry_exit_stubs_installed_) {
+      } else if (entry_exit_stubs_installed_ || IsMethodInstrumented(method)) {
         new_quick_code = GetQuickInstrumentationEntryPoint();
       } else {
         new_quick_code = quick_code;
@@ -756,6 +760,33 @@ bool Instrumentation::IsDeoptimizedMethodsEmpty() const {
   return deoptimized_methods_.empty();
 }
 
+bool Instrumentation::AddInstrumentedMethod(ArtMethod* method) {
+  if (IsInstrumentedMethod(method)) {
+    // Already in the map. Return.
+    return false;
+  }
+  // Not found. Add it.
+  instrumented_methods_.insert(method);
+  return true;
+}
+
+bool Instrumentation::IsInstrumentedMethod(ArtMethod* method) {
+  return instrumented_methods_.find(method) != instrumented_methods_.end();
+}
+
+bool Instrumentation::RemoveInstrumentedMethod(ArtMethod* method) {
+  auto it = instrumented_methods_.find(method);
+  if (it == instrumented_methods_.end()) {
+    return false;
+  }
+  instrumented_methods_.erase(it);
+  return true;
+}
+
+bool Instrumentation::IsInstrumentedMethodsEmpty() const {
+  return instrumented_methods_.empty();
+}
+
 void Instrumentation::Deoptimize(ArtMethod* method) {
   CHECK(!method->IsNative());
   CHECK(!method->IsProxyMethod());
@@ -791,7 +822,7 @@ void Instrumentation::Undeoptimize(ArtMethod* method) {
     bool found_and_erased = RemoveDeoptimizedMethod(method);
     CHECK(found_and_erased) << "Method " << PrettyMethod(method)
         << " is not deoptimized";
-    empty = IsDeoptimizedMethodsEmpty();
+    empty = IsDeoptimizedMethodsEmpty() && IsInstrumentedMethodsEmpty();
   }
 
   // Restore code and possibly stack only if we did not deoptimize everything.
@@ -801,6 +832,9 @@ void Instrumentation::Undeoptimize(ArtMethod* method) {
     if (method->IsStatic() && !method->IsConstructor() &&
         !method->GetDeclaringClass()->IsInitialized()) {
       UpdateEntrypoints(method, GetQuickResolutionStub());
+    } else if (IsMethodInstrumented(method)) {
+      // The method keeps its individually installed entry/exit stub.
+      UpdateEntrypoints(method, GetQuickInstrumentationEntryPoint());
     } else {
       const void* quick_code = class_linker->GetQuickOatCodeFor(method);
       if (NeedDebugVersionForBootImageCode(method, quick_code)) {
@@ -809,7 +843,8 @@ void Instrumentation::Undeoptimize(ArtMethod* method) {
       UpdateEntrypoints(method, quick_code);
     }
 
-    // If there is no deoptimized method left, we can restore the stack of each thread.
+    // If there is no deoptimized or instrumented method left, we can restore the stack of each
+    // thread.
     if (empty) {
       MutexLock mu(self, *Locks::thread_list_lock_);
       Runtime::Current()->GetThreadList()->ForEach(InstrumentationRestoreStack, this);
@@ -824,6 +859,76 @@ bool Instrumentation::IsDeoptimized(ArtMethod* method) {
   return IsDeoptimizedMethod(method);
 }
 
+void Instrumentation::InstrumentMethodEntryExit(ArtMethod* method) {
+  CHECK(!method->IsNative());
+  CHECK(!method->IsProxyMethod());
+  CHECK(method->IsInvokable());
+
+  Thread* self = Thread::Current();
+  {
+    WriterMutexLock mu(self, deoptimized_methods_lock_);
+    bool has_not_been_instrumented = AddInstrumentedMethod(method);
+    CHECK(has_not_been_instrumented) << "Method " << PrettyMethod(method)
+        << " is already instrumented";
+  }
+  if (!interpreter_stubs_installed_) {
+    UpdateEntrypoints(method, GetQuickInstrumentationEntryPoint());
+
+    // Install instrumentation exit stub and instrumentation frames. We may already have installed
+    // these previously so it will only cover the newly created frames.
+    instrumentation_stubs_installed_ = true;
+    MutexLock mu(self, *Locks::thread_list_lock_);
+    Runtime::Current()->GetThreadList()->ForEach(InstrumentationInstallStack, this);
+  }
+}
+
+void Instrumentation::UninstrumentMethodEntryExit(ArtMethod* method) {
+  CHECK(!method->IsNative());
+  CHECK(!method->IsProxyMethod());
+  CHECK(method->IsInvokable());
+
+  Thread* self = Thread::Current();
+  bool empty;
+  {
+    WriterMutexLock mu(self, deoptimized_methods_lock_);
+    bool found_and_erased = RemoveInstrumentedMethod(method);
+    CHECK(found_and_erased) << "Method " << PrettyMethod(method)
+        << " is not instrumented";
+    empty = IsDeoptimizedMethodsEmpty() && IsInstrumentedMethodsEmpty();
+  }
+
+  // Restore code and possibly stack only if the stubs are not installed process-wide.
+  if (!interpreter_stubs_installed_ && !entry_exit_stubs_installed_) {
+    // Restore its code, resolution trampoline or interpreter bridge.
+    ClassLinker* class_linker = Runtime::Current()->GetClassLinker();
+    if (method->IsStatic() && !method->IsConstructor() &&
+        !method->GetDeclaringClass()->IsInitialized()) {
+      UpdateEntrypoints(method, GetQuickResolutionStub());
+    } else if (IsDeoptimized(method)) {
+      UpdateEntrypoints(method, GetQuickToInterpreterBridge());
+    } else {
+      const void* quick_code = class_linker->GetQuickOatCodeFor(method);
+      if (NeedDebugVersionForBootImageCode(method, quick_code)) {
+        quick_code = GetQuickToInterpreterBridge();
+      }
+      UpdateEntrypoints(method, quick_code);
+    }
+
+    // If no method needs the exit stub anymore, we can restore the stack of each thread.
+    if (empty) {
+      MutexLock mu(self, *Locks::thread_list_lock_);
+      Runtime::Current()->GetThreadList()->ForEach(InstrumentationRestoreStack, this);
+      instrumentation_stubs_installed_ = false;
+    }
+  }
+}
+
+bool Instrumentation::IsMethodInstrumented(ArtMethod* method) {
+  DCHECK(method != nullptr);
+  ReaderMutexLock mu(Thread::Current(), deoptimized_methods_lock_);
+  return IsInstrumentedMethod(method);
+}
+
 void Instrumentation::EnableDeoptimization() {
   ReaderMutexLock mu(Thread::Current(), deoptimized_methods_lock_);
   CHECK(IsDeoptimizedMethodsEmpty());
@@ -193,6 +193,21 @@ class Instrumentation {
   bool IsDeoptimized(ArtMethod* method)
       REQUIRES(!deoptimized_methods_lock_) SHARED_REQUIRES(Locks::mutator_lock_);
 
+  // Replace only this method's entrypoint with the instrumentation entry stub so that its entry
+  // and exit dispatch method events while its compiled code stays in place. Selective
+  // alternative to EnableMethodTracing, which installs entry/exit stubs process-wide.
+  void InstrumentMethodEntryExit(ArtMethod* method)
+      REQUIRES(Locks::mutator_lock_, !Locks::thread_list_lock_, !deoptimized_methods_lock_);
+
+  // Restore the compiled entrypoint of a method instrumented with InstrumentMethodEntryExit.
+  void UninstrumentMethodEntryExit(ArtMethod* method)
+      REQUIRES(Locks::mutator_lock_, !Locks::thread_list_lock_, !deoptimized_methods_lock_);
+
+  // Indicates whether the method had its entrypoint individually replaced by the
+  // instrumentation entry stub.
+  bool IsMethodInstrumented(ArtMethod* method)
+      REQUIRES(!deoptimized_methods_lock_) SHARED_REQUIRES(Locks::mutator_lock_);
+
   // Enable method tracing by installing instrumentation entry/exit stubs or interpreter.
   void EnableMethodTracing(const char* key,
                            bool needs_interpreter = kDeoptimizeForAccurateMethodEntryExitListeners)
@@ -497,6 +512,16 @@ class Instrumentation {
       SHARED_REQUIRES(Locks::mutator_lock_, deoptimized_methods_lock_);
   bool IsDeoptimizedMethodsEmpty() const
       SHARED_REQUIRES(Locks::mutator_lock_, deoptimized_methods_lock_);
+
+  // Read barrier-aware utility functions for accessing instrumented_methods_
+  bool AddInstrumentedMethod(ArtMethod* method)
+      SHARED_REQUIRES(Locks::mutator_lock_) REQUIRES(deoptimized_methods_lock_);
+  bool IsInstrumentedMethod(ArtMethod* method)
+      SHARED_REQUIRES(Locks::mutator_lock_, deoptimized_methods_lock_);
+  bool RemoveInstrumentedMethod(ArtMethod* method)
+      SHARED_REQUIRES(Locks::mutator_lock_) REQUIRES(deoptimized_methods_lock_);
+  bool IsInstrumentedMethodsEmpty() const
+      SHARED_REQUIRES(Locks::mutator_lock_, deoptimized_methods_lock_);
   void UpdateMethodsCodeImpl(ArtMethod* method, const void* quick_code)
       SHARED_REQUIRES(Locks::mutator_lock_) REQUIRES(!deoptimized_methods_lock_);
 
@@ -581,6 +606,10 @@ class Instrumentation {
   std::unordered_set<ArtMethod*> deoptimized_methods_ GUARDED_BY(deoptimized_methods_lock_);
   bool deoptimization_enabled_;
 
+  // The set of methods whose entrypoints were individually replaced by the instrumentation
+  // entry stub so that only they dispatch method entry/exit events.
+  std::unordered_set<ArtMethod*> instrumented_methods_ GUARDED_BY(deoptimized_methods_lock_);
+
   // Current interpreter handler table. This is updated each time the thread state flags are
   // modified.
   InterpreterHandlerTable interpreter_handler_table_ GUARDED_BY(Locks::mutator_lock_);
@@ -356,6 +356,16 @@ size_t InternTable::AddTableFromMemoryLocked(const uint8_t* ptr) {
   return strong_interns_.AddTableFromMemory(ptr);
 }
 
+size_t InternTable::AddAppImageTableFromMemory(
+    const uint8_t* ptr, SafeMap<mirror::String*, mirror::String*>* intern_remap) {
+  MutexLock mu(Thread::Current(), *Locks::intern_table_lock_);
+  return strong_interns_.AddAppImageTableFromMemory(ptr, intern_remap);
+}
+
+size_t InternTable::VisitSerializedTable(const uint8_t* ptr, RootVisitor* visitor) {
+  return Table::VisitSerialized(ptr, visitor);
+}
+
 size_t InternTable::WriteToMemory(uint8_t* ptr) {
   MutexLock mu(Thread::Current(), *Locks::intern_table_lock_);
   return strong_interns_.WriteToMemory(ptr);
@@ -373,7 +383,15 @@ bool InternTable::StringHashEquals::operator()(const GcRoot<mirror::String>& a,
   if (kIsDebugBuild) {
     Locks::mutator_lock_->AssertSharedHeld(Thread::Current());
   }
-  return a.Read()->Equals(b.Read());
+  mirror::String* a_string = a.Read();
+  mirror::String* b_string = b.Read();
+  // Candidates in a probe sequence may come from colliding buckets and so have different hashes.
+  // Strings reaching the table have their hash computed and cached by the hash functor, which
+  // makes comparing hashes a cheap way to reject them without touching the character arrays.
+  if (a_string->GetHashCode() != b_string->GetHashCode()) {
+    return false;
+  }
+  return a_string->Equals(b_string);
 }
 
 bool InternTable::StringHashEquals::operator()(const GcRoot<mirror::String>& a,
@@ -382,6 +400,9 @@ bool InternTable::StringHashEquals::operator()(const GcRoot<mirror::String>& a,
     Locks::mutator_lock_->AssertSharedHeld(Thread::Current());
   }
   mirror::String* a_string = a.Read();
+  if (a_string->GetHashCode() != b.GetHash()) {
+    return false;
+  }
   uint32_t a_length = static_cast<uint32_t>(a_string->GetLength());
   if (a_length != b.GetUtf16Length()) {
     return false;
@@ -397,7 +418,7 @@ size_t InternTable::Table::AddTableFromMemory(const uint8_t* ptr) {
     // Avoid inserting empty sets.
     return read_count;
   }
-  // TODO: Disable this for app images if app images have intern tables.
+  // App images go through AddAppImageTableFromMemory, which deduplicates instead of checking.
   static constexpr bool kCheckDuplicates = true;
   if (kCheckDuplicates) {
     for (GcRoot<mirror::String>& string : set) {
@@ -409,6 +430,41 @@ size_t InternTable::Table::AddTableFromMemory(const uint8_t* ptr) {
   return read_count;
 }
 
+size_t InternTable::Table::AddAppImageTableFromMemory(
+    const uint8_t* ptr, SafeMap<mirror::String*, mirror::String*>* intern_remap) {
+  size_t read_count = 0;
+  UnorderedSet set(ptr, /*make copy*/false, &read_count);
+  for (auto it = set.begin(); it != set.end(); ) {
+    mirror::String* string = it->Read();
+    mirror::String* existing = Find(string);
+    if (existing != nullptr) {
+      // The runtime interned an equal string while the image was not loaded, e.g. while loading
+      // classes from another dex file. References in the image must be redirected to the existing
+      // instance so that equal string literals keep pointer identity.
+      intern_remap->Put(string, existing);
+      it = set.Erase(it);
+    } else {
+      ++it;
+    }
+  }
+  if (!set.Empty()) {
+    // Insert at the front since we add new interns into the back.
+    tables_.insert(tables_.begin(), std::move(set));
+  }
+  return read_count;
+}
+
+size_t InternTable::Table::VisitSerialized(const uint8_t* ptr, RootVisitor* visitor) {
+  size_t read_count = 0;
+  UnorderedSet set(ptr, /*make copy*/false, &read_count);
+  BufferedRootVisitor<kDefaultBufferedRootCount> buffered_visitor(
+      visitor, RootInfo(kRootInternedString));
+  for (auto& intern : set) {
+    buffered_visitor.VisitRoot(intern);
+  }
+  return read_count;
+}
+
 size_t InternTable::Table::WriteToMemory(uint8_t* ptr) {
   if (tables_.empty()) {
     return 0;
@@ -26,6 +26,7 @@
 #include "gc_root.h"
 #include "gc/weak_root_state.h"
 #include "object_callbacks.h"
+#include "safe_map.h"
 
 namespace art {
 
@@ -129,6 +130,20 @@ class InternTable {
   size_t AddTableFromMemory(const uint8_t* ptr) REQUIRES(!Locks::intern_table_lock_)
       SHARED_REQUIRES(Locks::mutator_lock_);
 
+  // Merge an app image intern table as an additional strong table so that the strings the image
+  // pre-interned do not need to be interned one at a time. Strings for which the runtime already
+  // interned an equal instance are removed from the merged table and recorded in *intern_remap;
+  // the caller must redirect references in the image to the canonical instance.
+  size_t AddAppImageTableFromMemory(const uint8_t* ptr,
+                                    SafeMap<mirror::String*, mirror::String*>* intern_remap)
+      REQUIRES(!Locks::intern_table_lock_) SHARED_REQUIRES(Locks::mutator_lock_);
+
+  // Visit the roots of an intern table serialized at ptr, updating the serialized memory in
+  // place without reading the referenced strings. Used to relocate an app image intern table
+  // before the strings it references have been fixed up.
+  static size_t VisitSerializedTable(const uint8_t* ptr, RootVisitor* visitor)
+      SHARED_REQUIRES(Locks::mutator_lock_);
+
   // Write the post zygote intern table to a pointer. Only writes the strong interns since it is
   // expected that there is no weak interns since this is called from the image writer.
   size_t WriteToMemory(uint8_t* ptr) SHARED_REQUIRES(Locks::mutator_lock_)
@@ -201,6 +216,14 @@ class InternTable {
     // debug builds. Returns how many bytes were read.
     size_t AddTableFromMemory(const uint8_t* ptr)
         REQUIRES(Locks::intern_table_lock_) SHARED_REQUIRES(Locks::mutator_lock_);
+    // Read and add an app image intern table from ptr, removing strings already present in the
+    // existing tables and recording them in *intern_remap. Returns how many bytes were read.
+    size_t AddAppImageTableFromMemory(const uint8_t* ptr,
+                                      SafeMap<mirror::String*, mirror::String*>* intern_remap)
+        REQUIRES(Locks::intern_table_lock_) SHARED_REQUIRES(Locks::mutator_lock_);
+    // Visit the roots of a table serialized at ptr without reading the referenced strings.
+    static size_t VisitSerialized(const uint8_t* ptr, RootVisitor* visitor)
+        SHARED_REQUIRES(Locks::mutator_lock_);
     // Write the intern tables to ptr, if there are multiple tables they are combined into a single
     // one. Returns how many bytes were written.
     size_t WriteToMemory(uint8_t* ptr)
@@ -208,7 +231,8 @@ class InternTable {
 
    private:
     typedef HashSet<GcRoot<mirror::String>, GcRootEmptyFn, StringHashEquals, StringHashEquals,
-        TrackingAllocator<GcRoot<mirror::String>, kAllocatorTagInternTable>> UnorderedSet;
+        TrackingAllocator<GcRoot<mirror::String>, kAllocatorTagInternTable>,
+        /* kStoreHashTags */ true> UnorderedSet;
 
     void SweepWeaks(UnorderedSet* set, IsMarkedVisitor* visitor)
         SHARED_REQUIRES(Locks::mutator_lock_) REQUIRES(Locks::intern_table_lock_);
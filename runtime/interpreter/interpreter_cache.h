@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_INTERPRETER_INTERPRETER_CACHE_H_
+#define ART_RUNTIME_INTERPRETER_INTERPRETER_CACHE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "atomic.h"
+#include "base/bit_utils.h"
+#include "base/macros.h"
+
+namespace art {
+namespace interpreter {
+
+// Small direct-mapped cache of resolution results for individual dex instructions, used by the
+// switch interpreter to avoid going through the dex cache and the access checks on every executed
+// field access and invoke. Entries are keyed by the address of the instruction, which identifies
+// both the method and the dex pc, so resolution results cached for one call site can never be
+// returned for another.
+//
+// Each thread owns one cache, so lookups and stores need no synchronization and a cached
+// class-initialization state can never leak to a thread that still has to wait for the
+// initializing thread. Entries are validated against a global epoch counter that class unloading
+// bumps; a stale entry whose metadata has been freed then simply misses.
+class InterpreterCache {
+ public:
+  InterpreterCache() : entries_() {}
+
+  // Return true and set *value if the cache holds a valid entry for the given instruction.
+  ALWAYS_INLINE bool Get(const void* key, void** value) {
+    const Entry& entry = entries_[IndexOf(key)];
+    if (LIKELY(entry.key == key && entry.epoch == GlobalEpoch())) {
+      *value = entry.value;
+      return true;
+    }
+    return false;
+  }
+
+  ALWAYS_INLINE void Set(const void* key, void* value) {
+    entries_[IndexOf(key)] = Entry { key, value, GlobalEpoch() };
+  }
+
+  static uint64_t GlobalEpoch() {
+    return global_epoch_.LoadRelaxed();
+  }
+
+  // Invalidate all entries in all threads' caches. Called when class unloading frees metadata
+  // that cached entries may point to. The unloading GC synchronizes with the mutators before any
+  // memory is actually reclaimed, so a relaxed counter is sufficient.
+  static void BumpGlobalEpoch() {
+    global_epoch_.FetchAndAddSequentiallyConsistent(1u);
+  }
+
+ private:
+  static constexpr size_t kSize = 128;
+  static_assert(IsPowerOfTwo(kSize), "Size must be power of two to index by masking");
+
+  struct Entry {
+    const void* key;  // Address of the dex instruction.
+    void* value;      // Resolved ArtField* or ArtMethod*.
+    uint64_t epoch;   // Value of global_epoch_ when the entry was stored.
+  };
+
+  static ALWAYS_INLINE size_t IndexOf(const void* key) {
+    // Dex instructions are 2-byte aligned, drop the always-zero bit before masking.
+    return (reinterpret_cast<uintptr_t>(key) >> 1) & (kSize - 1);
+  }
+
+  Entry entries_[kSize];
+
+  // Bumped by class unloading to invalidate the caches of all threads at once. Never reset, so
+  // with 64 bits an entry from a previous epoch can never alias a current one.
+  static Atomic<uint64_t> global_epoch_;
+
+  DISALLOW_COPY_AND_ASSIGN(InterpreterCache);
+};
+
+}  // namespace interpreter
+}  // namespace art
+
+#endif  // ART_RUNTIME_INTERPRETER_INTERPRETER_CACHE_H_
@@ -40,13 +40,21 @@ template<FindFieldType find_type, Primitive::Type field_type, bool do_access_che
 bool DoFieldGet(Thread* self, ShadowFrame& shadow_frame, const Instruction* inst,
                 uint16_t inst_data) {
   const bool is_static = (find_type == StaticObjectRead) || (find_type == StaticPrimitiveRead);
-  const uint32_t field_idx = is_static ? inst->VRegB_21c() : inst->VRegC_22c();
-  ArtField* f =
-      FindFieldFromCode<find_type, do_access_check>(field_idx, shadow_frame.GetMethod(), self,
-                                                    Primitive::ComponentSize(field_type));
-  if (UNLIKELY(f == nullptr)) {
-    CHECK(self->IsExceptionPending());
-    return false;
+  ArtField* f;
+  // Resolution and the access checks are deterministic per call site, so consult the
+  // per-thread cache before going through the dex cache.
+  void* cached_value;
+  if (LIKELY(self->GetInterpreterCache()->Get(inst, &cached_value))) {
+    f = reinterpret_cast<ArtField*>(cached_value);
+  } else {
+    const uint32_t field_idx = is_static ? inst->VRegB_21c() : inst->VRegC_22c();
+    f = FindFieldFromCode<find_type, do_access_check>(field_idx, shadow_frame.GetMethod(), self,
+                                                      Primitive::ComponentSize(field_type));
+    if (UNLIKELY(f == nullptr)) {
+      CHECK(self->IsExceptionPending());
+      return false;
+    }
+    self->GetInterpreterCache()->Set(inst, f);
   }
   Object* obj;
   if (is_static) {
@@ -235,13 +243,20 @@ bool DoFieldPut(Thread* self, const ShadowFrame& shadow_frame, const Instruction
                 uint16_t inst_data) {
   bool do_assignability_check = do_access_check;
   bool is_static = (find_type == StaticObjectWrite) || (find_type == StaticPrimitiveWrite);
-  uint32_t field_idx = is_static ? inst->VRegB_21c() : inst->VRegC_22c();
-  ArtField* f =
-      FindFieldFromCode<find_type, do_access_check>(field_idx, shadow_frame.GetMethod(), self,
-                                                    Primitive::ComponentSize(field_type));
-  if (UNLIKELY(f == nullptr)) {
-    CHECK(self->IsExceptionPending());
-    return false;
+  ArtField* f;
+  // See DoFieldGet for why the result of the resolution can be cached per call site.
+  void* cached_value;
+  if (LIKELY(self->GetInterpreterCache()->Get(inst, &cached_value))) {
+    f = reinterpret_cast<ArtField*>(cached_value);
+  } else {
+    uint32_t field_idx = is_static ? inst->VRegB_21c() : inst->VRegC_22c();
+    f = FindFieldFromCode<find_type, do_access_check>(field_idx, shadow_frame.GetMethod(), self,
+                                                      Primitive::ComponentSize(field_type));
+    if (UNLIKELY(f == nullptr)) {
+      CHECK(self->IsExceptionPending());
+      return false;
+    }
+    self->GetInterpreterCache()->Set(inst, f);
   }
   Object* obj;
   if (is_static) {
@@ -631,8 +631,27 @@ static inline bool DoInvoke(Thread* self, ShadowFrame& shadow_frame, const Instr
   const uint32_t vregC = (is_range) ? inst->VRegC_3rc() : inst->VRegC_35c();
   Object* receiver = (type == kStatic) ? nullptr : shadow_frame.GetVRegReference(vregC);
   ArtMethod* sf_method = shadow_frame.GetMethod();
-  ArtMethod* const called_method = FindMethodFromCode<type, do_access_check>(
-      method_idx, &receiver, sf_method, self);
+  // The target of a static or direct invoke is the same on every execution, so it can be served
+  // from the per-thread cache. Virtual and interface targets depend on the receiver type and
+  // always resolve through FindMethodFromCode.
+  ArtMethod* called_method;
+  void* cached_value;
+  if ((type == kStatic || type == kDirect) &&
+      LIKELY(self->GetInterpreterCache()->Get(inst, &cached_value))) {
+    if (type != kStatic && UNLIKELY(receiver == nullptr)) {
+      // FindMethodFromCode performs the null check on the slow path, mirror it here.
+      ThrowNullPointerExceptionForMethodAccess(method_idx, type);
+      result->SetJ(0);
+      return false;
+    }
+    called_method = reinterpret_cast<ArtMethod*>(cached_value);
+  } else {
+    called_method = FindMethodFromCode<type, do_access_check>(
+        method_idx, &receiver, sf_method, self);
+    if ((type == kStatic || type == kDirect) && called_method != nullptr) {
+      self->GetInterpreterCache()->Set(inst, called_method);
+    }
+  }
   // The shadow frame should already be pushed, so we don't need to update it.
   if (UNLIKELY(called_method == nullptr)) {
     CHECK(self->IsExceptionPending());
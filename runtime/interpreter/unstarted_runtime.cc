@@ -545,7 +545,8 @@ void UnstartedRuntime::UnstartedVoidLookupType(
 }
 
 // Arraycopy emulation.
-// Note: we can't use any fast copy functions, as they are not available under transaction.
+// Note: once the original contents of the destination range are recorded in the
+// transaction log, the copy itself can use the fast raw functions.
 
 template <typename T>
 static void PrimitiveArrayCopy(Thread* self,
@@ -561,16 +562,16 @@ static void PrimitiveArrayCopy(Thread* self,
   }
   mirror::PrimitiveArray<T>* src = down_cast<mirror::PrimitiveArray<T>*>(src_array);
   mirror::PrimitiveArray<T>* dst = down_cast<mirror::PrimitiveArray<T>*>(dst_array);
-  const bool copy_forward = (dst_pos < src_pos) || (dst_pos - src_pos >= length);
-  if (copy_forward) {
-    for (int32_t i = 0; i < length; ++i) {
-      dst->Set(dst_pos + i, src->Get(src_pos + i));
-    }
-  } else {
-    for (int32_t i = 1; i <= length; ++i) {
-      dst->Set(dst_pos + length - i, src->Get(src_pos + length - i));
-    }
-  }
+  Runtime* runtime = Runtime::Current();
+  if (runtime->IsActiveTransaction()) {
+    // Record the destination range in one pass instead of logging element by
+    // element: the string tables of large <clinit>s copy thousands of elements
+    // and each individual RecordWriteArray call takes the transaction log lock.
+    runtime->RecordWriteArrayRange(dst, dst_pos, length);
+  }
+  // The original contents are recorded above when needed, so a raw copy is
+  // transaction safe; Memmove also handles overlapping ranges.
+  dst->Memmove(dst_pos, src, src_pos, length);
 }
 
 void UnstartedRuntime::UnstartedSystemArraycopy(
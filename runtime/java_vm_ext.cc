@@ -27,6 +27,7 @@
 #include "dex_file-inl.h"
 #include "fault_handler.h"
 #include "indirect_reference_table-inl.h"
+#include "jni_env_ext.h"
 #include "mirror/class-inl.h"
 #include "mirror/class_loader.h"
 #include "nativebridge/native_bridge.h"
@@ -425,6 +426,8 @@ JavaVMExt::JavaVMExt(Runtime* runtime, const RuntimeArgumentMap& runtime_options
       check_jni_abort_hook_(nullptr),
       check_jni_abort_hook_data_(nullptr),
       check_jni_(false),  // Initialized properly in the constructor body below.
+      check_jni_sample_interval_(
+          runtime_options.GetOrDefault(RuntimeArgumentMap::CheckJniSampleInterval)),
       force_copy_(runtime_options.Exists(RuntimeArgumentMap::JniOptsForceCopy)),
       tracing_enabled_(runtime_options.Exists(RuntimeArgumentMap::JniTrace)
                        || VLOG_IS_ON(third_party_jni)),
@@ -436,12 +439,53 @@ JavaVMExt::JavaVMExt(Runtime* runtime, const RuntimeArgumentMap& runtime_options
       weak_globals_lock_("JNI weak global reference table lock", kJniWeakGlobalsLock),
       weak_globals_(kWeakGlobalsInitial, kWeakGlobalsMax, kWeakGlobal),
       allow_accessing_weak_globals_(true),
-      weak_globals_add_condition_("weak globals add condition", weak_globals_lock_) {
+      weak_globals_add_condition_("weak globals add condition", weak_globals_lock_),
+      env_pool_lock_("JNIEnvExt pool lock") {
   functions = unchecked_functions_;
   SetCheckJniEnabled(runtime_options.Exists(RuntimeArgumentMap::CheckJni));
 }
 
 JavaVMExt::~JavaVMExt() {
+  MutexLock mu(Thread::Current(), env_pool_lock_);
+  STLDeleteElements(&env_pool_);
+}
+
+// Upper bound on the number of recycled environments kept around. Attaches beyond the pool
+// size fall back to a fresh allocation, so this only needs to cover the expected number of
+// concurrently detached-and-soon-reattached threads.
+static constexpr size_t kMaxPooledEnvs = 16;
+
+JNIEnvExt* JavaVMExt::AcquireEnv(Thread* self, Thread* thread) {
+  {
+    MutexLock mu(self, env_pool_lock_);
+    if (!env_pool_.empty()) {
+      JNIEnvExt* env = env_pool_.back();
+      env_pool_.pop_back();
+      env->Reset(thread);
+      return env;
+    }
+  }
+  return JNIEnvExt::Create(thread, this);
+}
+
+void JavaVMExt::ReleaseEnv(JNIEnvExt* env) {
+  DCHECK(env != nullptr);
+  DCHECK_EQ(env->vm, this);
+  // Only recycle environments left in a pristine state. Leftover critical sections, local
+  // reference frames or JNI monitors indicate misbehaving native code (and a runtime that
+  // has been deleted underneath a daemon thread cannot be pooled at all); tearing the
+  // environment down is the safe choice there.
+  if (!env->runtime_deleted &&
+      env->critical == 0 &&
+      env->stacked_local_ref_cookies.empty() &&
+      env->monitors.Size() == 0u) {
+    MutexLock mu(Thread::Current(), env_pool_lock_);
+    if (env_pool_.size() < kMaxPooledEnvs) {
+      env_pool_.push_back(env);
+      return;
+    }
+  }
+  delete env;
 }
 
 void JavaVMExt::JniAbort(const char* jni_function_name, const char* msg) {
@@ -17,6 +17,8 @@
 #ifndef ART_RUNTIME_JAVA_VM_EXT_H_
 #define ART_RUNTIME_JAVA_VM_EXT_H_
 
+#include <vector>
+
 #include "jni.h"
 
 #include "base/macros.h"
@@ -31,6 +33,7 @@ namespace mirror {
 }  // namespace mirror
 
 class ArtMethod;
+struct JNIEnvExt;
 class Libraries;
 class ParsedOptions;
 class Runtime;
@@ -49,6 +52,12 @@ class JavaVMExt : public JavaVM {
     return check_jni_;
   }
 
+  // With -Xcheck:jni:sample:N only every Nth JNI call on a given JNIEnv goes
+  // through the thorough argument checks; 0 means every call is checked.
+  unsigned int GetCheckJniSampleInterval() const {
+    return check_jni_sample_interval_;
+  }
+
   bool IsTracingEnabled() const {
     return tracing_enabled_;
   }
@@ -171,6 +180,16 @@ class JavaVMExt : public JavaVM {
   void TrimGlobals() SHARED_REQUIRES(Locks::mutator_lock_)
       REQUIRES(!globals_lock_);
 
+  // Takes a recycled environment from the pool, re-targeted at `thread`, or creates a fresh
+  // one. Recycling keeps the indirect reference table mapping of a detached thread alive,
+  // which removes most of the JNIEnvExt setup cost from thread attach. `self` is the calling
+  // thread, which creates the environment of a child thread before starting it.
+  JNIEnvExt* AcquireEnv(Thread* self, Thread* thread) REQUIRES(!env_pool_lock_);
+
+  // Returns `env` to the pool on thread detach, or deletes it if it is not in a recyclable
+  // state or the pool is full. The caller must not use `env` afterwards.
+  void ReleaseEnv(JNIEnvExt* env) REQUIRES(!env_pool_lock_);
+
  private:
   // Return true if self can currently access weak globals.
   bool MayAccessWeakGlobalsUnlocked(Thread* self) const SHARED_REQUIRES(Locks::mutator_lock_);
@@ -186,6 +205,7 @@ class JavaVMExt : public JavaVM {
 
   // Extra checking.
   bool check_jni_;
+  const unsigned int check_jni_sample_interval_;
   bool force_copy_;
   const bool tracing_enabled_;
 
@@ -215,6 +235,10 @@ class JavaVMExt : public JavaVM {
   Atomic<bool> allow_accessing_weak_globals_;
   ConditionVariable weak_globals_add_condition_ GUARDED_BY(weak_globals_lock_);
 
+  // JNIEnvExt instances of detached threads, kept for reuse by the next attach.
+  Mutex env_pool_lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
+  std::vector<JNIEnvExt*> env_pool_ GUARDED_BY(env_pool_lock_);
+
   DISALLOW_COPY_AND_ASSIGN(JavaVMExt);
 };
 
@@ -111,7 +111,15 @@ JDWP::ObjectId ObjectRegistry::InternalAdd(Handle<T> obj_h) {
     entry->reference_count = 1;
     entry->id = next_id_++;
 
-    id_to_entry_.Put(entry->id, entry);
+    const size_t index = static_cast<size_t>(entry->id - 1);
+    const size_t page = index / kIdsPerPage;
+    if (page >= id_to_entry_pages_.size()) {
+      id_to_entry_pages_.resize(page + 1);
+    }
+    if (id_to_entry_pages_[page] == nullptr) {
+      id_to_entry_pages_[page].reset(new ObjectRegistryEntry*[kIdsPerPage]());
+    }
+    id_to_entry_pages_[page][index % kIdsPerPage] = entry;
 
     env->DeleteLocalRef(local_reference);
   }
@@ -134,6 +142,18 @@ bool ObjectRegistry::ContainsLocked(Thread* self, mirror::Object* o, int32_t ide
   return false;
 }
 
+ObjectRegistryEntry** ObjectRegistry::SlotForId(JDWP::ObjectId id) {
+  if (id == 0 || id >= next_id_) {
+    return nullptr;
+  }
+  const size_t index = static_cast<size_t>(id - 1);
+  const size_t page = index / kIdsPerPage;
+  if (page >= id_to_entry_pages_.size() || id_to_entry_pages_[page] == nullptr) {
+    return nullptr;
+  }
+  return &id_to_entry_pages_[page][index % kIdsPerPage];
+}
+
 void ObjectRegistry::Clear() {
   Thread* const self = Thread::Current();
 
@@ -162,22 +182,22 @@ void ObjectRegistry::Clear() {
     }
     delete entry;
   }
-  // Clear the maps.
+  // Clear the maps. Note ids stay monotonic across a Clear(); SlotForId() treats ids from
+  // the discarded pages as invalid.
   object_to_entry_.clear();
-  id_to_entry_.clear();
+  id_to_entry_pages_.clear();
 }
 
 mirror::Object* ObjectRegistry::InternalGet(JDWP::ObjectId id, JDWP::JdwpError* error) {
   Thread* self = Thread::Current();
   MutexLock mu(self, lock_);
-  auto it = id_to_entry_.find(id);
-  if (it == id_to_entry_.end()) {
+  ObjectRegistryEntry** slot = SlotForId(id);
+  if (slot == nullptr || *slot == nullptr) {
     *error = JDWP::ERR_INVALID_OBJECT;
     return nullptr;
   }
-  ObjectRegistryEntry& entry = *it->second;
   *error = JDWP::ERR_NONE;
-  return self->DecodeJObject(entry.jni_reference);
+  return self->DecodeJObject((*slot)->jni_reference);
 }
 
 jobject ObjectRegistry::GetJObject(JDWP::ObjectId id) {
@@ -186,26 +206,25 @@ jobject ObjectRegistry::GetJObject(JDWP::ObjectId id) {
   }
   Thread* self = Thread::Current();
   MutexLock mu(self, lock_);
-  auto it = id_to_entry_.find(id);
-  CHECK(it != id_to_entry_.end()) << id;
-  ObjectRegistryEntry& entry = *it->second;
-  return entry.jni_reference;
+  ObjectRegistryEntry** slot = SlotForId(id);
+  CHECK(slot != nullptr && *slot != nullptr) << id;
+  return (*slot)->jni_reference;
 }
 
 void ObjectRegistry::DisableCollection(JDWP::ObjectId id) {
   Thread* self = Thread::Current();
   MutexLock mu(self, lock_);
-  auto it = id_to_entry_.find(id);
-  CHECK(it != id_to_entry_.end());
-  Promote(*it->second);
+  ObjectRegistryEntry** slot = SlotForId(id);
+  CHECK(slot != nullptr && *slot != nullptr) << id;
+  Promote(**slot);
 }
 
 void ObjectRegistry::EnableCollection(JDWP::ObjectId id) {
   Thread* self = Thread::Current();
   MutexLock mu(self, lock_);
-  auto it = id_to_entry_.find(id);
-  CHECK(it != id_to_entry_.end());
-  Demote(*it->second);
+  ObjectRegistryEntry** slot = SlotForId(id);
+  CHECK(slot != nullptr && *slot != nullptr) << id;
+  Demote(**slot);
 }
 
 void ObjectRegistry::Demote(ObjectRegistryEntry& entry) {
@@ -233,9 +252,9 @@ void ObjectRegistry::Promote(ObjectRegistryEntry& entry) {
 bool ObjectRegistry::IsCollected(JDWP::ObjectId id) {
   Thread* self = Thread::Current();
   MutexLock mu(self, lock_);
-  auto it = id_to_entry_.find(id);
-  CHECK(it != id_to_entry_.end());
-  ObjectRegistryEntry& entry = *it->second;
+  ObjectRegistryEntry** slot = SlotForId(id);
+  CHECK(slot != nullptr && *slot != nullptr) << id;
+  ObjectRegistryEntry& entry = **slot;
   if (entry.jni_reference_type == JNIWeakGlobalRefType) {
     JNIEnv* env = self->GetJniEnv();
     return env->IsSameObject(entry.jni_reference, nullptr);  // Has the jweak been collected?
@@ -247,11 +266,11 @@ bool ObjectRegistry::IsCollected(JDWP::ObjectId id) {
 void ObjectRegistry::DisposeObject(JDWP::ObjectId id, uint32_t reference_count) {
   Thread* self = Thread::Current();
   MutexLock mu(self, lock_);
-  auto it = id_to_entry_.find(id);
-  if (it == id_to_entry_.end()) {
+  ObjectRegistryEntry** slot = SlotForId(id);
+  if (slot == nullptr || *slot == nullptr) {
     return;
   }
-  ObjectRegistryEntry* entry = it->second;
+  ObjectRegistryEntry* entry = *slot;
   entry->reference_count -= reference_count;
   if (entry->reference_count <= 0) {
     JNIEnv* env = self->GetJniEnv();
@@ -270,7 +289,7 @@ void ObjectRegistry::DisposeObject(JDWP::ObjectId id, uint32_t reference_count)
     } else {
       env->DeleteGlobalRef(entry->jni_reference);
     }
-    id_to_entry_.erase(id);
+    *slot = nullptr;
     delete entry;
   }
 }
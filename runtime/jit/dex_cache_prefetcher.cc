@@ -0,0 +1,202 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "dex_cache_prefetcher.h"
+
+#include "art_method-inl.h"
+#include "base/casts.h"
+#include "base/systrace.h"
+#include "base/time_utils.h"
+#include "class_linker.h"
+#include "dex_file-inl.h"
+#include "dex_instruction-inl.h"
+#include "handle_scope-inl.h"
+#include "jit/offline_profiling_info.h"
+#include "method_reference.h"
+#include "mirror/class-inl.h"
+#include "mirror/class_loader.h"
+#include "mirror/dex_cache-inl.h"
+#include "os.h"
+#include "runtime.h"
+#include "scoped_thread_state_change.h"
+#include "thread.h"
+#include "utils.h"
+
+namespace art {
+
+void DexCachePrefetcher::Prefetch(const std::string& profile_filename) {
+  ScopedTrace trace(__PRETTY_FUNCTION__);
+  const uint64_t start_time = NanoTime();
+
+  ProfileCompilationInfo info;
+  {
+    std::unique_ptr<File> profile_file(OS::OpenFileForReading(profile_filename.c_str()));
+    if (profile_file.get() == nullptr) {
+      VLOG(profiler) << "No profile to prefetch dex caches from: " << profile_filename;
+      return;
+    }
+    if (!info.Load(profile_file->Fd())) {
+      VLOG(profiler) << "Could not load profile file for dex cache prefetch: "
+                     << profile_filename;
+      return;
+    }
+  }
+  if (info.GetNumberOfMethods() == 0) {
+    return;
+  }
+
+  Thread* const self = Thread::Current();
+  ClassLinker* const class_linker = Runtime::Current()->GetClassLinker();
+  ScopedObjectAccess soa(self);
+
+  // Collect the loaded dex files. Resolution cannot run under the dex lock, so the pointers are
+  // re-validated against the dex cache list before each dex file is processed.
+  std::vector<const DexFile*> dex_files;
+  {
+    ReaderMutexLock mu(self, *class_linker->DexLock());
+    for (const ClassLinker::DexCacheData& data : class_linker->GetDexCachesData()) {
+      dex_files.push_back(data.dex_file);
+    }
+  }
+
+  for (const DexFile* dex_file : dex_files) {
+    StackHandleScope<2> hs(self);
+    MutableHandle<mirror::DexCache> dex_cache(hs.NewHandle<mirror::DexCache>(nullptr));
+    MutableHandle<mirror::ClassLoader> class_loader(hs.NewHandle<mirror::ClassLoader>(nullptr));
+    {
+      // The dex file may have been unloaded since the list was collected; only a match in the
+      // current dex cache list makes the pointer safe to dereference.
+      ReaderMutexLock mu(self, *class_linker->DexLock());
+      for (const ClassLinker::DexCacheData& data : class_linker->GetDexCachesData()) {
+        if (data.dex_file == dex_file) {
+          dex_cache.Assign(class_linker->FindDexCacheLocked(self, *dex_file, true));
+          break;
+        }
+      }
+    }
+    if (dex_cache.Get() == nullptr) {
+      continue;
+    }
+    // The profile stores no class loader. Recover the defining loader from a class of this dex
+    // file which the app has already loaded; holding it in a handle also keeps the dex file
+    // alive. If no class was loaded yet there is nothing worth prefetching here either.
+    bool found_loader = false;
+    for (size_t i = 0, num_types = dex_cache->NumResolvedTypes(); i < num_types; ++i) {
+      mirror::Class* klass = dex_cache->GetResolvedType(i);
+      if (klass != nullptr && klass->GetDexCache() == dex_cache.Get()) {
+        class_loader.Assign(klass->GetClassLoader());
+        found_loader = true;
+        break;
+      }
+    }
+    if (!found_loader) {
+      continue;
+    }
+    PrefetchDexFile(self, class_linker, *dex_file, info, dex_cache, class_loader);
+  }
+
+  VLOG(profiler) << "Dex cache prefetch for " << profile_filename << " took "
+                 << PrettyDuration(NanoTime() - start_time);
+}
+
+void DexCachePrefetcher::PrefetchDexFile(Thread* self,
+                                         ClassLinker* class_linker,
+                                         const DexFile& dex_file,
+                                         const ProfileCompilationInfo& info,
+                                         Handle<mirror::DexCache> dex_cache,
+                                         Handle<mirror::ClassLoader> class_loader) {
+  // The profile exposes only a membership test, so probe all of the dex file's method ids. The
+  // probe is two set lookups and is cheap next to the resolution work done for the hits.
+  const size_t num_method_ids = dex_file.NumMethodIds();
+  for (size_t method_idx = 0; method_idx < num_method_ids; ++method_idx) {
+    if (!info.ContainsMethod(MethodReference(&dex_file, method_idx))) {
+      continue;
+    }
+    ArtMethod* method = class_linker->ResolveMethodWithoutInvokeType(dex_file,
+                                                                     method_idx,
+                                                                     dex_cache,
+                                                                     class_loader);
+    if (method == nullptr) {
+      self->ClearException();
+      continue;
+    }
+    const DexFile::CodeItem* code_item = method->GetCodeItem();
+    if (code_item != nullptr) {
+      PrefetchCodeItem(self, class_linker, dex_file, *code_item, dex_cache, class_loader);
+    }
+  }
+}
+
+void DexCachePrefetcher::PrefetchCodeItem(Thread* self,
+                                          ClassLinker* class_linker,
+                                          const DexFile& dex_file,
+                                          const DexFile::CodeItem& code_item,
+                                          Handle<mirror::DexCache> dex_cache,
+                                          Handle<mirror::ClassLoader> class_loader) {
+  const uint16_t* insns = code_item.insns_;
+  for (uint32_t dex_pc = 0; dex_pc < code_item.insns_size_in_code_units_; ) {
+    const Instruction* inst = Instruction::At(insns + dex_pc);
+    const Instruction::Code opcode = inst->Opcode();
+    uint32_t index = DexFile::kDexNoIndex;
+    switch (Instruction::FormatOf(opcode)) {
+      case Instruction::k21c: index = inst->VRegB_21c(); break;
+      case Instruction::k22c: index = inst->VRegC_22c(); break;
+      case Instruction::k31c: index = inst->VRegB_31c(); break;
+      case Instruction::k35c: index = inst->VRegB_35c(); break;
+      case Instruction::k3rc: index = inst->VRegB_3rc(); break;
+      default: break;
+    }
+    if (index != DexFile::kDexNoIndex) {
+      switch (Instruction::IndexTypeOf(opcode)) {
+        case Instruction::kIndexStringRef:
+          if (class_linker->ResolveString(dex_file, index, dex_cache) == nullptr) {
+            self->ClearException();
+          }
+          break;
+        case Instruction::kIndexTypeRef:
+          if (class_linker->ResolveType(dex_file,
+                                        dchecked_integral_cast<uint16_t>(index),
+                                        dex_cache,
+                                        class_loader) == nullptr) {
+            self->ClearException();
+          }
+          break;
+        case Instruction::kIndexFieldRef: {
+          // Static field accesses use format 21c, instance field accesses format 22c.
+          const bool is_static = Instruction::FormatOf(opcode) == Instruction::k21c;
+          if (class_linker->ResolveField(dex_file, index, dex_cache, class_loader, is_static) ==
+              nullptr) {
+            self->ClearException();
+          }
+          break;
+        }
+        case Instruction::kIndexMethodRef:
+          if (class_linker->ResolveMethodWithoutInvokeType(dex_file,
+                                                           index,
+                                                           dex_cache,
+                                                           class_loader) == nullptr) {
+            self->ClearException();
+          }
+          break;
+        default:
+          break;
+      }
+    }
+    dex_pc += inst->SizeInCodeUnits();
+  }
+}
+
+}  // namespace art
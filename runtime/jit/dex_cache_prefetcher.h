@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_JIT_DEX_CACHE_PREFETCHER_H_
+#define ART_RUNTIME_JIT_DEX_CACHE_PREFETCHER_H_
+
+#include <string>
+
+#include "base/macros.h"
+#include "base/mutex.h"
+#include "dex_file.h"
+#include "handle.h"
+
+namespace art {
+
+class ClassLinker;
+class ProfileCompilationInfo;
+
+namespace mirror {
+class ClassLoader;
+class DexCache;
+}  // namespace mirror
+
+// Pre-resolves the dex cache entries referenced by the hot startup methods recorded in a
+// profile. Runs on the profile saver thread shortly after an app starts so that profiled
+// startup code does not pay a resolution trampoline round-trip for every first use of a
+// string, type, field or method.
+class DexCachePrefetcher {
+ public:
+  // Loads the profile at the given location and resolves the references of every recorded
+  // method whose dex file is already loaded. Failures (missing profile, not yet loaded dex
+  // files, unresolvable references) are silently ignored; the prefetch is purely a warm-up.
+  static void Prefetch(const std::string& profile_filename)
+      REQUIRES(!Locks::mutator_lock_);
+
+ private:
+  static void PrefetchDexFile(Thread* self,
+                              ClassLinker* class_linker,
+                              const DexFile& dex_file,
+                              const ProfileCompilationInfo& info,
+                              Handle<mirror::DexCache> dex_cache,
+                              Handle<mirror::ClassLoader> class_loader)
+      SHARED_REQUIRES(Locks::mutator_lock_);
+
+  static void PrefetchCodeItem(Thread* self,
+                               ClassLinker* class_linker,
+                               const DexFile& dex_file,
+                               const DexFile::CodeItem& code_item,
+                               Handle<mirror::DexCache> dex_cache,
+                               Handle<mirror::ClassLoader> class_loader)
+      SHARED_REQUIRES(Locks::mutator_lock_);
+
+  DISALLOW_IMPLICIT_CONSTRUCTORS(DexCachePrefetcher);
+};
+
+}  // namespace art
+
+#endif  // ART_RUNTIME_JIT_DEX_CACHE_PREFETCHER_H_
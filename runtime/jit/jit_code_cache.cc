@@ -110,6 +110,11 @@ JitCodeCache* JitCodeCache::Create(size_t initial_capacity,
   data_size = initial_capacity / 2;
   code_size = initial_capacity - data_size;
   DCHECK_EQ(code_size + data_size, initial_capacity);
+  // Ask for transparent huge page backing to relieve iTLB/dTLB pressure on hot compiled code.
+  // Best effort: the advice has no effect on the ashmem-backed configuration, and the kernel
+  // keeps normal pages where it cannot collapse the range.
+  data_map->MadviseHugePages();
+  code_map->MadviseHugePages();
   return new JitCodeCache(
       code_map, data_map, code_size, data_size, max_capacity, garbage_collect_code);
 }
@@ -343,10 +348,13 @@ uint8_t* JitCodeCache::CommitCodeInternal(Thread* self,
           code_size);
     }
 
-    FlushInstructionCache(reinterpret_cast<char*>(code_ptr),
-                          reinterpret_cast<char*>(code_ptr + code_size));
     number_of_compilations_++;
   }
+  // Flush the instruction cache outside of the lock: flushing only reads the new
+  // code, which no other committing thread can touch, and may issue a syscall
+  // that would otherwise lengthen the critical section for all of them.
+  FlushInstructionCache(reinterpret_cast<char*>(code_ptr),
+                        reinterpret_cast<char*>(code_ptr + code_size));
   // We need to update the entry point in the runnable state for the instrumentation.
   {
     MutexLock mu(self, lock_);
@@ -635,6 +635,51 @@ std::string ProfileCompilationInfo::DumpInfo(const std::vector<const DexFile*>*
   return os.str();
 }
 
+std::string ProfileCompilationInfo::DumpNewMethods(
+    const ProfileCompilationInfo& reference,
+    const std::vector<const DexFile*>* dex_files) const {
+  std::ostringstream os;
+  uint32_t number_of_new_methods = 0;
+
+  for (const auto& it : info_) {
+    const std::string& location = it.first;
+    const DexFileData& dex_data = it.second;
+    // A reference line only filters our methods if it describes the same dex file.
+    const std::set<uint16_t>* reference_methods = nullptr;
+    auto reference_it = reference.info_.find(location);
+    if ((reference_it != reference.info_.end()) &&
+        (reference_it->second.checksum == dex_data.checksum)) {
+      reference_methods = &reference_it->second.method_set;
+    }
+    const DexFile* dex_file = nullptr;
+    if (dex_files != nullptr) {
+      for (size_t i = 0; i < dex_files->size(); i++) {
+        if (location == (*dex_files)[i]->GetLocation()) {
+          dex_file = (*dex_files)[i];
+        }
+      }
+    }
+    bool printed_location = false;
+    for (const auto method_it : dex_data.method_set) {
+      if ((reference_methods != nullptr) &&
+          (reference_methods->find(method_it) != reference_methods->end())) {
+        continue;
+      }
+      if (!printed_location) {
+        os << "\n" << location << "\n\tmethods: ";
+        printed_location = true;
+      }
+      if (dex_file != nullptr) {
+        os << "\n\t\t" << PrettyMethod(method_it, *dex_file, true);
+      } else {
+        os << method_it << ",";
+      }
+      number_of_new_methods++;
+    }
+  }
+  return "NewMethods: " + std::to_string(number_of_new_methods) + os.str();
+}
+
 bool ProfileCompilationInfo::Equals(const ProfileCompilationInfo& other) {
   return info_.Equals(other.info_);
 }
@@ -75,6 +75,15 @@ class ProfileCompilationInfo {
   std::string DumpInfo(const std::vector<const DexFile*>* dex_files,
                        bool print_full_dex_location = true) const;
 
+  // Dumps the methods present in the current profile but absent from the
+  // reference profile into a string and returns it. The format matches
+  // DumpInfo. Dex files whose checksum does not match the reference are
+  // treated as entirely new.
+  // This is intended for diffing two generations of a profile, e.g. to see
+  // which methods became hot since the last compilation.
+  std::string DumpNewMethods(const ProfileCompilationInfo& reference,
+                             const std::vector<const DexFile*>* dex_files) const;
+
   bool Equals(const ProfileCompilationInfo& other);
 
   static std::string GetProfileDexFileKey(const std::string& dex_location);
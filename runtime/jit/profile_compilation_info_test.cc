@@ -193,6 +193,30 @@ TEST_F(ProfileCompilationInfoTest, MergeFail) {
   ASSERT_FALSE(info1.MergeWith(info2));
 }
 
+TEST_F(ProfileCompilationInfoTest, DumpNewMethods) {
+  ProfileCompilationInfo current_info;
+  ProfileCompilationInfo reference_info;
+  for (uint16_t i = 0; i < 10; i++) {
+    ASSERT_TRUE(AddMethod("dex_location1", /* checksum */ 1, /* method_idx */ i, &current_info));
+  }
+  for (uint16_t i = 0; i < 5; i++) {
+    ASSERT_TRUE(AddMethod("dex_location1", /* checksum */ 1, /* method_idx */ i, &reference_info));
+  }
+
+  // Only the methods the reference profile has not seen count as new.
+  ASSERT_EQ("NewMethods: 5\ndex_location1\n\tmethods: 5,6,7,8,9,",
+            current_info.DumpNewMethods(reference_info, nullptr));
+
+  // Identical profiles have no new methods.
+  ASSERT_EQ("NewMethods: 0", reference_info.DumpNewMethods(reference_info, nullptr));
+
+  // A dex file with a mismatched checksum is entirely new.
+  ProfileCompilationInfo mismatched_info;
+  ASSERT_TRUE(AddMethod("dex_location1", /* checksum */ 2, /* method_idx */ 0, &mismatched_info));
+  ASSERT_EQ("NewMethods: 1\ndex_location1\n\tmethods: 0,",
+            mismatched_info.DumpNewMethods(reference_info, nullptr));
+}
+
 TEST_F(ProfileCompilationInfoTest, SaveMaxMethods) {
   ScratchFile profile;
 
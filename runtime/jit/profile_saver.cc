@@ -24,8 +24,10 @@
 #include "base/systrace.h"
 #include "base/time_utils.h"
 #include "compiler_filter.h"
+#include "jit/dex_cache_prefetcher.h"
 #include "oat_file_manager.h"
 #include "scoped_thread_state_change.h"
+#include "verifier/verification_cache.h"
 
 
 namespace art {
@@ -47,6 +49,7 @@ static constexpr const uint32_t kMaximumNumberOfNotificationBeforeWake = 50;
 
 ProfileSaver* ProfileSaver::instance_ = nullptr;
 pthread_t ProfileSaver::profiler_pthread_ = 0U;
+Atomic<uint32_t> ProfileSaver::jit_activity_notifications_(0);
 
 ProfileSaver::ProfileSaver(const std::string& output_filename,
                            jit::JitCodeCache* jit_code_cache,
@@ -59,7 +62,6 @@ ProfileSaver::ProfileSaver(const std::string& output_filename,
       last_save_number_of_methods_(0),
       last_save_number_of_classes_(0),
       last_time_ns_saver_woke_up_(0),
-      jit_activity_notifications_(0),
       wait_lock_("ProfileSaver wait lock"),
       period_condition_("ProfileSaver period condition", wait_lock_),
       total_bytes_written_(0),
@@ -99,6 +101,22 @@ void ProfileSaver::Run() {
   }
   FetchAndCacheResolvedClassesAndMethods();
 
+  // By now the app's class loaders are active, so warm the dex caches with the references of
+  // the hot methods recorded by previous runs. This saves the startup code path the resolution
+  // trampoline round-trips it would otherwise take on every first use.
+  {
+    std::vector<std::string> profile_filenames;
+    {
+      MutexLock mu(self, *Locks::profiler_lock_);
+      for (const auto& it : tracked_dex_base_locations_) {
+        profile_filenames.push_back(it.first);
+      }
+    }
+    for (const std::string& profile_filename : profile_filenames) {
+      DexCachePrefetcher::Prefetch(profile_filename);
+    }
+  }
+
   // Loop for the profiled methods.
   while (!ShuttingDown(self)) {
     uint64_t sleep_start = NanoTime();
@@ -139,49 +157,58 @@ void ProfileSaver::Run() {
     uint16_t new_methods = 0;
     uint64_t start_work = NanoTime();
     bool profile_saved_to_disk = ProcessProfilingInfo(&new_methods);
+    // Piggy-back on the save period to persist new verification results.
+    verifier::VerificationCache::SaveIfDirty();
     // Update the notification counter based on result. Note that there might be contention on this
     // but we don't care about to be 100% precise.
     if (!profile_saved_to_disk) {
       // If we didn't save to disk it may be because we didn't have enough new methods.
       // Set the jit activity notifications to new_methods so we can wake up earlier if needed.
-      jit_activity_notifications_ = new_methods;
+      jit_activity_notifications_.StoreRelaxed(new_methods);
     }
     total_ns_of_work_ += NanoTime() - start_work;
   }
+  // Do a final save on shutdown so that verification results from this session are not lost.
+  verifier::VerificationCache::SaveIfDirty();
 }
 
 void ProfileSaver::NotifyJitActivity() {
+  // Unlikely to overflow but if it happens,
+  // we would have waken up the saver long before that.
+  uint32_t notifications = jit_activity_notifications_.FetchAndAddRelaxed(1) + 1;
+  if (notifications <= kMinimumNumberOfNotificationBeforeWake) {
+    // Common case: not enough activity to consider waking up the saver. Stay
+    // lock free so that notifying threads do not contend on the profiler lock.
+    return;
+  }
   MutexLock mu(Thread::Current(), *Locks::profiler_lock_);
   if (instance_ == nullptr || instance_->shutting_down_) {
     return;
   }
-  instance_->NotifyJitActivityInternal();
+  instance_->NotifyJitActivityInternal(notifications);
 }
 
 void ProfileSaver::WakeUpSaver() {
-  jit_activity_notifications_ = 0;
+  jit_activity_notifications_.StoreRelaxed(0);
   last_time_ns_saver_woke_up_ = NanoTime();
   period_condition_.Signal(Thread::Current());
 }
 
-void ProfileSaver::NotifyJitActivityInternal() {
-  // Unlikely to overflow but if it happens,
-  // we would have waken up the saver long before that.
-  jit_activity_notifications_++;
+void ProfileSaver::NotifyJitActivityInternal(uint32_t notifications) {
   // Note that we are not as precise as we could be here but we don't want to wake the saver
   // every time we see a hot method.
-  if (jit_activity_notifications_ > kMinimumNumberOfNotificationBeforeWake) {
-    MutexLock wait_mutex(Thread::Current(), wait_lock_);
-    if ((NanoTime() - last_time_ns_saver_woke_up_) > kMinSavePeriodNs) {
-      WakeUpSaver();
-    }
-  } else if (jit_activity_notifications_ > kMaximumNumberOfNotificationBeforeWake) {
+  if (notifications > kMaximumNumberOfNotificationBeforeWake) {
     // Make sure to wake up the saver if we see a spike in the number of notifications.
     // This is a precaution to avoid "loosing" a big number of methods in case
     // this is a spike with no jit after.
     total_number_of_hot_spikes_++;
     MutexLock wait_mutex(Thread::Current(), wait_lock_);
     WakeUpSaver();
+  } else {
+    MutexLock wait_mutex(Thread::Current(), wait_lock_);
+    if ((NanoTime() - last_time_ns_saver_woke_up_) > kMinSavePeriodNs) {
+      WakeUpSaver();
+    }
   }
 }
 
@@ -406,6 +433,11 @@ void ProfileSaver::Start(const std::string& output_filename,
     return;
   }
 
+  // The verification cache lives alongside the profile. Started here (not under the profiler
+  // lock) since loading it reads from disk.
+  verifier::VerificationCache::Start(
+      output_filename + verifier::VerificationCache::kFileSuffix);
+
   MutexLock mu(Thread::Current(), *Locks::profiler_lock_);
   if (instance_ != nullptr) {
     // If we already have an instance, make sure it uses the same jit_code_cache.
@@ -17,6 +17,7 @@
 #ifndef ART_RUNTIME_JIT_PROFILE_SAVER_H_
 #define ART_RUNTIME_JIT_PROFILE_SAVER_H_
 
+#include "atomic.h"
 #include "base/mutex.h"
 #include "jit_code_cache.h"
 #include "offline_profiling_info.h"
@@ -80,7 +81,7 @@ class ProfileSaver {
     REQUIRES(!Locks::profiler_lock_)
     REQUIRES(!Locks::mutator_lock_);
 
-  void NotifyJitActivityInternal() REQUIRES(!wait_lock_);
+  void NotifyJitActivityInternal(uint32_t notifications) REQUIRES(!wait_lock_);
   void WakeUpSaver() REQUIRES(wait_lock_);
 
   // Returns true if the saver is shutting down (ProfileSaver::Stop() has been called).
@@ -111,6 +112,10 @@ class ProfileSaver {
   static ProfileSaver* instance_ GUARDED_BY(Locks::profiler_lock_);
   // Profile saver thread.
   static pthread_t profiler_pthread_ GUARDED_BY(Locks::profiler_lock_);
+  // The number of jit activity notifications since the saver last woke up.
+  // Static and atomic so that notifying threads stay lock free; they only
+  // take the locks when enough notifications accumulated to consider a wake up.
+  static Atomic<uint32_t> jit_activity_notifications_;
 
   jit::JitCodeCache* jit_code_cache_;
 
@@ -130,7 +135,6 @@ class ProfileSaver {
   uint32_t last_save_number_of_methods_;
   uint32_t last_save_number_of_classes_;
   uint64_t last_time_ns_saver_woke_up_ GUARDED_BY(wait_lock_);
-  uint32_t jit_activity_notifications_;
 
   // A local cache for the profile information. Maps each tracked file to its
   // profile information. The size of this cache is usually very small and tops
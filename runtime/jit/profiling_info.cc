@@ -80,7 +80,12 @@ void ProfilingInfo::AddInvokeInfo(uint32_t dex_pc, mirror::Class* cls) {
   for (size_t i = 0; i < InlineCache::kIndividualCacheSize; ++i) {
     mirror::Class* existing = cache->classes_[i].Read();
     if (existing == cls) {
-      // Receiver type is already in the cache, nothing else to do.
+      // Receiver type is already in the cache, count the hit. The counter is
+      // intentionally not atomic: lost updates are acceptable for a heuristic.
+      uint16_t hit_count = cache->hit_counts_[i];
+      if (hit_count != std::numeric_limits<uint16_t>::max()) {
+        cache->hit_counts_[i] = hit_count + 1u;
+      }
       return;
     } else if (existing == nullptr) {
       // Cache entry is empty, try to put `cls` in it.
@@ -93,6 +98,7 @@ void ProfilingInfo::AddInvokeInfo(uint32_t dex_pc, mirror::Class* cls) {
         --i;
       } else {
         // We successfully set `cls`, just return.
+        cache->hit_counts_[i] = 1u;
         return;
       }
     }
@@ -73,11 +73,19 @@ class InlineCache {
     return classes_[i].Read();
   }
 
+  // Returns how many times the receiver type in slot `i` has been seen. The
+  // counts are racy and saturating; they are only a heuristic for the compiler
+  // to identify the dominant receivers of a call site.
+  uint16_t GetHitCountAt(size_t i) const {
+    return hit_counts_[i];
+  }
+
   static constexpr uint16_t kIndividualCacheSize = 5;
 
  private:
   uint32_t dex_pc_;
   GcRoot<mirror::Class> classes_[kIndividualCacheSize];
+  uint16_t hit_counts_[kIndividualCacheSize];
 
   friend class ProfilingInfo;
 
@@ -147,6 +155,11 @@ class ProfilingInfo {
       memset(&cache->classes_[0],
              0,
              InlineCache::kIndividualCacheSize * sizeof(GcRoot<mirror::Class>));
+      // Restart the hit counts along with the types, so that stale receivers
+      // do not dominate the counts forever.
+      memset(&cache->hit_counts_[0],
+             0,
+             InlineCache::kIndividualCacheSize * sizeof(uint16_t));
     }
   }
 
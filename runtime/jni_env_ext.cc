@@ -59,6 +59,7 @@ JNIEnvExt::JNIEnvExt(Thread* self_in, JavaVMExt* vm_in)
       local_ref_cookie(IRT_FIRST_SEGMENT),
       locals(kLocalsInitial, kLocalsMax, kLocal, false),
       check_jni(false),
+      check_jni_sample_countdown(1u),
       runtime_deleted(false),
       critical(0),
       monitors("monitors", kMonitorsInitial, kMonitorsMax) {
@@ -111,6 +112,19 @@ void JNIEnvExt::PopFrame() {
   stacked_local_ref_cookies.pop_back();
 }
 
+void JNIEnvExt::Reset(Thread* new_self) {
+  DCHECK_EQ(critical, 0);
+  DCHECK(stacked_local_ref_cookies.empty());
+  self = new_self;
+  local_ref_cookie = IRT_FIRST_SEGMENT;
+  // Truncating the segment state makes any stale entries from the previous thread
+  // unreachable; their memory stays mapped, which is the point of recycling.
+  locals.SetSegmentState(IRT_FIRST_SEGMENT);
+  check_jni_sample_countdown = 1u;
+  // The CheckJNI setting may have been toggled while this environment sat in the pool.
+  SetCheckJniEnabled(vm->IsCheckJniEnabled());
+}
+
 // Note: the offset code is brittle, as we can't use OFFSETOF_MEMBER or offsetof easily. Thus, there
 //       are tests in jni_internal_test to match the results against the actual values.
 
@@ -46,6 +46,12 @@ struct JNIEnvExt : public JNIEnv {
   void PushFrame(int capacity) SHARED_REQUIRES(Locks::mutator_lock_);
   void PopFrame() SHARED_REQUIRES(Locks::mutator_lock_);
 
+  // Restores the pristine state a freshly attached thread expects and re-targets the
+  // environment at `new_self`. Only called when this environment is recycled through the
+  // JavaVMExt environment pool; it is not reachable by any other thread at that point, so
+  // the nominally mutator-lock-guarded locals can be reset without holding the lock.
+  void Reset(Thread* new_self) NO_THREAD_SAFETY_ANALYSIS;
+
   template<typename T>
   T AddLocalReference(mirror::Object* obj)
       SHARED_REQUIRES(Locks::mutator_lock_);
@@ -57,7 +63,9 @@ struct JNIEnvExt : public JNIEnv {
   jobject NewLocalRef(mirror::Object* obj) SHARED_REQUIRES(Locks::mutator_lock_);
   void DeleteLocalRef(jobject obj) SHARED_REQUIRES(Locks::mutator_lock_);
 
-  Thread* const self;
+  // The thread using this environment. Rebound by Reset() when the environment is recycled
+  // for a new thread.
+  Thread* self;
   JavaVMExt* const vm;
 
   // Cookie used when using the local indirect reference table.
@@ -74,6 +82,10 @@ struct JNIEnvExt : public JNIEnv {
   // Frequently-accessed fields cached from JavaVM.
   bool check_jni;
 
+  // Countdown until the next fully checked call when CheckJNI sampling is
+  // enabled; starts at 1 so the first call on every thread is checked.
+  uint32_t check_jni_sample_countdown;
+
   // If we are a JNI env for a daemon thread with a deleted runtime.
   bool runtime_deleted;
 
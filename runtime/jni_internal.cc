@@ -2981,6 +2981,58 @@ void RegisterNativeMethods(JNIEnv* env, const char* jni_class_name, const JNINat
   JNI::RegisterNativeMethods(env, c.get(), methods, method_count, false);
 }
 
+extern "C" jint ArtResolveMethodIds(JNIEnv* env,
+                                    jclass java_class,
+                                    const char* const* names,
+                                    const char* const* signatures,
+                                    const jboolean* is_static,
+                                    jint count,
+                                    jmethodID* method_ids) {
+  if (env == nullptr || java_class == nullptr || names == nullptr || signatures == nullptr ||
+      is_static == nullptr || method_ids == nullptr || count < 0) {
+    return -1;
+  }
+  ScopedObjectAccess soa(env);
+  for (jint i = 0; i != count; ++i) {
+    if (names[i] == nullptr || signatures[i] == nullptr) {
+      return -1;
+    }
+    jmethodID id = FindMethodID(soa, java_class, names[i], signatures[i],
+                                is_static[i] != JNI_FALSE);
+    if (id == nullptr) {
+      return i;
+    }
+    method_ids[i] = id;
+  }
+  return count;
+}
+
+extern "C" jint ArtResolveFieldIds(JNIEnv* env,
+                                   jclass java_class,
+                                   const char* const* names,
+                                   const char* const* signatures,
+                                   const jboolean* is_static,
+                                   jint count,
+                                   jfieldID* field_ids) {
+  if (env == nullptr || java_class == nullptr || names == nullptr || signatures == nullptr ||
+      is_static == nullptr || field_ids == nullptr || count < 0) {
+    return -1;
+  }
+  ScopedObjectAccess soa(env);
+  for (jint i = 0; i != count; ++i) {
+    if (names[i] == nullptr || signatures[i] == nullptr) {
+      return -1;
+    }
+    jfieldID id = FindFieldID(soa, java_class, names[i], signatures[i],
+                              is_static[i] != JNI_FALSE);
+    if (id == nullptr) {
+      return i;
+    }
+    field_ids[i] = id;
+  }
+  return count;
+}
+
 }  // namespace art
 
 std::ostream& operator<<(std::ostream& os, const jobjectRefType& rhs) {
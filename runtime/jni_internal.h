@@ -46,6 +46,29 @@ void RegisterNativeMethods(JNIEnv* env, const char* jni_class_name, const JNINat
 
 int ThrowNewException(JNIEnv* env, jclass exception_class, const char* msg, jobject cause);
 
+// Nonstandard extensions for native code that resolves large ID tables at
+// library load time, meant to be looked up with dlsym() rather than exposed
+// through the JNIEnv function table. They resolve `count` member IDs on
+// `java_class` with a single JNI transition and a single class initialization
+// check instead of one per ID. They return the number of IDs resolved; if it
+// is less than `count`, a NoSuchMethodError (respectively NoSuchFieldError)
+// describing the first failing entry is pending and the remaining output
+// entries are unchanged. They return -1 on invalid arguments.
+extern "C" jint ArtResolveMethodIds(JNIEnv* env,
+                                    jclass java_class,
+                                    const char* const* names,
+                                    const char* const* signatures,
+                                    const jboolean* is_static,
+                                    jint count,
+                                    jmethodID* method_ids);
+extern "C" jint ArtResolveFieldIds(JNIEnv* env,
+                                   jclass java_class,
+                                   const char* const* names,
+                                   const char* const* signatures,
+                                   const jboolean* is_static,
+                                   jint count,
+                                   jfieldID* field_ids);
+
 }  // namespace art
 
 std::ostream& operator<<(std::ostream& os, const jobjectRefType& rhs);
@@ -20,7 +20,23 @@
 
 namespace art {
 
-LinearAlloc::LinearAlloc(ArenaPool* pool) : lock_("linear alloc"), allocator_(pool) {
+// Size of the buffers handed out to threads for lock-free bump allocation, and the largest
+// request served from them. Larger requests (e.g. the method arrays of big classes) go straight
+// to the shared allocator since they would exhaust a buffer in a few allocations anyway.
+static constexpr size_t kThreadLocalBufferSize = 16 * KB;
+static constexpr size_t kMaxThreadLocalAlloc = 1 * KB;
+
+// Matches the (private) alignment that ArenaAllocator applies to its allocations, so that
+// thread-local buffer carving and direct allocations place objects identically.
+static constexpr size_t kLinearAllocAlignment = 8;
+
+Atomic<uintptr_t> LinearAlloc::next_id_;
+
+LinearAlloc::LinearAlloc(ArenaPool* pool)
+    : lock_("linear alloc"),
+      allocator_(pool),
+      // Start the ids at 1 so that no allocator matches the zero initialized thread-local state.
+      id_(next_id_.FetchAndAddSequentiallyConsistent(1u) + 1u) {
 }
 
 void* LinearAlloc::Realloc(Thread* self, void* ptr, size_t old_size, size_t new_size) {
@@ -29,6 +45,20 @@ void* LinearAlloc::Realloc(Thread* self, void* ptr, size_t old_size, size_t new_
 }
 
 void* LinearAlloc::Alloc(Thread* self, size_t size) {
+  const size_t aligned_size = RoundUp(size, kLinearAllocAlignment);
+  if (LIKELY(aligned_size <= kMaxThreadLocalAlloc)) {
+    if (!self->HasLinearAllocTlab(this, id_) || self->LinearAllocTlabSize() < aligned_size) {
+      uint8_t* start;
+      {
+        MutexLock mu(self, lock_);
+        start = reinterpret_cast<uint8_t*>(allocator_.Alloc(kThreadLocalBufferSize));
+      }
+      // The remainder of any previous buffer (of this or another allocator) is abandoned. The
+      // memory is never freed before the whole allocator is, so nothing leaks.
+      self->SetLinearAllocTlab(this, id_, start, start + kThreadLocalBufferSize);
+    }
+    return self->AllocLinearAllocTlab(aligned_size);
+  }
   MutexLock mu(self, lock_);
   return allocator_.Alloc(size);
 }
@@ -17,6 +17,7 @@
 #ifndef ART_RUNTIME_LINEAR_ALLOC_H_
 #define ART_RUNTIME_LINEAR_ALLOC_H_
 
+#include "atomic.h"
 #include "base/arena_allocator.h"
 
 namespace art {
@@ -28,6 +29,8 @@ class LinearAlloc {
  public:
   explicit LinearAlloc(ArenaPool* pool);
 
+  // Small allocations are served from a thread-local buffer carved out under lock_ and bumped
+  // without locking afterwards, so concurrent class loading does not contend on the lock.
   void* Alloc(Thread* self, size_t size) REQUIRES(!lock_);
 
   // Realloc never frees the input pointer, it is the caller's job to do this if necessary.
@@ -39,7 +42,8 @@ class LinearAlloc {
     return reinterpret_cast<T*>(Alloc(self, elements * sizeof(T)));
   }
 
-  // Return the number of bytes used in the allocator.
+  // Return the number of bytes used in the allocator. Thread-local buffers are counted in full
+  // when they are handed out, including their not yet allocated tail.
   size_t GetUsedMemory() const REQUIRES(!lock_);
 
   ArenaPool* GetArenaPool() REQUIRES(!lock_);
@@ -55,6 +59,14 @@ class LinearAlloc {
   mutable Mutex lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
   ArenaAllocator allocator_ GUARDED_BY(lock_);
 
+  // Id unique across all LinearAllocs ever created. Thread-local buffers are tagged with it so
+  // that a stale buffer of a deleted allocator can never be mistaken for a buffer of a new
+  // allocator at the same address.
+  const uintptr_t id_;
+
+  // Source of the ids, incremented for each constructed LinearAlloc.
+  static Atomic<uintptr_t> next_id_;
+
   DISALLOW_IMPLICIT_CONSTRUCTORS(LinearAlloc);
 };
 
@@ -279,7 +279,8 @@ MemMap* MemMap::MapAnonymous(const char* name,
                              bool low_4gb,
                              bool reuse,
                              std::string* error_msg,
-                             bool use_ashmem) {
+                             bool use_ashmem,
+                             bool huge_pages) {
 #ifndef __LP64__
   UNUSED(low_4gb);
 #endif
@@ -288,6 +289,19 @@ MemMap* MemMap::MapAnonymous(const char* name,
   }
   size_t page_aligned_byte_count = RoundUp(byte_count, kPageSize);
 
+  if (huge_pages) {
+    // Transparent huge pages only back private anonymous memory, so do not place the region in
+    // ashmem. The alignment and advice below are best effort; normal 4K pages remain the
+    // fallback when the kernel declines.
+    use_ashmem = false;
+  }
+  // Over-allocate so that a kHugePageSize-aligned extent of the requested size can be carved
+  // out; the kernel only collapses fully aligned extents into huge pages.
+  size_t map_byte_count = page_aligned_byte_count;
+  if (huge_pages && expected_ptr == nullptr) {
+    map_byte_count += kHugePageSize - kPageSize;
+  }
+
   int flags = MAP_PRIVATE | MAP_ANONYMOUS;
   if (reuse) {
     // reuse means it is okay that it overlaps an existing page mapping.
@@ -328,7 +342,7 @@ MemMap* MemMap::MapAnonymous(const char* name,
   int saved_errno = 0;
 
   void* actual = MapInternal(expected_ptr,
-                             page_aligned_byte_count,
+                             map_byte_count,
                              prot,
                              flags,
                              fd.get(),
@@ -343,7 +357,7 @@ MemMap* MemMap::MapAnonymous(const char* name,
       *error_msg = StringPrintf("Failed anonymous mmap(%p, %zd, 0x%x, 0x%x, %d, 0): %s. "
                                     "See process maps in the log.",
                                 expected_ptr,
-                                page_aligned_byte_count,
+                                map_byte_count,
                                 prot,
                                 flags,
                                 fd.get(),
@@ -351,6 +365,26 @@ MemMap* MemMap::MapAnonymous(const char* name,
     }
     return nullptr;
   }
+  if (map_byte_count != page_aligned_byte_count) {
+    // Trim the over-allocation so that the returned region starts huge-page aligned.
+    uint8_t* map_begin = reinterpret_cast<uint8_t*>(actual);
+    uint8_t* aligned_begin = AlignUp(map_begin, kHugePageSize);
+    size_t head_size = aligned_begin - map_begin;
+    size_t tail_size = map_byte_count - head_size - page_aligned_byte_count;
+    if (head_size != 0u) {
+      munmap(map_begin, head_size);
+    }
+    if (tail_size != 0u) {
+      munmap(aligned_begin + page_aligned_byte_count, tail_size);
+    }
+    actual = aligned_begin;
+  }
+#ifdef MADV_HUGEPAGE
+  if (huge_pages) {
+    // Advisory; on failure we simply keep normal pages.
+    madvise(actual, page_aligned_byte_count, MADV_HUGEPAGE);
+  }
+#endif
   std::ostringstream check_map_request_error_msg;
   if (!CheckMapRequest(expected_ptr, actual, page_aligned_byte_count, error_msg)) {
     return nullptr;
@@ -475,6 +509,7 @@ MemMap::~MemMap() {
     if (result == -1) {
       PLOG(FATAL) << "munmap failed";
     }
+    TrackedAllocators::RegisterFree(kAllocatorTagMemMap, base_size_);
   }
 
   // Remove it from maps_.
@@ -505,6 +540,10 @@ MemMap::MemMap(const std::string& name, uint8_t* begin, size_t size, void* base_
     CHECK(base_begin_ != nullptr);
     CHECK_NE(base_size_, 0U);
 
+    if (!reuse_) {
+      TrackedAllocators::RegisterAllocation(kAllocatorTagMemMap, base_size_);
+    }
+
     // Add it to maps_.
     MutexLock mu(Thread::Current(), *Locks::mem_maps_lock_);
     DCHECK(maps_ != nullptr);
@@ -530,6 +569,10 @@ MemMap* MemMap::RemapAtEnd(uint8_t* new_end, const char* tail_name, int tail_pro
   }
   size_ = new_end - reinterpret_cast<uint8_t*>(begin_);
   base_size_ = new_base_end - reinterpret_cast<uint8_t*>(base_begin_);
+  if (!reuse_) {
+    // The tail pages move to the new map created below, which registers them itself.
+    TrackedAllocators::RegisterFree(kAllocatorTagMemMap, old_base_end - new_base_end);
+  }
   DCHECK_LE(begin_ + size_, reinterpret_cast<uint8_t*>(base_begin_) + base_size_);
   size_t tail_size = old_end - new_end;
   uint8_t* tail_base_begin = new_base_end;
@@ -591,6 +634,15 @@ void MemMap::MadviseDontNeedAndZero() {
   }
 }
 
+void MemMap::MadviseHugePages() {
+#ifdef MADV_HUGEPAGE
+  if (base_begin_ != nullptr && base_size_ != 0) {
+    // Deliberately no warning on failure: the kernel may lack THP support entirely.
+    madvise(base_begin_, base_size_, MADV_HUGEPAGE);
+  }
+#endif
+}
+
 bool MemMap::Sync() {
   bool result;
   if (redzone_size_ != 0) {
@@ -760,6 +812,9 @@ void MemMap::SetSize(size_t new_size) {
       base_size_ - new_size);
   CHECK_EQ(munmap(reinterpret_cast<void*>(reinterpret_cast<uintptr_t>(BaseBegin()) + new_size),
                   base_size_ - new_size), 0) << new_size << " " << base_size_;
+  if (!reuse_) {
+    TrackedAllocators::RegisterFree(kAllocatorTagMemMap, base_size_ - new_size);
+  }
   base_size_ = new_size;
   size_ = new_size;
 }
@@ -866,7 +921,19 @@ void* MemMap::MapInternal(void* addr,
           return actual;
         }
       } else {
-        // Skip over last page.
+        // The conflicting mapping is typically not one of ours (those were skipped using
+        // maps_ above) but e.g. a shared library, and may span many pages. Rather than
+        // re-probing it one page at a time on subsequent iterations, grow the probed
+        // range exponentially while it remains fully mapped.
+        size_t probe_size = kPageSize;
+        while (tail_ptr + probe_size <= 4 * GB &&
+               msync(reinterpret_cast<void*>(tail_ptr), probe_size, 0) == 0) {
+          tail_ptr += probe_size;
+          probe_size *= 2;
+        }
+        // A failed probe only shows an unmapped hole somewhere in its range; the next
+        // iteration resumes the page-by-page scan at tail_ptr.
+        next_mem_pos_ = tail_ptr;
         ptr = tail_ptr;
       }
     }
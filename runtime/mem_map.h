@@ -52,6 +52,10 @@ static constexpr bool kMadviseZeroes = false;
 // Otherwise, calls might see uninitialized values.
 class MemMap {
  public:
+  // Size of a transparent huge page; the kernel only collapses fully aligned extents of this
+  // size into huge TLB entries.
+  static constexpr size_t kHugePageSize = 2 * MB;
+
   // Request an anonymous region of length 'byte_count' and a requested base address.
   // Use null as the requested base address if you don't care.
   // "reuse" allows re-mapping an address range from an existing mapping.
@@ -60,6 +64,11 @@ class MemMap {
   // 'name' will be used -- on systems that support it -- to give the mapping
   // a name.
   //
+  // "huge_pages" asks for transparent huge page backing to reduce TLB pressure on large
+  // regions: the mapping is placed in plain anonymous memory (never ashmem), aligned to
+  // kHugePageSize when no base address is requested, and advised with MADV_HUGEPAGE. All of
+  // this is best effort; the mapping falls back to normal pages when the kernel declines.
+  //
   // On success, returns returns a MemMap instance.  On failure, returns null.
   static MemMap* MapAnonymous(const char* name,
                               uint8_t* addr,
@@ -68,7 +77,8 @@ class MemMap {
                               bool low_4gb,
                               bool reuse,
                               std::string* error_msg,
-                              bool use_ashmem = true);
+                              bool use_ashmem = true,
+                              bool huge_pages = false);
 
   // Create placeholder for a region allocated by direct call to mmap.
   // This is useful when we do not have control over the code calling mmap,
@@ -132,6 +142,10 @@ class MemMap {
 
   void MadviseDontNeedAndZero();
 
+  // Advise the kernel to back this mapping with transparent huge pages. Best effort: the advice
+  // is silently ignored for mappings the kernel cannot collapse (e.g. file-backed ones).
+  void MadviseHugePages();
+
   int GetProtect() const {
     return prot_;
   }
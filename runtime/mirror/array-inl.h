@@ -19,6 +19,10 @@
 
 #include "array.h"
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 #include "base/bit_utils.h"
 #include "base/casts.h"
 #include "base/logging.h"
@@ -249,12 +253,52 @@ inline void PrimitiveArray<T>::SetWithoutChecks(int32_t i, T value) {
   DCHECK(CheckIsValidIndex<kVerifyFlags>(i));
   GetData()[i] = value;
 }
+// Chunk size used to widen element copies. Widening preserves the no-tearing
+// guarantee: the chunk stores are chunk aligned, so any split the hardware may
+// apply happens on a boundary that is itself element aligned.
+static constexpr size_t kArrayCopyChunkSize = sizeof(uint64_t);
+
+// Byte count from which the copy no longer fits in the caches anyway, so
+// streaming stores (where available) are used to avoid evicting the working
+// set of the application.
+static constexpr size_t kArrayCopyNonTemporalThreshold = 1 * MB;
+
+// Returns true if the pointers can reach chunk alignment together by advancing
+// over the same number of elements.
+template<typename T>
+static inline bool ArrayCopyCoAligned(const T* d, const T* s) {
+  return ((reinterpret_cast<uintptr_t>(d) ^ reinterpret_cast<uintptr_t>(s)) %
+          kArrayCopyChunkSize) == 0u;
+}
+
 // Backward copy where elements are of aligned appropriately for T. Count is in T sized units.
 // Copies are guaranteed not to tear when the sizeof T is less-than 64bit.
 template<typename T>
 static inline void ArrayBackwardCopy(T* d, const T* s, int32_t count) {
   d += count;
   s += count;
+  if (sizeof(T) < kArrayCopyChunkSize && ArrayCopyCoAligned(d, s)) {
+    // Copy elements until the end of the destination is chunk aligned.
+    while (count > 0 && reinterpret_cast<uintptr_t>(d) % kArrayCopyChunkSize != 0u) {
+      --d;
+      --s;
+      --count;
+      *d = *s;
+    }
+    // Chunk aligned body.
+    constexpr int32_t kElementsPerChunk = static_cast<int32_t>(kArrayCopyChunkSize / sizeof(T));
+    uint64_t* wd = reinterpret_cast<uint64_t*>(d);
+    const uint64_t* ws = reinterpret_cast<const uint64_t*>(s);
+    for (int32_t chunks = count / kElementsPerChunk; chunks != 0; --chunks) {
+      --wd;
+      --ws;
+      *wd = *ws;
+    }
+    int32_t copied = (count / kElementsPerChunk) * kElementsPerChunk;
+    d -= copied;
+    s -= copied;
+    count -= copied;
+  }
   for (int32_t i = 0; i < count; ++i) {
     d--;
     s--;
@@ -266,6 +310,42 @@ static inline void ArrayBackwardCopy(T* d, const T* s, int32_t count) {
 // Copies are guaranteed not to tear when the sizeof T is less-than 64bit.
 template<typename T>
 static inline void ArrayForwardCopy(T* d, const T* s, int32_t count) {
+  if (sizeof(T) < kArrayCopyChunkSize && ArrayCopyCoAligned(d, s)) {
+    // Copy elements until the destination is chunk aligned.
+    while (count > 0 && reinterpret_cast<uintptr_t>(d) % kArrayCopyChunkSize != 0u) {
+      *d++ = *s++;
+      --count;
+    }
+    constexpr int32_t kElementsPerChunk = static_cast<int32_t>(kArrayCopyChunkSize / sizeof(T));
+    int32_t chunks = count / kElementsPerChunk;
+    uint64_t* wd = reinterpret_cast<uint64_t*>(d);
+    const uint64_t* ws = reinterpret_cast<const uint64_t*>(s);
+    d += chunks * kElementsPerChunk;
+    s += chunks * kElementsPerChunk;
+    count -= chunks * kElementsPerChunk;
+#if defined(__SSE2__)
+    if (static_cast<size_t>(chunks) * kArrayCopyChunkSize >= kArrayCopyNonTemporalThreshold) {
+      // Fix up to the 16-byte alignment required by the streaming stores.
+      if (reinterpret_cast<uintptr_t>(wd) % (2u * kArrayCopyChunkSize) != 0u) {
+        *wd++ = *ws++;
+        --chunks;
+      }
+      while (chunks >= 2) {
+        _mm_stream_si128(reinterpret_cast<__m128i*>(wd),
+                         _mm_loadu_si128(reinterpret_cast<const __m128i*>(ws)));
+        wd += 2;
+        ws += 2;
+        chunks -= 2;
+      }
+      // Make the streaming stores visible to other observers before the write
+      // barrier and any subsequent release operation.
+      _mm_sfence();
+    }
+#endif
+    for (; chunks != 0; --chunks) {
+      *wd++ = *ws++;
+    }
+  }
   for (int32_t i = 0; i < count; ++i) {
     *d = *s;
     d++;
@@ -454,14 +454,20 @@ inline bool Class::CheckResolvedMethodAccess(Class* access_to, ArtMethod* method
 inline bool Class::IsSubClass(Class* klass) {
   DCHECK(!IsInterface()) << PrettyClass(this);
   DCHECK(!IsArrayClass()) << PrettyClass(this);
+  // Cohen-style subtype test on the stored superclass chain depths: a target deeper than this
+  // class cannot be a superclass, and otherwise the candidate superclass at the target's depth
+  // is found by walking up exactly the depth difference, leaving one pointer compare instead of
+  // one per step.
+  const uint32_t depth = GetSuperClassDepth();
+  const uint32_t klass_depth = klass->GetSuperClassDepth();
+  if (depth < klass_depth) {
+    return false;
+  }
   Class* current = this;
-  do {
-    if (current == klass) {
-      return true;
-    }
+  for (uint32_t i = depth - klass_depth; i != 0u; --i) {
     current = current->GetSuperClass();
-  } while (current != nullptr);
-  return false;
+  }
+  return current == klass;
 }
 
 inline ArtMethod* Class::FindVirtualMethodForInterface(ArtMethod* method, size_t pointer_size) {
@@ -686,6 +692,13 @@ template<bool kIsInstrumented, bool kCheckAddFinalizer>
 inline Object* Class::Alloc(Thread* self, gc::AllocatorType allocator_type) {
   CheckObjectAlloc();
   gc::Heap* heap = Runtime::Current()->GetHeap();
+  if (UNLIKELY(IsPretenured())) {
+    // The allocation profile flagged this class as long-lived, so route its instances directly
+    // into the non-moving space where moving collectors never have to copy them. The compiled
+    // allocation fast paths bail out for flagged classes (they test the access flags against
+    // ACCESS_FLAGS_CLASS_ALLOC_FAST_PATH_REJECT_MASK), so those allocations end up here too.
+    allocator_type = heap->GetCurrentNonMovingAllocator();
+  }
   const bool add_finalizer = kCheckAddFinalizer && IsFinalizable();
   if (!kCheckAddFinalizer) {
     DCHECK(!IsFinalizable());
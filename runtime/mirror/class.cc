@@ -1042,9 +1042,13 @@ ArtMethod* Class::GetDeclaredConstructor(
 }
 
 uint32_t Class::Depth() {
-  uint32_t depth = 0;
-  for (Class* klass = this; klass->GetSuperClass() != nullptr; klass = klass->GetSuperClass()) {
-    depth++;
+  const uint32_t depth = GetSuperClassDepth();
+  if (kIsDebugBuild) {
+    uint32_t walked = 0;
+    for (Class* klass = this; klass->GetSuperClass() != nullptr; klass = klass->GetSuperClass()) {
+      walked++;
+    }
+    CHECK_EQ(walked, depth) << PrettyClass(this);
   }
   return depth;
 }
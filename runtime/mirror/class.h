@@ -249,6 +249,18 @@ class MANAGED Class FINAL : public Object {
     SetAccessFlags(flags | kAccClassIsFinalizable);
   }
 
+  // Returns true if the allocation profile found instances of this class to be long-lived, in
+  // which case new instances are allocated directly in the non-moving space. See
+  // AllocRecordObjectMap::SweepAllocationRecords.
+  ALWAYS_INLINE bool IsPretenured() SHARED_REQUIRES(Locks::mutator_lock_) {
+    return (GetAccessFlags() & kAccClassIsPretenured) != 0;
+  }
+
+  ALWAYS_INLINE void SetPretenured() SHARED_REQUIRES(Locks::mutator_lock_) {
+    uint32_t flags = GetField32(OFFSET_OF_OBJECT_MEMBER(Class, access_flags_));
+    SetAccessFlags(flags | kAccClassIsPretenured);
+  }
+
   ALWAYS_INLINE bool IsStringClass() SHARED_REQUIRES(Locks::mutator_lock_) {
     return (GetClassFlags() & kClassFlagString) != 0;
   }
@@ -679,6 +691,9 @@ class MANAGED Class FINAL : public Object {
     DCHECK(old_super_class == nullptr || old_super_class == new_super_class);
     DCHECK(new_super_class != nullptr);
     SetFieldObject<false>(OFFSET_OF_OBJECT_MEMBER(Class, super_class_), new_super_class);
+    // Keep the superclass chain depth in sync. The superclass is always linked before its
+    // subclasses, so its own depth is already valid here. See IsSubClass().
+    SetSuperClassDepth(new_super_class->GetSuperClassDepth() + 1u);
   }
 
   bool HasSuperClass() SHARED_REQUIRES(Locks::mutator_lock_) {
@@ -1132,8 +1147,27 @@ class MANAGED Class FINAL : public Object {
   }
 
   void SetDexTypeIndex(uint16_t type_idx) SHARED_REQUIRES(Locks::mutator_lock_) {
+    // Not called within a transaction. The upper 16 bits hold the superclass chain depth and
+    // must be preserved.
+    const uint32_t depth_bits =
+        GetField32(OFFSET_OF_OBJECT_MEMBER(Class, dex_type_idx_)) & ~0xffffu;
+    SetField32<false>(OFFSET_OF_OBJECT_MEMBER(Class, dex_type_idx_), depth_bits | type_idx);
+  }
+
+  // Number of superclasses between this class and java.lang.Object, i.e. 0 for Object,
+  // primitives and unlinked classes, 1 for direct subclasses of Object. Maintained by
+  // SetSuperClass(); superclass chains come nowhere near 2^16 deep in practice. This makes the
+  // subtype test in IsSubClass() a bounded walk with a single pointer compare at the end.
+  uint16_t GetSuperClassDepth() SHARED_REQUIRES(Locks::mutator_lock_) {
+    return GetField32(OFFSET_OF_OBJECT_MEMBER(Class, dex_type_idx_)) >> 16;
+  }
+
+  void SetSuperClassDepth(uint16_t depth) SHARED_REQUIRES(Locks::mutator_lock_) {
     // Not called within a transaction.
-    SetField32<false>(OFFSET_OF_OBJECT_MEMBER(Class, dex_type_idx_), type_idx);
+    const uint32_t type_idx =
+        GetField32(OFFSET_OF_OBJECT_MEMBER(Class, dex_type_idx_)) & 0xffffu;
+    SetField32<false>(OFFSET_OF_OBJECT_MEMBER(Class, dex_type_idx_),
+                      type_idx | (static_cast<uint32_t>(depth) << 16));
   }
 
   uint32_t FindTypeIndexInOtherDexFile(const DexFile& dex_file)
@@ -1434,8 +1468,8 @@ class MANAGED Class FINAL : public Object {
   // TODO: really 16bits
   int32_t dex_class_def_idx_;
 
-  // Type index in dex file.
-  // TODO: really 16bits
+  // Low 16 bits: type index in dex file. Upper 16 bits: depth of the superclass chain, used by
+  // the fast subtype test in IsSubClass().
   int32_t dex_type_idx_;
 
   // Number of instance fields that are object refs.
@@ -26,7 +26,7 @@
 #include "runtime.h"
 #include "string.h"
 #include "thread.h"
-#include "utf.h"
+#include "utf-inl.h"
 #include "utils.h"
 
 namespace art {
@@ -69,7 +69,14 @@ class SetStringCountAndBytesVisitor {
     string->SetCount(count_);
     uint16_t* value = string->GetValue();
     const uint8_t* const src = reinterpret_cast<uint8_t*>(src_array_->GetData()) + offset_;
-    for (int i = 0; i < count_; i++) {
+    int32_t i = 0;
+    if (high_byte_ == 0) {
+      // The common high_byte == 0 case is a plain Latin-1 widening; do it in chunks.
+      for (; count_ - i >= static_cast<int32_t>(kUtf8AsciiChunkSize); i += kUtf8AsciiChunkSize) {
+        WidenLatin1Chunk(src + i, value + i);
+      }
+    }
+    for (; i < count_; i++) {
       value[i] = high_byte_ + (src[i] & 0xFF);
     }
   }
@@ -182,9 +189,17 @@ inline String* String::Alloc(Thread* self, int32_t utf16_length, gc::AllocatorTy
   }
 
   gc::Heap* heap = Runtime::Current()->GetHeap();
+  // A string class always satisfies the class check in ShouldAllocLargeObject, so whether this
+  // allocation is large depends only on its size. Deciding that here keeps the class checks out
+  // of the common small-string path.
+  if (UNLIKELY(alloc_size >= heap->GetLargeObjectThreshold())) {
+    return down_cast<String*>(
+        heap->AllocObjectWithAllocator<kIsInstrumented, true>(self, string_class, alloc_size,
+                                                              allocator_type, pre_fence_visitor));
+  }
   return down_cast<String*>(
-      heap->AllocObjectWithAllocator<kIsInstrumented, true>(self, string_class, alloc_size,
-                                                            allocator_type, pre_fence_visitor));
+      heap->AllocObjectWithAllocator<kIsInstrumented, false>(self, string_class, alloc_size,
+                                                             allocator_type, pre_fence_visitor));
 }
 
 template <bool kIsInstrumented>
@@ -143,13 +143,11 @@ bool String::Equals(String* that) {
     return false;
   } else {
     // Note: don't short circuit on hash code as we're presumably here as the
-    // hash code was already equal
-    for (int32_t i = 0; i < that->GetLength(); ++i) {
-      if (this->CharAt(i) != that->CharAt(i)) {
-        return false;
-      }
-    }
-    return true;
+    // hash code was already equal.
+    // memcmp is vectorized in libc and beats a per-char loop for the common
+    // multi-character case.
+    return memcmp(this->GetValue(), that->GetValue(),
+                  sizeof(uint16_t) * this->GetLength()) == 0;
   }
 }
 
@@ -77,7 +77,7 @@ int32_t Throwable::GetStackDepth() {
   mirror::ObjectArray<mirror::Object>* const trace = stack_state->AsObjectArray<mirror::Object>();
   const int32_t array_len = trace->GetLength();
   DCHECK_GT(array_len, 0);
-  // See method BuildInternalStackTraceVisitor::Init for the format.
+  // See method Thread::CreateInternalStackTrace for the format.
   return array_len - 1;
 }
 
@@ -95,7 +95,7 @@ std::string Throwable::Dump() {
     mirror::ObjectArray<mirror::Object>* object_array =
         stack_state->AsObjectArray<mirror::Object>();
     // Decode the internal stack trace into the depth and method trace
-    // See method BuildInternalStackTraceVisitor::Init for the format.
+    // See method Thread::CreateInternalStackTrace for the format.
     DCHECK_GT(object_array->GetLength(), 0);
     mirror::Object* methods_and_dex_pcs = object_array->Get(0);
     DCHECK(methods_and_dex_pcs->IsIntArray() || methods_and_dex_pcs->IsLongArray());
@@ -68,11 +68,23 @@ static constexpr uint32_t kAccCompileDontBother =     0x01000000;  // method (ru
 // Set by the verifier for a method that could not be verified to follow structured locking.
 static constexpr uint32_t kAccMustCountLocks =        0x02000000;  // method (runtime)
 
+// Set by the class linker on a virtual method when a subclass installs an override of it in its
+// vtable. Updated without synchronization, so a reader may briefly observe a stale zero; it may
+// therefore only feed guarded speculation (see the JIT inliner), never unguarded
+// devirtualization.
+static constexpr uint32_t kAccOverridden =            0x04000000;  // method (runtime)
+
 // Special runtime-only flags.
 // Interface and all its super-interfaces with default methods have been recursively initialized.
 static constexpr uint32_t kAccRecursivelyInitialized    = 0x20000000;
 // Interface declares some default method.
 static constexpr uint32_t kAccHasDefaultMethod          = 0x40000000;
+// The allocation profile found instances of this class to be long-lived, so new instances are
+// allocated directly in the non-moving space. Shares its value with kAccHasDefaultMethod, which
+// is only set on interfaces, while this flag is only set on instantiable classes. Must stay
+// adjacent to kAccClassIsFinalizable so the pair forms a valid immediate for the combined test
+// in the allocation fast paths (see ACCESS_FLAGS_CLASS_ALLOC_FAST_PATH_REJECT_MASK).
+static constexpr uint32_t kAccClassIsPretenured         = 0x40000000;
 // class/ancestor overrides finalize()
 static constexpr uint32_t kAccClassIsFinalizable        = 0x80000000;
 
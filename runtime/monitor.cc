@@ -16,9 +16,11 @@
 
 #include "monitor.h"
 
+#include <algorithm>
 #include <vector>
 
 #include "art_method-inl.h"
+#include "base/histogram-inl.h"
 #include "base/mutex.h"
 #include "base/stl_util.h"
 #include "base/systrace.h"
@@ -40,6 +42,18 @@ namespace art {
 
 static constexpr uint64_t kLongWaitMs = 100;
 
+// Bounds and step for the adaptive spin budget used by Monitor::Lock. The budget of a monitor
+// grows by kMonitorSpinsStep every time spinning sights an unlock and halves every time the
+// spinner parks anyway, so only monitors with short hold times keep spending cycles spinning.
+// A floor of one keeps a monitor that went contended for a while able to re-learn.
+static constexpr uint32_t kMonitorSpinsMin = 1;
+static constexpr uint32_t kMonitorSpinsMax = 100;
+static constexpr uint32_t kMonitorSpinsInitial = 10;
+static constexpr uint32_t kMonitorSpinsStep = 10;
+
+// How many of the most contended monitors MonitorList::DumpForSigQuit lists individually.
+static constexpr size_t kContentionDumpMaxMonitors = 5;
+
 /*
  * Every Object has a monitor associated with it, but not every Object is actually locked.  Even
  * the ones that are locked do not need a full-fledged monitor until a) there is actual contention
@@ -79,6 +93,10 @@ Monitor::Monitor(Thread* self, Thread* owner, mirror::Object* obj, int32_t hash_
       num_waiters_(0),
       owner_(owner),
       lock_count_(0),
+      max_spins_(kMonitorSpinsInitial),
+      contention_count_(0),
+      spin_acquire_count_(0),
+      park_count_(0),
       obj_(GcRoot<mirror::Object>(obj)),
       wait_set_(nullptr),
       hash_code_(hash_code),
@@ -102,6 +120,10 @@ Monitor::Monitor(Thread* self, Thread* owner, mirror::Object* obj, int32_t hash_
       num_waiters_(0),
       owner_(owner),
       lock_count_(0),
+      max_spins_(kMonitorSpinsInitial),
+      contention_count_(0),
+      spin_acquire_count_(0),
+      park_count_(0),
       obj_(GcRoot<mirror::Object>(obj)),
       wait_set_(nullptr),
       hash_code_(hash_code),
@@ -331,6 +353,28 @@ void Monitor::Lock(Thread* self) {
       break;
     }
     // Contended.
+    ++contention_count_;
+    // Adaptive spin phase. Short critical sections are usually released within a few hundred
+    // nanoseconds, so try to sight an unlock before paying two context switches to park on
+    // monitor_contenders_. Spinning happens without monitor_lock_ held; as in the thin-lock
+    // spin in MonitorEnter, use sched_yield rather than NanoSleep to keep suspension prompt.
+    const uint32_t spins_allowed = max_spins_;
+    if (spins_allowed != 0u) {
+      monitor_lock_.Unlock(self);
+      for (uint32_t spin = 0; spin < spins_allowed && GetOwner() != nullptr; ++spin) {
+        sched_yield();
+      }
+      monitor_lock_.Lock(self);
+      if (owner_ == nullptr) {
+        // The spin sighted an unlock. Grow the budget and retry the acquisition path above.
+        ++spin_acquire_count_;
+        max_spins_ = std::min(max_spins_ + kMonitorSpinsStep, kMonitorSpinsMax);
+        continue;
+      }
+      // Spun the whole budget without sighting an unlock; shrink it and fall through to parking.
+      max_spins_ = std::max(max_spins_ / 2, kMonitorSpinsMin);
+    }
+    ++park_count_;
     const bool log_contention = (lock_profiling_threshold_ != 0);
     uint64_t wait_start_ms = log_contention ? MilliTime() : 0;
     ArtMethod* owners_method = locking_method_;
@@ -1275,7 +1319,8 @@ uint32_t Monitor::GetOwnerThreadId() {
 
 MonitorList::MonitorList()
     : allow_new_monitors_(true), monitor_list_lock_("MonitorList lock", kMonitorListLock),
-      monitor_add_condition_("MonitorList disallow condition", monitor_list_lock_) {
+      monitor_add_condition_("MonitorList disallow condition", monitor_list_lock_),
+      deflate_pass_remaining_(0u) {
 }
 
 MonitorList::~MonitorList() {
@@ -1358,10 +1403,76 @@ class MonitorDeflateVisitor : public IsMarkedVisitor {
   size_t deflate_count_;
 };
 
-size_t MonitorList::DeflateMonitors() {
+void MonitorList::DumpForSigQuit(std::ostream& os) {
+  Thread* self = Thread::Current();
+  Histogram<uint64_t> histogram("monitor contention counts", 1u);
+  struct ContendedMonitor {
+    MonitorId id;
+    uint32_t contention_count;
+    uint32_t spin_acquire_count;
+    uint32_t park_count;
+    uint32_t max_spins;
+  };
+  std::vector<ContendedMonitor> contended;
+  MutexLock mu(self, monitor_list_lock_);
+  for (Monitor* m : list_) {
+    // monitor_lock_ sits below monitor_list_lock_ in the lock hierarchy and is never held across
+    // a park, so taking it here is safe and brief.
+    MutexLock mu2(self, m->monitor_lock_);
+    if (m->contention_count_ != 0u) {
+      histogram.AddValue(m->contention_count_);
+      contended.push_back(ContendedMonitor { m->monitor_id_, m->contention_count_,
+          m->spin_acquire_count_, m->park_count_, m->max_spins_ });
+    }
+  }
+  if (histogram.SampleSize() == 0u) {
+    os << "No contended monitors\n";
+    return;
+  }
+  os << "Histogram of monitor contention counts: ";
+  histogram.DumpBins(os);
+  os << "\n";
+  std::sort(contended.begin(), contended.end(),
+            [](const ContendedMonitor& a, const ContendedMonitor& b) {
+              return a.contention_count > b.contention_count;
+            });
+  const size_t count = std::min(contended.size(), kContentionDumpMaxMonitors);
+  for (size_t i = 0; i < count; ++i) {
+    const ContendedMonitor& cm = contended[i];
+    os << "Monitor " << cm.id << " contended " << cm.contention_count << " times (spin acquired "
+       << cm.spin_acquire_count << ", parked " << cm.park_count << ", spin budget "
+       << cm.max_spins << ")\n";
+  }
+}
+
+size_t MonitorList::DeflateMonitorsSlice(size_t max_scanned, bool* pass_complete) {
   MonitorDeflateVisitor visitor;
   Locks::mutator_lock_->AssertExclusiveHeld(visitor.self_);
-  SweepMonitorList(&visitor);
+  MutexLock mu(visitor.self_, monitor_list_lock_);
+  if (deflate_pass_remaining_ == 0u) {
+    // Start a new pass over the monitors present right now. Monitors added while the pass is in
+    // progress go to the front of the list and are picked up by the next pass.
+    deflate_pass_remaining_ = list_.size();
+  }
+  size_t to_scan = std::min(max_scanned, deflate_pass_remaining_);
+  deflate_pass_remaining_ -= to_scan;
+  for (size_t i = 0; i < to_scan; ++i) {
+    Monitor* m = list_.front();
+    list_.pop_front();
+    // Disable the read barrier in GetObject() as mutators are suspended.
+    mirror::Object* obj = m->GetObject<kWithoutReadBarrier>();
+    // The object of a monitor can be null if the monitor was already deflated.
+    mirror::Object* new_obj = obj != nullptr ? visitor.IsMarked(obj) : nullptr;
+    if (new_obj == nullptr) {
+      VLOG(monitor) << "freeing deflated monitor " << m;
+      MonitorPool::ReleaseMonitor(visitor.self_, m);
+    } else {
+      m->SetObject(new_obj);
+      // Rotate survivors to the back so the next slice resumes where this one stopped.
+      list_.push_back(m);
+    }
+  }
+  *pass_complete = (deflate_pass_remaining_ == 0u);
   return visitor.deflate_count_;
 }
 
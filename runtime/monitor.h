@@ -276,6 +276,18 @@ class Monitor {
   // Owner's recursive lock depth.
   int lock_count_ GUARDED_BY(monitor_lock_);
 
+  // Adaptive spin budget for contended acquisition. Lock() spins up to this many times hoping to
+  // sight an unlock before parking on monitor_contenders_; the budget is grown when spinning
+  // succeeds and shrunk when the spinner parks anyway.
+  uint32_t max_spins_ GUARDED_BY(monitor_lock_);
+
+  // Contention statistics, surfaced by MonitorList::DumpForSigQuit. A contention event is a pass
+  // through Lock() that found the monitor owned by another thread; it resolves either by the spin
+  // sighting an unlock or by parking on monitor_contenders_.
+  uint32_t contention_count_ GUARDED_BY(monitor_lock_);
+  uint32_t spin_acquire_count_ GUARDED_BY(monitor_lock_);
+  uint32_t park_count_ GUARDED_BY(monitor_lock_);
+
   // What object are we part of. This is a weak root. Do not access
   // this directly, use GetObject() to read it so it will be guarded
   // by a read barrier.
@@ -320,8 +332,13 @@ class MonitorList {
   void DisallowNewMonitors() REQUIRES(!monitor_list_lock_);
   void AllowNewMonitors() REQUIRES(!monitor_list_lock_);
   void BroadcastForNewMonitors() REQUIRES(!monitor_list_lock_);
-  // Returns how many monitors were deflated.
-  size_t DeflateMonitors() REQUIRES(!monitor_list_lock_) REQUIRES(Locks::mutator_lock_);
+  // Deflate up to max_scanned monitors and return how many were deflated. Requires mutators to be
+  // suspended. A full pass over the list is spread across calls; *pass_complete is set to true
+  // once the pass has covered every monitor that was in the list when the pass began.
+  size_t DeflateMonitorsSlice(size_t max_scanned, bool* pass_complete)
+      REQUIRES(!monitor_list_lock_) REQUIRES(Locks::mutator_lock_);
+  // Dump a histogram of per-monitor contention counts plus the worst offenders.
+  void DumpForSigQuit(std::ostream& os) REQUIRES(!monitor_list_lock_);
 
   typedef std::list<Monitor*, TrackingAllocator<Monitor*, kAllocatorTagMonitorList>> Monitors;
 
@@ -334,6 +351,8 @@ class MonitorList {
   Mutex monitor_list_lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
   ConditionVariable monitor_add_condition_ GUARDED_BY(monitor_list_lock_);
   Monitors list_ GUARDED_BY(monitor_list_lock_);
+  // Monitors left to scan in the current incremental deflation pass; zero when no pass is active.
+  size_t deflate_pass_remaining_ GUARDED_BY(monitor_list_lock_);
 
   friend class Monitor;
   DISALLOW_COPY_AND_ASSIGN(MonitorList);
@@ -108,18 +108,37 @@ void MonitorPool::FreeInternal() {
 Monitor* MonitorPool::CreateMonitorInPool(Thread* self, Thread* owner, mirror::Object* obj,
                                           int32_t hash_code)
     SHARED_REQUIRES(Locks::mutator_lock_) {
-  // We are gonna allocate, so acquire the writer lock.
-  MutexLock mu(self, *Locks::allocated_monitor_ids_lock_);
+  // Fast path: pop storage from the thread's cache without taking the global lock.
+  Monitor* mon_uninitialized = self->GetMonitorPoolCache();
+  if (LIKELY(mon_uninitialized != nullptr)) {
+    self->SetMonitorPoolCache(mon_uninitialized->next_free_, self->GetMonitorPoolCacheSize() - 1);
+  } else {
+    // We are gonna allocate, so acquire the writer lock.
+    MutexLock mu(self, *Locks::allocated_monitor_ids_lock_);
+
+    // Enough space, or need to resize?
+    if (first_free_ == nullptr) {
+      VLOG(monitor) << "Allocating a new chunk.";
+      AllocateChunk();
+    }
 
-  // Enough space, or need to resize?
-  if (first_free_ == nullptr) {
-    VLOG(monitor) << "Allocating a new chunk.";
-    AllocateChunk();
+    mon_uninitialized = first_free_;
+    first_free_ = first_free_->next_free_;
+
+    // Refill the thread's cache with a batch while we hold the lock, so the next inflations on
+    // this thread take the fast path above.
+    Monitor* cache_head = nullptr;
+    size_t cache_size = 0;
+    while (cache_size < kMonitorCacheBatchSize - 1 && first_free_ != nullptr) {
+      Monitor* cached = first_free_;
+      first_free_ = first_free_->next_free_;
+      cached->next_free_ = cache_head;
+      cache_head = cached;
+      ++cache_size;
+    }
+    self->SetMonitorPoolCache(cache_head, cache_size);
   }
 
-  Monitor* mon_uninitialized = first_free_;
-  first_free_ = first_free_->next_free_;
-
   // Pull out the id which was preinitialized.
   MonitorId id = mon_uninitialized->monitor_id_;
 
@@ -130,9 +149,6 @@ Monitor* MonitorPool::CreateMonitorInPool(Thread* self, Thread* owner, mirror::O
 }
 
 void MonitorPool::ReleaseMonitorToPool(Thread* self, Monitor* monitor) {
-  // Might be racy with allocation, so acquire lock.
-  MutexLock mu(self, *Locks::allocated_monitor_ids_lock_);
-
   // Keep the monitor id. Don't trust it's not cleared.
   MonitorId id = monitor->monitor_id_;
 
@@ -140,12 +156,29 @@ void MonitorPool::ReleaseMonitorToPool(Thread* self, Monitor* monitor) {
   // TODO: Exception safety?
   monitor->~Monitor();
 
-  // Add to the head of the free list.
-  monitor->next_free_ = first_free_;
-  first_free_ = monitor;
+  // Add to the head of the thread's cache.
+  monitor->next_free_ = self->GetMonitorPoolCache();
 
   // Rewrite monitor id.
   monitor->monitor_id_ = id;
+
+  size_t cache_size = self->GetMonitorPoolCacheSize() + 1;
+  self->SetMonitorPoolCache(monitor, cache_size);
+
+  // Return a batch to the central free list once the cache is full, so a thread that releases
+  // many monitors (e.g. during a sweep) does not hoard all the free storage.
+  if (UNLIKELY(cache_size >= kMonitorCacheMaxSize)) {
+    Monitor* batch_head = self->GetMonitorPoolCache();
+    Monitor* batch_tail = batch_head;
+    for (size_t i = 1; i < kMonitorCacheBatchSize; ++i) {
+      batch_tail = batch_tail->next_free_;
+    }
+    self->SetMonitorPoolCache(batch_tail->next_free_, cache_size - kMonitorCacheBatchSize);
+
+    MutexLock mu(self, *Locks::allocated_monitor_ids_lock_);
+    batch_tail->next_free_ = first_free_;
+    first_free_ = batch_head;
+  }
 }
 
 void MonitorPool::ReleaseMonitorsToPool(Thread* self, MonitorList::Monitors* monitors) {
@@ -154,4 +187,20 @@ void MonitorPool::ReleaseMonitorsToPool(Thread* self, MonitorList::Monitors* mon
   }
 }
 
+void MonitorPool::FlushMonitorCacheInPool(Thread* self) {
+  Monitor* head = self->GetMonitorPoolCache();
+  if (head == nullptr) {
+    return;
+  }
+  Monitor* tail = head;
+  while (tail->next_free_ != nullptr) {
+    tail = tail->next_free_;
+  }
+  self->SetMonitorPoolCache(nullptr, 0u);
+
+  MutexLock mu(self, *Locks::allocated_monitor_ids_lock_);
+  tail->next_free_ = first_free_;
+  first_free_ = head;
+}
+
 }  // namespace art
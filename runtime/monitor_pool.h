@@ -71,6 +71,16 @@ class MonitorPool {
 #endif
   }
 
+  // Return all monitors cached by the given thread to the central free list. Called on thread
+  // detach.
+  static void FlushMonitorCache(Thread* self) {
+#ifndef __LP64__
+    UNUSED(self);
+#else
+    GetMonitorPool()->FlushMonitorCacheInPool(self);
+#endif
+  }
+
   static Monitor* MonitorFromMonitorId(MonitorId mon_id) {
 #ifndef __LP64__
     return reinterpret_cast<Monitor*>(mon_id << LockWord::kMonitorIdAlignmentShift);
@@ -127,6 +137,7 @@ class MonitorPool {
 
   void ReleaseMonitorToPool(Thread* self, Monitor* monitor);
   void ReleaseMonitorsToPool(Thread* self, MonitorList::Monitors* monitors);
+  void FlushMonitorCacheInPool(Thread* self) REQUIRES(!Locks::allocated_monitor_ids_lock_);
 
   // Note: This is safe as we do not ever move chunks.  All needed entries in the monitor_chunks_
   // data structure are read-only once we get here.  Updates happen-before this call because
@@ -178,6 +189,11 @@ class MonitorPool {
     return kInitialChunkStorage << index;
   }
 
+  // Number of free monitors moved between a thread's cache and the central free list at a time.
+  static constexpr size_t kMonitorCacheBatchSize = 8;
+  // Flush a batch back to the central free list once a thread's cache grows to this size.
+  static constexpr size_t kMonitorCacheMaxSize = 2 * kMonitorCacheBatchSize;
+
   // TODO: There are assumptions in the code that monitor addresses are 8B aligned (>>3).
   static constexpr size_t kMonitorAlignment = 8;
   // Size of a monitor, rounded up to a multiple of alignment.
@@ -21,6 +21,7 @@
 
 #include <sstream>
 
+#include "base/allocator.h"
 #include "base/histogram-inl.h"
 #include "base/time_utils.h"
 #include "class_linker.h"
@@ -368,6 +369,10 @@ enum class VMDebugRuntimeStatId {
   kArtGcBlockingGcTime,
   kArtGcGcCountRateHistogram,
   kArtGcBlockingGcCountRateHistogram,
+  kArtNativeBytesMapped,
+  kArtNativeBytesArenaPool,
+  kArtGcNativeAllocationRate,
+  kArtGcNativeGcsDeferred,
   kNumRuntimeStats,
 };
 
@@ -408,6 +413,24 @@ static jobject VMDebug_getRuntimeStatInternal(JNIEnv* env, jclass, jint statId)
       heap->DumpBlockingGcCountRateHistogram(output);
       return env->NewStringUTF(output.str().c_str());
     }
+    case VMDebugRuntimeStatId::kArtNativeBytesMapped: {
+      std::string output = std::to_string(
+          TrackedAllocators::g_bytes_used[kAllocatorTagMemMap].LoadRelaxed());
+      return env->NewStringUTF(output.c_str());
+    }
+    case VMDebugRuntimeStatId::kArtNativeBytesArenaPool: {
+      std::string output = std::to_string(
+          TrackedAllocators::g_bytes_used[kAllocatorTagArenaPool].LoadRelaxed());
+      return env->NewStringUTF(output.c_str());
+    }
+    case VMDebugRuntimeStatId::kArtGcNativeAllocationRate: {
+      std::string output = std::to_string(heap->GetNativeAllocationRate());
+      return env->NewStringUTF(output.c_str());
+    }
+    case VMDebugRuntimeStatId::kArtGcNativeGcsDeferred: {
+      std::string output = std::to_string(heap->GetDeferredNativeGcCount());
+      return env->NewStringUTF(output.c_str());
+    }
     default:
       return nullptr;
   }
@@ -472,6 +495,26 @@ static jobjectArray VMDebug_getRuntimeStatsInternal(JNIEnv* env, jclass) {
       return nullptr;
     }
   }
+  if (!SetRuntimeStatValue(env, result, VMDebugRuntimeStatId::kArtNativeBytesMapped,
+                           std::to_string(
+                               TrackedAllocators::g_bytes_used[kAllocatorTagMemMap].
+                                   LoadRelaxed()))) {
+    return nullptr;
+  }
+  if (!SetRuntimeStatValue(env, result, VMDebugRuntimeStatId::kArtNativeBytesArenaPool,
+                           std::to_string(
+                               TrackedAllocators::g_bytes_used[kAllocatorTagArenaPool].
+                                   LoadRelaxed()))) {
+    return nullptr;
+  }
+  if (!SetRuntimeStatValue(env, result, VMDebugRuntimeStatId::kArtGcNativeAllocationRate,
+                           std::to_string(heap->GetNativeAllocationRate()))) {
+    return nullptr;
+  }
+  if (!SetRuntimeStatValue(env, result, VMDebugRuntimeStatId::kArtGcNativeGcsDeferred,
+                           std::to_string(heap->GetDeferredNativeGcCount()))) {
+    return nullptr;
+  }
   return result;
 }
 
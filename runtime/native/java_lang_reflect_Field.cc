@@ -246,9 +246,9 @@ ALWAYS_INLINE inline static void SetFieldValue(mirror::Object* o, mirror::Field*
     break;
   case Primitive::kPrimByte:
     if (is_volatile) {
-      o->SetFieldBooleanVolatile<false>(offset, new_value.GetB());
+      o->SetFieldByteVolatile<false>(offset, new_value.GetB());
     } else {
-      o->SetFieldBoolean<false>(offset, new_value.GetB());
+      o->SetFieldByte<false>(offset, new_value.GetB());
     }
     break;
   case Primitive::kPrimChar:
@@ -352,7 +352,10 @@ static void SetPrimitiveField(JNIEnv* env, jobject javaField, jobject javaObj,
 
   // Widen the value if necessary (and possible).
   JValue wide_value;
-  if (!ConvertPrimitiveValue(false, kPrimitiveType, field_type, new_value, &wide_value)) {
+  if (LIKELY(field_type == kPrimitiveType)) {
+    // Exact-type set, no conversion needed.
+    wide_value = new_value;
+  } else if (!ConvertPrimitiveValue(false, kPrimitiveType, field_type, new_value, &wide_value)) {
     DCHECK(soa.Self()->IsExceptionPending());
     return;
   }
@@ -364,7 +367,13 @@ static void SetPrimitiveField(JNIEnv* env, jobject javaField, jobject javaObj,
   }
 
   // Write the value.
-  SetFieldValue(o, f, field_type, false, wide_value);
+  if (LIKELY(field_type == kPrimitiveType)) {
+    // This if statement should get optimized out since we only pass in valid primitive types,
+    // leaving just the one store matching kPrimitiveType in SetFieldValue.
+    SetFieldValue(o, f, kPrimitiveType, false, wide_value);
+  } else {
+    SetFieldValue(o, f, field_type, false, wide_value);
+  }
 }
 
 static void Field_setBoolean(JNIEnv* env, jobject javaField, jobject javaObj, jboolean z) {
@@ -21,7 +21,9 @@
 #include "scoped_fast_native_object_access.h"
 #include "ScopedPrimitiveArray.h"
 #include "unicode/utf16.h"
+#include "utf-inl.h"
 
+#include <algorithm>
 #include <string.h>
 
 namespace art {
@@ -59,6 +61,19 @@ class NativeUnsafeByteSequence {
     return true;
   }
 
+  // Appends `length` characters known to be ASCII, one byte each.
+  bool appendAscii(const jchar* src, jint length) {
+    while (mSize - mOffset < length) {
+      if (!resize(std::max(mSize * 2, mOffset + length))) {
+        return false;
+      }
+    }
+    for (jint i = 0; i < length; ++i) {
+      mRawArray[mOffset++] = static_cast<jbyte>(src[i]);
+    }
+    return true;
+  }
+
   bool resize(int newSize) {
     if (newSize == mSize) {
       return true;
@@ -121,9 +136,16 @@ static void CharsetUtils_asciiBytesToChars(JNIEnv* env, jclass, jbyteArray javaB
   const jbyte* src = &bytes[offset];
   jchar* dst = &chars[0];
   static const jchar REPLACEMENT_CHAR = 0xfffd;
-  for (int i = length - 1; i >= 0; --i) {
-    jchar ch = static_cast<jchar>(*src++ & 0xff);
-    *dst++ = (ch <= 0x7f) ? ch : REPLACEMENT_CHAR;
+  for (jint i = 0; i < length; ++i) {
+    // Fast path: widen whole chunks of ASCII bytes without per-byte checks.
+    if (length - i >= static_cast<jint>(kUtf8AsciiChunkSize) &&
+        IsUtf8ChunkAscii(reinterpret_cast<const char*>(src + i))) {
+      WidenLatin1Chunk(reinterpret_cast<const uint8_t*>(src + i), dst + i);
+      i += kUtf8AsciiChunkSize - 1;
+      continue;
+    }
+    jchar ch = static_cast<jchar>(src[i] & 0xff);
+    dst[i] = (ch <= 0x7f) ? ch : REPLACEMENT_CHAR;
   }
 }
 
@@ -140,8 +162,12 @@ static void CharsetUtils_isoLatin1BytesToChars(JNIEnv* env, jclass, jbyteArray j
 
   const jbyte* src = &bytes[offset];
   jchar* dst = &chars[0];
-  for (int i = length - 1; i >= 0; --i) {
-    *dst++ = static_cast<jchar>(*src++ & 0xff);
+  jint i = 0;
+  for (; length - i >= static_cast<jint>(kUtf8AsciiChunkSize); i += kUtf8AsciiChunkSize) {
+    WidenLatin1Chunk(reinterpret_cast<const uint8_t*>(src + i), dst + i);
+  }
+  for (; i < length; ++i) {
+    dst[i] = static_cast<jchar>(src[i] & 0xff);
   }
 }
 
@@ -167,12 +193,19 @@ static jbyteArray charsToBytes(JNIEnv* env, jstring java_string, jint offset, ji
 
   const jchar* src = &(string->GetValue()[offset]);
   jbyte* dst = &bytes[0];
-  for (int i = length - 1; i >= 0; --i) {
-    jchar ch = *src++;
+  for (jint i = 0; i < length; ++i) {
+    // Fast path: narrow whole chunks of in-range characters without per-char checks.
+    if (length - i >= static_cast<jint>(kUtf16AsciiChunkSize) &&
+        IsUtf16ChunkAtMost(src + i, maxValidChar)) {
+      NarrowUtf16Chunk(src + i, reinterpret_cast<uint8_t*>(dst + i));
+      i += kUtf16AsciiChunkSize - 1;
+      continue;
+    }
+    jchar ch = src[i];
     if (ch > maxValidChar) {
       ch = '?';
     }
-    *dst++ = static_cast<jbyte>(ch);
+    dst[i] = static_cast<jbyte>(ch);
   }
 
   return javaBytes;
@@ -204,6 +237,18 @@ static jbyteArray CharsetUtils_toUtf8Bytes(JNIEnv* env, jclass, jstring java_str
 
   const int end = offset + length;
   for (int i = offset; i < end; ++i) {
+    // Fast path: bulk-append chunks of one-byte characters. The chunk is staged
+    // in a local buffer since appendAscii may allocate and move the string.
+    if (end - i >= static_cast<int>(kUtf16AsciiChunkSize) &&
+        IsUtf16ChunkAscii(string->GetValue() + i)) {
+      jchar chunk[kUtf16AsciiChunkSize];
+      memcpy(chunk, string->GetValue() + i, sizeof(chunk));
+      if (!out.appendAscii(chunk, kUtf16AsciiChunkSize)) {
+        return nullptr;
+      }
+      i += kUtf16AsciiChunkSize - 1;
+      continue;
+    }
     jint ch = string->CharAt(i);
     if (ch < 0x80) {
       // One byte.
@@ -190,6 +190,13 @@ void OatHeader::UpdateChecksum(const void* data, size_t length) {
   }
 }
 
+void OatHeader::UpdateChecksumWithPartial(uint32_t adler32_checksum, uint64_t length) {
+  DCHECK(IsValid());
+  if (length != 0u) {
+    adler32_checksum_ = adler32_combine(adler32_checksum_, adler32_checksum, length);
+  }
+}
+
 InstructionSet OatHeader::GetInstructionSet() const {
   CHECK(IsValid());
   return instruction_set_;
@@ -32,7 +32,8 @@ class InstructionSetFeatures;
 class PACKED(4) OatHeader {
  public:
   static constexpr uint8_t kOatMagic[] = { 'o', 'a', 't', '\n' };
-  static constexpr uint8_t kOatVersion[] = { '0', '7', '9', '\0' };
+  // Version bumped for the register mask table added to the CodeInfo encoding.
+  static constexpr uint8_t kOatVersion[] = { '0', '8', '2', '\0' };
 
   static constexpr const char* kImageLocationKey = "image-location";
   static constexpr const char* kDex2OatCmdLineKey = "dex2oat-cmdline";
@@ -60,6 +61,10 @@ class PACKED(4) OatHeader {
   uint32_t GetChecksum() const;
   void UpdateChecksumWithHeaderData();
   void UpdateChecksum(const void* data, size_t length);
+  // Folds an independently computed adler32 of `length` bytes into the rolling
+  // checksum, as if UpdateChecksum() had been called over those bytes. Allows
+  // callers to checksum large buffers in parallel chunks.
+  void UpdateChecksumWithPartial(uint32_t adler32_checksum, uint64_t length);
   uint32_t GetDexFileCount() const {
     DCHECK(IsValid());
     return dex_file_count_;
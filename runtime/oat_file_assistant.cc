@@ -41,6 +41,7 @@
 #include "scoped_thread_state_change.h"
 #include "ScopedFd.h"
 #include "utils.h"
+#include "verifier/verification_cache.h"
 
 namespace art {
 
@@ -499,10 +500,8 @@ bool OatFileAssistant::GivenOatFileIsOutOfDate(const OatFile& file) {
       break;
     }
 
-    std::string error_msg;
     uint32_t expected_secondary_checksum = 0;
-    if (DexFile::GetChecksum(secondary_dex_location.c_str(),
-          &expected_secondary_checksum, &error_msg)) {
+    if (GetSecondaryDexChecksum(secondary_dex_location, &expected_secondary_checksum)) {
       uint32_t actual_secondary_checksum
         = secondary_oat_dex_file->GetDexFileLocationChecksum();
       if (expected_secondary_checksum != actual_secondary_checksum) {
@@ -710,6 +709,22 @@ OatFileAssistant::GenerateOatFile(CompilerFilter::Filter target, std::string* er
     return kUpdateNotAttempted;
   }
 
+  // If a verification cache from a previous compilation sits next to the oat file, dex2oat
+  // will try to reuse it to skip re-verifying unchanged classes. Drop the cache now if its
+  // content or boot image checksum does not match the current environment so that stale
+  // results cannot be picked up.
+  const std::string cache_file_name =
+      oat_file_name + verifier::VerificationCache::kFileSuffix;
+  if (OS::FileExists(cache_file_name.c_str())) {
+    verifier::VerificationCache cache(cache_file_name);
+    cache.Load();
+    if (cache.GetNumberOfVerifiedClasses() == 0u ||
+        cache.GetBootImageChecksum() != GetCombinedImageChecksum()) {
+      VLOG(oat) << "Removing stale verification cache " << cache_file_name;
+      unlink(cache_file_name.c_str());
+    }
+  }
+
   std::vector<std::string> args;
   args.push_back("--dex-file=" + dex_location_);
   args.push_back("--oat-fd=" + std::to_string(oat_file->Fd()));
@@ -883,6 +898,25 @@ const uint32_t* OatFileAssistant::GetRequiredDexChecksum() {
   return required_dex_checksum_found_ ? &cached_required_dex_checksum_ : nullptr;
 }
 
+bool OatFileAssistant::GetSecondaryDexChecksum(const std::string& dex_location,
+                                               uint32_t* checksum) {
+  auto it = cached_secondary_dex_checksums_.find(dex_location);
+  if (it == cached_secondary_dex_checksums_.end()) {
+    std::string error_msg;
+    uint32_t value = 0;
+    bool found = DexFile::GetChecksum(dex_location.c_str(), &value, &error_msg);
+    if (!found) {
+      VLOG(oat) << "OatFileAssistant: " << error_msg;
+    }
+    it = cached_secondary_dex_checksums_.Put(dex_location, std::make_pair(found, value));
+  }
+  if (!it->second.first) {
+    return false;
+  }
+  *checksum = it->second.second;
+  return true;
+}
+
 const OatFile* OatFileAssistant::GetOdexFile() {
   CHECK(!oat_file_released_) << "OdexFile called after oat file released.";
   if (!odex_file_load_attempted_) {
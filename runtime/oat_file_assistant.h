@@ -28,6 +28,7 @@
 #include "compiler_filter.h"
 #include "oat_file.h"
 #include "os.h"
+#include "safe_map.h"
 #include "profiler.h"
 
 namespace art {
@@ -321,6 +322,12 @@ class OatFileAssistant {
   // found for the dex_location_ dex file.
   const uint32_t* GetRequiredDexChecksum();
 
+  // Gets the dex checksum for the given secondary multidex location, caching
+  // the result so that repeated queries (the out-of-date check runs once for
+  // the odex file and once for the oat file) do not reopen the apk each time.
+  // Returns true and sets *checksum if the checksum was located.
+  bool GetSecondaryDexChecksum(const std::string& dex_location, uint32_t* checksum);
+
   // Returns the loaded odex file.
   // Loads the file if needed. Returns null if the file failed to load.
   // The caller shouldn't clean up or free the returned pointer.
@@ -391,6 +398,12 @@ class OatFileAssistant {
   bool required_dex_checksum_found_;
   bool has_original_dex_files_;
 
+  // Cached checksums of secondary multidex files, keyed by multidex location.
+  // An entry with found == false records that the checksum could not be
+  // obtained, for example because the dex files were stripped from the apk.
+  // This should be accessed only by the GetSecondaryDexChecksum() method.
+  SafeMap<std::string, std::pair<bool, uint32_t>> cached_secondary_dex_checksums_;
+
   // Cached value of the odex file name.
   // This should be accessed only by the OdexFileName() method.
   bool cached_odex_file_name_attempted_ = false;
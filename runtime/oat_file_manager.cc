@@ -478,10 +478,11 @@ bool OatFileManager::HasCollisions(const OatFile* oat_file,
     std::vector<const OatFile*> boot_oat_files = GetBootOatFiles();
     // The same OatFile can be loaded multiple times at different addresses. In this case, we don't
     // need to check both against each other since they would have resolved the same way at compile
-    // time.
+    // time. Note that when rechecking collisions for an already registered oat file that is being
+    // reused for another class loader, the candidate itself is in oat_files_; the location
+    // comparison below keeps it from being compared against itself.
     std::unordered_set<std::string> unique_locations;
     for (const std::unique_ptr<const OatFile>& loaded_oat_file : oat_files_) {
-      DCHECK_NE(loaded_oat_file.get(), oat_file);
       const std::string& location = loaded_oat_file->GetLocation();
       if (std::find(boot_oat_files.begin(), boot_oat_files.end(), loaded_oat_file.get()) ==
           boot_oat_files.end() && location != oat_file->GetLocation() &&
@@ -555,6 +556,33 @@ std::vector<std::unique_ptr<const DexFile>> OatFileManager::OpenDexFilesFromOat(
   Locks::mutator_lock_->AssertNotHeld(self);
   Runtime* const runtime = Runtime::Current();
 
+  // If an oat file covering this dex location is already registered, share that mapping
+  // instead of opening and validating a second copy of the same data. Apps that create
+  // several class loaders over one apk would otherwise map a duplicate instance of the
+  // oat file per loader. The collision check still runs for the new loader's class path,
+  // but against the in-memory instance rather than a fresh mapping read back from disk.
+  const OatFile* reused_oat_file =
+      FindOpenedOatFileFromDexLocation(DexFile::GetBaseLocation(dex_location));
+  if (reused_oat_file != nullptr &&
+      (runtime->IsAotCompiler() || reused_oat_file->IsExecutable())) {
+    std::string collision_error_msg;
+    if (!HasCollisions(reused_oat_file, class_loader, dex_elements, &collision_error_msg)) {
+      std::vector<std::unique_ptr<const DexFile>> reused_dex_files =
+          OatFileAssistant::LoadDexFiles(*reused_oat_file, dex_location);
+      if (!reused_dex_files.empty()) {
+        VLOG(class_linker) << "Reusing registered oat file " << reused_oat_file->GetLocation()
+                           << " for " << dex_location;
+        *out_oat_file = reused_oat_file;
+        runtime->NotifyDexLoaded(dex_location);
+        return reused_dex_files;
+      }
+    } else {
+      VLOG(class_linker) << "Not reusing registered oat file " << reused_oat_file->GetLocation()
+                         << ": " << collision_error_msg;
+    }
+    // Fall through to the regular path, which handles collision fallback and logging.
+  }
+
   OatFileAssistant oat_file_assistant(dex_location,
                                       oat_location,
                                       kRuntimeISA,
@@ -85,6 +85,9 @@ std::unique_ptr<RuntimeParser> ParsedOptions::MakeParser(bool ignore_unrecognize
           .IntoKey(M::Image)
       .Define("-Xcheck:jni")
           .IntoKey(M::CheckJni)
+      .Define("-Xcheck:jni:sample:_")
+          .WithType<unsigned int>()
+          .IntoKey(M::CheckJniSampleInterval)
       .Define("-Xjniopts:forcecopy")
           .IntoKey(M::JniOptsForceCopy)
       .Define({"-Xrunjdwp:_", "-agentlib:jdwp=_"})
@@ -645,6 +648,8 @@ void ParsedOptions::Usage(const char* fmt, ...) {
   UsageMessage(stream, "  -Xrunjdwp:<options>\n");
   UsageMessage(stream, "  -Xbootclasspath:bootclasspath\n");
   UsageMessage(stream, "  -Xcheck:tag  (e.g. 'jni')\n");
+  UsageMessage(stream, "  -Xcheck:jni:sample:integervalue "
+                       "(fully validate only every Nth JNI call per thread)\n");
   UsageMessage(stream, "  -XmsN (min heap, must be multiple of 1K, >= 1MB)\n");
   UsageMessage(stream, "  -XmxN (max heap, must be multiple of 1K, >= 2MB)\n");
   UsageMessage(stream, "  -XssN (stack size)\n");
@@ -33,6 +33,40 @@
 
 namespace art {
 
+// Returns the descriptor of the java.lang box class whose single instance field has the given
+// primitive type, or null if the type has no box class. Dispatching on the field type first
+// means identifying a box class costs one descriptor comparison instead of cascading over all
+// eight box classes.
+static const char* GetBoxedClassDescriptor(Primitive::Type type) {
+  switch (type) {
+    case Primitive::kPrimBoolean: return "Ljava/lang/Boolean;";
+    case Primitive::kPrimByte: return "Ljava/lang/Byte;";
+    case Primitive::kPrimChar: return "Ljava/lang/Character;";
+    case Primitive::kPrimShort: return "Ljava/lang/Short;";
+    case Primitive::kPrimInt: return "Ljava/lang/Integer;";
+    case Primitive::kPrimLong: return "Ljava/lang/Long;";
+    case Primitive::kPrimFloat: return "Ljava/lang/Float;";
+    case Primitive::kPrimDouble: return "Ljava/lang/Double;";
+    default: return nullptr;
+  }
+}
+
+// Returns the primitive type boxed by the class of `o`, or kPrimNot if its class is not one of
+// the box classes. On success *field is set to the field holding the boxed value.
+static Primitive::Type GetBoxedPrimitiveType(mirror::Object* o, ArtField** field)
+    SHARED_REQUIRES(Locks::mutator_lock_) {
+  mirror::Class* klass = o->GetClass();
+  if (klass->NumInstanceFields() != 0u) {
+    ArtField* first_field = klass->GetInstanceField(0);
+    const char* box_descriptor = GetBoxedClassDescriptor(first_field->GetTypeAsPrimitiveType());
+    if (box_descriptor != nullptr && klass->DescriptorEquals(box_descriptor)) {
+      *field = first_field;
+      return first_field->GetTypeAsPrimitiveType();
+    }
+  }
+  return Primitive::kPrimNot;
+}
+
 class ArgArray {
  public:
   ArgArray(const char* shorty, uint32_t shorty_len)
@@ -238,15 +272,21 @@ class ArgArray {
         }
       }
 
-#define DO_FIRST_ARG(match_descriptor, get_fn, append) { \
-          if (LIKELY(arg != nullptr && arg->GetClass<>()->DescriptorEquals(match_descriptor))) { \
-            ArtField* primitive_field = arg->GetClass()->GetInstanceField(0); \
+      // Determine which primitive type the argument boxes, if any. For primitive shorty
+      // characters the argument is known to be non-null here. Each case below then only needs
+      // integer comparisons instead of one descriptor comparison per candidate box class.
+      ArtField* primitive_field = nullptr;
+      Primitive::Type box_type = Primitive::kPrimNot;
+      if (shorty_[i] != 'L') {
+        box_type = GetBoxedPrimitiveType(arg, &primitive_field);
+      }
+
+#define DO_FIRST_ARG(boxed_type, get_fn, append) { \
+          if (LIKELY(box_type == Primitive::boxed_type)) { \
             append(primitive_field-> get_fn(arg));
 
-#define DO_ARG(match_descriptor, get_fn, append) \
-          } else if (LIKELY(arg != nullptr && \
-                            arg->GetClass<>()->DescriptorEquals(match_descriptor))) { \
-            ArtField* primitive_field = arg->GetClass()->GetInstanceField(0); \
+#define DO_ARG(boxed_type, get_fn, append) \
+          } else if (box_type == Primitive::boxed_type) { \
             append(primitive_field-> get_fn(arg));
 
 #define DO_FAIL(expected) \
@@ -271,54 +311,54 @@ class ArgArray {
           Append(arg);
           break;
         case 'Z':
-          DO_FIRST_ARG("Ljava/lang/Boolean;", GetBoolean, Append)
+          DO_FIRST_ARG(kPrimBoolean, GetBoolean, Append)
           DO_FAIL("boolean")
           break;
         case 'B':
-          DO_FIRST_ARG("Ljava/lang/Byte;", GetByte, Append)
+          DO_FIRST_ARG(kPrimByte, GetByte, Append)
           DO_FAIL("byte")
           break;
         case 'C':
-          DO_FIRST_ARG("Ljava/lang/Character;", GetChar, Append)
+          DO_FIRST_ARG(kPrimChar, GetChar, Append)
           DO_FAIL("char")
           break;
         case 'S':
-          DO_FIRST_ARG("Ljava/lang/Short;", GetShort, Append)
-          DO_ARG("Ljava/lang/Byte;", GetByte, Append)
+          DO_FIRST_ARG(kPrimShort, GetShort, Append)
+          DO_ARG(kPrimByte, GetByte, Append)
           DO_FAIL("short")
           break;
         case 'I':
-          DO_FIRST_ARG("Ljava/lang/Integer;", GetInt, Append)
-          DO_ARG("Ljava/lang/Character;", GetChar, Append)
-          DO_ARG("Ljava/lang/Short;", GetShort, Append)
-          DO_ARG("Ljava/lang/Byte;", GetByte, Append)
+          DO_FIRST_ARG(kPrimInt, GetInt, Append)
+          DO_ARG(kPrimChar, GetChar, Append)
+          DO_ARG(kPrimShort, GetShort, Append)
+          DO_ARG(kPrimByte, GetByte, Append)
           DO_FAIL("int")
           break;
         case 'J':
-          DO_FIRST_ARG("Ljava/lang/Long;", GetLong, AppendWide)
-          DO_ARG("Ljava/lang/Integer;", GetInt, AppendWide)
-          DO_ARG("Ljava/lang/Character;", GetChar, AppendWide)
-          DO_ARG("Ljava/lang/Short;", GetShort, AppendWide)
-          DO_ARG("Ljava/lang/Byte;", GetByte, AppendWide)
+          DO_FIRST_ARG(kPrimLong, GetLong, AppendWide)
+          DO_ARG(kPrimInt, GetInt, AppendWide)
+          DO_ARG(kPrimChar, GetChar, AppendWide)
+          DO_ARG(kPrimShort, GetShort, AppendWide)
+          DO_ARG(kPrimByte, GetByte, AppendWide)
           DO_FAIL("long")
           break;
         case 'F':
-          DO_FIRST_ARG("Ljava/lang/Float;", GetFloat, AppendFloat)
-          DO_ARG("Ljava/lang/Long;", GetLong, AppendFloat)
-          DO_ARG("Ljava/lang/Integer;", GetInt, AppendFloat)
-          DO_ARG("Ljava/lang/Character;", GetChar, AppendFloat)
-          DO_ARG("Ljava/lang/Short;", GetShort, AppendFloat)
-          DO_ARG("Ljava/lang/Byte;", GetByte, AppendFloat)
+          DO_FIRST_ARG(kPrimFloat, GetFloat, AppendFloat)
+          DO_ARG(kPrimLong, GetLong, AppendFloat)
+          DO_ARG(kPrimInt, GetInt, AppendFloat)
+          DO_ARG(kPrimChar, GetChar, AppendFloat)
+          DO_ARG(kPrimShort, GetShort, AppendFloat)
+          DO_ARG(kPrimByte, GetByte, AppendFloat)
           DO_FAIL("float")
           break;
         case 'D':
-          DO_FIRST_ARG("Ljava/lang/Double;", GetDouble, AppendDouble)
-          DO_ARG("Ljava/lang/Float;", GetFloat, AppendDouble)
-          DO_ARG("Ljava/lang/Long;", GetLong, AppendDouble)
-          DO_ARG("Ljava/lang/Integer;", GetInt, AppendDouble)
-          DO_ARG("Ljava/lang/Character;", GetChar, AppendDouble)
-          DO_ARG("Ljava/lang/Short;", GetShort, AppendDouble)
-          DO_ARG("Ljava/lang/Byte;", GetByte, AppendDouble)
+          DO_FIRST_ARG(kPrimDouble, GetDouble, AppendDouble)
+          DO_ARG(kPrimFloat, GetFloat, AppendDouble)
+          DO_ARG(kPrimLong, GetLong, AppendDouble)
+          DO_ARG(kPrimInt, GetInt, AppendDouble)
+          DO_ARG(kPrimChar, GetChar, AppendDouble)
+          DO_ARG(kPrimShort, GetShort, AppendDouble)
+          DO_ARG(kPrimByte, GetByte, AppendDouble)
           DO_FAIL("double")
           break;
 #ifndef NDEBUG
@@ -782,42 +822,45 @@ static bool UnboxPrimitive(mirror::Object* o,
   }
 
   JValue boxed_value;
-  mirror::Class* klass = o->GetClass();
   mirror::Class* src_class = nullptr;
   ClassLinker* const class_linker = Runtime::Current()->GetClassLinker();
-  ArtField* primitive_field = &klass->GetIFieldsPtr()->At(0);
-  if (klass->DescriptorEquals("Ljava/lang/Boolean;")) {
-    src_class = class_linker->FindPrimitiveClass('Z');
-    boxed_value.SetZ(primitive_field->GetBoolean(o));
-  } else if (klass->DescriptorEquals("Ljava/lang/Byte;")) {
-    src_class = class_linker->FindPrimitiveClass('B');
-    boxed_value.SetB(primitive_field->GetByte(o));
-  } else if (klass->DescriptorEquals("Ljava/lang/Character;")) {
-    src_class = class_linker->FindPrimitiveClass('C');
-    boxed_value.SetC(primitive_field->GetChar(o));
-  } else if (klass->DescriptorEquals("Ljava/lang/Float;")) {
-    src_class = class_linker->FindPrimitiveClass('F');
-    boxed_value.SetF(primitive_field->GetFloat(o));
-  } else if (klass->DescriptorEquals("Ljava/lang/Double;")) {
-    src_class = class_linker->FindPrimitiveClass('D');
-    boxed_value.SetD(primitive_field->GetDouble(o));
-  } else if (klass->DescriptorEquals("Ljava/lang/Integer;")) {
-    src_class = class_linker->FindPrimitiveClass('I');
-    boxed_value.SetI(primitive_field->GetInt(o));
-  } else if (klass->DescriptorEquals("Ljava/lang/Long;")) {
-    src_class = class_linker->FindPrimitiveClass('J');
-    boxed_value.SetJ(primitive_field->GetLong(o));
-  } else if (klass->DescriptorEquals("Ljava/lang/Short;")) {
-    src_class = class_linker->FindPrimitiveClass('S');
-    boxed_value.SetS(primitive_field->GetShort(o));
-  } else {
-    std::string temp;
-    ThrowIllegalArgumentException(
-        StringPrintf("%s has type %s, got %s", UnboxingFailureKind(f).c_str(),
-            PrettyDescriptor(dst_class).c_str(),
-            PrettyDescriptor(o->GetClass()->GetDescriptor(&temp)).c_str()).c_str());
-    return false;
+  ArtField* primitive_field = nullptr;
+  const Primitive::Type src_type = GetBoxedPrimitiveType(o, &primitive_field);
+  switch (src_type) {
+    case Primitive::kPrimBoolean:
+      boxed_value.SetZ(primitive_field->GetBoolean(o));
+      break;
+    case Primitive::kPrimByte:
+      boxed_value.SetB(primitive_field->GetByte(o));
+      break;
+    case Primitive::kPrimChar:
+      boxed_value.SetC(primitive_field->GetChar(o));
+      break;
+    case Primitive::kPrimShort:
+      boxed_value.SetS(primitive_field->GetShort(o));
+      break;
+    case Primitive::kPrimInt:
+      boxed_value.SetI(primitive_field->GetInt(o));
+      break;
+    case Primitive::kPrimLong:
+      boxed_value.SetJ(primitive_field->GetLong(o));
+      break;
+    case Primitive::kPrimFloat:
+      boxed_value.SetF(primitive_field->GetFloat(o));
+      break;
+    case Primitive::kPrimDouble:
+      boxed_value.SetD(primitive_field->GetDouble(o));
+      break;
+    default: {
+      std::string temp;
+      ThrowIllegalArgumentException(
+          StringPrintf("%s has type %s, got %s", UnboxingFailureKind(f).c_str(),
+              PrettyDescriptor(dst_class).c_str(),
+              PrettyDescriptor(o->GetClass()->GetDescriptor(&temp)).c_str()).c_str());
+      return false;
+    }
   }
+  src_class = class_linker->FindPrimitiveClass(Primitive::Descriptor(src_type)[0]);
 
   return ConvertPrimitiveValue(unbox_for_result,
                                src_class->GetPrimitiveType(), dst_class->GetPrimitiveType(),
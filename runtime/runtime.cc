@@ -63,6 +63,7 @@
 #include "compiler_filter.h"
 #include "debugger.h"
 #include "elf_file.h"
+#include "entrypoints/quick/quick_entrypoint_counters.h"
 #include "entrypoints/runtime_asm_entrypoints.h"
 #include "experimental_flags.h"
 #include "fault_handler.h"
@@ -131,6 +132,7 @@
 #include "signal_set.h"
 #include "thread.h"
 #include "thread_list.h"
+#include "thread_pool.h"
 #include "trace.h"
 #include "transaction.h"
 #include "utils.h"
@@ -904,6 +906,22 @@ void Runtime::SetSentinel(mirror::Object* sentinel) {
   sentinel_ = GcRoot<mirror::Object>(sentinel);
 }
 
+// Interns the boot image strings on a startup worker while the main thread populates the class
+// table, see Runtime::Init.
+class AddImageStringsToTableTask FINAL : public Task {
+ public:
+  void Run(Thread* self) OVERRIDE {
+    ScopedTrace trace("AddImageStringsToTable");
+    ScopedObjectAccess soa(self);
+    Runtime* const runtime = Runtime::Current();
+    runtime->GetInternTable()->AddImagesStringsToTable(runtime->GetHeap()->GetBootImageSpaces());
+  }
+
+  void Finalize() OVERRIDE {
+    delete this;
+  }
+};
+
 bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
   RuntimeArgumentMap runtime_options(std::move(runtime_options_in));
   ScopedTrace trace(__FUNCTION__);
@@ -1058,8 +1076,12 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
   switch (kRuntimeISA) {
     case kArm:
     case kThumb2:
-    case kX86:
     case kArm64:
+      // The ARM fault handlers additionally recognize the implicit suspend check poll
+      // (a load through the suspend trigger pointer) emitted by the compiler.
+      implicit_suspend_checks_ = true;
+      FALLTHROUGH_INTENDED;
+    case kX86:
     case kX86_64:
     case kMips:
     case kMips64:
@@ -1148,12 +1170,16 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
       boot_class_path_string_ = Join(dex_locations, ':');
     }
     {
-      ScopedTrace trace2("AddImageStringsToTable");
-      GetInternTable()->AddImagesStringsToTable(heap_->GetBootImageSpaces());
-    }
-    {
+      // Interning the image strings and moving the image classes into the class table populate
+      // disjoint structures under different locks, so overlap them on a startup worker. Thread
+      // pool workers attach to the runtime before it has started, the same way the dex2oat
+      // compilation pool does.
       ScopedTrace trace2("MoveImageClassesToClassTable");
+      std::unique_ptr<ThreadPool> startup_pool(new ThreadPool("Runtime startup", 1u));
+      startup_pool->AddTask(self, new AddImageStringsToTableTask);
+      startup_pool->StartWorkers(self);
       GetClassLinker()->AddBootImageClassesToClassTable();
+      startup_pool->Wait(self, /* do_work */ true, /* may_hold_locks */ false);
     }
   } else {
     std::vector<std::string> dex_filenames;
@@ -1399,6 +1425,7 @@ void Runtime::DumpForSigQuit(std::ostream& os) {
   GetInternTable()->DumpForSigQuit(os);
   GetJavaVM()->DumpForSigQuit(os);
   GetHeap()->DumpForSigQuit(os);
+  GetMonitorList()->DumpForSigQuit(os);
   oat_file_manager_->DumpForSigQuit(os);
   if (GetJit() != nullptr) {
     GetJit()->DumpForSigQuit(os);
@@ -1406,10 +1433,16 @@ void Runtime::DumpForSigQuit(std::ostream& os) {
     os << "Running non JIT\n";
   }
   TrackedAllocators::Dump(os);
+  DumpEntrypointCounters(os);
   os << "\n";
 
   thread_list_->DumpForSigQuit(os);
   BaseMutex::DumpAll(os);
+  DumpLockContention(os);
+}
+
+void Runtime::DumpLockContention(std::ostream& os) {
+  BaseMutex::DumpContentionRanking(os);
 }
 
 void Runtime::DumpLockHolders(std::ostream& os) {
@@ -1445,6 +1478,10 @@ void Runtime::ResetStats(int kinds) {
   GetStats()->Clear(kinds & 0xffff);
   // TODO: wouldn't it make more sense to clear _all_ threads' stats?
   Thread::Current()->GetStats()->Clear(kinds >> 16);
+  // The entrypoint hit counters have no kind of their own; clear them with any reset.
+  if (kCountEntrypointHits) {
+    ResetEntrypointCounters();
+  }
 }
 
 int32_t Runtime::GetStat(int kind) {
@@ -1879,6 +1916,12 @@ void Runtime::RecordWriteArray(mirror::Array* array, size_t index, uint64_t valu
   preinitialization_transaction_->RecordWriteArray(array, index, value);
 }
 
+void Runtime::RecordWriteArrayRange(mirror::Array* array, size_t start_index, size_t count) const {
+  DCHECK(IsAotCompiler());
+  DCHECK(IsActiveTransaction());
+  preinitialization_transaction_->RecordWriteArrayRange(array, start_index, count);
+}
+
 void Runtime::RecordStrongStringInsertion(mirror::String* s) const {
   DCHECK(IsAotCompiler());
   DCHECK(IsActiveTransaction());
@@ -251,6 +251,9 @@ class Runtime {
   void DumpForSigQuit(std::ostream& os);
   void DumpLockHolders(std::ostream& os);
 
+  // Dump the ranked lock contention table gathered from the per-thread event rings.
+  void DumpLockContention(std::ostream& os);
+
   ~Runtime();
 
   const std::string& GetBootClassPathString() const {
@@ -506,6 +509,8 @@ class Runtime {
                                  mirror::Object* value, bool is_volatile) const;
   void RecordWriteArray(mirror::Array* array, size_t index, uint64_t value) const
       SHARED_REQUIRES(Locks::mutator_lock_);
+  void RecordWriteArrayRange(mirror::Array* array, size_t start_index, size_t count) const
+      SHARED_REQUIRES(Locks::mutator_lock_);
   void RecordStrongStringInsertion(mirror::String* s) const
       REQUIRES(Locks::intern_table_lock_);
   void RecordWeakStringInsertion(mirror::String* s) const
@@ -120,11 +120,13 @@ class ShadowFrame {
            (sizeof(StackReference<mirror::Object>) * num_vregs);
   }
 
-  // Create ShadowFrame in heap for deoptimization.
+  // Create ShadowFrame in heap for deoptimization. Deoptimization reads back
+  // vregs the compiled code may never have written, so the whole frame must
+  // start out zeroed, not just its reference array.
   static ShadowFrame* CreateDeoptimizedFrame(uint32_t num_vregs, ShadowFrame* link,
                                              ArtMethod* method, uint32_t dex_pc) {
     uint8_t* memory = new uint8_t[ComputeSize(num_vregs)];
-    return CreateShadowFrameImpl(num_vregs, link, method, dex_pc, memory);
+    return CreateShadowFrameImpl(num_vregs, link, method, dex_pc, memory, /* zero_vregs */ true);
   }
 
   // Delete a ShadowFrame allocated on the heap for deoptimization.
@@ -141,7 +143,7 @@ class ShadowFrame {
     void* alloca_mem = alloca(frame_size);                                                   \
     ShadowFrameAllocaUniquePtr(                                                              \
         ShadowFrame::CreateShadowFrameImpl((num_vregs), (link), (method), (dex_pc),          \
-                                           (alloca_mem)));                                   \
+                                           (alloca_mem), /* zero_vregs */ false));           \
     })
 
   ~ShadowFrame() {}
@@ -399,8 +401,9 @@ class ShadowFrame {
                                             ShadowFrame* link,
                                             ArtMethod* method,
                                             uint32_t dex_pc,
-                                            void* memory) {
-    return new (memory) ShadowFrame(num_vregs, link, method, dex_pc, true);
+                                            void* memory,
+                                            bool zero_vregs) {
+    return new (memory) ShadowFrame(num_vregs, link, method, dex_pc, true, zero_vregs);
   }
 
   const uint16_t* GetDexPCPtr() {
@@ -413,15 +416,23 @@ class ShadowFrame {
 
  private:
   ShadowFrame(uint32_t num_vregs, ShadowFrame* link, ArtMethod* method,
-              uint32_t dex_pc, bool has_reference_array)
+              uint32_t dex_pc, bool has_reference_array, bool zero_vregs)
       : link_(link), method_(method), result_register_(nullptr), dex_pc_ptr_(nullptr),
         code_item_(nullptr), number_of_vregs_(num_vregs), dex_pc_(dex_pc) {
     // TODO(iam): Remove this parameter, it's an an artifact of portable removal
     DCHECK(has_reference_array);
-    if (has_reference_array) {
+    if (zero_vregs) {
       memset(vregs_, 0, num_vregs * (sizeof(uint32_t) + sizeof(StackReference<mirror::Object>)));
     } else {
-      memset(vregs_, 0, num_vregs * sizeof(uint32_t));
+      // Regular interpreter invocation: the verifier guarantees every vreg is
+      // written before it is read, so only the reference array, which the GC
+      // scans unconditionally, needs to start out zeroed.
+      if (kIsDebugBuild) {
+        // Poison the raw vregs so that a read of a vreg that was never written
+        // fails loudly instead of silently observing zero.
+        memset(vregs_, 0xde, num_vregs * sizeof(uint32_t));
+      }
+      memset(References(), 0, num_vregs * sizeof(StackReference<mirror::Object>));
     }
   }
 
@@ -96,7 +96,7 @@ void StackMapEncoding::Dump(VariableIndentationOutputStream* vios) const {
       << ", dex_pc_bit_offset=" << static_cast<uint32_t>(dex_pc_bit_offset_)
       << ", dex_register_map_bit_offset=" << static_cast<uint32_t>(dex_register_map_bit_offset_)
       << ", inline_info_bit_offset=" << static_cast<uint32_t>(inline_info_bit_offset_)
-      << ", register_mask_bit_offset=" << static_cast<uint32_t>(register_mask_bit_offset_)
+      << ", register_mask_index_bit_offset=" << static_cast<uint32_t>(register_mask_index_bit_offset_)
       << ", stack_mask_bit_offset=" << static_cast<uint32_t>(stack_mask_bit_offset_)
       << ")\n";
 }
@@ -121,6 +121,7 @@ void CodeInfo::Dump(VariableIndentationOutputStream* vios,
   vios->Stream()
       << "Optimized CodeInfo (number_of_dex_registers=" << number_of_dex_registers
       << ", number_of_stack_maps=" << number_of_stack_maps
+      << ", number_of_register_masks=" << GetNumberOfRegisterMasks(encoding)
       << ")\n";
   ScopedIndentation indent1(vios);
   encoding.stack_map_encoding.Dump(vios);
@@ -197,7 +198,7 @@ void StackMap::Dump(VariableIndentationOutputStream* vios,
       << ", native_pc_offset=0x" << GetNativePcOffset(stack_map_encoding)
       << ", dex_register_map_offset=0x" << GetDexRegisterMapOffset(stack_map_encoding)
       << ", inline_info_offset=0x" << GetInlineDescriptorOffset(stack_map_encoding)
-      << ", register_mask=0x" << GetRegisterMask(stack_map_encoding)
+      << ", register_mask=0x" << code_info.GetRegisterMaskOf(encoding, *this)
       << std::dec
       << ", stack_mask=0b";
   for (size_t i = 0, e = GetNumberOfStackMaskBits(stack_map_encoding); i < e; ++i) {
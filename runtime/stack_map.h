@@ -713,7 +713,7 @@ class StackMapEncoding {
                       size_t dex_pc_max,
                       size_t dex_register_map_size,
                       size_t inline_info_size,
-                      size_t register_mask_max,
+                      size_t number_of_register_masks,
                       size_t stack_mask_bit_size) {
     size_t bit_offset = 0;
     DCHECK_EQ(kNativePcBitOffset, bit_offset);
@@ -735,8 +735,13 @@ class StackMapEncoding {
       bit_offset += MinimumBitsToStore(dex_register_map_size + inline_info_size);
     }
 
-    register_mask_bit_offset_ = dchecked_integral_cast<uint8_t>(bit_offset);
-    bit_offset += MinimumBitsToStore(register_mask_max);
+    // Register masks are deduplicated into a table stored in the CodeInfo;
+    // each stack map only stores an index into that table. A method with a
+    // single distinct register mask therefore needs zero bits per stack map.
+    register_mask_index_bit_offset_ = dchecked_integral_cast<uint8_t>(bit_offset);
+    if (number_of_register_masks != 0u) {
+      bit_offset += MinimumBitsToStore(number_of_register_masks - 1);
+    }
 
     stack_mask_bit_offset_ = dchecked_integral_cast<uint8_t>(bit_offset);
     bit_offset += stack_mask_bit_size;
@@ -754,10 +759,11 @@ class StackMapEncoding {
     return FieldEncoding(dex_register_map_bit_offset_, inline_info_bit_offset_, -1 /* min_value */);
   }
   ALWAYS_INLINE FieldEncoding GetInlineInfoEncoding() const {
-    return FieldEncoding(inline_info_bit_offset_, register_mask_bit_offset_, -1 /* min_value */);
+    return FieldEncoding(inline_info_bit_offset_, register_mask_index_bit_offset_,
+                         -1 /* min_value */);
   }
-  ALWAYS_INLINE FieldEncoding GetRegisterMaskEncoding() const {
-    return FieldEncoding(register_mask_bit_offset_, stack_mask_bit_offset_);
+  ALWAYS_INLINE FieldEncoding GetRegisterMaskIndexEncoding() const {
+    return FieldEncoding(register_mask_index_bit_offset_, stack_mask_bit_offset_);
   }
   ALWAYS_INLINE size_t GetStackMaskBitOffset() const {
     // The end offset is not encoded. It is implicitly the end of stack map entry.
@@ -771,7 +777,7 @@ class StackMapEncoding {
   uint8_t dex_pc_bit_offset_;
   uint8_t dex_register_map_bit_offset_;
   uint8_t inline_info_bit_offset_;
-  uint8_t register_mask_bit_offset_;
+  uint8_t register_mask_index_bit_offset_;
   uint8_t stack_mask_bit_offset_;
 };
 
@@ -785,8 +791,11 @@ class StackMapEncoding {
  *
  * The information is of the form:
  *
- *   [native_pc_offset, dex_pc, dex_register_map_offset, inlining_info_offset, register_mask,
- *   stack_mask].
+ *   [native_pc_offset, dex_pc, dex_register_map_offset, inlining_info_offset,
+ *   register_mask_index, stack_mask].
+ *
+ * The register mask index refers to the register mask table stored in the
+ * enclosing CodeInfo; use CodeInfo::GetRegisterMaskOf to read the actual mask.
  */
 class StackMap {
  public:
@@ -827,12 +836,12 @@ class StackMap {
     encoding.GetInlineInfoEncoding().Store(region_, offset);
   }
 
-  ALWAYS_INLINE uint32_t GetRegisterMask(const StackMapEncoding& encoding) const {
-    return encoding.GetRegisterMaskEncoding().Load(region_);
+  ALWAYS_INLINE uint32_t GetRegisterMaskIndex(const StackMapEncoding& encoding) const {
+    return encoding.GetRegisterMaskIndexEncoding().Load(region_);
   }
 
-  ALWAYS_INLINE void SetRegisterMask(const StackMapEncoding& encoding, uint32_t mask) {
-    encoding.GetRegisterMaskEncoding().Store(region_, mask);
+  ALWAYS_INLINE void SetRegisterMaskIndex(const StackMapEncoding& encoding, uint32_t index) {
+    encoding.GetRegisterMaskIndexEncoding().Store(region_, index);
   }
 
   ALWAYS_INLINE size_t GetNumberOfStackMaskBits(const StackMapEncoding& encoding) const {
@@ -1021,8 +1030,15 @@ class InlineInfo {
 struct CodeInfoEncoding {
   uint32_t non_header_size;
   uint32_t number_of_stack_maps;
+  // Number of leading stack maps sorted by native pc offset. Safepoint stack maps are
+  // emitted in code order and can be binary searched; catch stack maps are stored at the
+  // end of the list and may break the ordering.
+  uint32_t number_of_sorted_stack_maps;
   uint32_t stack_map_size_in_bytes;
   uint32_t number_of_location_catalog_entries;
+  // Number of entries in the register mask table following the stack maps.
+  // Stack maps store an index into this table instead of the full mask.
+  uint32_t number_of_register_masks;
   StackMapEncoding stack_map_encoding;
   InlineInfoEncoding inline_info_encoding;
   uint8_t header_size;
@@ -1033,8 +1049,10 @@ struct CodeInfoEncoding {
     const uint8_t* ptr = reinterpret_cast<const uint8_t*>(data);
     non_header_size = DecodeUnsignedLeb128(&ptr);
     number_of_stack_maps = DecodeUnsignedLeb128(&ptr);
+    number_of_sorted_stack_maps = DecodeUnsignedLeb128(&ptr);
     stack_map_size_in_bytes = DecodeUnsignedLeb128(&ptr);
     number_of_location_catalog_entries = DecodeUnsignedLeb128(&ptr);
+    number_of_register_masks = DecodeUnsignedLeb128(&ptr);
     static_assert(alignof(StackMapEncoding) == 1,
                   "StackMapEncoding should not require alignment");
     stack_map_encoding = *reinterpret_cast<const StackMapEncoding*>(ptr);
@@ -1054,8 +1072,10 @@ struct CodeInfoEncoding {
   void Compress(Vector* dest) const {
     EncodeUnsignedLeb128(dest, non_header_size);
     EncodeUnsignedLeb128(dest, number_of_stack_maps);
+    EncodeUnsignedLeb128(dest, number_of_sorted_stack_maps);
     EncodeUnsignedLeb128(dest, stack_map_size_in_bytes);
     EncodeUnsignedLeb128(dest, number_of_location_catalog_entries);
+    EncodeUnsignedLeb128(dest, number_of_register_masks);
     const uint8_t* stack_map_ptr = reinterpret_cast<const uint8_t*>(&stack_map_encoding);
     dest->insert(dest->end(), stack_map_ptr, stack_map_ptr + sizeof(StackMapEncoding));
     if (stack_map_encoding.GetInlineInfoEncoding().BitSize() > 0) {
@@ -1069,12 +1089,13 @@ struct CodeInfoEncoding {
  * Wrapper around all compiler information collected for a method.
  * The information is of the form:
  *
- *   [CodeInfoEncoding, StackMap+, DexRegisterLocationCatalog+, DexRegisterMap+, InlineInfo*]
+ *   [CodeInfoEncoding, StackMap+, RegisterMask+, DexRegisterLocationCatalog+,
+ *    DexRegisterMap+, InlineInfo*]
  *
  * where CodeInfoEncoding is of the form:
  *
  *   [non_header_size, number_of_stack_maps, stack_map_size_in_bytes,
- *    number_of_location_catalog_entries, StackMapEncoding]
+ *    number_of_location_catalog_entries, number_of_register_masks, StackMapEncoding]
  */
 class CodeInfo {
  public:
@@ -1124,10 +1145,32 @@ class CodeInfo {
     return encoding.stack_map_size_in_bytes * GetNumberOfStackMaps(encoding);
   }
 
-  uint32_t GetDexRegisterLocationCatalogOffset(const CodeInfoEncoding& encoding) const {
+  uint32_t GetNumberOfRegisterMasks(const CodeInfoEncoding& encoding) const {
+    return encoding.number_of_register_masks;
+  }
+
+  // Get the size of the register mask table of this CodeInfo object, in bytes.
+  size_t GetRegisterMasksSize(const CodeInfoEncoding& encoding) const {
+    return encoding.number_of_register_masks * sizeof(uint32_t);
+  }
+
+  uint32_t GetRegisterMasksOffset(const CodeInfoEncoding& encoding) const {
     return GetStackMapsOffset(encoding) + GetStackMapsSize(encoding);
   }
 
+  // Read the register mask of `stack_map` through the register mask table.
+  ALWAYS_INLINE uint32_t GetRegisterMaskOf(const CodeInfoEncoding& encoding,
+                                           const StackMap& stack_map) const {
+    uint32_t index = stack_map.GetRegisterMaskIndex(encoding.stack_map_encoding);
+    DCHECK_LT(index, encoding.number_of_register_masks);
+    return region_.LoadUnaligned<uint32_t>(
+        GetRegisterMasksOffset(encoding) + index * sizeof(uint32_t));
+  }
+
+  uint32_t GetDexRegisterLocationCatalogOffset(const CodeInfoEncoding& encoding) const {
+    return GetRegisterMasksOffset(encoding) + GetRegisterMasksSize(encoding);
+  }
+
   size_t GetDexRegisterMapsOffset(const CodeInfoEncoding& encoding) const {
     return GetDexRegisterLocationCatalogOffset(encoding)
          + GetDexRegisterLocationCatalogSize(encoding);
@@ -1227,12 +1270,32 @@ class CodeInfo {
 
   StackMap GetStackMapForNativePcOffset(uint32_t native_pc_offset,
                                         const CodeInfoEncoding& encoding) const {
-    // TODO: Safepoint stack maps are sorted by native_pc_offset but catch stack
-    //       maps are not. If we knew that the method does not have try/catch,
-    //       we could do binary search.
-    for (size_t i = 0, e = GetNumberOfStackMaps(encoding); i < e; ++i) {
+    // Binary search the sorted prefix of the stack map list (safepoint stack maps in code
+    // order) for the first entry with a native pc offset no smaller than the sought one,
+    // which is what the former linear scan would have found.
+    const StackMapEncoding& stack_map_encoding = encoding.stack_map_encoding;
+    const size_t number_of_sorted = encoding.number_of_sorted_stack_maps;
+    DCHECK_LE(number_of_sorted, GetNumberOfStackMaps(encoding));
+    size_t left = 0;
+    size_t right = number_of_sorted;
+    while (left != right) {
+      size_t mid = (left + right) / 2;
+      if (GetStackMapAt(mid, encoding).GetNativePcOffset(stack_map_encoding) < native_pc_offset) {
+        left = mid + 1;
+      } else {
+        right = mid;
+      }
+    }
+    if (left != number_of_sorted) {
+      StackMap stack_map = GetStackMapAt(left, encoding);
+      if (stack_map.GetNativePcOffset(stack_map_encoding) == native_pc_offset) {
+        return stack_map;
+      }
+    }
+    // Fall back to scanning the unsorted suffix, i.e. catch stack maps.
+    for (size_t i = number_of_sorted, e = GetNumberOfStackMaps(encoding); i < e; ++i) {
       StackMap stack_map = GetStackMapAt(i, encoding);
-      if (stack_map.GetNativePcOffset(encoding.stack_map_encoding) == native_pc_offset) {
+      if (stack_map.GetNativePcOffset(stack_map_encoding) == native_pc_offset) {
         return stack_map;
       }
     }
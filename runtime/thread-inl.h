@@ -277,6 +277,7 @@ inline void Thread::RevokeThreadLocalAllocationStack() {
   }
   tlsPtr_.thread_local_alloc_stack_end = nullptr;
   tlsPtr_.thread_local_alloc_stack_top = nullptr;
+  thread_local_alloc_stack_refill_size_ = kInitialThreadLocalAllocStackSize;
 }
 
 }  // namespace art
@@ -55,6 +55,7 @@
 #include "mirror/object_array-inl.h"
 #include "mirror/stack_trace_element.h"
 #include "monitor.h"
+#include "monitor_pool.h"
 #include "oat_quick_method_header.h"
 #include "object_lock.h"
 #include "quick_exception_handler.h"
@@ -630,10 +631,10 @@ void Thread::CreateNativeThread(JNIEnv* env, jobject java_peer, size_t stack_siz
   env->SetLongField(java_peer, WellKnownClasses::java_lang_Thread_nativePeer,
                     reinterpret_cast<jlong>(child_thread));
 
-  // Try to allocate a JNIEnvExt for the thread. We do this here as we might be out of memory and
+  // Try to acquire a JNIEnvExt for the thread. We do this here as we might be out of memory and
   // do not have a good way to report this on the child's side.
   std::unique_ptr<JNIEnvExt> child_jni_env_ext(
-      JNIEnvExt::Create(child_thread, Runtime::Current()->GetJavaVM()));
+      runtime->GetJavaVM()->AcquireEnv(self, child_thread));
 
   int pthread_create_result = 0;
   if (child_jni_env_ext.get() != nullptr) {
@@ -660,7 +661,7 @@ void Thread::CreateNativeThread(JNIEnv* env, jobject java_peer, size_t stack_siz
     }
   }
 
-  // Either JNIEnvExt::Create or pthread_create(3) failed, so clean up.
+  // Either JavaVMExt::AcquireEnv or pthread_create(3) failed, so clean up.
   {
     MutexLock mu(self, *Locks::runtime_shutdown_lock_);
     runtime->EndThreadBirth();
@@ -680,6 +681,10 @@ void Thread::CreateNativeThread(JNIEnv* env, jobject java_peer, size_t stack_siz
     ScopedObjectAccess soa(env);
     soa.Self()->ThrowOutOfMemoryError(msg.c_str());
   }
+  if (child_jni_env_ext.get() != nullptr) {
+    // The environment was never used by the stillborn thread; recycle it.
+    runtime->GetJavaVM()->ReleaseEnv(child_jni_env_ext.release());
+  }
 }
 
 bool Thread::Init(ThreadList* thread_list, JavaVMExt* java_vm, JNIEnvExt* jni_env_ext) {
@@ -719,7 +724,7 @@ bool Thread::Init(ThreadList* thread_list, JavaVMExt* java_vm, JNIEnvExt* jni_en
     DCHECK_EQ(jni_env_ext->self, this);
     tlsPtr_.jni_env = jni_env_ext;
   } else {
-    tlsPtr_.jni_env = JNIEnvExt::Create(this, java_vm);
+    tlsPtr_.jni_env = java_vm->AcquireEnv(this, this);
     if (tlsPtr_.jni_env == nullptr) {
       return false;
     }
@@ -952,9 +957,10 @@ void Thread::ShortDump(std::ostream& os) const {
      << "]";
 }
 
-void Thread::Dump(std::ostream& os, bool dump_native_stack, BacktraceMap* backtrace_map) const {
+void Thread::Dump(std::ostream& os, bool dump_native_stack, BacktraceMap* backtrace_map,
+                  FrameDescriptionCache* frame_cache) const {
   DumpState(os);
-  DumpStack(os, dump_native_stack, backtrace_map);
+  DumpStack(os, dump_native_stack, backtrace_map, frame_cache);
 }
 
 mirror::String* Thread::GetThreadName(const ScopedObjectAccessAlreadyRunnable& soa) const {
@@ -1350,12 +1356,60 @@ void Thread::DumpState(std::ostream& os) const {
   Thread::DumpState(os, this, GetTid());
 }
 
+// Renders the "method(SourceFile:line)" text of a stack frame, also yielding the line number
+// for the repetition detection in StackDumpVisitor.
+static std::string DescribeStackFrame(ArtMethod* m, uint32_t dex_pc, /*out*/ int* line_number)
+    SHARED_REQUIRES(Locks::mutator_lock_) {
+  mirror::Class* c = m->GetDeclaringClass();
+  mirror::DexCache* dex_cache = c->GetDexCache();
+  *line_number = -1;
+  if (dex_cache != nullptr) {  // be tolerant of bad input
+    const DexFile& dex_file = *dex_cache->GetDexFile();
+    *line_number = dex_file.GetLineNumFromPC(m, dex_pc);
+  }
+  std::ostringstream oss;
+  oss << PrettyMethod(m, false);
+  if (m->IsNative()) {
+    oss << "(Native method)";
+  } else {
+    const char* source_file(m->GetDeclaringClassSourceFile());
+    oss << "(" << (source_file != nullptr ? source_file : "unavailable")
+        << ":" << *line_number << ")";
+  }
+  return oss.str();
+}
+
+std::string FrameDescriptionCache::GetDescription(ArtMethod* m, uint32_t dex_pc,
+                                                  /*out*/ int* line_number) {
+  const std::pair<ArtMethod*, uint32_t> key(m, dex_pc);
+  {
+    MutexLock mu(Thread::Current(), lock_);
+    auto it = cache_.find(key);
+    if (it != cache_.end()) {
+      *line_number = it->second.line_number;
+      return it->second.description;
+    }
+  }
+  // Render outside the lock; the method name and line number resolution are the slow parts.
+  Entry entry;
+  entry.description = DescribeStackFrame(m, dex_pc, &entry.line_number);
+  *line_number = entry.line_number;
+  {
+    // Two threads may race to render the same frame; both produce the same text.
+    MutexLock mu(Thread::Current(), lock_);
+    cache_.emplace(key, entry);
+  }
+  return entry.description;
+}
+
 struct StackDumpVisitor : public StackVisitor {
-  StackDumpVisitor(std::ostream& os_in, Thread* thread_in, Context* context, bool can_allocate_in)
+  StackDumpVisitor(std::ostream& os_in, Thread* thread_in, Context* context, bool can_allocate_in,
+                   FrameDescriptionCache* frame_cache_in)
       SHARED_REQUIRES(Locks::mutator_lock_)
       : StackVisitor(thread_in, context, StackVisitor::StackWalkKind::kIncludeInlinedFrames),
         os(os_in),
         can_allocate(can_allocate_in),
+        frame_cache(frame_cache_in),
         last_method(nullptr),
         last_line_number(0),
         repetition_count(0),
@@ -1374,13 +1428,11 @@ struct StackDumpVisitor : public StackVisitor {
     }
     m = m->GetInterfaceMethodIfProxy(sizeof(void*));
     const int kMaxRepetition = 3;
-    mirror::Class* c = m->GetDeclaringClass();
-    mirror::DexCache* dex_cache = c->GetDexCache();
-    int line_number = -1;
-    if (dex_cache != nullptr) {  // be tolerant of bad input
-      const DexFile& dex_file = *dex_cache->GetDexFile();
-      line_number = dex_file.GetLineNumFromPC(m, GetDexPc(false));
-    }
+    const uint32_t dex_pc = GetDexPc(false);
+    int line_number;
+    const std::string description = (frame_cache != nullptr)
+        ? frame_cache->GetDescription(m, dex_pc, &line_number)
+        : DescribeStackFrame(m, dex_pc, &line_number);
     if (line_number == last_line_number && last_method == m) {
       ++repetition_count;
     } else {
@@ -1392,15 +1444,7 @@ struct StackDumpVisitor : public StackVisitor {
       last_method = m;
     }
     if (repetition_count < kMaxRepetition) {
-      os << "  at " << PrettyMethod(m, false);
-      if (m->IsNative()) {
-        os << "(Native method)";
-      } else {
-        const char* source_file(m->GetDeclaringClassSourceFile());
-        os << "(" << (source_file != nullptr ? source_file : "unavailable")
-           << ":" << line_number << ")";
-      }
-      os << "\n";
+      os << "  at " << description << "\n";
       if (frame_count == 0) {
         Monitor::DescribeWait(os, GetThread());
       }
@@ -1439,6 +1483,7 @@ struct StackDumpVisitor : public StackVisitor {
 
   std::ostream& os;
   const bool can_allocate;
+  FrameDescriptionCache* const frame_cache;
   ArtMethod* last_method;
   int last_line_number;
   int repetition_count;
@@ -1474,7 +1519,7 @@ static bool ShouldShowNativeStack(const Thread* thread)
   return current_method != nullptr && current_method->IsNative();
 }
 
-void Thread::DumpJavaStack(std::ostream& os) const {
+void Thread::DumpJavaStack(std::ostream& os, FrameDescriptionCache* frame_cache) const {
   // If flip_function is not null, it means we have run a checkpoint
   // before the thread wakes up to execute the flip function and the
   // thread roots haven't been forwarded.  So the following access to
@@ -1503,7 +1548,7 @@ void Thread::DumpJavaStack(std::ostream& os) const {
 
   std::unique_ptr<Context> context(Context::Create());
   StackDumpVisitor dumper(os, const_cast<Thread*>(this), context.get(),
-                          !tls32_.throwing_OutOfMemoryError);
+                          !tls32_.throwing_OutOfMemoryError, frame_cache);
   dumper.WalkStack();
 
   if (have_exception) {
@@ -1513,7 +1558,8 @@ void Thread::DumpJavaStack(std::ostream& os) const {
 
 void Thread::DumpStack(std::ostream& os,
                        bool dump_native_stack,
-                       BacktraceMap* backtrace_map) const {
+                       BacktraceMap* backtrace_map,
+                       FrameDescriptionCache* frame_cache) const {
   // TODO: we call this code when dying but may not have suspended the thread ourself. The
   //       IsSuspended check is therefore racy with the use for dumping (normally we inhibit
   //       the race with the thread_suspend_count_lock_).
@@ -1531,7 +1577,7 @@ void Thread::DumpStack(std::ostream& os,
       ArtMethod* method = GetCurrentMethod(nullptr, !dump_for_abort);
       DumpNativeStack(os, GetTid(), backtrace_map, "  native: ", method);
     }
-    DumpJavaStack(os);
+    DumpJavaStack(os, frame_cache);
   } else {
     os << "Not able to dump stack of thread that isn't suspended";
   }
@@ -1747,6 +1793,9 @@ void Thread::Destroy() {
       Runtime::Current()->GetHeap()->ConcurrentCopyingCollector()->RevokeThreadLocalMarkStack(this);
     }
   }
+
+  // Return any cached free monitor storage to the central pool.
+  MonitorPool::FlushMonitorCache(this);
 }
 
 Thread::~Thread() {
@@ -1755,7 +1804,9 @@ Thread::~Thread() {
   CHECK(tlsPtr_.opeer == nullptr);
   bool initialized = (tlsPtr_.jni_env != nullptr);  // Did Thread::Init run?
   if (initialized) {
-    delete tlsPtr_.jni_env;
+    // Hand the environment back for reuse by a future attach; the pool deletes it if it
+    // cannot be recycled.
+    tlsPtr_.jni_env->vm->ReleaseEnv(tlsPtr_.jni_env);
     tlsPtr_.jni_env = nullptr;
   }
   CHECK_NE(GetState(), kRunnable);
@@ -1776,6 +1827,7 @@ Thread::~Thread() {
 
   delete wait_cond_;
   delete wait_mutex_;
+  delete contention_event_ring_;
 
   if (tlsPtr_.long_jump_context != nullptr) {
     delete tlsPtr_.long_jump_context;
@@ -1791,6 +1843,7 @@ Thread::~Thread() {
   delete tlsPtr_.instrumentation_stack;
   delete tlsPtr_.name;
   delete tlsPtr_.stack_trace_sample;
+  delete[] tlsPtr_.method_trace_buffer;
   free(tlsPtr_.nested_signal_state);
 
   Runtime::Current()->GetHeap()->AssertThreadLocalBuffersAreRevoked(this);
@@ -2011,130 +2064,93 @@ class CountStackDepthVisitor : public StackVisitor {
   DISALLOW_COPY_AND_ASSIGN(CountStackDepthVisitor);
 };
 
-template<bool kTransactionActive>
-class BuildInternalStackTraceVisitor : public StackVisitor {
+// Visits the stack once, recording the method and dex pc of every interesting frame, so that
+// Thread::CreateInternalStackTrace() can size and fill in the trace arrays without a second
+// stack walk. ArtMethod pointers are never moved by the GC and the recorded methods stay on
+// the walked stack while the trace is built, so keeping raw pointers is safe.
+class FetchStackTraceVisitor : public StackVisitor {
  public:
-  BuildInternalStackTraceVisitor(Thread* self, Thread* thread, int skip_depth)
+  explicit FetchStackTraceVisitor(Thread* thread)
+      SHARED_REQUIRES(Locks::mutator_lock_)
       : StackVisitor(thread, nullptr, StackVisitor::StackWalkKind::kIncludeInlinedFrames),
-        self_(self),
-        skip_depth_(skip_depth),
-        count_(0),
-        trace_(nullptr),
-        pointer_size_(Runtime::Current()->GetClassLinker()->GetImagePointerSize()) {}
-
-  bool Init(int depth) SHARED_REQUIRES(Locks::mutator_lock_) ACQUIRE(Roles::uninterruptible_) {
-    // Allocate method trace as an object array where the first element is a pointer array that
-    // contains the ArtMethod pointers and dex PCs. The rest of the elements are the declaring
-    // class of the ArtMethod pointers.
-    ClassLinker* class_linker = Runtime::Current()->GetClassLinker();
-    StackHandleScope<1> hs(self_);
-    mirror::Class* array_class = class_linker->GetClassRoot(ClassLinker::kObjectArrayClass);
-    // The first element is the methods and dex pc array, the other elements are declaring classes
-    // for the methods to ensure classes in the stack trace don't get unloaded.
-    Handle<mirror::ObjectArray<mirror::Object>> trace(
-        hs.NewHandle(
-            mirror::ObjectArray<mirror::Object>::Alloc(hs.Self(), array_class, depth + 1)));
-    if (trace.Get() == nullptr) {
-      // Acquire uninterruptible_ in all paths.
-      self_->StartAssertNoThreadSuspension("Building internal stack trace");
-      self_->AssertPendingOOMException();
-      return false;
-    }
-    mirror::PointerArray* methods_and_pcs = class_linker->AllocPointerArray(self_, depth * 2);
-    const char* last_no_suspend_cause =
-        self_->StartAssertNoThreadSuspension("Building internal stack trace");
-    if (methods_and_pcs == nullptr) {
-      self_->AssertPendingOOMException();
-      return false;
-    }
-    trace->Set(0, methods_and_pcs);
-    trace_ = trace.Get();
-    // If We are called from native, use non-transactional mode.
-    CHECK(last_no_suspend_cause == nullptr) << last_no_suspend_cause;
-    return true;
-  }
-
-  virtual ~BuildInternalStackTraceVisitor() RELEASE(Roles::uninterruptible_) {
-    self_->EndAssertNoThreadSuspension(nullptr);
-  }
+        skipping_(true) {}
 
   bool VisitFrame() SHARED_REQUIRES(Locks::mutator_lock_) {
-    if (trace_ == nullptr) {
-      return true;  // We're probably trying to fillInStackTrace for an OutOfMemoryError.
+    // We want to skip frames up to and including the exception's constructor.
+    ArtMethod* m = GetMethod();
+    if (skipping_ && !m->IsRuntimeMethod() &&
+        !mirror::Throwable::GetJavaLangThrowable()->IsAssignableFrom(m->GetDeclaringClass())) {
+      skipping_ = false;
     }
-    if (skip_depth_ > 0) {
-      skip_depth_--;
-      return true;
+    if (!skipping_ && !m->IsRuntimeMethod()) {  // Ignore runtime frames (in particular callee save).
+      methods_.push_back(m);
+      dex_pcs_.push_back(m->IsProxyMethod() ? DexFile::kDexNoIndex : GetDexPc());
     }
-    ArtMethod* m = GetMethod();
-    if (m->IsRuntimeMethod()) {
-      return true;  // Ignore runtime frames (in particular callee save).
-    }
-    mirror::PointerArray* trace_methods_and_pcs = GetTraceMethodsAndPCs();
-    trace_methods_and_pcs->SetElementPtrSize<kTransactionActive>(count_, m, pointer_size_);
-    trace_methods_and_pcs->SetElementPtrSize<kTransactionActive>(
-        trace_methods_and_pcs->GetLength() / 2 + count_,
-        m->IsProxyMethod() ? DexFile::kDexNoIndex : GetDexPc(),
-        pointer_size_);
-    // Save the declaring class of the method to ensure that the declaring classes of the methods
-    // do not get unloaded while the stack trace is live.
-    trace_->Set(count_ + 1, m->GetDeclaringClass());
-    ++count_;
     return true;
   }
 
-  mirror::PointerArray* GetTraceMethodsAndPCs() const SHARED_REQUIRES(Locks::mutator_lock_) {
-    return down_cast<mirror::PointerArray*>(trace_->Get(0));
+  const std::vector<ArtMethod*>& GetMethods() const {
+    return methods_;
   }
 
-  mirror::ObjectArray<mirror::Object>* GetInternalStackTrace() const {
-    return trace_;
+  const std::vector<uint32_t>& GetDexPcs() const {
+    return dex_pcs_;
   }
 
  private:
-  Thread* const self_;
-  // How many more frames to skip.
-  int32_t skip_depth_;
-  // Current position down stack trace.
-  uint32_t count_;
-  // An object array where the first element is a pointer array that contains the ArtMethod
-  // pointers on the stack and dex PCs. The rest of the elements are the declaring
-  // class of the ArtMethod pointers. trace_[i+1] contains the declaring class of the ArtMethod of
-  // the i'th frame.
-  mirror::ObjectArray<mirror::Object>* trace_;
-  // For cross compilation.
-  const size_t pointer_size_;
-
-  DISALLOW_COPY_AND_ASSIGN(BuildInternalStackTraceVisitor);
+  std::vector<ArtMethod*> methods_;
+  std::vector<uint32_t> dex_pcs_;
+  bool skipping_;
+
+  DISALLOW_COPY_AND_ASSIGN(FetchStackTraceVisitor);
 };
 
 template<bool kTransactionActive>
 jobject Thread::CreateInternalStackTrace(const ScopedObjectAccessAlreadyRunnable& soa) const {
-  // Compute depth of stack
-  CountStackDepthVisitor count_visitor(const_cast<Thread*>(this));
-  count_visitor.WalkStack();
-  int32_t depth = count_visitor.GetDepth();
-  int32_t skip_depth = count_visitor.GetSkipDepth();
-
-  // Build internal stack trace.
-  BuildInternalStackTraceVisitor<kTransactionActive> build_trace_visitor(soa.Self(),
-                                                                         const_cast<Thread*>(this),
-                                                                         skip_depth);
-  if (!build_trace_visitor.Init(depth)) {
-    return nullptr;  // Allocation failed.
-  }
-  build_trace_visitor.WalkStack();
-  mirror::ObjectArray<mirror::Object>* trace = build_trace_visitor.GetInternalStackTrace();
-  if (kIsDebugBuild) {
-    mirror::PointerArray* trace_methods = build_trace_visitor.GetTraceMethodsAndPCs();
-    // Second half of trace_methods is dex PCs.
-    for (uint32_t i = 0; i < static_cast<uint32_t>(trace_methods->GetLength() / 2); ++i) {
-      auto* method = trace_methods->GetElementPtrSize<ArtMethod*>(
-          i, Runtime::Current()->GetClassLinker()->GetImagePointerSize());
-      CHECK(method != nullptr);
-    }
+  // Walk the stack once, recording the method and dex pc of each interesting frame.
+  FetchStackTraceVisitor fetch_visitor(const_cast<Thread*>(this));
+  fetch_visitor.WalkStack();
+  const std::vector<ArtMethod*>& methods = fetch_visitor.GetMethods();
+  const std::vector<uint32_t>& dex_pcs = fetch_visitor.GetDexPcs();
+  const int32_t depth = methods.size();
+
+  // Allocate method trace as an object array where the first element is a pointer array that
+  // contains the ArtMethod pointers and dex PCs. The rest of the elements are the declaring
+  // classes of the ArtMethod pointers.
+  Thread* const self = soa.Self();
+  ClassLinker* class_linker = Runtime::Current()->GetClassLinker();
+  StackHandleScope<1> hs(self);
+  mirror::Class* array_class = class_linker->GetClassRoot(ClassLinker::kObjectArrayClass);
+  Handle<mirror::ObjectArray<mirror::Object>> trace(
+      hs.NewHandle(mirror::ObjectArray<mirror::Object>::Alloc(self, array_class, depth + 1)));
+  if (trace.Get() == nullptr) {
+    self->AssertPendingOOMException();
+    return nullptr;
+  }
+  mirror::PointerArray* methods_and_pcs = class_linker->AllocPointerArray(self, depth * 2);
+  if (methods_and_pcs == nullptr) {
+    self->AssertPendingOOMException();
+    return nullptr;
+  }
+  trace->Set(0, methods_and_pcs);
+
+  // Fill in the trace. Nothing below allocates, so the raw methods_and_pcs pointer stays
+  // valid. The recorded methods are still on the walked stack, which keeps their declaring
+  // classes alive across the allocations above.
+  const char* old_cause = self->StartAssertNoThreadSuspension("Building internal stack trace");
+  CHECK(old_cause == nullptr) << old_cause;
+  const size_t pointer_size = class_linker->GetImagePointerSize();
+  for (int32_t i = 0; i < depth; ++i) {
+    ArtMethod* m = methods[i];
+    DCHECK(m != nullptr);
+    methods_and_pcs->SetElementPtrSize<kTransactionActive>(i, m, pointer_size);
+    methods_and_pcs->SetElementPtrSize<kTransactionActive>(depth + i, dex_pcs[i], pointer_size);
+    // Save the declaring class of the method to ensure that the declaring classes of the
+    // methods do not get unloaded while the stack trace is live.
+    trace->Set(i + 1, m->GetDeclaringClass());
   }
-  return soa.AddLocalReference<jobject>(trace);
+  self->EndAssertNoThreadSuspension(nullptr);
+  return soa.AddLocalReference<jobject>(trace.Get());
 }
 template jobject Thread::CreateInternalStackTrace<false>(
     const ScopedObjectAccessAlreadyRunnable& soa) const;
@@ -2489,6 +2505,9 @@ void Thread::DumpThreadOffset(std::ostream& os, uint32_t offset) {
   QUICK_ENTRY_POINT_INFO(pJniMethodEndSynchronized)
   QUICK_ENTRY_POINT_INFO(pJniMethodEndWithReference)
   QUICK_ENTRY_POINT_INFO(pJniMethodEndWithReferenceSynchronized)
+  QUICK_ENTRY_POINT_INFO(pJniMethodFastStart)
+  QUICK_ENTRY_POINT_INFO(pJniMethodFastEnd)
+  QUICK_ENTRY_POINT_INFO(pJniMethodFastEndWithReference)
   QUICK_ENTRY_POINT_INFO(pQuickGenericJniTrampoline)
   QUICK_ENTRY_POINT_INFO(pLockObject)
   QUICK_ENTRY_POINT_INFO(pUnlockObject)
@@ -2790,7 +2809,7 @@ class ReferenceMapVisitor : public StackVisitor {
         }
       }
       // Visit callee-save registers that hold pointers.
-      uint32_t register_mask = map.GetRegisterMask(encoding.stack_map_encoding);
+      uint32_t register_mask = code_info.GetRegisterMaskOf(encoding, map);
       for (size_t i = 0; i < BitSizeOf<uint32_t>(); ++i) {
         if (register_mask & (1 << i)) {
           mirror::Object** ref_addr = reinterpret_cast<mirror::Object**>(GetGPRAddress(i));
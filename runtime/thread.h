@@ -21,6 +21,7 @@
 #include <deque>
 #include <iosfwd>
 #include <list>
+#include <map>
 #include <memory>
 #include <setjmp.h>
 #include <string>
@@ -35,6 +36,7 @@
 #include "globals.h"
 #include "handle_scope.h"
 #include "instrumentation.h"
+#include "interpreter/interpreter_cache.h"
 #include "jvalue.h"
 #include "object_callbacks.h"
 #include "offsets.h"
@@ -83,6 +85,7 @@ class DexFile;
 class FrameIdToShadowFrame;
 class JavaVMExt;
 struct JNIEnvExt;
+class LinearAlloc;
 class Monitor;
 class Runtime;
 class ScopedObjectAccessAlreadyRunnable;
@@ -144,6 +147,30 @@ static constexpr size_t kNumRosAllocThreadLocalSizeBracketsInThread = 16;
 // if the thread makes a call out to a native function (through JNI), that native function
 // might only have 4K of memory (if the SP is adjacent to stack_end).
 
+// Memoizes rendered stack frame descriptions (method, source file and line number) for
+// Thread::Dump. The threads dumped on SIGQUIT largely share frames (e.g. pool threads parked
+// in identical code), so the dump checkpoint hands the same cache to every thread and each
+// distinct frame is resolved only once per dump.
+class FrameDescriptionCache {
+ public:
+  FrameDescriptionCache() : lock_("frame description cache lock") {}
+
+  // Returns the "method(SourceFile:line)" text for the frame, rendering it on first use.
+  std::string GetDescription(ArtMethod* m, uint32_t dex_pc, /*out*/ int* line_number)
+      SHARED_REQUIRES(Locks::mutator_lock_) REQUIRES(!lock_);
+
+ private:
+  struct Entry {
+    std::string description;
+    int line_number;
+  };
+
+  Mutex lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
+  std::map<std::pair<ArtMethod*, uint32_t>, Entry> cache_ GUARDED_BY(lock_);
+
+  DISALLOW_COPY_AND_ASSIGN(FrameDescriptionCache);
+};
+
 class Thread {
  public:
   static const size_t kStackOverflowImplicitCheckSize;
@@ -189,11 +216,12 @@ class Thread {
   // Dumps the detailed thread state and the thread stack (used for SIGQUIT).
   void Dump(std::ostream& os,
             bool dump_native_stack = true,
-            BacktraceMap* backtrace_map = nullptr) const
+            BacktraceMap* backtrace_map = nullptr,
+            FrameDescriptionCache* frame_cache = nullptr) const
       REQUIRES(!Locks::thread_suspend_count_lock_)
       SHARED_REQUIRES(Locks::mutator_lock_);
 
-  void DumpJavaStack(std::ostream& os) const
+  void DumpJavaStack(std::ostream& os, FrameDescriptionCache* frame_cache = nullptr) const
       REQUIRES(!Locks::thread_suspend_count_lock_)
       SHARED_REQUIRES(Locks::mutator_lock_);
 
@@ -455,6 +483,20 @@ class Thread {
     tlsPtr_.monitor_enter_object = obj;
   }
 
+  // This thread's cache of free pool monitor storage; only MonitorPool manipulates the list.
+  Monitor* GetMonitorPoolCache() const {
+    return tlsPtr_.monitor_pool_cache;
+  }
+
+  size_t GetMonitorPoolCacheSize() const {
+    return tlsPtr_.monitor_pool_cache_size;
+  }
+
+  void SetMonitorPoolCache(Monitor* head, size_t size) {
+    tlsPtr_.monitor_pool_cache = head;
+    tlsPtr_.monitor_pool_cache_size = size;
+  }
+
   // Implements java.lang.Thread.interrupted.
   bool Interrupted() REQUIRES(!*wait_mutex_);
   // Implements java.lang.Thread.isInterrupted.
@@ -476,6 +518,15 @@ class Thread {
     return wait_mutex_;
   }
 
+  // Ring of lock contention events recorded by this thread, null until the first contended
+  // acquisition with collection enabled. See BaseMutex::DumpContentionRanking.
+  ContentionEventRing* GetContentionEventRing() const {
+    return contention_event_ring_;
+  }
+  void SetContentionEventRing(ContentionEventRing* ring) {
+    contention_event_ring_ = ring;
+  }
+
   ConditionVariable* GetWaitConditionVariable() const REQUIRES(wait_mutex_) {
     return wait_cond_;
   }
@@ -798,6 +849,10 @@ class Thread {
                                                                 top_handle_scope));
   }
 
+  ALWAYS_INLINE interpreter::InterpreterCache* GetInterpreterCache() {
+    return &interpreter_cache_;
+  }
+
   DebugInvokeReq* GetInvokeReq() const {
     return tlsPtr_.debug_invoke_req;
   }
@@ -937,6 +992,30 @@ class Thread {
     tlsPtr_.stack_trace_sample = sample;
   }
 
+  uint8_t* GetMethodTraceBuffer() const {
+    return tlsPtr_.method_trace_buffer;
+  }
+
+  void SetMethodTraceBuffer(uint8_t* buffer) {
+    tlsPtr_.method_trace_buffer = buffer;
+  }
+
+  size_t GetMethodTraceBufferPos() const {
+    return tlsPtr_.method_trace_buffer_pos;
+  }
+
+  void SetMethodTraceBufferPos(size_t pos) {
+    tlsPtr_.method_trace_buffer_pos = pos;
+  }
+
+  size_t GetAllocRecordSampleCountdown() const {
+    return tlsPtr_.alloc_record_sample_countdown;
+  }
+
+  void SetAllocRecordSampleCountdown(size_t bytes) {
+    tlsPtr_.alloc_record_sample_countdown = bytes;
+  }
+
   uint64_t GetTraceClockBase() const {
     return tls64_.trace_clock_base;
   }
@@ -992,6 +1071,33 @@ class Thread {
     return tlsPtr_.thread_local_pos;
   }
 
+  // Thread-local buffer support for LinearAlloc. Buffers are carved out under the owning
+  // allocator's lock and bumped here without locking. The owner id disambiguates allocators
+  // whose address was reused after class unloading.
+  bool HasLinearAllocTlab(LinearAlloc* owner, uintptr_t owner_id) const {
+    return tlsPtr_.linear_alloc_tlab_owner == owner &&
+        tlsPtr_.linear_alloc_tlab_owner_id == owner_id;
+  }
+
+  // Returns the remaining space in the LinearAlloc buffer.
+  size_t LinearAllocTlabSize() const {
+    return tlsPtr_.linear_alloc_tlab_end - tlsPtr_.linear_alloc_tlab_pos;
+  }
+
+  void SetLinearAllocTlab(LinearAlloc* owner, uintptr_t owner_id, uint8_t* start, uint8_t* end) {
+    tlsPtr_.linear_alloc_tlab_owner = owner;
+    tlsPtr_.linear_alloc_tlab_owner_id = owner_id;
+    tlsPtr_.linear_alloc_tlab_pos = start;
+    tlsPtr_.linear_alloc_tlab_end = end;
+  }
+
+  // Doesn't check that there is room.
+  void* AllocLinearAllocTlab(size_t bytes) {
+    uint8_t* const ret = tlsPtr_.linear_alloc_tlab_pos;
+    tlsPtr_.linear_alloc_tlab_pos += bytes;
+    return ret;
+  }
+
   // Remove the suspend trigger for this thread by making the suspend_trigger_ TLS value
   // equal to a valid pointer.
   // TODO: does this need to atomic?  I don't think so.
@@ -1018,6 +1124,25 @@ class Thread {
   // Resets the thread local allocation pointers.
   void RevokeThreadLocalAllocationStack();
 
+  // Initial and maximum number of references handed out per thread-local allocation stack
+  // refill, see Heap::PushOnThreadLocalAllocationStackWithInternalGC.
+  static constexpr size_t kInitialThreadLocalAllocStackSize = 128;
+  static constexpr size_t kMaxThreadLocalAllocStackSize = 2048;
+
+  // Number of references the next thread-local allocation stack refill should request from the
+  // shared allocation stack.
+  size_t GetThreadLocalAllocStackRefillSize() const {
+    return thread_local_alloc_stack_refill_size_;
+  }
+
+  // Double the refill size up to the maximum. Called after a successful refill so that
+  // allocation-heavy threads contend less on the shared allocation stack bump pointer.
+  void GrowThreadLocalAllocStackRefillSize() {
+    if (thread_local_alloc_stack_refill_size_ < kMaxThreadLocalAllocStackSize) {
+      thread_local_alloc_stack_refill_size_ *= 2;
+    }
+  }
+
   size_t GetThreadLocalBytesAllocated() const {
     return tlsPtr_.thread_local_end - tlsPtr_.thread_local_start;
   }
@@ -1140,7 +1265,8 @@ class Thread {
   void DumpState(std::ostream& os) const SHARED_REQUIRES(Locks::mutator_lock_);
   void DumpStack(std::ostream& os,
                  bool dump_native_stack = true,
-                 BacktraceMap* backtrace_map = nullptr) const
+                 BacktraceMap* backtrace_map = nullptr,
+                 FrameDescriptionCache* frame_cache = nullptr) const
       REQUIRES(!Locks::thread_suspend_count_lock_)
       SHARED_REQUIRES(Locks::mutator_lock_);
 
@@ -1358,7 +1484,11 @@ class Thread {
       mterp_current_ibase(nullptr), mterp_default_ibase(nullptr), mterp_alt_ibase(nullptr),
       thread_local_alloc_stack_top(nullptr), thread_local_alloc_stack_end(nullptr),
       nested_signal_state(nullptr), flip_function(nullptr), method_verifier(nullptr),
-      thread_local_mark_stack(nullptr) {
+      thread_local_mark_stack(nullptr), linear_alloc_tlab_owner(nullptr),
+      linear_alloc_tlab_owner_id(0u), linear_alloc_tlab_pos(nullptr),
+      linear_alloc_tlab_end(nullptr), monitor_pool_cache(nullptr),
+      monitor_pool_cache_size(0u), method_trace_buffer(nullptr),
+      method_trace_buffer_pos(0u), alloc_record_sample_countdown(0u) {
       std::fill(held_mutexes, held_mutexes + kLockLevelCount, nullptr);
     }
 
@@ -1502,6 +1632,29 @@ class Thread {
 
     // Thread-local mark stack for the concurrent copying collector.
     gc::accounting::AtomicStack<mirror::Object>* thread_local_mark_stack;
+
+    // Thread-local allocation buffer for LinearAlloc. The owner and its id identify the
+    // allocator the buffer was carved from; the id alone is unique across all allocators ever
+    // created, so a stale buffer can never alias a new allocator reusing a freed address.
+    LinearAlloc* linear_alloc_tlab_owner;
+    uintptr_t linear_alloc_tlab_owner_id;
+    uint8_t* linear_alloc_tlab_pos;
+    uint8_t* linear_alloc_tlab_end;
+
+    // Head and size of this thread's cache of free pool monitor storage. Maintained by
+    // MonitorPool, which refills and flushes it in batches from the central free list so that
+    // monitor inflation does not take the global monitor ids lock on every call.
+    Monitor* monitor_pool_cache;
+    size_t monitor_pool_cache_size;
+
+    // Buffer of pending streaming method trace records and the number of bytes filled in,
+    // lazily set up by Trace and flushed in batches under its streaming lock.
+    uint8_t* method_trace_buffer;
+    size_t method_trace_buffer_pos;
+
+    // Bytes this thread may still allocate before the allocation tracker samples again.
+    // Starts at zero so a thread's first tracked allocation is always recorded.
+    size_t alloc_record_sample_countdown;
   } tlsPtr_;
 
   // Guards the 'interrupted_' and 'wait_monitor_' members.
@@ -1515,9 +1668,19 @@ class Thread {
   // Thread "interrupted" status; stays raised until queried or thrown.
   bool interrupted_ GUARDED_BY(wait_mutex_);
 
+  // Lazily allocated ring of lock contention events recorded by this thread.
+  ContentionEventRing* contention_event_ring_ = nullptr;
+
   // Debug disable read barrier count, only is checked for debug builds and only in the runtime.
   uint8_t debug_disallow_read_barrier_ = 0;
 
+  // Current thread-local allocation stack refill size in references. Doubled on each exhaustion
+  // up to kMaxThreadLocalAllocStackSize and reset when the stack is revoked.
+  size_t thread_local_alloc_stack_refill_size_ = kInitialThreadLocalAllocStackSize;
+
+  // Cache of resolution results consulted by the interpreter before going through the dex cache.
+  interpreter::InterpreterCache interpreter_cache_;
+
   friend class Dbg;  // For SetStateUnsafe.
   friend class gc::collector::SemiSpace;  // For getting stack traces.
   friend class Runtime;  // For CreatePeer.
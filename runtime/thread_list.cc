@@ -52,6 +52,10 @@ namespace art {
 
 static constexpr uint64_t kLongThreadSuspendThreshold = MsToNs(5);
 static constexpr uint64_t kThreadSuspendTimeoutMs = 30 * 1000;  // 30s.
+// How long SuspendAllInternal waits on the suspend barrier before naming the threads that have
+// not yet quiesced. Slow suspends are typically delayed by a single straggler, which is otherwise
+// invisible in the aggregate suspend histograms.
+static constexpr uint64_t kSuspendBarrierStragglerTimeoutMs = 100;
 // Use 0 since we want to yield to prevent blocking for an unpredictable amount of time.
 static constexpr useconds_t kThreadSuspendInitialSleepUs = 0;
 static constexpr useconds_t kThreadSuspendMaxYieldUs = 3000;
@@ -67,6 +71,8 @@ ThreadList::ThreadList()
       debug_suspend_all_count_(0),
       unregistering_count_(0),
       suspend_all_historam_("suspend all histogram", 16, 64),
+      suspend_request_histogram_("suspend request histogram", 16, 64),
+      suspend_wait_histogram_("suspend wait histogram", 16, 64),
       long_suspend_(false) {
   CHECK(Monitor::IsValidLockWord(LockWord::FromThinLockId(kMaxThreadId, 1, 0U)));
 }
@@ -134,6 +140,19 @@ void ThreadList::DumpForSigQuit(std::ostream& os) {
       suspend_all_historam_.PrintConfidenceIntervals(os, 0.99, data);  // Dump time to suspend.
     }
   }
+  {
+    MutexLock mu(Thread::Current(), *Locks::thread_suspend_count_lock_);
+    if (suspend_request_histogram_.SampleSize() > 0) {
+      Histogram<uint64_t>::CumulativeData data;
+      suspend_request_histogram_.CreateHistogram(&data);
+      suspend_request_histogram_.PrintConfidenceIntervals(os, 0.99, data);
+    }
+    if (suspend_wait_histogram_.SampleSize() > 0) {
+      Histogram<uint64_t>::CumulativeData data;
+      suspend_wait_histogram_.CreateHistogram(&data);
+      suspend_wait_histogram_.PrintConfidenceIntervals(os, 0.99, data);
+    }
+  }
   bool dump_native_stack = Runtime::Current()->GetDumpNativeStackOnSigQuit();
   Dump(os, dump_native_stack);
   DumpUnattachedThreads(os, dump_native_stack);
@@ -196,7 +215,7 @@ class DumpCheckpoint FINAL : public Closure {
     std::ostringstream local_os;
     {
       ScopedObjectAccess soa(self);
-      thread->Dump(local_os, dump_native_stack_, backtrace_map_.get());
+      thread->Dump(local_os, dump_native_stack_, backtrace_map_.get(), &frame_cache_);
     }
     local_os << "\n";
     {
@@ -225,6 +244,9 @@ class DumpCheckpoint FINAL : public Closure {
   Barrier barrier_;
   // A backtrace map, so that all threads use a shared info and don't reacquire/parse separately.
   std::unique_ptr<BacktraceMap> backtrace_map_;
+  // Shared frame description cache, so that frames common to several threads (pool threads
+  // parked in identical code) are rendered only once per dump.
+  FrameDescriptionCache frame_cache_;
   // Whether we should dump the native stack.
   const bool dump_native_stack_;
 };
@@ -537,6 +559,8 @@ void ThreadList::SuspendAllInternal(Thread* self,
   //    kNative) and will never begin executing Java code without first checking
   //    the suspend-request flag.
 
+  const uint64_t request_start_time = NanoTime();
+
   // The atomic counter for number of threads that need to pass the barrier.
   AtomicInteger pending_threads;
   uint32_t num_ignored = 0;
@@ -590,11 +614,17 @@ void ThreadList::SuspendAllInternal(Thread* self,
     }
   }
 
+  const uint64_t wait_start_time = NanoTime();
+
   // Wait for the barrier to be passed by all runnable threads. This wait
   // is done with a timeout so that we can detect problems.
 #if ART_USE_FUTEXES
   timespec wait_timeout;
-  InitTimeSpec(true, CLOCK_MONOTONIC, 10000, 0, &wait_timeout);
+  // Wait for a short period first; if the barrier has still not been passed by then, name the
+  // stragglers before waiting out the rest of the timeout. Note that FUTEX_WAIT interprets the
+  // timeout as relative, so pass a relative time.
+  InitTimeSpec(false, CLOCK_MONOTONIC, kSuspendBarrierStragglerTimeoutMs, 0, &wait_timeout);
+  bool reported_stragglers = false;
 #endif
   while (true) {
     int32_t cur_val = pending_threads.LoadRelaxed();
@@ -604,7 +634,24 @@ void ThreadList::SuspendAllInternal(Thread* self,
         // EAGAIN and EINTR both indicate a spurious failure, try again from the beginning.
         if ((errno != EAGAIN) && (errno != EINTR)) {
           if (errno == ETIMEDOUT) {
-            LOG(kIsDebugBuild ? FATAL : ERROR) << "Unexpected time out during suspend all.";
+            if (!reported_stragglers) {
+              std::ostringstream oss;
+              {
+                MutexLock mu(self, *Locks::thread_list_lock_);
+                for (const auto& thread : list_) {
+                  if (thread != ignore1 && thread != ignore2 && !thread->IsSuspended()) {
+                    oss << "\n" << *thread;
+                  }
+                }
+              }
+              LOG(WARNING) << "SuspendAll barrier not passed within "
+                           << kSuspendBarrierStragglerTimeoutMs
+                           << "ms, threads delaying quiescence:" << oss.str();
+              reported_stragglers = true;
+              InitTimeSpec(false, CLOCK_MONOTONIC, 10000, 0, &wait_timeout);
+            } else {
+              LOG(kIsDebugBuild ? FATAL : ERROR) << "Unexpected time out during suspend all.";
+            }
           } else {
             PLOG(FATAL) << "futex wait failed for SuspendAllInternal()";
           }
@@ -622,6 +669,15 @@ void ThreadList::SuspendAllInternal(Thread* self,
       break;
     }
   }
+
+  // Record the phase breakdown so SIGQUIT dumps show whether slow suspends are spent requesting
+  // suspension or waiting for stragglers to quiesce.
+  const uint64_t quiescence_time = NanoTime();
+  {
+    MutexLock mu(self, *Locks::thread_suspend_count_lock_);
+    suspend_request_histogram_.AdjustAndAddValue(wait_start_time - request_start_time);
+    suspend_wait_histogram_.AdjustAndAddValue(quiescence_time - wait_start_time);
+  }
 }
 
 void ThreadList::ResumeAll() {
@@ -194,6 +194,11 @@ class ThreadList {
   // by mutator lock ensures no thread can read when another thread is modifying it.
   Histogram<uint64_t> suspend_all_historam_ GUARDED_BY(Locks::mutator_lock_);
 
+  // Breakdown of SuspendAllInternal: time spent requesting suspension of every thread versus time
+  // spent waiting for the last runnable thread to reach quiescence at the suspend barrier.
+  Histogram<uint64_t> suspend_request_histogram_ GUARDED_BY(Locks::thread_suspend_count_lock_);
+  Histogram<uint64_t> suspend_wait_histogram_ GUARDED_BY(Locks::thread_suspend_count_lock_);
+
   // Whether or not the current thread suspension is long.
   bool long_suspend_;
 
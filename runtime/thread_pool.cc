@@ -17,6 +17,8 @@
 #include "thread_pool.h"
 
 #include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
 
 #include <sys/time.h>
 #include <sys/resource.h>
@@ -36,7 +38,9 @@ static constexpr bool kMeasureWaitTime = false;
 ThreadPoolWorker::ThreadPoolWorker(ThreadPool* thread_pool, const std::string& name,
                                    size_t stack_size)
     : thread_pool_(thread_pool),
-      name_(name) {
+      name_(name),
+      thread_(nullptr),
+      queue_lock_("thread pool worker queue lock", kThreadPoolWorkerQueueLock) {
   // Add an inaccessible page to catch stack overflow.
   stack_size += kPageSize;
   std::string error_msg;
@@ -71,8 +75,23 @@ void ThreadPoolWorker::SetPthreadPriority(int priority) {
 #endif
 }
 
+void ThreadPoolWorker::SetCpuAffinity(size_t cpu) {
+#if defined(__ANDROID__)
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  CPU_SET(cpu, &cpu_set);
+  int result = sched_setaffinity(pthread_gettid_np(pthread_), sizeof(cpu_set), &cpu_set);
+  if (result != 0) {
+    PLOG(WARNING) << "Failed to pin " << name_ << " to cpu " << cpu;
+  }
+#else
+  UNUSED(cpu);
+#endif
+}
+
 void ThreadPoolWorker::Run() {
   Thread* self = Thread::Current();
+  thread_ = self;
   Task* task = nullptr;
   thread_pool_->creation_barier_.Wait(self);
   while ((task = thread_pool_->GetTask(self)) != nullptr) {
@@ -92,10 +111,24 @@ void* ThreadPoolWorker::Callback(void* arg) {
 }
 
 void ThreadPool::AddTask(Thread* self, Task* task) {
-  MutexLock mu(self, task_queue_lock_);
-  tasks_.push_back(task);
+  if (threads_.empty()) {
+    MutexLock mu(self, task_queue_lock_);
+    tasks_.push_back(task);
+  } else {
+    // A worker keeps the tasks it spawns local so that recursively generated work stays hot in
+    // its own deque. External producers distribute round-robin so the workers mostly pop from
+    // disjoint queues.
+    size_t index = GetWorkerIndex(self);
+    if (index == kInvalidWorkerIndex) {
+      index = next_worker_queue_.FetchAndAddSequentiallyConsistent(1u) % threads_.size();
+    }
+    ThreadPoolWorker* worker = threads_[index];
+    MutexLock mu(self, worker->queue_lock_);
+    worker->queue_.push_back(task);
+  }
   // If we have any waiters, signal one.
-  if (started_ && waiting_count_ != 0) {
+  MutexLock mu(self, task_queue_lock_);
+  if (started_.LoadRelaxed() && waiting_count_.LoadRelaxed() != 0) {
     task_queue_condition_.Signal(self);
   }
 }
@@ -103,6 +136,10 @@ void ThreadPool::AddTask(Thread* self, Task* task) {
 void ThreadPool::RemoveAllTasks(Thread* self) {
   MutexLock mu(self, task_queue_lock_);
   tasks_.clear();
+  for (ThreadPoolWorker* worker : threads_) {
+    MutexLock mu2(self, worker->queue_lock_);
+    worker->queue_.clear();
+  }
 }
 
 ThreadPool::ThreadPool(const char* name, size_t num_threads)
@@ -117,7 +154,8 @@ ThreadPool::ThreadPool(const char* name, size_t num_threads)
     total_wait_time_(0),
     // Add one since the caller of constructor waits on the barrier too.
     creation_barier_(num_threads + 1),
-    max_active_workers_(num_threads) {
+    max_active_workers_(num_threads),
+    next_worker_queue_(0u) {
   Thread* self = Thread::Current();
   while (GetThreadCount() < num_threads) {
     const std::string worker_name = StringPrintf("%s worker thread %zu", name_.c_str(),
@@ -132,7 +170,7 @@ ThreadPool::ThreadPool(const char* name, size_t num_threads)
 void ThreadPool::SetMaxActiveWorkers(size_t threads) {
   MutexLock mu(Thread::Current(), task_queue_lock_);
   CHECK_LE(threads, GetThreadCount());
-  max_active_workers_ = threads;
+  max_active_workers_.StoreRelaxed(threads);
 }
 
 ThreadPool::~ThreadPool() {
@@ -151,7 +189,7 @@ ThreadPool::~ThreadPool() {
 
 void ThreadPool::StartWorkers(Thread* self) {
   MutexLock mu(self, task_queue_lock_);
-  started_ = true;
+  started_.StoreRelaxed(true);
   task_queue_condition_.Broadcast(self);
   start_time_ = NanoTime();
   total_wait_time_ = 0;
@@ -159,25 +197,40 @@ void ThreadPool::StartWorkers(Thread* self) {
 
 void ThreadPool::StopWorkers(Thread* self) {
   MutexLock mu(self, task_queue_lock_);
-  started_ = false;
+  started_.StoreRelaxed(false);
 }
 
 Task* ThreadPool::GetTask(Thread* self) {
-  MutexLock mu(self, task_queue_lock_);
-  while (!IsShuttingDown()) {
-    const size_t thread_count = GetThreadCount();
+  const size_t worker_index = GetWorkerIndex(self);
+  while (true) {
+    // Fast path, takes tasks straight from the per-worker deques without touching
+    // task_queue_lock_. The gating state is read racily, a stale value only costs one loop
+    // iteration.
     // Ensure that we don't use more threads than the maximum active workers.
-    const size_t active_threads = thread_count - waiting_count_;
+    const size_t active_threads = GetThreadCount() - waiting_count_.LoadRelaxed();
     // <= since self is considered an active worker.
-    if (active_threads <= max_active_workers_) {
-      Task* task = TryGetTaskLocked();
+    if (active_threads <= max_active_workers_.LoadRelaxed()) {
+      Task* task = TryGetTaskFromQueues(self, worker_index);
       if (task != nullptr) {
         return task;
       }
     }
 
-    ++waiting_count_;
-    if (waiting_count_ == GetThreadCount() && tasks_.empty()) {
+    MutexLock mu(self, task_queue_lock_);
+    if (IsShuttingDown()) {
+      // We are shutting down, return null to tell the worker thread to stop looping.
+      return nullptr;
+    }
+    // Re-check under the lock. Producers signal with task_queue_lock_ held after publishing
+    // their task, so anything visible now cannot have its wakeup lost by retrying.
+    const size_t active = GetThreadCount() - waiting_count_.LoadRelaxed();
+    if (started_.LoadRelaxed() && active <= max_active_workers_.LoadRelaxed() &&
+        !AllQueuesEmpty(self)) {
+      continue;  // Raced with a producer, retry the fast path.
+    }
+
+    waiting_count_.StoreRelaxed(waiting_count_.LoadRelaxed() + 1);
+    if (waiting_count_.LoadRelaxed() == GetThreadCount() && AllQueuesEmpty(self)) {
       // We may be done, lets broadcast to the completion condition.
       completion_condition_.Broadcast(self);
     }
@@ -187,27 +240,73 @@ Task* ThreadPool::GetTask(Thread* self) {
       const uint64_t wait_end = NanoTime();
       total_wait_time_ += wait_end - std::max(wait_start, start_time_);
     }
-    --waiting_count_;
+    waiting_count_.StoreRelaxed(waiting_count_.LoadRelaxed() - 1);
   }
-
-  // We are shutting down, return null to tell the worker thread to stop looping.
-  return nullptr;
 }
 
 Task* ThreadPool::TryGetTask(Thread* self) {
-  MutexLock mu(self, task_queue_lock_);
-  return TryGetTaskLocked();
+  return TryGetTaskFromQueues(self, GetWorkerIndex(self));
 }
 
-Task* ThreadPool::TryGetTaskLocked() {
-  if (started_ && !tasks_.empty()) {
-    Task* task = tasks_.front();
-    tasks_.pop_front();
-    return task;
+Task* ThreadPool::TryGetTaskFromQueues(Thread* self, size_t worker_index) {
+  if (!started_.LoadRelaxed()) {
+    return nullptr;
+  }
+  const size_t num_workers = threads_.size();
+  if (num_workers == 0u) {
+    MutexLock mu(self, task_queue_lock_);
+    if (started_.LoadRelaxed() && !tasks_.empty()) {
+      Task* task = tasks_.front();
+      tasks_.pop_front();
+      return task;
+    }
+    return nullptr;
+  }
+  // Our own deque first, newest task first for cache locality.
+  if (worker_index != kInvalidWorkerIndex) {
+    ThreadPoolWorker* worker = threads_[worker_index];
+    MutexLock mu(self, worker->queue_lock_);
+    if (!worker->queue_.empty()) {
+      Task* task = worker->queue_.back();
+      worker->queue_.pop_back();
+      return task;
+    }
+  }
+  // Steal from the other workers, oldest task first.
+  for (size_t i = 0; i < num_workers; ++i) {
+    if (i == worker_index) {
+      continue;
+    }
+    ThreadPoolWorker* worker = threads_[i];
+    MutexLock mu(self, worker->queue_lock_);
+    if (!worker->queue_.empty()) {
+      Task* task = worker->queue_.front();
+      worker->queue_.pop_front();
+      return task;
+    }
   }
   return nullptr;
 }
 
+size_t ThreadPool::GetWorkerIndex(Thread* self) const {
+  for (size_t i = 0; i < threads_.size(); ++i) {
+    if (threads_[i]->thread_ == self) {
+      return i;
+    }
+  }
+  return kInvalidWorkerIndex;
+}
+
+bool ThreadPool::AllQueuesEmpty(Thread* self) {
+  for (ThreadPoolWorker* worker : threads_) {
+    MutexLock mu(self, worker->queue_lock_);
+    if (!worker->queue_.empty()) {
+      return false;
+    }
+  }
+  return tasks_.empty();
+}
+
 void ThreadPool::Wait(Thread* self, bool do_work, bool may_hold_locks) {
   if (do_work) {
     Task* task = nullptr;
@@ -216,9 +315,10 @@ void ThreadPool::Wait(Thread* self, bool do_work, bool may_hold_locks) {
       task->Finalize();
     }
   }
-  // Wait until each thread is waiting and the task list is empty.
+  // Wait until each thread is waiting and every task deque is empty.
   MutexLock mu(self, task_queue_lock_);
-  while (!shutting_down_ && (waiting_count_ != GetThreadCount() || !tasks_.empty())) {
+  while (!shutting_down_ &&
+         (waiting_count_.LoadRelaxed() != GetThreadCount() || !AllQueuesEmpty(self))) {
     if (!may_hold_locks) {
       completion_condition_.Wait(self);
     } else {
@@ -229,7 +329,12 @@ void ThreadPool::Wait(Thread* self, bool do_work, bool may_hold_locks) {
 
 size_t ThreadPool::GetTaskCount(Thread* self) {
   MutexLock mu(self, task_queue_lock_);
-  return tasks_.size();
+  size_t count = tasks_.size();
+  for (ThreadPoolWorker* worker : threads_) {
+    MutexLock mu2(self, worker->queue_lock_);
+    count += worker->queue_.size();
+  }
+  return count;
 }
 
 void ThreadPool::SetPthreadPriority(int priority) {
@@ -238,4 +343,16 @@ void ThreadPool::SetPthreadPriority(int priority) {
   }
 }
 
+void ThreadPool::SetCpuAffinities() {
+  const long num_cpus = sysconf(_SC_NPROCESSORS_CONF);  // NOLINT(runtime/int)
+  if (num_cpus <= 0) {
+    return;
+  }
+  size_t cpu = 0;
+  for (ThreadPoolWorker* worker : threads_) {
+    worker->SetCpuAffinity(cpu % static_cast<size_t>(num_cpus));
+    ++cpu;
+  }
+}
+
 }  // namespace art
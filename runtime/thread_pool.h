@@ -20,6 +20,7 @@
 #include <deque>
 #include <vector>
 
+#include "atomic.h"
 #include "barrier.h"
 #include "base/mutex.h"
 #include "mem_map.h"
@@ -62,6 +63,9 @@ class ThreadPoolWorker {
   // Set the "nice" priorty for this worker.
   void SetPthreadPriority(int priority);
 
+  // Pin this worker to the given CPU. Best effort, failures are logged and ignored.
+  void SetCpuAffinity(size_t cpu);
+
  protected:
   ThreadPoolWorker(ThreadPool* thread_pool, const std::string& name, size_t stack_size);
   static void* Callback(void* arg) REQUIRES(!Locks::mutator_lock_);
@@ -71,6 +75,14 @@ class ThreadPoolWorker {
   const std::string name_;
   std::unique_ptr<MemMap> stack_;
   pthread_t pthread_;
+  // The worker's attached thread. Written before the creation barrier is released, so other
+  // threads may read it without synchronization afterwards.
+  Thread* thread_;
+  // Local task deque. The owning worker pushes and pops at the back, other threads steal from
+  // the front. Guarded by its own low-level lock so that busy workers do not serialize on the
+  // pool's task_queue_lock_.
+  Mutex queue_lock_;
+  std::deque<Task*> queue_ GUARDED_BY(queue_lock_);
 
  private:
   friend class ThreadPool;
@@ -117,13 +129,29 @@ class ThreadPool {
   // Set the "nice" priorty for threads in the pool.
   void SetPthreadPriority(int priority);
 
+  // Pin each worker to its own CPU, round-robin over the online CPUs. Optional; intended for
+  // pools whose tasks benefit from cache affinity, such as parallel GC marking.
+  void SetCpuAffinities();
+
  protected:
+  static constexpr size_t kInvalidWorkerIndex = static_cast<size_t>(-1);
+
   // get a task to run, blocks if there are no tasks left
   virtual Task* GetTask(Thread* self) REQUIRES(!task_queue_lock_);
 
   // Try to get a task, returning null if there is none available.
   Task* TryGetTask(Thread* self) REQUIRES(!task_queue_lock_);
-  Task* TryGetTaskLocked() REQUIRES(task_queue_lock_);
+
+  // Take a task directly from the per-worker deques without blocking: the caller's own deque
+  // first (newest task first, for cache locality), then the other workers' deques (oldest task
+  // first). Pools without workers fall back to the shared tasks_ queue.
+  Task* TryGetTaskFromQueues(Thread* self, size_t worker_index) REQUIRES(!task_queue_lock_);
+
+  // Index of the given thread's worker deque, or kInvalidWorkerIndex for non-worker threads.
+  size_t GetWorkerIndex(Thread* self) const;
+
+  // Whether every worker deque and the shared queue are empty.
+  bool AllQueuesEmpty(Thread* self) REQUIRES(task_queue_lock_);
 
   // Are we shutting down?
   bool IsShuttingDown() const REQUIRES(task_queue_lock_) {
@@ -134,10 +162,14 @@ class ThreadPool {
   Mutex task_queue_lock_;
   ConditionVariable task_queue_condition_ GUARDED_BY(task_queue_lock_);
   ConditionVariable completion_condition_ GUARDED_BY(task_queue_lock_);
-  volatile bool started_ GUARDED_BY(task_queue_lock_);
+  // Written with task_queue_lock_ held, read racily in the workers' lock-free fast path. A
+  // stale value only costs one extra loop iteration there.
+  Atomic<bool> started_;
   volatile bool shutting_down_ GUARDED_BY(task_queue_lock_);
-  // How many worker threads are waiting on the condition.
-  volatile size_t waiting_count_ GUARDED_BY(task_queue_lock_);
+  // How many worker threads are waiting on the condition. Written with task_queue_lock_ held,
+  // read racily in the fast path throttle check.
+  Atomic<size_t> waiting_count_;
+  // Shared task queue, only used when the pool has no workers.
   std::deque<Task*> tasks_ GUARDED_BY(task_queue_lock_);
   // TODO: make this immutable/const?
   std::vector<ThreadPoolWorker*> threads_;
@@ -145,7 +177,10 @@ class ThreadPool {
   uint64_t start_time_ GUARDED_BY(task_queue_lock_);
   uint64_t total_wait_time_;
   Barrier creation_barier_;
-  size_t max_active_workers_ GUARDED_BY(task_queue_lock_);
+  // Written with task_queue_lock_ held, read racily in the fast path throttle check.
+  Atomic<size_t> max_active_workers_;
+  // Round-robin cursor distributing externally added tasks over the worker deques.
+  Atomic<size_t> next_worker_queue_;
 
  private:
   friend class ThreadPoolWorker;
@@ -20,6 +20,7 @@
 #include <unistd.h>
 
 #include "art_method-inl.h"
+#include "barrier.h"
 #include "base/casts.h"
 #include "base/stl_util.h"
 #include "base/systrace.h"
@@ -40,6 +41,7 @@
 #include "ScopedLocalRef.h"
 #include "thread.h"
 #include "thread_list.h"
+#include "thread_pool.h"
 #include "utils.h"
 #include "entrypoints/quick/quick_entrypoints.h"
 
@@ -84,11 +86,15 @@ static const uint16_t kTraceVersionDualClock      = 3;
 static const uint16_t kTraceRecordSizeSingleClock = 10;  // using v2
 static const uint16_t kTraceRecordSizeDualClock   = 14;  // using v3 with two timestamps
 
+// Size of the per-thread buffer that batches streaming events so that the streaming lock and
+// the shared buffer are only touched once it runs full or the thread exits.
+static constexpr size_t kPerThreadBufSize = 4 * KB;
+
 TraceClockSource Trace::default_clock_source_ = kDefaultTraceClockSource;
 
 Trace* volatile Trace::the_trace_ = nullptr;
 pthread_t Trace::sampling_pthread_ = 0U;
-std::unique_ptr<std::vector<ArtMethod*>> Trace::temp_stack_trace_;
+Atomic<std::vector<ArtMethod*>*> Trace::temp_stack_trace_(nullptr);
 
 // The key identifying the tracer to update instrumentation.
 static constexpr const char* kTracerInstrumentationKey = "Tracer";
@@ -103,35 +109,50 @@ ArtMethod* Trace::DecodeTraceMethod(uint32_t tmid) {
 }
 
 uint32_t Trace::EncodeTraceMethod(ArtMethod* method) {
+  bool is_new_method;
+  return EncodeTraceMethod(method, &is_new_method);
+}
+
+uint32_t Trace::EncodeTraceMethod(ArtMethod* method, bool* is_new_method) {
   MutexLock mu(Thread::Current(), *unique_methods_lock_);
   uint32_t idx;
   auto it = art_method_id_map_.find(method);
   if (it != art_method_id_map_.end()) {
     idx = it->second;
+    *is_new_method = false;
   } else {
     unique_methods_.push_back(method);
     idx = unique_methods_.size() - 1;
     art_method_id_map_.emplace(method, idx);
+    *is_new_method = true;
   }
   DCHECK_LT(idx, unique_methods_.size());
   DCHECK_EQ(unique_methods_[idx], method);
   return idx;
 }
 
-uint32_t Trace::EncodeTraceMethodAndAction(ArtMethod* method, TraceAction action) {
-  uint32_t tmid = (EncodeTraceMethod(method) << TraceActionBits) | action;
+uint32_t Trace::EncodeTraceMethodAndAction(ArtMethod* method, TraceAction action,
+                                           bool* is_new_method) {
+  uint32_t tmid = (EncodeTraceMethod(method, is_new_method) << TraceActionBits) | action;
   DCHECK_EQ(method, DecodeTraceMethod(tmid));
   return tmid;
 }
 
 std::vector<ArtMethod*>* Trace::AllocStackTrace() {
-  return (temp_stack_trace_.get() != nullptr)  ? temp_stack_trace_.release() :
-      new std::vector<ArtMethod*>();
+  std::vector<ArtMethod*>* stack_trace = temp_stack_trace_.LoadSequentiallyConsistent();
+  if (stack_trace != nullptr &&
+      temp_stack_trace_.CompareExchangeStrongSequentiallyConsistent(stack_trace, nullptr)) {
+    return stack_trace;
+  }
+  return new std::vector<ArtMethod*>();
 }
 
 void Trace::FreeStackTrace(std::vector<ArtMethod*>* stack_trace) {
   stack_trace->clear();
-  temp_stack_trace_.reset(stack_trace);
+  if (!temp_stack_trace_.CompareExchangeStrongSequentiallyConsistent(nullptr, stack_trace)) {
+    // Another thread already parked its trace; keeping one spare is enough.
+    delete stack_trace;
+  }
 }
 
 void Trace::SetDefaultClockSource(TraceClockSource clock_source) {
@@ -234,9 +255,32 @@ static void ClearThreadStackTraceAndClockBase(Thread* thread, void* arg ATTRIBUT
   delete stack_trace;
 }
 
+// Checkpoint closure run by each sampled thread at its next safepoint, or by the sampling
+// thread on behalf of threads that are already suspended. Either way the sampled thread's
+// stack is stable while it is walked, without stopping the world.
+class TraceSampleCheckpoint FINAL : public Closure {
+ public:
+  TraceSampleCheckpoint(Trace* trace, Barrier* barrier) : trace_(trace), barrier_(barrier) {}
+
+  void Run(Thread* thread) OVERRIDE {
+    Thread* self = Thread::Current();
+    ScopedObjectAccess soa(self);
+    GetSample(thread, trace_);
+    barrier_->Pass(self);
+  }
+
+ private:
+  Trace* const trace_;
+  Barrier* const barrier_;
+
+  DISALLOW_COPY_AND_ASSIGN(TraceSampleCheckpoint);
+};
+
 void Trace::CompareAndUpdateStackTrace(Thread* thread,
                                        std::vector<ArtMethod*>* stack_trace) {
-  CHECK_EQ(pthread_self(), sampling_pthread_);
+  // Run either by the sampled thread itself at a checkpoint, or by the sampling thread on
+  // behalf of a thread whose suspend count it holds.
+  DCHECK(thread == Thread::Current() || thread->IsSuspended());
   std::vector<ArtMethod*>* old_stack_trace = thread->GetStackTraceSample();
   // Update the thread's stack trace sample.
   thread->SetStackTraceSample(stack_trace);
@@ -282,6 +326,7 @@ void* Trace::RunSamplingThread(void* arg) {
   CHECK(runtime->AttachCurrentThread("Sampling Profiler", true, runtime->GetSystemThreadGroup(),
                                      !runtime->IsAotCompiler()));
 
+  Barrier barrier(0);
   while (true) {
     usleep(interval_us);
     ScopedTrace trace("Profile sampling");
@@ -294,10 +339,18 @@ void* Trace::RunSamplingThread(void* arg) {
         break;
       }
     }
-    {
-      ScopedSuspendAll ssa(__FUNCTION__);
-      MutexLock mu(self, *Locks::thread_list_lock_);
-      runtime->GetThreadList()->ForEach(GetSample, the_trace);
+    // Sample through the checkpoint mechanism rather than suspending the world: runnable
+    // threads walk their own stack at the next safepoint and already suspended threads are
+    // walked from here, so mutators are never stopped in bulk.
+    TraceSampleCheckpoint check_point(the_trace, &barrier);
+    barrier.Init(self, 0);
+    size_t barrier_count = runtime->GetThreadList()->RunCheckpoint(&check_point);
+    if (barrier_count != 0) {
+      // Checkpoints run here for suspended threads have already passed the barrier.
+      ScopedThreadStateChange tsc(self, kWaitingForCheckPointsToRun);
+      static constexpr uint32_t kSampleBarrierTimeoutMs = 10000;
+      bool timed_out = barrier.Increment(self, barrier_count, kSampleBarrierTimeoutMs);
+      CHECK(!timed_out);
     }
   }
 
@@ -307,6 +360,20 @@ void* Trace::RunSamplingThread(void* arg) {
 
 void Trace::Start(const char* trace_filename, int trace_fd, size_t buffer_size, int flags,
                   TraceOutputMode output_mode, TraceMode trace_mode, int interval_us) {
+  StartInternal(trace_filename, trace_fd, buffer_size, flags, output_mode, trace_mode, interval_us,
+                /* selected_methods */ nullptr);
+}
+
+void Trace::StartSelective(const char* trace_filename, int trace_fd, size_t buffer_size,
+                           int flags, TraceOutputMode output_mode,
+                           const std::vector<ArtMethod*>& methods) {
+  StartInternal(trace_filename, trace_fd, buffer_size, flags, output_mode,
+                TraceMode::kMethodTracing, /* interval_us */ 0, &methods);
+}
+
+void Trace::StartInternal(const char* trace_filename, int trace_fd, size_t buffer_size, int flags,
+                          TraceOutputMode output_mode, TraceMode trace_mode, int interval_us,
+                          const std::vector<ArtMethod*>* selected_methods) {
   Thread* self = Thread::Current();
   {
     MutexLock mu(self, *Locks::trace_lock_);
@@ -360,6 +427,19 @@ void Trace::Start(const char* trace_filename, int trace_fd, size_t buffer_size,
       enable_stats = (flags && kTraceCountAllocs) != 0;
       the_trace_ = new Trace(trace_file.release(), trace_filename, buffer_size, flags, output_mode,
                              trace_mode);
+      if (selected_methods != nullptr) {
+        the_trace_->selective_ = true;
+        for (ArtMethod* method : *selected_methods) {
+          // The instrumentation entry stub cannot be installed on these, see
+          // InstrumentMethodEntryExit.
+          if (method->IsNative() || method->IsProxyMethod() || !method->IsInvokable()) {
+            LOG(WARNING) << "Not tracing " << PrettyMethod(method)
+                         << ": cannot install the instrumentation entry stub";
+            continue;
+          }
+          the_trace_->selected_methods_.insert(method);
+        }
+      }
       if (trace_mode == TraceMode::kSampling) {
         CHECK_PTHREAD_CALL(pthread_create, (&sampling_pthread_, nullptr, &RunSamplingThread,
                                             reinterpret_cast<void*>(interval_us)),
@@ -370,8 +450,16 @@ void Trace::Start(const char* trace_filename, int trace_fd, size_t buffer_size,
                                                    instrumentation::Instrumentation::kMethodEntered |
                                                    instrumentation::Instrumentation::kMethodExited |
                                                    instrumentation::Instrumentation::kMethodUnwind);
-        // TODO: In full-PIC mode, we don't need to fully deopt.
-        runtime->GetInstrumentation()->EnableMethodTracing(kTracerInstrumentationKey);
+        if (the_trace_->selective_) {
+          // Flip only the selected methods' entrypoints; everything else keeps running its
+          // compiled code with no tracing overhead.
+          for (ArtMethod* method : the_trace_->selected_methods_) {
+            runtime->GetInstrumentation()->InstrumentMethodEntryExit(method);
+          }
+        } else {
+          // TODO: In full-PIC mode, we don't need to fully deopt.
+          runtime->GetInstrumentation()->EnableMethodTracing(kTracerInstrumentationKey);
+        }
       }
     }
   }
@@ -421,12 +509,23 @@ void Trace::StopTracing(bool finish_tracing, bool flush_file) {
         MutexLock mu(self, *Locks::thread_list_lock_);
         runtime->GetThreadList()->ForEach(ClearThreadStackTraceAndClockBase, nullptr);
       } else {
-        runtime->GetInstrumentation()->DisableMethodTracing(kTracerInstrumentationKey);
+        if (the_trace->selective_) {
+          for (ArtMethod* method : the_trace->selected_methods_) {
+            runtime->GetInstrumentation()->UninstrumentMethodEntryExit(method);
+          }
+        } else {
+          runtime->GetInstrumentation()->DisableMethodTracing(kTracerInstrumentationKey);
+        }
         runtime->GetInstrumentation()->RemoveListener(
             the_trace, instrumentation::Instrumentation::kMethodEntered |
             instrumentation::Instrumentation::kMethodExited |
             instrumentation::Instrumentation::kMethodUnwind);
       }
+      if (the_trace->trace_output_mode_ == TraceOutputMode::kStreaming) {
+        // Release the per-thread buffers, flushed by FinishTracing() if the data was wanted.
+        MutexLock mu(self, *Locks::thread_list_lock_);
+        runtime->GetThreadList()->ForEach(ReleaseThreadBufferCallback, nullptr);
+      }
       if (the_trace->trace_file_.get() != nullptr) {
         // Do not try to erase, so flush and close explicitly.
         if (flush_file) {
@@ -507,7 +606,13 @@ void Trace::Pause() {
       MutexLock mu(self, *Locks::thread_list_lock_);
       runtime->GetThreadList()->ForEach(ClearThreadStackTraceAndClockBase, nullptr);
     } else {
-      runtime->GetInstrumentation()->DisableMethodTracing(kTracerInstrumentationKey);
+      if (the_trace->selective_) {
+        for (ArtMethod* method : the_trace->selected_methods_) {
+          runtime->GetInstrumentation()->UninstrumentMethodEntryExit(method);
+        }
+      } else {
+        runtime->GetInstrumentation()->DisableMethodTracing(kTracerInstrumentationKey);
+      }
       runtime->GetInstrumentation()->RemoveListener(
           the_trace,
           instrumentation::Instrumentation::kMethodEntered |
@@ -554,8 +659,14 @@ void Trace::Resume() {
                                                  instrumentation::Instrumentation::kMethodEntered |
                                                  instrumentation::Instrumentation::kMethodExited |
                                                  instrumentation::Instrumentation::kMethodUnwind);
-      // TODO: In full-PIC mode, we don't need to fully deopt.
-      runtime->GetInstrumentation()->EnableMethodTracing(kTracerInstrumentationKey);
+      if (the_trace->selective_) {
+        for (ArtMethod* method : the_trace->selected_methods_) {
+          runtime->GetInstrumentation()->InstrumentMethodEntryExit(method);
+        }
+      } else {
+        // TODO: In full-PIC mode, we don't need to fully deopt.
+        runtime->GetInstrumentation()->EnableMethodTracing(kTracerInstrumentationKey);
+      }
     }
   }
 
@@ -591,7 +702,7 @@ Trace::Trace(File* trace_file, const char* trace_name, size_t buffer_size, int f
       clock_source_(default_clock_source_),
       buffer_size_(std::max(kMinBufSize, buffer_size)),
       start_time_(MicroTime()), clock_overhead_ns_(GetClockOverheadNanoSeconds()), cur_offset_(0),
-      overflow_(false), interval_us_(0), streaming_lock_(nullptr),
+      overflow_(false), interval_us_(0), selective_(false), streaming_lock_(nullptr),
       unique_methods_lock_(new Mutex("unique methods lock", kTracingUniqueMethodsLock)) {
   uint16_t trace_version = GetTraceVersion(clock_source_);
   if (output_mode == TraceOutputMode::kStreaming) {
@@ -645,33 +756,32 @@ void Trace::DumpBuf(uint8_t* buf, size_t buf_size, TraceClockSource clock_source
   }
 }
 
-static void GetVisitedMethodsFromBitSets(
-    const std::map<const DexFile*, DexIndexBitSet*>& seen_methods,
-    std::set<ArtMethod*>* visited_methods) SHARED_REQUIRES(Locks::mutator_lock_) {
-  ClassLinker* class_linker = Runtime::Current()->GetClassLinker();
-  Thread* const self = Thread::Current();
-  for (auto& e : seen_methods) {
-    DexIndexBitSet* bit_set = e.second;
-    // TODO: Visit trace methods as roots.
-    mirror::DexCache* dex_cache = class_linker->FindDexCache(self, *e.first, false);
-    for (uint32_t i = 0; i < bit_set->size(); ++i) {
-      if ((*bit_set)[i]) {
-        visited_methods->insert(dex_cache->GetResolvedMethod(i, sizeof(void*)));
-      }
-    }
-  }
-}
-
 void Trace::FinishTracing() {
   size_t final_offset = 0;
 
   std::set<ArtMethod*> visited_methods;
   if (trace_output_mode_ == TraceOutputMode::kStreaming) {
-    // Write the secondary file with all the method names.
-    GetVisitedMethodsFromBitSets(seen_methods_, &visited_methods);
-
-    // Clean up.
-    STLDeleteValues(&seen_methods_);
+    // The threads are suspended here, so the per-thread buffers cannot grow concurrently.
+    // Flush them, then the tail of the shared buffer, which WriteToBuf() only writes out
+    // once it runs full.
+    {
+      MutexLock mu(Thread::Current(), *Locks::thread_list_lock_);
+      Runtime::Current()->GetThreadList()->ForEach(FlushThreadBufferCallback, this);
+    }
+    {
+      MutexLock mu(Thread::Current(), *streaming_lock_);
+      const size_t offset = static_cast<size_t>(cur_offset_.LoadRelaxed());
+      if (offset > 0u && trace_file_.get() != nullptr &&
+          !trace_file_->WriteFully(buf_.get(), offset)) {
+        PLOG(WARNING) << "Failed streaming the tail of the tracing buffer.";
+      }
+      cur_offset_.StoreRelease(0);
+    }
+    // Write the secondary file with all the method names. TODO: Visit trace methods as roots.
+    {
+      MutexLock mu(Thread::Current(), *unique_methods_lock_);
+      visited_methods.insert(unique_methods_.begin(), unique_methods_.end());
+    }
   } else {
     final_offset = cur_offset_.LoadRelaxed();
     GetVisitedMethods(final_offset, &visited_methods);
@@ -784,6 +894,10 @@ void Trace::FieldWritten(Thread* thread ATTRIBUTE_UNUSED,
 
 void Trace::MethodEntered(Thread* thread, mirror::Object* this_object ATTRIBUTE_UNUSED,
                           ArtMethod* method, uint32_t dex_pc ATTRIBUTE_UNUSED) {
+  if (UNLIKELY(selective_ && selected_methods_.find(method) == selected_methods_.end())) {
+    // The interpreter reports every method to entry/exit listeners, drop the unselected ones.
+    return;
+  }
   uint32_t thread_clock_diff = 0;
   uint32_t wall_clock_diff = 0;
   ReadClocks(thread, &thread_clock_diff, &wall_clock_diff);
@@ -794,6 +908,9 @@ void Trace::MethodEntered(Thread* thread, mirror::Object* this_object ATTRIBUTE_
 void Trace::MethodExited(Thread* thread, mirror::Object* this_object ATTRIBUTE_UNUSED,
                          ArtMethod* method, uint32_t dex_pc ATTRIBUTE_UNUSED,
                          const JValue& return_value ATTRIBUTE_UNUSED) {
+  if (UNLIKELY(selective_ && selected_methods_.find(method) == selected_methods_.end())) {
+    return;
+  }
   uint32_t thread_clock_diff = 0;
   uint32_t wall_clock_diff = 0;
   ReadClocks(thread, &thread_clock_diff, &wall_clock_diff);
@@ -803,6 +920,9 @@ void Trace::MethodExited(Thread* thread, mirror::Object* this_object ATTRIBUTE_U
 
 void Trace::MethodUnwind(Thread* thread, mirror::Object* this_object ATTRIBUTE_UNUSED,
                          ArtMethod* method, uint32_t dex_pc ATTRIBUTE_UNUSED) {
+  if (UNLIKELY(selective_ && selected_methods_.find(method) == selected_methods_.end())) {
+    return;
+  }
   uint32_t thread_clock_diff = 0;
   uint32_t wall_clock_diff = 0;
   ReadClocks(thread, &thread_clock_diff, &wall_clock_diff);
@@ -847,25 +967,6 @@ void Trace::ReadClocks(Thread* thread, uint32_t* thread_clock_diff, uint32_t* wa
   }
 }
 
-bool Trace::RegisterMethod(ArtMethod* method) {
-  mirror::DexCache* dex_cache = method->GetDexCache();
-  const DexFile* dex_file = dex_cache->GetDexFile();
-  auto* resolved_method = dex_cache->GetResolvedMethod(method->GetDexMethodIndex(), sizeof(void*));
-  if (resolved_method != method) {
-    DCHECK(resolved_method == nullptr);
-    dex_cache->SetResolvedMethod(method->GetDexMethodIndex(), method, sizeof(void*));
-  }
-  if (seen_methods_.find(dex_file) == seen_methods_.end()) {
-    seen_methods_.insert(std::make_pair(dex_file, new DexIndexBitSet()));
-  }
-  DexIndexBitSet* bit_set = seen_methods_.find(dex_file)->second;
-  if (!(*bit_set)[method->GetDexMethodIndex()]) {
-    bit_set->set(method->GetDexMethodIndex());
-    return true;
-  }
-  return false;
-}
-
 bool Trace::RegisterThread(Thread* thread) {
   pid_t tid = thread->GetTid();
   CHECK_LT(0U, static_cast<uint32_t>(tid));
@@ -946,7 +1047,8 @@ void Trace::LogMethodTraceEvent(Thread* thread, ArtMethod* method,
       UNIMPLEMENTED(FATAL) << "Unexpected event: " << event;
   }
 
-  uint32_t method_value = EncodeTraceMethodAndAction(method, action);
+  bool is_new_method = false;
+  uint32_t method_value = EncodeTraceMethodAndAction(method, action, &is_new_method);
 
   // Write data
   uint8_t* ptr;
@@ -972,31 +1074,72 @@ void Trace::LogMethodTraceEvent(Thread* thread, ArtMethod* method,
   static_assert(kPacketSize == 2 + 4 + 4 + 4, "Packet size incorrect.");
 
   if (trace_output_mode_ == TraceOutputMode::kStreaming) {
-    MutexLock mu(Thread::Current(), *streaming_lock_);  // To serialize writing.
-    if (RegisterMethod(method)) {
+    // Definition blocks for newly seen methods and threads go to the shared buffer right
+    // away. Flushes of the per-thread buffers append to the shared buffer as well, so a
+    // definition always reaches the file before the first record referring to it.
+    if (UNLIKELY(is_new_method)) {
       // Write a special block with the name.
       std::string method_line(GetMethodLine(method));
       uint8_t buf2[5];
       Append2LE(buf2, 0);
       buf2[2] = kOpNewMethod;
       Append2LE(buf2 + 3, static_cast<uint16_t>(method_line.length()));
+      MutexLock mu(Thread::Current(), *streaming_lock_);  // To serialize writing.
       WriteToBuf(buf2, sizeof(buf2));
       WriteToBuf(reinterpret_cast<const uint8_t*>(method_line.c_str()), method_line.length());
     }
-    if (RegisterThread(thread)) {
-      // It might be better to postpone this. Threads might not have received names...
-      std::string thread_name;
-      thread->GetThreadName(thread_name);
-      uint8_t buf2[7];
-      Append2LE(buf2, 0);
-      buf2[2] = kOpNewThread;
-      Append2LE(buf2 + 3, static_cast<uint16_t>(thread->GetTid()));
-      Append2LE(buf2 + 5, static_cast<uint16_t>(thread_name.length()));
-      WriteToBuf(buf2, sizeof(buf2));
-      WriteToBuf(reinterpret_cast<const uint8_t*>(thread_name.c_str()), thread_name.length());
+    uint8_t* thread_buffer = thread->GetMethodTraceBuffer();
+    if (UNLIKELY(thread_buffer == nullptr)) {
+      thread_buffer = new uint8_t[kPerThreadBufSize];
+      thread->SetMethodTraceBuffer(thread_buffer);
+      thread->SetMethodTraceBufferPos(0u);
+      MutexLock mu(Thread::Current(), *streaming_lock_);  // To serialize writing.
+      if (RegisterThread(thread)) {
+        // It might be better to postpone this. Threads might not have received names...
+        std::string thread_name;
+        thread->GetThreadName(thread_name);
+        uint8_t buf2[7];
+        Append2LE(buf2, 0);
+        buf2[2] = kOpNewThread;
+        Append2LE(buf2 + 3, static_cast<uint16_t>(thread->GetTid()));
+        Append2LE(buf2 + 5, static_cast<uint16_t>(thread_name.length()));
+        WriteToBuf(buf2, sizeof(buf2));
+        WriteToBuf(reinterpret_cast<const uint8_t*>(thread_name.c_str()), thread_name.length());
+      }
+    }
+    // Append the record to the per-thread buffer, taking the streaming lock only when the
+    // buffer must be flushed. Only one thread writes a given buffer at a time: its owner in
+    // instrumented mode; in sampling mode the owner samples itself at a checkpoint, or the
+    // sampling thread writes the buffer while holding the owner's suspend count.
+    size_t pos = thread->GetMethodTraceBufferPos();
+    if (UNLIKELY(pos + kPacketSize > kPerThreadBufSize)) {
+      FlushStreamingBuffer(thread);
+      pos = 0u;
     }
-    WriteToBuf(stack_buf, sizeof(stack_buf));
+    memcpy(thread_buffer + pos, stack_buf, kPacketSize);
+    thread->SetMethodTraceBufferPos(pos + kPacketSize);
+  }
+}
+
+void Trace::FlushStreamingBuffer(Thread* thread) {
+  uint8_t* buffer = thread->GetMethodTraceBuffer();
+  const size_t pos = thread->GetMethodTraceBufferPos();
+  if (buffer == nullptr || pos == 0u) {
+    return;
   }
+  MutexLock mu(Thread::Current(), *streaming_lock_);
+  WriteToBuf(buffer, pos);
+  thread->SetMethodTraceBufferPos(0u);
+}
+
+void Trace::FlushThreadBufferCallback(Thread* thread, void* arg) {
+  reinterpret_cast<Trace*>(arg)->FlushStreamingBuffer(thread);
+}
+
+void Trace::ReleaseThreadBufferCallback(Thread* thread, void* arg ATTRIBUTE_UNUSED) {
+  delete[] thread->GetMethodTraceBuffer();
+  thread->SetMethodTraceBuffer(nullptr);
+  thread->SetMethodTraceBufferPos(0u);
 }
 
 void Trace::GetVisitedMethods(size_t buf_size,
@@ -1043,6 +1186,9 @@ void Trace::StoreExitingThreadInfo(Thread* thread) {
     // The same thread/tid may be used multiple times. As SafeMap::Put does not allow to override
     // a previous mapping, use SafeMap::Overwrite.
     the_trace_->exited_threads_.Overwrite(thread->GetTid(), name);
+    // The thread is about to go away; flush and release its streaming buffer.
+    the_trace_->FlushStreamingBuffer(thread);
+    ReleaseThreadBufferCallback(thread, nullptr);
   }
 }
 
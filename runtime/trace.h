@@ -24,6 +24,7 @@
 #include <set>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include "atomic.h"
@@ -40,7 +41,6 @@ class ArtMethod;
 class DexFile;
 class Thread;
 
-using DexIndexBitSet = std::bitset<65536>;
 using ThreadIDBitSet = std::bitset<65536>;
 
 enum TracingMode {
@@ -116,6 +116,15 @@ class Trace FINAL : public instrumentation::InstrumentationListener {
                     TraceOutputMode output_mode, TraceMode trace_mode, int interval_us)
       REQUIRES(!Locks::mutator_lock_, !Locks::thread_list_lock_, !Locks::thread_suspend_count_lock_,
                !Locks::trace_lock_);
+  // Start tracing restricted to the given methods: only their entrypoints are flipped to the
+  // instrumentation entry stub, every other method keeps running its compiled code untouched.
+  // Methods the stub cannot be installed on (native, proxy, not invokable) are skipped with a
+  // warning. Selective traces always use method tracing, never sampling.
+  static void StartSelective(const char* trace_filename, int trace_fd, size_t buffer_size,
+                             int flags, TraceOutputMode output_mode,
+                             const std::vector<ArtMethod*>& methods)
+      REQUIRES(!Locks::mutator_lock_, !Locks::thread_list_lock_, !Locks::thread_suspend_count_lock_,
+               !Locks::trace_lock_);
   static void Pause() REQUIRES(!Locks::trace_lock_, !Locks::thread_list_lock_);
   static void Resume() REQUIRES(!Locks::trace_lock_);
 
@@ -190,6 +199,14 @@ class Trace FINAL : public instrumentation::InstrumentationListener {
   Trace(File* trace_file, const char* trace_name, size_t buffer_size, int flags,
         TraceOutputMode output_mode, TraceMode trace_mode);
 
+  // Common implementation of Start and StartSelective. selected_methods is null when tracing
+  // everything.
+  static void StartInternal(const char* trace_filename, int trace_fd, size_t buffer_size,
+                            int flags, TraceOutputMode output_mode, TraceMode trace_mode,
+                            int interval_us, const std::vector<ArtMethod*>* selected_methods)
+      REQUIRES(!Locks::mutator_lock_, !Locks::thread_list_lock_, !Locks::thread_suspend_count_lock_,
+               !Locks::trace_lock_);
+
   // The sampling interval in microseconds is passed as an argument.
   static void* RunSamplingThread(void* arg) REQUIRES(!Locks::trace_lock_);
 
@@ -200,7 +217,8 @@ class Trace FINAL : public instrumentation::InstrumentationListener {
       // This causes the negative annotations to incorrectly have a false positive. TODO: Figure out
       // how to annotate this.
       NO_THREAD_SAFETY_ANALYSIS;
-  void FinishTracing() SHARED_REQUIRES(Locks::mutator_lock_) REQUIRES(!*unique_methods_lock_);
+  void FinishTracing()
+      SHARED_REQUIRES(Locks::mutator_lock_) REQUIRES(!*unique_methods_lock_, !*streaming_lock_);
 
   void ReadClocks(Thread* thread, uint32_t* thread_clock_diff, uint32_t* wall_clock_diff);
 
@@ -216,20 +234,32 @@ class Trace FINAL : public instrumentation::InstrumentationListener {
       SHARED_REQUIRES(Locks::mutator_lock_) REQUIRES(!*unique_methods_lock_);
   void DumpThreadList(std::ostream& os) REQUIRES(!Locks::thread_list_lock_);
 
-  // Methods to register seen entitites in streaming mode. The methods return true if the entity
-  // is newly discovered.
-  bool RegisterMethod(ArtMethod* method)
-      SHARED_REQUIRES(Locks::mutator_lock_) REQUIRES(streaming_lock_);
+  // Method to register seen threads in streaming mode. Returns true if the thread is newly
+  // discovered. Newly seen methods are detected through EncodeTraceMethod() instead.
   bool RegisterThread(Thread* thread)
       REQUIRES(streaming_lock_);
 
+  // Flush the pending streaming events of the given thread, if any, to the shared buffer.
+  void FlushStreamingBuffer(Thread* thread) REQUIRES(!*streaming_lock_);
+
+  // ThreadList::ForEach callbacks for flushing and releasing the per-thread streaming buffers.
+  static void FlushThreadBufferCallback(Thread* thread, void* arg)
+      SHARED_REQUIRES(Locks::mutator_lock_) NO_THREAD_SAFETY_ANALYSIS;
+  static void ReleaseThreadBufferCallback(Thread* thread, void* arg)
+      NO_THREAD_SAFETY_ANALYSIS;
+
   // Copy a temporary buffer to the main buffer. Used for streaming. Exposed here for lock
   // annotation.
   void WriteToBuf(const uint8_t* src, size_t src_size)
       REQUIRES(streaming_lock_);
 
   uint32_t EncodeTraceMethod(ArtMethod* method) REQUIRES(!*unique_methods_lock_);
-  uint32_t EncodeTraceMethodAndAction(ArtMethod* method, TraceAction action)
+  // As above, but also reports whether this was the first time the method was encoded, so
+  // that streaming mode can emit the definition block of a newly seen method.
+  uint32_t EncodeTraceMethod(ArtMethod* method, /*out*/ bool* is_new_method)
+      REQUIRES(!*unique_methods_lock_);
+  uint32_t EncodeTraceMethodAndAction(ArtMethod* method, TraceAction action,
+                                      /*out*/ bool* is_new_method)
       REQUIRES(!*unique_methods_lock_);
   ArtMethod* DecodeTraceMethod(uint32_t tmid) REQUIRES(!*unique_methods_lock_);
   std::string GetMethodLine(ArtMethod* method) REQUIRES(!*unique_methods_lock_)
@@ -247,8 +277,9 @@ class Trace FINAL : public instrumentation::InstrumentationListener {
   // Sampling thread, non-zero when sampling.
   static pthread_t sampling_pthread_;
 
-  // Used to remember an unused stack trace to avoid re-allocation during sampling.
-  static std::unique_ptr<std::vector<ArtMethod*>> temp_stack_trace_;
+  // Used to remember an unused stack trace to avoid re-allocation during sampling. Accessed
+  // with compare-and-swap since sampling checkpoints run on the sampled threads concurrently.
+  static Atomic<std::vector<ArtMethod*>*> temp_stack_trace_;
 
   // File to write trace data out to, null if direct to ddms.
   std::unique_ptr<File> trace_file_;
@@ -288,10 +319,18 @@ class Trace FINAL : public instrumentation::InstrumentationListener {
   // Sampling profiler sampling interval.
   int interval_us_;
 
+  // True when this trace is restricted to selected_methods_. Only those methods carry the
+  // instrumentation entry stub; methods running in the interpreter still report entry/exit
+  // events, which the listener callbacks drop when the method is not selected.
+  bool selective_;
+
+  // The traced methods when selective_. Filled under suspension before instrumentation is
+  // installed and immutable afterwards, so the listener callbacks read it without locking.
+  std::unordered_set<ArtMethod*> selected_methods_;
+
   // Streaming mode data.
   std::string streaming_file_name_;
   Mutex* streaming_lock_;
-  std::map<const DexFile*, DexIndexBitSet*> seen_methods_;
   std::unique_ptr<ThreadIDBitSet> seen_threads_;
 
   // Bijective map from ArtMethod* to index.
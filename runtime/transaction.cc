@@ -19,11 +19,14 @@
 #include "base/stl_util.h"
 #include "base/logging.h"
 #include "gc/accounting/card_table-inl.h"
+#include "gc/heap.h"
 #include "intern_table.h"
 #include "mirror/class-inl.h"
 #include "mirror/object-inl.h"
 #include "mirror/object_array-inl.h"
+#include "runtime.h"
 
+#include <algorithm>
 #include <list>
 
 namespace art {
@@ -32,22 +35,27 @@ namespace art {
 static constexpr bool kEnableTransactionStats = false;
 
 Transaction::Transaction()
-  : log_lock_("transaction log lock", kTransactionLogLock), aborted_(false) {
+  : log_lock_("transaction log lock", kTransactionLogLock),
+    allocator_(Runtime::Current()->GetArenaPool()),
+    object_logs_(allocator_.Adapter(kArenaAllocTransaction)),
+    array_logs_(allocator_.Adapter(kArenaAllocTransaction)),
+    intern_string_logs_(allocator_.Adapter(kArenaAllocTransaction)),
+    aborted_(false) {
   CHECK(Runtime::Current()->IsAotCompiler());
 }
 
 Transaction::~Transaction() {
   if (kEnableTransactionStats) {
     MutexLock mu(Thread::Current(), log_lock_);
-    size_t objects_count = object_logs_.size();
+    size_t objects_count = object_logs_.Size();
     size_t field_values_count = 0;
-    for (auto it : object_logs_) {
-      field_values_count += it.second.Size();
+    for (const auto& it : object_logs_) {
+      field_values_count += it.second->Size();
     }
-    size_t array_count = array_logs_.size();
+    size_t array_count = array_logs_.Size();
     size_t array_values_count = 0;
-    for (auto it : array_logs_) {
-      array_values_count += it.second.Size();
+    for (const auto& it : array_logs_) {
+      array_values_count += it.second->Size();
     }
     size_t string_count = intern_string_logs_.size();
     LOG(INFO) << "Transaction::~Transaction"
@@ -102,24 +110,21 @@ void Transaction::RecordWriteFieldBoolean(mirror::Object* obj, MemberOffset fiel
                                           uint8_t value, bool is_volatile) {
   DCHECK(obj != nullptr);
   MutexLock mu(Thread::Current(), log_lock_);
-  ObjectLog& object_log = object_logs_[obj];
-  object_log.LogBooleanValue(field_offset, value, is_volatile);
+  GetOrCreateObjectLog(obj)->LogBooleanValue(field_offset, value, is_volatile);
 }
 
 void Transaction::RecordWriteFieldByte(mirror::Object* obj, MemberOffset field_offset,
                                        int8_t value, bool is_volatile) {
   DCHECK(obj != nullptr);
   MutexLock mu(Thread::Current(), log_lock_);
-  ObjectLog& object_log = object_logs_[obj];
-  object_log.LogByteValue(field_offset, value, is_volatile);
+  GetOrCreateObjectLog(obj)->LogByteValue(field_offset, value, is_volatile);
 }
 
 void Transaction::RecordWriteFieldChar(mirror::Object* obj, MemberOffset field_offset,
                                        uint16_t value, bool is_volatile) {
   DCHECK(obj != nullptr);
   MutexLock mu(Thread::Current(), log_lock_);
-  ObjectLog& object_log = object_logs_[obj];
-  object_log.LogCharValue(field_offset, value, is_volatile);
+  GetOrCreateObjectLog(obj)->LogCharValue(field_offset, value, is_volatile);
 }
 
 
@@ -127,8 +132,7 @@ void Transaction::RecordWriteFieldShort(mirror::Object* obj, MemberOffset field_
                                         int16_t value, bool is_volatile) {
   DCHECK(obj != nullptr);
   MutexLock mu(Thread::Current(), log_lock_);
-  ObjectLog& object_log = object_logs_[obj];
-  object_log.LogShortValue(field_offset, value, is_volatile);
+  GetOrCreateObjectLog(obj)->LogShortValue(field_offset, value, is_volatile);
 }
 
 
@@ -136,24 +140,21 @@ void Transaction::RecordWriteField32(mirror::Object* obj, MemberOffset field_off
                                      bool is_volatile) {
   DCHECK(obj != nullptr);
   MutexLock mu(Thread::Current(), log_lock_);
-  ObjectLog& object_log = object_logs_[obj];
-  object_log.Log32BitsValue(field_offset, value, is_volatile);
+  GetOrCreateObjectLog(obj)->Log32BitsValue(field_offset, value, is_volatile);
 }
 
 void Transaction::RecordWriteField64(mirror::Object* obj, MemberOffset field_offset, uint64_t value,
                                      bool is_volatile) {
   DCHECK(obj != nullptr);
   MutexLock mu(Thread::Current(), log_lock_);
-  ObjectLog& object_log = object_logs_[obj];
-  object_log.Log64BitsValue(field_offset, value, is_volatile);
+  GetOrCreateObjectLog(obj)->Log64BitsValue(field_offset, value, is_volatile);
 }
 
 void Transaction::RecordWriteFieldReference(mirror::Object* obj, MemberOffset field_offset,
                                             mirror::Object* value, bool is_volatile) {
   DCHECK(obj != nullptr);
   MutexLock mu(Thread::Current(), log_lock_);
-  ObjectLog& object_log = object_logs_[obj];
-  object_log.LogReferenceValue(field_offset, value, is_volatile);
+  GetOrCreateObjectLog(obj)->LogReferenceValue(field_offset, value, is_volatile);
 }
 
 void Transaction::RecordWriteArray(mirror::Array* array, size_t index, uint64_t value) {
@@ -161,8 +162,51 @@ void Transaction::RecordWriteArray(mirror::Array* array, size_t index, uint64_t
   DCHECK(array->IsArrayInstance());
   DCHECK(!array->IsObjectArray());
   MutexLock mu(Thread::Current(), log_lock_);
-  ArrayLog& array_log = array_logs_[array];
-  array_log.LogValue(index, value);
+  GetOrCreateArrayLog(array)->LogValue(index, value);
+}
+
+static uint64_t ReadArrayValue(mirror::Array* array, Primitive::Type array_type, size_t index)
+    SHARED_REQUIRES(Locks::mutator_lock_) {
+  switch (array_type) {
+    case Primitive::kPrimBoolean:
+      return array->AsBooleanArray()->GetWithoutChecks(index);
+    case Primitive::kPrimByte:
+      return array->AsByteArray()->GetWithoutChecks(index);
+    case Primitive::kPrimChar:
+      return array->AsCharArray()->GetWithoutChecks(index);
+    case Primitive::kPrimShort:
+      return array->AsShortArray()->GetWithoutChecks(index);
+    case Primitive::kPrimInt:
+      return array->AsIntArray()->GetWithoutChecks(index);
+    case Primitive::kPrimFloat:
+      return array->AsFloatArray()->GetWithoutChecks(index);
+    case Primitive::kPrimLong:
+      return array->AsLongArray()->GetWithoutChecks(index);
+    case Primitive::kPrimDouble:
+      return array->AsDoubleArray()->GetWithoutChecks(index);
+    case Primitive::kPrimNot:
+      LOG(FATAL) << "ObjectArray should be treated as Object";
+      UNREACHABLE();
+    default:
+      LOG(FATAL) << "Unsupported type " << array_type;
+      UNREACHABLE();
+  }
+}
+
+void Transaction::RecordWriteArrayRange(mirror::Array* array, size_t start_index, size_t count) {
+  DCHECK(array != nullptr);
+  DCHECK(array->IsArrayInstance());
+  DCHECK(!array->IsObjectArray());
+  if (UNLIKELY(count == 0)) {
+    return;
+  }
+  Primitive::Type type = array->GetClass()->GetComponentType()->GetPrimitiveType();
+  MutexLock mu(Thread::Current(), log_lock_);
+  ArrayLog* array_log = GetOrCreateArrayLog(array);
+  for (size_t i = 0; i < count; ++i) {
+    size_t index = start_index + i;
+    array_log->LogValue(index, ReadArrayValue(array, type, index));
+  }
 }
 
 void Transaction::RecordStrongStringInsertion(mirror::String* s) {
@@ -185,12 +229,48 @@ void Transaction::RecordWeakStringRemoval(mirror::String* s) {
   LogInternedString(log);
 }
 
+Transaction::ObjectLog* Transaction::GetOrCreateObjectLog(mirror::Object* obj) {
+  auto it = object_logs_.Find(obj);
+  if (it == object_logs_.end()) {
+    ObjectLog* log = new (&allocator_) ObjectLog(&allocator_);
+    object_logs_.Insert(std::make_pair(obj, log));
+    return log;
+  }
+  return it->second;
+}
+
+Transaction::ArrayLog* Transaction::GetOrCreateArrayLog(mirror::Array* array) {
+  auto it = array_logs_.Find(array);
+  if (it == array_logs_.end()) {
+    ArrayLog* log = new (&allocator_) ArrayLog(&allocator_);
+    array_logs_.Insert(std::make_pair(array, log));
+    return log;
+  }
+  return it->second;
+}
+
 void Transaction::LogInternedString(const InternStringLog& log) {
   Locks::intern_table_lock_->AssertExclusiveHeld(Thread::Current());
   MutexLock mu(Thread::Current(), log_lock_);
   intern_string_logs_.push_front(log);
 }
 
+bool Transaction::WroteToBootImage() {
+  gc::Heap* const heap = Runtime::Current()->GetHeap();
+  MutexLock mu(Thread::Current(), log_lock_);
+  for (const auto& it : object_logs_) {
+    if (heap->ObjectIsInBootImageSpace(it.first)) {
+      return true;
+    }
+  }
+  for (const auto& it : array_logs_) {
+    if (heap->ObjectIsInBootImageSpace(it.first)) {
+      return true;
+    }
+  }
+  return false;
+}
+
 void Transaction::Rollback() {
   CHECK(!Runtime::Current()->IsActiveTransaction());
   Thread* self = Thread::Current();
@@ -205,19 +285,19 @@ void Transaction::Rollback() {
 void Transaction::UndoObjectModifications() {
   // TODO we may not need to restore objects allocated during this transaction. Or we could directly
   // remove them from the heap.
-  for (auto it : object_logs_) {
-    it.second.Undo(it.first);
+  for (const auto& it : object_logs_) {
+    it.second->Undo(it.first);
   }
-  object_logs_.clear();
+  object_logs_.Clear();
 }
 
 void Transaction::UndoArrayModifications() {
   // TODO we may not need to restore array allocated during this transaction. Or we could directly
   // remove them from the heap.
-  for (auto it : array_logs_) {
-    it.second.Undo(it.first);
+  for (const auto& it : array_logs_) {
+    it.second->Undo(it.first);
   }
-  array_logs_.clear();
+  array_logs_.Clear();
 }
 
 void Transaction::UndoInternStringTableModifications() {
@@ -243,8 +323,8 @@ void Transaction::VisitObjectLogs(RootVisitor* visitor) {
   std::list<ObjectPair> moving_roots;
 
   // Visit roots.
-  for (auto it : object_logs_) {
-    it.second.VisitRoots(visitor);
+  for (auto& it : object_logs_) {
+    it.second->VisitRoots(visitor);
     mirror::Object* old_root = it.first;
     mirror::Object* new_root = old_root;
     visitor->VisitRoot(&new_root, RootInfo(kRootUnknown));
@@ -257,11 +337,12 @@ void Transaction::VisitObjectLogs(RootVisitor* visitor) {
   for (const ObjectPair& pair : moving_roots) {
     mirror::Object* old_root = pair.first;
     mirror::Object* new_root = pair.second;
-    auto old_root_it = object_logs_.find(old_root);
+    auto old_root_it = object_logs_.Find(old_root);
     CHECK(old_root_it != object_logs_.end());
-    CHECK(object_logs_.find(new_root) == object_logs_.end());
-    object_logs_.insert(std::make_pair(new_root, old_root_it->second));
-    object_logs_.erase(old_root_it);
+    CHECK(object_logs_.Find(new_root) == object_logs_.end());
+    ObjectLog* log = old_root_it->second;
+    object_logs_.Erase(old_root_it);
+    object_logs_.Insert(std::make_pair(new_root, log));
   }
 }
 
@@ -270,7 +351,7 @@ void Transaction::VisitArrayLogs(RootVisitor* visitor) {
   typedef std::pair<mirror::Array*, mirror::Array*> ArrayPair;
   std::list<ArrayPair> moving_roots;
 
-  for (auto it : array_logs_) {
+  for (auto& it : array_logs_) {
     mirror::Array* old_root = it.first;
     CHECK(!old_root->IsObjectArray());
     mirror::Array* new_root = old_root;
@@ -284,11 +365,12 @@ void Transaction::VisitArrayLogs(RootVisitor* visitor) {
   for (const ArrayPair& pair : moving_roots) {
     mirror::Array* old_root = pair.first;
     mirror::Array* new_root = pair.second;
-    auto old_root_it = array_logs_.find(old_root);
+    auto old_root_it = array_logs_.Find(old_root);
     CHECK(old_root_it != array_logs_.end());
-    CHECK(array_logs_.find(new_root) == array_logs_.end());
-    array_logs_.insert(std::make_pair(new_root, old_root_it->second));
-    array_logs_.erase(old_root_it);
+    CHECK(array_logs_.Find(new_root) == array_logs_.end());
+    ArrayLog* log = old_root_it->second;
+    array_logs_.Erase(old_root_it);
+    array_logs_.Insert(std::make_pair(new_root, log));
   }
 }
 
@@ -328,21 +410,25 @@ void Transaction::ObjectLog::LogReferenceValue(MemberOffset offset, mirror::Obje
 
 void Transaction::ObjectLog::LogValue(ObjectLog::FieldValueKind kind,
                                       MemberOffset offset, uint64_t value, bool is_volatile) {
-  auto it = field_values_.find(offset.Uint32Value());
-  if (it == field_values_.end()) {
-    ObjectLog::FieldValue field_value;
-    field_value.value = value;
-    field_value.is_volatile = is_volatile;
-    field_value.kind = kind;
-    field_values_.insert(std::make_pair(offset.Uint32Value(), field_value));
+  for (const FieldValue& field_value : field_values_) {
+    if (field_value.offset == offset.Uint32Value()) {
+      // We keep the original, pre-transaction value.
+      return;
+    }
   }
+  ObjectLog::FieldValue field_value;
+  field_value.value = value;
+  field_value.offset = offset.Uint32Value();
+  field_value.is_volatile = is_volatile;
+  field_value.kind = kind;
+  field_values_.push_back(field_value);
 }
 
 void Transaction::ObjectLog::Undo(mirror::Object* obj) {
-  for (auto& it : field_values_) {
+  for (const FieldValue& field_value : field_values_) {
     // Garbage collector needs to access object's class and array's length. So we don't rollback
     // these values.
-    MemberOffset field_offset(it.first);
+    MemberOffset field_offset(field_value.offset);
     if (field_offset.Uint32Value() == mirror::Class::ClassOffset().Uint32Value()) {
       // Skip Object::class field.
       continue;
@@ -352,7 +438,6 @@ void Transaction::ObjectLog::Undo(mirror::Object* obj) {
       // Skip Array::length field.
       continue;
     }
-    FieldValue& field_value = it.second;
     UndoFieldWrite(obj, field_offset, field_value);
   }
 }
@@ -431,8 +516,7 @@ void Transaction::ObjectLog::UndoFieldWrite(mirror::Object* obj, MemberOffset fi
 }
 
 void Transaction::ObjectLog::VisitRoots(RootVisitor* visitor) {
-  for (auto it : field_values_) {
-    FieldValue& field_value = it.second;
+  for (FieldValue& field_value : field_values_) {
     if (field_value.kind == ObjectLog::kReference) {
       visitor->VisitRootIfNonNull(reinterpret_cast<mirror::Object**>(&field_value.value),
                                   RootInfo(kRootUnknown));
@@ -482,18 +566,45 @@ void Transaction::InternStringLog::VisitRoots(RootVisitor* visitor) {
 }
 
 void Transaction::ArrayLog::LogValue(size_t index, uint64_t value) {
-  auto it = array_values_.find(index);
-  if (it == array_values_.end()) {
-    array_values_.insert(std::make_pair(index, value));
+  // Find the range with the highest start index not greater than `index`.
+  auto it = std::upper_bound(ranges_.begin(), ranges_.end(), index,
+                             [](size_t lhs, const ArrayRange& rhs) {
+                               return lhs < rhs.start_index;
+                             });
+  if (it != ranges_.begin()) {
+    ArrayRange& range = *std::prev(it);
+    if (index < range.start_index + range.values.size()) {
+      // Already logged. We keep the original, pre-transaction value.
+      return;
+    }
+    if (index == range.start_index + range.values.size()) {
+      // Extend the previous run. This is the common case for bulk writes such as
+      // the arraycopy emulation, which log consecutive indexes.
+      range.values.push_back(value);
+      return;
+    }
   }
+  ArenaVector<uint64_t> values(ranges_.get_allocator());
+  values.push_back(value);
+  ranges_.insert(it, ArrayRange(index, std::move(values)));
+}
+
+size_t Transaction::ArrayLog::Size() const {
+  size_t result = 0u;
+  for (const ArrayRange& range : ranges_) {
+    result += range.values.size();
+  }
+  return result;
 }
 
 void Transaction::ArrayLog::Undo(mirror::Array* array) {
   DCHECK(array != nullptr);
   DCHECK(array->IsArrayInstance());
   Primitive::Type type = array->GetClass()->GetComponentType()->GetPrimitiveType();
-  for (auto it : array_values_) {
-    UndoArrayWrite(array, type, it.first, it.second);
+  for (const ArrayRange& range : ranges_) {
+    for (size_t i = 0, size = range.values.size(); i != size; ++i) {
+      UndoArrayWrite(array, type, range.start_index + i, range.values[i]);
+    }
   }
 }
 
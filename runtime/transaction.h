@@ -17,6 +17,9 @@
 #ifndef ART_RUNTIME_TRANSACTION_H_
 #define ART_RUNTIME_TRANSACTION_H_
 
+#include "base/arena_allocator.h"
+#include "base/arena_containers.h"
+#include "base/arena_object.h"
 #include "base/macros.h"
 #include "base/mutex.h"
 #include "base/value_object.h"
@@ -24,10 +27,8 @@
 #include "object_callbacks.h"
 #include "offsets.h"
 #include "primitive.h"
-#include "safe_map.h"
 
-#include <list>
-#include <map>
+#include <utility>
 
 namespace art {
 namespace mirror {
@@ -81,6 +82,14 @@ class Transaction FINAL {
       REQUIRES(!log_lock_)
       SHARED_REQUIRES(Locks::mutator_lock_);
 
+  // Record the original values of a dense range of a primitive array. This is
+  // equivalent to calling RecordWriteArray for each element but only takes the
+  // log lock once, which matters for bulk operations like the arraycopy
+  // emulation of the unstarted runtime.
+  void RecordWriteArrayRange(mirror::Array* array, size_t start_index, size_t count)
+      REQUIRES(!log_lock_)
+      SHARED_REQUIRES(Locks::mutator_lock_);
+
   // Record intern string table changes.
   void RecordStrongStringInsertion(mirror::String* s)
       REQUIRES(Locks::intern_table_lock_)
@@ -95,6 +104,13 @@ class Transaction FINAL {
       REQUIRES(Locks::intern_table_lock_)
       REQUIRES(!log_lock_);
 
+  // Returns true if the transaction wrote to an object allocated in the boot image. Such
+  // side effects cannot be preserved when writing an app image, so a class initializer
+  // that escapes the app's own objects must be rolled back.
+  bool WroteToBootImage()
+      REQUIRES(!log_lock_)
+      SHARED_REQUIRES(Locks::mutator_lock_);
+
   // Abort transaction by undoing all recorded changes.
   void Rollback()
       SHARED_REQUIRES(Locks::mutator_lock_)
@@ -105,8 +121,14 @@ class Transaction FINAL {
       SHARED_REQUIRES(Locks::mutator_lock_);
 
  private:
-  class ObjectLog : public ValueObject {
+  // The undo logs are allocated in an arena owned by the transaction so that recording
+  // a write does not hit the native allocator; everything is released in one go when
+  // the transaction is destroyed.
+  class ObjectLog : public ArenaObject<kArenaAllocTransaction> {
    public:
+    explicit ObjectLog(ArenaAllocator* allocator)
+        : field_values_(allocator->Adapter(kArenaAllocTransaction)) {}
+
     void LogBooleanValue(MemberOffset offset, uint8_t value, bool is_volatile);
     void LogByteValue(MemberOffset offset, int8_t value, bool is_volatile);
     void LogCharValue(MemberOffset offset, uint16_t value, bool is_volatile);
@@ -135,6 +157,7 @@ class Transaction FINAL {
     struct FieldValue : public ValueObject {
       // TODO use JValue instead ?
       uint64_t value;
+      uint32_t offset;
       FieldValueKind kind;
       bool is_volatile;
     };
@@ -143,27 +166,39 @@ class Transaction FINAL {
     void UndoFieldWrite(mirror::Object* obj, MemberOffset field_offset,
                         const FieldValue& field_value) SHARED_REQUIRES(Locks::mutator_lock_);
 
-    // Maps field's offset to its value.
-    std::map<uint32_t, FieldValue> field_values_;
+    // Original field values in recording order. An object has few distinct logged
+    // fields, so a flat arena-backed vector is cheaper than a node-based map.
+    ArenaVector<FieldValue> field_values_;
   };
 
-  class ArrayLog : public ValueObject {
+  class ArrayLog : public ArenaObject<kArenaAllocTransaction> {
    public:
+    explicit ArrayLog(ArenaAllocator* allocator)
+        : ranges_(allocator->Adapter(kArenaAllocTransaction)) {}
+
     void LogValue(size_t index, uint64_t value);
 
     void Undo(mirror::Array* obj) SHARED_REQUIRES(Locks::mutator_lock_);
 
-    size_t Size() const {
-      return array_values_.size();
-    }
+    size_t Size() const;
 
    private:
+    // A dense run of logged elements. Writes to consecutive indexes extend the
+    // previous run, so bulk operations like the arraycopy emulation produce one
+    // record instead of one map node per element.
+    struct ArrayRange : public ValueObject {
+      ArrayRange(size_t start, ArenaVector<uint64_t>&& v)
+          : start_index(start), values(std::move(v)) {}
+
+      size_t start_index;
+      ArenaVector<uint64_t> values;
+    };
+
     void UndoArrayWrite(mirror::Array* array, Primitive::Type array_type, size_t index,
                         uint64_t value) SHARED_REQUIRES(Locks::mutator_lock_);
 
-    // Maps index to value.
-    // TODO use JValue instead ?
-    std::map<size_t, uint64_t> array_values_;
+    // Non-overlapping ranges sorted by start index.
+    ArenaVector<ArrayRange> ranges_;
   };
 
   class InternStringLog : public ValueObject {
@@ -192,6 +227,20 @@ class Transaction FINAL {
     const StringOp string_op_;
   };
 
+  // EmptyFn implementation for the art::HashMap-based undo logs below.
+  template <typename K, typename V>
+  struct LogMapEmptyFn {
+    void MakeEmpty(std::pair<K*, V*>& item) const {
+      item.first = nullptr;
+    }
+    bool IsEmpty(const std::pair<K*, V*>& item) const {
+      return item.first == nullptr;
+    }
+  };
+
+  ObjectLog* GetOrCreateObjectLog(mirror::Object* obj) REQUIRES(log_lock_);
+  ArrayLog* GetOrCreateArrayLog(mirror::Array* array) REQUIRES(log_lock_);
+
   void LogInternedString(const InternStringLog& log)
       REQUIRES(Locks::intern_table_lock_)
       REQUIRES(!log_lock_);
@@ -220,9 +269,14 @@ class Transaction FINAL {
   const std::string& GetAbortMessage() REQUIRES(!log_lock_);
 
   Mutex log_lock_ ACQUIRED_AFTER(Locks::intern_table_lock_);
-  std::map<mirror::Object*, ObjectLog> object_logs_ GUARDED_BY(log_lock_);
-  std::map<mirror::Array*, ArrayLog> array_logs_  GUARDED_BY(log_lock_);
-  std::list<InternStringLog> intern_string_logs_ GUARDED_BY(log_lock_);
+  // Arena backing all the logs below. Declared before the containers so that it
+  // outlives them on destruction.
+  ArenaAllocator allocator_ GUARDED_BY(log_lock_);
+  ArenaHashMap<mirror::Object*, ObjectLog*, LogMapEmptyFn<mirror::Object, ObjectLog>>
+      object_logs_ GUARDED_BY(log_lock_);
+  ArenaHashMap<mirror::Array*, ArrayLog*, LogMapEmptyFn<mirror::Array, ArrayLog>>
+      array_logs_ GUARDED_BY(log_lock_);
+  ArenaDeque<InternStringLog> intern_string_logs_ GUARDED_BY(log_lock_);
   bool aborted_ GUARDED_BY(log_lock_);
   std::string abort_message_ GUARDED_BY(log_lock_);
 
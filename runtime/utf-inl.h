@@ -17,10 +17,115 @@
 #ifndef ART_RUNTIME_UTF_INL_H_
 #define ART_RUNTIME_UTF_INL_H_
 
+#include <string.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON__) || defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
 #include "utf.h"
 
 namespace art {
 
+inline bool IsUtf8ChunkAscii(const char* utf8) {
+#if defined(__SSE2__)
+  const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(utf8));
+  return _mm_movemask_epi8(chunk) == 0;
+#elif defined(__ARM_NEON__) || defined(__aarch64__)
+  const uint8x16_t chunk = vld1q_u8(reinterpret_cast<const uint8_t*>(utf8));
+  const uint8x8_t high_bits = vorr_u8(vget_low_u8(chunk), vget_high_u8(chunk));
+  return (vget_lane_u64(vreinterpret_u64_u8(high_bits), 0) &
+          UINT64_C(0x8080808080808080)) == 0;
+#else
+  uint64_t words[2];
+  memcpy(words, utf8, sizeof(words));
+  return ((words[0] | words[1]) & UINT64_C(0x8080808080808080)) == 0;
+#endif
+}
+
+inline bool IsUtf16ChunkAscii(const uint16_t* utf16) {
+#if defined(__SSE2__)
+  const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(utf16));
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i non_ascii =
+      _mm_and_si128(chunk, _mm_set1_epi16(static_cast<int16_t>(0xff80)));
+  return _mm_movemask_epi8(_mm_cmpeq_epi16(non_ascii, zero)) == 0xffff &&
+         _mm_movemask_epi8(_mm_cmpeq_epi16(chunk, zero)) == 0;
+#elif defined(__ARM_NEON__) || defined(__aarch64__)
+  const uint16x8_t chunk = vld1q_u16(utf16);
+  // (ch - 1) < 0x7f unsigned is equivalent to 1 <= ch <= 0x7f.
+  const uint16x8_t in_range = vcltq_u16(vsubq_u16(chunk, vdupq_n_u16(1)),
+                                        vdupq_n_u16(0x7f));
+  const uint16x4_t reduced = vand_u16(vget_low_u16(in_range), vget_high_u16(in_range));
+  return vget_lane_u64(vreinterpret_u64_u16(reduced), 0) == UINT64_C(0xffffffffffffffff);
+#else
+  uint64_t words[2];
+  memcpy(words, utf16, sizeof(words));
+  // `x | (x - 1)` has a bit of 0xff80 set in every lane unless the lane is in
+  // [1, 0x7f]. A borrow from a zero lane can only make the test fail, which
+  // just means taking the scalar path.
+  const uint64_t ones = UINT64_C(0x0001000100010001);
+  const uint64_t mask = UINT64_C(0xff80ff80ff80ff80);
+  return (((words[0] | (words[0] - ones)) & mask) == 0) &&
+         (((words[1] | (words[1] - ones)) & mask) == 0);
+#endif
+}
+
+inline void WidenLatin1Chunk(const uint8_t* bytes, uint16_t* utf16) {
+#if defined(__SSE2__)
+  const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes));
+  const __m128i zero = _mm_setzero_si128();
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(utf16), _mm_unpacklo_epi8(chunk, zero));
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(utf16 + 8), _mm_unpackhi_epi8(chunk, zero));
+#elif defined(__ARM_NEON__) || defined(__aarch64__)
+  const uint8x16_t chunk = vld1q_u8(bytes);
+  vst1q_u16(utf16, vmovl_u8(vget_low_u8(chunk)));
+  vst1q_u16(utf16 + 8, vmovl_u8(vget_high_u8(chunk)));
+#else
+  for (size_t i = 0; i < kUtf8AsciiChunkSize; ++i) {
+    utf16[i] = bytes[i];
+  }
+#endif
+}
+
+inline bool IsUtf16ChunkAtMost(const uint16_t* utf16, uint16_t max_value) {
+#if defined(__SSE2__)
+  const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(utf16));
+  // Unsigned saturating subtraction leaves zero exactly in the lanes that are in range.
+  const __m128i above =
+      _mm_subs_epu16(chunk, _mm_set1_epi16(static_cast<int16_t>(max_value)));
+  return _mm_movemask_epi8(_mm_cmpeq_epi16(above, _mm_setzero_si128())) == 0xffff;
+#elif defined(__ARM_NEON__) || defined(__aarch64__)
+  const uint16x8_t chunk = vld1q_u16(utf16);
+  const uint16x8_t in_range = vcleq_u16(chunk, vdupq_n_u16(max_value));
+  const uint16x4_t reduced = vand_u16(vget_low_u16(in_range), vget_high_u16(in_range));
+  return vget_lane_u64(vreinterpret_u64_u16(reduced), 0) == UINT64_C(0xffffffffffffffff);
+#else
+  for (size_t i = 0; i < kUtf16AsciiChunkSize; ++i) {
+    if (utf16[i] > max_value) {
+      return false;
+    }
+  }
+  return true;
+#endif
+}
+
+inline void NarrowUtf16Chunk(const uint16_t* utf16, uint8_t* bytes) {
+#if defined(__SSE2__)
+  const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(utf16));
+  const __m128i low = _mm_and_si128(chunk, _mm_set1_epi16(0x00ff));
+  _mm_storel_epi64(reinterpret_cast<__m128i*>(bytes), _mm_packus_epi16(low, low));
+#elif defined(__ARM_NEON__) || defined(__aarch64__)
+  vst1_u8(bytes, vmovn_u16(vld1q_u16(utf16)));
+#else
+  for (size_t i = 0; i < kUtf16AsciiChunkSize; ++i) {
+    bytes[i] = static_cast<uint8_t>(utf16[i]);
+  }
+#endif
+}
+
 inline uint16_t GetTrailingUtf16Char(uint32_t maybe_pair) {
   return static_cast<uint16_t>(maybe_pair >> 16);
 }
@@ -16,6 +16,8 @@
 
 #include "utf.h"
 
+#include <algorithm>
+
 #include "base/logging.h"
 #include "mirror/array.h"
 #include "mirror/object-inl.h"
@@ -47,29 +49,39 @@ size_t CountModifiedUtf8Chars(const char* utf8, size_t byte_count) {
   DCHECK_LE(byte_count, strlen(utf8));
   size_t len = 0;
   const char* end = utf8 + byte_count;
-  for (; utf8 < end; ++utf8) {
-    int ic = *utf8;
-    len++;
-    if (LIKELY((ic & 0x80) == 0)) {
-      // One-byte encoding.
-      continue;
-    }
-    // Two- or three-byte encoding.
-    utf8++;
-    if ((ic & 0x20) == 0) {
-      // Two-byte encoding.
-      continue;
-    }
-    utf8++;
-    if ((ic & 0x10) == 0) {
-      // Three-byte encoding.
+  while (utf8 < end) {
+    // Fast path: whole chunks of ASCII count one character per byte.
+    if (static_cast<size_t>(end - utf8) >= kUtf8AsciiChunkSize && IsUtf8ChunkAscii(utf8)) {
+      utf8 += kUtf8AsciiChunkSize;
+      len += kUtf8AsciiChunkSize;
       continue;
     }
+    // Mixed segment: process a chunk's worth of bytes before retrying the fast path.
+    const char* const scalar_end = std::min(end, utf8 + kUtf8AsciiChunkSize);
+    for (; utf8 < scalar_end; ++utf8) {
+      int ic = *utf8;
+      len++;
+      if (LIKELY((ic & 0x80) == 0)) {
+        // One-byte encoding.
+        continue;
+      }
+      // Two- or three-byte encoding.
+      utf8++;
+      if ((ic & 0x20) == 0) {
+        // Two-byte encoding.
+        continue;
+      }
+      utf8++;
+      if ((ic & 0x10) == 0) {
+        // Three-byte encoding.
+        continue;
+      }
 
-    // Four-byte encoding: needs to be converted into a surrogate
-    // pair.
-    utf8++;
-    len++;
+      // Four-byte encoding: needs to be converted into a surrogate
+      // pair.
+      utf8++;
+      len++;
+    }
   }
   return len;
 }
@@ -105,18 +117,75 @@ void ConvertModifiedUtf8ToUtf16(uint16_t* utf16_data_out, size_t out_chars,
   }
 
   // String contains non-ASCII characters.
-  for (const char *p = in_start; p < in_end;) {
-    const uint32_t ch = GetUtf16FromUtf8(&p);
-    const uint16_t leading = GetLeadingUtf16Char(ch);
-    const uint16_t trailing = GetTrailingUtf16Char(ch);
+  const char* p = in_start;
+  while (p < in_end) {
+    // Fast path: bulk-widen chunks of ASCII.
+    if (static_cast<size_t>(in_end - p) >= kUtf8AsciiChunkSize && IsUtf8ChunkAscii(p)) {
+      for (size_t i = 0; i < kUtf8AsciiChunkSize; ++i) {
+        *out_p++ = dchecked_integral_cast<uint16_t>(*p++);
+      }
+      continue;
+    }
+    // Mixed segment: decode a chunk's worth of bytes before retrying the fast path.
+    const char* const scalar_end = std::min(in_end, p + kUtf8AsciiChunkSize);
+    while (p < scalar_end) {
+      const uint32_t ch = GetUtf16FromUtf8(&p);
+      const uint16_t leading = GetLeadingUtf16Char(ch);
+      const uint16_t trailing = GetTrailingUtf16Char(ch);
 
-    *out_p++ = leading;
-    if (trailing != 0) {
-      *out_p++ = trailing;
+      *out_p++ = leading;
+      if (trailing != 0) {
+        *out_p++ = trailing;
+      }
     }
   }
 }
 
+// Encodes one UTF-16 character (consuming its trail surrogate when it leads a
+// valid pair) as modified UTF-8, advancing the input and output positions.
+static inline void ConvertUtf16CharToModifiedUtf8(char** utf8_out,
+                                                  const uint16_t** utf16_in,
+                                                  size_t* char_count) {
+  const uint16_t ch = *(*utf16_in)++;
+  --*char_count;
+  if (ch > 0 && ch <= 0x7f) {
+    *(*utf8_out)++ = ch;
+    return;
+  }
+  // Char_count == 0 here implies we've encountered an unpaired
+  // surrogate and we have no choice but to encode it as 3-byte UTF
+  // sequence. Note that unpaired surrogates can occur as a part of
+  // "normal" operation.
+  if ((ch >= 0xd800 && ch <= 0xdbff) && (*char_count > 0)) {
+    const uint16_t ch2 = **utf16_in;
+
+    // Check if the other half of the pair is within the expected
+    // range. If it isn't, we will have to emit both "halves" as
+    // separate 3 byte sequences.
+    if (ch2 >= 0xdc00 && ch2 <= 0xdfff) {
+      ++*utf16_in;
+      --*char_count;
+      const uint32_t code_point = (ch << 10) + ch2 - 0x035fdc00;
+      *(*utf8_out)++ = (code_point >> 18) | 0xf0;
+      *(*utf8_out)++ = ((code_point >> 12) & 0x3f) | 0x80;
+      *(*utf8_out)++ = ((code_point >> 6) & 0x3f) | 0x80;
+      *(*utf8_out)++ = (code_point & 0x3f) | 0x80;
+      return;
+    }
+  }
+
+  if (ch > 0x07ff) {
+    // Three byte encoding.
+    *(*utf8_out)++ = (ch >> 12) | 0xe0;
+    *(*utf8_out)++ = ((ch >> 6) & 0x3f) | 0x80;
+    *(*utf8_out)++ = (ch & 0x3f) | 0x80;
+  } else /*(ch > 0x7f || ch == 0)*/ {
+    // Two byte encoding.
+    *(*utf8_out)++ = (ch >> 6) | 0xc0;
+    *(*utf8_out)++ = (ch & 0x3f) | 0x80;
+  }
+}
+
 void ConvertUtf16ToModifiedUtf8(char* utf8_out, size_t byte_count,
                                 const uint16_t* utf16_in, size_t char_count) {
   if (LIKELY(byte_count == char_count)) {
@@ -129,43 +198,21 @@ void ConvertUtf16ToModifiedUtf8(char* utf8_out, size_t byte_count,
   }
 
   // String contains non-ASCII characters.
-  while (char_count--) {
-    const uint16_t ch = *utf16_in++;
-    if (ch > 0 && ch <= 0x7f) {
-      *utf8_out++ = ch;
-    } else {
-      // Char_count == 0 here implies we've encountered an unpaired
-      // surrogate and we have no choice but to encode it as 3-byte UTF
-      // sequence. Note that unpaired surrogates can occur as a part of
-      // "normal" operation.
-      if ((ch >= 0xd800 && ch <= 0xdbff) && (char_count > 0)) {
-        const uint16_t ch2 = *utf16_in;
-
-        // Check if the other half of the pair is within the expected
-        // range. If it isn't, we will have to emit both "halves" as
-        // separate 3 byte sequences.
-        if (ch2 >= 0xdc00 && ch2 <= 0xdfff) {
-          utf16_in++;
-          char_count--;
-          const uint32_t code_point = (ch << 10) + ch2 - 0x035fdc00;
-          *utf8_out++ = (code_point >> 18) | 0xf0;
-          *utf8_out++ = ((code_point >> 12) & 0x3f) | 0x80;
-          *utf8_out++ = ((code_point >> 6) & 0x3f) | 0x80;
-          *utf8_out++ = (code_point & 0x3f) | 0x80;
-          continue;
-        }
-      }
-
-      if (ch > 0x07ff) {
-        // Three byte encoding.
-        *utf8_out++ = (ch >> 12) | 0xe0;
-        *utf8_out++ = ((ch >> 6) & 0x3f) | 0x80;
-        *utf8_out++ = (ch & 0x3f) | 0x80;
-      } else /*(ch > 0x7f || ch == 0)*/ {
-        // Two byte encoding.
-        *utf8_out++ = (ch >> 6) | 0xc0;
-        *utf8_out++ = (ch & 0x3f) | 0x80;
+  while (char_count != 0) {
+    // Fast path: bulk-narrow chunks of characters with one-byte encodings.
+    if (char_count >= kUtf16AsciiChunkSize && IsUtf16ChunkAscii(utf16_in)) {
+      for (size_t i = 0; i < kUtf16AsciiChunkSize; ++i) {
+        *utf8_out++ = static_cast<char>(*utf16_in++);
       }
+      char_count -= kUtf16AsciiChunkSize;
+      continue;
+    }
+    // Mixed segment: encode a chunk's worth of characters before retrying the
+    // fast path.
+    const size_t scalar_limit =
+        (char_count > kUtf16AsciiChunkSize) ? char_count - kUtf16AsciiChunkSize : 0u;
+    while (char_count > scalar_limit) {
+      ConvertUtf16CharToModifiedUtf8(&utf8_out, &utf16_in, &char_count);
     }
   }
 }
@@ -36,6 +36,45 @@ namespace mirror {
   typedef PrimitiveArray<uint16_t> CharArray;
 }  // namespace mirror
 
+/*
+ * The conversion routines below have vectorized fast paths for ASCII-dominant
+ * input which process UTF-8 in chunks of kUtf8AsciiChunkSize bytes and UTF-16
+ * in chunks of kUtf16AsciiChunkSize characters.
+ */
+static constexpr size_t kUtf8AsciiChunkSize = 16;
+static constexpr size_t kUtf16AsciiChunkSize = 8;
+
+/*
+ * Returns true if the kUtf8AsciiChunkSize bytes at `utf8` are all ASCII
+ * (high bit clear).
+ */
+ALWAYS_INLINE bool IsUtf8ChunkAscii(const char* utf8);
+
+/*
+ * Returns true if the kUtf16AsciiChunkSize characters at `utf16` all convert
+ * to a single UTF-8 byte, i.e. are in [1, 0x7f]. Note that 0 does not qualify
+ * since it uses a two-byte encoding in modified UTF-8.
+ */
+ALWAYS_INLINE bool IsUtf16ChunkAscii(const uint16_t* utf16);
+
+/*
+ * Widens the kUtf8AsciiChunkSize bytes at `bytes` to UTF-16 characters,
+ * zero-extending each byte (ISO-8859-1 semantics).
+ */
+ALWAYS_INLINE void WidenLatin1Chunk(const uint8_t* bytes, uint16_t* utf16);
+
+/*
+ * Returns true if the kUtf16AsciiChunkSize characters at `utf16` are all less
+ * than or equal to `max_value`.
+ */
+ALWAYS_INLINE bool IsUtf16ChunkAtMost(const uint16_t* utf16, uint16_t max_value);
+
+/*
+ * Narrows the kUtf16AsciiChunkSize characters at `utf16` to one byte each by
+ * truncation. Only meaningful after the characters were checked to fit.
+ */
+ALWAYS_INLINE void NarrowUtf16Chunk(const uint16_t* utf16, uint8_t* bytes);
+
 /*
  * Returns the number of UTF-16 characters in the given modified UTF-8 string.
  */
@@ -378,4 +378,41 @@ TEST_F(UtfTest, ExhaustiveBidirectionalCodePointCheck) {
   }
 }
 
+TEST_F(UtfTest, ChunkedAsciiFastPaths) {
+  // Build input long enough to engage the vectorized ASCII fast paths, with
+  // multi-byte characters breaking up the ASCII runs at irregular offsets.
+  std::vector<uint16_t> chars;
+  for (size_t i = 0; i < 128; ++i) {
+    chars.push_back('a' + (i % 26));
+    if (i % 37 == 0) {
+      chars.push_back(0x00e9);  // Two-byte encoding.
+    }
+    if (i % 53 == 0) {
+      chars.push_back(0x20ac);  // Three-byte encoding.
+    }
+    if (i % 71 == 0) {
+      chars.push_back(0);  // Also two bytes in modified UTF-8.
+    }
+    if (i % 89 == 0) {
+      chars.push_back(0xd801);  // Surrogate pair, four bytes.
+      chars.push_back(0xdc37);
+    }
+  }
+  const size_t char_count = chars.size();
+  const size_t byte_count = CountUtf8Bytes(&chars[0], char_count);
+  EXPECT_EQ(byte_count, CountUtf8Bytes_reference(&chars[0], char_count));
+
+  std::vector<char> bytes(byte_count + 1, 0);
+  std::vector<char> bytes_reference(byte_count + 1, 0);
+  ConvertUtf16ToModifiedUtf8(&bytes[0], byte_count, &chars[0], char_count);
+  ConvertUtf16ToModifiedUtf8_reference(&bytes_reference[0], &chars[0], char_count);
+  EXPECT_EQ(0, memcmp(&bytes[0], &bytes_reference[0], byte_count));
+
+  EXPECT_EQ(char_count, CountModifiedUtf8Chars(&bytes[0], byte_count));
+
+  std::vector<uint16_t> out(char_count, 0);
+  ConvertModifiedUtf8ToUtf16(&out[0], char_count, &bytes[0], byte_count);
+  EXPECT_EQ(chars, out);
+}
+
 }  // namespace art
@@ -35,9 +35,11 @@
 #include "gc/accounting/card_table-inl.h"
 #include "indenter.h"
 #include "intern_table.h"
+#include "java_vm_ext.h"
 #include "leb128.h"
 #include "mirror/class.h"
 #include "mirror/class-inl.h"
+#include "mirror/class_loader.h"
 #include "mirror/dex_cache-inl.h"
 #include "mirror/object-inl.h"
 #include "mirror/object_array-inl.h"
@@ -45,6 +47,7 @@
 #include "register_line-inl.h"
 #include "runtime.h"
 #include "scoped_thread_state_change.h"
+#include "thread_pool.h"
 #include "utils.h"
 #include "handle_scope-inl.h"
 
@@ -58,6 +61,15 @@ static constexpr bool kDebugVerify = false;
 // On VLOG(verifier), should we dump the whole state when we run into a hard failure?
 static constexpr bool kDumpRegLinesOnHardFailureIfVLOG = true;
 
+// Parallelism options for intra-class verification. Classes with at least
+// kParallelVerificationMinMethods methods are verified by a temporary thread pool during AOT
+// compilation, in chunks of kParallelVerificationChunkSize methods per task. Chunks are small
+// compared to the method count threshold so that methods of wildly different sizes still
+// balance across the workers.
+static constexpr size_t kParallelVerificationMinMethods = 1024;
+static constexpr size_t kParallelVerificationWorkers = 3;  // In addition to the invoking thread.
+static constexpr size_t kParallelVerificationChunkSize = 64;
+
 // We print a warning blurb about "dx --no-optimize" when we find monitor-locking issues. Make
 // sure we only print this once.
 static bool gPrintedDxMonitorText = false;
@@ -259,6 +271,201 @@ MethodVerifier::FailureData MethodVerifier::VerifyMethods(Thread* self,
   return failure_data;
 }
 
+// A method picked up for parallel verification. The method is resolved up front on the invoking
+// thread, only the verification itself runs on the pool.
+struct MethodVerificationEntry {
+  uint32_t method_idx;
+  const DexFile::CodeItem* code_item;
+  ArtMethod* method;
+  uint32_t access_flags;
+};
+
+class MethodVerifier::VerificationTask : public Task {
+ public:
+  VerificationTask(const DexFile* dex_file,
+                   jobject dex_cache,
+                   jobject class_loader,
+                   const DexFile::ClassDef* class_def,
+                   CompilerCallbacks* callbacks,
+                   bool allow_soft_failures,
+                   LogSeverity log_level,
+                   bool need_precise_constants,
+                   std::vector<MethodVerificationEntry>&& entries)
+      : dex_file_(dex_file),
+        dex_cache_(dex_cache),
+        class_loader_(class_loader),
+        class_def_(class_def),
+        callbacks_(callbacks),
+        allow_soft_failures_(allow_soft_failures),
+        log_level_(log_level),
+        need_precise_constants_(need_precise_constants),
+        entries_(std::move(entries)) {}
+
+  void Run(Thread* self) OVERRIDE {
+    ScopedObjectAccess soa(self);
+    StackHandleScope<2> hs(self);
+    Handle<mirror::DexCache> dex_cache(hs.NewHandle(soa.Decode<mirror::DexCache*>(dex_cache_)));
+    Handle<mirror::ClassLoader> class_loader(
+        hs.NewHandle(soa.Decode<mirror::ClassLoader*>(class_loader_)));
+    for (const MethodVerificationEntry& entry : entries_) {
+      self->AllowThreadSuspension();
+      std::string hard_failure_msg;
+      MethodVerifier::FailureData result = VerifyMethod(self,
+                                                        entry.method_idx,
+                                                        dex_file_,
+                                                        dex_cache,
+                                                        class_loader,
+                                                        class_def_,
+                                                        entry.code_item,
+                                                        entry.method,
+                                                        entry.access_flags,
+                                                        callbacks_,
+                                                        allow_soft_failures_,
+                                                        log_level_,
+                                                        need_precise_constants_,
+                                                        &hard_failure_msg);
+      if (result.kind == kHardFailure) {
+        hard_failure_msgs_.push_back(std::move(hard_failure_msg));
+      }
+      failure_data_.Merge(result);
+    }
+  }
+
+  const MethodVerifier::FailureData& GetFailureData() const {
+    return failure_data_;
+  }
+
+  const std::vector<std::string>& GetHardFailureMessages() const {
+    return hard_failure_msgs_;
+  }
+
+ private:
+  const DexFile* const dex_file_;
+  const jobject dex_cache_;
+  const jobject class_loader_;
+  const DexFile::ClassDef* const class_def_;
+  CompilerCallbacks* const callbacks_;
+  const bool allow_soft_failures_;
+  const LogSeverity log_level_;
+  const bool need_precise_constants_;
+  const std::vector<MethodVerificationEntry> entries_;
+
+  MethodVerifier::FailureData failure_data_;
+  std::vector<std::string> hard_failure_msgs_;
+
+  DISALLOW_COPY_AND_ASSIGN(VerificationTask);
+};
+
+MethodVerifier::FailureData MethodVerifier::VerifyMethodsParallel(
+    Thread* self,
+    ClassLinker* linker,
+    const DexFile* dex_file,
+    const DexFile::ClassDef* class_def,
+    ClassDataItemIterator* it,
+    Handle<mirror::DexCache> dex_cache,
+    Handle<mirror::ClassLoader> class_loader,
+    CompilerCallbacks* callbacks,
+    bool allow_soft_failures,
+    LogSeverity log_level,
+    bool need_precise_constants,
+    std::string* error_string) {
+  DCHECK(it != nullptr);
+
+  // Collect and resolve the methods up front. Resolution mutates the dex cache and is cheap
+  // compared to the verification itself, so it stays on the invoking thread.
+  std::vector<MethodVerificationEntry> entries;
+  entries.reserve(it->NumDirectMethods() + it->NumVirtualMethods());
+  for (bool direct : {true, false}) {
+    int64_t previous_method_idx = -1;
+    while (direct ? HasNextMethod<true>(it) : HasNextMethod<false>(it)) {
+      self->AllowThreadSuspension();
+      uint32_t method_idx = it->GetMemberIndex();
+      if (method_idx == previous_method_idx) {
+        // smali can create dex files with two encoded_methods sharing the same method_idx
+        // http://code.google.com/p/smali/issues/detail?id=119
+        it->Next();
+        continue;
+      }
+      previous_method_idx = method_idx;
+      InvokeType type = it->GetMethodInvokeType(*class_def);
+      ArtMethod* method = linker->ResolveMethod<ClassLinker::kNoICCECheckForCache>(
+          *dex_file, method_idx, dex_cache, class_loader, nullptr, type);
+      if (method == nullptr) {
+        DCHECK(self->IsExceptionPending());
+        // We couldn't resolve the method, but continue regardless.
+        self->ClearException();
+      } else {
+        DCHECK(method->GetDeclaringClassUnchecked() != nullptr) << type;
+      }
+      entries.push_back(MethodVerificationEntry { method_idx,
+                                                  it->GetMethodCodeItem(),
+                                                  method,
+                                                  it->GetMethodAccessFlags() });
+      it->Next();
+    }
+  }
+
+  MethodVerifier::FailureData failure_data;
+  if (entries.empty()) {
+    return failure_data;
+  }
+
+  // The tasks reference the dex cache and class loader through global refs since the workers
+  // run with their own handle scopes and may observe a moving GC.
+  JavaVMExt* vm = Runtime::Current()->GetJavaVM();
+  jobject dex_cache_ref = vm->AddGlobalRef(self, dex_cache.Get());
+  jobject class_loader_ref = vm->AddGlobalRef(self, class_loader.Get());
+
+  std::vector<std::unique_ptr<VerificationTask>> tasks;
+  for (size_t i = 0; i < entries.size(); i += kParallelVerificationChunkSize) {
+    const size_t end = std::min(entries.size(), i + kParallelVerificationChunkSize);
+    tasks.emplace_back(
+        new VerificationTask(dex_file,
+                             dex_cache_ref,
+                             class_loader_ref,
+                             class_def,
+                             callbacks,
+                             allow_soft_failures,
+                             log_level,
+                             need_precise_constants,
+                             std::vector<MethodVerificationEntry>(entries.begin() + i,
+                                                                  entries.begin() + end)));
+  }
+
+  ThreadPool pool("Method verifier pool", kParallelVerificationWorkers);
+  for (const std::unique_ptr<VerificationTask>& task : tasks) {
+    pool.AddTask(self, task.get());
+  }
+  pool.StartWorkers(self);
+  {
+    // Release the mutator lock while waiting so that we don't block suspension, and let the
+    // invoking thread consume tasks as well.
+    ScopedThreadSuspension sts(self, kNative);
+    pool.Wait(self, /* do_work */ true, /* may_hold_locks */ false);
+  }
+  vm->DeleteGlobalRef(self, dex_cache_ref);
+  vm->DeleteGlobalRef(self, class_loader_ref);
+
+  // Merge the results in task order so that failure messages stay deterministic.
+  bool reported_hard_failure = false;
+  for (const std::unique_ptr<VerificationTask>& task : tasks) {
+    for (const std::string& hard_failure_msg : task->GetHardFailureMessages()) {
+      if (reported_hard_failure) {
+        *error_string += "\n";
+      } else {
+        *error_string += "Verifier rejected class ";
+        *error_string += PrettyDescriptor(dex_file->GetClassDescriptor(*class_def));
+        *error_string += ":";
+        reported_hard_failure = true;
+      }
+      *error_string += " ";
+      *error_string += hard_failure_msg;
+    }
+    failure_data.Merge(task->GetFailureData());
+  }
+  return failure_data;
+}
+
 MethodVerifier::FailureKind MethodVerifier::VerifyClass(Thread* self,
                                                         const DexFile* dex_file,
                                                         Handle<mirror::DexCache> dex_cache,
@@ -289,6 +496,34 @@ MethodVerifier::FailureKind MethodVerifier::VerifyClass(Thread* self,
     it.Next();
   }
   ClassLinker* linker = Runtime::Current()->GetClassLinker();
+  const size_t num_methods = it.NumDirectMethods() + it.NumVirtualMethods();
+  if (UNLIKELY(num_methods >= kParallelVerificationMinMethods) &&
+      Runtime::Current()->IsAotCompiler()) {
+    // Fan the methods of unusually large classes out to a temporary thread pool so that a
+    // single dex2oat worker doesn't serialize on the class for seconds. Not used at runtime
+    // where spawning threads during class loading is undesirable.
+    MethodVerifier::FailureData data = VerifyMethodsParallel(self,
+                                                             linker,
+                                                             dex_file,
+                                                             class_def,
+                                                             &it,
+                                                             dex_cache,
+                                                             class_loader,
+                                                             callbacks,
+                                                             allow_soft_failures,
+                                                             log_level,
+                                                             false /* need precise constants */,
+                                                             error);
+    if (data.kind == kNoFailure) {
+      return kNoFailure;
+    }
+    if ((data.types & VERIFY_ERROR_LOCKING) != 0) {
+      LOG(WARNING) << StringPrintf("Class %s failed lock verification and will run slower.",
+                                   PrettyDescriptor(
+                                       dex_file->GetClassDescriptor(*class_def)).c_str());
+    }
+    return data.kind;
+  }
   // Direct methods.
   MethodVerifier::FailureData data1 = VerifyMethods<true>(self,
                                                           linker,
@@ -344,6 +344,25 @@ class MethodVerifier {
                                    std::string* error_string)
       SHARED_REQUIRES(Locks::mutator_lock_);
 
+  // Verify all methods (direct and virtual) of a class with a temporary pool of worker threads.
+  // Used for classes with unusually many methods, where sequential verification would stall a
+  // single dex2oat worker for a long time. The iterator must be positioned at the first direct
+  // method and is fully consumed.
+  class VerificationTask;
+  static FailureData VerifyMethodsParallel(Thread* self,
+                                           ClassLinker* linker,
+                                           const DexFile* dex_file,
+                                           const DexFile::ClassDef* class_def,
+                                           ClassDataItemIterator* it,
+                                           Handle<mirror::DexCache> dex_cache,
+                                           Handle<mirror::ClassLoader> class_loader,
+                                           CompilerCallbacks* callbacks,
+                                           bool allow_soft_failures,
+                                           LogSeverity log_level,
+                                           bool need_precise_constants,
+                                           std::string* error_string)
+      SHARED_REQUIRES(Locks::mutator_lock_);
+
   /*
    * Perform verification on a single method.
    *
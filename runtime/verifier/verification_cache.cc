@@ -0,0 +1,336 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "verification_cache.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <limits>
+#include <vector>
+
+#include "base/logging.h"
+#include "base/scoped_flock.h"
+#include "base/unix_file/fd_file.h"
+#include "jit/offline_profiling_info.h"
+#include "oat_file_assistant.h"
+#include "os.h"
+#include "thread.h"
+
+namespace art {
+namespace verifier {
+
+const uint8_t VerificationCache::kVerificationCacheMagic[] = { 'v', 'r', 'f', '\0' };
+// Version 002 added the boot image checksum to the header.
+const uint8_t VerificationCache::kVerificationCacheVersion[] = { '0', '0', '2', '\0' };
+constexpr const char* VerificationCache::kFileSuffix;
+
+static constexpr uint16_t kMaxDexFileKeyLength = PATH_MAX;
+// Refuse to parse cache files larger than this, the content is certainly bad.
+static constexpr size_t kMaxCacheFileSizeBytes = 4 * MB;
+
+Atomic<VerificationCache*> VerificationCache::instance_(nullptr);
+
+VerificationCache::VerificationCache(const std::string& cache_filename)
+    : cache_filename_(cache_filename),
+      lock_("VerificationCache lock"),
+      boot_image_checksum_(0u),
+      dirty_(false) {}
+
+void VerificationCache::Start(const std::string& cache_filename) {
+  if (instance_.LoadAcquire() != nullptr) {
+    return;
+  }
+  VerificationCache* cache = new VerificationCache(cache_filename);
+  cache->Load();
+  // Results recorded against a different boot image (e.g. before an OTA) must not be
+  // trusted; this drops them and stamps future saves with the current checksum.
+  cache->SetBootImageChecksum(OatFileAssistant::CalculateCombinedImageChecksum());
+  if (!instance_.CompareExchangeStrongSequentiallyConsistent(nullptr, cache)) {
+    // Raced with another Start(), the first instance wins.
+    delete cache;
+    return;
+  }
+  VLOG(profiler) << "Started verification cache using file: " << cache_filename;
+}
+
+bool VerificationCache::IsStarted() {
+  return instance_.LoadAcquire() != nullptr;
+}
+
+bool VerificationCache::ContainsClass(const DexFile& dex_file, uint16_t class_def_index) {
+  VerificationCache* const cache = instance_.LoadAcquire();
+  if (cache == nullptr) {
+    return false;
+  }
+  return cache->IsClassVerified(dex_file, class_def_index);
+}
+
+void VerificationCache::AddClass(const DexFile& dex_file, uint16_t class_def_index) {
+  VerificationCache* const cache = instance_.LoadAcquire();
+  if (cache == nullptr) {
+    return;
+  }
+  cache->AddVerifiedClass(dex_file, class_def_index);
+}
+
+bool VerificationCache::IsClassVerified(const DexFile& dex_file, uint16_t class_def_index) const {
+  const std::string key = ProfileCompilationInfo::GetProfileDexFileKey(dex_file.GetLocation());
+  MutexLock mu(Thread::Current(), lock_);
+  auto it = info_.find(key);
+  if (it == info_.end() || it->second.checksum != dex_file.GetLocationChecksum()) {
+    return false;
+  }
+  return it->second.class_set.find(class_def_index) != it->second.class_set.end();
+}
+
+void VerificationCache::AddVerifiedClass(const DexFile& dex_file, uint16_t class_def_index) {
+  const std::string key = ProfileCompilationInfo::GetProfileDexFileKey(dex_file.GetLocation());
+  if (key.size() >= kMaxDexFileKeyLength) {
+    return;
+  }
+  MutexLock mu(Thread::Current(), lock_);
+  auto it = info_.find(key);
+  if (it == info_.end()) {
+    it = info_.Put(key, DexFileData(dex_file.GetLocationChecksum()));
+  } else if (it->second.checksum != dex_file.GetLocationChecksum()) {
+    // The dex file changed since the entry was recorded, drop the stale results.
+    it->second.checksum = dex_file.GetLocationChecksum();
+    it->second.class_set.clear();
+  }
+  if (it->second.class_set.size() >= std::numeric_limits<uint16_t>::max()) {
+    return;
+  }
+  if (it->second.class_set.insert(class_def_index).second) {
+    dirty_ = true;
+  }
+}
+
+uint32_t VerificationCache::GetBootImageChecksum() const {
+  MutexLock mu(Thread::Current(), lock_);
+  return boot_image_checksum_;
+}
+
+void VerificationCache::SetBootImageChecksum(uint32_t checksum) {
+  MutexLock mu(Thread::Current(), lock_);
+  if (boot_image_checksum_ != checksum) {
+    if (!info_.empty()) {
+      VLOG(profiler) << "Dropping verification cache recorded against a different boot image";
+      info_.clear();
+    }
+    boot_image_checksum_ = checksum;
+  }
+}
+
+size_t VerificationCache::GetNumberOfVerifiedClasses() const {
+  MutexLock mu(Thread::Current(), lock_);
+  size_t count = 0u;
+  for (const auto& it : info_) {
+    count += it.second.class_set.size();
+  }
+  return count;
+}
+
+bool VerificationCache::SaveIfDirty() {
+  VerificationCache* const cache = instance_.LoadAcquire();
+  if (cache == nullptr) {
+    return false;
+  }
+  {
+    MutexLock mu(Thread::Current(), cache->lock_);
+    if (!cache->dirty_) {
+      return false;
+    }
+  }
+  return cache->Save();
+}
+
+// Returns true if all the bytes were successfully written to the file descriptor.
+static bool WriteBuffer(int fd, const uint8_t* buffer, size_t byte_count) {
+  while (byte_count > 0) {
+    int bytes_written = TEMP_FAILURE_RETRY(write(fd, buffer, byte_count));
+    if (bytes_written == -1) {
+      return false;
+    }
+    byte_count -= bytes_written;
+    buffer += bytes_written;
+  }
+  return true;
+}
+
+// Insert each byte, from low to high into the buffer.
+template <typename T>
+static void AddUintToBuffer(std::vector<uint8_t>* buffer, T value) {
+  for (size_t i = 0; i < sizeof(T); i++) {
+    buffer->push_back((value >> (i * kBitsPerByte)) & 0xff);
+  }
+}
+
+// Reads an uint value previously written with AddUintToBuffer. Returns false if the buffer
+// does not hold enough bytes.
+template <typename T>
+static bool ReadUintAndAdvance(const uint8_t** ptr, const uint8_t* end, T* value) {
+  if (*ptr + sizeof(T) > end) {
+    return false;
+  }
+  *value = 0;
+  for (size_t i = 0; i < sizeof(T); i++) {
+    *value += static_cast<T>((*ptr)[i]) << (i * kBitsPerByte);
+  }
+  *ptr += sizeof(T);
+  return true;
+}
+
+/**
+ * Serialization format (mirrors the profile file format):
+ *    magic,version,boot_image_checksum,number_of_lines
+ *    dex_location_size1,number_of_classes1,dex_location_checksum1,dex_location1, \
+ *        class_def_idx11,class_def_idx12...
+ *    .....
+ **/
+bool VerificationCache::Save() {
+  ScopedFlock flock;
+  std::string error;
+  // Unlike the profile file the cache file is not pre-created by the framework, so use the
+  // creating Init() overload.
+  if (!flock.Init(cache_filename_.c_str(), &error)) {
+    LOG(WARNING) << "Couldn't lock the verification cache file " << cache_filename_ << ": "
+                 << error;
+    return false;
+  }
+  // The cache is loaded once at startup and only grows afterwards, so the in-memory state
+  // supersedes whatever is in the file and we can simply overwrite it.
+  if (!flock.GetFile()->ClearContent()) {
+    PLOG(WARNING) << "Could not clear verification cache file: " << cache_filename_;
+    return false;
+  }
+  int fd = flock.GetFile()->Fd();
+
+  std::vector<uint8_t> buffer;
+  {
+    MutexLock mu(Thread::Current(), lock_);
+    AddUintToBuffer(&buffer, boot_image_checksum_);  // uint32_t
+    AddUintToBuffer(&buffer, static_cast<uint16_t>(info_.size()));
+    for (const auto& it : info_) {
+      const std::string& dex_location = it.first;
+      const DexFileData& dex_data = it.second;
+      DCHECK_LT(dex_location.size(), kMaxDexFileKeyLength);
+      DCHECK_LE(dex_data.class_set.size(), std::numeric_limits<uint16_t>::max());
+      AddUintToBuffer(&buffer, static_cast<uint16_t>(dex_location.size()));
+      AddUintToBuffer(&buffer, static_cast<uint16_t>(dex_data.class_set.size()));
+      AddUintToBuffer(&buffer, dex_data.checksum);  // uint32_t
+      buffer.insert(buffer.end(), dex_location.begin(), dex_location.end());
+      for (uint16_t class_def_index : dex_data.class_set) {
+        AddUintToBuffer(&buffer, class_def_index);
+      }
+    }
+    dirty_ = false;
+  }
+
+  bool result = WriteBuffer(fd, kVerificationCacheMagic, sizeof(kVerificationCacheMagic)) &&
+      WriteBuffer(fd, kVerificationCacheVersion, sizeof(kVerificationCacheVersion)) &&
+      WriteBuffer(fd, buffer.data(), buffer.size());
+  if (result) {
+    VLOG(profiler) << "Successfully saved verification cache to " << cache_filename_
+                   << " Size: " << buffer.size();
+  } else {
+    VLOG(profiler) << "Failed to save verification cache to " << cache_filename_;
+    MutexLock mu(Thread::Current(), lock_);
+    dirty_ = true;
+  }
+  return result;
+}
+
+void VerificationCache::Load() {
+  std::unique_ptr<File> file(OS::OpenFileForReading(cache_filename_.c_str()));
+  if (file == nullptr) {
+    // No cache yet, this is expected on the first launch after install or profile reset.
+    return;
+  }
+  int64_t file_size = file->GetLength();
+  if (file_size <= 0) {
+    // We allow empty cache files, they may be created externally before we first save.
+    return;
+  }
+  if (static_cast<size_t>(file_size) > kMaxCacheFileSizeBytes) {
+    LOG(WARNING) << "Verification cache file " << cache_filename_ << " is too large: "
+                 << file_size;
+    return;
+  }
+  std::vector<uint8_t> data(file_size);
+  if (!file->ReadFully(data.data(), data.size())) {
+    PLOG(WARNING) << "Could not read verification cache file " << cache_filename_;
+    return;
+  }
+
+  const uint8_t* ptr = data.data();
+  const uint8_t* const end = ptr + data.size();
+  if (ptr + sizeof(kVerificationCacheMagic) > end ||
+      memcmp(ptr, kVerificationCacheMagic, sizeof(kVerificationCacheMagic)) != 0) {
+    LOG(WARNING) << "Verification cache file " << cache_filename_ << " is missing the magic";
+    return;
+  }
+  ptr += sizeof(kVerificationCacheMagic);
+  if (ptr + sizeof(kVerificationCacheVersion) > end ||
+      memcmp(ptr, kVerificationCacheVersion, sizeof(kVerificationCacheVersion)) != 0) {
+    // Old or unknown version, start from scratch.
+    VLOG(profiler) << "Verification cache version mismatch in " << cache_filename_;
+    return;
+  }
+  ptr += sizeof(kVerificationCacheVersion);
+
+  MutexLock mu(Thread::Current(), lock_);
+  uint16_t number_of_lines;
+  if (!ReadUintAndAdvance(&ptr, end, &boot_image_checksum_) ||
+      !ReadUintAndAdvance(&ptr, end, &number_of_lines)) {
+    LOG(WARNING) << "Truncated verification cache file " << cache_filename_;
+    info_.clear();
+    return;
+  }
+  for (uint16_t line = 0; line < number_of_lines; ++line) {
+    uint16_t dex_location_size;
+    uint16_t class_set_size;
+    uint32_t checksum;
+    if (!ReadUintAndAdvance(&ptr, end, &dex_location_size) ||
+        !ReadUintAndAdvance(&ptr, end, &class_set_size) ||
+        !ReadUintAndAdvance(&ptr, end, &checksum) ||
+        dex_location_size == 0 ||
+        dex_location_size >= kMaxDexFileKeyLength ||
+        ptr + dex_location_size + class_set_size * sizeof(uint16_t) > end) {
+      LOG(WARNING) << "Bad data in verification cache file " << cache_filename_;
+      info_.clear();
+      return;
+    }
+    std::string dex_location(reinterpret_cast<const char*>(ptr), dex_location_size);
+    ptr += dex_location_size;
+    DexFileData dex_data(checksum);
+    for (uint16_t i = 0; i < class_set_size; ++i) {
+      uint16_t class_def_index;
+      ReadUintAndAdvance(&ptr, end, &class_def_index);
+      dex_data.class_set.insert(class_def_index);
+    }
+    info_.Put(dex_location, dex_data);
+  }
+  VLOG(profiler) << "Loaded verification cache from " << cache_filename_ << " with "
+                 << info_.size() << " dex files";
+}
+
+}  // namespace verifier
+}  // namespace art
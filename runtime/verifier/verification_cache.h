@@ -0,0 +1,120 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_VERIFIER_VERIFICATION_CACHE_H_
+#define ART_RUNTIME_VERIFIER_VERIFICATION_CACHE_H_
+
+#include <set>
+#include <string>
+
+#include "atomic.h"
+#include "base/mutex.h"
+#include "dex_file.h"
+#include "safe_map.h"
+
+namespace art {
+namespace verifier {
+
+/**
+ * Persistent cache of class verification results.
+ * The cache records, keyed by dex location checksum and class def index, the classes which
+ * fully verified (no soft or hard failure) so that subsequent verification of the unchanged
+ * dex file can be skipped. It has two users:
+ *  - The runtime keeps a singleton next to the profile managed by ProfileSaver. For
+ *    interpret-only apps every class is soft-verified again on each cold start;
+ *    ClassLinker::VerifyClass consults the cache to skip the method verifier.
+ *  - dex2oat writes an instance next to the oat file so that recompiling the same dex files
+ *    (e.g. after a compiler filter change or an A/B OTA) does not re-verify classes that
+ *    already verified against the same boot image.
+ * A class whose dex file checksum no longer matches is ignored, as is the whole file if its
+ * version, boot image checksum or content is not understood.
+ */
+class VerificationCache {
+ public:
+  static const uint8_t kVerificationCacheMagic[];
+  static const uint8_t kVerificationCacheVersion[];
+
+  // Suffix appended to the profile or oat file name to derive the cache file name.
+  static constexpr const char* kFileSuffix = ".vrf";
+
+  // Creates the cache singleton if not already created and loads previously saved results
+  // from cache_filename. Subsequent calls are no-ops.
+  static void Start(const std::string& cache_filename);
+
+  // Returns true if the cache has been started.
+  static bool IsStarted();
+
+  // Returns true if the class fully verified in a previous run and the dex checksum still
+  // matches. Returns false if the cache is not started.
+  static bool ContainsClass(const DexFile& dex_file, uint16_t class_def_index);
+
+  // Records that the class fully verified at runtime. No-op if the cache is not started.
+  static void AddClass(const DexFile& dex_file, uint16_t class_def_index);
+
+  // Writes the cache back to disk if new classes were recorded since the last save.
+  // Called periodically from the profile saver thread.
+  static bool SaveIfDirty();
+
+  // Instance API, used by dex2oat and OatFileAssistant to read and write the cache next to
+  // an oat file. The runtime uses the static singleton API above instead.
+  explicit VerificationCache(const std::string& cache_filename);
+
+  void Load() REQUIRES(!lock_);
+  bool Save() REQUIRES(!lock_);
+
+  // Returns true if the class fully verified when the cache was recorded and the dex
+  // checksum still matches.
+  bool IsClassVerified(const DexFile& dex_file, uint16_t class_def_index) const
+      REQUIRES(!lock_);
+
+  // Records that the class fully verified.
+  void AddVerifiedClass(const DexFile& dex_file, uint16_t class_def_index) REQUIRES(!lock_);
+
+  // The combined boot image checksum the cached results were recorded against. Verification
+  // results are only valid against the same boot classpath, so setting a checksum different
+  // from the loaded one drops all previously recorded results.
+  uint32_t GetBootImageChecksum() const REQUIRES(!lock_);
+  void SetBootImageChecksum(uint32_t checksum) REQUIRES(!lock_);
+
+  size_t GetNumberOfVerifiedClasses() const REQUIRES(!lock_);
+
+ private:
+  struct DexFileData {
+    explicit DexFileData(uint32_t location_checksum) : checksum(location_checksum) {}
+    uint32_t checksum;
+    std::set<uint16_t> class_set;
+  };
+
+  // The only instance of the cache, created by Start() and never destroyed.
+  static Atomic<VerificationCache*> instance_;
+
+  const std::string cache_filename_;
+
+  mutable Mutex lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
+  // Maps profile dex file keys to their verified class def indices.
+  SafeMap<std::string, DexFileData> info_ GUARDED_BY(lock_);
+  // Combined checksum of the boot image the results were verified against.
+  uint32_t boot_image_checksum_ GUARDED_BY(lock_);
+  // True if classes were added since the last successful save.
+  bool dirty_ GUARDED_BY(lock_);
+
+  DISALLOW_COPY_AND_ASSIGN(VerificationCache);
+};
+
+}  // namespace verifier
+}  // namespace art
+
+#endif  // ART_RUNTIME_VERIFIER_VERIFICATION_CACHE_H_
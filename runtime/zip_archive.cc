@@ -23,6 +23,7 @@
 #include <unistd.h>
 #include <vector>
 
+#include "base/bit_utils.h"
 #include "base/stringprintf.h"
 #include "base/unix_file/fd_file.h"
 
@@ -55,6 +56,32 @@ MemMap* ZipEntry::ExtractToMemMap(const char* zip_filename, const char* entry_fi
   std::string name(entry_filename);
   name += " extracted in memory from ";
   name += zip_filename;
+
+  // A stored entry is a verbatim byte range of the archive, so instead of copying it into
+  // anonymous memory we can map the archive region itself, copy-on-write. Dex data must be
+  // at least 4-byte aligned, which mmap only guarantees if the entry offset is equally
+  // aligned within the file. The mapping stays clean until someone writes to it, whereas an
+  // extracted copy dirties every page up front.
+  if (zip_entry_->method == kCompressStored &&
+      IsAligned<4>(static_cast<uint64_t>(zip_entry_->offset))) {
+    DCHECK_EQ(zip_entry_->compressed_length, zip_entry_->uncompressed_length);
+    std::unique_ptr<MemMap> map(MemMap::MapFile(GetUncompressedLength(),
+                                                PROT_READ | PROT_WRITE,
+                                                MAP_PRIVATE,
+                                                GetFileDescriptor(handle_),
+                                                zip_entry_->offset,
+                                                /*low_4gb*/ false,
+                                                name.c_str(),
+                                                error_msg));
+    if (map.get() != nullptr) {
+      return map.release();
+    }
+    // Fall through to the extracting path; the copy costs more but has fewer ways to fail.
+    VLOG(startup) << "Direct mapping of stored zip entry failed, extracting instead: "
+                  << *error_msg;
+    error_msg->clear();
+  }
+
   std::unique_ptr<MemMap> map(MemMap::MapAnonymous(name.c_str(),
                                                    nullptr, GetUncompressedLength(),
                                                    PROT_READ | PROT_WRITE, false, false,
@@ -36,6 +36,7 @@
 namespace art {
 
 typedef int (*SigActionFnPtr)(int, const struct sigaction*, struct sigaction*);
+typedef int (*SigProcMaskFnPtr)(int how, const sigset_t*, sigset_t*);
 
 class SignalAction {
  public:
@@ -98,6 +99,15 @@ static bool initialized;
 static void* linked_sigaction_sym;
 static void* linked_sigprocmask_sym;
 
+// Precomputed dispatch state. It is rebuilt outside of signal context whenever a chain is
+// claimed or unclaimed and read without synchronization on signal delivery, so the delivery
+// path neither scans the claim table nor performs lazy initialization.
+static int num_claimed_signals = 0;
+// All signals except the claimed ones. This is the mask applied around special handlers; it
+// matches what routing a full set through the sigprocmask interposer used to compute on every
+// delivery.
+static sigset_t special_handler_block_mask;
+
 static void log(const char* format, ...) {
   char buf[256];
   va_list ap;
@@ -118,6 +128,21 @@ static void CheckSignalValid(int signal) {
   }
 }
 
+// Rebuild the precomputed dispatch state after a claim or unclaim. Never called from signal
+// context, so it is safe to run the lazy initialization here and keep it off the delivery path.
+static void UpdateDispatchState() {
+  InitializeSignalChain();
+  sigfillset(&special_handler_block_mask);
+  num_claimed_signals = 0;
+  for (int i = 1; i < _NSIG; ++i) {
+    if (user_sigactions[i].IsClaimed()) {
+      // Claimed signals are never blocked, see the sigprocmask interposer below.
+      sigdelset(&special_handler_block_mask, i);
+      ++num_claimed_signals;
+    }
+  }
+}
+
 // Sigchainlib's own handler so we can ensure a managed handler is called first even if nobody
 // claimed a chain. Simply forward to InvokeUserSignalHandler.
 static void sigchainlib_managed_handler_sigaction(int sig, siginfo_t* info, void* context) {
@@ -129,12 +154,14 @@ extern "C" void ClaimSignalChain(int signal, struct sigaction* oldaction) {
   CheckSignalValid(signal);
 
   user_sigactions[signal].Claim(*oldaction);
+  UpdateDispatchState();
 }
 
 extern "C" void UnclaimSignalChain(int signal) {
   CheckSignalValid(signal);
 
   user_sigactions[signal].Unclaim(signal);
+  UpdateDispatchState();
 }
 
 // Invoke the user's signal handler.
@@ -150,15 +177,28 @@ extern "C" void InvokeUserSignalHandler(int sig, siginfo_t* info, void* context)
   // Do we have a managed handler? If so, run it first.
   SpecialSignalHandlerFn managed = user_sigactions[sig].GetSpecialHandler();
   if (managed != nullptr) {
-    sigset_t mask, old_mask;
-    sigfillset(&mask);
-    sigprocmask(SIG_BLOCK, &mask, &old_mask);
-    // Call the handler. If it succeeds, we're done.
-    if (managed(sig, info, context)) {
+    // Block with the mask precomputed at claim time, through the linked sigprocmask so delivery
+    // does not rescan the claim table or hit the interposer's lazy initialization. The claim
+    // that got us here ran UpdateDispatchState, so the linked symbol is resolved.
+    sigset_t old_mask;
+    if (linked_sigprocmask_sym != nullptr) {
+      SigProcMaskFnPtr linked_sigprocmask =
+          reinterpret_cast<SigProcMaskFnPtr>(linked_sigprocmask_sym);
+      linked_sigprocmask(SIG_BLOCK, &special_handler_block_mask, &old_mask);
+      // Call the handler. If it succeeds, we're done.
+      bool handled = managed(sig, info, context);
+      linked_sigprocmask(SIG_SETMASK, &old_mask, nullptr);
+      if (handled) {
+        return;
+      }
+    } else {
+      sigprocmask(SIG_BLOCK, &special_handler_block_mask, &old_mask);
+      bool handled = managed(sig, info, context);
       sigprocmask(SIG_SETMASK, &old_mask, nullptr);
-      return;
+      if (handled) {
+        return;
+      }
     }
-    sigprocmask(SIG_SETMASK, &old_mask, nullptr);
   }
 
   const struct sigaction& action = user_sigactions[sig].GetAction();
@@ -193,6 +233,7 @@ extern "C" void EnsureFrontOfChain(int signal, struct sigaction* expected_action
   if (current_action.sa_sigaction != expected_action->sa_sigaction) {
     log("Warning: Unexpected sigaction action found %p\n", current_action.sa_sigaction);
     user_sigactions[signal].Claim(current_action);
+    UpdateDispatchState();
     linked_sigaction(signal, expected_action, nullptr);
   }
 }
@@ -278,7 +319,8 @@ extern "C" int sigprocmask(int how, const sigset_t* bionic_new_set, sigset_t* bi
   if (bionic_new_set != nullptr) {
     tmpset = *bionic_new_set;
 
-    if (how == SIG_BLOCK) {
+    // Skip the scan entirely in the common case of a process with no claimed chains.
+    if (how == SIG_BLOCK && num_claimed_signals != 0) {
       // Don't allow claimed signals in the mask.  If a signal chain has been claimed
       // we can't allow the user to block that signal.
       for (int i = 0 ; i < _NSIG; ++i) {
@@ -354,6 +396,7 @@ extern "C" void SetSpecialSignalHandlerFn(int signal, SpecialSignalHandlerFn fn)
 #endif
     if (sigaction(signal, &act, &old_act) != -1) {
       user_sigactions[signal].Claim(old_act);
+      UpdateDispatchState();
     }
   }
 }
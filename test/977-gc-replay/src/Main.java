@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import java.io.BufferedReader;
+import java.io.FileReader;
+import java.util.ArrayList;
+import java.util.HashMap;
+import java.util.Map;
+import java.util.TreeMap;
+
+public class Main {
+  // Number of replayed allocations between footprint reports.
+  private static final long REPORT_INTERVAL = 100000;
+
+  // Parameters of the built-in synthetic trace used when no file is given.
+  private static final long SYNTHETIC_ALLOCATIONS = 400000;
+  private static final long MAX_LIFETIME = 20000;
+
+  // Objects kept alive until the replay reaches their recorded death tick,
+  // keyed by death tick.
+  private static final TreeMap<Long, ArrayList<byte[]>> live =
+      new TreeMap<Long, ArrayList<byte[]>>();
+
+  public static void main(String[] args) throws Exception {
+    if (args.length > 0) {
+      replayFile(args[0]);
+    } else {
+      replaySynthetic();
+    }
+    live.clear();
+    System.out.println("Done.");
+  }
+
+  // Allocates one object of the given size, dying at the given tick. A
+  // negative death tick means no death was recorded; such objects are kept
+  // until the end of the replay like the trace suggests.
+  private static void allocate(long tick, int bytes, long deathTick) {
+    while (!live.isEmpty() && live.firstKey() <= tick) {
+      live.pollFirstEntry();
+    }
+    byte[] obj = new byte[bytes];
+    Long key = Long.valueOf(deathTick < 0 ? Long.MAX_VALUE : deathTick);
+    ArrayList<byte[]> bucket = live.get(key);
+    if (bucket == null) {
+      bucket = new ArrayList<byte[]>();
+      live.put(key, bucket);
+    }
+    bucket.add(obj);
+    if (tick % REPORT_INTERVAL == 0) {
+      Runtime runtime = Runtime.getRuntime();
+      System.err.println("tick " + tick + " footprint "
+          + (runtime.totalMemory() - runtime.freeMemory()));
+    }
+  }
+
+  // Replays a trace recorded with debug.allocTracker.traceFile. Allocation
+  // lines are "a <tick> <bytes> <class-descriptor>" and death lines are
+  // "d <alloc-tick> <death-tick> <bytes>"; all classes are replayed as byte
+  // arrays of the recorded size.
+  private static void replayFile(String fileName) throws Exception {
+    Map<Long, Long> deaths = new HashMap<Long, Long>();
+    BufferedReader reader = new BufferedReader(new FileReader(fileName));
+    try {
+      String line;
+      while ((line = reader.readLine()) != null) {
+        if (line.startsWith("d ")) {
+          String[] fields = line.split(" ");
+          deaths.put(Long.valueOf(fields[1]), Long.valueOf(fields[2]));
+        }
+      }
+    } finally {
+      reader.close();
+    }
+    reader = new BufferedReader(new FileReader(fileName));
+    try {
+      String line;
+      while ((line = reader.readLine()) != null) {
+        if (!line.startsWith("a ")) {
+          continue;
+        }
+        String[] fields = line.split(" ");
+        long tick = Long.parseLong(fields[1]);
+        int bytes = Integer.parseInt(fields[2]);
+        Long deathTick = deaths.get(Long.valueOf(tick));
+        allocate(tick, bytes, deathTick == null ? -1 : deathTick.longValue());
+      }
+    } finally {
+      reader.close();
+    }
+  }
+
+  // Deterministic stand-in workload: mostly small short-lived objects with a
+  // tail of larger, longer-lived ones, from a fixed-seed generator.
+  private static void replaySynthetic() {
+    long seed = 42;
+    for (long tick = 0; tick < SYNTHETIC_ALLOCATIONS; tick++) {
+      seed = seed * 6364136223846793005L + 1442695040888963407L;
+      int bytes = 16 << (int) ((seed >>> 32) % 7);
+      long lifetime = (seed >>> 16) % MAX_LIFETIME;
+      allocate(tick, bytes, tick + 1 + lifetime);
+    }
+  }
+}
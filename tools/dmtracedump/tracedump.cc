@@ -45,6 +45,9 @@ int32_t versionNumber;
 /* thread list in key file is not reliable, so just max out */
 #define MAX_THREADS 32768
 
+/* largest data record we are prepared to read; real traces use 9-18 bytes */
+#define MAX_RECORD_SIZE 4096
+
 /* Size of temporary buffers for escaping html strings */
 #define HTML_BUFSIZE 10240
 
@@ -826,35 +829,65 @@ DataKeys* parseKeys(FILE* fp, int32_t verbose) {
   if (pKeys == nullptr) return nullptr;
 
   /*
-   * We load the entire file into memory.  We do this, rather than memory-
-   * mapping it, because we want to change some whitespace to NULs.
+   * The text key section is small, but the binary record data that follows
+   * it can be orders of magnitude larger, so read the file incrementally
+   * until we see the "*end" token rather than loading all of it.  We read
+   * into a private buffer (instead of memory-mapping the file) because we
+   * want to change some whitespace to NULs.
    */
-  if (fseek(fp, 0L, SEEK_END) != 0) {
-    perror("fseek");
-    freeDataKeys(pKeys);
-    return nullptr;
-  }
-  pKeys->fileLen = ftell(fp);
-  if (pKeys->fileLen == 0) {
-    fprintf(stderr, "Key file is empty.\n");
+  static const char endToken[] = "\n*end\n";
+  const size_t endTokenLen = strlen(endToken);
+  size_t capacity = 64 * 1024;
+  size_t used = 0;
+  int64_t keyLen = -1;
+  char* fileData = reinterpret_cast<char*>(malloc(capacity));
+  if (fileData == nullptr) {
+    fprintf(stderr, "ERROR: unable to alloc %zu bytes\n", capacity);
     freeDataKeys(pKeys);
     return nullptr;
   }
-  rewind(fp);
 
-  pKeys->fileData = new char[pKeys->fileLen];
-  if (pKeys->fileData == nullptr) {
-    fprintf(stderr, "ERROR: unable to alloc %" PRIu64 " bytes\n", pKeys->fileLen);
-    freeDataKeys(pKeys);
-    return nullptr;
+  while (keyLen < 0) {
+    size_t numRead = fread(fileData + used, 1, capacity - used, fp);
+    if (numRead == 0) break;
+
+    /* Back up so that a token straddling the previous read is still found. */
+    size_t searchStart = (used > endTokenLen) ? used - endTokenLen : 0;
+    used += numRead;
+    for (size_t ii = searchStart; ii + endTokenLen <= used; ++ii) {
+      if (memcmp(fileData + ii, endToken, endTokenLen) == 0) {
+        keyLen = ii + endTokenLen;
+        break;
+      }
+    }
+
+    if (keyLen < 0 && used == capacity) {
+      capacity *= 2;
+      char* newData = reinterpret_cast<char*>(realloc(fileData, capacity));
+      if (newData == nullptr) {
+        fprintf(stderr, "ERROR: unable to alloc %zu bytes\n", capacity);
+        free(fileData);
+        freeDataKeys(pKeys);
+        return nullptr;
+      }
+      fileData = newData;
+    }
   }
 
-  if (fread(pKeys->fileData, 1, pKeys->fileLen, fp) != (size_t)pKeys->fileLen) {
-    fprintf(stderr, "ERROR: unable to read %" PRIu64 " bytes from trace file\n", pKeys->fileLen);
+  if (keyLen < 0) {
+    if (used == 0) {
+      fprintf(stderr, "Key file is empty.\n");
+    } else {
+      fprintf(stderr, "ERROR: could not find the end of the key section\n");
+    }
+    free(fileData);
     freeDataKeys(pKeys);
     return nullptr;
   }
 
+  pKeys->fileData = fileData;
+  pKeys->fileLen = keyLen;
+
   offset = 0;
   offset = parseVersion(pKeys, offset, verbose);
   offset = parseThreads(pKeys, offset);
@@ -865,9 +898,6 @@ DataKeys* parseKeys(FILE* fp, int32_t verbose) {
     return nullptr;
   }
 
-  /* Reduce our allocation now that we know where the end of the key section is. */
-  pKeys->fileData = reinterpret_cast<char*>(realloc(pKeys->fileData, offset));
-  pKeys->fileLen = offset;
   /* Leave fp pointing to the beginning of the data section. */
   fseek(fp, offset, SEEK_SET);
 
@@ -950,6 +980,10 @@ int32_t parseDataHeader(FILE* fp, DataHeader* pHeader) {
   } else if (pHeader->version == 3) {
     pHeader->recordSize = read2LE(fp);
     bytesToRead -= 2;
+    if (pHeader->recordSize < 10 || pHeader->recordSize > MAX_RECORD_SIZE) {
+      fprintf(stderr, "Bad record size: %d\n", pHeader->recordSize);
+      return -1;
+    }
   } else {
     fprintf(stderr, "Unsupported trace file version: %d\n", pHeader->version);
     return -1;
@@ -991,33 +1025,35 @@ MethodEntry* lookupMethod(DataKeys* pKeys, int64_t methodId) {
  * methodVal and elapsedTime.  On end-of-file, the threadId, methodVal,
  * and elapsedTime are unchanged.  Returns 1 on end-of-file, otherwise
  * returns 0.
+ *
+ * Each record is fetched with a single buffered read and decoded in
+ * memory; pulling multi-GB traces through getc() one byte at a time
+ * dominated the run time.
  */
 int32_t readDataRecord(FILE* dataFp, DataHeader* dataHeader, int32_t* threadId,
                    uint32_t* methodVal, uint64_t* elapsedTime) {
-  int32_t id;
-  int32_t bytesToRead = dataHeader->recordSize;
-  if (dataHeader->version == 1) {
-    id = getc(dataFp);
-    bytesToRead -= 1;
-  } else {
-    id = read2LE(dataFp);
-    bytesToRead -= 2;
-  }
-  if (id == EOF) return 1;
-  *threadId = id;
-
-  *methodVal = read4LE(dataFp);
-  *elapsedTime = read4LE(dataFp);
-  bytesToRead -= 8;
-
-  while (bytesToRead-- > 0) {
-    getc(dataFp);
-  }
-
-  if (feof(dataFp)) {
-    fprintf(stderr, "WARNING: hit EOF mid-record\n");
+  uint8_t record[MAX_RECORD_SIZE];
+  size_t numRead = fread(record, 1, dataHeader->recordSize, dataFp);
+  if (numRead < (size_t) dataHeader->recordSize) {
+    if (numRead != 0) {
+      fprintf(stderr, "WARNING: hit EOF mid-record\n");
+    }
     return 1;
   }
+
+  const uint8_t* cursor = record;
+  if (dataHeader->version == 1) {
+    *threadId = *cursor++;
+  } else {
+    *threadId = cursor[0] | (cursor[1] << 8);
+    cursor += 2;
+  }
+  *methodVal = cursor[0] | (cursor[1] << 8) | (cursor[2] << 16) |
+               ((uint32_t) cursor[3] << 24);
+  cursor += 4;
+  *elapsedTime = cursor[0] | (cursor[1] << 8) | (cursor[2] << 16) |
+                 ((uint32_t) cursor[3] << 24);
+  /* Any remaining bytes (e.g. the version 3 wall clock field) are skipped. */
   return 0;
 }
 
@@ -2260,20 +2296,38 @@ int32_t compareMethodNamesForDiff(const void* a, const void* b) {
   return result;
 }
 
-int32_t findMatch(MethodEntry** methods, int32_t size, MethodEntry* matchThis) {
-  for (int32_t i = 0; i < size; i++) {
-    MethodEntry* method = methods[i];
+/* An entry of the name-sorted lookup table used when diffing two traces,
+ * remembering where the method lives in the original array.
+ */
+typedef struct MethodSearchEntry {
+  MethodEntry* method;
+  int32_t index;
+} MethodSearchEntry;
 
-    if (method != nullptr && !compareMethodNamesForDiff(&method, &matchThis)) {
-      // printf("%s.%s == %s.%s<br>\n", matchThis->className, matchThis->methodName,
-      //        method->className, method->methodName);
+int32_t compareMethodSearchEntries(const void* a, const void* b) {
+  const MethodSearchEntry* entryA = (const MethodSearchEntry*) a;
+  const MethodSearchEntry* entryB = (const MethodSearchEntry*) b;
+  return compareMethodNamesForDiff(&entryA->method, &entryB->method);
+}
 
-      return i;
-      // if (!compareMethodNames(&method, &matchThis)) return i;
-    }
+/* Looks up "matchThis" in a table sorted with compareMethodSearchEntries
+ * and returns its index in the original methods array, or -1 if there is
+ * no match.  The caller clears matched entries in "methods" so that the
+ * leftovers can be reported; treat those as unmatched here.  The binary
+ * search replaces a linear scan that made diffing quadratic in the number
+ * of methods.
+ */
+int32_t findMatch(MethodSearchEntry* sortedMethods, MethodEntry** methods, int32_t size,
+                  MethodEntry* matchThis) {
+  MethodSearchEntry key;
+  key.method = matchThis;
+  key.index = 0;
+  MethodSearchEntry* found = reinterpret_cast<MethodSearchEntry*>(
+      bsearch(&key, sortedMethods, size, sizeof(MethodSearchEntry), compareMethodSearchEntries));
+  if (found == nullptr || methods[found->index] == nullptr) {
+    return -1;
   }
-
-  return -1;
+  return found->index;
 }
 
 int32_t compareDiffEntriesExculsive(const void* a, const void* b) {
@@ -2339,6 +2393,14 @@ void createDiff(DataKeys* d1, DataKeys* d2) {
     methods2[i]->index = i;
   }
 
+  /* Build a name-sorted table of run 2's methods for matching. */
+  MethodSearchEntry* sorted2 = new MethodSearchEntry[d2->numMethods];
+  for (int32_t i = 0; i < d2->numMethods; ++i) {
+    sorted2[i].method = methods2[i];
+    sorted2[i].index = i;
+  }
+  qsort(sorted2, d2->numMethods, sizeof(MethodSearchEntry), compareMethodSearchEntries);
+
   int32_t max = (d1->numMethods < d2->numMethods) ? d2->numMethods : d1->numMethods;
   max++;
   DiffEntry* diffs = new DiffEntry[max];
@@ -2351,7 +2413,7 @@ void createDiff(DataKeys* d1, DataKeys* d2) {
   int32_t matches = 0;
 
   for (int32_t i = 0; i < d1->numMethods; i++) {
-    int32_t match = findMatch(methods2, d2->numMethods, methods1[i]);
+    int32_t match = findMatch(sorted2, methods2, d2->numMethods, methods1[i]);
     if (match >= 0) {
       ptr->method1 = methods1[i];
       ptr->method2 = methods2[match];
@@ -2383,6 +2445,7 @@ void createDiff(DataKeys* d1, DataKeys* d2) {
   }
   ptr->method1 = nullptr;
   ptr->method2 = nullptr;
+  delete[] sorted2;
 
   qsort(diffs, matches, sizeof(DiffEntry), compareDiffEntriesExculsive);
   ptr = diffs;